@@ -0,0 +1,306 @@
+#pragma once
+#ifndef OPENGM_COMPRESSED_ADJACENCY_HXX
+#define OPENGM_COMPRESSED_ADJACENCY_HXX
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/opengm.hxx"
+
+namespace opengm {
+
+/// Immutable adjacency lists in compressed sparse row (CSR) format.
+///
+/// The neighbors of all nodes are stored in one contiguous array, sorted
+/// per node. Each entry can carry an identifier of the connecting edge
+/// (e.g. the index of the factor that induces it). Neighbor lists are
+/// accessed as ranges that point into this storage without copying.
+///
+/// \ingroup datastructures
+template<class I = size_t>
+class CompressedAdjacency {
+public:
+   typedef I IndexType;
+   typedef const I* const_iterator;
+
+   /// Non-owning view of a contiguous sequence of indices
+   class Range {
+   public:
+      typedef I value_type;
+      typedef const I* const_iterator;
+
+      Range(const I* begin = NULL, const I* end = NULL)
+         : begin_(begin), end_(end)
+         {}
+      const_iterator begin() const
+         { return begin_; }
+      const_iterator end() const
+         { return end_; }
+      size_t size() const
+         { return static_cast<size_t>(end_ - begin_); }
+      bool empty() const
+         { return begin_ == end_; }
+      const I& operator[](const size_t j) const
+         { OPENGM_ASSERT(j < size());
+           return begin_[j]; }
+
+   private:
+      const I* begin_;
+      const I* end_;
+   };
+
+   CompressedAdjacency();
+
+   size_t numberOfNodes() const;
+   size_t numberOfEntries() const;
+   size_t numberOfNeighbors(const size_t) const;
+   Range neighbors(const size_t) const;
+   Range operator[](const size_t) const;
+   Range edges(const size_t) const;
+   const_iterator neighborsBegin(const size_t) const;
+   const_iterator neighborsEnd(const size_t) const;
+   bool connected(const size_t, const size_t) const;
+   bool hasEdgeIdentifiers() const;
+
+   template<class NEIGHBORHOOD>
+      void build(const size_t, const NEIGHBORHOOD&, const bool = true, const bool = false, const size_t = 0);
+   void clear();
+
+private:
+   std::vector<size_t> offsets_;
+   std::vector<I> neighbors_;
+   std::vector<I> edges_;
+};
+
+template<class I>
+inline
+CompressedAdjacency<I>::CompressedAdjacency()
+:  offsets_(1, 0),
+   neighbors_(),
+   edges_()
+{}
+
+/// \brief number of nodes
+template<class I>
+inline size_t
+CompressedAdjacency<I>::numberOfNodes() const
+{
+   return offsets_.size() - 1;
+}
+
+/// \brief total number of entries in all adjacency lists
+template<class I>
+inline size_t
+CompressedAdjacency<I>::numberOfEntries() const
+{
+   return neighbors_.size();
+}
+
+/// \brief number of neighbors of a node
+template<class I>
+inline size_t
+CompressedAdjacency<I>::numberOfNeighbors
+(
+   const size_t node
+) const
+{
+   OPENGM_ASSERT(node < numberOfNodes());
+   return offsets_[node + 1] - offsets_[node];
+}
+
+/// \brief sorted neighbors of a node
+template<class I>
+inline typename CompressedAdjacency<I>::Range
+CompressedAdjacency<I>::neighbors
+(
+   const size_t node
+) const
+{
+   OPENGM_ASSERT(node < numberOfNodes());
+   const I* data = neighbors_.empty() ? NULL : &neighbors_[0];
+   return Range(data + offsets_[node], data + offsets_[node + 1]);
+}
+
+/// \brief sorted neighbors of a node
+template<class I>
+inline typename CompressedAdjacency<I>::Range
+CompressedAdjacency<I>::operator[]
+(
+   const size_t node
+) const
+{
+   return neighbors(node);
+}
+
+/// \brief identifiers of the edges to the neighbors of a node
+///
+/// The j-th edge identifier belongs to the j-th neighbor.
+/// Only available if the adjacency was built with edge identifiers.
+template<class I>
+inline typename CompressedAdjacency<I>::Range
+CompressedAdjacency<I>::edges
+(
+   const size_t node
+) const
+{
+   OPENGM_ASSERT(node < numberOfNodes());
+   OPENGM_ASSERT(hasEdgeIdentifiers());
+   const I* data = edges_.empty() ? NULL : &edges_[0];
+   return Range(data + offsets_[node], data + offsets_[node + 1]);
+}
+
+template<class I>
+inline typename CompressedAdjacency<I>::const_iterator
+CompressedAdjacency<I>::neighborsBegin
+(
+   const size_t node
+) const
+{
+   return neighbors(node).begin();
+}
+
+template<class I>
+inline typename CompressedAdjacency<I>::const_iterator
+CompressedAdjacency<I>::neighborsEnd
+(
+   const size_t node
+) const
+{
+   return neighbors(node).end();
+}
+
+/// \brief check if two nodes are adjacent (binary search in the shorter list)
+template<class I>
+inline bool
+CompressedAdjacency<I>::connected
+(
+   const size_t j,
+   const size_t k
+) const
+{
+   if(numberOfNeighbors(j) <= numberOfNeighbors(k)) {
+      const Range r = neighbors(j);
+      return std::binary_search(r.begin(), r.end(), static_cast<I>(k));
+   }
+   else {
+      const Range r = neighbors(k);
+      return std::binary_search(r.begin(), r.end(), static_cast<I>(j));
+   }
+}
+
+template<class I>
+inline bool
+CompressedAdjacency<I>::hasEdgeIdentifiers() const
+{
+   return edges_.size() == neighbors_.size();
+}
+
+/// \brief build the adjacency lists
+///
+/// \param numberOfNodes number of nodes
+/// \param neighborhood functor; neighborhood(node, out) appends pairs
+///        (neighbor, edge identifier) of the node to the std::vector out
+/// \param unique remove duplicate neighbors (keeps the smallest edge identifier)
+/// \param withEdgeIdentifiers store the edge identifiers
+/// \param numberOfThreads number of threads (0 = all available), used only WITH_OPENMP
+///
+/// Two passes over the nodes are made: one to count the neighbors and one
+/// to fill the lists. Both passes run in parallel if OpenMP is enabled.
+template<class I>
+template<class NEIGHBORHOOD>
+void
+CompressedAdjacency<I>::build
+(
+   const size_t numberOfNodes,
+   const NEIGHBORHOOD& neighborhood,
+   const bool unique,
+   const bool withEdgeIdentifiers,
+   const size_t numberOfThreads
+)
+{
+   typedef std::pair<I, I> Entry;
+   offsets_.assign(numberOfNodes + 1, 0);
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+   #endif
+
+   // count
+   #ifdef WITH_OPENMP
+   #pragma omp parallel num_threads(nThreads)
+   #endif
+   {
+      std::vector<Entry> buffer;
+      #ifdef WITH_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for(std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t>(numberOfNodes); ++n) {
+         buffer.clear();
+         neighborhood(static_cast<size_t>(n), buffer);
+         std::sort(buffer.begin(), buffer.end());
+         if(unique) {
+            size_t count = 0;
+            for(size_t j = 0; j < buffer.size(); ++j) {
+               if(j == 0 || buffer[j].first != buffer[j - 1].first) {
+                  ++count;
+               }
+            }
+            offsets_[n + 1] = count;
+         }
+         else {
+            offsets_[n + 1] = buffer.size();
+         }
+      }
+   }
+   for(size_t n = 0; n < numberOfNodes; ++n) {
+      offsets_[n + 1] += offsets_[n];
+   }
+
+   // fill
+   neighbors_.resize(offsets_.back());
+   edges_.resize(withEdgeIdentifiers ? offsets_.back() : 0);
+   #ifdef WITH_OPENMP
+   #pragma omp parallel num_threads(nThreads)
+   #endif
+   {
+      std::vector<Entry> buffer;
+      #ifdef WITH_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for(std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t>(numberOfNodes); ++n) {
+         buffer.clear();
+         neighborhood(static_cast<size_t>(n), buffer);
+         std::sort(buffer.begin(), buffer.end());
+         size_t position = offsets_[n];
+         for(size_t j = 0; j < buffer.size(); ++j) {
+            if(!unique || j == 0 || buffer[j].first != buffer[j - 1].first) {
+               neighbors_[position] = buffer[j].first;
+               if(withEdgeIdentifiers) {
+                  edges_[position] = buffer[j].second;
+               }
+               ++position;
+            }
+         }
+         OPENGM_ASSERT(position == offsets_[n + 1]);
+      }
+   }
+}
+
+/// \brief remove all nodes and release the memory
+template<class I>
+inline void
+CompressedAdjacency<I>::clear()
+{
+   std::vector<size_t>(1, 0).swap(offsets_);
+   std::vector<I>().swap(neighbors_);
+   std::vector<I>().swap(edges_);
+}
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_COMPRESSED_ADJACENCY_HXX
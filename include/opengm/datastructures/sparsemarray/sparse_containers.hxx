@@ -0,0 +1,415 @@
+#pragma once
+#ifndef OPENGM_SPARSE_CONTAINERS_HXX
+#define OPENGM_SPARSE_CONTAINERS_HXX
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <iterator>
+#include <cstddef>
+
+#include "opengm/opengm.hxx"
+
+namespace opengm {
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_sparse_containers {
+
+   /// key value pair returned by the iterators of the flat containers
+   /// (keys and values are stored in separate arrays, so there is no pair to point to)
+   template<class KEY, class VALUE>
+   class KeyValueProxy {
+   public:
+      KeyValueProxy(const KEY key, const VALUE value)
+      :  pair_(key, value) {}
+      const std::pair<KEY, VALUE>* operator->() const
+         { return &pair_; }
+   private:
+      std::pair<KEY, VALUE> pair_;
+   };
+
+   /// forward iterator over the slots of a flat container,
+   /// slots holding the key EMPTY are skipped if SKIP_EMPTY is true
+   template<class KEY, class VALUE, bool SKIP_EMPTY>
+   class FlatMapIterator {
+   public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef std::pair<KEY, VALUE> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef KeyValueProxy<KEY, VALUE> pointer;
+      typedef value_type reference;
+
+      FlatMapIterator()
+      :  keys_(NULL), values_(NULL), slot_(0), numberOfSlots_(0) {}
+      FlatMapIterator(const KEY* keys, const VALUE* values, const size_t slot, const size_t numberOfSlots)
+      :  keys_(keys), values_(values), slot_(slot), numberOfSlots_(numberOfSlots)
+         { skipEmpty(); }
+
+      value_type operator*() const
+         { return value_type(keys_[slot_], values_[slot_]); }
+      pointer operator->() const
+         { return pointer(keys_[slot_], values_[slot_]); }
+      FlatMapIterator& operator++()
+         { ++slot_; skipEmpty(); return *this; }
+      FlatMapIterator operator++(int)
+         { FlatMapIterator tmp(*this); ++(*this); return tmp; }
+      bool operator==(const FlatMapIterator& other) const
+         { return slot_ == other.slot_ && keys_ == other.keys_; }
+      bool operator!=(const FlatMapIterator& other) const
+         { return !(*this == other); }
+      /// position of the iterator in the underlying arrays
+      size_t slot() const
+         { return slot_; }
+
+   private:
+      void skipEmpty() {
+         if(SKIP_EMPTY) {
+            while(slot_ < numberOfSlots_ && keys_[slot_] == std::numeric_limits<KEY>::max()) {
+               ++slot_;
+            }
+         }
+      }
+
+      const KEY* keys_;
+      const VALUE* values_;
+      size_t slot_;
+      size_t numberOfSlots_;
+   };
+
+} // namespace detail_sparse_containers
+/// \endcond
+
+/// Open addressing hash map with linear probing
+///
+/// Drop-in container for SparseFunction. Keys and values are stored in two
+/// flat arrays, such that a lookup touches (in the common case) a single
+/// cache line of keys and no pointers are followed. The largest value of
+/// KEY is reserved to mark empty slots.
+///
+/// \tparam KEY unsigned integral key type
+/// \tparam VALUE mapped type
+///
+/// \ingroup datastructures
+template<class KEY, class VALUE>
+class OpenAddressingMap {
+public:
+   typedef KEY key_type;
+   typedef VALUE mapped_type;
+   typedef std::pair<KEY, VALUE> value_type;
+   typedef size_t size_type;
+   typedef detail_sparse_containers::FlatMapIterator<KEY, VALUE, true> const_iterator;
+   typedef const_iterator iterator;
+
+   OpenAddressingMap();
+   explicit OpenAddressingMap(const size_t);
+
+   size_type size() const
+      { return size_; }
+   bool empty() const
+      { return size_ == 0; }
+   size_type bucketCount() const
+      { return keys_.size(); }
+   const_iterator begin() const
+      { return keys_.empty() ? end() : const_iterator(&keys_[0], &values_[0], 0, keys_.size()); }
+   const_iterator end() const
+      { return keys_.empty() ? const_iterator() : const_iterator(&keys_[0], &values_[0], keys_.size(), keys_.size()); }
+
+   const_iterator find(const key_type) const;
+   size_type count(const key_type key) const
+      { return find(key) == end() ? 0 : 1; }
+   std::pair<const_iterator, bool> insert(const value_type&);
+   void reserve(const size_t);
+   void clear();
+
+private:
+   static const double maxLoadFactor_;
+   key_type emptyKey() const
+      { return std::numeric_limits<key_type>::max(); }
+   size_t slotOf(const key_type key) const
+      { return static_cast<size_t>((static_cast<UInt64Type>(key) * static_cast<UInt64Type>(0x9E3779B97F4A7C15ULL)) >> shift_); }
+   void rehash(const size_t);
+
+   std::vector<key_type> keys_;
+   std::vector<mapped_type> values_;
+   size_t size_;
+   size_t mask_;
+   unsigned int shift_;
+};
+
+template<class KEY, class VALUE>
+const double OpenAddressingMap<KEY, VALUE>::maxLoadFactor_ = 0.5;
+
+template<class KEY, class VALUE>
+inline
+OpenAddressingMap<KEY, VALUE>::OpenAddressingMap()
+:  keys_(),
+   values_(),
+   size_(0),
+   mask_(0),
+   shift_(64)
+{}
+
+/// \param expectedSize number of entries the map will hold without rehashing
+template<class KEY, class VALUE>
+inline
+OpenAddressingMap<KEY, VALUE>::OpenAddressingMap
+(
+   const size_t expectedSize
+)
+:  keys_(),
+   values_(),
+   size_(0),
+   mask_(0),
+   shift_(64)
+{
+   reserve(expectedSize);
+}
+
+template<class KEY, class VALUE>
+inline typename OpenAddressingMap<KEY, VALUE>::const_iterator
+OpenAddressingMap<KEY, VALUE>::find
+(
+   const key_type key
+) const {
+   if(size_ == 0) {
+      return end();
+   }
+   size_t slot = slotOf(key);
+   for(;;) {
+      const key_type k = keys_[slot];
+      if(k == key) {
+         return const_iterator(&keys_[0], &values_[0], slot, keys_.size());
+      }
+      if(k == emptyKey()) {
+         return end();
+      }
+      slot = (slot + 1) & mask_;
+   }
+}
+
+/// insert a key value pair, an existing entry is not overwritten (as std::map::insert)
+template<class KEY, class VALUE>
+inline std::pair<typename OpenAddressingMap<KEY, VALUE>::const_iterator, bool>
+OpenAddressingMap<KEY, VALUE>::insert
+(
+   const value_type& keyValue
+) {
+   OPENGM_ASSERT(keyValue.first != emptyKey());
+   if(static_cast<double>(size_ + 1) > maxLoadFactor_ * static_cast<double>(keys_.size())) {
+      rehash(std::max<size_t>(16, keys_.size() * 2));
+   }
+   size_t slot = slotOf(keyValue.first);
+   for(;;) {
+      const key_type k = keys_[slot];
+      if(k == keyValue.first) {
+         return std::pair<const_iterator, bool>(const_iterator(&keys_[0], &values_[0], slot, keys_.size()), false);
+      }
+      if(k == emptyKey()) {
+         keys_[slot] = keyValue.first;
+         values_[slot] = keyValue.second;
+         ++size_;
+         return std::pair<const_iterator, bool>(const_iterator(&keys_[0], &values_[0], slot, keys_.size()), true);
+      }
+      slot = (slot + 1) & mask_;
+   }
+}
+
+/// make room for n entries without exceeding the maximal load factor
+template<class KEY, class VALUE>
+inline void
+OpenAddressingMap<KEY, VALUE>::reserve
+(
+   const size_t n
+) {
+   size_t numberOfSlots = 16;
+   while(static_cast<double>(n) > maxLoadFactor_ * static_cast<double>(numberOfSlots)) {
+      numberOfSlots *= 2;
+   }
+   if(numberOfSlots > keys_.size()) {
+      rehash(numberOfSlots);
+   }
+}
+
+template<class KEY, class VALUE>
+inline void
+OpenAddressingMap<KEY, VALUE>::clear() {
+   keys_.clear();
+   values_.clear();
+   size_ = 0;
+   mask_ = 0;
+   shift_ = 64;
+}
+
+template<class KEY, class VALUE>
+void
+OpenAddressingMap<KEY, VALUE>::rehash
+(
+   const size_t numberOfSlots
+) {
+   OPENGM_ASSERT((numberOfSlots & (numberOfSlots - 1)) == 0);
+   std::vector<key_type> oldKeys(numberOfSlots, emptyKey());
+   std::vector<mapped_type> oldValues(numberOfSlots);
+   oldKeys.swap(keys_);
+   oldValues.swap(values_);
+   mask_ = numberOfSlots - 1;
+   shift_ = 64;
+   for(size_t s = numberOfSlots; s > 1; s >>= 1) {
+      --shift_;
+   }
+   for(size_t i = 0; i < oldKeys.size(); ++i) {
+      if(oldKeys[i] != emptyKey()) {
+         size_t slot = slotOf(oldKeys[i]);
+         while(keys_[slot] != emptyKey()) {
+            slot = (slot + 1) & mask_;
+         }
+         keys_[slot] = oldKeys[i];
+         values_[slot] = oldValues[i];
+      }
+   }
+}
+
+/// Sorted key array
+///
+/// Compact container for SparseFunction that is meant to be filled once
+/// (e.g. by converting a map-based SparseFunction) and then only read.
+/// Keys are kept sorted in one contiguous array and values in a second one.
+/// Lookups use interpolation search (the keys of a SparseFunction are
+/// linear indices and thus roughly uniformly spread) and fall back to
+/// binary search on small ranges.
+///
+/// Inserting keys in increasing order is O(1), any other insert is O(n).
+///
+/// \tparam KEY unsigned integral key type
+/// \tparam VALUE mapped type
+///
+/// \ingroup datastructures
+template<class KEY, class VALUE>
+class SortedArrayMap {
+public:
+   typedef KEY key_type;
+   typedef VALUE mapped_type;
+   typedef std::pair<KEY, VALUE> value_type;
+   typedef size_t size_type;
+   typedef detail_sparse_containers::FlatMapIterator<KEY, VALUE, false> const_iterator;
+   typedef const_iterator iterator;
+
+   SortedArrayMap()
+   :  keys_(), values_() {}
+   template<class ITERATOR>
+      SortedArrayMap(ITERATOR, ITERATOR);
+
+   size_type size() const
+      { return keys_.size(); }
+   bool empty() const
+      { return keys_.empty(); }
+   const_iterator begin() const
+      { return keys_.empty() ? end() : const_iterator(&keys_[0], &values_[0], 0, keys_.size()); }
+   const_iterator end() const
+      { return keys_.empty() ? const_iterator() : const_iterator(&keys_[0], &values_[0], keys_.size(), keys_.size()); }
+
+   const_iterator find(const key_type) const;
+   size_type count(const key_type key) const
+      { return find(key) == end() ? 0 : 1; }
+   std::pair<const_iterator, bool> insert(const value_type&);
+   void reserve(const size_t n)
+      { keys_.reserve(n); values_.reserve(n); }
+   void clear()
+      { keys_.clear(); values_.clear(); }
+
+   /// sorted keys
+   const std::vector<key_type>& keys() const
+      { return keys_; }
+   /// values in the order of the keys
+   const std::vector<mapped_type>& values() const
+      { return values_; }
+
+private:
+   size_t lowerBound(const key_type) const;
+
+   std::vector<key_type> keys_;
+   std::vector<mapped_type> values_;
+};
+
+/// construct from a range of key value pairs (e.g. the entries of a std::map)
+template<class KEY, class VALUE>
+template<class ITERATOR>
+inline
+SortedArrayMap<KEY, VALUE>::SortedArrayMap
+(
+   ITERATOR begin,
+   ITERATOR end
+)
+:  keys_(),
+   values_()
+{
+   for(; begin != end; ++begin) {
+      insert(value_type(begin->first, begin->second));
+   }
+}
+
+template<class KEY, class VALUE>
+inline size_t
+SortedArrayMap<KEY, VALUE>::lowerBound
+(
+   const key_type key
+) const {
+   size_t lo = 0;
+   size_t hi = keys_.size();
+   // interpolation steps, bounded to keep the worst case logarithmic
+   for(size_t step = 0; step < 4 && hi - lo > 32; ++step) {
+      const key_type kLo = keys_[lo];
+      const key_type kHi = keys_[hi - 1];
+      if(key <= kLo) {
+         return lo;
+      }
+      if(key > kHi) {
+         return hi;
+      }
+      const double t = static_cast<double>(key - kLo) / static_cast<double>(kHi - kLo);
+      const size_t guess = lo + static_cast<size_t>(t * static_cast<double>(hi - 1 - lo));
+      if(keys_[guess] < key) {
+         lo = guess + 1;
+      }
+      else {
+         hi = guess + 1;
+      }
+   }
+   return static_cast<size_t>(std::lower_bound(keys_.begin() + lo, keys_.begin() + hi, key) - keys_.begin());
+}
+
+template<class KEY, class VALUE>
+inline typename SortedArrayMap<KEY, VALUE>::const_iterator
+SortedArrayMap<KEY, VALUE>::find
+(
+   const key_type key
+) const {
+   const size_t pos = lowerBound(key);
+   if(pos < keys_.size() && keys_[pos] == key) {
+      return const_iterator(&keys_[0], &values_[0], pos, keys_.size());
+   }
+   return end();
+}
+
+/// insert a key value pair, an existing entry is not overwritten (as std::map::insert)
+template<class KEY, class VALUE>
+inline std::pair<typename SortedArrayMap<KEY, VALUE>::const_iterator, bool>
+SortedArrayMap<KEY, VALUE>::insert
+(
+   const value_type& keyValue
+) {
+   size_t pos = keys_.size();
+   if(!keys_.empty() && !(keys_.back() < keyValue.first)) {
+      pos = lowerBound(keyValue.first);
+      if(keys_[pos] == keyValue.first) {
+         return std::pair<const_iterator, bool>(const_iterator(&keys_[0], &values_[0], pos, keys_.size()), false);
+      }
+   }
+   keys_.insert(keys_.begin() + pos, keyValue.first);
+   values_.insert(values_.begin() + pos, keyValue.second);
+   return std::pair<const_iterator, bool>(const_iterator(&keys_[0], &values_[0], pos, keys_.size()), true);
+}
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_SPARSE_CONTAINERS_HXX
@@ -5,11 +5,29 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <vector>
 #include "opengm/functions/function_properties_base.hxx"
+#include "opengm/datastructures/sparsemarray/sparse_containers.hxx"
 
 
 namespace opengm {
 
+/// Sparse function, only entries that differ from a default value are stored
+///
+/// The container that maps linear indices to values is exchangeable:
+/// - std::map<I,T> (default) supports fast incremental construction
+/// - OpenAddressingMap<KEY,T> is a flat hash map for fast lookups of mutable functions
+/// - SortedArrayMap<KEY,T> is the most compact form for functions that are built once
+///
+/// A function that has been built with one container is converted ("frozen")
+/// into another one by the converting constructor:
+/// \code
+/// SparseFunction<double,size_t,size_t> f(shape.begin(),shape.end(),0.0);
+/// f.insert(coordinate,1.0);
+/// SparseFunction<double,size_t,size_t,SortedArrayMap<size_t,double> > frozen(f);
+/// \endcode
+///
+/// \ingroup functions
 template<class T,class I,class L,class CONTAINER=std::map<I,T> >
 class SparseFunction   : public FunctionBase<SparseFunction<T, I, L,CONTAINER>, T, I, L> {
 public:
@@ -53,6 +71,27 @@ public:
         }
     }
 
+    /// convert a sparse function with another container type
+    template<class OTHER_CONTAINER>
+    explicit SparseFunction(const SparseFunction<T,I,L,OTHER_CONTAINER>& other):
+    dimension_(other.dimension()),
+    defaultValue_(other.defaultValue()),
+    container_(){
+        shape_.resize(dimension_);
+        strides_.resize(dimension_);
+        LabelType strideVal=1;
+        for(unsigned short  dim=0;dim<dimension_;++dim){
+            shape_[dim]=other.shape(dim);
+            strides_[dim]=strideVal;
+            strideVal*=shape_[dim];
+        }
+        reserveContainer(container_,other.container().size());
+        typedef typename SparseFunction<T,I,L,OTHER_CONTAINER>::ConstContainerIteratorType OtherIteratorType;
+        for(OtherIteratorType it=other.container().begin();it!=other.container().end();++it){
+            container_.insert(KeyValPairType(static_cast<KeyType>(it->first),it->second));
+        }
+    }
+
     size_t size()const{
       size_t size =1;
       for(unsigned short  dim=0;dim<dimension_;++dim){
@@ -177,6 +216,18 @@ public:
     }
 
 private:
+    template<class C>
+    static void reserveContainer(C&,const size_t){
+    }
+    template<class K,class V>
+    static void reserveContainer(OpenAddressingMap<K,V>& container,const size_t n){
+        container.reserve(n);
+    }
+    template<class K,class V>
+    static void reserveContainer(SortedArrayMap<K,V>& container,const size_t n){
+        container.reserve(n);
+    }
+
     unsigned short dimension_;
     ValueType defaultValue_;        
     ContainerType container_;
@@ -134,6 +134,16 @@ public:
    }
 };
 
+/// \brief meta function, true for function types whose values depend linearly on
+/// an opengm::Parameters object (learnable functions)
+///
+/// Learnable functions implement numberOfParameters(), parameterIndex(paramNumber)
+/// and parameterGradient(paramNumber, labelIterator), the derivative of the
+/// function value w.r.t. the parameter.
+template<class FUNCTION>
+struct IsLearnableFunction : meta::FalseCase {
+};
+
 
 
 
@@ -51,6 +51,11 @@ public:
    IndexType parameterIndex(const size_t paramNumber)const{
       return piValueNotEqual_;
    }
+   template<class ITERATOR>
+   ValueType parameterGradient(const size_t paramNumber, ITERATOR begin)const{
+      OPENGM_ASSERT(paramNumber==0);
+      return (begin[0]==begin[1] ? static_cast<ValueType>(0) : static_cast<ValueType>(1));
+   }
 
 
 private:
@@ -72,6 +77,10 @@ struct FunctionRegistration<LPottsFunction<T, I, L> > {
    };
 };
 
+template<class T, class I, class L>
+struct IsLearnableFunction<LPottsFunction<T, I, L> > : meta::TrueCase {
+};
+
 
 
 
@@ -373,6 +373,7 @@ GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::addVariable
    const IndexType nLabels
 ) 
 {
+   this->invalidateAdjacency();
    space_.addVariable(nLabels);
    variableFactorAdjaceny_.push_back(RandomAccessSet<size_t>());
    return space_.numberOfVariables() - 1;    
@@ -660,6 +661,7 @@ GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::addFactor
 ) 
 {
   
+   this->invalidateAdjacency();
    const IndexType indexInVisVector = factorsVis_.size();
    IndexType factorOrder = 0;
    while(begin!=end){
@@ -712,6 +714,7 @@ GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::addFactorNonFinalized
 {
 
 
+   this->invalidateAdjacency();
    const IndexType indexInVisVector = factorsVis_.size();
    IndexType factorOrder = 0;
    while(begin!=end){
@@ -747,6 +750,7 @@ GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::addFactorNonFinalized
 template<class T, class OPERATOR, class FUNCTION_TYPE_LIST, class SPACE>
 void 
 GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::finalize(){
+   this->invalidateAdjacency();
 
    std::vector<std::set<IndexType> >  variableFactorAdjaceny(this->numberOfVariables());
    for(IndexType fi=0; fi < this->numberOfFactors();++fi){
@@ -772,6 +776,7 @@ GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>::operator=
    const GraphicalModel<T, OPERATOR, FUNCTION_TYPE_LIST, SPACE>& gm
 ) {
    if(this!=&gm) {
+      this->invalidateAdjacency();
       this->space_ = gm.space_;
       this->functionDataField_=gm.functionDataField_;
       this->factors_.resize(gm.factors_.size());
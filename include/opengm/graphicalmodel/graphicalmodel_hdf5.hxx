@@ -552,6 +552,7 @@ void load
 
    marray::hdf5::closeGroup(group);
    marray::hdf5::closeFile(file);
+   gm.invalidateAdjacency();
    gm.variableFactorAdjaceny_.resize(gm.numberOfVariables());
    // adjacenies
 
@@ -3,9 +3,13 @@
 #define OPENGM_GRAPHICALMODEL_MANIPULATOR_HXX
 
 #include <exception>
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <queue>
+#include <deque>
+#include <limits>
+#include <cstddef>
 
 #include "opengm/graphicalmodel/graphicalmodel.hxx"
 #include "opengm/graphicalmodel/space/discretespace.hxx"
@@ -19,6 +23,10 @@
 
 #include <iostream>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace opengm {
 
 /// \brief GraphicalModelManipulator
@@ -40,6 +48,11 @@ namespace opengm {
 /// Corresponding author: Jörg Hendrik Kappes
 ///
 /// Invariant: Order of the variables in the modified subgraphs is the same as in the original graph
+///
+/// With incremental updates enabled, buildModifiedSubModels only recomputes the
+/// connected components that are touched by variables whose fixation changed since
+/// the last call and rebuilds only their sub-models. The other sub-models are kept.
+/// This requires the original model to stay unchanged between the calls.
 /// See also: reducedinference.hxx
 ///
 /// \ingroup graphical_models
@@ -70,7 +83,7 @@ namespace opengm {
 
       //BuildModels
       void buildModifiedModel();
-      void buildModifiedSubModels();
+      void buildModifiedSubModels(const size_t numberOfThreads = 0);
 
       //Get Models
       const OGM& getOriginalModel() const;
@@ -81,7 +94,11 @@ namespace opengm {
       size_t numberOfSubmodels() const;
       void modifiedState2OriginalState(const std::vector<LabelType>&, std::vector<LabelType>&) const;
       void modifiedSubStates2OriginalState(const std::vector<std::vector<LabelType> >&, std::vector<LabelType>&) const;
+      void originalState2ModifiedSubStates(const std::vector<LabelType>&, std::vector<std::vector<LabelType> >&) const;
       bool isLocked() const;
+      void setIncrementalUpdates(const bool);
+      size_t numberOfRebuiltSubmodels() const;
+      bool isRebuiltSubmodel(const size_t) const;
 
       //Manipulation
       void fixVariable(const typename GM::IndexType, const typename GM::LabelType);
@@ -93,7 +110,7 @@ namespace opengm {
       bool isFixed(const typename GM::IndexType)const;
 
    private:
-      void expand(IndexType, IndexType,  std::vector<bool>&);
+      IndexType assignSubProblems(std::vector<size_t>&);
 
       //General Members
       const OGM& gm_;                            // original model
@@ -108,9 +125,18 @@ namespace opengm {
 
       //Modified SubModels
       bool validSubModels_;                      // true if themodified submodels are valid            
-      std::vector<MGM> submodels_;               // modified submodels           
+      std::deque<MGM> submodels_;                // storage of the modified submodels
+      std::vector<size_t> subModelSlot_;         // storage index of the submodel of each subproblem
       std::vector<IndexType> var2subProblem_;    // subproblem of variable (for fixed variables undefined)
 
+      //Incremental Updates
+      bool incremental_;                         // if true untouched submodels are kept
+      bool hasPreviousSubModels_;                // true if the stored submodels belong to the previous state
+      std::vector<bool> previousFixVariable_;    // fixed variables when the submodels were built
+      std::vector<LabelType> previousFixVariableLabel_;
+      size_t numberOfRebuiltSubmodels_;
+      std::vector<bool> rebuiltSubModel_;        // true if the sub-model of the subproblem was built by the last call
+
       //Tentacles
      std::vector<IndexType> tentacleRoots_;                                                    // Root-node of the tentacles 
      std::vector<opengm::ExplicitFunction<ValueType,IndexType,LabelType> > tentacleFunctions_; // functions that replace the tentacles 
@@ -138,7 +164,10 @@ namespace opengm {
         mode_(mode),
         validModel_(false), 
         validSubModels_(false),
-        var2subProblem_(std::vector<IndexType>(gm.numberOfVariables(),0))
+        var2subProblem_(std::vector<IndexType>(gm.numberOfVariables(),0)),
+        incremental_(false),
+        hasPreviousSubModels_(false),
+        numberOfRebuiltSubmodels_(0)
    {
       return;
    }
@@ -166,8 +195,8 @@ namespace opengm {
    GraphicalModelManipulator<GM>::getModifiedSubModel(size_t i) const
    {
       OPENGM_ASSERT(isLocked() && validSubModels_);
-      OPENGM_ASSERT(i < submodels_.size()); 
-      return submodels_[i];
+      OPENGM_ASSERT(i < subModelSlot_.size()); 
+      return submodels_[subModelSlot_[i]];
    }
 
 /// \brief return the number of submodels
@@ -175,7 +204,40 @@ namespace opengm {
    size_t GraphicalModelManipulator<GM>::numberOfSubmodels() const
    { 
       OPENGM_ASSERT(isLocked());
-      return submodels_.size();
+      return subModelSlot_.size();
+   }
+
+/// \brief enable or disable incremental updates of the sub-models
+///
+/// If enabled, the sub-models are kept by unlock() and buildModifiedSubModels()
+/// rebuilds only the sub-models of components that contain or touch a variable 
+/// that was fixed, freed or relabeled since the previous call.
+   template<class GM>
+   void GraphicalModelManipulator<GM>::setIncrementalUpdates(const bool incremental)
+   {
+      incremental_ = incremental;
+      if(!incremental_){
+         hasPreviousSubModels_ = false;
+      }
+   }
+
+/// \brief return the number of sub-models built by the last call of buildModifiedSubModels
+   template<class GM>
+   size_t GraphicalModelManipulator<GM>::numberOfRebuiltSubmodels() const
+   { 
+      return numberOfRebuiltSubmodels_;
+   }
+
+/// \brief true if the sub-model of subproblem i was built by the last call of buildModifiedSubModels
+///
+/// Sub-models that were kept by an incremental update are identical to 
+/// sub-models of the previous call, i.e. they have the same variables and factors.
+   template<class GM>
+   bool GraphicalModelManipulator<GM>::isRebuiltSubmodel(const size_t i) const
+   { 
+      OPENGM_ASSERT(isLocked() && validSubModels_);
+      OPENGM_ASSERT(i < rebuiltSubModel_.size()); 
+      return rebuiltSubModel_[i];
    }
 
 /// \brief unlock model
@@ -185,7 +247,11 @@ namespace opengm {
       locked_=false;
       validSubModels_=false;
       validModel_=false;
-      submodels_.clear();
+      if(!incremental_){
+         submodels_.clear();
+         subModelSlot_.clear();
+         hasPreviousSubModels_=false;
+      }
       freeAllVariables();
    }
 
@@ -272,9 +338,9 @@ namespace opengm {
    void GraphicalModelManipulator<GM>::modifiedSubStates2OriginalState(const std::vector<std::vector<LabelType> >& subconf, std::vector<LabelType>& conf) const
    {  
       conf.resize(gm_.numberOfVariables());
-      std::vector<IndexType> varCount(submodels_.size(),0);
-      for(IndexType i=0;i<submodels_.size(); ++i){
-          OPENGM_ASSERT(submodels_[i].numberOfVariables()==subconf[i].size());
+      std::vector<IndexType> varCount(subModelSlot_.size(),0);
+      for(IndexType i=0;i<subModelSlot_.size(); ++i){
+          OPENGM_ASSERT(submodels_[subModelSlot_[i]].numberOfVariables()==subconf[i].size());
       }
       for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
          if(fixVariable_[var]){
@@ -293,6 +359,27 @@ namespace opengm {
         OPENGM_ASSERT( l == conf[tentacleRoots_[i]] );
       } 
    }
+
+/// \brief restrict a labeling of the original problem to the modified subproblems 
+///
+/// Labels of fixed variables are ignored, tentacles are not supported.
+   template<class GM>
+   void GraphicalModelManipulator<GM>::originalState2ModifiedSubStates(const std::vector<LabelType>& conf, std::vector<std::vector<LabelType> >& subconf) const
+   {  
+      OPENGM_ASSERT(isLocked() && validSubModels_);
+      OPENGM_ASSERT(conf.size()==gm_.numberOfVariables());
+      OPENGM_ASSERT(tentacleRoots_.empty());
+      subconf.resize(subModelSlot_.size());
+      for(IndexType i=0;i<subModelSlot_.size(); ++i){
+         subconf[i].resize(0);
+         subconf[i].reserve(submodels_[subModelSlot_[i]].numberOfVariables());
+      }
+      for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
+         if(!fixVariable_[var]){
+            subconf[var2subProblem_[var]].push_back(conf[var]);
+         }
+      }
+   }
  
 /// \brief build modified model
    template<class GM>
@@ -381,26 +468,51 @@ namespace opengm {
    }
 
 /// \brief build modified sub-models 
+///
+/// The connected components are assigned in a sequential sweep, afterwards the
+/// sub-models are independent of each other and are filled concurrently if
+/// OpenGM is compiled with OpenMP. The order of variables and factors inside each 
+/// sub-model is the same as in the sequential construction. With incremental 
+/// updates only the sub-models of changed components are built.
+///
+/// \param numberOfThreads number of threads used to fill the sub-models (0 = OpenMP default)
    template<class GM>
    void
-   GraphicalModelManipulator<GM>::buildModifiedSubModels()
+   GraphicalModelManipulator<GM>::buildModifiedSubModels(const size_t numberOfThreads)
    {
       locked_ = true; 
       validSubModels_ = true;
       
-      //Find Connected Components
-      std::vector<bool> closedVar   = fixVariable_;
-      IndexType numberOfSubproblems = 0;
-      for(IndexType var=0 ; var<gm_.numberOfVariables(); ++var){
-         if(closedVar[var])
-            continue;
-         else{
-            expand(var, numberOfSubproblems, closedVar); 
+      //Find Connected Components, kept sub-models are moved to their new subproblem
+      const size_t noSlot = std::numeric_limits<size_t>::max();
+      std::vector<size_t> keptSlot;
+      const IndexType numberOfSubproblems = assignSubProblems(keptSlot);
+      {
+         std::vector<size_t> freeSlots;
+         std::vector<bool> usedSlot(submodels_.size(),false);
+         for(IndexType sp=0; sp<numberOfSubproblems; ++sp){
+            if(keptSlot[sp]!=noSlot) usedSlot[keptSlot[sp]]=true;
+         }
+         for(size_t slot=0; slot<submodels_.size(); ++slot){
+            if(!usedSlot[slot]){
+               submodels_[slot] = MGM();
+               freeSlots.push_back(slot);
+            }
+         }
+         std::reverse(freeSlots.begin(),freeSlots.end());
+         subModelSlot_.resize(numberOfSubproblems);
+         for(IndexType sp=0; sp<numberOfSubproblems; ++sp){
+            if(keptSlot[sp]!=noSlot){
+               subModelSlot_[sp] = keptSlot[sp];
+            }else if(!freeSlots.empty()){
+               subModelSlot_[sp] = freeSlots.back();
+               freeSlots.pop_back();
+            }else{
+               subModelSlot_[sp] = submodels_.size();
+               submodels_.push_back(MGM());
+            }
          }
-         ++numberOfSubproblems;
       }
-      if(numberOfSubproblems==0) numberOfSubproblems=1;
-      submodels_.resize(numberOfSubproblems); 
       std::vector<IndexType> numberOfVariables(numberOfSubproblems,0);
       std::vector<IndexType> varMap(gm_.numberOfVariables(),0);
       for(IndexType var=0; var<gm_.numberOfVariables();++var){
@@ -417,69 +529,128 @@ namespace opengm {
             shape[var2subProblem_[var]][varMap[var]] = gm_.numberOfLabels(var);
          }
       }
-      for (size_t i=0; i<numberOfSubproblems; ++i){
-         MSpaceType space(shape[i].begin(),shape[i].end());
-         submodels_[i] = MGM(space); 
-      }
-    
-      std::vector<PositionAndLabel<IndexType,LabelType> > fixedVars;
-      std::vector<IndexType> MVars;
 
+      // Assign factors to sub-problems (compressed row storage) and 
+      // accumulate the factors whose variables are all fixed into a constant
+      const IndexType noSubproblem = numberOfSubproblems;
+      std::vector<IndexType> factor2subProblem(gm_.numberOfFactors(),noSubproblem);
+      std::vector<IndexType> subProblemFactorBegin(numberOfSubproblems+1,0);
       ValueType constant;
       GM::OperatorType::neutral(constant);
-
-      for(IndexType f=0; f<gm_.numberOfFactors();++f){
-	 if(tentacleFactor_[f]) continue; 
-         IndexType subproblem = 0;
-         fixedVars.resize(0); 
-         MVars.resize(0);
-         for(IndexType i=0; i<gm_[f].numberOfVariables(); ++i){
-            const IndexType var = gm_[f].variableIndex(i);
-            if(fixVariable_[var]){
-               fixedVars.push_back(PositionAndLabel<IndexType,LabelType>(i,fixVariableLabel_[var]));
+      {
+         std::vector<LabelType> fixedStates;
+         for(IndexType f=0; f<gm_.numberOfFactors();++f){
+            if(tentacleFactor_[f]) continue; 
+            bool hasFixedVar = false;
+            for(IndexType i=0; i<gm_[f].numberOfVariables(); ++i){
+               const IndexType var = gm_[f].variableIndex(i);
+               if(fixVariable_[var]){
+                  hasFixedVar = true;
+               }else{
+                  factor2subProblem[f] = var2subProblem_[var];
+               }
+            }
+            if(mode_==FIX){
+               if(factor2subProblem[f]==noSubproblem){ //constant, all fixed
+                  fixedStates.resize(gm_[f].numberOfVariables());
+                  for(IndexType i=0; i<gm_[f].numberOfVariables(); ++i){
+                     fixedStates[i]=fixVariableLabel_[ gm_[f].variableIndex(i)];
+                  }     
+                  GM::OperatorType::op(gm_[f](fixedStates.begin()),constant);  
+               }
+            } else if(mode_==DROP){
+               if(hasFixedVar){
+                  factor2subProblem[f] = noSubproblem;
+               }else if(factor2subProblem[f]==noSubproblem){
+                  factor2subProblem[f] = 0;
+               }
             }else{
-               MVars.push_back(varMap[var]);
-               subproblem = var2subProblem_[var];
+               throw std::runtime_error("Unsupported manipulation mode"); 
+            }
+            if(factor2subProblem[f]!=noSubproblem && keptSlot[factor2subProblem[f]]!=noSlot){
+               factor2subProblem[f] = noSubproblem;
+            }
+            if(factor2subProblem[f]!=noSubproblem){
+               ++subProblemFactorBegin[factor2subProblem[f]+1];
             }
          }
-         if(mode_==FIX){
-            if(MVars.size()==0){ //constant, all fixed
-               std::vector<LabelType> fixedStates(gm_[f].numberOfVariables(),0);
-               for(IndexType i=0; i<gm_[f].numberOfVariables(); ++i){
-                  fixedStates[i]=fixVariableLabel_[ gm_[f].variableIndex(i)];
-               }     
-               GM::OperatorType::op(gm_[f](fixedStates.begin()),constant);  
+      }
+      for (size_t i=0; i<numberOfSubproblems; ++i){
+         subProblemFactorBegin[i+1] += subProblemFactorBegin[i];
+      }
+      std::vector<IndexType> subProblemFactors(subProblemFactorBegin.back());
+      {
+         std::vector<IndexType> fill(subProblemFactorBegin.begin(),subProblemFactorBegin.end()-1);
+         for(IndexType f=0; f<gm_.numberOfFactors();++f){
+            if(factor2subProblem[f]!=noSubproblem){
+               subProblemFactors[fill[factor2subProblem[f]]++] = f;
             }
-            else if(fixedVars.size()==0){//non fixed
-               const ViewFunction<GM> func(gm_[f]);
-               submodels_[subproblem].addFactor(submodels_[subproblem].addFunction(func),MVars.begin(), MVars.end());    
-            }else{
-               const ViewFixVariablesFunction<GM> func(gm_[f], fixedVars);
-               submodels_[subproblem].addFactor(submodels_[subproblem].addFunction(func),MVars.begin(), MVars.end());
+         }
+      }
+
+      // Build the sub-models, each sub-model is only touched by one thread
+      const std::ptrdiff_t numberOfSubproblemsS = static_cast<std::ptrdiff_t>(numberOfSubproblems);
+#ifdef WITH_OPENMP
+      const int numThreads = numberOfThreads>0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic,1) num_threads(numThreads)
+#endif
+      for(std::ptrdiff_t sp=0; sp<numberOfSubproblemsS; ++sp){
+         if(keptSlot[sp]!=noSlot) continue;
+         MGM& smgm = submodels_[subModelSlot_[sp]];
+         smgm = MGM(MSpaceType(shape[sp].begin(),shape[sp].end()));
+         smgm.reserveFactors(subProblemFactorBegin[sp+1]-subProblemFactorBegin[sp]);
+         std::vector<PositionAndLabel<IndexType,LabelType> > fixedVars;
+         std::vector<IndexType> MVars;
+         for(IndexType n=subProblemFactorBegin[sp]; n<subProblemFactorBegin[sp+1]; ++n){
+            const IndexType f = subProblemFactors[n];
+            fixedVars.resize(0); 
+            MVars.resize(0);
+            for(IndexType i=0; i<gm_[f].numberOfVariables(); ++i){
+               const IndexType var = gm_[f].variableIndex(i);
+               if(fixVariable_[var]){
+                  fixedVars.push_back(PositionAndLabel<IndexType,LabelType>(i,fixVariableLabel_[var]));
+               }else{
+                  MVars.push_back(varMap[var]);
+               }
             }
-         } else if(mode_==DROP){
             if(fixedVars.size()==0){//non fixed
                const ViewFunction<GM> func(gm_[f]);
-               submodels_[subproblem].addFactor(submodels_[subproblem].addFunction(func),MVars.begin(), MVars.end());    
+               smgm.addFactor(smgm.addFunction(func),MVars.begin(), MVars.end());    
+            }else{
+               const ViewFixVariablesFunction<GM> func(gm_[f], fixedVars);
+               smgm.addFactor(smgm.addFunction(func),MVars.begin(), MVars.end());
             }
-         }else{
-            throw std::runtime_error("Unsupported manipulation mode"); 
          }
-      } 
+      }
+
       if(mode_==FIX){
          // Add Tentacle nodes
          for(size_t i=0; i<tentacleRoots_.size(); ++i){
             IndexType var = varMap[tentacleRoots_[i]];
-            IndexType subproblem = var2subProblem_[tentacleRoots_[i]];
-            submodels_[subproblem].addFactor(submodels_[subproblem].addFunction(tentacleFunctions_[i]), &var, &var+1);
+            MGM& smgm = submodels_[subModelSlot_[var2subProblem_[tentacleRoots_[i]]]];
+            smgm.addFactor(smgm.addFunction(tentacleFunctions_[i]), &var, &var+1);
          }
          {
             //std::cout <<"Const= "<<constant<<std::endl;
             LabelType temp;
+            std::vector<IndexType> MVars;
             ConstantFunction<ValueType, IndexType, LabelType> func(&temp, &temp, constant);
-            submodels_[0].addFactor( submodels_[0].addFunction(func),MVars.begin(), MVars.begin());
+            MGM& smgm = submodels_[subModelSlot_[0]];
+            smgm.addFactor( smgm.addFunction(func),MVars.begin(), MVars.begin());
          }  
       }
+
+      numberOfRebuiltSubmodels_ = 0;
+      rebuiltSubModel_.assign(numberOfSubproblems,false);
+      for(IndexType sp=0; sp<numberOfSubproblems; ++sp){
+         if(keptSlot[sp]==noSlot){
+            ++numberOfRebuiltSubmodels_;
+            rebuiltSubModel_[sp] = true;
+         }
+      }
+      previousFixVariable_      = fixVariable_;
+      previousFixVariableLabel_ = fixVariableLabel_;
+      hasPreviousSubModels_     = incremental_;
       //std::cout << " numvars : " << submodels_[0].numberOfVariables() <<std::endl;
    }
 
@@ -849,22 +1020,89 @@ namespace opengm {
 ////////////////////
 // Private Methods
 ////////////////////    
+/// \brief assign the free variables to connected components
+///
+/// The subproblems are numbered in the order of their first variable. With
+/// incremental updates, components of the previous call that neither contain
+/// nor touch a changed variable are kept, only the other variables are
+/// regrouped. For each subproblem the storage slot of its kept sub-model is
+/// returned (or the maximal size_t if the sub-model needs to be built).
    template<class GM>
-   void
-   GraphicalModelManipulator<GM>::expand(IndexType var, IndexType CCN,  std::vector<bool>& closedVar)
+   typename GraphicalModelManipulator<GM>::IndexType
+   GraphicalModelManipulator<GM>::assignSubProblems(std::vector<size_t>& keptSlot)
    {
-      if(closedVar[var])
-         return;
-      else{
-         closedVar[var]       = true;
-         var2subProblem_[var] = CCN;
-         for( typename GM::ConstFactorIterator itf = gm_.factorsOfVariableBegin(var); itf!=gm_.factorsOfVariableEnd(var); ++itf){
-            for( typename  GM::ConstVariableIterator itv = gm_.variablesOfFactorBegin(*itf); itv!=gm_.variablesOfFactorEnd(*itf);++itv){
-               expand(*itv, CCN, closedVar);
+      const size_t    noSlot  = std::numeric_limits<size_t>::max();
+      const IndexType noLabel = std::numeric_limits<IndexType>::max();
+      const IndexType numberOfPreviousSubproblems = static_cast<IndexType>(subModelSlot_.size());
+      std::vector<IndexType> component(gm_.numberOfVariables(), noLabel);
+      IndexType numberOfComponents = 0;
+
+      const bool update = incremental_ && hasPreviousSubModels_ && tentacleRoots_.empty() 
+         && previousFixVariable_.size()==gm_.numberOfVariables();
+      if(update){
+         // previous components that contain or touch a changed variable
+         std::vector<bool> touched(numberOfPreviousSubproblems, false);
+         for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
+            const bool changed = fixVariable_[var]!=previousFixVariable_[var] 
+               || (fixVariable_[var] && mode_==FIX && fixVariableLabel_[var]!=previousFixVariableLabel_[var]);
+            if(!changed) continue;
+            if(!previousFixVariable_[var]) touched[var2subProblem_[var]] = true;
+            for(typename GM::ConstFactorIterator itf=gm_.factorsOfVariableBegin(var); itf!=gm_.factorsOfVariableEnd(var); ++itf){
+               for(typename GM::ConstVariableIterator itv=gm_.variablesOfFactorBegin(*itf); itv!=gm_.variablesOfFactorEnd(*itf); ++itv){
+                  if(!previousFixVariable_[*itv]) touched[var2subProblem_[*itv]] = true;
+               }
+            }
+         }
+         // the first sub-model carries the factors without free variables
+         if(numberOfPreviousSubproblems>0) touched[0] = true;
+         for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
+            if(!previousFixVariable_[var] && !touched[var2subProblem_[var]]){
+               component[var] = var2subProblem_[var];
+            }
+         }
+         numberOfComponents = numberOfPreviousSubproblems;
+      }
+
+      // group the remaining free variables by breadth first search
+      std::vector<IndexType> queue;
+      for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
+         if(fixVariable_[var] || component[var]!=noLabel) continue;
+         component[var] = numberOfComponents;
+         queue.assign(1, var);
+         for(size_t n=0; n<queue.size(); ++n){
+            const IndexType v = queue[n];
+            for(typename GM::ConstFactorIterator itf=gm_.factorsOfVariableBegin(v); itf!=gm_.factorsOfVariableEnd(v); ++itf){
+               for(typename GM::ConstVariableIterator itv=gm_.variablesOfFactorBegin(*itf); itv!=gm_.variablesOfFactorEnd(*itf); ++itv){
+                  if(!fixVariable_[*itv] && component[*itv]==noLabel){
+                     component[*itv] = numberOfComponents;
+                     queue.push_back(*itv);
+                  }
+               }
             }
          }
+         ++numberOfComponents;
       }
-    }
+
+      // number the subproblems by their first variable
+      std::vector<IndexType> subProblem(numberOfComponents, noLabel);
+      IndexType numberOfSubproblems = 0;
+      keptSlot.clear();
+      for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
+         if(fixVariable_[var]) continue;
+         const IndexType c = component[var];
+         if(subProblem[c]==noLabel){
+            subProblem[c] = numberOfSubproblems++;
+            keptSlot.push_back(update && c<numberOfPreviousSubproblems ? subModelSlot_[c] : noSlot);
+         }
+         var2subProblem_[var] = subProblem[c];
+      }
+      if(numberOfSubproblems==0){
+         numberOfSubproblems = 1;
+         keptSlot.push_back(noSlot);
+      }
+      keptSlot[0] = noSlot;
+      return numberOfSubproblems;
+   }
 
    
 } //namespace opengm
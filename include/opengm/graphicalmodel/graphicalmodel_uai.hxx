@@ -0,0 +1,677 @@
+#pragma once
+#ifndef OPENGM_GRAPHICALMODEL_UAI_HXX
+#define OPENGM_GRAPHICALMODEL_UAI_HXX
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define OPENGM_UAI_MMAP
+#endif
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/opengm.hxx"
+#include "opengm/functions/explicit_function.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+
+namespace opengm {
+
+/// File I/O of graphical models in the text format of the UAI inference competitions
+///
+/// A model file consists of a preamble (network type, number of variables,
+/// their numbers of labels, number of factors and the scope of each factor)
+/// followed by one table per factor. Each table lists its number of entries
+/// and the entries with the label of the last variable of the scope changing
+/// fastest. Tables of MARKOV and BAYES networks are probabilities, they are
+/// converted to energies -log(p) on load and back on save unless this is
+/// switched off.
+namespace uai {
+
+/// energy assigned to a table entry of probability zero
+static const double zeroProbabilityEnergy = 10000000.0;
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_uai {
+
+/// read-only view of a whole file, memory-mapped where possible
+class FileBuffer {
+public:
+   FileBuffer(const std::string& filename)
+   :  data_(NULL), size_(0), mapped_(false) {
+      #ifdef OPENGM_UAI_MMAP
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0) {
+         throw RuntimeError("Could not open file " + filename);
+      }
+      struct stat status;
+      if(::fstat(fd, &status) != 0) {
+         ::close(fd);
+         throw RuntimeError("Could not read the size of file " + filename);
+      }
+      size_ = static_cast<size_t>(status.st_size);
+      if(size_ > 0) {
+         void* data = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+         if(data != MAP_FAILED) {
+            data_ = static_cast<const char*>(data);
+            mapped_ = true;
+            ::madvise(data, size_, MADV_SEQUENTIAL);
+         }
+      }
+      ::close(fd);
+      if(mapped_ || size_ == 0) {
+         return;
+      }
+      #endif
+      std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+      if(!file.is_open()) {
+         throw RuntimeError("Could not open file " + filename);
+      }
+      file.seekg(0, std::ios::end);
+      buffer_.resize(static_cast<size_t>(file.tellg()));
+      file.seekg(0, std::ios::beg);
+      if(!buffer_.empty()) {
+         file.read(&buffer_[0], buffer_.size());
+      }
+      data_ = buffer_.empty() ? NULL : &buffer_[0];
+      size_ = buffer_.size();
+   }
+   ~FileBuffer() {
+      #ifdef OPENGM_UAI_MMAP
+      if(mapped_) {
+         ::munmap(const_cast<char*>(data_), size_);
+      }
+      #endif
+   }
+   const char* begin() const { return data_; }
+   const char* end() const { return data_ + size_; }
+   size_t size() const { return size_; }
+
+private:
+   FileBuffer(const FileBuffer&);
+   FileBuffer& operator=(const FileBuffer&);
+
+   const char* data_;
+   size_t size_;
+   bool mapped_;
+   std::vector<char> buffer_;
+};
+
+inline bool isSpace(const char c) {
+   return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline const char* skipSpace(const char* p, const char* end) {
+   while(p != end && isSpace(*p)) {
+      ++p;
+   }
+   return p;
+}
+
+inline const char* skipToken(const char* p, const char* end) {
+   while(p != end && !isSpace(*p)) {
+      ++p;
+   }
+   return p;
+}
+
+/// parses the number in [begin, end).
+///
+/// Decimal numbers with at most 15 significant digits and a decimal exponent
+/// of at most 22 are computed exactly from an integer mantissa and a power
+/// of ten. Everything else is passed to strtod. Both yield the correctly
+/// rounded double.
+inline double parseNumber(const char* begin, const char* end) {
+   static const double powersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+   };
+   const char* p = begin;
+   bool negative = false;
+   if(p != end && (*p == '-' || *p == '+')) {
+      negative = (*p == '-');
+      ++p;
+   }
+   unsigned long long mantissa = 0;
+   int significantDigits = 0;
+   int exponent = 0;
+   bool anyDigit = false;
+   bool fast = true;
+   for(; p != end && *p >= '0' && *p <= '9'; ++p) {
+      anyDigit = true;
+      if(mantissa != 0 || *p != '0') {
+         if(significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned long long>(*p - '0');
+            ++significantDigits;
+         }
+         else {
+            fast = false;
+         }
+      }
+   }
+   if(p != end && *p == '.') {
+      for(++p; p != end && *p >= '0' && *p <= '9'; ++p) {
+         anyDigit = true;
+         if(mantissa != 0 || *p != '0') {
+            if(significantDigits < 19) {
+               mantissa = mantissa * 10 + static_cast<unsigned long long>(*p - '0');
+               ++significantDigits;
+            }
+            else {
+               fast = false;
+            }
+         }
+         --exponent;
+      }
+   }
+   if(anyDigit && p != end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      bool negativeExponent = false;
+      if(p != end && (*p == '-' || *p == '+')) {
+         negativeExponent = (*p == '-');
+         ++p;
+      }
+      if(p == end) {
+         fast = false;
+      }
+      int e = 0;
+      for(; p != end && *p >= '0' && *p <= '9'; ++p) {
+         if(e < 10000) {
+            e = e * 10 + (*p - '0');
+         }
+      }
+      exponent += negativeExponent ? -e : e;
+   }
+   if(anyDigit && fast && p == end && significantDigits <= 15 && exponent >= -22 && exponent <= 22) {
+      double value = static_cast<double>(mantissa);
+      if(exponent < 0) {
+         value /= powersOfTen[-exponent];
+      }
+      else {
+         value *= powersOfTen[exponent];
+      }
+      return negative ? -value : value;
+   }
+
+   // inf, nan, hexadecimal and long numbers
+   const std::string token(begin, end);
+   char* tokenEnd = NULL;
+   const double value = std::strtod(token.c_str(), &tokenEnd);
+   if(token.empty() || tokenEnd != token.c_str() + token.size()) {
+      throw RuntimeError("Invalid number in UAI file: " + token);
+   }
+   return value;
+}
+
+/// sequential reader for the preamble
+class Tokenizer {
+public:
+   Tokenizer(const char* begin, const char* end)
+   :  p_(begin), end_(end) {}
+   bool atEnd() {
+      p_ = skipSpace(p_, end_);
+      return p_ == end_;
+   }
+   std::string word(const char* what) {
+      if(atEnd()) {
+         throw RuntimeError(std::string("Bad UAI file format: ") + what + " is missing.");
+      }
+      const char* begin = p_;
+      p_ = skipToken(p_, end_);
+      return std::string(begin, p_);
+   }
+   size_t integer(const char* what) {
+      if(atEnd()) {
+         throw RuntimeError(std::string("Bad UAI file format: ") + what + " is missing.");
+      }
+      size_t value = 0;
+      const char* begin = p_;
+      for(; p_ != end_ && *p_ >= '0' && *p_ <= '9'; ++p_) {
+         value = value * 10 + static_cast<size_t>(*p_ - '0');
+      }
+      if(p_ == begin || (p_ != end_ && !isSpace(*p_))) {
+         throw RuntimeError(std::string("Bad UAI file format: ") + what + " is not a non-negative integer.");
+      }
+      return value;
+   }
+   const char* position() const { return p_; }
+
+private:
+   const char* p_;
+   const char* end_;
+};
+
+/// parses all whitespace separated numbers in [begin, end) in parallel.
+///
+/// The range is cut into chunks at whitespace. The tokens of each chunk are
+/// counted in a first pass, the prefix sums of the counts are the positions
+/// at which the chunks write their numbers in the second pass.
+inline void parseNumbers(const char* begin, const char* end, std::vector<double>& numbers, const size_t numberOfThreads) {
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+   #else
+   const int nThreads = 1;
+   #endif
+   const size_t minimalChunkSize = 1 << 16;
+   const size_t size = static_cast<size_t>(end - begin);
+   const size_t numberOfChunks = std::max<size_t>(1, std::min<size_t>(size / minimalChunkSize, 8 * static_cast<size_t>(nThreads)));
+   std::vector<const char*> chunks(numberOfChunks + 1, end);
+   chunks[0] = begin;
+   for(size_t c = 1; c < numberOfChunks; ++c) {
+      const char* p = std::max(chunks[c - 1], begin + c * (size / numberOfChunks));
+      chunks[c] = skipToken(p, end);
+   }
+
+   std::vector<size_t> offsets(numberOfChunks + 1, 0);
+   #ifdef WITH_OPENMP
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t>(numberOfChunks); ++c) {
+      size_t count = 0;
+      const char* p = skipSpace(chunks[c], chunks[c + 1]);
+      while(p != chunks[c + 1]) {
+         ++count;
+         p = skipSpace(skipToken(p, chunks[c + 1]), chunks[c + 1]);
+      }
+      offsets[c + 1] = count;
+   }
+   for(size_t c = 0; c < numberOfChunks; ++c) {
+      offsets[c + 1] += offsets[c];
+   }
+
+   numbers.resize(offsets.back());
+   bool invalid = false;
+   std::string message;
+   #ifdef WITH_OPENMP
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t>(numberOfChunks); ++c) {
+      try {
+         double* out = numbers.empty() ? NULL : &numbers[offsets[c]];
+         const char* p = skipSpace(chunks[c], chunks[c + 1]);
+         while(p != chunks[c + 1]) {
+            const char* tokenEnd = skipToken(p, chunks[c + 1]);
+            *out++ = parseNumber(p, tokenEnd);
+            p = skipSpace(tokenEnd, chunks[c + 1]);
+         }
+      }
+      catch(std::exception& e) {
+         #ifdef WITH_OPENMP
+         #pragma omp critical(opengm_uai_parse_error)
+         #endif
+         {
+            invalid = true;
+            message = e.what();
+         }
+      }
+   }
+   if(invalid) {
+      throw RuntimeError(message);
+   }
+}
+
+/// hash of a table including its shape
+template<class T, class L>
+inline size_t tableHash(const L* shapeBegin, const L* shapeEnd, const T* valuesBegin, const T* valuesEnd) {
+   size_t hash = static_cast<size_t>(shapeEnd - shapeBegin);
+   for(; shapeBegin != shapeEnd; ++shapeBegin) {
+      hash = hash * 1000003u ^ static_cast<size_t>(*shapeBegin);
+   }
+   for(; valuesBegin != valuesEnd; ++valuesBegin) {
+      const T value = *valuesBegin + T(0); // -0 and +0 hash alike
+      size_t bits = 0;
+      std::memcpy(&bits, &value, std::min(sizeof(T), sizeof(size_t)));
+      hash = hash * 1000003u ^ bits;
+   }
+   return hash;
+}
+
+} // namespace detail_uai
+/// \endcond
+
+/// \brief load a graphical model from a UAI file
+///
+/// The function type list of the model must contain
+/// ExplicitFunction<ValueType, IndexType, LabelType>. The variables of each
+/// factor are sorted and the table is permuted accordingly. Identical tables
+/// share one function.
+///
+/// \param gm graphical model, replaced by the loaded model
+/// \param filename UAI model file
+/// \param negativeLog convert the probabilities p of the file to energies
+/// -log(p), cut off at zeroProbabilityEnergy
+/// \param numberOfThreads number of threads used to parse and convert the
+/// tables (0 = one per core, ignored without OpenMP)
+template<class GM>
+void load
+(
+   GM& gm,
+   const std::string& filename,
+   const bool negativeLog = true,
+   const size_t numberOfThreads = 0
+) {
+   typedef typename GM::ValueType ValueType;
+   typedef typename GM::IndexType IndexType;
+   typedef typename GM::LabelType LabelType;
+   typedef ExplicitFunction<ValueType, IndexType, LabelType> ExplicitFunctionType;
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+   #endif
+
+   detail_uai::FileBuffer file(filename);
+   detail_uai::Tokenizer preamble(file.begin(), file.end());
+
+   // preamble
+   const std::string type = preamble.word("Network type");
+   if(type != "MARKOV" && type != "BAYES") {
+      throw RuntimeError("Unsupported network type \"" + type + "\". Only MARKOV and BAYES networks are supported.");
+   }
+   const size_t numberOfVariables = preamble.integer("Number of variables");
+   std::vector<LabelType> numbersOfLabels(numberOfVariables);
+   for(size_t v = 0; v < numberOfVariables; ++v) {
+      numbersOfLabels[v] = static_cast<LabelType>(preamble.integer("Number of labels"));
+   }
+   const size_t numberOfFactors = preamble.integer("Number of factors");
+   std::vector<size_t> scopeOffsets(numberOfFactors + 1, 0);
+   std::vector<IndexType> scopes;
+   for(size_t f = 0; f < numberOfFactors; ++f) {
+      const size_t order = preamble.integer("Factor scope");
+      for(size_t j = 0; j < order; ++j) {
+         const size_t v = preamble.integer("Factor scope");
+         if(v >= numberOfVariables) {
+            throw RuntimeError("Bad UAI file format: Variable index in factor scope out of range.");
+         }
+         scopes.push_back(static_cast<IndexType>(v));
+      }
+      scopeOffsets[f + 1] = scopes.size();
+   }
+
+   // tables
+   std::vector<double> numbers;
+   detail_uai::parseNumbers(preamble.position(), file.end(), numbers, numberOfThreads);
+   std::vector<size_t> tableOffsets(numberOfFactors + 1, 0);
+   size_t position = 0;
+   for(size_t f = 0; f < numberOfFactors; ++f) {
+      size_t size = 1;
+      for(size_t j = scopeOffsets[f]; j < scopeOffsets[f + 1]; ++j) {
+         size *= numbersOfLabels[scopes[j]];
+      }
+      if(position >= numbers.size() || numbers[position] != static_cast<double>(size)) {
+         throw RuntimeError("Bad UAI file format: Size of a function table does not match the factor scope.");
+      }
+      position += size + 1;
+      tableOffsets[f + 1] = tableOffsets[f] + size;
+   }
+   if(position != numbers.size()) {
+      throw RuntimeError("Bad UAI file format: Function tables do not match the preamble.");
+   }
+
+   // sort the scopes, permute and convert the tables in place of the numbers
+   std::vector<ValueType> tables(tableOffsets.back());
+   std::vector<LabelType> shapes(scopes.size());
+   std::vector<size_t> hashes(numberOfFactors);
+   enum Error { NoError, DuplicateVariable, NegativeProbability };
+   std::vector<unsigned char> errors(numberOfFactors, NoError);
+   #ifdef WITH_OPENMP
+   #pragma omp parallel for schedule(dynamic, 64) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t f = 0; f < static_cast<std::ptrdiff_t>(numberOfFactors); ++f) {
+      const size_t order = scopeOffsets[f + 1] - scopeOffsets[f];
+      IndexType* scope = scopes.empty() ? NULL : &scopes[scopeOffsets[f]];
+      LabelType* shape = shapes.empty() ? NULL : &shapes[scopeOffsets[f]];
+      std::vector<std::pair<IndexType, size_t> > sorted(order);
+      for(size_t j = 0; j < order; ++j) {
+         sorted[j] = std::make_pair(scope[j], j);
+      }
+      std::sort(sorted.begin(), sorted.end());
+      for(size_t j = 1; j < order; ++j) {
+         if(sorted[j].first == sorted[j - 1].first) {
+            errors[f] = DuplicateVariable;
+         }
+      }
+      // stride of each position of the file scope in the first-index-fastest table of the sorted scope
+      std::vector<size_t> strides(order);
+      size_t stride = 1;
+      for(size_t j = 0; j < order; ++j) {
+         scope[j] = sorted[j].first;
+         shape[j] = numbersOfLabels[sorted[j].first];
+         strides[sorted[j].second] = stride;
+         stride *= shape[j];
+      }
+      std::vector<LabelType> labels(order, 0);
+      std::vector<LabelType> fileShape(order);
+      for(size_t j = 0; j < order; ++j) {
+         fileShape[sorted[j].second] = shape[j];
+      }
+      const double* in = &numbers[tableOffsets[f] + f + 1];
+      ValueType* out = &tables[tableOffsets[f]];
+      const size_t size = tableOffsets[f + 1] - tableOffsets[f];
+      size_t target = 0;
+      for(size_t n = 0; n < size; ++n) {
+         double value = in[n];
+         if(negativeLog) {
+            if(value < 0.0) {
+               errors[f] = NegativeProbability;
+            }
+            value = value <= 0.0 ? zeroProbabilityEnergy : std::min(-std::log(value), zeroProbabilityEnergy);
+         }
+         out[target] = static_cast<ValueType>(value);
+         // the label of the last variable of the file scope changes fastest
+         for(size_t j = order; j-- > 0; ) {
+            ++labels[j];
+            target += strides[j];
+            if(labels[j] < fileShape[j]) {
+               break;
+            }
+            target -= strides[j] * labels[j];
+            labels[j] = 0;
+         }
+      }
+      hashes[f] = detail_uai::tableHash(shape, shape + order, out, out + size);
+   }
+   for(size_t f = 0; f < numberOfFactors; ++f) {
+      if(errors[f] == DuplicateVariable) {
+         throw RuntimeError("Bad UAI file format: Variable occurs twice in a factor scope.");
+      }
+      if(errors[f] == NegativeProbability) {
+         throw RuntimeError("Bad UAI file format: Negative probability in function table.");
+      }
+   }
+   numbers.clear();
+
+   // deduplicate tables
+   std::vector<size_t> functionOfFactor(numberOfFactors);
+   std::vector<size_t> representatives;
+   {
+      std::map<size_t, std::vector<size_t> > buckets;
+      for(size_t f = 0; f < numberOfFactors; ++f) {
+         std::vector<size_t>& bucket = buckets[hashes[f]];
+         const size_t order = scopeOffsets[f + 1] - scopeOffsets[f];
+         const size_t size = tableOffsets[f + 1] - tableOffsets[f];
+         bool found = false;
+         for(size_t k = 0; k < bucket.size() && !found; ++k) {
+            const size_t g = representatives[bucket[k]];
+            if(scopeOffsets[g + 1] - scopeOffsets[g] == order
+            && tableOffsets[g + 1] - tableOffsets[g] == size
+            && std::equal(shapes.begin() + scopeOffsets[f], shapes.begin() + scopeOffsets[f + 1], shapes.begin() + scopeOffsets[g])
+            && std::equal(tables.begin() + tableOffsets[f], tables.begin() + tableOffsets[f + 1], tables.begin() + tableOffsets[g])) {
+               functionOfFactor[f] = bucket[k];
+               found = true;
+            }
+         }
+         if(!found) {
+            functionOfFactor[f] = representatives.size();
+            bucket.push_back(representatives.size());
+            representatives.push_back(f);
+         }
+      }
+   }
+
+   // build the model
+   gm = GM(typename GM::SpaceType(numbersOfLabels.begin(), numbersOfLabels.end()));
+   gm.template reserveFunctions<ExplicitFunctionType>(representatives.size());
+   gm.reserveFactors(numberOfFactors);
+   gm.reserveFactorsVarialbeIndices(scopes.size());
+   std::vector<typename GM::FunctionIdentifier> functionIds(representatives.size());
+   for(size_t k = 0; k < representatives.size(); ++k) {
+      const size_t g = representatives[k];
+      const LabelType* shape = shapes.empty() ? NULL : &shapes[0] + scopeOffsets[g];
+      ExplicitFunctionType function(shape, shape + (scopeOffsets[g + 1] - scopeOffsets[g]));
+      for(size_t n = 0; n < function.size(); ++n) {
+         function(n) = tables[tableOffsets[g] + n];
+      }
+      functionIds[k] = gm.addFunction(function);
+   }
+   for(size_t f = 0; f < numberOfFactors; ++f) {
+      gm.addFactorNonFinalized(functionIds[functionOfFactor[f]], scopes.begin() + scopeOffsets[f], scopes.begin() + scopeOffsets[f + 1]);
+   }
+   gm.finalize();
+}
+
+/// \brief load the evidence of a UAI evidence file
+///
+/// Both the current format (number of observed variables followed by
+/// variable-label pairs) and the older format with a leading number of
+/// samples (of which the first is read) are understood. The evidence can be
+/// applied, e.g., with GraphicalModelManipulator::fixVariable.
+///
+/// \param filename UAI evidence file
+/// \param evidence pairs of observed variable and label
+template<class INDEX, class LABEL>
+void loadEvidence
+(
+   const std::string& filename,
+   std::vector<std::pair<INDEX, LABEL> >& evidence
+) {
+   detail_uai::FileBuffer file(filename);
+   detail_uai::Tokenizer tokenizer(file.begin(), file.end());
+   std::vector<size_t> numbers;
+   while(!tokenizer.atEnd()) {
+      numbers.push_back(tokenizer.integer("Evidence"));
+   }
+   evidence.clear();
+   if(numbers.empty()) {
+      return;
+   }
+   size_t offset;
+   if(numbers.size() == 1 + 2 * numbers[0]) {
+      offset = 1;
+   }
+   else if(numbers.size() >= 2 && numbers[0] > 0 && numbers.size() >= 2 + 2 * numbers[1]) {
+      offset = 2;
+   }
+   else {
+      throw RuntimeError("Bad UAI evidence file format.");
+   }
+   const size_t numberOfObservations = numbers[offset - 1];
+   evidence.reserve(numberOfObservations);
+   for(size_t j = 0; j < numberOfObservations; ++j) {
+      evidence.push_back(std::make_pair(static_cast<INDEX>(numbers[offset + 2 * j]), static_cast<LABEL>(numbers[offset + 2 * j + 1])));
+   }
+}
+
+/// \brief save a graphical model as a UAI MARKOV network
+///
+/// The tables of blocks of factors are formatted in parallel and written in
+/// order. All function types are supported.
+///
+/// \param gm graphical model
+/// \param filename UAI model file
+/// \param negativeLog write the probabilities exp(-v) of the values v of the
+/// model instead of the values
+/// \param numberOfThreads number of threads used to format the tables
+/// (0 = one per core, ignored without OpenMP)
+template<class GM>
+void save
+(
+   const GM& gm,
+   const std::string& filename,
+   const bool negativeLog = true,
+   const size_t numberOfThreads = 0
+) {
+   typedef typename GM::LabelType LabelType;
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+   #endif
+
+   std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+   if(!file.is_open()) {
+      throw RuntimeError("Could not open file " + filename);
+   }
+   file << "MARKOV\n" << gm.numberOfVariables() << "\n";
+   for(size_t v = 0; v < gm.numberOfVariables(); ++v) {
+      file << gm.numberOfLabels(v) << (v + 1 == gm.numberOfVariables() ? "" : " ");
+   }
+   file << "\n" << gm.numberOfFactors() << "\n";
+   for(size_t f = 0; f < gm.numberOfFactors(); ++f) {
+      file << gm[f].numberOfVariables();
+      for(size_t j = 0; j < gm[f].numberOfVariables(); ++j) {
+         file << " " << gm[f].variableIndex(j);
+      }
+      file << "\n";
+   }
+
+   const size_t blockSize = 4096;
+   std::vector<std::string> buffers(std::min(blockSize, static_cast<size_t>(gm.numberOfFactors())));
+   for(size_t blockBegin = 0; blockBegin < gm.numberOfFactors(); blockBegin += blockSize) {
+      const size_t blockEnd = std::min(blockBegin + blockSize, static_cast<size_t>(gm.numberOfFactors()));
+      #ifdef WITH_OPENMP
+      #pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+      #endif
+      for(std::ptrdiff_t f = static_cast<std::ptrdiff_t>(blockBegin); f < static_cast<std::ptrdiff_t>(blockEnd); ++f) {
+         std::string& buffer = buffers[f - blockBegin];
+         buffer.clear();
+         const size_t order = gm[f].numberOfVariables();
+         const size_t size = gm[f].size();
+         char number[64];
+         std::snprintf(number, sizeof(number), "\n%lu\n", static_cast<unsigned long>(size));
+         buffer += number;
+         std::vector<LabelType> labels(std::max<size_t>(order, 1), 0);
+         for(size_t n = 0; n < size; ++n) {
+            double value = static_cast<double>(gm[f](labels.begin()));
+            if(negativeLog) {
+               value = std::exp(-value);
+            }
+            std::snprintf(number, sizeof(number), "%.17g", value);
+            buffer += number;
+            // the label of the last variable changes fastest
+            size_t j = order;
+            while(j > 0) {
+               --j;
+               if(++labels[j] < gm[f].numberOfLabels(j)) {
+                  break;
+               }
+               labels[j] = 0;
+            }
+            buffer += (order == 0 || labels[order - 1] == 0 || n + 1 == size) ? '\n' : ' ';
+         }
+      }
+      for(size_t f = blockBegin; f < blockEnd; ++f) {
+         file.write(buffers[f - blockBegin].data(), buffers[f - blockBegin].size());
+      }
+   }
+   if(!file) {
+      throw RuntimeError("Could not write file " + filename);
+   }
+}
+
+} // namespace uai
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_GRAPHICALMODEL_UAI_HXX
@@ -3,11 +3,17 @@
 #define OPENGM_FACTORGRAPH_HXX
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
+#include <vector>
+#include <set>
+#include <utility>
+#include <atomic>
 
 #include "opengm/utilities/accessor_iterator.hxx"
 #include "opengm/datastructures/randomaccessset.hxx"
 #include "opengm/datastructures/partition.hxx"
+#include "opengm/datastructures/compressed_adjacency.hxx"
 
 #include <typeinfo>
 namespace opengm {
@@ -24,6 +30,11 @@ public:
    typedef S SpecialType;
    typedef AccessorIterator<VariableAccessor, true> ConstVariableIterator;
    typedef AccessorIterator<FactorAccessor, true> ConstFactorIterator;
+   typedef CompressedAdjacency<IndexType> AdjacencyType;
+
+   FactorGraph();
+   FactorGraph(const FactorGraph&);
+   FactorGraph& operator=(const FactorGraph&);
 
    // required interface of S (the template parameter)
    size_t numberOfVariables() const;
@@ -60,7 +71,14 @@ public:
    void factorAdjacencyList(std::vector<std::set<IndexType>  >&) const;
    void factorAdjacencyList(std::vector<RandomAccessSet<IndexType> >&) const;
 
+   // cached adjacency (built on first use)
+   const AdjacencyType& variableAdjacency() const;
+   const AdjacencyType& factorAdjacency() const;
+   const AdjacencyType& secondOrderAdjacency() const;
+
 protected:
+   void invalidateAdjacency();
+
    // cast operators
    operator S&() 
       { return static_cast<S&>(*this); }
@@ -123,12 +141,93 @@ private:
       size_t variable_;
    };
 
+   class VariableNeighborhood {
+   public:
+      VariableNeighborhood(const FactorGraph<S,I>& factorGraph)
+         : factorGraph_(factorGraph)
+         {}
+      void operator()(const size_t, std::vector<std::pair<I, I> >&) const;
+
+   private:
+      const FactorGraph<S,I>& factorGraph_;
+   };
+
+   class FactorNeighborhood {
+   public:
+      FactorNeighborhood(const FactorGraph<S,I>& factorGraph)
+         : factorGraph_(factorGraph)
+         {}
+      void operator()(const size_t, std::vector<std::pair<I, I> >&) const;
+
+   private:
+      const FactorGraph<S,I>& factorGraph_;
+   };
+
+   class SecondOrderNeighborhood {
+   public:
+      SecondOrderNeighborhood(const FactorGraph<S,I>& factorGraph)
+         : factorGraph_(factorGraph)
+         {}
+      void operator()(const size_t, std::vector<std::pair<I, I> >&) const;
+
+   private:
+      const FactorGraph<S,I>& factorGraph_;
+   };
+
    template<class LIST>
       void templatedVariableAdjacencyList(LIST&) const;
    template<class LIST>
       void templatedFactorAdjacencyList(LIST&) const;
+   template<class NEIGHBORHOOD>
+      const AdjacencyType& cachedAdjacency(AdjacencyType&, std::atomic<bool>&, const size_t, const bool, const bool) const;
+
+   mutable AdjacencyType variableAdjacency_;
+   mutable AdjacencyType factorAdjacency_;
+   mutable AdjacencyType secondOrderAdjacency_;
+   mutable std::atomic<bool> variableAdjacencyValid_;
+   mutable std::atomic<bool> factorAdjacencyValid_;
+   mutable std::atomic<bool> secondOrderAdjacencyValid_;
 };
 
+template<class S,class I>
+inline
+FactorGraph<S,I>::FactorGraph()
+:  variableAdjacency_(),
+   factorAdjacency_(),
+   secondOrderAdjacency_(),
+   variableAdjacencyValid_(false),
+   factorAdjacencyValid_(false),
+   secondOrderAdjacencyValid_(false)
+{}
+
+/// the cached adjacency is not copied but rebuilt on demand
+template<class S,class I>
+inline
+FactorGraph<S,I>::FactorGraph
+(
+   const FactorGraph<S,I>&
+)
+:  variableAdjacency_(),
+   factorAdjacency_(),
+   secondOrderAdjacency_(),
+   variableAdjacencyValid_(false),
+   factorAdjacencyValid_(false),
+   secondOrderAdjacencyValid_(false)
+{}
+
+template<class S,class I>
+inline FactorGraph<S,I>&
+FactorGraph<S,I>::operator=
+(
+   const FactorGraph<S,I>& other
+)
+{
+   if(this != &other) {
+      invalidateAdjacency();
+   }
+   return *this;
+}
+
 /// \brief total number of variable nodes in the factor graph
 /// \return number of variable nodes
 template<class S,class I>
@@ -881,17 +980,12 @@ FactorGraph<S,I>::templatedVariableAdjacencyList
    LIST& out
 ) const
 {
+   const AdjacencyType& adjacency = variableAdjacency();
    out.clear();
    out.resize(numberOfVariables());
-   for(size_t factor=0; factor<numberOfFactors(); ++factor) {
-      for(size_t j=0; j<numberOfVariables(factor); ++j) {
-         for(size_t k=j+1; k<numberOfVariables(factor); ++k) {
-            const size_t variable1 = variableOfFactor(factor, j);
-            const size_t variable2 = variableOfFactor(factor, k);
-            out[variable1].insert(variable2);
-            out[variable2].insert(variable1);
-         }
-      }
+   for(size_t variable=0; variable<numberOfVariables(); ++variable) {
+      const typename AdjacencyType::Range neighbors = adjacency.neighbors(variable);
+      out[variable].insert(neighbors.begin(), neighbors.end());
    }
 }
 
@@ -923,21 +1017,157 @@ FactorGraph<S,I>::templatedFactorAdjacencyList
    LIST& out
 ) const
 {
+   const AdjacencyType& adjacency = factorAdjacency();
    out.clear();
    out.resize(numberOfFactors());
-   for(size_t f=0; f<numberOfFactors(); ++f) {
-      for(size_t v=0 ;v<numberOfVariables(f); ++v) {
-         for(size_t ff=0;ff<numberOfFactors(v);++ff) {
-            const size_t fOfVar=factorOfVariable(v,ff);
-            if(f!=fOfVar) {
-               out[f].insert(fOfVar);
-            }
+   for(size_t factor=0; factor<numberOfFactors(); ++factor) {
+      const typename AdjacencyType::Range neighbors = adjacency.neighbors(factor);
+      out[factor].insert(neighbors.begin(), neighbors.end());
+   }
+}
+
+/// \brief variable adjacency in compressed sparse row format
+///
+/// Two variables are adjacent if they are connected by a factor. The
+/// adjacency is built on first use and cached until the graph changes.
+/// The returned object (and ranges obtained from it) are valid until then.
+template<class S,class I>
+inline const typename FactorGraph<S,I>::AdjacencyType&
+FactorGraph<S,I>::variableAdjacency() const
+{
+   return cachedAdjacency<VariableNeighborhood>(variableAdjacency_, variableAdjacencyValid_, numberOfVariables(), true, false);
+}
+
+/// \brief factor adjacency in compressed sparse row format
+///
+/// Two factors are adjacent if they share a variable. The adjacency is
+/// built on first use and cached until the graph changes.
+template<class S,class I>
+inline const typename FactorGraph<S,I>::AdjacencyType&
+FactorGraph<S,I>::factorAdjacency() const
+{
+   return cachedAdjacency<FactorNeighborhood>(factorAdjacency_, factorAdjacencyValid_, numberOfFactors(), true, false);
+}
+
+/// \brief adjacency of the variables w.r.t. second order factors
+///
+/// For each variable, the neighbors via second order factors are listed,
+/// together with the connecting factor as edge identifier. A neighbor occurs
+/// once per connecting factor. The adjacency is built on first use and
+/// cached until the graph changes.
+template<class S,class I>
+inline const typename FactorGraph<S,I>::AdjacencyType&
+FactorGraph<S,I>::secondOrderAdjacency() const
+{
+   return cachedAdjacency<SecondOrderNeighborhood>(secondOrderAdjacency_, secondOrderAdjacencyValid_, numberOfVariables(), false, true);
+}
+
+/// \brief discard the cached adjacency
+///
+/// Must be called by S (the template parameter) whenever variables or
+/// factors are added or changed.
+template<class S,class I>
+inline void
+FactorGraph<S,I>::invalidateAdjacency()
+{
+   if(variableAdjacencyValid_.load(std::memory_order_relaxed)) {
+      variableAdjacencyValid_.store(false);
+      variableAdjacency_.clear();
+   }
+   if(factorAdjacencyValid_.load(std::memory_order_relaxed)) {
+      factorAdjacencyValid_.store(false);
+      factorAdjacency_.clear();
+   }
+   if(secondOrderAdjacencyValid_.load(std::memory_order_relaxed)) {
+      secondOrderAdjacencyValid_.store(false);
+      secondOrderAdjacency_.clear();
+   }
+}
+
+template<class S,class I>
+template<class NEIGHBORHOOD>
+inline const typename FactorGraph<S,I>::AdjacencyType&
+FactorGraph<S,I>::cachedAdjacency
+(
+   AdjacencyType& adjacency,
+   std::atomic<bool>& valid,
+   const size_t numberOfNodes,
+   const bool unique,
+   const bool withEdgeIdentifiers
+) const
+{
+   if(!valid.load(std::memory_order_acquire)) {
+      #ifdef WITH_OPENMP
+      #pragma omp critical(opengm_factorgraph_adjacency)
+      #endif
+      {
+         if(!valid.load(std::memory_order_relaxed)) {
+            adjacency.build(numberOfNodes, NEIGHBORHOOD(*this), unique, withEdgeIdentifiers);
+            valid.store(true, std::memory_order_release);
+         }
+      }
+   }
+   return adjacency;
+}
+
+template<class S,class I>
+inline void
+FactorGraph<S,I>::VariableNeighborhood::operator()
+(
+   const size_t variable,
+   std::vector<std::pair<I, I> >& out
+) const
+{
+   for(size_t j=0; j<factorGraph_.numberOfFactors(variable); ++j) {
+      const size_t factor = factorGraph_.factorOfVariable(variable, j);
+      for(size_t k=0; k<factorGraph_.numberOfVariables(factor); ++k) {
+         const size_t other = factorGraph_.variableOfFactor(factor, k);
+         if(other != variable) {
+            out.push_back(std::pair<I, I>(static_cast<I>(other), static_cast<I>(factor)));
+         }
+      }
+   }
+}
+
+template<class S,class I>
+inline void
+FactorGraph<S,I>::FactorNeighborhood::operator()
+(
+   const size_t factor,
+   std::vector<std::pair<I, I> >& out
+) const
+{
+   for(size_t j=0; j<factorGraph_.numberOfVariables(factor); ++j) {
+      const size_t variable = factorGraph_.variableOfFactor(factor, j);
+      for(size_t k=0; k<factorGraph_.numberOfFactors(variable); ++k) {
+         const size_t other = factorGraph_.factorOfVariable(variable, k);
+         if(other != factor) {
+            out.push_back(std::pair<I, I>(static_cast<I>(other), static_cast<I>(variable)));
          }
       }
    }
 }
 
-/// \brief computes the shortest path from s to t using Dijkstra's algorithm with uniform distances
+template<class S,class I>
+inline void
+FactorGraph<S,I>::SecondOrderNeighborhood::operator()
+(
+   const size_t variable,
+   std::vector<std::pair<I, I> >& out
+) const
+{
+   for(size_t j=0; j<factorGraph_.numberOfFactors(variable); ++j) {
+      const size_t factor = factorGraph_.factorOfVariable(variable, j);
+      if(factorGraph_.numberOfVariables(factor) == 2) {
+         const size_t other = factorGraph_.variableOfFactor(factor, 0) == variable
+            ? factorGraph_.variableOfFactor(factor, 1)
+            : factorGraph_.variableOfFactor(factor, 0);
+         out.push_back(std::pair<I, I>(static_cast<I>(other), static_cast<I>(factor)));
+      }
+   }
+}
+
+/// \brief computes the shortest path from s to t by breadth first search (uniform distances)
 /// \param s ID of the start variable
 /// \param t ID of the target variable
 /// \param[out] path returns computed path from s to t
@@ -953,118 +1183,45 @@ FactorGraph<S,I>::shortestPath(const size_t s, const size_t t, LIST& path, const
    const size_t infinity = std::numeric_limits<size_t>::max();
 
    bool useAllVariables = (allowedVariables.size() == 0) || (allowedVariables.size() == numberOfVariables());
-
-   if(useAllVariables) {
-      std::vector<size_t> distances(numberOfVariables(), infinity);
-      std::vector<size_t> previous(numberOfVariables(), infinity);
-      distances[s] = 0;
-      LIST Q;
-      for(size_t i = 0; i < numberOfVariables(); i++) {
-         Q.push_back(i);
-      }
-      while(Q.size() !=0) {
-         typename LIST::iterator currentIter = Q.begin();
-         for(typename LIST::iterator iter = Q.begin(); iter != Q.end(); iter++) {
-            if(distances[*iter] < distances[*currentIter]) {
-               currentIter = iter;
-            }
-         }
-         if(distances[*currentIter] == infinity) {
-            // all remaining variables are inaccessible from s
-            return false;
-         }
-         if(*currentIter == t) {
-            // target found
-            break;
-         }
-         size_t currentID = *currentIter;
-         Q.erase(currentIter);
-         // iterate over all neighbor variables of *current which are still in Q
-         for(ConstFactorIterator factorIter = factorsOfVariableBegin(currentID); factorIter != factorsOfVariableEnd(currentID); factorIter++) {
-            for(ConstVariableIterator variableIter = variablesOfFactorBegin(*factorIter); variableIter != variablesOfFactorEnd(*factorIter); variableIter++) {
-               if(std::find(Q.begin(), Q.end(), *variableIter) != Q.end()) {
-                  size_t newDistance = distances[currentID] + 1;
-                  if(newDistance < distances[*variableIter]) {
-                     distances[*variableIter] = newDistance;
-                     previous[*variableIter] = currentID;
-                  }
-               }
-            }
-         }
-      }
-      OPENGM_ASSERT(previous[t] != infinity);
-      // create path
-      size_t u = t;
-      while(previous[u] != infinity) {
-         path.push_front(u);
-         u = previous[u];
-      }
-      path.push_front(s);
-      return true;
-   } else {
+   std::vector<bool> allowed;
+   if(!useAllVariables) {
       OPENGM_ASSERT(std::find(allowedVariables.begin(), allowedVariables.end(), s) != allowedVariables.end());
       OPENGM_ASSERT(std::find(allowedVariables.begin(), allowedVariables.end(), t) != allowedVariables.end());
-      std::vector<size_t> distances(allowedVariables.size(), infinity);
-      std::vector<size_t> previous(allowedVariables.size(), infinity);
-      std::map<size_t, size_t> local2actualIDs;
-      std::map<size_t, size_t> actual2localIDs;
-      LIST Q;
-      size_t counter = 0;
+      allowed.resize(numberOfVariables(), false);
       for(typename LIST::const_iterator iter = allowedVariables.begin(); iter != allowedVariables.end(); iter++) {
-         Q.push_back(counter);
-         local2actualIDs.insert(std::pair<size_t, size_t>(counter, *iter));
-         actual2localIDs.insert(std::pair<size_t, size_t>(*iter, counter));
-         counter++;
+         allowed[*iter] = true;
       }
-      distances[actual2localIDs.find(s)->second] = 0;
-      while(Q.size() !=0) {
-         typename LIST::iterator currentIter = Q.begin();
-         for(typename LIST::iterator iter = Q.begin(); iter != Q.end(); iter++) {
-            if(distances[*iter] < distances[*currentIter]) {
-               currentIter = iter;
-            }
-         }
-         if(distances[*currentIter] == infinity) {
-            // all remaining variables are inaccessible from s
-            return false;
-         }
-         // get actual ID
-         size_t actualID = local2actualIDs.find(*currentIter)->second;
-         if(actualID == t) {
-            // target found
-            break;
-         }
-         size_t currentLocalID = *currentIter;
-         Q.erase(currentIter);
-         // iterate over all neighbor variables of *current which are in allowedVariables and are still in Q
-         for(ConstFactorIterator factorIter = factorsOfVariableBegin(actualID); factorIter != factorsOfVariableEnd(actualID); factorIter++) {
-            for(ConstVariableIterator variableIter = variablesOfFactorBegin(*factorIter); variableIter != variablesOfFactorEnd(*factorIter); variableIter++) {
-               const std::map<size_t, size_t>::const_iterator actual2localIDsCurrentPosition = actual2localIDs.find(*variableIter);
-               if(actual2localIDsCurrentPosition != actual2localIDs.end()) {
-                  size_t localID = actual2localIDsCurrentPosition->second;
-                  if(std::find(Q.begin(), Q.end(), localID) != Q.end()) {
-                     size_t newDistance = distances[currentLocalID] + 1;
-                     if(newDistance < distances[localID]) {
-                        distances[localID] = newDistance;
-                        previous[localID] = currentLocalID;
-                     }
-                  }
-               }
+   }
+
+   std::vector<size_t> previous(numberOfVariables(), infinity);
+   std::vector<bool> visited(numberOfVariables(), false);
+   std::vector<size_t> queue(1, s);
+   visited[s] = true;
+   for(size_t head = 0; head < queue.size() && !visited[t]; head++) {
+      const size_t currentID = queue[head];
+      // visit all neighbor variables of current which are allowed and have not been visited
+      for(ConstFactorIterator factorIter = factorsOfVariableBegin(currentID); factorIter != factorsOfVariableEnd(currentID); factorIter++) {
+         for(ConstVariableIterator variableIter = variablesOfFactorBegin(*factorIter); variableIter != variablesOfFactorEnd(*factorIter); variableIter++) {
+            if(!visited[*variableIter] && (useAllVariables || allowed[*variableIter])) {
+               visited[*variableIter] = true;
+               previous[*variableIter] = currentID;
+               queue.push_back(*variableIter);
             }
          }
       }
-      OPENGM_ASSERT(actual2localIDs.find(t)->second != infinity);
-      // create path
-      size_t u = actual2localIDs.find(t)->second;
-      while(previous[u] != infinity) {
-
-         path.push_front(local2actualIDs.find(u)->second);
-         u = previous[u];
-      }
-      path.push_front(s);
-      return true;
    }
-   return false;
+   if(!visited[t]) {
+      // t is inaccessible from s
+      return false;
+   }
+   // create path
+   size_t u = t;
+   while(u != s) {
+      path.push_front(u);
+      u = previous[u];
+   }
+   path.push_front(s);
+   return true;
 }
 
 /// \brief checks if variabel1 is connected to variable2 via two hops
@@ -1079,15 +1236,10 @@ FactorGraph<S,I>::twoHopConnected(const size_t variable1, const size_t variable2
    OPENGM_ASSERT(variable2 < numberOfVariables());
    oneHopVariables.clear();
    if(variable1 != variable2) {
-      for(ConstFactorIterator factorIter = factorsOfVariableBegin(variable1); factorIter != factorsOfVariableEnd(variable1); factorIter++) {
-         for(ConstVariableIterator variableIter = variablesOfFactorBegin(*factorIter); variableIter != variablesOfFactorEnd(*factorIter); variableIter++) {
-            if((*variableIter != variable1) || (*variableIter != variable2)) {
-               if(variableVariableConnection(*variableIter, variable2)) {
-                  oneHopVariables.push_back(*variableIter);
-               }
-            }
-         }
-      }
+      // common neighbors in the (sorted) cached adjacency
+      const typename AdjacencyType::Range n1 = variableAdjacency()[variable1];
+      const typename AdjacencyType::Range n2 = variableAdjacency()[variable2];
+      std::set_intersection(n1.begin(), n1.end(), n2.begin(), n2.end(), std::back_inserter(oneHopVariables));
    }
    if(oneHopVariables.size() == 0) {
       return false;
@@ -0,0 +1,1076 @@
+#pragma once
+#ifndef OPENGM_GRID_GRAPHICALMODEL_HXX
+#define OPENGM_GRID_GRAPHICALMODEL_HXX
+
+#include <vector>
+#include <algorithm>
+
+#include "opengm/opengm.hxx"
+#include "opengm/functions/explicit_function.hxx"
+#include "opengm/functions/function_properties_base.hxx"
+#include "opengm/functions/function_properties.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+#include "opengm/graphicalmodel/space/grid_space.hxx"
+#include "opengm/graphicalmodel/graphviews/factorgraph.hxx"
+#include "opengm/utilities/accessor_iterator.hxx"
+#include "opengm/utilities/metaprogramming.hxx"
+
+namespace opengm {
+
+template<class T, class OPERATOR, class I, class L> class GridGraphicalModel;
+template<class GRID_GRAPHICAL_MODEL> class GridFactor;
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_grid_graphical_model {
+
+/// first order function that views the unaries of one variable in the
+/// label-major unary array of a GridGraphicalModel
+template<class T, class I, class L>
+class UnaryView
+: public FunctionBase<UnaryView<T, I, L>, T, I, L>
+{
+public:
+   typedef T ValueType;
+   typedef I IndexType;
+   typedef L LabelType;
+
+   UnaryView(const T* data = NULL, const size_t stride = 1, const size_t numberOfLabels = 0)
+      : data_(data), stride_(stride), numberOfLabels_(numberOfLabels)
+      {}
+   size_t shape(const size_t j) const
+      { OPENGM_ASSERT(j == 0);
+        return numberOfLabels_; }
+   size_t size() const
+      { return numberOfLabels_; }
+   size_t dimension() const
+      { return 1; }
+   template<class ITERATOR>
+      ValueType operator()(ITERATOR labels) const
+      { OPENGM_ASSERT(static_cast<size_t>(*labels) < numberOfLabels_);
+        return data_[static_cast<size_t>(*labels) * stride_]; }
+
+private:
+   const T* data_;
+   size_t stride_;
+   size_t numberOfLabels_;
+};
+
+template<class GM>
+class VariableAccessor {
+public:
+   typedef typename GM::IndexType value_type;
+
+   VariableAccessor(const GM* gm = NULL, const size_t factor = 0)
+      : gm_(gm), factor_(factor)
+      {}
+   size_t size() const
+      { OPENGM_ASSERT(gm_ != NULL);
+        return gm_->numberOfVariables(factor_); }
+   const value_type operator[](const size_t j) const
+      { OPENGM_ASSERT(gm_ != NULL);
+        return gm_->variableOfFactor(factor_, j); }
+   bool operator==(const VariableAccessor& other) const
+      { return factor_ == other.factor_ && gm_ == other.gm_; }
+
+private:
+   const GM* gm_;
+   size_t factor_;
+};
+
+template<class GM>
+class ShapeAccessor {
+public:
+   typedef size_t value_type;
+
+   ShapeAccessor(const GM* gm = NULL, const size_t factor = 0)
+      : gm_(gm), factor_(factor)
+      {}
+   size_t size() const
+      { OPENGM_ASSERT(gm_ != NULL);
+        return gm_->numberOfVariables(factor_); }
+   const value_type operator[](const size_t j) const
+      { OPENGM_ASSERT(gm_ != NULL);
+        return gm_->numberOfLabels(gm_->variableOfFactor(factor_, j)); }
+   bool operator==(const ShapeAccessor& other) const
+      { return factor_ == other.factor_ && gm_ == other.gm_; }
+
+private:
+   const GM* gm_;
+   size_t factor_;
+};
+
+template<class OUT_ITERATOR>
+class CopyFunctor {
+public:
+   CopyFunctor(OUT_ITERATOR out)
+      : out_(out)
+      {}
+   template<class VALUE>
+      void operator()(const VALUE value)
+      { *out_ = value;
+        ++out_; }
+
+private:
+   OUT_ITERATOR out_;
+};
+
+} // namespace detail_grid_graphical_model
+/// \endcond
+
+/// Graphical model on a 4-connected 2D grid with implicit topology
+///
+/// Variables are numbered x + dimX * y. Factors 0, ..., numberOfVariables()-1
+/// are the unary factors of the variables. They are followed by the
+/// horizontal factors (x,y)-(x+1,y) and then by the vertical factors
+/// (x,y)-(x,y+1), each block in variable order.
+///
+/// No variable index sequences or adjacency sets are stored: the structure
+/// is computed from the coordinates. The unaries
+/// are stored in one contiguous label-major array (all variables for
+/// label 0, then all variables for label 1, ...) and all pairwise factors of
+/// one direction share a single function. The model implements the
+/// interface of GraphicalModel that is used by inference algorithms, e.g.
+/// ICM, BP, TRW-S and GraphCut. A factor is a lightweight handle (model
+/// pointer and factor index).
+///
+/// \ingroup graphical_models
+template<class T, class OPERATOR, class I = size_t, class L = size_t>
+class GridGraphicalModel
+:  public FactorGraph<GridGraphicalModel<T, OPERATOR, I, L>, I>
+{
+public:
+   typedef GridGraphicalModel<T, OPERATOR, I, L> GraphicalModelType;
+   typedef GridSpace<I, L> SpaceType;
+   typedef I IndexType;
+   typedef L LabelType;
+   typedef T ValueType;
+   typedef OPERATOR OperatorType;
+
+   typedef ExplicitFunction<T, I, L> PairwiseFunctionType;
+   typedef detail_grid_graphical_model::UnaryView<T, I, L> UnaryFunctionType;
+   typedef typename meta::TypeListGenerator<PairwiseFunctionType, UnaryFunctionType>::type FunctionTypeList;
+   enum FunctionInformation {
+      NrOfFunctionTypes = 2
+   };
+   enum Direction {
+      Horizontal = 0,
+      Vertical = 1
+   };
+
+   typedef FunctionIdentification<IndexType, UInt8Type> FunctionIdentifier;
+   typedef IndependentFactor<ValueType, IndexType, LabelType> IndependentFactorType;
+   typedef GridFactor<GraphicalModelType> FactorType;
+
+   GridGraphicalModel();
+   GridGraphicalModel(const IndexType, const IndexType, const LabelType, const ValueType = ValueType());
+   GridGraphicalModel(const GridGraphicalModel&);
+   GridGraphicalModel& operator=(const GridGraphicalModel&);
+   void assign(const IndexType, const IndexType, const LabelType, const ValueType = ValueType());
+
+   // graphical model interface
+   const SpaceType& space() const;
+   IndexType numberOfVariables() const;
+   IndexType numberOfVariables(const IndexType) const;
+   IndexType numberOfLabels(const IndexType) const;
+   IndexType numberOfFunctions(const size_t) const;
+   IndexType numberOfFactors() const;
+   IndexType numberOfFactors(const IndexType) const;
+   IndexType variableOfFactor(const IndexType, const IndexType) const;
+   IndexType factorOfVariable(const IndexType, const IndexType) const;
+   const FactorType& operator[](const IndexType) const;
+   template<class ITERATOR>
+      ValueType evaluate(ITERATOR) const;
+   template<class ITERATOR>
+      bool isValidIndexSequence(ITERATOR, ITERATOR) const;
+   size_t factorOrder() const;
+
+   // grid
+   IndexType dimX() const;
+   IndexType dimY() const;
+   IndexType variableIndex(const IndexType, const IndexType) const;
+   IndexType factorIndex(const Direction, const IndexType, const IndexType) const;
+   bool isPairwise(const IndexType) const;
+   Direction direction(const IndexType) const;
+   bool isGrid(marray::Matrix<size_t>&) const;
+
+   // values
+   const ValueType& unary(const IndexType, const LabelType) const;
+   ValueType& unary(const IndexType, const LabelType);
+   const ValueType* unaries() const;
+   ValueType* unaries();
+   const PairwiseFunctionType& pairwiseFunction(const Direction) const;
+   void setPairwiseFunction(const Direction, const PairwiseFunctionType&);
+   UnaryFunctionType unaryFunction(const IndexType) const;
+
+private:
+   IndexType numberOfHorizontalFactors() const;
+   IndexType numberOfVerticalFactors() const;
+   void initializeFactors();
+
+   SpaceType space_;
+   std::vector<ValueType> unaries_;
+   PairwiseFunctionType pairwise_[2];
+   std::vector<FactorType> factors_;
+};
+
+/// Factor of a GridGraphicalModel
+///
+/// A handle (model pointer and factor index) with the same interface as
+/// Factor, except for the access to the underlying function by reference
+/// (use callFunctor instead).
+template<class GRID_GRAPHICAL_MODEL>
+class GridFactor {
+public:
+   typedef GRID_GRAPHICAL_MODEL GraphicalModelType;
+   typedef typename GraphicalModelType::ValueType ValueType;
+   typedef typename GraphicalModelType::IndexType IndexType;
+   typedef typename GraphicalModelType::LabelType LabelType;
+   typedef typename GraphicalModelType::FunctionTypeList FunctionTypeList;
+   typedef typename GraphicalModelType::PairwiseFunctionType PairwiseFunctionType;
+   typedef typename GraphicalModelType::UnaryFunctionType UnaryFunctionType;
+   enum FunctionInformation {
+      NrOfFunctionTypes = GraphicalModelType::NrOfFunctionTypes
+   };
+   typedef AccessorIterator<detail_grid_graphical_model::VariableAccessor<GraphicalModelType>, true> VariablesIteratorType;
+   typedef AccessorIterator<detail_grid_graphical_model::ShapeAccessor<GraphicalModelType>, true> ShapeIteratorType;
+
+   GridFactor(const GraphicalModelType* = NULL, const IndexType = 0);
+
+   IndexType size() const;
+   IndexType numberOfVariables() const;
+   IndexType numberOfLabels(const IndexType) const;
+   IndexType shape(const IndexType) const;
+   IndexType variableIndex(const IndexType) const;
+   ShapeIteratorType shapeBegin() const;
+   ShapeIteratorType shapeEnd() const;
+   VariablesIteratorType variableIndicesBegin() const;
+   VariablesIteratorType variableIndicesEnd() const;
+   template<class ITERATOR>
+      void variableIndices(ITERATOR) const;
+   template<class ITERATOR>
+      ValueType operator()(ITERATOR) const;
+   template<class FUNCTOR>
+      void callFunctor(FUNCTOR&) const;
+   template<class ITERATOR>
+      void copyValues(ITERATOR) const;
+   template<class ITERATOR>
+      void copyValuesSwitchedOrder(ITERATOR) const;
+   UInt8Type functionType() const;
+   IndexType functionIndex() const;
+   bool isPotts() const;
+   bool isGeneralizedPotts() const;
+   bool isSubmodular() const;
+   bool isSquaredDifference() const;
+   bool isTruncatedSquaredDifference() const;
+   bool isAbsoluteDifference() const;
+   bool isTruncatedAbsoluteDifference() const;
+   template<int PROPERTY>
+      bool binaryProperty() const;
+   template<int PROPERTY>
+      ValueType valueProperty() const;
+   template<class FUNCTOR>
+      void forAllValuesInAnyOrder(FUNCTOR&) const;
+   template<class FUNCTOR>
+      void forAtLeastAllUniqueValues(FUNCTOR&) const;
+   template<class FUNCTOR>
+      void forAllValuesInOrder(FUNCTOR&) const;
+   template<class FUNCTOR>
+      void forAllValuesInSwitchedOrder(FUNCTOR&) const;
+   ValueType sum() const;
+   ValueType product() const;
+   ValueType min() const;
+   ValueType max() const;
+   IndexType dimension() const { return this->numberOfVariables(); }
+
+private:
+   bool isUnary() const;
+
+   const GraphicalModelType* gm_;
+   IndexType index_;
+};
+
+template<class T, class OPERATOR, class I, class L>
+inline
+GridGraphicalModel<T, OPERATOR, I, L>::GridGraphicalModel()
+:  space_(0, 0, 0),
+   unaries_(),
+   factors_()
+{}
+
+/// \brief construct a grid model
+/// \param dimX width of the grid
+/// \param dimY height of the grid
+/// \param numberOfLabels number of labels of each variable
+/// \param value initial value of all unaries and of all pairwise entries
+template<class T, class OPERATOR, class I, class L>
+inline
+GridGraphicalModel<T, OPERATOR, I, L>::GridGraphicalModel
+(
+   const IndexType dimX,
+   const IndexType dimY,
+   const LabelType numberOfLabels,
+   const ValueType value
+)
+{
+   assign(dimX, dimY, numberOfLabels, value);
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline
+GridGraphicalModel<T, OPERATOR, I, L>::GridGraphicalModel
+(
+   const GridGraphicalModel<T, OPERATOR, I, L>& gm
+)
+:  FactorGraph<GridGraphicalModel<T, OPERATOR, I, L>, I>(),
+   space_(gm.space_),
+   unaries_(gm.unaries_)
+{
+   pairwise_[Horizontal] = gm.pairwise_[Horizontal];
+   pairwise_[Vertical] = gm.pairwise_[Vertical];
+   initializeFactors();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline GridGraphicalModel<T, OPERATOR, I, L>&
+GridGraphicalModel<T, OPERATOR, I, L>::operator=
+(
+   const GridGraphicalModel<T, OPERATOR, I, L>& gm
+)
+{
+   if(this != &gm) {
+      this->invalidateAdjacency();
+      space_ = gm.space_;
+      unaries_ = gm.unaries_;
+      pairwise_[Horizontal] = gm.pairwise_[Horizontal];
+      pairwise_[Vertical] = gm.pairwise_[Vertical];
+      initializeFactors();
+   }
+   return *this;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline void
+GridGraphicalModel<T, OPERATOR, I, L>::assign
+(
+   const IndexType dimX,
+   const IndexType dimY,
+   const LabelType numberOfLabels,
+   const ValueType value
+)
+{
+   this->invalidateAdjacency();
+   space_.assign(dimX, dimY, numberOfLabels);
+   unaries_.assign(static_cast<size_t>(dimX) * dimY * numberOfLabels, value);
+   const size_t shape[] = {numberOfLabels, numberOfLabels};
+   pairwise_[Horizontal] = PairwiseFunctionType(shape, shape + 2, value);
+   pairwise_[Vertical] = PairwiseFunctionType(shape, shape + 2, value);
+   initializeFactors();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline const typename GridGraphicalModel<T, OPERATOR, I, L>::SpaceType&
+GridGraphicalModel<T, OPERATOR, I, L>::space() const
+{
+   return space_;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfVariables() const
+{
+   return space_.numberOfVariables();
+}
+
+/// \brief number of variables of a factor
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfVariables
+(
+   const IndexType factorIndex
+) const
+{
+   OPENGM_ASSERT(factorIndex < numberOfFactors());
+   return factorIndex < numberOfVariables() ? 1 : 2;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfLabels
+(
+   const IndexType variableIndex
+) const
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   return space_.numberOfLabels();
+}
+
+/// \brief number of functions of a type (0: pairwise, 1: unary)
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfFunctions
+(
+   const size_t functionTypeIndex
+) const
+{
+   OPENGM_ASSERT(functionTypeIndex < NrOfFunctionTypes);
+   return functionTypeIndex == 0 ? 2 : numberOfVariables();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfFactors() const
+{
+   return numberOfVariables() + numberOfHorizontalFactors() + numberOfVerticalFactors();
+}
+
+/// \brief number of factors that depend on a variable
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfFactors
+(
+   const IndexType variableIndex
+) const
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   const IndexType x = variableIndex % dimX();
+   const IndexType y = variableIndex / dimX();
+   return 1 + (x > 0) + (x + 1 < dimX()) + (y > 0) + (y + 1 < dimY());
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::variableOfFactor
+(
+   const IndexType factorIndex,
+   const IndexType variableNumber
+) const
+{
+   OPENGM_ASSERT(factorIndex < numberOfFactors());
+   OPENGM_ASSERT(variableNumber < numberOfVariables(factorIndex));
+   if(factorIndex < numberOfVariables()) {
+      return factorIndex;
+   }
+   IndexType e = factorIndex - numberOfVariables();
+   if(e < numberOfHorizontalFactors()) {
+      const IndexType v = (e / (dimX() - 1)) * dimX() + e % (dimX() - 1);
+      return v + variableNumber;
+   }
+   e -= numberOfHorizontalFactors();
+   return e + variableNumber * dimX();
+}
+
+/// \brief factors of a variable in ascending order
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::factorOfVariable
+(
+   const IndexType variableIndex,
+   const IndexType factorNumber
+) const
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   OPENGM_ASSERT(factorNumber < numberOfFactors(variableIndex));
+   const IndexType x = variableIndex % dimX();
+   const IndexType y = variableIndex / dimX();
+   IndexType n = factorNumber;
+   if(n == 0) {
+      return variableIndex;
+   }
+   --n;
+   if(x > 0) {
+      if(n == 0) {
+         return factorIndex(Horizontal, x - 1, y);
+      }
+      --n;
+   }
+   if(x + 1 < dimX()) {
+      if(n == 0) {
+         return factorIndex(Horizontal, x, y);
+      }
+      --n;
+   }
+   if(y > 0) {
+      if(n == 0) {
+         return factorIndex(Vertical, x, y - 1);
+      }
+      --n;
+   }
+   OPENGM_ASSERT(n == 0 && y + 1 < dimY());
+   return factorIndex(Vertical, x, y);
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline const typename GridGraphicalModel<T, OPERATOR, I, L>::FactorType&
+GridGraphicalModel<T, OPERATOR, I, L>::operator[]
+(
+   const IndexType factorIndex
+) const
+{
+   OPENGM_ASSERT(factorIndex < numberOfFactors());
+   return factors_[factorIndex];
+}
+
+/// \brief evaluate the modeled function for a given labeling
+///
+/// The factors are visited block by block and row by row.
+template<class T, class OPERATOR, class I, class L>
+template<class ITERATOR>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::ValueType
+GridGraphicalModel<T, OPERATOR, I, L>::evaluate
+(
+   ITERATOR labels
+) const
+{
+   ValueType value;
+   OperatorType::neutral(value);
+   const size_t n = numberOfVariables();
+   for(size_t v = 0; v < n; ++v) {
+      OperatorType::op(unaries_[static_cast<size_t>(labels[v]) * n + v], value);
+   }
+   LabelType c[2];
+   for(IndexType y = 0; y < dimY(); ++y) {
+      for(IndexType x = 0; x + 1 < dimX(); ++x) {
+         const size_t v = variableIndex(x, y);
+         c[0] = labels[v];
+         c[1] = labels[v + 1];
+         OperatorType::op(pairwise_[Horizontal](c), value);
+      }
+   }
+   for(IndexType y = 0; y + 1 < dimY(); ++y) {
+      for(IndexType x = 0; x < dimX(); ++x) {
+         const size_t v = variableIndex(x, y);
+         c[0] = labels[v];
+         c[1] = labels[v + dimX()];
+         OperatorType::op(pairwise_[Vertical](c), value);
+      }
+   }
+   return value;
+}
+
+template<class T, class OPERATOR, class I, class L>
+template<class ITERATOR>
+inline bool
+GridGraphicalModel<T, OPERATOR, I, L>::isValidIndexSequence
+(
+   ITERATOR begin,
+   ITERATOR end
+) const
+{
+   ITERATOR previousIt = begin;
+   while(begin != end) {
+      if(*begin >= this->numberOfVariables()) {
+         return false;
+      }
+      if(previousIt != begin && *previousIt >= *begin) {
+         return false;
+      }
+      previousIt = begin;
+      ++begin;
+   }
+   return true;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline size_t
+GridGraphicalModel<T, OPERATOR, I, L>::factorOrder() const
+{
+   return numberOfFactors() > numberOfVariables() ? 2 : 1;
+}
+
+/// \brief grid layout of the variables (known, unlike in FactorGraph::isGrid)
+template<class T, class OPERATOR, class I, class L>
+inline bool
+GridGraphicalModel<T, OPERATOR, I, L>::isGrid
+(
+   marray::Matrix<size_t>& gridIDs
+) const
+{
+   if(numberOfVariables() == 0) {
+      return false;
+   }
+   gridIDs = marray::Matrix<size_t>(dimX(), dimY());
+   for(IndexType y = 0; y < dimY(); ++y) {
+      for(IndexType x = 0; x < dimX(); ++x) {
+         gridIDs(x, y) = variableIndex(x, y);
+      }
+   }
+   return true;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::dimX() const
+{
+   return space_.dimX();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::dimY() const
+{
+   return space_.dimY();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::variableIndex
+(
+   const IndexType x,
+   const IndexType y
+) const
+{
+   OPENGM_ASSERT(x < dimX() && y < dimY());
+   return x + dimX() * y;
+}
+
+/// \brief index of the pairwise factor between (x,y) and its right (Horizontal) or lower (Vertical) neighbor
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::factorIndex
+(
+   const Direction direction,
+   const IndexType x,
+   const IndexType y
+) const
+{
+   if(direction == Horizontal) {
+      OPENGM_ASSERT(x + 1 < dimX() && y < dimY());
+      return numberOfVariables() + y * (dimX() - 1) + x;
+   }
+   else {
+      OPENGM_ASSERT(x < dimX() && y + 1 < dimY());
+      return numberOfVariables() + numberOfHorizontalFactors() + variableIndex(x, y);
+   }
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline bool
+GridGraphicalModel<T, OPERATOR, I, L>::isPairwise
+(
+   const IndexType factorIndex
+) const
+{
+   OPENGM_ASSERT(factorIndex < numberOfFactors());
+   return factorIndex >= numberOfVariables();
+}
+
+/// \brief direction of a pairwise factor
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::Direction
+GridGraphicalModel<T, OPERATOR, I, L>::direction
+(
+   const IndexType factorIndex
+) const
+{
+   OPENGM_ASSERT(isPairwise(factorIndex));
+   return factorIndex < numberOfVariables() + numberOfHorizontalFactors() ? Horizontal : Vertical;
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline const typename GridGraphicalModel<T, OPERATOR, I, L>::ValueType&
+GridGraphicalModel<T, OPERATOR, I, L>::unary
+(
+   const IndexType variableIndex,
+   const LabelType label
+) const
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   OPENGM_ASSERT(label < space_.numberOfLabels());
+   return unaries_[static_cast<size_t>(label) * numberOfVariables() + variableIndex];
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::ValueType&
+GridGraphicalModel<T, OPERATOR, I, L>::unary
+(
+   const IndexType variableIndex,
+   const LabelType label
+)
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   OPENGM_ASSERT(label < space_.numberOfLabels());
+   return unaries_[static_cast<size_t>(label) * numberOfVariables() + variableIndex];
+}
+
+/// \brief label-major array of all unaries, entry (variable, label) is at label * numberOfVariables() + variable
+template<class T, class OPERATOR, class I, class L>
+inline const typename GridGraphicalModel<T, OPERATOR, I, L>::ValueType*
+GridGraphicalModel<T, OPERATOR, I, L>::unaries() const
+{
+   return unaries_.empty() ? NULL : &unaries_[0];
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::ValueType*
+GridGraphicalModel<T, OPERATOR, I, L>::unaries()
+{
+   return unaries_.empty() ? NULL : &unaries_[0];
+}
+
+/// \brief function shared by all pairwise factors of one direction
+template<class T, class OPERATOR, class I, class L>
+inline const typename GridGraphicalModel<T, OPERATOR, I, L>::PairwiseFunctionType&
+GridGraphicalModel<T, OPERATOR, I, L>::pairwiseFunction
+(
+   const Direction direction
+) const
+{
+   return pairwise_[direction];
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline void
+GridGraphicalModel<T, OPERATOR, I, L>::setPairwiseFunction
+(
+   const Direction direction,
+   const PairwiseFunctionType& function
+)
+{
+   if(function.dimension() != 2
+      || function.shape(0) != space_.numberOfLabels()
+      || function.shape(1) != space_.numberOfLabels()) {
+      throw RuntimeError("The shape of the pairwise function does not match the number of labels.");
+   }
+   pairwise_[direction] = function;
+}
+
+/// \brief the unaries of a variable as a (non-owning) function
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::UnaryFunctionType
+GridGraphicalModel<T, OPERATOR, I, L>::unaryFunction
+(
+   const IndexType variableIndex
+) const
+{
+   OPENGM_ASSERT(variableIndex < numberOfVariables());
+   return UnaryFunctionType(unaries() + variableIndex, numberOfVariables(), space_.numberOfLabels());
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfHorizontalFactors() const
+{
+   return dimX() == 0 ? 0 : (dimX() - 1) * dimY();
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline typename GridGraphicalModel<T, OPERATOR, I, L>::IndexType
+GridGraphicalModel<T, OPERATOR, I, L>::numberOfVerticalFactors() const
+{
+   return dimY() == 0 ? 0 : dimX() * (dimY() - 1);
+}
+
+template<class T, class OPERATOR, class I, class L>
+inline void
+GridGraphicalModel<T, OPERATOR, I, L>::initializeFactors()
+{
+   factors_.resize(numberOfFactors());
+   for(size_t f = 0; f < factors_.size(); ++f) {
+      factors_[f] = FactorType(this, static_cast<IndexType>(f));
+   }
+}
+
+// implementation of GridFactor
+
+template<class GM>
+inline
+GridFactor<GM>::GridFactor
+(
+   const GraphicalModelType* gm,
+   const IndexType index
+)
+:  gm_(gm),
+   index_(index)
+{}
+
+template<class GM>
+inline bool
+GridFactor<GM>::isUnary() const
+{
+   return !gm_->isPairwise(index_);
+}
+
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::size() const
+{
+   return isUnary() ? gm_->space().numberOfLabels() : gm_->space().numberOfLabels() * gm_->space().numberOfLabels();
+}
+
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::numberOfVariables() const
+{
+   return isUnary() ? 1 : 2;
+}
+
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::numberOfLabels
+(
+   const IndexType j
+) const
+{
+   OPENGM_ASSERT(j < numberOfVariables());
+   return gm_->space().numberOfLabels();
+}
+
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::shape
+(
+   const IndexType j
+) const
+{
+   return numberOfLabels(j);
+}
+
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::variableIndex
+(
+   const IndexType j
+) const
+{
+   return gm_->variableOfFactor(index_, j);
+}
+
+template<class GM>
+inline typename GridFactor<GM>::ShapeIteratorType
+GridFactor<GM>::shapeBegin() const
+{
+   return ShapeIteratorType(detail_grid_graphical_model::ShapeAccessor<GM>(gm_, index_), 0);
+}
+
+template<class GM>
+inline typename GridFactor<GM>::ShapeIteratorType
+GridFactor<GM>::shapeEnd() const
+{
+   return ShapeIteratorType(detail_grid_graphical_model::ShapeAccessor<GM>(gm_, index_), numberOfVariables());
+}
+
+template<class GM>
+inline typename GridFactor<GM>::VariablesIteratorType
+GridFactor<GM>::variableIndicesBegin() const
+{
+   return VariablesIteratorType(detail_grid_graphical_model::VariableAccessor<GM>(gm_, index_), 0);
+}
+
+template<class GM>
+inline typename GridFactor<GM>::VariablesIteratorType
+GridFactor<GM>::variableIndicesEnd() const
+{
+   return VariablesIteratorType(detail_grid_graphical_model::VariableAccessor<GM>(gm_, index_), numberOfVariables());
+}
+
+template<class GM>
+template<class ITERATOR>
+inline void
+GridFactor<GM>::variableIndices
+(
+   ITERATOR out
+) const
+{
+   for(IndexType j = 0; j < numberOfVariables(); ++j) {
+      *out = variableIndex(j);
+      ++out;
+   }
+}
+
+template<class GM>
+template<class ITERATOR>
+inline typename GridFactor<GM>::ValueType
+GridFactor<GM>::operator()
+(
+   ITERATOR labels
+) const
+{
+   if(isUnary()) {
+      return gm_->unary(index_, static_cast<LabelType>(*labels));
+   }
+   else {
+      return gm_->pairwiseFunction(gm_->direction(index_))(labels);
+   }
+}
+
+/// \brief call a functor with the function of the factor
+///
+/// The functor is called with a PairwiseFunctionType (for pairwise factors)
+/// or with a UnaryFunctionType (for unary factors).
+template<class GM>
+template<class FUNCTOR>
+inline void
+GridFactor<GM>::callFunctor
+(
+   FUNCTOR& functor
+) const
+{
+   if(isUnary()) {
+      functor(gm_->unaryFunction(index_));
+   }
+   else {
+      functor(gm_->pairwiseFunction(gm_->direction(index_)));
+   }
+}
+
+/// \brief copies the values of a factors into an iterator (first coordinate major order)
+template<class GM>
+template<class ITERATOR>
+inline void
+GridFactor<GM>::copyValues
+(
+   ITERATOR out
+) const
+{
+   detail_grid_graphical_model::CopyFunctor<ITERATOR> functor(out);
+   forAllValuesInOrder(functor);
+}
+
+template<class GM>
+template<class ITERATOR>
+inline void
+GridFactor<GM>::copyValuesSwitchedOrder
+(
+   ITERATOR out
+) const
+{
+   detail_grid_graphical_model::CopyFunctor<ITERATOR> functor(out);
+   forAllValuesInSwitchedOrder(functor);
+}
+
+/// \brief 0 for pairwise factors, 1 for unary factors
+template<class GM>
+inline UInt8Type
+GridFactor<GM>::functionType() const
+{
+   return isUnary() ? 1 : 0;
+}
+
+/// \brief direction for pairwise factors, variable index for unary factors
+template<class GM>
+inline typename GridFactor<GM>::IndexType
+GridFactor<GM>::functionIndex() const
+{
+   return isUnary() ? index_ : static_cast<IndexType>(gm_->direction(index_));
+}
+
+#define OPENGM_GRID_FACTOR_DELEGATE(RETURN_TYPE, NAME)                     \
+template<class GM>                                                         \
+inline RETURN_TYPE                                                         \
+GridFactor<GM>::NAME() const                                               \
+{                                                                          \
+   if(isUnary()) {                                                         \
+      return gm_->unaryFunction(index_).NAME();                            \
+   }                                                                       \
+   else {                                                                  \
+      return gm_->pairwiseFunction(gm_->direction(index_)).NAME();         \
+   }                                                                       \
+}
+
+OPENGM_GRID_FACTOR_DELEGATE(bool, isPotts)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isGeneralizedPotts)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isSubmodular)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isSquaredDifference)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isTruncatedSquaredDifference)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isAbsoluteDifference)
+OPENGM_GRID_FACTOR_DELEGATE(bool, isTruncatedAbsoluteDifference)
+OPENGM_GRID_FACTOR_DELEGATE(typename GridFactor<GM>::ValueType, sum)
+OPENGM_GRID_FACTOR_DELEGATE(typename GridFactor<GM>::ValueType, product)
+OPENGM_GRID_FACTOR_DELEGATE(typename GridFactor<GM>::ValueType, min)
+OPENGM_GRID_FACTOR_DELEGATE(typename GridFactor<GM>::ValueType, max)
+
+#undef OPENGM_GRID_FACTOR_DELEGATE
+
+template<class GM>
+template<int PROPERTY>
+inline bool
+GridFactor<GM>::binaryProperty() const
+{
+   if(isUnary()) {
+      return BinaryFunctionProperties<PROPERTY, UnaryFunctionType>::op(gm_->unaryFunction(index_));
+   }
+   else {
+      return BinaryFunctionProperties<PROPERTY, PairwiseFunctionType>::op(gm_->pairwiseFunction(gm_->direction(index_)));
+   }
+}
+
+template<class GM>
+template<int PROPERTY>
+inline typename GridFactor<GM>::ValueType
+GridFactor<GM>::valueProperty() const
+{
+   if(isUnary()) {
+      return ValueFunctionProperties<PROPERTY, UnaryFunctionType>::op(gm_->unaryFunction(index_));
+   }
+   else {
+      return ValueFunctionProperties<PROPERTY, PairwiseFunctionType>::op(gm_->pairwiseFunction(gm_->direction(index_)));
+   }
+}
+
+template<class GM>
+template<class FUNCTOR>
+inline void
+GridFactor<GM>::forAllValuesInAnyOrder
+(
+   FUNCTOR& functor
+) const
+{
+   if(isUnary()) {
+      gm_->unaryFunction(index_).forAllValuesInAnyOrder(functor);
+   }
+   else {
+      gm_->pairwiseFunction(gm_->direction(index_)).forAllValuesInAnyOrder(functor);
+   }
+}
+
+template<class GM>
+template<class FUNCTOR>
+inline void
+GridFactor<GM>::forAtLeastAllUniqueValues
+(
+   FUNCTOR& functor
+) const
+{
+   if(isUnary()) {
+      gm_->unaryFunction(index_).forAtLeastAllUniqueValues(functor);
+   }
+   else {
+      gm_->pairwiseFunction(gm_->direction(index_)).forAtLeastAllUniqueValues(functor);
+   }
+}
+
+template<class GM>
+template<class FUNCTOR>
+inline void
+GridFactor<GM>::forAllValuesInOrder
+(
+   FUNCTOR& functor
+) const
+{
+   if(isUnary()) {
+      gm_->unaryFunction(index_).forAllValuesInOrder(functor);
+   }
+   else {
+      gm_->pairwiseFunction(gm_->direction(index_)).forAllValuesInOrder(functor);
+   }
+}
+
+template<class GM>
+template<class FUNCTOR>
+inline void
+GridFactor<GM>::forAllValuesInSwitchedOrder
+(
+   FUNCTOR& functor
+) const
+{
+   if(isUnary()) {
+      gm_->unaryFunction(index_).forAllValuesInSwitchedOrder(functor);
+   }
+   else {
+      gm_->pairwiseFunction(gm_->direction(index_)).forAllValuesInSwitchedOrder(functor);
+   }
+}
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_GRID_GRAPHICALMODEL_HXX
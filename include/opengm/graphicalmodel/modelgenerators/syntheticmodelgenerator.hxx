@@ -5,16 +5,38 @@
 /// \cond HIDDEN_SYMBOLS
 
 #include <cstdlib>
+#include <cmath>
 #include <vector>
-#include <cstdlib>
+#include <map>
 #include <set>
+#include <algorithm>
 #include <functional>
+#include <unordered_set>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 #include <opengm/graphicalmodel/graphicalmodel.hxx>
 #include <opengm/utilities/random.hxx>
 
 namespace opengm {
 
+   namespace detail_syntheticmodelgenerator {
+      // streams of the random numbers that do not belong to a factor
+      static const UInt64Type numberOfStatesStream = 0xFFFFFFFFFFFFFF00ULL;
+      static const UInt64Type structureStream = 0xFFFFFFFFFFFFFF01ULL;
+      static const UInt64Type repairStream = 0xFFFFFFFFFFFFFF02ULL;
+   }
+
+   /// Generator of random models on grids, complete graphs, stars, 3D grids,
+   /// random regular graphs and random higher order cliques.
+   ///
+   /// The models depend only on the id and the parameter: every random number
+   /// is a function of (id, factor index, table entry), so function tables are
+   /// filled in parallel and the number of threads does not change the model.
+   /// Functions without random numbers (CONSTF, GPOTTS, L1) are shared between
+   /// all factors of equal shape.
    template<class GM>
    class SyntheticModelGenerator2
    {
@@ -29,6 +51,9 @@ namespace opengm {
       typedef typename GM::FunctionIdentifier FunctionIdentifier;
       typedef typename GM::OperatorType OperatorType;
 
+      /// function types, for factors of order higher than one:
+      /// GPOTTS and RGPOTTS are zero iff all labels are equal,
+      /// L1 is 0.1 times the difference of the largest and the smallest label
       enum FunctionTypes
       {
          EMPTY, CONSTF, URANDOM, IRANDOM, GPOTTS, RGPOTTS, L1
@@ -41,6 +66,8 @@ namespace opengm {
          std::vector<std::vector<ValueType> > functionParameters_;
          std::vector<bool> sharedFunctions_;
          bool randomNumberOfStates_;
+         /// number of threads filling the function tables (0 = one per core)
+         size_t numberOfThreads_;
 
          Parameter()
          {
@@ -54,6 +81,7 @@ namespace opengm {
             functionParameters_[1][1] = 1;
             sharedFunctions_.resize(2, true);
             randomNumberOfStates_ = false;
+            numberOfThreads_ = 0;
          }
 
          bool isConsistent() const
@@ -65,14 +93,18 @@ namespace opengm {
 
       SyntheticModelGenerator2();
       GM buildGrid(const size_t, const size_t, const size_t, const size_t, const Parameter&) const;
+      GM buildGrid3D(const size_t, const size_t, const size_t, const size_t, const size_t, const Parameter&) const;
       GM buildFull(const size_t, const size_t, const size_t, const Parameter&) const;
       GM buildStar(const size_t, const size_t, const size_t, const Parameter&) const;
+      GM buildRandomRegular(const size_t, const size_t, const size_t, const size_t, const Parameter&) const;
+      GM buildCliques(const size_t, const size_t, const size_t, const size_t, const size_t, const Parameter&) const;
 
    private:
-      void addUnaries(GM&, const FunctionTypes, const std::vector<ValueType>&, const bool) const;
-      template<class ITERATOR>
-      FunctionIdentifier addFunction(GM&, const FunctionTypes, const std::vector<ValueType>&, ITERATOR, ITERATOR) const;
-      GraphicalModelType getGM(size_t,size_t,bool) const;
+      GM build(const size_t, const size_t, const size_t, const std::vector<IndexType>&, const size_t, const Parameter&) const;
+      void addFactors(GM&, const size_t, const FunctionTypes, const std::vector<ValueType>&, const bool,
+         const std::vector<IndexType>&, const size_t, const size_t) const;
+      void fillFunction(ExplicitFunctionType&, const FunctionTypes, const std::vector<ValueType>&, const UInt64Type, const UInt64Type) const;
+      GraphicalModelType getGM(size_t,size_t,size_t,bool) const;
    };
 
    template<class GM>
@@ -80,14 +112,14 @@ namespace opengm {
    {}
 
    template<class GM>
-   GM SyntheticModelGenerator2<GM>::getGM(size_t numVar, size_t numStates, bool randomNumberOfStates) const
+   GM SyntheticModelGenerator2<GM>::getGM(size_t id, size_t numVar, size_t numStates, bool randomNumberOfStates) const
    {
       if(randomNumberOfStates) {
          std::vector<typename GM::LabelType> numberOfLabels(numVar);
          // generate random integer variables in the range [1, numStates + 1) = [1, numStates]
-         opengm::RandomUniform<size_t> randomIntegerNumberGenerator(1,numStates + 1);
          for(size_t i = 0; i < numVar; i++) {
-            numberOfLabels[i] = randomIntegerNumberGenerator();
+            const double u = CounterBasedRandom::uniformAt(id, detail_syntheticmodelgenerator::numberOfStatesStream, i);
+            numberOfLabels[i] = 1 + static_cast<typename GM::LabelType>(u * numStates);
          }
          return GM( opengm::DiscreteSpace<typename GM::IndexType,typename GM::LabelType>(numberOfLabels.begin(), numberOfLabels.end()));
       } else {
@@ -96,205 +128,225 @@ namespace opengm {
       }
    }
 
+   /// fills a function table with random numbers of the stream
    template<class GM>
-   void SyntheticModelGenerator2<GM>::addUnaries
+   void SyntheticModelGenerator2<GM>::fillFunction
    (
-      GM& gm,
+      ExplicitFunctionType& function,
       const FunctionTypes functionType,
       const std::vector<ValueType>& functionParameter,
-      const bool sharedFunction
+      const UInt64Type seed,
+      const UInt64Type stream
    ) const
    {
-      typename GM::LabelType shape[1];
-      typename GM::IndexType var[] = {0};
-      FunctionIdentifier funcId;
+      const size_t order = function.dimension();
+      std::vector<LabelType> labels(order, 0);
+      ValueType potts = 0;
       switch (functionType) {
       case URANDOM:
          OPENGM_ASSERT(functionParameter.size() == 2);
          OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
-         for(size_t i = 0; i < gm.numberOfVariables(); ++i) {
-            shape[0] = gm.numberOfLabels(i);
-            var[0] = i;
-            if(!sharedFunction|| i == 0) {
-               ExplicitFunctionType function(shape, shape + 1);
-               for(size_t ni = 0; ni < shape[0]; ++ni) {
-                  function(ni) = functionParameter[0] + (functionParameter[1] - functionParameter[0]) * (rand() % 1000000) * 0.000001;
-               }
-               funcId = gm.addFunction(function);
-            }
-            gm.addFactor(funcId, var, var + 1);
+         for(size_t n = 0; n < function.size(); ++n) {
+            function(n) = functionParameter[0] + (functionParameter[1] - functionParameter[0])
+               * CounterBasedRandom::uniformAt(seed, stream, n);
          }
-         break;
+         return;
       case IRANDOM:
          OPENGM_ASSERT(functionParameter.size() == 2);
          OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
-         for(size_t i = 0; i < gm.numberOfVariables(); ++i) {
-            shape[0] = gm.numberOfLabels(i);
-            var[0] = i;
-            if(!sharedFunction || i == 0) {
-               ExplicitFunctionType function(shape, shape + 1);
-               for(size_t ni = 0; ni < shape[0]; ++ni) {
-                  function(ni) = functionParameter[0] + rand() % (size_t) (functionParameter[1] - functionParameter[0]);
-               }
-               funcId = gm.addFunction(function);
-            }
-            gm.addFactor(funcId, var, var + 1);
+         for(size_t n = 0; n < function.size(); ++n) {
+            function(n) = functionParameter[0] + std::floor((functionParameter[1] - functionParameter[0])
+               * CounterBasedRandom::uniformAt(seed, stream, n));
          }
-         break;
-      case EMPTY:
-         // do nothing
-         break;
+         return;
       case CONSTF:
          OPENGM_ASSERT(functionParameter.size() == 1);
-         for(typename GM::IndexType i = 0; i < gm.numberOfVariables(); ++i) {
-            shape[0] = gm.numberOfLabels(i);
-            var[0] = i;
-            if(!sharedFunction || i == 0) {
-               ExplicitFunctionType function(shape, shape + 1);
-               for(typename GM::LabelType ni = 0; ni < shape[0]; ++ni) {
-                  function(ni) = functionParameter[0];
-               }
-               funcId = gm.addFunction(function);
-            }
-            gm.addFactor(funcId, var, var + 1);
+         for(size_t n = 0; n < function.size(); ++n) {
+            function(n) = functionParameter[0];
          }
+         return;
+      case GPOTTS:
+         OPENGM_ASSERT(functionParameter.size() == 1);
+         potts = functionParameter[0];
+         break;
+      case RGPOTTS:
+         OPENGM_ASSERT(functionParameter.size() == 2);
+         OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
+         potts = functionParameter[0] + (functionParameter[1] - functionParameter[0])
+            * CounterBasedRandom::uniformAt(seed, stream, 0);
+         break;
+      case L1:
          break;
       default:
-         throw RuntimeError("Unknown function type for unary factors.");
+         throw RuntimeError("Unknown function type.");
+      }
+      // GPOTTS, RGPOTTS and L1 depend on the labels, the first label changes fastest
+      for(size_t n = 0; n < function.size(); ++n) {
+         const LabelType smallest = order == 0 ? 0 : *std::min_element(labels.begin(), labels.end());
+         const LabelType largest = order == 0 ? 0 : *std::max_element(labels.begin(), labels.end());
+         if(functionType == L1) {
+            function(n) = 0.1 * static_cast<ValueType>(largest - smallest);
+         }
+         else {
+            function(n) = smallest == largest ? 0 : potts;
+         }
+         for(size_t j = 0; j < order; ++j) {
+            if(++labels[j] < function.shape(j)) {
+               break;
+            }
+            labels[j] = 0;
+         }
       }
    }
 
+   /// adds one factor per scope of the given order. Random functions are either
+   /// one per factor or, if shared, one per model; the tables are filled in parallel.
    template<class GM>
-   template<class ITERATOR>
-   typename GM::FunctionIdentifier SyntheticModelGenerator2<GM>::addFunction
+   void SyntheticModelGenerator2<GM>::addFactors
    (
       GM& gm,
+      const size_t id,
       const FunctionTypes functionType,
       const std::vector<ValueType>& functionParameter,
-      ITERATOR shapeBegin, ITERATOR shapeEnd
+      const bool sharedFunction,
+      const std::vector<IndexType>& scopes,
+      const size_t order,
+      const size_t numberOfThreads
    ) const
    {
-      switch (functionType) {
-      case URANDOM:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 2);
-         OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
-         ExplicitFunctionType function(shapeBegin, shapeEnd);
-         for(typename GM::LabelType ni = 0; ni < shapeBegin[0]; ++ni) {
-            for(typename GM::LabelType nj = 0; nj < shapeBegin[1]; ++nj) {
-               function(ni, nj) = functionParameter[0] + (functionParameter[1] - functionParameter[0]) * (rand() % 1000000) * 0.000001;
-            }
-         }
-         return gm.addFunction(function);
+      if(functionType == EMPTY) {
+         return;
       }
-      case IRANDOM:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 2);
-         OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
-         ExplicitFunctionType function(shapeBegin, shapeEnd);
-         for(typename GM::LabelType ni = 0; ni < shapeBegin[0]; ++ni) {
-            for(typename GM::LabelType nj = 0; nj < shapeBegin[1]; ++nj) {
-               function(ni, nj) = functionParameter[0] + rand() % (size_t) (functionParameter[0] - functionParameter[1]);
-            }
+      const size_t numberOfFactors = order == 0 ? 0 : scopes.size() / order;
+      const bool random = functionType == URANDOM || functionType == IRANDOM || functionType == RGPOTTS;
+      std::vector<LabelType> shape(order);
+      std::map<std::vector<LabelType>, FunctionIdentifier> sharedFunctions;
+      std::vector<std::pair<FunctionIdentifier, UInt64Type> > newFunctions;
+      std::vector<FunctionIdentifier> functionIds(numberOfFactors);
+      for(size_t f = 0; f < numberOfFactors; ++f) {
+         for(size_t j = 0; j < order; ++j) {
+            shape[j] = gm.numberOfLabels(scopes[f * order + j]);
          }
-         return gm.addFunction(function);
-      }
-      case GPOTTS:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 1);
-         ExplicitFunctionType function(shapeBegin, shapeEnd, functionParameter[0]);
-         for(typename GM::LabelType ni = 0; ni < shapeBegin[0]; ++ni) {
-            for(typename GM::LabelType nj = 0; nj < shapeBegin[1]; ++nj) {
-               if(ni == nj)
-                  function(ni, nj) = 0;
-            }
-         }
-         return gm.addFunction(function);
-      } 
-      case L1:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 1);
-         ExplicitFunctionType function(shapeBegin, shapeEnd, functionParameter[0]);
-         for(typename GM::LabelType ni = 0; ni < shapeBegin[0]; ++ni) {
-            for(typename GM::LabelType nj = 0; nj < shapeBegin[1]; ++nj) {
-               function(ni, nj) = 0.1*fabs(1.0*ni-1.0*nj);
-            }
+         // the stream of a function is the index of the first factor using it
+         const UInt64Type stream = gm.numberOfFactors() + f;
+         if(random && !sharedFunction) {
+            newFunctions.push_back(std::make_pair(gm.addFunction(ExplicitFunctionType(shape.begin(), shape.end())), stream));
+            functionIds[f] = newFunctions.back().first;
          }
-         return gm.addFunction(function);
-      }
-      case RGPOTTS:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 2);
-         OPENGM_ASSERT(functionParameter[0] <= functionParameter[1]);
-         ValueType v = functionParameter[0] + (functionParameter[1] - functionParameter[0]) * (rand() % 1000000) * 0.000001;
-         ExplicitFunctionType function(shapeBegin, shapeEnd, v);
-         for(typename GM::LabelType ni = 0; ni < shapeBegin[0]; ++ni) {
-            for(typename GM::LabelType nj = 0; nj < shapeBegin[1]; ++nj) {
-               if(ni == nj)
-                  function(ni, nj) = 0;
+         else {
+            typename std::map<std::vector<LabelType>, FunctionIdentifier>::const_iterator it = sharedFunctions.find(shape);
+            if(it == sharedFunctions.end()) {
+               newFunctions.push_back(std::make_pair(gm.addFunction(ExplicitFunctionType(shape.begin(), shape.end())), stream));
+               it = sharedFunctions.insert(std::make_pair(shape, newFunctions.back().first)).first;
             }
+            functionIds[f] = it->second;
          }
-         return gm.addFunction(function);
       }
-      case CONSTF:
-         {
-         OPENGM_ASSERT(functionParameter.size() == 1);
-         ExplicitFunctionType function(shapeBegin, shapeEnd, functionParameter[0]);
-         return gm.addFunction(function);
+
+      #ifdef WITH_OPENMP
+      const int nThreads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+      #pragma omp parallel for schedule(dynamic, 256) num_threads(nThreads)
+      #endif
+      for(std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(newFunctions.size()); ++k) {
+         ExplicitFunctionType& function = gm.template getFunction<ExplicitFunctionType>(newFunctions[k].first);
+         fillFunction(function, functionType, functionParameter, id, newFunctions[k].second);
       }
-      default:
-         throw RuntimeError("Unknown function type for unary factors.");
+
+      for(size_t f = 0; f < numberOfFactors; ++f) {
+         gm.addFactorNonFinalized(functionIds[f], scopes.begin() + f * order, scopes.begin() + (f + 1) * order);
       }
    }
 
+   /// builds a model with unaries and one factor per scope of the given order
    template<class GM>
-   GM SyntheticModelGenerator2<GM>::buildGrid
+   GM SyntheticModelGenerator2<GM>::build
    (
       const size_t id,
-      const size_t height, const size_t width,
+      const size_t numVars,
       const size_t numStates,
+      const std::vector<IndexType>& scopes,
+      const size_t order,
       const Parameter& parameter
    ) const
    {
-      srand(id);
       OPENGM_ASSERT(parameter.isConsistent());
       OPENGM_ASSERT(parameter.functionTypes_.size() == 2);
-      GraphicalModelType gm = getGM(height*width,numStates,parameter.randomNumberOfStates_);
+      GraphicalModelType gm = getGM(id, numVars, numStates, parameter.randomNumberOfStates_);
+      gm.reserveFactors(numVars + (order == 0 ? 0 : scopes.size() / order));
+      gm.reserveFactorsVarialbeIndices(numVars + scopes.size());
       // UNARY
-      addUnaries(gm, parameter.functionTypes_[0], parameter.functionParameters_[0], parameter.sharedFunctions_[0] && !parameter.randomNumberOfStates_);
-      // PAIRWISE
-      typename GM::LabelType shape[2];
-      typename GM::IndexType var[2];
-      bool newFunction = true;
-      FunctionIdentifier funcId;
+      std::vector<IndexType> variables(numVars);
+      for(size_t i = 0; i < numVars; ++i) {
+         variables[i] = static_cast<IndexType>(i);
+      }
+      addFactors(gm, id, parameter.functionTypes_[0], parameter.functionParameters_[0],
+         parameter.sharedFunctions_[0] && !parameter.randomNumberOfStates_, variables, 1, parameter.numberOfThreads_);
+      // HIGHER ORDER
+      addFactors(gm, id, parameter.functionTypes_[1], parameter.functionParameters_[1],
+         parameter.sharedFunctions_[1] && !parameter.randomNumberOfStates_, scopes, order, parameter.numberOfThreads_);
+      gm.finalize();
+      return gm;
+   }
+
+   template<class GM>
+   GM SyntheticModelGenerator2<GM>::buildGrid
+   (
+      const size_t id,
+      const size_t height, const size_t width,
+      const size_t numStates,
+      const Parameter& parameter
+   ) const
+   {
+      std::vector<IndexType> scopes;
+      scopes.reserve(4 * height * width);
       for(size_t i = 0; i < height; ++i) {
          for(size_t j = 0; j < width; ++j) {
             size_t v = i + height * j;
             if(i + 1 < height) {
-               var[0] = v;
-               var[1] = i + 1 + height * j;
-               shape[0] = gm.numberOfLabels(var[0]);
-               shape[1] = gm.numberOfLabels(var[1]);
-               if(newFunction) {
-                  funcId = addFunction(gm, parameter.functionTypes_[1], parameter.functionParameters_[1], shape, shape + 2);
-               }
-               newFunction = !parameter.sharedFunctions_[1] || parameter.randomNumberOfStates_;
-               gm.addFactor(funcId, var, var + 2);
+               scopes.push_back(v);
+               scopes.push_back(i + 1 + height * j);
             }
             if(j + 1 < width) {
-               var[0] = v;
-               var[1] = i + height * (j + 1);
-               shape[0] = gm.numberOfLabels(var[0]);
-               shape[1] = gm.numberOfLabels(var[1]);
-               if(newFunction) {
-                  funcId = addFunction(gm, parameter.functionTypes_[1], parameter.functionParameters_[1], shape, shape + 2);
+               scopes.push_back(v);
+               scopes.push_back(i + height * (j + 1));
+            }
+         }
+      }
+      return build(id, height * width, numStates, scopes, 2, parameter);
+   }
+
+   /// 6-connected grid, variable (i, j, k) has the index i + height * (j + width * k)
+   template<class GM>
+   GM SyntheticModelGenerator2<GM>::buildGrid3D
+   (
+      const size_t id,
+      const size_t height, const size_t width, const size_t depth,
+      const size_t numStates,
+      const Parameter& parameter
+   ) const
+   {
+      std::vector<IndexType> scopes;
+      scopes.reserve(6 * height * width * depth);
+      for(size_t k = 0; k < depth; ++k) {
+         for(size_t j = 0; j < width; ++j) {
+            for(size_t i = 0; i < height; ++i) {
+               const size_t v = i + height * (j + width * k);
+               if(i + 1 < height) {
+                  scopes.push_back(v);
+                  scopes.push_back(v + 1);
+               }
+               if(j + 1 < width) {
+                  scopes.push_back(v);
+                  scopes.push_back(v + height);
+               }
+               if(k + 1 < depth) {
+                  scopes.push_back(v);
+                  scopes.push_back(v + height * width);
                }
-               newFunction = !parameter.sharedFunctions_[1] || parameter.randomNumberOfStates_;
-               gm.addFactor(funcId, var, var + 2);
             }
          }
       }
-      return gm;
+      return build(id, height * width * depth, numStates, scopes, 2, parameter);
    }
 
    template<class GM>
@@ -306,31 +358,15 @@ namespace opengm {
       const Parameter& parameter
    ) const
    {
-      srand(id);
-      OPENGM_ASSERT(parameter.isConsistent());
-      OPENGM_ASSERT(parameter.functionTypes_.size() == 2);
-      GraphicalModelType gm = getGM(numVars,numStates,parameter.randomNumberOfStates_);
-      //UNARY
-      addUnaries(gm, parameter.functionTypes_[0], parameter.functionParameters_[0], parameter.sharedFunctions_[0]&& !parameter.randomNumberOfStates_);
-      //PAIRWISE
-      typename GM::LabelType shape[2];
-      typename GM::IndexType var[2];
-      bool newFunction = true;
-      FunctionIdentifier funcId;
-      for(typename GM::IndexType i = 0; i < numVars; ++i) {
-         for(typename GM::IndexType j = i + 1; j < numVars; ++j) {
-            var[0] = i;
-            var[1] = j;
-            shape[0] = gm.numberOfLabels(var[0]);
-            shape[1] = gm.numberOfLabels(var[1]);
-            if(newFunction) {
-               funcId = addFunction(gm, parameter.functionTypes_[1], parameter.functionParameters_[1], shape, shape + 2);
-            }
-            newFunction = !parameter.sharedFunctions_[1] || parameter.randomNumberOfStates_;
-            gm.addFactor(funcId, var, var + 2);
+      std::vector<IndexType> scopes;
+      scopes.reserve(numVars > 0 ? numVars * (numVars - 1) : 0);
+      for(size_t i = 0; i < numVars; ++i) {
+         for(size_t j = i + 1; j < numVars; ++j) {
+            scopes.push_back(i);
+            scopes.push_back(j);
          }
       }
-      return gm;
+      return build(id, numVars, numStates, scopes, 2, parameter);
    }
 
    template<class GM>
@@ -342,41 +378,138 @@ namespace opengm {
       const Parameter& parameter
    ) const
    {
-      srand(id);
-      OPENGM_ASSERT(parameter.isConsistent());
-      OPENGM_ASSERT(parameter.functionTypes_.size() == 2);
-      GraphicalModelType gm = getGM(numVars,numStates,parameter.randomNumberOfStates_);
-      // UNARY
-      addUnaries(gm, parameter.functionTypes_[0], parameter.functionParameters_[0], parameter.sharedFunctions_[0]&& !parameter.randomNumberOfStates_);
-      // PAIRWISE
-      typename GM::LabelType shape[2];
-      typename GM::IndexType var[2];
-      bool newFunction = true;
-      FunctionIdentifier funcId;
-      const size_t root = (rand() % gm.numberOfVariables());
-      for(size_t i = 0; i < root; ++i) {
-         var[0] = i;
-         var[1] = root;
-         shape[0] = gm.numberOfLabels(var[0]);
-         shape[1] = gm.numberOfLabels(var[1]);
-         if(newFunction) {
-            funcId = addFunction(gm, parameter.functionTypes_[1], parameter.functionParameters_[1], shape, shape + 2);
+      const size_t root = static_cast<size_t>(numVars
+         * CounterBasedRandom::uniformAt(id, detail_syntheticmodelgenerator::structureStream, 0));
+      std::vector<IndexType> scopes;
+      scopes.reserve(2 * numVars);
+      for(size_t i = 0; i < numVars; ++i) {
+         if(i != root) {
+            scopes.push_back(std::min(i, root));
+            scopes.push_back(std::max(i, root));
+         }
+      }
+      return build(id, numVars, numStates, scopes, 2, parameter);
+   }
+
+   /// random graph in which every variable has exactly degree neighbors.
+   ///
+   /// The edges of a random perfect matching of numVars * degree stubs form a
+   /// multigraph; self-loops and parallel edges are removed by random edge switches.
+   template<class GM>
+   GM SyntheticModelGenerator2<GM>::buildRandomRegular
+   (
+      const size_t id,
+      const size_t numVars,
+      const size_t degree,
+      const size_t numStates,
+      const Parameter& parameter
+   ) const
+   {
+      if((numVars * degree) % 2 != 0 || (degree >= numVars && numVars > 0)) {
+         throw RuntimeError("A regular graph requires an even number of stubs and a degree smaller than the number of variables.");
+      }
+      std::vector<IndexType> stubs(numVars * degree);
+      for(size_t s = 0; s < stubs.size(); ++s) {
+         stubs[s] = static_cast<IndexType>(s / degree);
+      }
+      for(size_t s = stubs.size(); s > 1; --s) {
+         const size_t t = static_cast<size_t>(s
+            * CounterBasedRandom::uniformAt(id, detail_syntheticmodelgenerator::structureStream, s));
+         std::swap(stubs[s - 1], stubs[t]);
+      }
+
+      const size_t numberOfEdges = stubs.size() / 2;
+      std::unordered_set<UInt64Type> edges;
+      edges.reserve(numberOfEdges);
+      std::vector<size_t> invalid;
+      for(size_t e = 0; e < numberOfEdges; ++e) {
+         IndexType& a = stubs[2 * e];
+         IndexType& b = stubs[2 * e + 1];
+         if(a > b) {
+            std::swap(a, b);
+         }
+         if(a == b || !edges.insert(static_cast<UInt64Type>(a) * numVars + b).second) {
+            invalid.push_back(e);
          }
-         newFunction = !parameter.sharedFunctions_[1] || parameter.randomNumberOfStates_;
-         gm.addFactor(funcId, var, var + 2);
       }
-      for(size_t i = root + 1; i < gm.numberOfVariables(); ++i) {
-         var[0] = root;
-         var[1] = i;
-         shape[0] = gm.numberOfLabels(var[0]);
-         shape[1] = gm.numberOfLabels(var[1]);
-         if(newFunction) {
-            funcId = addFunction(gm, parameter.functionTypes_[1], parameter.functionParameters_[1], shape, shape + 2);
+      const size_t maxNumberOfSwitches = 100 * (numberOfEdges + 1);
+      for(size_t r = 0; !invalid.empty(); ++r) {
+         if(r == maxNumberOfSwitches) {
+            throw RuntimeError("Could not generate a simple regular graph.");
          }
-         newFunction = !parameter.sharedFunctions_[1] || parameter.randomNumberOfStates_;
-         gm.addFactor(funcId, var, var + 2);
+         // switch (a, b), (c, d) to (a, c), (b, d) or (a, d), (b, c)
+         const size_t e = invalid.back();
+         const size_t o = static_cast<size_t>(numberOfEdges
+            * CounterBasedRandom::uniformAt(id, detail_syntheticmodelgenerator::repairStream, 2 * r));
+         const bool cross = CounterBasedRandom::uniformAt(id, detail_syntheticmodelgenerator::repairStream, 2 * r + 1) < 0.5;
+         const IndexType a = stubs[2 * e];
+         const IndexType b = stubs[2 * e + 1];
+         const IndexType c = stubs[2 * o + (cross ? 1 : 0)];
+         const IndexType d = stubs[2 * o + (cross ? 0 : 1)];
+         const UInt64Type other = static_cast<UInt64Type>(std::min(c, d)) * numVars + std::max(c, d);
+         const UInt64Type first = static_cast<UInt64Type>(std::min(a, c)) * numVars + std::max(a, c);
+         const UInt64Type second = static_cast<UInt64Type>(std::min(b, d)) * numVars + std::max(b, d);
+         if(o == e || a == c || b == d || first == second || c == d
+            || std::find(invalid.begin(), invalid.end(), o) != invalid.end()
+            || edges.count(first) != 0 || edges.count(second) != 0) {
+            continue;
+         }
+         edges.erase(other);
+         edges.insert(first);
+         edges.insert(second);
+         stubs[2 * e] = std::min(a, c);
+         stubs[2 * e + 1] = std::max(a, c);
+         stubs[2 * o] = std::min(b, d);
+         stubs[2 * o + 1] = std::max(b, d);
+         invalid.pop_back();
       }
-      return gm;
+
+      // factors in lexicographic order of their variables
+      std::vector<std::pair<IndexType, IndexType> > sorted(numberOfEdges);
+      for(size_t e = 0; e < numberOfEdges; ++e) {
+         sorted[e] = std::make_pair(stubs[2 * e], stubs[2 * e + 1]);
+      }
+      std::sort(sorted.begin(), sorted.end());
+      for(size_t e = 0; e < numberOfEdges; ++e) {
+         stubs[2 * e] = sorted[e].first;
+         stubs[2 * e + 1] = sorted[e].second;
+      }
+      return build(id, numVars, numStates, stubs, 2, parameter);
+   }
+
+   /// numCliques factors over cliqueOrder distinct random variables each
+   template<class GM>
+   GM SyntheticModelGenerator2<GM>::buildCliques
+   (
+      const size_t id,
+      const size_t numVars,
+      const size_t numCliques,
+      const size_t cliqueOrder,
+      const size_t numStates,
+      const Parameter& parameter
+   ) const
+   {
+      if(cliqueOrder == 0 || cliqueOrder > numVars) {
+         throw RuntimeError("The order of the cliques must be positive and at most the number of variables.");
+      }
+      std::vector<IndexType> scopes(numCliques * cliqueOrder);
+      #ifdef WITH_OPENMP
+      const int nThreads = parameter.numberOfThreads_ > 0 ? static_cast<int>(parameter.numberOfThreads_) : omp_get_max_threads();
+      #pragma omp parallel for schedule(static) num_threads(nThreads)
+      #endif
+      for(std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t>(numCliques); ++c) {
+         IndexType* clique = &scopes[c * cliqueOrder];
+         UInt64Type draw = 0;
+         for(size_t j = 0; j < cliqueOrder; ++j) {
+            // rejection sampling of distinct variables, the draws of clique c are the stream c
+            do {
+               clique[j] = static_cast<IndexType>(numVars * CounterBasedRandom::uniformAt(
+                  id, detail_syntheticmodelgenerator::structureStream - 1 - static_cast<UInt64Type>(c), draw++));
+            } while(std::find(clique, clique + j, clique[j]) != clique + j);
+         }
+         std::sort(clique, clique + cliqueOrder);
+      }
+      return build(id, numVars, numStates, scopes, cliqueOrder, parameter);
    }
 
 } // namespace opengm
@@ -384,4 +517,3 @@ namespace opengm {
 /// \endcond
 
 #endif // #ifndef OPENGM_SYNTHETIC_MODEL_GENERATOR2_HXX
-
@@ -101,6 +101,16 @@ GridSpace<I, L>::numberOfLabels
    return numberOfStates_;
 }
 
+template<class I, class L>
+inline typename GridSpace<I, L>::LabelType
+GridSpace<I, L>::numberOfLabels
+(
+   const typename GridSpace<I, L>::IndexType x,
+   const typename GridSpace<I, L>::IndexType y
+) const{
+   return numberOfStates_;
+}
+
 template<class I, class L>
 inline bool
 GridSpace<I, L>::isSimpleSpace() const{
@@ -0,0 +1,805 @@
+#pragma once
+#ifndef OPENGM_ADMM_HXX
+#define OPENGM_ADMM_HXX
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/opengm.hxx"
+#include "opengm/operations/adder.hxx"
+#include "opengm/operations/minimizer.hxx"
+#include "opengm/operations/maximizer.hxx"
+#include "opengm/utilities/metaprogramming.hxx"
+#include "opengm/inference/inference.hxx"
+#include "opengm/inference/visitors/visitors.hxx"
+
+namespace opengm {
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_admm {
+
+/// Gauss-Jordan elimination of the regular or singular n x n system a x = b
+/// (a is row major). If a is regular, b is overwritten with x and true is
+/// returned. Otherwise b is overwritten with a non-zero vector of the null
+/// space of a and false is returned.
+inline bool solveOrNullVector(std::vector<double>& a, std::vector<double>& b, const size_t n) {
+   double scale = 1.0;
+   for(size_t i = 0; i < n * n; ++i) {
+      scale = std::max(scale, std::fabs(a[i]));
+   }
+   const double tolerance = 1e-10 * scale;
+   std::vector<size_t> pivotColumn;
+   std::vector<bool> isPivot(n, false);
+   for(size_t col = 0, row = 0; col < n && row < n; ++col) {
+      size_t best = row;
+      for(size_t r = row + 1; r < n; ++r) {
+         if(std::fabs(a[r * n + col]) > std::fabs(a[best * n + col])) {
+            best = r;
+         }
+      }
+      if(std::fabs(a[best * n + col]) <= tolerance) {
+         continue;
+      }
+      if(best != row) {
+         std::swap_ranges(a.begin() + best * n, a.begin() + (best + 1) * n, a.begin() + row * n);
+         std::swap(b[best], b[row]);
+      }
+      const double pivot = a[row * n + col];
+      for(size_t c = col; c < n; ++c) {
+         a[row * n + c] /= pivot;
+      }
+      b[row] /= pivot;
+      for(size_t r = 0; r < n; ++r) {
+         const double factor = a[r * n + col];
+         if(r == row || factor == 0.0) {
+            continue;
+         }
+         for(size_t c = col; c < n; ++c) {
+            a[r * n + c] -= factor * a[row * n + c];
+         }
+         b[r] -= factor * b[row];
+      }
+      pivotColumn.push_back(col);
+      isPivot[col] = true;
+      ++row;
+   }
+   if(pivotColumn.size() == n) {
+      return true;
+   }
+   const size_t freeColumn = std::find(isPivot.begin(), isPivot.end(), false) - isPivot.begin();
+   std::fill(b.begin(), b.begin() + n, 0.0);
+   b[freeColumn] = 1.0;
+   for(size_t r = 0; r < pivotColumn.size(); ++r) {
+      b[pivotColumn[r]] = -a[r * n + freeColumn];
+   }
+   return false;
+}
+
+} // namespace detail_admm
+/// \endcond
+
+/// \brief Alternating directions dual decomposition (AD3)\n\n
+/// A. F. T. Martins, M. A. T. Figueiredo, P. M. Q. Aguiar, N. A. Smith and E. P. Xing,
+/// "AD3: Alternating Directions Dual Decomposition for MAP Inference in Graphical Models", JMLR 16, 2015
+///
+/// Header-only ADMM solver of the local polytope relaxation. Every factor of order
+/// larger than one is a subproblem that receives an equal share of the unary
+/// potentials of its variables. In each iteration the quadratic subproblems of
+/// all factors are solved independently (in parallel with more than one thread),
+/// the variable marginals are averaged and the Lagrange multipliers are updated.
+/// Subproblems of pairwise factors of two binary variables are solved in closed
+/// form, all others by an active set method over the configurations of the factor
+/// that is warm started from the previous iteration.
+///
+/// bound() is the best dual value, value() the best labeling found by rounding the
+/// variable marginals. Only opengm::Adder with opengm::Minimizer or
+/// opengm::Maximizer is supported.
+/// \ingroup inference
+template<class GM, class ACC>
+class ADMM : public Inference<GM, ACC> {
+public:
+   typedef ACC AccumulationType;
+   typedef GM GraphicalModelType;
+   OPENGM_GM_TYPE_TYPEDEFS;
+   typedef visitors::VerboseVisitor<ADMM<GM, ACC> > VerboseVisitorType;
+   typedef visitors::EmptyVisitor<ADMM<GM, ACC> >   EmptyVisitorType;
+   typedef visitors::TimingVisitor<ADMM<GM, ACC> >  TimingVisitorType;
+
+   class Parameter {
+   public:
+      /// \param steps maximum number of iterations
+      /// \param eta initial penalty of the augmented Lagrangian
+      /// \param adaptEta balance primal and dual residual by adapting eta
+      /// \param residualThreshold stop if primal and dual residual fall below this threshold
+      /// \param numberOfThreads number of threads solving factor subproblems (0 = one per core)
+      Parameter(
+         const size_t steps = 1000,
+         const double eta = 0.1,
+         const bool adaptEta = true,
+         const double residualThreshold = 1e-6,
+         const size_t numberOfThreads = 1
+      )
+      :  steps_(steps),
+         eta_(eta),
+         adaptEta_(adaptEta),
+         residualThreshold_(residualThreshold),
+         numberOfThreads_(numberOfThreads)
+      {}
+
+      size_t steps_;
+      double eta_;
+      bool adaptEta_;
+      double residualThreshold_;
+      size_t numberOfThreads_;
+   };
+
+   ADMM(const GraphicalModelType&, const Parameter& = Parameter());
+   std::string name() const;
+   const GraphicalModelType& graphicalModel() const;
+   InferenceTermination infer();
+   template<class VisitorType>
+      InferenceTermination infer(VisitorType&);
+   void setStartingPoint(typename std::vector<LabelType>::const_iterator);
+   InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
+   ValueType value() const;
+   ValueType bound() const;
+
+   /// current variable marginals, concatenated for all variables
+   const std::vector<double>& posteriors() const
+      { return p_; }
+
+private:
+   struct Workspace {
+      std::vector<LabelType> labels_;
+      std::vector<LabelType> configurations_;
+      std::vector<double> kkt_;
+      std::vector<double> rhs_;
+      std::vector<double> potential_;
+      std::vector<double> marginal_;
+   };
+
+   size_t numberOfSlots(const size_t f) const
+      { return factorSlot_[f + 1] - factorSlot_[f]; }
+   size_t numberOfLabels(const size_t slot) const
+      { return slotOffset_[slot + 1] - slotOffset_[slot]; }
+   const double* variablePosterior(const size_t slot) const
+      { return &p_[labelOffset_[slotVariable_[slot]]]; }
+   size_t bestConfiguration(const size_t, const double*, Workspace&, double&) const;
+   void decode(const size_t, size_t, LabelType*) const;
+   void solveBinaryPairwise(const size_t);
+   void solveActiveSet(const size_t, Workspace&);
+   void roundSequentially(Workspace&);
+   void updateLabeling(const ValueType);
+
+   const GraphicalModelType& gm_;
+   Parameter parameter_;
+   double sign_;
+   double constant_;
+   double eta_;
+   // unary potentials and marginals of all variables
+   std::vector<size_t> labelOffset_;
+   std::vector<double> unary_;
+   std::vector<double> p_;
+   std::vector<IndexType> degree_;
+   std::vector<size_t> variableSlotBegin_;
+   std::vector<size_t> variableSlot_;
+   // higher order factors, their values and one slot per factor variable
+   std::vector<IndexType> factors_;
+   std::vector<size_t> valueOffset_;
+   std::vector<double> values_;
+   std::vector<size_t> factorSlot_;
+   std::vector<size_t> slotFactor_;
+   std::vector<IndexType> slotVariable_;
+   std::vector<size_t> slotOffset_;
+   std::vector<double> mu_;
+   std::vector<double> lambda_;
+   std::vector<double> potential_;
+   std::vector<std::vector<size_t> > activeSet_;
+   std::vector<std::vector<double> > activeWeights_;
+   std::vector<Workspace> workspaces_;
+   std::vector<LabelType> arg_;
+   std::vector<LabelType> rounded_;
+   ValueType value_;
+   ValueType bound_;
+};
+
+template<class GM, class ACC>
+ADMM<GM, ACC>::ADMM
+(
+   const GraphicalModelType& gm,
+   const Parameter& parameter
+)
+:  gm_(gm),
+   parameter_(parameter),
+   sign_(meta::Compare<ACC, Maximizer>::value ? 1.0 : -1.0),
+   constant_(0.0),
+   eta_(parameter.eta_),
+   labelOffset_(gm.numberOfVariables() + 1, 0),
+   degree_(gm.numberOfVariables(), 0),
+   factorSlot_(1, 0),
+   slotOffset_(1, 0),
+   arg_(gm.numberOfVariables(), 0),
+   rounded_(gm.numberOfVariables(), 0)
+{
+   if(!meta::Compare<OperatorType, Adder>::value) {
+      throw RuntimeError("ADMM supports only opengm::Adder as operator");
+   }
+   if(!meta::Compare<ACC, Minimizer>::value && !meta::Compare<ACC, Maximizer>::value) {
+      throw RuntimeError("ADMM supports only opengm::Minimizer and opengm::Maximizer as accumulator");
+   }
+
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      labelOffset_[v + 1] = labelOffset_[v] + gm_.numberOfLabels(v);
+   }
+   unary_.assign(labelOffset_.back(), 0.0);
+   p_.resize(labelOffset_.back());
+
+   std::vector<double> buffer;
+   valueOffset_.push_back(0);
+   for(IndexType f = 0; f < gm_.numberOfFactors(); ++f) {
+      const IndexType order = gm_[f].numberOfVariables();
+      buffer.resize(gm_[f].size());
+      gm_[f].copyValues(buffer.begin());
+      if(order == 0) {
+         constant_ += sign_ * buffer[0];
+      }
+      else if(order == 1) {
+         double* unary = &unary_[labelOffset_[gm_[f].variableIndex(0)]];
+         for(size_t l = 0; l < buffer.size(); ++l) {
+            unary[l] += sign_ * buffer[l];
+         }
+      }
+      else {
+         factors_.push_back(f);
+         for(size_t i = 0; i < buffer.size(); ++i) {
+            values_.push_back(sign_ * buffer[i]);
+         }
+         valueOffset_.push_back(values_.size());
+         for(IndexType k = 0; k < order; ++k) {
+            const IndexType v = gm_[f].variableIndex(k);
+            ++degree_[v];
+            slotFactor_.push_back(factors_.size() - 1);
+            slotVariable_.push_back(v);
+            slotOffset_.push_back(slotOffset_.back() + gm_.numberOfLabels(v));
+         }
+         factorSlot_.push_back(slotVariable_.size());
+      }
+   }
+
+   // slots of each variable
+   variableSlotBegin_.assign(gm_.numberOfVariables() + 1, 0);
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      variableSlotBegin_[v + 1] = variableSlotBegin_[v] + degree_[v];
+   }
+   variableSlot_.resize(slotVariable_.size());
+   std::vector<size_t> fill(variableSlotBegin_.begin(), variableSlotBegin_.end() - 1);
+   for(size_t slot = 0; slot < slotVariable_.size(); ++slot) {
+      variableSlot_[fill[slotVariable_[slot]]++] = slot;
+   }
+
+   mu_.assign(slotOffset_.back(), 0.0);
+   potential_.assign(slotOffset_.back(), 0.0);
+
+   // rounding of variables that are not covered by any factor subproblem
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      if(degree_[v] == 0) {
+         rounded_[v] = static_cast<LabelType>(std::max_element(unary_.begin() + labelOffset_[v], unary_.begin() + labelOffset_[v + 1]) - (unary_.begin() + labelOffset_[v]));
+      }
+   }
+   arg_ = rounded_;
+   value_ = gm_.evaluate(arg_.begin());
+   bound_ = ACC::template ineutral<ValueType>();
+}
+
+template<class GM, class ACC>
+inline std::string
+ADMM<GM, ACC>::name() const {
+   return "ADMM";
+}
+
+template<class GM, class ACC>
+inline const typename ADMM<GM, ACC>::GraphicalModelType&
+ADMM<GM, ACC>::graphicalModel() const {
+   return gm_;
+}
+
+template<class GM, class ACC>
+inline void
+ADMM<GM, ACC>::setStartingPoint
+(
+   typename std::vector<LabelType>::const_iterator begin
+) {
+   std::copy(begin, begin + gm_.numberOfVariables(), arg_.begin());
+   value_ = gm_.evaluate(arg_.begin());
+}
+
+template<class GM, class ACC>
+inline InferenceTermination
+ADMM<GM, ACC>::arg
+(
+   std::vector<LabelType>& arg,
+   const size_t n
+) const {
+   if(n != 1) {
+      return UNKNOWN;
+   }
+   arg = arg_;
+   return NORMAL;
+}
+
+template<class GM, class ACC>
+inline typename ADMM<GM, ACC>::ValueType
+ADMM<GM, ACC>::value() const {
+   return value_;
+}
+
+template<class GM, class ACC>
+inline typename ADMM<GM, ACC>::ValueType
+ADMM<GM, ACC>::bound() const {
+   return bound_;
+}
+
+template<class GM, class ACC>
+inline InferenceTermination
+ADMM<GM, ACC>::infer() {
+   EmptyVisitorType visitor;
+   return infer(visitor);
+}
+
+template<class GM, class ACC>
+template<class VisitorType>
+InferenceTermination
+ADMM<GM, ACC>::infer
+(
+   VisitorType& visitor
+) {
+   const size_t numberOfFactors = factors_.size();
+   #ifdef WITH_OPENMP
+   const int nThreads = parameter_.numberOfThreads_ > 0 ? static_cast<int>(parameter_.numberOfThreads_) : omp_get_max_threads();
+   #else
+   const int nThreads = 1;
+   #endif
+   workspaces_.resize(nThreads);
+   activeSet_.assign(numberOfFactors, std::vector<size_t>());
+   activeWeights_.assign(numberOfFactors, std::vector<double>());
+   lambda_.assign(slotOffset_.back(), 0.0);
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      std::fill(p_.begin() + labelOffset_[v], p_.begin() + labelOffset_[v + 1], 1.0 / gm_.numberOfLabels(v));
+   }
+   eta_ = parameter_.eta_;
+
+   // dual contribution of the variables that are not covered by any factor
+   double freeDual = constant_;
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      if(degree_[v] == 0) {
+         freeDual += *std::max_element(unary_.begin() + labelOffset_[v], unary_.begin() + labelOffset_[v + 1]);
+      }
+   }
+   const double numberOfEntries = std::max<double>(1.0, static_cast<double>(slotOffset_.back()));
+
+   visitor.begin(*this);
+   InferenceTermination termination = NORMAL;
+   for(size_t step = 0; step < parameter_.steps_; ++step) {
+      // factor subproblems
+      double dual = freeDual;
+      #ifdef WITH_OPENMP
+      #pragma omp parallel for schedule(dynamic, 64) num_threads(nThreads) reduction(+:dual)
+      #endif
+      for(std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t>(numberOfFactors); ++n) {
+         #ifdef WITH_OPENMP
+         Workspace& workspace = workspaces_[omp_get_thread_num()];
+         #else
+         Workspace& workspace = workspaces_[0];
+         #endif
+         const size_t f = static_cast<size_t>(n);
+         for(size_t slot = factorSlot_[f]; slot < factorSlot_[f + 1]; ++slot) {
+            const IndexType v = slotVariable_[slot];
+            const double share = 1.0 / degree_[v];
+            for(size_t l = 0; l < numberOfLabels(slot); ++l) {
+               potential_[slotOffset_[slot] + l] = share * unary_[labelOffset_[v] + l] + lambda_[slotOffset_[slot] + l];
+            }
+         }
+         double best;
+         bestConfiguration(f, &potential_[slotOffset_[factorSlot_[f]]], workspace, best);
+         dual += best;
+         if(numberOfSlots(f) == 2 && numberOfLabels(factorSlot_[f]) == 2 && numberOfLabels(factorSlot_[f] + 1) == 2) {
+            solveBinaryPairwise(f);
+         }
+         else {
+            solveActiveSet(f, workspace);
+         }
+      }
+      if(ACC::ibop(static_cast<ValueType>(sign_ * dual), bound_)) {
+         bound_ = static_cast<ValueType>(sign_ * dual);
+      }
+
+      // average the marginals of the factors
+      double dualResidual = 0.0;
+      #ifdef WITH_OPENMP
+      #pragma omp parallel for schedule(static) num_threads(nThreads) reduction(+:dualResidual)
+      #endif
+      for(std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t>(gm_.numberOfVariables()); ++n) {
+         const IndexType v = static_cast<IndexType>(n);
+         if(degree_[v] == 0) {
+            continue;
+         }
+         LabelType best = 0;
+         for(LabelType l = 0; l < gm_.numberOfLabels(v); ++l) {
+            double average = 0.0;
+            for(size_t s = variableSlotBegin_[v]; s < variableSlotBegin_[v + 1]; ++s) {
+               average += mu_[slotOffset_[variableSlot_[s]] + l];
+            }
+            average /= degree_[v];
+            const double difference = average - p_[labelOffset_[v] + l];
+            dualResidual += degree_[v] * difference * difference;
+            p_[labelOffset_[v] + l] = average;
+            if(average > p_[labelOffset_[v] + best]) {
+               best = l;
+            }
+         }
+         rounded_[v] = best;
+      }
+
+      // update the Lagrange multipliers
+      double primalResidual = 0.0;
+      #ifdef WITH_OPENMP
+      #pragma omp parallel for schedule(static) num_threads(nThreads) reduction(+:primalResidual)
+      #endif
+      for(std::ptrdiff_t n = 0; n < static_cast<std::ptrdiff_t>(slotVariable_.size()); ++n) {
+         const size_t slot = static_cast<size_t>(n);
+         const double* p = variablePosterior(slot);
+         for(size_t l = 0; l < numberOfLabels(slot); ++l) {
+            const double difference = mu_[slotOffset_[slot] + l] - p[l];
+            primalResidual += difference * difference;
+            lambda_[slotOffset_[slot] + l] -= eta_ * difference;
+         }
+      }
+      primalResidual = std::sqrt(primalResidual / numberOfEntries);
+      dualResidual = eta_ * std::sqrt(dualResidual / numberOfEntries);
+
+      updateLabeling(gm_.evaluate(rounded_.begin()));
+      if(step % 10 == 9) {
+         roundSequentially(workspaces_[0]);
+      }
+      if(visitor(*this) != visitors::VisitorReturnFlag::ContinueInf) {
+         break;
+      }
+      // the rounded labeling attains the dual bound
+      if(!ACC::bop(bound_, value_) || std::fabs(value_ - bound_) <= 1e-9 * std::max<double>(1.0, std::fabs(value_))) {
+         termination = CONVERGENCE;
+         break;
+      }
+      if(primalResidual < parameter_.residualThreshold_ && dualResidual < parameter_.residualThreshold_) {
+         termination = CONVERGENCE;
+         break;
+      }
+      if(parameter_.adaptEta_) {
+         if(primalResidual > 10.0 * dualResidual) {
+            eta_ *= 2.0;
+         }
+         else if(dualResidual > 10.0 * primalResidual) {
+            eta_ /= 2.0;
+         }
+      }
+   }
+   roundSequentially(workspaces_[0]);
+   visitor.end(*this);
+   return termination;
+}
+
+template<class GM, class ACC>
+inline void
+ADMM<GM, ACC>::updateLabeling
+(
+   const ValueType value
+) {
+   if(ACC::bop(value, value_)) {
+      value_ = value;
+      arg_ = rounded_;
+   }
+}
+
+/// rounds the variables one after the other, each to the label that maximizes
+/// the local dual subproblems given the labels of the preceding variables
+template<class GM, class ACC>
+void
+ADMM<GM, ACC>::roundSequentially
+(
+   Workspace& workspace
+) {
+   std::vector<double>& score = workspace.marginal_;
+   std::vector<LabelType>& labels = workspace.labels_;
+   for(IndexType v = 0; v < gm_.numberOfVariables(); ++v) {
+      if(degree_[v] == 0) {
+         continue;
+      }
+      score.assign(gm_.numberOfLabels(v), 0.0);
+      for(size_t s = variableSlotBegin_[v]; s < variableSlotBegin_[v + 1]; ++s) {
+         const size_t f = slotFactor_[variableSlot_[s]];
+         const size_t firstSlot = factorSlot_[f];
+         const size_t order = numberOfSlots(f);
+         const size_t self = variableSlot_[s] - firstSlot;
+         const double* values = &values_[valueOffset_[f]];
+         std::vector<double>& best = workspace.potential_;
+         best.assign(gm_.numberOfLabels(v), -std::numeric_limits<double>::infinity());
+         labels.assign(order, 0);
+         for(size_t index = 0; index < valueOffset_[f + 1] - valueOffset_[f]; ++index) {
+            bool consistent = true;
+            for(size_t k = 0; k < order && consistent; ++k) {
+               consistent = k == self || slotVariable_[firstSlot + k] > v || labels[k] == rounded_[slotVariable_[firstSlot + k]];
+            }
+            if(consistent) {
+               double value = values[index];
+               for(size_t k = 0; k < order; ++k) {
+                  const size_t slot = firstSlot + k;
+                  const IndexType u = slotVariable_[slot];
+                  value += unary_[labelOffset_[u] + labels[k]] / degree_[u] + lambda_[slotOffset_[slot] + labels[k]];
+               }
+               best[labels[self]] = std::max(best[labels[self]], value);
+            }
+            for(size_t k = 0; k < order; ++k) {
+               if(++labels[k] < numberOfLabels(firstSlot + k)) {
+                  break;
+               }
+               labels[k] = 0;
+            }
+         }
+         for(LabelType l = 0; l < gm_.numberOfLabels(v); ++l) {
+            score[l] += best[l];
+         }
+      }
+      rounded_[v] = static_cast<LabelType>(std::max_element(score.begin(), score.end()) - score.begin());
+   }
+   updateLabeling(gm_.evaluate(rounded_.begin()));
+}
+
+/// configuration of factor f with linear index (first variable fastest)
+template<class GM, class ACC>
+inline void
+ADMM<GM, ACC>::decode
+(
+   const size_t f,
+   size_t index,
+   LabelType* labels
+) const {
+   for(size_t slot = factorSlot_[f]; slot < factorSlot_[f + 1]; ++slot) {
+      const size_t numLabels = numberOfLabels(slot);
+      *labels++ = static_cast<LabelType>(index % numLabels);
+      index /= numLabels;
+   }
+}
+
+/// maximizes the factor values plus the potentials of the factor slots
+template<class GM, class ACC>
+size_t
+ADMM<GM, ACC>::bestConfiguration
+(
+   const size_t f,
+   const double* potential,
+   Workspace& workspace,
+   double& best
+) const {
+   const size_t firstSlot = factorSlot_[f];
+   const size_t order = numberOfSlots(f);
+   const size_t base = slotOffset_[firstSlot];
+   const double* values = &values_[valueOffset_[f]];
+   const size_t size = valueOffset_[f + 1] - valueOffset_[f];
+   std::vector<LabelType>& labels = workspace.labels_;
+   labels.assign(order, 0);
+   best = -std::numeric_limits<double>::infinity();
+   size_t bestIndex = 0;
+   for(size_t index = 0; index < size; ++index) {
+      double score = values[index];
+      for(size_t k = 0; k < order; ++k) {
+         score += potential[slotOffset_[firstSlot + k] - base + labels[k]];
+      }
+      if(score > best) {
+         best = score;
+         bestIndex = index;
+      }
+      for(size_t k = 0; k < order; ++k) {
+         if(++labels[k] < numberOfLabels(firstSlot + k)) {
+            break;
+         }
+         labels[k] = 0;
+      }
+   }
+   return bestIndex;
+}
+
+/// closed form solution of the subproblem of a pairwise factor of two binary
+/// variables, parametrized by z1 = mu1(1), z2 = mu2(1) and z12 = q(1,1)
+template<class GM, class ACC>
+void
+ADMM<GM, ACC>::solveBinaryPairwise
+(
+   const size_t f
+) {
+   const size_t slot = factorSlot_[f];
+   const double* theta = &values_[valueOffset_[f]];
+   const double* v1 = &potential_[slotOffset_[slot]];
+   const double* v2 = &potential_[slotOffset_[slot + 1]];
+   const double c1 = variablePosterior(slot)[1] + (theta[1] - theta[0] + v1[1] - v1[0]) / (2.0 * eta_);
+   const double c2 = variablePosterior(slot + 1)[1] + (theta[2] - theta[0] + v2[1] - v2[0]) / (2.0 * eta_);
+   const double c12 = (theta[0] - theta[1] - theta[2] + theta[3]) / (2.0 * eta_);
+
+   // minimizes (z1-c1)^2/2 + (z2-c2)^2/2 - c12 z12 over the marginal polytope,
+   // for c12 < 0 the second variable is flipped
+   const bool flip = c12 < 0.0;
+   const double a1 = flip ? c1 + c12 : c1;
+   const double a2 = flip ? 1.0 - c2 : c2;
+   const double a12 = std::fabs(c12);
+   double z1, z2;
+   if(a1 > a2 + a12) {
+      z1 = a1;
+      z2 = a2 + a12;
+   }
+   else if(a2 > a1 + a12) {
+      z1 = a1 + a12;
+      z2 = a2;
+   }
+   else {
+      z1 = z2 = (a1 + a2 + a12) / 2.0;
+   }
+   z1 = std::min(1.0, std::max(0.0, z1));
+   z2 = std::min(1.0, std::max(0.0, z2));
+   if(flip) {
+      z2 = 1.0 - z2;
+   }
+   double* mu1 = &mu_[slotOffset_[slot]];
+   double* mu2 = &mu_[slotOffset_[slot + 1]];
+   mu1[0] = 1.0 - z1;
+   mu1[1] = z1;
+   mu2[0] = 1.0 - z2;
+   mu2[1] = z2;
+}
+
+/// active set method for the subproblem
+///    max_q  values'q + potential'M q - eta/2 |M q - p|^2
+/// over distributions q on the configurations of factor f, M maps q to the
+/// marginals of the factor variables
+template<class GM, class ACC>
+void
+ADMM<GM, ACC>::solveActiveSet
+(
+   const size_t f,
+   Workspace& workspace
+) {
+   const size_t firstSlot = factorSlot_[f];
+   const size_t order = numberOfSlots(f);
+   const size_t base = slotOffset_[firstSlot];
+   const size_t width = slotOffset_[factorSlot_[f + 1]] - base;
+   const double* values = &values_[valueOffset_[f]];
+   const double* potential = &potential_[base];
+   std::vector<size_t>& active = activeSet_[f];
+   std::vector<double>& beta = activeWeights_[f];
+   std::vector<LabelType>& configurations = workspace.configurations_;
+   std::vector<double>& marginal = workspace.marginal_;
+   std::vector<double>& modified = workspace.potential_;
+   std::vector<double>& kkt = workspace.kkt_;
+   std::vector<double>& rhs = workspace.rhs_;
+
+   if(active.empty()) {
+      double best;
+      active.push_back(bestConfiguration(f, potential, workspace, best));
+      beta.assign(1, 1.0);
+   }
+   const size_t maxIterations = 10 * width + 10;
+   for(size_t iteration = 0; iteration < maxIterations; ++iteration) {
+      const size_t k = active.size();
+      configurations.resize(k * order);
+      for(size_t j = 0; j < k; ++j) {
+         decode(f, active[j], &configurations[j * order]);
+      }
+      // KKT system [H 1; 1' 0] [beta; tau] = [c; 1]
+      const size_t n = k + 1;
+      kkt.assign(n * n, 0.0);
+      rhs.assign(n, 0.0);
+      for(size_t j = 0; j < k; ++j) {
+         const LabelType* sj = &configurations[j * order];
+         double c = values[active[j]] / eta_;
+         for(size_t i = 0; i < order; ++i) {
+            c += potential[slotOffset_[firstSlot + i] - base + sj[i]] / eta_ + variablePosterior(firstSlot + i)[sj[i]];
+         }
+         rhs[j] = c;
+         for(size_t t = 0; t < k; ++t) {
+            size_t agreements = 0;
+            for(size_t i = 0; i < order; ++i) {
+               agreements += (sj[i] == configurations[t * order + i]);
+            }
+            kkt[j * n + t] = static_cast<double>(agreements);
+         }
+         kkt[j * n + k] = kkt[k * n + j] = 1.0;
+      }
+      rhs[k] = 1.0;
+      std::vector<double> c(rhs.begin(), rhs.begin() + k);
+
+      size_t blocking = k;
+      if(!detail_admm::solveOrNullVector(kkt, rhs, n)) {
+         // the objective is linear along the null direction, follow the ascending
+         // direction of the linear part until a weight vanishes
+         double slope = 0.0;
+         for(size_t j = 0; j < k; ++j) {
+            slope += c[j] * rhs[j];
+         }
+         const double direction = slope >= 0.0 ? 1.0 : -1.0;
+         double step = std::numeric_limits<double>::infinity();
+         for(size_t j = 0; j < k; ++j) {
+            const double d = direction * rhs[j];
+            if(d < 0.0 && -beta[j] / d < step) {
+               step = -beta[j] / d;
+               blocking = j;
+            }
+         }
+         OPENGM_ASSERT(blocking < k);
+         for(size_t j = 0; j < k; ++j) {
+            beta[j] += step * direction * rhs[j];
+         }
+      }
+      else {
+         double step = 1.0;
+         for(size_t j = 0; j < k; ++j) {
+            if(rhs[j] < 0.0 && beta[j] - rhs[j] > 0.0) {
+               const double s = beta[j] / (beta[j] - rhs[j]);
+               if(s < step) {
+                  step = s;
+                  blocking = j;
+               }
+            }
+         }
+         for(size_t j = 0; j < k; ++j) {
+            beta[j] += step * (rhs[j] - beta[j]);
+         }
+         if(blocking == k) {
+            // the solution on the active set is feasible, check optimality
+            marginal.assign(width, 0.0);
+            for(size_t j = 0; j < k; ++j) {
+               for(size_t i = 0; i < order; ++i) {
+                  marginal[slotOffset_[firstSlot + i] - base + configurations[j * order + i]] += beta[j];
+               }
+            }
+            modified.resize(width);
+            for(size_t i = 0; i < order; ++i) {
+               const double* p = variablePosterior(firstSlot + i);
+               for(size_t l = 0; l < numberOfLabels(firstSlot + i); ++l) {
+                  const size_t e = slotOffset_[firstSlot + i] - base + l;
+                  modified[e] = potential[e] + eta_ * (p[l] - marginal[e]);
+               }
+            }
+            double best;
+            const size_t candidate = bestConfiguration(f, &modified[0], workspace, best);
+            const double tau = rhs[k];
+            if(best / eta_ <= tau + 1e-12 * std::max(1.0, std::fabs(tau))
+               || std::find(active.begin(), active.end(), candidate) != active.end()) {
+               break;
+            }
+            active.push_back(candidate);
+            beta.push_back(0.0);
+            continue;
+         }
+      }
+      active.erase(active.begin() + blocking);
+      beta.erase(beta.begin() + blocking);
+   }
+
+   double* mu = &mu_[base];
+   std::fill(mu, mu + width, 0.0);
+   std::vector<LabelType>& labels = workspace.labels_;
+   labels.resize(order);
+   for(size_t j = 0; j < active.size(); ++j) {
+      decode(f, active[j], &labels[0]);
+      for(size_t i = 0; i < order; ++i) {
+         mu[slotOffset_[firstSlot + i] - base + labels[i]] += beta[j];
+      }
+   }
+}
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_ADMM_HXX
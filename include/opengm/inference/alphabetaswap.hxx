@@ -6,10 +6,17 @@
 
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/inference/auxiliary/minstcutgrid.hxx"
 
 namespace opengm {
 
 /// Alpha-Beta-Swap Algorithm
+///
+/// If the inference algorithm INF supports grids (GraphCut, unless
+/// Parameter::useGrid_ is false) and the graphical model is a grid, each
+/// swap move with regular pairwise terms is solved on the full grid, where
+/// variables with labels other than alpha and beta are isolated.
+///
 /// \ingroup inference
 template<class GM, class INF>
 class AlphaBetaSwap : public Inference<GM, typename INF::AccumulationType> {
@@ -48,6 +55,8 @@ private:
    size_t alpha_;
    size_t beta_;
    size_t maxState_;
+   marray::Matrix<size_t> grid_;
+   bool useGrid_;
    void increment();
    void addUnary(INF&, const size_t var, const ValueType v0, const ValueType v1);
    void addPairwise(INF&, const size_t var1, const size_t var2, const ValueType v0, const ValueType v1, const ValueType v2, const ValueType v3);
@@ -111,6 +120,7 @@ inline AlphaBetaSwap<GM, INF>::AlphaBetaSwap
       if (numSt > maxState_)
          maxState_ = numSt;
    }
+   useGrid_ = detail_minstcutgrid::gridEnabled<INF>(parameter_.parameter_, 0) && gm_.isGrid(grid_);
 }
 
 template<class GM, class INF>
@@ -200,27 +210,46 @@ AlphaBetaSwap<GM, INF>::infer
    size_t numberOfLabelPairs = maxState_*(maxState_ - 1)/2;
    while (it++ < parameter_.maxNumberOfIterations_ && countUnchanged < numberOfLabelPairs && exitInf == false) {
       increment();
+      vecAA[0] = alpha_;
+      vecAA[1] = alpha_;
+      vecBB[0] = beta_;
+      vecBB[1] = beta_;
+      vecBA[0] = beta_;
+      vecBA[1] = alpha_;
+      vecAB[0] = alpha_;
+      vecAB[1] = beta_;
+      // the grid solver needs regular pairwise terms (e.g. metrics),
+      // otherwise the move is solved on the alpha and beta variables only
+      bool gridMove = useGrid_;
+      for (size_t k = 0; k < gm_.numberOfFactors() && gridMove; ++k) {
+         const FactorType& factor = gm_[k];
+         if (factor.numberOfVariables() == 2
+         && (label_[factor.variableIndex(0)] == alpha_ || label_[factor.variableIndex(0)] == beta_)
+         && (label_[factor.variableIndex(1)] == alpha_ || label_[factor.variableIndex(1)] == beta_)
+         && AccumulationType::bop(factor(vecAB) + factor(vecBA), factor(vecAA) + factor(vecBB))) {
+            gridMove = false;
+         }
+      }
       size_t counter = 0;
       std::vector<size_t> numFacDim(4, 0);
       for (size_t i = 0; i < numberOfVariables; ++i) {
          if (label_[i] == alpha_ || label_[i] == beta_) {
-            variable2Node[i] = counter++;
+            variable2Node[i] = gridMove ? i : counter;
+            ++counter;
          }
       }
       if (counter == 0) {
          continue;
       }
-      INF inf(counter, numFacDim);
+      if (gridMove) {
+         counter = numberOfVariables;
+      }
+      INF inf(counter, numFacDim, parameter_.parameter_);
+      if (gridMove) {
+         detail_minstcutgrid::setGrid(inf, grid_, 0);
+      }
       vecA[0] = alpha_;
       vecB[0] = beta_;
-      vecAA[0] = alpha_;
-      vecAA[1] = alpha_;
-      vecBB[0] = beta_;
-      vecBB[1] = beta_;
-      vecBA[0] = beta_;
-      vecBA[1] = alpha_;
-      vecAB[0] = alpha_;
-      vecAB[1] = beta_;
       vecAX[0] = alpha_;
       vecBX[0] = beta_;
       vecXA[1] = alpha_;
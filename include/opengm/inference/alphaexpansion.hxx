@@ -4,10 +4,20 @@
 
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/inference/auxiliary/minstcutgrid.hxx"
+#include "opengm/utilities/random.hxx"
 
 namespace opengm {
 
 /// Alpha-Expansion Algorithm
+///
+/// If the inference algorithm INF supports grids (GraphCut, unless
+/// Parameter::useGrid_ is false) and the graphical model is a grid, each expansion
+/// move is solved on the grid: pairwise terms between two variables with
+/// labels different from alpha are added directly (which is exact for
+/// metrics) instead of by means of an auxiliary node. Moves with terms
+/// that are not regular are built with auxiliary nodes as usual.
+///
 /// \ingroup inference
 template<class GM, class INF>
 class AlphaExpansion
@@ -46,6 +56,7 @@ public:
       size_t maxNumberOfSteps_;
       LabelingIntitialType labelInitialType_;
       OrderType orderType_;
+      /// seeds of the counter-based random label order and initial labeling
       unsigned int randSeedOrder_;
       unsigned int randSeedLabel_;
       std::vector<LabelType> labelOrder_;
@@ -63,16 +74,19 @@ public:
    template<class Visitor>
       InferenceTermination infer(Visitor& visitor);
    void setStartingPoint(typename std::vector<LabelType>::const_iterator);
+   InferenceTermination rebind(const GraphicalModelType&);
    InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
 
 private:
-   const GraphicalModelType& gm_;
+   const GraphicalModelType* gm_;
    Parameter parameter_;
    std::vector<LabelType> label_;
    std::vector<LabelType> labelList_;
    size_t maxState_;
    size_t alpha_;
    size_t counter_;
+   marray::Matrix<size_t> grid_;
+   bool useGrid_;
    void incrementAlpha();
    void setLabelOrder(std::vector<LabelType>& l);
    void setLabelOrderRandom(unsigned int);
@@ -94,7 +108,7 @@ template<class GM, class INF>
 inline const typename AlphaExpansion<GM, INF>::GraphicalModelType&
 AlphaExpansion<GM, INF>::graphicalModel() const
 {
-   return gm_;
+   return *gm_;
 }
 
 template<class GM, class INF>
@@ -116,13 +130,27 @@ AlphaExpansion<GM,INF>::setStartingPoint
    typename std::vector<typename AlphaExpansion<GM,INF>::LabelType>::const_iterator begin
 ) {
    try{
-      label_.assign(begin, begin+gm_.numberOfVariables());
+      label_.assign(begin, begin+gm_->numberOfVariables());
    }
    catch(...) {
       throw RuntimeError("unsuitable starting point");
    }
 }
 
+/// \brief bind to a model of the same structure, the current labeling is the starting point of the next infer()
+template<class GM, class INF>
+inline InferenceTermination
+AlphaExpansion<GM,INF>::rebind
+(
+   const GraphicalModelType& gm
+) {
+   this->checkRebind(*gm_, gm);
+   gm_ = &gm;
+   counter_ = 0;
+   alpha_   = labelList_[counter_];
+   return NORMAL;
+}
+
 template<class GM, class INF>
 inline
 AlphaExpansion<GM, INF>::AlphaExpansion
@@ -130,17 +158,18 @@ AlphaExpansion<GM, INF>::AlphaExpansion
    const GraphicalModelType& gm,
    Parameter para
 )
-:  gm_(gm),
+:  gm_(&gm),
    parameter_(para),
-   maxState_(0)
+   maxState_(0),
+   useGrid_(false)
 {
-   for(size_t j=0; j<gm_.numberOfFactors(); ++j) {
-      if(gm_[j].numberOfVariables() > 2) {
+   for(size_t j=0; j<gm_->numberOfFactors(); ++j) {
+      if((*gm_)[j].numberOfVariables() > 2) {
          throw RuntimeError("This implementation of Alpha-Expansion supports only factors of order <= 2.");
       }
    }
-   for(size_t i=0; i<gm_.numberOfVariables(); ++i) {
-      size_t numSt = gm_.numberOfLabels(i);
+   for(size_t i=0; i<gm_->numberOfVariables(); ++i) {
+      size_t numSt = gm_->numberOfLabels(i);
       if(numSt > maxState_) {
          maxState_ = numSt;
       }
@@ -156,7 +185,7 @@ AlphaExpansion<GM, INF>::AlphaExpansion
       setInitialLabel(parameter_.label_);
    }
    else{
-      label_.resize(gm_.numberOfVariables(), 0);
+      label_.resize(gm_->numberOfVariables(), 0);
    }
 
 
@@ -174,6 +203,7 @@ AlphaExpansion<GM, INF>::AlphaExpansion
 
    counter_ = 0;
    alpha_   = labelList_[counter_];
+   useGrid_ = detail_minstcutgrid::gridEnabled<INF>(parameter_.parameter_, 0) && gm_->isGrid(grid_);
 }
 
 // reset assumes that the structure of
@@ -267,9 +297,9 @@ AlphaExpansion<GM, INF>::infer
    bool exitInf = false;
    size_t it = 0;
    size_t countUnchanged = 0;
-   size_t numberOfVariables = gm_.numberOfVariables();
+   size_t numberOfVariables = gm_->numberOfVariables();
    std::vector<size_t> variable2Node(numberOfVariables);
-   ValueType energy = gm_.evaluate(label_);
+   ValueType energy = gm_->evaluate(label_);
    visitor.begin(*this);
    LabelType vecA[1];
    LabelType vecX[1];
@@ -278,9 +308,31 @@ AlphaExpansion<GM, INF>::infer
    LabelType vecXA[2];
    LabelType vecXX[2];
    while(it++ < parameter_.maxNumberOfSteps_ && countUnchanged < maxState_ && exitInf == false) {
+      // on the grid, pairwise terms between two variables not labeled alpha
+      // are added without auxiliary nodes. This is exact only if these terms
+      // are regular (e.g. for metrics), otherwise the move is built as usual.
+      // The grid solver does not accept the negative capacities of irregular
+      // terms between equally labeled variables either.
+      bool gridMove = useGrid_;
+      for(size_t k=0 ; k<gm_->numberOfFactors() && gridMove; ++k) {
+         const FactorType& factor = (*gm_)[k];
+         if(factor.numberOfVariables() == 2) {
+            const size_t var1 = factor.variableIndex(0);
+            const size_t var2 = factor.variableIndex(1);
+            if(label_[var1] != alpha_ && label_[var2] != alpha_ ) {
+               vecAA[0] = vecAA[1] = alpha_;
+               vecAX[0] = alpha_;       vecAX[1] = label_[var2];
+               vecXA[0] = label_[var1]; vecXA[1] = alpha_;
+               vecXX[0] = label_[var1]; vecXX[1] = label_[var2];
+               if(AccumulationType::bop(factor(vecAX) + factor(vecXA), factor(vecAA) + factor(vecXX))) {
+                  gridMove = false;
+               }
+            }
+         }
+      }
       size_t numberOfAuxiliaryNodes = 0;
-      for(size_t k=0 ; k<gm_.numberOfFactors(); ++k) {
-         const FactorType& factor = gm_[k];
+      for(size_t k=0 ; k<gm_->numberOfFactors() && !gridMove; ++k) {
+         const FactorType& factor = (*gm_)[k];
          if(factor.numberOfVariables() == 2) {
             size_t var1 = factor.variableIndex(0);
             size_t var2 = factor.variableIndex(1);
@@ -291,17 +343,20 @@ AlphaExpansion<GM, INF>::infer
       }
       std::vector<size_t> numFacDim(4, 0);
       INF inf(numberOfVariables + numberOfAuxiliaryNodes, numFacDim, parameter_.parameter_);
+      if(gridMove) {
+         detail_minstcutgrid::setGrid(inf, grid_, 0);
+      }
       size_t varX = numberOfVariables;
       size_t countAlphas = 0;
-      for (size_t k=0 ; k<gm_.numberOfVariables(); ++k) {
+      for (size_t k=0 ; k<gm_->numberOfVariables(); ++k) {
          if (label_[k] == alpha_ ) {
             addUnary(inf, k, 0, std::numeric_limits<ValueType>::infinity());
             ++countAlphas;
          }
       }
-      if(countAlphas < gm_.numberOfVariables()) {
-         for (size_t k=0 ; k<gm_.numberOfFactors(); ++k) {
-            const  FactorType& factor = gm_[k];
+      if(countAlphas < gm_->numberOfVariables()) {
+         for (size_t k=0 ; k<gm_->numberOfFactors(); ++k) {
+            const  FactorType& factor = (*gm_)[k];
             if(factor.numberOfVariables() == 1) {
                size_t var = factor.variableIndex(0);
                vecA[0] = alpha_;
@@ -327,7 +382,7 @@ AlphaExpansion<GM, INF>::infer
                else if(label_[var2]==alpha_) {
                   addUnary(inf, var1, factor(vecAA), factor(vecXA));
                }
-               else if(label_[var1]==label_[var2]) {
+               else if(label_[var1]==label_[var2] || gridMove) {
                   addPairwise(inf, var1, var2, factor(vecAA), factor(vecAX), factor(vecXA), factor(vecXX));
                }
                else{
@@ -347,11 +402,11 @@ AlphaExpansion<GM, INF>::infer
             if (label_[var] != alpha_ && state[var]==0) {
                label_[var] = alpha_;
             }
-            OPENGM_ASSERT(label_[var] < gm_.numberOfLabels(var));
+            OPENGM_ASSERT(label_[var] < gm_->numberOfLabels(var));
          }
       }
-      OPENGM_ASSERT(gm_.numberOfVariables() == label_.size());
-      ValueType energy2 = gm_.evaluate(label_);
+      OPENGM_ASSERT(gm_->numberOfVariables() == label_.size());
+      ValueType energy2 = gm_->evaluate(label_);
       //visitor(*this,energy2,energy,alpha_);
       if( visitor(*this) != visitors::VisitorReturnFlag::ContinueInf ){
          exitInf=true;
@@ -383,7 +438,7 @@ AlphaExpansion<GM, INF>::arg
       return UNKNOWN;
    }
    else {
-      OPENGM_ASSERT(label_.size() == gm_.numberOfVariables());
+      OPENGM_ASSERT(label_.size() == gm_->numberOfVariables());
       arg.resize(label_.size());
       for(size_t i=0; i<label_.size(); ++i) {
          arg[i] = label_[i];
@@ -409,12 +464,12 @@ AlphaExpansion<GM, INF>::setLabelOrderRandom
 (
    unsigned int seed
 ) {
-   srand(seed);
    labelList_.resize(maxState_);
    for (size_t i=0; i<maxState_;++i) {
       labelList_[i]=i;
    }
-   random_shuffle(labelList_.begin(), labelList_.end());
+   CounterBasedRandom random(seed);
+   std::shuffle(labelList_.begin(), labelList_.end(), random);
 }
 
 template<class GM, class INF>
@@ -423,10 +478,10 @@ AlphaExpansion<GM, INF>::setInitialLabel
 (
    std::vector<LabelType>& l
 ) {
-   label_.resize(gm_.numberOfVariables());
+   label_.resize(gm_->numberOfVariables());
    if(l.size() == label_.size()) {
       for(size_t i=0; i<l.size();++i) {
-         if(l[i]>=gm_.numberOfLabels(i)) return;
+         if(l[i]>=gm_->numberOfLabels(i)) return;
       }
       for(size_t i=0; i<l.size();++i) {
          label_[i] = l[i];
@@ -437,15 +492,15 @@ AlphaExpansion<GM, INF>::setInitialLabel
 template<class GM, class INF>
 inline void
 AlphaExpansion<GM, INF>::setInitialLabelLocalOptimal() {
-   label_.resize(gm_.numberOfVariables(), 0);
+   label_.resize(gm_->numberOfVariables(), 0);
    std::vector<size_t> accVec;
-   for(size_t i=0; i<gm_.numberOfFactors();++i) {
-      if(gm_[i].numberOfVariables()==1) {
+   for(size_t i=0; i<gm_->numberOfFactors();++i) {
+      if((*gm_)[i].numberOfVariables()==1) {
          std::vector<size_t> state(1, 0);
-         ValueType value = gm_[i](state.begin());
-         for(state[0]=1; state[0]<gm_.numberOfLabels(i); ++state[0]) {
-            if(AccumulationType::bop(gm_[i](state.begin()), value)) {
-               value = gm_[i](state.begin());
+         ValueType value = (*gm_)[i](state.begin());
+         for(state[0]=1; state[0]<gm_->numberOfLabels(i); ++state[0]) {
+            if(AccumulationType::bop((*gm_)[i](state.begin()), value)) {
+               value = (*gm_)[i](state.begin());
                label_[i] = state[0];
             }
          }
@@ -459,10 +514,10 @@ AlphaExpansion<GM, INF>::setInitialLabelRandom
 (
    unsigned int seed
 ) {
-   srand(seed);
-   label_.resize(gm_.numberOfVariables());
-   for(size_t i=0; i<gm_.numberOfVariables();++i) {
-      label_[i] = rand() % gm_.numberOfLabels(i);
+   CounterBasedRandom random(seed);
+   label_.resize(gm_->numberOfVariables());
+   for(size_t i=0; i<gm_->numberOfVariables();++i) {
+      label_[i] = random.uniformInteger(static_cast<LabelType>(gm_->numberOfLabels(i)));
    }
 }
 
@@ -4,6 +4,7 @@
 
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/utilities/random.hxx"
 #include "opengm/inference/fix-fusion/fusion-move.hpp"
 #include "QPBO.h"
 
@@ -506,12 +507,12 @@ AlphaExpansionFusion<GM, ACC>::setLabelOrderRandom
 (
    unsigned int seed
 ) {
-   srand(seed);
    labelList_.resize(maxState_);
    for (size_t i=0; i<maxState_;++i) {
       labelList_[i]=i;
    }
-   random_shuffle(labelList_.begin(), labelList_.end());
+   CounterBasedRandom random(seed);
+   std::shuffle(labelList_.begin(), labelList_.end(), random);
 }
 
 template<class GM, class ACC>
@@ -556,10 +557,10 @@ AlphaExpansionFusion<GM, ACC>::setInitialLabelRandom
 (
    unsigned int seed
 ) {
-   srand(seed);
+   CounterBasedRandom random(seed);
    label_.resize(gm_.numberOfVariables());
    for(size_t i=0; i<gm_.numberOfVariables();++i) {
-      label_[i] = rand() % gm_.numberOfLabels(i);
+      label_[i] = random.uniformInteger(static_cast<LabelType>(gm_.numberOfLabels(i)));
    }
 }
 
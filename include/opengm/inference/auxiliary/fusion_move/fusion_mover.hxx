@@ -579,10 +579,12 @@ public:
                 }
             }
             else if(param_.fusionSolver_ == SoSFusion){
+                #ifdef WITH_SOSPD
                     typename SoSSubInf::Parameter subInfParam;
                     subInfParam.ubFn_ = param_.ubFn_;
                     subInfParam.flowAlg_ = param_.alg_;
                     valRes = fusionMover_. template fuse<SoSSubInf> (subInfParam,true);
+                #endif
             }
             else{
                throw RuntimeError("Unknown Fusion Type! Maybe caused by missing linking!");
@@ -23,6 +23,15 @@ using OUT::operator <<;
 #endif
 
 
+/// Dual variables of the LP relaxation, one vector per (factor, variable) pair
+/// of every factor with order > 1.
+///
+/// All dual vectors are kept in a single contiguous buffer, ordered by factor,
+/// local variable index and label. The offsets of the (factor, variable) slots
+/// are precomputed, so locating a dual vector is O(1) and the whole buffer can
+/// be serialized or written to HDF5 in one piece. The nested containers of
+/// earlier versions (VecUnaryFactors) and the per-factor maps of local variable
+/// ids (VarIdMapType) no longer exist, use getIterators and localId instead.
 template<class GM>
 class LPReparametrisationStorage{
 public:
@@ -32,27 +41,30 @@ public:
 	typedef typename GM::IndexType IndexType;
 	typedef typename GM::LabelType LabelType;
 
-	//typedef std::valarray<ValueType> UnaryFactor;
 	typedef std::vector<ValueType> UnaryFactor;
 	typedef ValueType* uIterator;
-	typedef std::vector<UnaryFactor> VecUnaryFactors;
-	typedef std::map<IndexType,IndexType> VarIdMapType;
+	typedef const ValueType* const_uIterator;
 	LPReparametrisationStorage(const GM& gm);
 
-	const UnaryFactor& get(IndexType factorIndex,IndexType relativeVarIndex)const//const access
+	/// copy of the dual vector of a (factor, variable) pair, getIterators gives access without a copy
+	UnaryFactor get(IndexType factorIndex,IndexType relativeVarIndex)const
 	{
-		OPENGM_ASSERT(factorIndex < _gm.numberOfFactors());
-		OPENGM_ASSERT(relativeVarIndex < _dualVariables[factorIndex].size());
-		return _dualVariables[factorIndex][relativeVarIndex];
+		const std::pair<const_uIterator,const_uIterator> it=getIterators(factorIndex,relativeVarIndex);
+		return UnaryFactor(it.first,it.second);
+	}
+
+	std::pair<const_uIterator,const_uIterator> getIterators(IndexType factorIndex,IndexType relativeVarIndex)const//const access
+	{
+		const size_t slot=_slotIndex(factorIndex,relativeVarIndex);
+		const_uIterator begin=_duals()+_slotOffset[slot];
+		return std::make_pair(begin,_duals()+_slotOffset[slot+1]);
 	}
 	std::pair<uIterator,uIterator> getIterators(IndexType factorIndex,IndexType relativeVarIndex)
-				{
-		OPENGM_ASSERT(factorIndex < _gm.numberOfFactors());
-		OPENGM_ASSERT(relativeVarIndex < _dualVariables[factorIndex].size());
-		UnaryFactor& uf=_dualVariables[factorIndex][relativeVarIndex];
-		uIterator begin=&uf[0];
-		return std::make_pair(begin,begin+uf.size());
-				}
+	{
+		const size_t slot=_slotIndex(factorIndex,relativeVarIndex);
+		uIterator begin=_duals()+_slotOffset[slot];
+		return std::make_pair(begin,_duals()+_slotOffset[slot+1]);
+	}
 
 	template<class ITERATOR>
 	ValueType getFactorValue(IndexType findex,ITERATOR it)const
@@ -64,11 +76,11 @@ public:
 		if (factor.numberOfVariables()>1)
 		{
 			res=factor(it);
+			const size_t* slotOffset=&_slotOffset[_factorSlot[findex]];
 			for (IndexType varId=0;varId<factor.numberOfVariables();++varId)
 			{
-				OPENGM_ASSERT(varId < _dualVariables[findex].size());
-				OPENGM_ASSERT(*(it+varId) < _dualVariables[findex][varId].size());
-				res+=_dualVariables[findex][varId][*(it+varId)];
+				OPENGM_ASSERT(slotOffset[varId]+*(it+varId) < slotOffset[varId+1]);
+				res+=_dualVariables[slotOffset[varId]+*(it+varId)];
 			}
 		}else
 		{
@@ -91,9 +103,9 @@ public:
 				continue;
 			}
 
-			OPENGM_ASSERT( factorId < _dualVariables.size() );
-			OPENGM_ASSERT(label < _dualVariables[factorId][localId(factorId,varIndex)].size());
-			res-=_dualVariables[factorId][localId(factorId,varIndex)][label];
+			const size_t slot=_slotIndex(factorId,localId(factorId,varIndex));
+			OPENGM_ASSERT(_slotOffset[slot]+label < _slotOffset[slot+1]);
+			res-=_dualVariables[_slotOffset[slot]+label];
 		}
 
 		return res;
@@ -102,12 +114,22 @@ public:
 	void PrintTestData(std::ostream& fout)const;
 #endif
 	IndexType localId(IndexType factorId,IndexType varIndex)const{
-		typename VarIdMapType::const_iterator it = _localIdMap[factorId].find(varIndex);
-		trws_base::exception_check(it!=_localIdMap[factorId].end(),"LPReparametrisationStorage:localId() - factor and variable are not connected!");
-		return it->second;};
+		OPENGM_ASSERT(factorId < _gm.numberOfFactors());
+		const FactorType& factor=_gm[factorId];
+		// factors are small, a linear scan over the variable indices beats any map
+		for (IndexType n=0;n<factor.numberOfVariables();++n)
+			if (factor.variableIndex(n)==varIndex) return n;
+		trws_base::exception_check(false,"LPReparametrisationStorage:localId() - factor and variable are not connected!");
+		return 0;};
 
 	const GM& graphicalModel()const{return _gm;}
 
+	/// total number of dual variables
+	size_t size()const{return _dualVariables.size();}
+	/// the contiguous buffer of all dual variables, see the class description for the ordering
+	const ValueType* data()const{return _duals();}
+	ValueType* data(){return _duals();}
+
 	template<class VECTOR>
 	void serialize(VECTOR* pserialization)const;
 	template<class VECTOR>
@@ -115,37 +137,49 @@ public:
 private:
 	LPReparametrisationStorage(const LPReparametrisationStorage&);//TODO: carefully implement, when needed
 	LPReparametrisationStorage& operator=(const LPReparametrisationStorage&);//TODO: carefully implement, when needed
+
+	size_t _slotIndex(IndexType factorIndex,IndexType relativeVarIndex)const
+	{
+		OPENGM_ASSERT(factorIndex < _gm.numberOfFactors());
+		OPENGM_ASSERT(_factorSlot[factorIndex]+relativeVarIndex < _factorSlot[factorIndex+1]);
+		return _factorSlot[factorIndex]+relativeVarIndex;
+	}
+	const ValueType* _duals()const{return _dualVariables.empty() ? 0 : &_dualVariables[0];}
+	ValueType* _duals(){return _dualVariables.empty() ? 0 : &_dualVariables[0];}
+
 	const GM& _gm;
-	std::vector<VecUnaryFactors> _dualVariables;
-	std::vector<VarIdMapType> _localIdMap;
+	std::vector<ValueType> _dualVariables;
+	std::vector<size_t> _factorSlot;//!> index of the first slot of each factor, numberOfFactors()+1 entries
+	std::vector<size_t> _slotOffset;//!> offset of each slot in _dualVariables, numberOfSlots+1 entries
 };
 
 template<class GM>
 LPReparametrisationStorage<GM>::LPReparametrisationStorage(const GM& gm)
-:_gm(gm),_localIdMap(gm.numberOfFactors())
+:_gm(gm),_factorSlot(gm.numberOfFactors()+1,0)
  {
-	_dualVariables.resize(_gm.numberOfFactors());
 	//for all factors with order > 1
+	size_t numberOfSlots=0;
 	for (IndexType findex=0;findex<_gm.numberOfFactors();++findex)
 	{
-		IndexType numVars=_gm[findex].numberOfVariables();
-		VarIdMapType& mapFindex=_localIdMap[findex];
-		if (numVars>=2)
-		{
+		_factorSlot[findex]=numberOfSlots;
+		if (_gm[findex].numberOfVariables()>=2)
+			numberOfSlots+=_gm[findex].numberOfVariables();
+	}
+	_factorSlot[_gm.numberOfFactors()]=numberOfSlots;
 
-			_dualVariables[findex].resize(numVars);
-			//std::valarray<IndexType> v(numVars);
-			std::vector<IndexType> v(numVars);
-			_gm[findex].variableIndices(&v[0]);
-			for (IndexType n=0;n<numVars;++n)
-			{
-				//_dualVariables[findex][n].assign(_gm.numberOfLabels(v[n]),0.0);//TODO. Do it like this
-				_dualVariables[findex][n].resize(_gm.numberOfLabels(v[n]));
-				mapFindex[v[n]]=n;
-			}
+	_slotOffset.resize(numberOfSlots+1);
+	size_t offset=0, slot=0;
+	for (IndexType findex=0;findex<_gm.numberOfFactors();++findex)
+	{
+		if (_gm[findex].numberOfVariables()<2) continue;
+		for (IndexType n=0;n<_gm[findex].numberOfVariables();++n)
+		{
+			_slotOffset[slot++]=offset;
+			offset+=_gm[findex].numberOfLabels(n);
 		}
 	}
-
+	_slotOffset[numberOfSlots]=offset;
+	_dualVariables.assign(offset,0.0);
  }
 
 #ifdef TRWS_DEBUG_OUTPUT
@@ -153,11 +187,15 @@ template<class GM>
 void LPReparametrisationStorage<GM>::PrintTestData(std::ostream& fout)const
 {
 	fout << "_dualVariables.size()=" << _dualVariables.size()<<std::endl;
-	for (IndexType factorIndex=0;factorIndex<_dualVariables.size();++factorIndex )
+	for (IndexType factorIndex=0;factorIndex<_gm.numberOfFactors();++factorIndex )
 	{
 		fout <<"factorIndex="<<factorIndex<<": ---------------------------------"<<std::endl;
-		for (IndexType varId=0;varId<_dualVariables[factorIndex].size();++varId)
-			fout <<"varId="<<varId<<": "<< _dualVariables[factorIndex][varId]<<std::endl;
+		for (size_t slot=_factorSlot[factorIndex];slot<_factorSlot[factorIndex+1];++slot)
+		{
+			fout <<"varId="<<slot-_factorSlot[factorIndex]<<": ";
+			std::copy(_dualVariables.begin()+_slotOffset[slot],_dualVariables.begin()+_slotOffset[slot+1],std::ostream_iterator<ValueType>(fout," "));
+			fout <<std::endl;
+		}
 	}
 }
 #endif
@@ -166,45 +204,19 @@ template<class GM>
 template<class VECTOR>
 void LPReparametrisationStorage<GM>::serialize(VECTOR* pserialization)const
 {
-//computing total space needed:
-size_t i=0;
-for (IndexType factorId=0;factorId<_dualVariables.size();++factorId)
- for (IndexType localId=0;localId<_dualVariables[factorId].size();++localId)
-  for (LabelType label=0;label<_dualVariables[factorId][localId].size();++label)
-	  ++i;
-
- pserialization->resize(i);
- //serializing....
- i=0;
- for (IndexType factorId=0;factorId<_dualVariables.size();++factorId)
-	 for (IndexType localId=0;localId<_dualVariables[factorId].size();++localId)
-		for (LabelType label=0;label<_dualVariables[factorId][localId].size();++label)
-		 (*pserialization)[i++]=_dualVariables[factorId][localId][label];
+ pserialization->resize(_dualVariables.size());
+ std::copy(_dualVariables.begin(),_dualVariables.end(),pserialization->begin());
 }
 
 template<class GM>
 template<class VECTOR>
 void LPReparametrisationStorage<GM>::deserialize(const VECTOR& serialization)
 {
-	size_t i=0;
-	 for (IndexType factorId=0;factorId<_gm.numberOfFactors();++factorId)
-	 {
-		 OPENGM_ASSERT(factorId<_dualVariables.size());
-		 if (_gm[factorId].numberOfVariables()==1) continue;
-		 for (IndexType localId=0;localId<_gm[factorId].numberOfVariables();++localId)
-		 {
-			OPENGM_ASSERT(localId<_dualVariables[factorId].size());
-			for (LabelType label=0;label<_dualVariables[factorId][localId].size();++label)
-			{
-			 OPENGM_ASSERT(label<_dualVariables[factorId][localId].size());
-			 if (i>=serialization.size())
-				 throw std::runtime_error("LPReparametrisationStorage<GM>::deserialize(): Size of serialization is less than required for the graphical model! Deserialization failed.");
-			 _dualVariables[factorId][localId][label]=serialization[i++];
-			}
-		 }
-	 }
-	 if (i!=serialization.size())
+	 if (serialization.size()<_dualVariables.size())
+		 throw std::runtime_error("LPReparametrisationStorage<GM>::deserialize(): Size of serialization is less than required for the graphical model! Deserialization failed.");
+	 if (serialization.size()>_dualVariables.size())
 		 throw std::runtime_error("LPReparametrisationStorage<GM>::deserialize(): Size of serialization is greater than required for the graphical model! Deserialization failed.");
+	 std::copy(serialization.begin(),serialization.end(),_dualVariables.begin());
 }
 /*
 #ifdef WITH_HDF5
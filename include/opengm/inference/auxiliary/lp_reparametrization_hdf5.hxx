@@ -14,27 +14,59 @@
 namespace opengm {
 namespace hdf5 {
 
+/// writes the dual buffer of the reparametrization as a one-dimensional dataset,
+/// without an intermediate copy
 template<class GM>
 void save(const LPReparametrisationStorage<GM>& repa,const std::string& filename,const std::string& modelname)
 {
-		hid_t file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-	    OPENGM_ASSERT(file >= 0);
-		marray::Vector<typename GM::ValueType> marr;
-		repa.serialize(&marr);
-		marray::hdf5::save(file,modelname.c_str(),marr);
-	    H5Fclose(file);
+	typedef typename GM::ValueType ValueType;
+	hid_t file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if(file < 0)
+		throw std::runtime_error("opengm::hdf5::save(): cannot create file "+filename);
+	hsize_t shape[1] = {static_cast<hsize_t>(repa.size())};
+	hid_t dataspace = H5Screate_simple(1, shape, NULL);
+	hid_t dataset = H5Dcreate(file, modelname.c_str(), marray::hdf5::hdf5Type<ValueType>(), dataspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+	herr_t status = -1;
+	if(dataset >= 0) {
+		status = H5Dwrite(dataset, marray::hdf5::hdf5Type<ValueType>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, repa.data());
+		H5Dclose(dataset);
+	}
+	H5Sclose(dataspace);
+	H5Fclose(file);
+	if(status < 0)
+		throw std::runtime_error("opengm::hdf5::save(): cannot write dataset "+modelname);
 }
 
+/// reads the dual buffer directly into the reparametrization, the dataset must
+/// have been written for the same graphical model
 template<class GM>
 void load(LPReparametrisationStorage<GM>* prepa, const std::string& filename, const std::string& modelname)
 {
+	typedef typename GM::ValueType ValueType;
 	hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
-	OPENGM_ASSERT(file>=0);
-	marray::Vector<typename GM::ValueType> marr;
-	marray::hdf5::load(file,modelname.c_str(),marr);
-	prepa->deserialize(marr);
+	if(file < 0)
+		throw std::runtime_error("opengm::hdf5::load(): cannot open file "+filename);
+	hid_t dataset = H5Dopen(file, modelname.c_str(), H5P_DEFAULT);
+	if(dataset < 0) {
+		H5Fclose(file);
+		throw std::runtime_error("opengm::hdf5::load(): cannot open dataset "+modelname);
+	}
+	hid_t filespace = H5Dget_space(dataset);
+	hsize_t shape[1] = {0};
+	const bool sizeMatches = H5Sget_simple_extent_ndims(filespace) == 1
+		&& H5Sget_simple_extent_dims(filespace, shape, NULL) >= 0
+		&& shape[0] == static_cast<hsize_t>(prepa->size());
+	herr_t status = -1;
+	if(sizeMatches)
+		status = H5Dread(dataset, marray::hdf5::hdf5Type<ValueType>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, prepa->data());
+	H5Sclose(filespace);
+	H5Dclose(dataset);
 	H5Fclose(file);
-};
+	if(!sizeMatches)
+		throw std::runtime_error("opengm::hdf5::load(): size of the stored reparametrization does not match the graphical model");
+	if(status < 0)
+		throw std::runtime_error("opengm::hdf5::load(): cannot read dataset "+modelname);
+}
 }
 }
 
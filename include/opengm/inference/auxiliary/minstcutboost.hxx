@@ -58,6 +58,7 @@ namespace opengm {
       MinSTCutBoost(size_t numberOfNodes, size_t numberOfEdges);
       void addEdge(node_type, node_type, ValueType);
       void calculateCut(std::vector<bool>&);
+      void reset();
 
    private:
       // Members
@@ -99,6 +100,14 @@ namespace opengm {
       //std::cout << n1 << "->" << n2 << " : " << cost << std::endl;
    }
 
+   /// \brief remove all edges, the vertices are kept
+   template<class NType, class VType, BoostMaxFlowAlgorithm mfalg>
+   void MinSTCutBoost<NType, VType, mfalg>::reset() {
+      for (size_t j = 0; j < num_vertices(graph_); ++j) {
+         clear_out_edges(static_cast<vertex_descriptor>(j), graph_);
+      }
+   }
+
    template<class NType, class VType, BoostMaxFlowAlgorithm mfalg>
    void MinSTCutBoost<NType, VType, mfalg>::calculateCut(std::vector<bool>& segmentation) {
       if (mfalg == KOLMOGOROV) {//Kolmogorov
@@ -0,0 +1,592 @@
+#pragma once
+#ifndef OPENGM_MINSTCUTGRID_HXX
+#define OPENGM_MINSTCUTGRID_HXX
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/opengm.hxx"
+
+namespace opengm {
+
+/// \brief Native min st-cut solver for 1D, 2D and 3D lattices
+///
+/// Nodes are the points of a dimX x dimY x dimZ grid in raster order
+/// (x fastest). Only edges between lattice neighbors (4-connectivity in 2D,
+/// 6-connectivity in 3D) are supported. They are stored implicitly, as one
+/// capacity per node and direction, so no edge lists are needed.
+///
+/// The maximum flow is computed by push-relabel on blocks of the lattice
+/// (region discharge). Blocks are colored such that blocks of the same
+/// color neither touch each other nor a common node; all blocks of a color
+/// are discharged in parallel (WITH_OPENMP). Exact distance labels are
+/// recomputed by a breadth first search from the sink after each sweep.
+///
+/// The interface is that of the other min st-cut backends of GraphCut:
+/// node 0 is the source, node 1 the sink and node i+2 the i-th grid point.
+///
+/// \ingroup inference
+template<class NType, class VType>
+class MinSTCutGrid {
+public:
+   typedef NType node_type;
+   typedef VType ValueType;
+
+   MinSTCutGrid(const size_t, const size_t = 1, const size_t = 1, const size_t = 0);
+   size_t numberOfNodes() const;
+   size_t dimension(const size_t) const;
+   bool adjacent(const node_type, const node_type) const;
+   void addEdge(node_type, node_type, ValueType);
+   void calculateCut(std::vector<bool>&);
+   void reset();
+
+private:
+   typedef unsigned int IndexType;
+   typedef unsigned int LabelType;
+
+   // per-thread buffers of the block discharge
+   struct Workspace {
+      std::vector<IndexType> active_;
+      std::vector<IndexType> queue_;
+      std::vector<std::pair<LabelType, IndexType> > seeds_;
+   };
+
+   bool neighbor(const IndexType, const size_t, IndexType&) const;
+   IndexType internalIndex(const size_t) const;
+   size_t direction(const size_t, const size_t) const;
+   size_t globalRelabel();
+   void dischargeBlock(const size_t, Workspace&);
+   void regionRelabel(const size_t, Workspace&);
+   void push(const IndexType, const size_t, const IndexType, const ValueType);
+
+   static const NType S = 0;
+   static const NType T = 1;
+   static const size_t NoNeighbor = static_cast<size_t>(-1);
+
+   size_t numberOfThreads_;
+   size_t dims_[3];
+   size_t numberOfAxes_;
+   size_t axes_[3];
+   size_t numberOfDirections_;
+   size_t localBits_[3];
+   size_t localShift_[3];
+   IndexType localMask_[3];
+   size_t blockShift_;
+   size_t numberOfBlocks_[3];
+   std::vector<size_t> blockNeighbors_;
+   std::vector<std::vector<size_t> > blocksOfColor_;
+   LabelType infinity_;
+
+   std::vector<ValueType> capacity_;
+   std::vector<ValueType> excess_;
+   std::vector<ValueType> sinkCapacity_;
+   std::vector<LabelType> label_;
+   std::vector<IndexType> queue_;
+};
+
+template<class NType, class VType>
+const size_t MinSTCutGrid<NType, VType>::NoNeighbor;
+
+/// \brief construct an empty lattice of dimX x dimY x dimZ nodes
+/// \param numberOfThreads number of threads (0 = all available), used only WITH_OPENMP
+template<class NType, class VType>
+MinSTCutGrid<NType, VType>::MinSTCutGrid
+(
+   const size_t dimX,
+   const size_t dimY,
+   const size_t dimZ,
+   const size_t numberOfThreads
+)
+:  numberOfThreads_(numberOfThreads),
+   numberOfAxes_(0),
+   blockShift_(0)
+{
+   if(dimX == 0 || dimY == 0 || dimZ == 0) {
+      throw RuntimeError("MinSTCutGrid: all grid dimensions must be positive.");
+   }
+   dims_[0] = dimX;
+   dims_[1] = dimY;
+   dims_[2] = dimZ;
+   for(size_t a = 0; a < 3; ++a) {
+      if(dims_[a] > 1) {
+         axes_[numberOfAxes_++] = a;
+      }
+   }
+   numberOfDirections_ = 2 * numberOfAxes_;
+
+   // blocks of 4096 nodes: 4096 (1D), 64x64 (2D), 16x16x16 (3D)
+   const size_t shift = numberOfAxes_ == 0 ? 0 : 12 / numberOfAxes_;
+   size_t totalBlocks = 1;
+   for(size_t a = 0; a < 3; ++a) {
+      const size_t s = dims_[a] > 1 ? shift : 0;
+      localBits_[a] = s;
+      localShift_[a] = blockShift_;
+      localMask_[a] = static_cast<IndexType>((size_t(1) << s) - 1);
+      blockShift_ += s;
+      numberOfBlocks_[a] = (dims_[a] + localMask_[a]) >> s;
+      totalBlocks *= numberOfBlocks_[a];
+   }
+   const size_t numberOfInternalNodes = totalBlocks << blockShift_;
+   if(numberOfInternalNodes >= static_cast<size_t>(std::numeric_limits<IndexType>::max())) {
+      throw RuntimeError("MinSTCutGrid: the grid is too large.");
+   }
+   infinity_ = static_cast<LabelType>(numberOfInternalNodes);
+
+   // neighboring blocks and block colors (parity of the block coordinates)
+   blockNeighbors_.assign(totalBlocks * numberOfDirections_, NoNeighbor);
+   blocksOfColor_.resize(size_t(1) << numberOfAxes_);
+   for(size_t b = 0; b < totalBlocks; ++b) {
+      const size_t coordinate[] = {
+         b % numberOfBlocks_[0],
+         (b / numberOfBlocks_[0]) % numberOfBlocks_[1],
+         b / (numberOfBlocks_[0] * numberOfBlocks_[1])
+      };
+      size_t color = 0;
+      size_t stride = 1;
+      for(size_t j = 0; j < numberOfAxes_; ++j) {
+         const size_t a = axes_[j];
+         color |= (coordinate[a] & 1) << j;
+         if(coordinate[a] > 0) {
+            blockNeighbors_[b * numberOfDirections_ + 2 * j] = b - stride;
+         }
+         if(coordinate[a] + 1 < numberOfBlocks_[a]) {
+            blockNeighbors_[b * numberOfDirections_ + 2 * j + 1] = b + stride;
+         }
+         stride *= numberOfBlocks_[a];
+      }
+      blocksOfColor_[color].push_back(b);
+   }
+
+   capacity_.assign(numberOfInternalNodes * numberOfDirections_, ValueType());
+   excess_.assign(numberOfInternalNodes, ValueType());
+   sinkCapacity_.assign(numberOfInternalNodes, ValueType());
+}
+
+/// \brief number of nodes including source and sink
+template<class NType, class VType>
+inline size_t
+MinSTCutGrid<NType, VType>::numberOfNodes() const
+{
+   return dims_[0] * dims_[1] * dims_[2] + 2;
+}
+
+template<class NType, class VType>
+inline size_t
+MinSTCutGrid<NType, VType>::dimension
+(
+   const size_t axis
+) const
+{
+   OPENGM_ASSERT(axis < 3);
+   return dims_[axis];
+}
+
+/// \brief check if two (non-terminal) nodes are lattice neighbors
+template<class NType, class VType>
+inline bool
+MinSTCutGrid<NType, VType>::adjacent
+(
+   const node_type n1,
+   const node_type n2
+) const
+{
+   if(n1 < 2 || n2 < 2 || n1 >= numberOfNodes() || n2 >= numberOfNodes()) {
+      return false;
+   }
+   return direction(n1 - 2, n2 - 2) != NoNeighbor;
+}
+
+/// \brief add capacity to the edge n1 -> n2
+template<class NType, class VType>
+inline void
+MinSTCutGrid<NType, VType>::addEdge
+(
+   node_type n1,
+   node_type n2,
+   ValueType cost
+)
+{
+   OPENGM_ASSERT(n1 < numberOfNodes());
+   OPENGM_ASSERT(n2 < numberOfNodes());
+   OPENGM_ASSERT(cost >= 0);
+   if(n1 == S) {
+      excess_[internalIndex(n2 - 2)] += cost;
+   }
+   else if(n2 == T) {
+      sinkCapacity_[internalIndex(n1 - 2)] += cost;
+   }
+   else {
+      const size_t d = direction(n1 - 2, n2 - 2);
+      if(d == NoNeighbor) {
+         throw RuntimeError("MinSTCutGrid: edges are supported only between neighboring grid nodes.");
+      }
+      capacity_[internalIndex(n1 - 2) * numberOfDirections_ + d] += cost;
+   }
+}
+
+/// \brief set all capacities to zero, the lattice is kept
+template<class NType, class VType>
+inline void
+MinSTCutGrid<NType, VType>::reset()
+{
+   std::fill(capacity_.begin(), capacity_.end(), ValueType());
+   std::fill(excess_.begin(), excess_.end(), ValueType());
+   std::fill(sinkCapacity_.begin(), sinkCapacity_.end(), ValueType());
+}
+
+/// \brief compute a minimum cut
+///
+/// segmentation[i] is true iff node i is on the sink side. Nodes that can
+/// reach the sink in the residual graph are assigned to the sink side.
+template<class NType, class VType>
+void
+MinSTCutGrid<NType, VType>::calculateCut
+(
+   std::vector<bool>& segmentation
+)
+{
+   const std::ptrdiff_t numberOfInternalNodes = static_cast<std::ptrdiff_t>(excess_.size());
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads_ > 0 ? static_cast<int>(numberOfThreads_) : omp_get_max_threads();
+   #endif
+
+   // route flow from the source directly to the sink where possible
+   #ifdef WITH_OPENMP
+   #pragma omp parallel for schedule(static) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t n = 0; n < numberOfInternalNodes; ++n) {
+      const ValueType m = std::min(excess_[n], sinkCapacity_[n]);
+      excess_[n] -= m;
+      sinkCapacity_[n] -= m;
+   }
+
+   label_.resize(excess_.size());
+   queue_.reserve(excess_.size());
+   while(globalRelabel() > 0) {
+      for(size_t c = 0; c < blocksOfColor_.size(); ++c) {
+         const std::vector<size_t>& blocks = blocksOfColor_[c];
+         #ifdef WITH_OPENMP
+         #pragma omp parallel num_threads(nThreads)
+         #endif
+         {
+            Workspace workspace;
+            #ifdef WITH_OPENMP
+            #pragma omp for schedule(dynamic, 1)
+            #endif
+            for(std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(blocks.size()); ++b) {
+               dischargeBlock(blocks[b], workspace);
+            }
+         }
+      }
+   }
+
+   segmentation.resize(numberOfNodes());
+   segmentation[S] = false;
+   segmentation[T] = true;
+   for(size_t i = 0; i + 2 < segmentation.size(); ++i) {
+      segmentation[i + 2] = label_[internalIndex(i)] < infinity_;
+   }
+}
+
+/// \brief exact distance labels by a breadth first search from the sink
+///
+/// \return number of active nodes (positive excess, finite label)
+template<class NType, class VType>
+size_t
+MinSTCutGrid<NType, VType>::globalRelabel()
+{
+   std::fill(label_.begin(), label_.end(), infinity_);
+   queue_.clear();
+   for(size_t n = 0; n < sinkCapacity_.size(); ++n) {
+      if(sinkCapacity_[n] > 0) {
+         label_[n] = 1;
+         queue_.push_back(static_cast<IndexType>(n));
+      }
+   }
+   for(size_t head = 0; head < queue_.size(); ++head) {
+      const IndexType w = queue_[head];
+      for(size_t d = 0; d < numberOfDirections_; ++d) {
+         IndexType u;
+         if(neighbor(w, d, u) && label_[u] == infinity_ && capacity_[u * numberOfDirections_ + (d ^ 1)] > 0) {
+            label_[u] = label_[w] + 1;
+            queue_.push_back(u);
+         }
+      }
+   }
+   size_t numberOfActiveNodes = 0;
+   for(size_t n = 0; n < excess_.size(); ++n) {
+      if(excess_[n] > 0 && label_[n] < infinity_) {
+         ++numberOfActiveNodes;
+      }
+   }
+   return numberOfActiveNodes;
+}
+
+/// \brief push-relabel restricted to the nodes of one block
+///
+/// Flow may leave the block; labels of nodes outside the block are not
+/// changed. The labels inside the block are recomputed by regionRelabel
+/// initially and whenever the number of relabel operations since the last
+/// update exceeds the number of nodes in the block. This prevents excess
+/// that cannot reach the sink from being pushed back and forth while its
+/// labels grow one by one.
+template<class NType, class VType>
+void
+MinSTCutGrid<NType, VType>::dischargeBlock
+(
+   const size_t block,
+   Workspace& workspace
+)
+{
+   const IndexType begin = static_cast<IndexType>(block << blockShift_);
+   const IndexType end = static_cast<IndexType>((block + 1) << blockShift_);
+   std::vector<IndexType>& active = workspace.active_;
+   active.clear();
+   for(IndexType n = begin; n < end; ++n) {
+      if(excess_[n] > 0 && label_[n] < infinity_) {
+         active.push_back(n);
+      }
+   }
+   if(active.empty()) {
+      return;
+   }
+   regionRelabel(block, workspace);
+   size_t numberOfRelabels = 0;
+   for(size_t head = 0; head < active.size(); ++head) {
+      const IndexType u = active[head];
+      while(excess_[u] > 0 && label_[u] < infinity_) {
+         // push along admissible edges
+         if(label_[u] == 1 && sinkCapacity_[u] > 0) {
+            const ValueType delta = std::min(excess_[u], sinkCapacity_[u]);
+            sinkCapacity_[u] -= delta;
+            excess_[u] -= delta;
+         }
+         for(size_t d = 0; d < numberOfDirections_ && excess_[u] > 0; ++d) {
+            const ValueType c = capacity_[u * numberOfDirections_ + d];
+            IndexType w;
+            if(c > 0 && neighbor(u, d, w) && label_[w] + 1 == label_[u]) {
+               const bool wasActive = excess_[w] > 0;
+               push(u, d, w, std::min(excess_[u], c));
+               if(!wasActive && w >= begin && w < end) {
+                  active.push_back(w);
+               }
+            }
+         }
+         // relabel
+         if(excess_[u] > 0) {
+            if(++numberOfRelabels > end - begin) {
+               regionRelabel(block, workspace);
+               numberOfRelabels = 0;
+               continue;
+            }
+            LabelType m = sinkCapacity_[u] > 0 ? 1 : infinity_;
+            for(size_t d = 0; d < numberOfDirections_; ++d) {
+               IndexType w;
+               if(capacity_[u * numberOfDirections_ + d] > 0 && neighbor(u, d, w)) {
+                  m = std::min(m, label_[w] + 1);
+               }
+            }
+            OPENGM_ASSERT(m > label_[u]);
+            label_[u] = std::min(m, infinity_);
+         }
+      }
+   }
+}
+
+/// \brief exact distance labels of the nodes in a block
+///
+/// Distances to the sink are computed within the block, where a path may
+/// also end at a node outside the block, whose label is taken as fixed.
+/// Seeds (nodes with residual capacity to the sink or to a node outside
+/// the block) are processed in the order of their labels, merged with the
+/// queue of the breadth first search.
+template<class NType, class VType>
+void
+MinSTCutGrid<NType, VType>::regionRelabel
+(
+   const size_t block,
+   Workspace& workspace
+)
+{
+   const IndexType begin = static_cast<IndexType>(block << blockShift_);
+   const IndexType end = static_cast<IndexType>((block + 1) << blockShift_);
+   std::vector<std::pair<LabelType, IndexType> >& seeds = workspace.seeds_;
+   std::vector<IndexType>& queue = workspace.queue_;
+   seeds.clear();
+   queue.clear();
+   for(IndexType u = begin; u < end; ++u) {
+      LabelType m = sinkCapacity_[u] > 0 ? 1 : infinity_;
+      for(size_t d = 0; d < numberOfDirections_; ++d) {
+         IndexType w;
+         if(capacity_[u * numberOfDirections_ + d] > 0 && neighbor(u, d, w) && (w < begin || w >= end)) {
+            m = std::min(m, label_[w] + 1);
+         }
+      }
+      if(m < infinity_) {
+         seeds.push_back(std::pair<LabelType, IndexType>(m, u));
+      }
+   }
+   std::sort(seeds.begin(), seeds.end());
+   std::fill(label_.begin() + begin, label_.begin() + end, infinity_);
+   for(size_t j = 0; j < seeds.size(); ++j) {
+      label_[seeds[j].second] = seeds[j].first;
+   }
+   size_t head = 0;
+   size_t seed = 0;
+   while(head < queue.size() || seed < seeds.size()) {
+      IndexType w;
+      if(seed < seeds.size() && (head == queue.size() || seeds[seed].first <= label_[queue[head]])) {
+         w = seeds[seed].second;
+         if(label_[w] != seeds[seed++].first) {
+            // improved by the search and therefore queued
+            continue;
+         }
+      }
+      else {
+         w = queue[head++];
+      }
+      for(size_t d = 0; d < numberOfDirections_; ++d) {
+         IndexType u;
+         if(neighbor(w, d, u) && u >= begin && u < end && label_[w] + 1 < label_[u] && capacity_[u * numberOfDirections_ + (d ^ 1)] > 0) {
+            label_[u] = label_[w] + 1;
+            queue.push_back(u);
+         }
+      }
+   }
+}
+
+template<class NType, class VType>
+inline void
+MinSTCutGrid<NType, VType>::push
+(
+   const IndexType u,
+   const size_t d,
+   const IndexType w,
+   const ValueType delta
+)
+{
+   capacity_[u * numberOfDirections_ + d] -= delta;
+   capacity_[w * numberOfDirections_ + (d ^ 1)] += delta;
+   excess_[u] -= delta;
+   excess_[w] += delta;
+}
+
+/// \brief neighbor of an internal node in a direction (2*axis: -, 2*axis+1: +)
+template<class NType, class VType>
+inline bool
+MinSTCutGrid<NType, VType>::neighbor
+(
+   const IndexType n,
+   const size_t d,
+   IndexType& w
+) const
+{
+   const size_t a = axes_[d >> 1];
+   const IndexType mask = localMask_[a];
+   const IndexType stride = IndexType(1) << localShift_[a];
+   const IndexType local = (n >> localShift_[a]) & mask;
+   if(d & 1) {
+      if(local < mask) {
+         w = n + stride;
+         return true;
+      }
+   }
+   else if(local > 0) {
+      w = n - stride;
+      return true;
+   }
+   const size_t b = blockNeighbors_[(n >> blockShift_) * numberOfDirections_ + d];
+   if(b == NoNeighbor) {
+      return false;
+   }
+   const IndexType offset = (n & ((IndexType(1) << blockShift_) - 1)) ^ (mask << localShift_[a]);
+   w = static_cast<IndexType>(b << blockShift_) | offset;
+   return true;
+}
+
+/// \brief position in the blocked storage of a node given in raster order
+template<class NType, class VType>
+inline typename MinSTCutGrid<NType, VType>::IndexType
+MinSTCutGrid<NType, VType>::internalIndex
+(
+   const size_t node
+) const
+{
+   const size_t coordinate[] = {
+      node % dims_[0],
+      (node / dims_[0]) % dims_[1],
+      node / (dims_[0] * dims_[1])
+   };
+   size_t block = 0;
+   size_t local = 0;
+   for(size_t a = 3; a-- > 0; ) {
+      block = block * numberOfBlocks_[a] + (coordinate[a] >> localBits_[a]);
+      local |= (coordinate[a] & localMask_[a]) << localShift_[a];
+   }
+   return static_cast<IndexType>((block << blockShift_) | local);
+}
+
+/// \brief direction from node n1 to node n2 (raster order), NoNeighbor if not adjacent
+template<class NType, class VType>
+inline size_t
+MinSTCutGrid<NType, VType>::direction
+(
+   const size_t n1,
+   const size_t n2
+) const
+{
+   const size_t c1[] = {n1 % dims_[0], (n1 / dims_[0]) % dims_[1], n1 / (dims_[0] * dims_[1])};
+   const size_t c2[] = {n2 % dims_[0], (n2 / dims_[0]) % dims_[1], n2 / (dims_[0] * dims_[1])};
+   size_t result = NoNeighbor;
+   for(size_t j = 0; j < numberOfAxes_; ++j) {
+      const size_t a = axes_[j];
+      if(c1[a] != c2[a]) {
+         if(result != NoNeighbor) {
+            return NoNeighbor;
+         }
+         if(c2[a] + 1 == c1[a]) {
+            result = 2 * j;
+         }
+         else if(c1[a] + 1 == c2[a]) {
+            result = 2 * j + 1;
+         }
+         else {
+            return NoNeighbor;
+         }
+      }
+   }
+   return result;
+}
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_minstcutgrid {
+
+   // true if the solver INF (e.g. GraphCut) can use MinSTCutGrid
+   template<class INF>
+   inline bool gridEnabled(const typename INF::Parameter& parameter, typename INF::GridMinStCutType*)
+      { return parameter.useGrid_; }
+   template<class INF>
+   inline bool gridEnabled(const typename INF::Parameter&, ...)
+      { return false; }
+
+   // hand the grid layout of the variables to the solver INF
+   template<class INF, class ARRAY>
+   inline bool setGrid(INF& inf, const ARRAY& variables, typename INF::GridMinStCutType*)
+      { return inf.setGrid(variables); }
+   template<class INF, class ARRAY>
+   inline bool setGrid(INF&, const ARRAY&, ...)
+      { return false; }
+
+} // namespace detail_minstcutgrid
+/// \endcond
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_MINSTCUTGRID_HXX
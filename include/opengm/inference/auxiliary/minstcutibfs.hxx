@@ -24,6 +24,7 @@ namespace opengm {
       MinSTCutIBFS(size_t numberOfNodes, size_t numberOfEdges);
       void addEdge(node_type,node_type,ValueType);
       void calculateCut(std::vector<bool>&);
+      void reset();
       
     private: 
       // Members
@@ -91,6 +92,16 @@ namespace opengm {
       return;
     };
 
+    /// \brief remove all edges
+    ///
+    /// IBFSGraph cannot be cleared, it is reallocated with the same size.
+    template<class NType, class VType>
+    void MinSTCutIBFS<NType,VType>::reset() {
+      delete graph_;
+      graph_         = new graph_type();
+      graph_->initSize((int)(numberOfNodes_-2),(int)(numberOfEdges_ - 2*(numberOfNodes_-2))); 
+    };
+
   } //namespace external
 } // namespace opengm
 
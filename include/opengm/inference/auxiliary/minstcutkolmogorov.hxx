@@ -27,6 +27,7 @@ public:
    MinSTCutKolmogorov(size_t numberOfNodes, size_t numberOfEdges);
    void addEdge(node_type,node_type,ValueType);
    void calculateCut(std::vector<bool>&);
+   void reset();
       
 private: 
    graph_type*  graph_;
@@ -92,6 +93,13 @@ void MinSTCutKolmogorov<NType,VType>::calculateCut(std::vector<bool>& segmentati
    return;
 }
 
+/// \brief remove all edges, the memory of the graph is kept
+template<class NType, class VType>
+void MinSTCutKolmogorov<NType,VType>::reset() {
+   graph_->reset();
+   graph_->add_node(numberOfNodes_-2);
+}
+
 /// \endcond 
 
 } // namespace external
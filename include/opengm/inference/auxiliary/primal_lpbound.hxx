@@ -12,6 +12,9 @@
 #include <opengm/inference/auxiliary/transportationsolver.hxx>
 #include <opengm/graphicalmodel/graphicalmodel.hxx>
 #include <opengm/inference/trws/utilities2.hxx>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace opengm
 {
@@ -35,12 +38,15 @@ template<class ValueType>
 struct PrimalLPBound_Parameter
 {
 	PrimalLPBound_Parameter(ValueType relativePrecision,
-			                size_t maxIterationNumber)
+			                size_t maxIterationNumber,
+			                size_t numberOfThreads=1)
 	:relativePrecision_(relativePrecision),
-	 maxIterationNumber_(maxIterationNumber){};
+	 maxIterationNumber_(maxIterationNumber),
+	 numberOfThreads_(numberOfThreads){};
 
 	ValueType relativePrecision_;
 	size_t maxIterationNumber_;
+	size_t numberOfThreads_;//!< number of threads used by getTotalValue() (0 = one per core), has effect only with WITH_OPENMP
 };
 
 //! [class primallpbound]
@@ -80,20 +86,22 @@ public:
 	template<class ValueIterator>
 	void getVariable(IndexType var, ValueIterator outputBegin);//memory has to be allocated in advance
 
-	ValueType getTotalValue(); // calls getFactorValue() and getVariableValue() and add them. Buffered
+	ValueType getTotalValue(); // calls getFactorValue() and getVariableValue() and add them. Buffered. Pairwise factors are processed in parallel with WITH_OPENMP
 	ValueType getFactorValue(IndexType factorId);//pairwise factor factorId. Buffering of the current value is performed
 	ValueType getVariableValue(IndexType varId); //inner product. Buffered
 	template<class Matrix>
 	ValueType getFactorVariable(IndexType factorId, Matrix& matrix); //pairwise factor factorId, buffering of the solution is performed
 
-	void ResetBuffer(){_bufferedValues(_gm.numberOfFactors(),ValueTypeNan); _totalValue=ValueTypeNan;}//reset buffer, if you changed potentials of gm and want to take this fact into account
+	void ResetBuffer(){_bufferedValues.assign(_gm.numberOfFactors(),ValueTypeNan); _totalValue=ValueTypeNan;}//reset buffer, if you changed potentials of gm and want to take this fact into account
 	bool IsValueBuffered(IndexType factorId)const{OPENGM_ASSERT(factorId<_bufferedValues.size()); return (_bufferedValues[factorId] != ValueTypeNan);}
 	bool IsFactorVariableBuffered(IndexType factorId)const{return _lastActiveSolver==factorId;}
 	static void CheckDuplicateUnaryFactors(const GM& gm);
 private:
 	void _checkPWFactorID(IndexType factorId,const std::string& message_prefix=std::string());
+	ValueType _solveFactor(IndexType factorId,Solver& solver)const;
 	const GM& _gm;
 	Solver _solver;
+	std::vector<Solver> _threadSolvers;//each thread reuses the workspace of its own solver
 	std::vector<UnaryFactor> _unaryFactors;
 	VariableToFactorMapping<GM> _mapping;
 
@@ -133,6 +141,9 @@ _solver(
 		std::cerr,
 #endif
 		param.relativePrecision_,param.maxIterationNumber_),
+#ifdef WITH_OPENMP
+_threadSolvers(param.numberOfThreads_>0 ? param.numberOfThreads_ : omp_get_max_threads(),_solver),
+#endif
 _unaryFactors(gm.numberOfVariables()),
 _mapping(gm),
 _bufferedValues(gm.numberOfFactors(),ValueTypeNan),
@@ -186,17 +197,25 @@ typename PrimalLPBound<GM,ACC>::ValueType PrimalLPBound<GM,ACC>::getFactorValue(
 
 	if (_bufferedValues[factorId] == ValueTypeNan)
 	{
-	const typename GM::FactorType& factor=_gm[factorId];
-	IndexType var0=factor.variableIndex(0),
-			  var1=factor.variableIndex(1);
-	_solver.Init(_unaryFactors[var0].size(),_unaryFactors[var1].size(),FactorWrapper<typename GM::FactorType>(factor));
-	_bufferedValues[factorId]=_solver.Solve(_unaryFactors[var0].begin(),_unaryFactors[var1].begin());
+	_bufferedValues[factorId]=_solveFactor(factorId,_solver);
 	_lastActiveSolver=factorId;
 	}
 
 	return _bufferedValues[factorId];
 }
 
+template <class GM,class ACC>
+typename PrimalLPBound<GM,ACC>::ValueType PrimalLPBound<GM,ACC>::_solveFactor(IndexType factorId,Solver& solver)const
+{
+	const typename GM::FactorType& factor=_gm[factorId];
+	IndexType var0=factor.variableIndex(0),
+			  var1=factor.variableIndex(1);
+	//the solver keeps a pointer to the wrapper, it has to live until Solve() returns
+	const FactorWrapper<typename GM::FactorType> wrapper(factor);
+	solver.Init(_unaryFactors[var0].size(),_unaryFactors[var1].size(),wrapper);
+	return solver.Solve(_unaryFactors[var0].begin(),_unaryFactors[var1].begin());
+}
+
 template <class GM,class ACC>
 template<class Matrix>
 typename PrimalLPBound<GM,ACC>::ValueType PrimalLPBound<GM,ACC>::getFactorVariable(IndexType factorId,  Matrix& matrix)
@@ -239,6 +258,37 @@ typename PrimalLPBound<GM,ACC>::ValueType PrimalLPBound<GM,ACC>::getTotalValue()
 {
 	if (_totalValue==ValueTypeNan)
 	{
+#ifdef WITH_OPENMP
+	//transportation problems of pairwise factors are independent and are solved in parallel.
+	//The last one is left to the sequential loop below, so that _solver keeps its solution as before.
+	std::ptrdiff_t numberOfPending=static_cast<std::ptrdiff_t>(_gm.numberOfFactors());
+	while ((numberOfPending>0) && ((_gm[numberOfPending-1].numberOfVariables()!=2) || (_bufferedValues[numberOfPending-1]!=ValueTypeNan)))
+		--numberOfPending;
+	--numberOfPending;
+	bool failed=false;
+	std::string errorMessage;
+	#pragma omp parallel for schedule(dynamic, 64) num_threads(static_cast<int>(_threadSolvers.size()))
+	for (std::ptrdiff_t f=0;f<numberOfPending;++f)
+	{
+		const IndexType factorId=static_cast<IndexType>(f);
+		if ((_gm[factorId].numberOfVariables()!=2) || (_bufferedValues[factorId]!=ValueTypeNan))
+			continue;
+		try
+		{
+			_bufferedValues[factorId]=_solveFactor(factorId,_threadSolvers[omp_get_thread_num()]);
+		}
+		catch (const std::exception& e)
+		{
+			#pragma omp critical(primal_lpbound_error)
+			{
+				failed=true;
+				errorMessage=e.what();
+			}
+		}
+	}
+	if (failed)
+		throw std::runtime_error(errorMessage);
+#endif
 	_totalValue=0;
 	for (IndexType factorId=0;factorId<_gm.numberOfFactors();++factorId)
 	{
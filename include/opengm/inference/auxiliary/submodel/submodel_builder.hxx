@@ -141,13 +141,29 @@ public:
         notFixedVarPosBuffer_(),
         nLocalVar_(0),
         handledFactor_(gm.numberOfFactors(),false),
-        labels_(gm.numberOfVariables())
+        labels_(gm.numberOfVariables()),
+        unaryOffset_(),
+        unaryValues_(),
+        edgeVis_(),
+        edgeOffset_(),
+        edgeValues_(),
+        localAdjacency_(),
+        highOrderOffset_(),
+        highOrderVis_(),
+        highOrderValues_(),
+        factorLabelBuffer_(),
+        currentLabelBuffer_(),
+        treeOrder_(),
+        treeParent_(),
+        treeParentEdge_(),
+        treeVisited_()
     {
         //std::cout<<"submodel constructor\n";
         const IndexType maxOrder = gm_.factorOrder();
         localFactorViBuffer_.resize(maxOrder);
         fixedVarPosBuffer_.resize(maxOrder);
         notFixedVarPosBuffer_.resize(maxOrder);
+        factorLabelBuffer_.resize(maxOrder);
         //std::cout<<"submodel constructor done\n";
     }
 
@@ -317,6 +333,269 @@ public:
     }
     
 
+    // optimize a tree shaped submodel by dynamic programming on the
+    // conditioned submodel, the buffers are reused between calls.
+    // falls back to mergeFactorsAndInferDp for conditioned factors of higher order
+    bool inferConditionedTreeDp(std::vector<LabelType> & resultArg){
+        OPENGM_CHECK_OP(nLocalVar_,!=,0,"");
+        buildConditionedModel();
+        if(highOrderOffset_.size()>1){
+            return mergeFactorsAndInferDp(resultArg);
+        }
+        const bool isForest = orderTree();
+        OPENGM_CHECK(isForest,"the submodel is not a forest");
+        if(resultArg.size()!=nLocalVar_){
+            resultArg.resize(nLocalVar_);
+        }
+
+        // collect beliefs from the leaves to the roots, unaryValues_ holds
+        // the belief of a variable once all its children are processed
+        for(IndexType t=nLocalVar_;t>0;--t){
+            const IndexType viLocal = treeOrder_[t-1];
+            const IndexType parent  = treeParent_[viLocal];
+            if(parent==viLocal){
+                continue;
+            }
+            const IndexType e       = treeParentEdge_[viLocal];
+            const bool      first   = edgeVis_[2*e]==viLocal;
+            const LabelType nLabels = submodelSpace_[viLocal];
+            const LabelType nLabelsParent = submodelSpace_[parent];
+            const LabelType nLabelsFirst  = submodelSpace_[edgeVis_[2*e]];
+            for(LabelType lp=0;lp<nLabelsParent;++lp){
+                ValueType message;
+                ACC::neutral(message);
+                for(LabelType l=0;l<nLabels;++l){
+                    const size_t index = first ? l+nLabelsFirst*lp : lp+nLabelsFirst*l;
+                    ValueType value = unaryValues_[unaryOffset_[viLocal]+l];
+                    OperatorType::op(edgeValues_[edgeOffset_[e]+index],value);
+                    ACC::op(value,message);
+                }
+                OperatorType::op(message,unaryValues_[unaryOffset_[parent]+lp]);
+            }
+        }
+
+        // decode from the roots to the leaves
+        for(IndexType t=0;t<nLocalVar_;++t){
+            const IndexType viLocal = treeOrder_[t];
+            const IndexType parent  = treeParent_[viLocal];
+            const LabelType nLabels = submodelSpace_[viLocal];
+            ValueType best;
+            ACC::neutral(best);
+            LabelType bestLabel = 0;
+            for(LabelType l=0;l<nLabels;++l){
+                ValueType value = unaryValues_[unaryOffset_[viLocal]+l];
+                if(parent!=viLocal){
+                    const IndexType e     = treeParentEdge_[viLocal];
+                    const bool      first = edgeVis_[2*e]==viLocal;
+                    const LabelType lp    = resultArg[parent];
+                    const LabelType nLabelsFirst = submodelSpace_[edgeVis_[2*e]];
+                    OperatorType::op(edgeValues_[edgeOffset_[e]+(first ? l+nLabelsFirst*lp : lp+nLabelsFirst*l)],value);
+                }
+                if(l==0 || ACC::bop(value,best)){
+                    best=value;
+                    bestLabel=l;
+                }
+            }
+            resultArg[viLocal]=bestLabel;
+        }
+
+        for(IndexType localVi=0;localVi<nLocalVar_;++localVi){
+            const IndexType globalVi=localVariables_[localVi];
+            if(resultArg[localVi]!=labels_[globalVi]){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // build the conditioned submodel with explicit functions and infer.
+    // If improving is set, a result that is worse than the current labels of
+    // the submodel (e.g. of an approximate solver) is replaced by them.
+    template<class SOLVER>
+    bool inferConditionedSubmodel(
+        const typename SOLVER::Parameter & para ,
+        std::vector<LabelType> & resultArg,
+        const bool improving=true,
+        const bool warmStart=false
+    ){
+        OPENGM_CHECK_OP(nLocalVar_,!=,0,"");
+        if(resultArg.size()!=nLocalVar_){
+            resultArg.resize(nLocalVar_);
+        }
+        buildConditionedModel();
+        const IndexType nEdges     = static_cast<IndexType>(edgeOffset_.size());
+        const IndexType nHighOrder = static_cast<IndexType>(highOrderOffset_.size()-1);
+
+        MergedSubGmType subGm( SubSpaceType(submodelSpace_.begin(),submodelSpace_.begin()+nLocalVar_) );
+        subGm.reserveFactors(nLocalVar_+nEdges+nHighOrder);
+        subGm.reserveFactorsVarialbeIndices(nLocalVar_+2*nEdges+highOrderVis_.size());
+        subGm. template reserveFunctions<ArrayFunction>(nLocalVar_+nEdges+nHighOrder);
+        for(IndexType viLocal=0;viLocal<nLocalVar_;++viLocal){
+            const LabelType * shape = &submodelSpace_[viLocal];
+            ArrayFunction function(shape,shape+1);
+            std::copy(unaryValues_.begin()+unaryOffset_[viLocal],unaryValues_.begin()+unaryOffset_[viLocal+1],&function(0));
+            subGm.addFactorNonFinalized(subGm.addFunction(function),&viLocal,&viLocal+1);
+        }
+        for(IndexType e=0;e<nEdges;++e){
+            const LabelType shape[] = {submodelSpace_[edgeVis_[2*e]],submodelSpace_[edgeVis_[2*e+1]]};
+            ArrayFunction function(shape,shape+2);
+            std::copy(edgeValues_.begin()+edgeOffset_[e],edgeValues_.begin()+edgeOffset_[e]+shape[0]*shape[1],&function(0));
+            subGm.addFactorNonFinalized(subGm.addFunction(function),edgeVis_.begin()+2*e,edgeVis_.begin()+2*e+2);
+        }
+        size_t visBegin=0;
+        for(IndexType h=0;h<nHighOrder;++h){
+            const size_t visEnd = visBegin+highOrderVis_[visBegin]+1;
+            for(size_t v=visBegin+1;v<visEnd;++v){
+                localFactorViBuffer_[v-visBegin-1]=highOrderVis_[v];
+                factorLabelBuffer_[v-visBegin-1]=submodelSpace_[highOrderVis_[v]];
+            }
+            const IndexType order = static_cast<IndexType>(visEnd-visBegin-1);
+            ArrayFunction function(factorLabelBuffer_.begin(),factorLabelBuffer_.begin()+order);
+            std::copy(highOrderValues_.begin()+highOrderOffset_[h],highOrderValues_.begin()+highOrderOffset_[h+1],&function(0));
+            subGm.addFactorNonFinalized(subGm.addFunction(function),localFactorViBuffer_.begin(),localFactorViBuffer_.begin()+order);
+            visBegin=visEnd;
+        }
+        subGm.finalize();
+
+        currentLabelBuffer_.resize(nLocalVar_);
+        for(IndexType viLocal=0;viLocal<nLocalVar_;++viLocal){
+            currentLabelBuffer_[viLocal]=labels_[localVariables_[viLocal]];
+        }
+        SOLVER solver(subGm,para);
+        if(warmStart){
+            solver.setStartingPoint(currentLabelBuffer_.begin());
+        }
+        solver.infer();
+        solver.arg(resultArg);
+        if(improving && AccumulationType::bop(subGm.evaluate(currentLabelBuffer_.begin()),subGm.evaluate(resultArg.begin()))){
+            std::copy(currentLabelBuffer_.begin(),currentLabelBuffer_.end(),resultArg.begin());
+            return false;
+        }
+
+        for(IndexType localVi=0;localVi<nLocalVar_;++localVi){
+            const IndexType globalVi=localVariables_[localVi];
+            if(resultArg[localVi]!=labels_[globalVi]){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // condition all factors of the submodel on the labels of the
+    // variables outside. Factors with one free variable are merged into
+    // the unary tables, factors with two free variables into one table
+    // per pair of variables. The buffers keep their capacity.
+    // O( sum over factors of the submodel of the conditioned table size )
+    void buildConditionedModel(){
+        unaryOffset_.resize(nLocalVar_+1);
+        unaryOffset_[0]=0;
+        for(IndexType viLocal=0;viLocal<nLocalVar_;++viLocal){
+            unaryOffset_[viLocal+1]=unaryOffset_[viLocal]+submodelSpace_[viLocal];
+        }
+        unaryValues_.resize(unaryOffset_[nLocalVar_]);
+        for(size_t i=0;i<unaryValues_.size();++i){
+            OperatorType::neutral(unaryValues_[i]);
+        }
+        if(localAdjacency_.size()<nLocalVar_){
+            localAdjacency_.resize(nLocalVar_);
+        }
+        for(IndexType viLocal=0;viLocal<nLocalVar_;++viLocal){
+            localAdjacency_[viLocal].clear();
+        }
+        edgeVis_.clear();
+        edgeOffset_.clear();
+        edgeValues_.clear();
+        highOrderOffset_.assign(1,0);
+        highOrderVis_.clear();
+        highOrderValues_.clear();
+
+        for(IndexType localVi=0;localVi<nLocalVar_;++localVi){
+            const IndexType globalVi = localVariables_[localVi];
+            const IndexType nFac = gm_.numberOfFactors(globalVi);
+            for(IndexType f=0;f<nFac;++f){
+                const IndexType fi = gm_.factorOfVariable(globalVi,f);
+                if(handledFactor_[fi]==true){
+                    continue;
+                }
+                handledFactor_[fi]=true;
+                const FactorType & factor = gm_[fi];
+                const IndexType    order  = factor.numberOfVariables();
+                OPENGM_CHECK_OP(order,>,0,"order==0 is not yet supported");
+
+                IndexType notFixedVars = 0;
+                for(IndexType v=0;v<order;++v){
+                    const IndexType facVi=factor.variableIndex(v);
+                    if(inSubmodel_[facVi]){
+                        notFixedVarPosBuffer_[notFixedVars]=v;
+                        ++notFixedVars;
+                    }
+                    else{
+                        factorLabelBuffer_[v]=labels_[facVi];
+                    }
+                }
+
+                if(notFixedVars==1){
+                    const IndexType viLocal = globalToLocalVariables_[factor.variableIndex(notFixedVarPosBuffer_[0])];
+                    const IndexType pos     = notFixedVarPosBuffer_[0];
+                    for(LabelType l=0;l<submodelSpace_[viLocal];++l){
+                        factorLabelBuffer_[pos]=l;
+                        OperatorType::op(factor(factorLabelBuffer_.begin()),unaryValues_[unaryOffset_[viLocal]+l]);
+                    }
+                }
+                else if(notFixedVars==2){
+                    const IndexType pos0 = notFixedVarPosBuffer_[0];
+                    const IndexType pos1 = notFixedVarPosBuffer_[1];
+                    const IndexType vi0  = globalToLocalVariables_[factor.variableIndex(pos0)];
+                    const IndexType vi1  = globalToLocalVariables_[factor.variableIndex(pos1)];
+                    const IndexType e    = findOrAddEdge(std::min(vi0,vi1),std::max(vi0,vi1));
+                    const bool transposed = vi0>vi1;
+                    const LabelType n0 = submodelSpace_[vi0];
+                    const LabelType n1 = submodelSpace_[vi1];
+                    for(LabelType l1=0;l1<n1;++l1){
+                        factorLabelBuffer_[pos1]=l1;
+                        for(LabelType l0=0;l0<n0;++l0){
+                            factorLabelBuffer_[pos0]=l0;
+                            const size_t index = transposed ? l1+n1*l0 : l0+n0*l1;
+                            OperatorType::op(factor(factorLabelBuffer_.begin()),edgeValues_[edgeOffset_[e]+index]);
+                        }
+                    }
+                }
+                else{
+                    // table with the first free variable running fastest
+                    highOrderVis_.push_back(notFixedVars);
+                    size_t size=1;
+                    for(IndexType v=0;v<notFixedVars;++v){
+                        const IndexType viLocal = globalToLocalVariables_[factor.variableIndex(notFixedVarPosBuffer_[v])];
+                        highOrderVis_.push_back(viLocal);
+                        size*=submodelSpace_[viLocal];
+                        factorLabelBuffer_[notFixedVarPosBuffer_[v]]=0;
+                    }
+                    for(size_t i=0;i<size;++i){
+                        highOrderValues_.push_back(factor(factorLabelBuffer_.begin()));
+                        for(IndexType v=0;v<notFixedVars;++v){
+                            const IndexType pos = notFixedVarPosBuffer_[v];
+                            if(++factorLabelBuffer_[pos]<factor.numberOfLabels(pos)){
+                                break;
+                            }
+                            factorLabelBuffer_[pos]=0;
+                        }
+                    }
+                    highOrderOffset_.push_back(highOrderValues_.size());
+                }
+            }
+        }
+
+        // CLEANUP
+        // - clean all used factors
+        for(IndexType localVi=0;localVi<nLocalVar_;++localVi){
+            const IndexType globalVi = localVariables_[localVi];
+            const IndexType nFac = gm_.numberOfFactors(globalVi);
+            for(IndexType f=0;f<nFac;++f){
+                handledFactor_[gm_.factorOfVariable(globalVi,f)]=false;
+            }
+        }
+    }
+
     // build model inplace for a given solver
     void reserveGraphicalModel(SubGmType & subGm){
         OPENGM_CHECK_OP(nLocalVar_,!=,0,"");
@@ -684,6 +963,83 @@ private:
     // global labels
     std::vector<LabelType> labels_;
 
+    // conditioned submodel, indexed by local variables
+    std::vector<size_t>    unaryOffset_;
+    std::vector<ValueType> unaryValues_;
+    std::vector<IndexType> edgeVis_;
+    std::vector<size_t>    edgeOffset_;
+    std::vector<ValueType> edgeValues_;
+    std::vector<std::vector<std::pair<IndexType,IndexType> > > localAdjacency_;
+    std::vector<size_t>    highOrderOffset_;
+    std::vector<IndexType> highOrderVis_;
+    std::vector<ValueType> highOrderValues_;
+    std::vector<LabelType> factorLabelBuffer_;
+    std::vector<LabelType> currentLabelBuffer_;
+
+    // tree order of the conditioned submodel
+    std::vector<IndexType>     treeOrder_;
+    std::vector<IndexType>     treeParent_;
+    std::vector<IndexType>     treeParentEdge_;
+    std::vector<unsigned char> treeVisited_;
+
+    // edge between local variables vi0 < vi1, a new edge has a neutral table
+    IndexType findOrAddEdge(const IndexType vi0,const IndexType vi1){
+        std::vector<std::pair<IndexType,IndexType> > & adjacency = localAdjacency_[vi0];
+        for(size_t n=0;n<adjacency.size();++n){
+            if(adjacency[n].first==vi1){
+                return adjacency[n].second;
+            }
+        }
+        const IndexType e = static_cast<IndexType>(edgeOffset_.size());
+        edgeVis_.push_back(vi0);
+        edgeVis_.push_back(vi1);
+        edgeOffset_.push_back(edgeValues_.size());
+        edgeValues_.resize(edgeValues_.size()+submodelSpace_[vi0]*submodelSpace_[vi1]);
+        for(size_t i=edgeOffset_[e];i<edgeValues_.size();++i){
+            OperatorType::neutral(edgeValues_[i]);
+        }
+        adjacency.push_back(std::make_pair(vi1,e));
+        localAdjacency_[vi1].push_back(std::make_pair(vi0,e));
+        return e;
+    }
+
+    // breadth first order of the edges of the conditioned submodel,
+    // returns false if the edges contain a cycle
+    bool orderTree(){
+        treeOrder_.resize(nLocalVar_);
+        treeParent_.resize(nLocalVar_);
+        treeParentEdge_.resize(nLocalVar_);
+        treeVisited_.assign(nLocalVar_,0);
+        IndexType end=0;
+        for(IndexType root=0;root<nLocalVar_;++root){
+            if(treeVisited_[root]){
+                continue;
+            }
+            treeVisited_[root]=1;
+            treeParent_[root]=root;
+            IndexType begin=end;
+            treeOrder_[end++]=root;
+            while(begin<end){
+                const IndexType viLocal=treeOrder_[begin++];
+                for(size_t n=0;n<localAdjacency_[viLocal].size();++n){
+                    const IndexType other=localAdjacency_[viLocal][n].first;
+                    const IndexType e=localAdjacency_[viLocal][n].second;
+                    if(treeParent_[viLocal]!=viLocal && e==treeParentEdge_[viLocal]){
+                        continue;
+                    }
+                    if(treeVisited_[other]){
+                        return false;
+                    }
+                    treeVisited_[other]=1;
+                    treeParent_[other]=viLocal;
+                    treeParentEdge_[other]=e;
+                    treeOrder_[end++]=other;
+                }
+            }
+        }
+        return true;
+    }
+
 
 
 };
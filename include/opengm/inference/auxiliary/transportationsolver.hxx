@@ -13,7 +13,7 @@
 #include <iomanip>
 #include <cassert>
 #include <cmath>
-#include <list>
+#include <vector>
 #include <limits>
 
 //#define TRWS_DEBUG_OUTPUT
@@ -31,100 +31,93 @@ using OUT::operator <<;
 
 /* List 2D class and implementation ==================================================== */
 
+/*
+ * Sparse 2D matrix, whose non-zero elements are linked in row and column lists.
+ * Elements as well as list headers are stored in contiguous arrays and are linked by indexes,
+ * therefore copying and resizing reuse the allocated memory.
+ */
 template<class T>
 class List2D
 {
 public:
 
-	struct bufferElement;
-
-	struct listElement
+	struct bufferElement
 	{
-		listElement(size_t coordinate,bufferElement* pbufElement):
-			_coordinate(coordinate), _pbufElement(pbufElement)
-		{};
-
-		size_t _coordinate;
-		bufferElement* _pbufElement;
+		T _value;
+		size_t _x, _y;
+		size_t _rowPrev, _rowNext;
+		size_t _colPrev, _colNext;
 	};
 
-	typedef std::list<listElement> List1D;
+	struct listHeader
+	{
+		size_t _first, _last, _size;
+	};
 
-	template<class Parent,class typeT>
-		class iterator_template : public Parent
+	template<class Owner,class typeT>
+		class iterator_template
 		{
 			public:
-			iterator_template(Parent it,const bufferElement* pbuffer0):Parent(it),_pbuffer0(pbuffer0){};
-			typeT& operator * ()const{return this->Parent::operator *()._pbufElement->_value;}
+			iterator_template():_plist(0),_index(0),_line(0),_isRow(true){};
+			iterator_template(Owner* plist,size_t index,size_t line,bool isRow):_plist(plist),_index(index),_line(line),_isRow(isRow){};
+			template<class OtherOwner,class otherT>
+			iterator_template(const iterator_template<OtherOwner,otherT>& other):_plist(other._plist),_index(other._index),_line(other._line),_isRow(other._isRow){};
 
-			size_t index()const
-			{
-				return (this->Parent::operator *()._pbufElement)-_pbuffer0;
-			}
+			typeT& operator * ()const{return _plist->_buffer[_index]._value;}
 
-			size_t coordinate()const{return this->Parent::operator *()._coordinate;}
-			size_t x()const{return (*this->Parent::operator *()._pbufElement->_rowIterator)._coordinate;}
-			size_t y()const{return (*this->Parent::operator *()._pbufElement->_colIterator)._coordinate;}
+			size_t index()const{return _index;}
 
-			bool isRowIterator()const{return &(*(this->Parent::operator *()._pbufElement->_rowIterator)) == &(*Parent(*this));}
+			size_t coordinate()const{return (_isRow ? x() : y());}
+			size_t x()const{return _plist->_buffer[_index]._x;}
+			size_t y()const{return _plist->_buffer[_index]._y;}
+
+			bool isRowIterator()const{return _isRow;}
 
 			iterator_template changeDir()const{
-			    if (isRowIterator())
-					return iterator_template(this->Parent::operator *()._pbufElement->_colIterator,_pbuffer0);
+			    if (_isRow)
+					return iterator_template(_plist,_index,x(),false);
 				else
-					return iterator_template(this->Parent::operator *()._pbufElement->_rowIterator,_pbuffer0);
+					return iterator_template(_plist,_index,y(),true);
 			}
 
 			iterator_template operator ++ (int){iterator_template it=*this; ++(*this); return it;}
-			iterator_template& operator ++ (){Parent::operator ++(); return *this;}
-			iterator_template& operator -- (){Parent::operator --(); return *this;}
-			private:
-			const bufferElement* _pbuffer0;
-		};
-
-		typedef iterator_template<typename List1D::iterator,T> iterator;
-		typedef iterator_template<typename List1D::const_iterator,const T> const_iterator;
+			iterator_template& operator ++ (){
+				const bufferElement& el=_plist->_buffer[_index];
+				_index=(_isRow ? el._rowNext : el._colNext);
+				return *this;
+			}
+			iterator_template& operator -- (){
+				if (_index==List2D::_nil())
+					_index=(_isRow ? _plist->_rows[_line]._last : _plist->_cols[_line]._last);
+				else
+				{
+					const bufferElement& el=_plist->_buffer[_index];
+					_index=(_isRow ? el._rowPrev : el._colPrev);
+				}
+				return *this;
+			}
 
-	typedef std::vector<List1D> List1DSeq;
+			template<class OtherOwner,class otherT>
+			bool operator == (const iterator_template<OtherOwner,otherT>& other)const
+			{return (_index==other._index) && (_line==other._line) && (_isRow==other._isRow);}
+			template<class OtherOwner,class otherT>
+			bool operator != (const iterator_template<OtherOwner,otherT>& other)const{return !(*this==other);}
 
-	struct bufferElement
-	{
-		bufferElement(const T& val,typename List1D::iterator rowIterator,typename List1D::iterator colIterator)
-		    :_value(val) {
-		    if (_value != NaN()) {
-			_rowIterator = rowIterator;
-			_colIterator = colIterator;
-		    }
+			private:
+			template<class,class> friend class iterator_template;
+			Owner* _plist;
+			size_t _index;
+			size_t _line;//y for row iterators, x for column iterators
+			bool _isRow;
 		};
 
-		bufferElement(const bufferElement &other)
-		: _value(other._value)
-		{
-		 if (_value != NaN()) {
-			 _rowIterator = other._rowIterator;
-			 _colIterator = other._colIterator;
-		 }
-		}
-
-		bufferElement & operator=(const bufferElement &other) {
-			_value = other._value;
-			 if (_value != NaN()) {
-				 _rowIterator = other._rowIterator;
-				 _colIterator = other._colIterator;
-			 }
-			 return *this;
-		}
-
-		T _value;
-		typename List1D::iterator _rowIterator;
-		typename List1D::iterator _colIterator;
-	};
+		typedef iterator_template<List2D,T> iterator;
+		typedef iterator_template<const List2D,const T> const_iterator;
 
 	typedef std::vector<bufferElement> Buffer;
+	typedef std::vector<listHeader> HeaderSeq;
 
 	List2D(size_t xsize, size_t ysize, size_t nnz);
-	List2D(const List2D&);
-	List2D& operator = (const List2D&);
 
 	void clear();
 	/*
@@ -146,32 +139,32 @@ public:
 	 * returns <false>
 	 */
 	bool insert(size_t x, size_t y, const T& val);
-	void erase(iterator it);
+	void erase(iterator it){erase(it.index());}
 	/*
 	 * index - index in the _buffer array
 	 */
-	void erase(size_t index){erase(iterator(_buffer[index]._rowIterator,&_buffer[0]));}
+	void erase(size_t index);
 
 	void rowErase(size_t y);
 	void colErase(size_t x);
 
-	size_t rowSize(size_t y)const{return _rowLists[y].size();};
-	size_t xsize()const{return _colLists.size();}
-	size_t colSize(size_t x)const{return _colLists[x].size();};
-	size_t ysize()const{return _rowLists.size();}
+	size_t rowSize(size_t y)const{return _rows[y]._size;};
+	size_t xsize()const{return _cols.size();}
+	size_t colSize(size_t x)const{return _cols[x]._size;};
+	size_t ysize()const{return _rows.size();}
 	size_t nnz()const{return _buffer.size();}
 
-	iterator rowBegin(size_t y){return iterator(_rowLists[y].begin(),&_buffer[0]);}
-	const_iterator rowBegin(size_t y)const{return const_iterator(_rowLists[y].begin(),&_buffer[0]);}
+	iterator rowBegin(size_t y){return iterator(this,_rows[y]._first,y,true);}
+	const_iterator rowBegin(size_t y)const{return const_iterator(this,_rows[y]._first,y,true);}
 
-	iterator rowEnd(size_t y){return iterator(_rowLists[y].end(),&_buffer[0]);}
-	const_iterator rowEnd(size_t y)const{return const_iterator(_rowLists[y].end(),&_buffer[0]);}
+	iterator rowEnd(size_t y){return iterator(this,_nil(),y,true);}
+	const_iterator rowEnd(size_t y)const{return const_iterator(this,_nil(),y,true);}
 
-	iterator colBegin(size_t x){return iterator(_colLists[x].begin(),&_buffer[0]);}
-	const_iterator colBegin(size_t x)const{return const_iterator(_colLists[x].begin(),&_buffer[0]);}
+	iterator colBegin(size_t x){return iterator(this,_cols[x]._first,x,false);}
+	const_iterator colBegin(size_t x)const{return const_iterator(this,_cols[x]._first,x,false);}
 
-	iterator colEnd(size_t x){return iterator(_colLists[x].end(),&_buffer[0]);}
-	const_iterator colEnd(size_t x)const{return const_iterator(_colLists[x].end(),&_buffer[0]);}
+	iterator colEnd(size_t x){return iterator(this,_nil(),x,false);}
+	const_iterator colEnd(size_t x)const{return const_iterator(this,_nil(),x,false);}
 
 	//iterator switchDirection(iterator it)const;
 	template<class BinaryTable1D>
@@ -194,14 +187,23 @@ public:
 #endif
 private:
 	bool _insert(size_t x, size_t y, const T& val, size_t position);
-	void _copy(const List2D<T>& lst);
 	static T NaN(){return std::numeric_limits<T>::max();}
+	static size_t _nil(){return std::numeric_limits<size_t>::max();}
+	static listHeader _emptyHeader(){listHeader h; h._first=h._last=_nil(); h._size=0; return h;}
+	static bufferElement _emptyElement()
+	{
+		bufferElement el;
+		el._value=NaN();
+		el._x=el._y=_nil();
+		el._rowPrev=el._rowNext=el._colPrev=el._colNext=_nil();
+		return el;
+	}
 
 	//size_t _nnz;
 	size_t _insertPosition;
 	size_t _pushPosition;
-	List1DSeq _rowLists;
-	List1DSeq _colLists;
+	HeaderSeq _rows;
+	HeaderSeq _cols;
 	Buffer _buffer;
 };
 
@@ -209,75 +211,21 @@ template<class T>
 List2D<T>::List2D(size_t xsize, size_t ysize, size_t nnz):
 _insertPosition(nnz-1),
 _pushPosition(0),
-_rowLists(ysize),
-_colLists(xsize),
-_buffer(nnz,bufferElement(NaN(),typename List1D::iterator(),typename List1D::iterator()))
+_rows(ysize,_emptyHeader()),
+_cols(xsize,_emptyHeader()),
+_buffer(nnz,_emptyElement())
 {};
 
-template<class T>
-List2D<T>::List2D(const List2D& lst)
-{
-	_copy(lst);
-}
-
 template<class T>
 void List2D<T>::resize(size_t xsize, size_t ysize, size_t nnz)
 {
-	_rowLists.assign(ysize,List1D());
-	_colLists.assign(xsize,List1D());
-	_buffer.assign(nnz,bufferElement(NaN(),typename List1D::iterator(),typename List1D::iterator()));
+	_rows.assign(ysize,_emptyHeader());
+	_cols.assign(xsize,_emptyHeader());
+	_buffer.assign(nnz,_emptyElement());
 	_insertPosition=nnz-1;
 	_pushPosition=0;
 };
 
-
-template<class T>
-void List2D<T>::_copy(const List2D<T>& lst)
-{
-	_buffer=lst._buffer;
-
-	_rowLists=lst._rowLists;
-	typename List1DSeq::iterator itbeg=_rowLists.begin(), itend=_rowLists.end();
-	for (;itbeg!=itend;++itbeg)
-	{
-		typename List1D::iterator beg=(*itbeg).begin(),end=(*itbeg).end();
-		for (;beg!=end;++beg)
-		{
-			size_t offset=(*beg)._pbufElement-&(lst._buffer[0]);
-			(*beg)._pbufElement= &_buffer[offset];
-			(*beg)._pbufElement->_rowIterator=beg;
-		}
-	}
-
-	_colLists=lst._colLists;
-	itbeg=_colLists.begin(), itend=_colLists.end();
-	for (;itbeg!=itend;++itbeg)
-	{
-		typename List1D::iterator beg=(*itbeg).begin(),end=(*itbeg).end();
-		for (;beg!=end;++beg)
-		{
-			size_t offset=(*beg)._pbufElement-&(lst._buffer[0]);
-			(*beg)._pbufElement= &_buffer[offset];
-			(*beg)._pbufElement->_colIterator=beg;
-		}
-	}
-
-	//_nnz=lst._nnz;
-	_insertPosition=lst._insertPosition;
-	_pushPosition=lst._pushPosition;
-};
-
-template<class T>
-List2D<T>& List2D<T>::operator = (const List2D<T>& lst)
-{
-	if (this==&lst)
-		return *this;
-
-	_copy(lst);
-
-	return *this;
-}
-
 template<class T>
 bool List2D<T>::insert(size_t x,size_t y,const T& val)
 {
@@ -305,81 +253,83 @@ bool List2D<T>::push(size_t x, size_t y, const T& val)
 	return false;
 }
 
-template<class E>
-class coordLess
-{
-public:
- coordLess(size_t x):_x(x){}
- bool operator () (const E& e) const{return e._coordinate < _x;}
-private:
- size_t _x;
-};
-
-template<class E>
-class coordMore
-{
-public:
- coordMore(size_t x):_x(x){}
- bool operator () (const E& e) const{return e._coordinate > _x;}
-private:
- size_t _x;
-};
-
 template<class T>
 bool List2D<T>::_insert(size_t x, size_t y, const T& val, size_t position)
 {
-	assert(x<_colLists.size());
-	assert(y< _rowLists.size());
+	assert(x<_cols.size());
+	assert(y<_rows.size());
 
 	if (position >= _buffer.size())
 		return false;
 
 	bufferElement& buf=_buffer[position];
 	buf._value=val;
-
-	List1D& rowList=_rowLists[y];
-	List1D& colList=_colLists[x];
-
-	typename List1D::iterator insertPosition=std::find_if(rowList.begin(),rowList.end(),coordMore<listElement>(x));
-	buf._rowIterator=rowList.insert(insertPosition,listElement(x,&buf));
-	insertPosition=std::find_if(colList.begin(),colList.end(),coordMore<listElement>(y));
-	buf._colIterator=colList.insert(insertPosition,listElement(y,&buf));
+	buf._x=x;
+	buf._y=y;
+
+	//lists are sorted by coordinates, the new element is placed in front of the first one with a larger coordinate
+	listHeader& row=_rows[y];
+	size_t next=row._first;
+	while ((next!=_nil()) && (_buffer[next]._x <= x))
+		next=_buffer[next]._rowNext;
+	buf._rowNext=next;
+	buf._rowPrev=(next==_nil() ? row._last : _buffer[next]._rowPrev);
+	if (buf._rowPrev==_nil()) row._first=position; else _buffer[buf._rowPrev]._rowNext=position;
+	if (next==_nil()) row._last=position; else _buffer[next]._rowPrev=position;
+	++row._size;
+
+	listHeader& col=_cols[x];
+	next=col._first;
+	while ((next!=_nil()) && (_buffer[next]._y <= y))
+		next=_buffer[next]._colNext;
+	buf._colNext=next;
+	buf._colPrev=(next==_nil() ? col._last : _buffer[next]._colPrev);
+	if (buf._colPrev==_nil()) col._first=position; else _buffer[buf._colPrev]._colNext=position;
+	if (next==_nil()) col._last=position; else _buffer[next]._colPrev=position;
+	++col._size;
 
 	return true;
 };
 
 template<class T>
-void List2D<T>::erase(iterator it)
+void List2D<T>::erase(size_t index)
 {
- _insertPosition=it.index();
- size_t x=it.x(), y=it.y();
- _rowLists[y].erase(_buffer[_insertPosition]._rowIterator);
- _colLists[x].erase(_buffer[_insertPosition]._colIterator);
- _buffer[_insertPosition]._value=NaN();
+ _insertPosition=index;
+ bufferElement& buf=_buffer[index];
+
+ listHeader& row=_rows[buf._y];
+ if (buf._rowPrev==_nil()) row._first=buf._rowNext; else _buffer[buf._rowPrev]._rowNext=buf._rowNext;
+ if (buf._rowNext==_nil()) row._last=buf._rowPrev; else _buffer[buf._rowNext]._rowPrev=buf._rowPrev;
+ --row._size;
+
+ listHeader& col=_cols[buf._x];
+ if (buf._colPrev==_nil()) col._first=buf._colNext; else _buffer[buf._colPrev]._colNext=buf._colNext;
+ if (buf._colNext==_nil()) col._last=buf._colPrev; else _buffer[buf._colNext]._colPrev=buf._colPrev;
+ --col._size;
+
+ buf=_emptyElement();
 };
 
 template<class T>
 void List2D<T>::rowErase(size_t y)
 {
-	while (!_rowLists[y].empty())
-		erase(iterator(_rowLists[y].begin(),&_buffer[0]));
+	while (_rows[y]._first!=_nil())
+		erase(_rows[y]._first);
 };
 
 template<class T>
 void List2D<T>::colErase(size_t x)
 {
-	while (!_colLists[x].empty())
-		erase(iterator(_colLists[x].begin(),&_buffer[0]));
+	while (_cols[x]._first!=_nil())
+		erase(_cols[x]._first);
 };
 
 template<class T>
 void List2D<T>::clear()
 {
-	for (size_t x=0;x<_rowLists.size();++x)
-		rowErase(x);
-
-	for (size_t y=0;y<_colLists.size();++y)
-		colErase(y);
+	_rows.assign(_rows.size(),_emptyHeader());
+	_cols.assign(_cols.size(),_emptyHeader());
+	_buffer.assign(_buffer.size(),_emptyElement());
 
 	_pushPosition=0;
 	_insertPosition=_buffer.size()-1;
@@ -390,11 +340,11 @@ template<class BinaryTable1D>
 T List2D<T>::inner_product1D(const BinaryTable1D& bin)const
 {
 	T sum=0;
-	for (size_t i=0; i<_colLists.size();++i)
+	for (size_t i=0; i<xsize();++i)
 	{
-		typename List1D::const_iterator beg=_colLists[i].begin(), end=_colLists[i].end();
+		const_iterator beg=colBegin(i), end=colEnd(i);
 		for (;beg!=end;++beg)
-			sum+=(*beg)._pbufElement->_value * bin[xsize()*((*beg)._coordinate)+i];
+			sum+=(*beg) * bin[xsize()*beg.y()+i];
 	};
 	return sum;
 };
@@ -429,10 +379,10 @@ T List2D<T>::inner_product2D(const BinaryTable2D& bin, T* pprecision)const //DEB
 template<class T>
 std::pair<bool,T> List2D<T>::getValue(size_t x,size_t y)const
 {
- typename List1D::const_iterator beg=_colLists[x].begin(), end=_colLists[x].end();
+ const_iterator beg=colBegin(x), end=colEnd(x);
  for (;beg!=end;++beg)
-	if ((*beg)._coordinate==y)
-		return std::make_pair(true,(*beg)._pbufElement->_value);
+	if (beg.y()==y)
+		return std::make_pair(true,*beg);
 
   return std::make_pair(false,(T)0);
 };
@@ -444,40 +394,33 @@ void List2D<T>::PrintTestData(std::ostream& fout)const
 	fout << "_nnz=" <<_buffer.size()<<std::endl;
 	fout << "_insertPosition=" << _insertPosition<<std::endl;
 	fout << "_pushPosition=" << _pushPosition<<std::endl;
-	fout << "xsize="<<_colLists.size()<<std::endl;
-	fout << "ysize="<<_rowLists.size()<<std::endl;
-
-	std::vector<T> printBuffer(_buffer.size(),NaN());
+	fout << "xsize="<<_cols.size()<<std::endl;
+	fout << "ysize="<<_rows.size()<<std::endl;
 
 	fout << "row Lists: "<<std::endl;
-	for (size_t i=0; i< _rowLists.size();++i)
+	for (size_t i=0; i< _rows.size();++i)
 	{
 		fout << "y="<<i<<": ";
-		typename List1D::const_iterator beg=_rowLists[i].begin(), end=_rowLists[i].end();
+		const_iterator beg=rowBegin(i), end=rowEnd(i);
 		for (;beg!=end;++beg)
-		{
-			fout <<"("<<(*beg)._coordinate<<","<<(*beg)._pbufElement->_value<<")";
-			printBuffer[(*beg)._pbufElement-&_buffer[0]]=(*beg)._pbufElement->_value;
-		}
+			fout <<"("<<beg.coordinate()<<","<<*beg<<")";
 		fout <<std::endl;
 	}
 
 	fout << "column Lists: "<<std::endl;
-	for (size_t i=0; i< _colLists.size();++i)
+	for (size_t i=0; i< _cols.size();++i)
 	{
 		fout << "x="<<i<<": ";
-		typename List1D::const_iterator beg=_colLists[i].begin(), end=_colLists[i].end();
+		const_iterator beg=colBegin(i), end=colEnd(i);
 		for (;beg!=end;++beg)
-		{
-			fout <<"("<<(*beg)._coordinate<<","<<(*beg)._pbufElement->_value<<")";
-		}
+			fout <<"("<<beg.coordinate()<<","<<*beg<<")";
 		fout <<std::endl;
 	}
 
 	fout << "buffer: ";
-	for (size_t i=0;i<printBuffer.size();++i)
-		if (printBuffer[i]!=NaN())
-		 fout << "("<<_buffer[i]._value<<","<<(*_buffer[i]._rowIterator)._coordinate <<","<< (*_buffer[i]._colIterator)._coordinate<<")";
+	for (size_t i=0;i<_buffer.size();++i)
+		if (_buffer[i]._value!=NaN())
+		 fout << "("<<_buffer[i]._value<<","<<_buffer[i]._x <<","<< _buffer[i]._y<<")";
 		else
 			fout << "(nan,nan,nan)";
 	fout << std::endl;
@@ -616,11 +559,11 @@ public:
 	typedef typename DenseMatrix::ValueType floatType;
 	typedef enum{X, Y} Direction;
 	typedef std::pair<size_t,Direction> CoordDir;
-	typedef std::queue<CoordDir> Queue;
+	typedef std::vector<CoordDir> Queue;
 	typedef List2D<floatType> FeasiblePoint;
 	typedef std::vector<floatType> UnaryDense;
 	typedef std::vector<size_t> IndexArray;
-	typedef std::list<typename FeasiblePoint::const_iterator> CycleList;
+	typedef std::vector<typename FeasiblePoint::const_iterator> CycleList;
 
 	static const floatType floatTypeEps;
 	static const size_t defaultMaxIterationNumber;
@@ -634,7 +577,7 @@ public:
 #ifdef	TRWS_DEBUG_OUTPUT
 		_fout(fout),
 #endif
-		_pbinInitial(0),_xsize(0),_ysize(0),_relativePrecision(relativePrecision),_basicSolution(0,0,0),_maxIterationNumber(maxIterationNumber)
+		_pbinInitial(0),_xsize(0),_ysize(0),_relativePrecision(relativePrecision),_basicSolution(0,0,0),_maxIterationNumber(maxIterationNumber),_workspace(0,0,0)
 	{
 		assert(relativePrecision >0);
 	};
@@ -647,7 +590,7 @@ public:
 #ifdef	TRWS_DEBUG_OUTPUT
 		_fout(fout),
 #endif
-	  _pbinInitial(&bin),_xsize(xsize),_ysize(ysize),_relativePrecision(relativePrecision),_basicSolution(xsize,ysize,_nnz(xsize,ysize)),_maxIterationNumber(maxIterationNumber)
+	  _pbinInitial(&bin),_xsize(xsize),_ysize(ysize),_relativePrecision(relativePrecision),_basicSolution(xsize,ysize,_nnz(xsize,ysize)),_maxIterationNumber(maxIterationNumber),_workspace(0,0,0)
 	{
 		assert(relativePrecision >0);
 		Init(xsize,ysize,bin);
@@ -705,6 +648,14 @@ private:
 	IndexArray _nonZeroXcoordinates;//_activeXbound;
 	IndexArray _nonZeroYcoordinates;//_activeYbound;
 	size_t _maxIterationNumber;
+
+	//workspace, reused by subsequent calls of Solve() to avoid memory allocations
+	FeasiblePoint _workspace;
+	UnaryDense _xarr, _yarr;
+	UnaryDense _xdual, _ydual;
+	UnaryDense _rowRest, _colRest;
+	Queue _queue;
+	CycleList _plusList, _minusList;
 };
 
 template<class OPTIMIZER,class DenseMatrix>
@@ -742,8 +693,10 @@ template<class OPTIMIZER,class DenseMatrix>
 void TransportationSolver<OPTIMIZER,DenseMatrix>::
 _InitBasicSolution(const UnaryDense& xarr,const UnaryDense& yarr)
 {
-	UnaryDense row=xarr;
-	UnaryDense col=yarr;
+	UnaryDense& row=_rowRest;
+	UnaryDense& col=_colRest;
+	row.assign(xarr.begin(),xarr.end());
+	col.assign(yarr.begin(),yarr.end());
 	//north-west corner basic solution
 	//_basicSolution.clear();
 	_basicSolution.resize(xarr.size(),yarr.size(),_nnz(xarr.size(),yarr.size()));
@@ -812,7 +765,8 @@ _BuildDuals(UnaryDense* pxdual,UnaryDense* pydual)
 	xdual.assign(_nonZeroXcoordinates.size(),0.0);
 	ydual.assign(_nonZeroYcoordinates.size(),0.0);
 
-	FeasiblePoint fpcopy(_basicSolution);
+	FeasiblePoint& fpcopy=_workspace;
+	fpcopy=_basicSolution;
 	CoordDir currNode=_findSingleNeighborNode(fpcopy);
 
 	if (currNode.first==MAXSIZE_T)
@@ -828,15 +782,16 @@ _BuildDuals(UnaryDense* pxdual,UnaryDense* pydual)
 		currNode.first=fpcopy.rowBegin(currNode.first).coordinate();
 	}
 
-	Queue qu;
-	qu.push(currNode);
+	Queue& qu=_queue;
+	qu.clear();
+	qu.push_back(currNode);
 
 	size_t counter=0;
-	do
+	for (size_t front=0;front<qu.size();++front)
 	{
-		if (qu.front().second==Y)
+		if (qu[front].second==Y)
 		{
-		 size_t y=qu.front().first;
+		 size_t y=qu[front].first;
 
 		 typename FeasiblePoint::iterator beg=fpcopy.rowBegin(y),
 										  end=fpcopy.rowEnd(y);
@@ -845,13 +800,13 @@ _BuildDuals(UnaryDense* pxdual,UnaryDense* pydual)
 			 size_t x=beg.coordinate();
 			 //xdual[x]=(*_pbin)(x,y)-ydual[y];
 			 xdual[x]=_matrix(x,y)-ydual[y];
-			 qu.push(std::make_pair(x,X));
+			 qu.push_back(std::make_pair(x,X));
 		 }
 		 fpcopy.rowErase(y);
 
 		}else
 		{
-			size_t x=qu.front().first;
+			size_t x=qu[front].first;
 
 			 typename FeasiblePoint::iterator beg=fpcopy.colBegin(x),
 											  end=fpcopy.colEnd(x);
@@ -860,16 +815,14 @@ _BuildDuals(UnaryDense* pxdual,UnaryDense* pydual)
 				 size_t y=beg.coordinate();
 				 //ydual[y]=(*_pbin)(x,y)-xdual[x];
 				 ydual[y]=_matrix(x,y)-xdual[x];
-				 qu.push(std::make_pair(y,Y));
+				 qu.push_back(std::make_pair(y,Y));
 			 }
 
 			 fpcopy.colErase(x);
 		}
 
-		qu.pop();
-
 	_checkCounter(&counter, "_BuildDuals-infinite loop!\n");
-	}while (!qu.empty());
+	}
 
 };
 
@@ -954,9 +907,10 @@ _ChangeSolution(const FeasiblePoint& fp,const std::pair<size_t,size_t>& move)
 		break;
 	}
 
-	CycleList plusList, minusList;
-	CycleList* pplus=&plusList, *pPlusList=0;
-	CycleList* pminus=&minusList, *pMinusList=0;
+	_plusList.clear();
+	_minusList.clear();
+	CycleList* pplus=&_plusList, *pPlusList=0;
+	CycleList* pminus=&_minusList, *pMinusList=0;
 
 	//going along the cycle to assign +/- to vertices correctly
 	typename FeasiblePoint::const_iterator it=fp.rowBegin(y);
@@ -1012,7 +966,8 @@ _MovePotentials(const std::pair<size_t,size_t>& move)
 {
 	floatType ObjVal=GetObjectiveValue();
 	floatType primalValueNumericalPrecisionOld=_primalValueNumericalPrecision;
-	FeasiblePoint fp=_basicSolution;
+	FeasiblePoint& fp=_workspace;
+	fp=_basicSolution;
 
 	_FindCycle(&fp,move);
 
@@ -1044,10 +999,9 @@ _isOptimal(std::pair<size_t,size_t>* pmove)
 {
 	//checks current basic solution for optimality
 	//1. build duals
-	UnaryDense xduals,yduals;
-	_BuildDuals(&xduals,&yduals);
+	_BuildDuals(&_xdual,&_ydual);
 	//2. check whether they satisfy dual constraints
-	return _CheckDualConstraints(xduals,yduals,pmove);
+	return _CheckDualConstraints(_xdual,_ydual,pmove);
 };
 
 template<class OPTIMIZER,class DenseMatrix>
@@ -1104,7 +1058,8 @@ typename TransportationSolver<OPTIMIZER,DenseMatrix>::floatType TransportationSo
 Solve(Iterator xbegin,Iterator ybegin)
 {
 	_recalculated=false;
-	UnaryDense xarr,yarr;
+	UnaryDense& xarr=_xarr;
+	UnaryDense& yarr=_yarr;
 
 	_FilterBound(xbegin,_xsize,xarr,&_nonZeroXcoordinates,_relativePrecision*_xsize*_ysize);
 	_FilterBound(ybegin,_ysize,yarr,&_nonZeroYcoordinates,_relativePrecision*_xsize*_ysize);
@@ -1149,11 +1104,12 @@ typename TransportationSolver<OPTIMIZER,DenseMatrix>::floatType TransportationSo
 	 for (size_t x=0;x<_xsize;++x)
 		 (*pbin)(x,y)=0.0;
 
-	MatrixWrapper<floatType> matrix(_basicSolution.xsize(),_basicSolution.ysize());
-	_basicSolution.get2DTable(&matrix);
-	for (size_t y=0;y<matrix.ysize();++y)
-	 for (size_t x=0;x<matrix.xsize();++x)
-		 (*pbin)(_nonZeroXcoordinates[x],_nonZeroYcoordinates[y])=matrix(x,y);
+	for (size_t x=0;x<_basicSolution.xsize();++x)
+	{
+		typename FeasiblePoint::const_iterator beg=_basicSolution.colBegin(x), end=_basicSolution.colEnd(x);
+		for (;beg!=end;++beg)
+		 (*pbin)(_nonZeroXcoordinates[beg.x()],_nonZeroYcoordinates[beg.y()])=*beg;
+	}
 
 	return GetObjectiveValue();
 };
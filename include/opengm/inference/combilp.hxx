@@ -12,6 +12,9 @@
 #include <opengm/inference/auxiliary/lp_reparametrization.hxx>
 #include <opengm/inference/trws/output_debug_utils.hxx>
 #include <opengm/inference/trws/trws_base.hxx>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace opengm{
 
@@ -172,7 +175,7 @@ namespace opengm{
          void ReparametrizeAndSave();
       private:
          void _Reparametrize(typename ReparametrizerType::ReparametrizedGMType* pgm,const MaskType& mask);
-         InferenceTermination _PerformILPInference(GMManipulatorType& modelManipulator,std::vector<LabelType>* plabeling);
+         InferenceTermination _PerformILPInference(GMManipulatorType& modelManipulator,const std::vector<LabelType>& previousLabeling,std::vector<LabelType>* plabeling);
          Parameter _parameter;
          ReparametrizerType& _lpparametrizer;
          std::vector<LabelType> _labeling;
@@ -200,33 +203,88 @@ namespace opengm{
       {
       };
 
+      /*
+       * The connected components of the submodel are independent ILPs and are solved concurrently (with WITH_OPENMP).
+       * If the labeling of the previous ILP cycle is given, components whose submodels were kept by the incremental
+       * manipulator take over their previous optimal labeling, the other ones are warm started with it.
+       */
       template<class GM, class ACC, class LPREPARAMETRIZER>
-      InferenceTermination CombiLP_base<GM,ACC,LPREPARAMETRIZER>::_PerformILPInference(GMManipulatorType& modelManipulator,std::vector<LabelType>* plabeling)
+      InferenceTermination CombiLP_base<GM,ACC,LPREPARAMETRIZER>::_PerformILPInference(GMManipulatorType& modelManipulator,const std::vector<LabelType>& previousLabeling,std::vector<LabelType>* plabeling)
       {
-         InferenceTermination terminationILP=NORMAL;
-         modelManipulator.buildModifiedSubModels();
+         modelManipulator.buildModifiedSubModels(_parameter.threads_);
 
+         const bool hasPrevious=!previousLabeling.empty();
          std::vector<std::vector<LabelType> > submodelLabelings(modelManipulator.numberOfSubmodels());
+         if (hasPrevious)
+            modelManipulator.originalState2ModifiedSubStates(previousLabeling,submodelLabelings);
+
+         std::vector<size_t> pending;
          for (size_t modelIndex=0;modelIndex<modelManipulator.numberOfSubmodels();++modelIndex)
+            if (!hasPrevious || modelManipulator.isRebuiltSubmodel(modelIndex))
+               pending.push_back(modelIndex);
+
+#ifdef TRWS_DEBUG_OUTPUT
+         _fout << "Solving "<<pending.size()<<" of "<<modelManipulator.numberOfSubmodels()<<" ILP components."<<std::endl;
+#endif
+
+         InferenceTermination terminationILP=NORMAL;
+         const std::ptrdiff_t numberOfPending=static_cast<std::ptrdiff_t>(pending.size());
+#ifdef WITH_OPENMP
+         const int nThreads = _parameter.threads_>0 ? static_cast<int>(_parameter.threads_) : omp_get_max_threads();
+         // several components share the threads, a single one gets all of them inside CPLEX
+         const int ilpThreads = numberOfPending>1 ? 1 : static_cast<int>(_parameter.threads_);
+         bool failed=false;
+         std::string errorMessage;
+         #pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+#else
+         const int ilpThreads = static_cast<int>(_parameter.threads_);
+#endif
+         for (std::ptrdiff_t n=0;n<numberOfPending;++n)
          {
+            const size_t modelIndex=pending[n];
+#ifdef WITH_OPENMP
+            try
+            {
+#endif
             const typename GMManipulatorType::MGM& model=modelManipulator.getModifiedSubModel(modelIndex);
-            submodelLabelings[modelIndex].resize(model.numberOfVariables());
             typename LPCPLEX::Parameter param;
             param.integerConstraint_=true;
-            param.numberOfThreads_= _parameter.threads_;
+            param.numberOfThreads_= ilpThreads;
             param.timeLimit_ = 3600;                       // TODO: Make this a parameter (1h)
             param.workMem_= 1024*6;                        // TODO: Make this a parameter (6GB)
             LPCPLEX ilpSolver(model,param);
-            terminationILP=ilpSolver.infer();
+            if (hasPrevious)
+               ilpSolver.setStartingPoint(submodelLabelings[modelIndex].begin());
+            const InferenceTermination termination=ilpSolver.infer();
 
-            if ((terminationILP!=NORMAL) && (terminationILP!=CONVERGENCE)){
-               return terminationILP;
+            if ((termination!=NORMAL) && (termination!=CONVERGENCE)){
+#ifdef WITH_OPENMP
+               #pragma omp critical(combilp_ilp_termination)
+#endif
+               terminationILP=termination;
                //std::cout << "WARNING: solving ILP failed!"<<std::endl;
-               //return NORMAL;
             }
             else
                ilpSolver.arg(submodelLabelings[modelIndex]);
+#ifdef WITH_OPENMP
+            }
+            catch (const std::exception& e)
+            {
+               #pragma omp critical(combilp_ilp_error)
+               {
+                  failed=true;
+                  errorMessage=e.what();
+               }
+            }
+#endif
          }
+#ifdef WITH_OPENMP
+         if (failed)
+            throw std::runtime_error(errorMessage);
+#endif
+
+         if ((terminationILP!=NORMAL) && (terminationILP!=CONVERGENCE))
+            return terminationILP;
 
          modelManipulator.modifiedSubStates2OriginalState(submodelLabelings,*plabeling);
          return terminationILP;
@@ -250,6 +308,21 @@ namespace opengm{
          bool reparametrizedFlag=false;
          InferenceTermination terminationId=TIMEOUT;
 
+         // with a single reparametrization the model stays the same for all ILP
+         // runs and the submodels of components untouched by the growing mask are kept
+         if (_parameter.singleReparametrization_)
+         {
+#ifdef TRWS_DEBUG_OUTPUT
+            _fout << "Reparametrizing..."<<std::endl;
+#endif
+            _Reparametrize(&gm,MaskType(mask.size(),true));
+            reparametrizedFlag=true;
+         }
+         GMManipulatorType incrementalManipulator(gm,GMManipulatorType::DROP);
+         incrementalManipulator.setIncrementalUpdates(true);
+         // labeling of the previous ILP cycle, reused for kept components and as MIP start
+         std::vector<LabelType> labeling;
+
          for (size_t i=0;(startILP && (i<_parameter.maxNumberOfILPCycles_));++i)
          {
 
@@ -272,15 +345,7 @@ namespace opengm{
             }
 #endif
 
-            if (_parameter.singleReparametrization_ && (!reparametrizedFlag) )
-            {
-#ifdef TRWS_DEBUG_OUTPUT
-               _fout << "Reparametrizing..."<<std::endl;
-#endif
-               _Reparametrize(&gm,MaskType(mask.size(),true));
-               reparametrizedFlag=true;
-            }
-            else if (!_parameter.singleReparametrization_)
+            if (!_parameter.singleReparametrization_)
             {
 #ifdef TRWS_DEBUG_OUTPUT
                _fout << "Reparametrizing..."<<std::endl;
@@ -290,7 +355,8 @@ namespace opengm{
 
             OPENGM_ASSERT(mask.size()==gm.numberOfVariables());
 
-            GMManipulatorType modelManipulator(gm,GMManipulatorType::DROP);
+            GMManipulatorType cycleManipulator(gm,GMManipulatorType::DROP);
+            GMManipulatorType& modelManipulator = (reparametrizedFlag ? incrementalManipulator : cycleManipulator);
             modelManipulator.unlock();
             modelManipulator.freeAllVariables();
             for (IndexType varId=0;varId<mask.size();++varId)
@@ -298,8 +364,8 @@ namespace opengm{
             modelManipulator.lock();
 
             InferenceTermination terminationILP;
-            std::vector<LabelType> labeling;
-            terminationILP=_PerformILPInference(modelManipulator,&labeling);
+            std::vector<LabelType> cycleLabeling;
+            terminationILP=_PerformILPInference(modelManipulator,labeling,&cycleLabeling);
             if ((terminationILP!=NORMAL) && (terminationILP!=CONVERGENCE))
             {
                _labeling=lp_labeling;
@@ -310,6 +376,7 @@ namespace opengm{
                //return NORMAL;
                return terminationILP;
             }
+            labeling.swap(cycleLabeling);
 
 #ifdef TRWS_DEBUG_OUTPUT
             _fout <<"Boundary size="<<std::count(boundmask.begin(),boundmask.end(),true)<<std::endl;
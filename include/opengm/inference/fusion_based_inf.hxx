@@ -29,7 +29,8 @@
 #include "opengm/inference/external/ad3.hxx"
 #endif
 
-#include <stdlib.h>     /* srand, rand */
+#include <stdlib.h>
+#include <numeric>
 
 
 #include "opengm/inference/lazyflipper.hxx"
@@ -166,13 +167,17 @@ public:
     struct Parameter
     {
         Parameter(
-            const std::string startDirection = std::string("up")
+            const std::string startDirection = std::string("up"),
+            const size_t seed = 0
         )
-        : startDirection_(startDirection)
+        : startDirection_(startDirection),
+          seed_(seed)
         {
 
         }
         std::string startDirection_;
+        /// seed of the counter-based random directions (startDirection "random")
+        size_t seed_;
     };
     MJumpUpDownGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -186,8 +191,9 @@ public:
     void reset()
     {
         if(param_.startDirection_==  std::string("random")){
+            CounterBasedRandom random(param_.seed_);
             for(size_t i=0; i<gm_.numberOfVariables();++i){
-                direction_[i]=rand()%2 == 0 ? -1:1;
+                direction_[i]=random.uniformInteger(2) == 0 ? -1:1;
             }
         }
         else if(param_.startDirection_==  std::string("up")){
@@ -232,7 +238,7 @@ public:
             const LabelType d  = direction_[vi];
             const LabelType js = jumpSize_[vi];
 
-            if(d>=1){
+            if(d==1){
 
                 if(cl+js < gm_.numberOfLabels(vi)){
                     proposal[vi] = cl + js;
@@ -273,13 +279,17 @@ public:
     struct Parameter
     {
         Parameter(
-            const std::string startDirection = std::string("up")
+            const std::string startDirection = std::string("up"),
+            const size_t seed = 0
         )
-        : startDirection_(startDirection)
+        : startDirection_(startDirection),
+          seed_(seed)
         {
 
         }
         std::string startDirection_;
+        /// seed of the counter-based random directions (startDirection "random")
+        size_t seed_;
     };
     JumpUpDownGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -293,8 +303,9 @@ public:
     void reset()
     {
         if(param_.startDirection_==  std::string("random")){
+            CounterBasedRandom random(param_.seed_);
             for(size_t i=0; i<gm_.numberOfVariables();++i){
-                direction_[i]=rand()%2 == 0 ? -1:1;
+                direction_[i]=random.uniformInteger(2) == 0 ? -1:1;
             }
         }
         else if(param_.startDirection_==  std::string("up")){
@@ -339,7 +350,7 @@ public:
             const LabelType d  = direction_[vi];
             const LabelType js = jumpSize_[vi];
 
-            if(d>=1){
+            if(d==1){
 
                 if(cl+js < gm_.numberOfLabels(vi)){
                     proposal[vi] = cl + js;
@@ -380,13 +391,17 @@ public:
     struct Parameter
     {
         Parameter(
-            const std::string startDirection = std::string("up")
+            const std::string startDirection = std::string("up"),
+            const size_t seed = 0
         )
-        : startDirection_(startDirection)
+        : startDirection_(startDirection),
+          seed_(seed)
         {
 
         }
         std::string startDirection_;
+        /// seed of the counter-based random directions (startDirection "random")
+        size_t seed_;
     };
     UpDownGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -399,8 +414,9 @@ public:
     void reset()
     {
         if(param_.startDirection_==  std::string("random")){
+            CounterBasedRandom random(param_.seed_);
             for(size_t i=0; i<gm_.numberOfVariables();++i){
-                direction_[i]=rand()%2 == 0 ? -1:1;
+                direction_[i]=random.uniformInteger(2) == 0 ? -1:1;
             }
         }
         else if(param_.startDirection_==  std::string("up")){
@@ -567,7 +583,11 @@ public:
     OPENGM_GM_TYPE_TYPEDEFS;
     struct Parameter
     {
-        Parameter(){}
+        Parameter(const size_t seed = 0)
+        :   seed_(seed){
+        }
+        /// seed of the counter-based random labels, the labels of a step do not depend on each other
+        size_t seed_;
     };
     RandomGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -582,10 +602,10 @@ public:
     size_t defaultNumStopIt() {return 10;}
     void getProposal(const std::vector<LabelType> &current , std::vector<LabelType> &proposal)
     {
+        CounterBasedRandom random(param_.seed_, currentStep_);
         for (IndexType vi = 0; vi < gm_.numberOfVariables(); ++vi){
             // draw label
-           opengm::RandomUniform<size_t> randomLabel(0, gm_.numberOfLabels(vi),currentStep_+vi);
-            proposal[vi] = randomLabel();
+            proposal[vi] = random.uniformInteger(static_cast<LabelType>(gm_.numberOfLabels(vi)));
         }
         ++currentStep_;
     }
@@ -606,7 +626,11 @@ public:
     OPENGM_GM_TYPE_TYPEDEFS;
     struct Parameter
     {
-        Parameter(){}
+        Parameter(const size_t seed = 0)
+        :   seed_(seed){
+        }
+        /// seed of the counter-based random labels, the labels of a step do not depend on each other
+        size_t seed_;
     };
     RandomLFGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -621,10 +645,10 @@ public:
     size_t defaultNumStopIt() {return 10;}
     void getProposal(const std::vector<LabelType> &current , std::vector<LabelType> &proposal)
     {
+        CounterBasedRandom random(param_.seed_, currentStep_);
         for (IndexType vi = 0; vi < gm_.numberOfVariables(); ++vi){
             // draw label
-            opengm::RandomUniform<size_t> randomLabel(0, gm_.numberOfLabels(vi),currentStep_+vi);
-            proposal[vi] = randomLabel();
+            proposal[vi] = random.uniformInteger(static_cast<LabelType>(gm_.numberOfLabels(vi)));
         }
         typename opengm::LazyFlipper<GM,ACC>::Parameter para(1,proposal.begin(),proposal.end());
         opengm::LazyFlipper<GM,ACC> lf(gm_,para);
@@ -648,17 +672,20 @@ public:
     OPENGM_GM_TYPE_TYPEDEFS;
     struct Parameter
     {
-        Parameter(const float temp=1.0)
-        :   temp_(temp){
+        Parameter(const float temp=1.0, const size_t seed = 0)
+        :   temp_(temp),
+            seed_(seed){
         }
         float temp_;
+        /// seed of the counter-based random labels
+        size_t seed_;
     };
 
     NonUniformRandomGen(const GM &gm, const Parameter &param)
     :  gm_(gm),
     param_(param),
     currentStep_(0),
-    randomGens_(gm.numberOfVariables())
+    cumulativeWeights_(gm.numberOfVariables())
     {
         std::vector<bool> hasUnary(gm.numberOfVariables(),false);
 
@@ -678,15 +705,18 @@ public:
                    //OPENGM_CHECK_OP(weights[l],>=,0.0, "NonUniformRandomGen allows only positive unaries");
                     weights[l]=std::exp(-1.0*param_.temp_*weights[l]);
                 }
-                randomGens_[vi]=GenType(weights.begin(),weights.end());
+                std::partial_sum(weights.begin(),weights.end(),weights.begin());
+                cumulativeWeights_[vi].swap(weights);
                 hasUnary[vi]=true;
             }
         }
         for(IndexType vi=0 ;vi<gm_.numberOfVariables(); ++vi){
             if(!hasUnary[vi]){
                 const LabelType numLabels = gm_.numberOfLabels(vi);
-                std::vector<ValueType> weights(numLabels,1.0);
-                randomGens_[vi]=GenType(weights.begin(),weights.end());
+                cumulativeWeights_[vi].resize(numLabels);
+                for(LabelType l=0; l<numLabels; ++l){
+                    cumulativeWeights_[vi][l]=static_cast<ValueType>(l+1);
+                }
             }
         }
 
@@ -702,8 +732,9 @@ public:
     }
     void getProposal(const std::vector<LabelType> &current , std::vector<LabelType> &proposal)
     {
+        CounterBasedRandom random(param_.seed_, currentStep_);
         for (IndexType vi = 0; vi < gm_.numberOfVariables(); ++vi){
-            proposal[vi]=randomGens_[vi]();
+            proposal[vi]=static_cast<LabelType>(random.categorical(cumulativeWeights_[vi].begin(),cumulativeWeights_[vi].end()));
         }
         ++currentStep_;
     }
@@ -711,10 +742,7 @@ private:
     const GM &gm_;
     Parameter param_;
     LabelType currentStep_;
-
-    typedef RandomDiscreteWeighted<LabelType,ValueType> GenType;
-
-    std::vector < RandomDiscreteWeighted<LabelType,ValueType> > randomGens_;
+    std::vector<std::vector<ValueType> > cumulativeWeights_;
 };
 
 
@@ -727,10 +755,12 @@ public:
     OPENGM_GM_TYPE_TYPEDEFS;
     struct Parameter
     {
-       Parameter(double sigma = 20.0) : sigma_(sigma)
+       Parameter(double sigma = 20.0, const size_t seed = 0) : sigma_(sigma), seed_(seed)
           {
           }
        double sigma_;
+       /// seed of the counter-based random labels
+       size_t seed_;
     };
     BlurGen(const GM &gm, const Parameter &param)
         :  gm_(gm),
@@ -815,19 +845,15 @@ public:
    
     void getProposal(const std::vector<LabelType> &current , std::vector<LabelType> &proposal)
     { 
+       CounterBasedRandom random(param_.seed_, currentStep_);
        if ((currentStep_ % 2) == 0){ 
-          for (int i = 0; i < height_; ++i) {
-             for (int j = 0; j < width_; ++j) { 
-                const size_t var = ind(i,j);
-                opengm::RandomUniform<size_t> randomLabel(0, gm_.numberOfLabels(var),currentStep_+i+j);
-                proposal[var] = (LabelType)(randomLabel());
-             }
+          for (size_t var = 0; var < gm_.numberOfVariables(); ++var) {
+             proposal[var] = random.uniformInteger(static_cast<LabelType>(gm_.numberOfLabels(var)));
           } 
        }else{
           proposal.resize(gm_.numberOfVariables(),0.0);
-          opengm::RandomUniform<double> randomLabel(-param_.sigma_*1.5, param_.sigma_*1.5,currentStep_);
           for(size_t i=0; i<proposal.size();++i){
-             proposal[i] = std::min(gm_.numberOfLabels(i)-1, (LabelType)(std::max(0.0,bluredLabel_[i] + randomLabel())));
+             proposal[i] = std::min(gm_.numberOfLabels(i)-1, (LabelType)(std::max(0.0,bluredLabel_[i] + random.uniform(-param_.sigma_*1.5, param_.sigma_*1.5))));
           }
        }
        ++currentStep_;
@@ -853,12 +879,14 @@ public:
    OPENGM_GM_TYPE_TYPEDEFS;
    struct Parameter
    {
-      Parameter(double sigma = 20.0, bool useLocalMargs = false, double temp=1) : sigma_(sigma),  useLocalMargs_(useLocalMargs),  temp_(temp)
+      Parameter(double sigma = 20.0, bool useLocalMargs = false, double temp=1, const size_t seed = 0) : sigma_(sigma),  useLocalMargs_(useLocalMargs),  temp_(temp), seed_(seed)
          {
          }
       double sigma_;
       bool   useLocalMargs_; 
       double temp_;
+      /// seed of the counter-based random labels
+      size_t seed_;
       
    };
    EnergyBlurGen(const GM &gm, const Parameter &param)
@@ -965,7 +993,7 @@ public:
             }
          } 
          if(param_.useLocalMargs_){
-            localMargGens_.reserve(bluredOpt.size());
+            cumulativeMargs_.resize(bluredOpt.size());
             for(size_t var=0 ; var<bluredOpt.size(); ++var){
                const ValueType minValue = *std::min_element(margs[var].begin(),margs[var].end());
                for(LabelType l=0; l<numLabels; ++l){
@@ -974,14 +1002,15 @@ public:
                for(LabelType l=0; l<numLabels; ++l){
                   margs[var][l]=std::exp(-1.0*param_.temp_*margs[var][l]);
                }
-               localMargGens_[var]=opengm::RandomDiscreteWeighted<LabelType,ValueType>(margs[var].begin(),margs[var].end(),var);  
+               cumulativeMargs_[var].resize(numLabels);
+               std::partial_sum(margs[var].begin(),margs[var].end(),cumulativeMargs_[var].begin());
             }
          }else{
-            uniformGens_.reserve(bluredOpt.size());
+            minLabel_.resize(bluredOpt.size());
+            maxLabel_.resize(bluredOpt.size());
             for(size_t var=0 ; var<bluredOpt.size(); ++var){
-               LabelType minVal = (LabelType)(std::max((double)(0)         , bluredOpt[var]-param_.sigma_*1.5));
-               LabelType maxVal = (LabelType)(std::min((double)(numLabels) , bluredOpt[var]+param_.sigma_*1.5));
-               uniformGens_[var] = opengm::RandomUniform<LabelType>(minVal, maxVal+1, var);
+               minLabel_[var] = (LabelType)(std::max((double)(0)           , bluredOpt[var]-param_.sigma_*1.5));
+               maxLabel_[var] = (LabelType)(std::min((double)(numLabels-1) , bluredOpt[var]+param_.sigma_*1.5));
             }
          }   
       }
@@ -992,20 +1021,21 @@ public:
    void getProposal(const std::vector<LabelType> &current , std::vector<LabelType> &proposal)
       {
          proposal.resize(gm_.numberOfVariables());  
+         CounterBasedRandom random(param_.seed_, currentStep_);
          if(param_.useLocalMargs_){ 
             for(size_t i=0; i<proposal.size();++i){
-               proposal[i] = localMargGens_[i](); 
+               proposal[i] = static_cast<LabelType>(random.categorical(cumulativeMargs_[i].begin(), cumulativeMargs_[i].end())); 
             } 
          }
          else{
-            opengm::RandomUniform<LabelType> randomLabel(0, gm_.numberOfLabels(0),currentStep_);
             if ((currentStep_ % 2) == 0){ 
+               const LabelType numLabels = gm_.numberOfLabels(0);
                for(size_t i=0; i<proposal.size();++i){
-                  proposal[i] = randomLabel();
+                  proposal[i] = random.uniformInteger(numLabels);
                } 
             }else{
                for(size_t i=0; i<proposal.size();++i){
-                  proposal[i] = uniformGens_[i]();
+                  proposal[i] = minLabel_[i] + random.uniformInteger(static_cast<LabelType>(maxLabel_[i] - minLabel_[i] + 1));
                }
             }
          }
@@ -1019,9 +1049,10 @@ private:
    size_t width_;
    LabelType currentStep_;
 
-   // Random Generators
-   std::vector<opengm::RandomDiscreteWeighted<LabelType,ValueType> > localMargGens_;
-   std::vector<opengm::RandomUniform<LabelType> >                    uniformGens_;
+   // cumulative local marginals (useLocalMargs) or label range around the blured optimum
+   std::vector<std::vector<ValueType> > cumulativeMargs_;
+   std::vector<LabelType> minLabel_;
+   std::vector<LabelType> maxLabel_;
 };
 
 
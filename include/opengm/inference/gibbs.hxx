@@ -116,7 +116,8 @@ public:
          const ValueType tmax=1,
          const IndexType periods=10,
          const VariableProposal variableProposal = RANDOM,
-         const std::vector<size_t>& startPoint = std::vector<size_t>()
+         const std::vector<size_t>& startPoint = std::vector<size_t>(),
+         const size_t seed = 0
       )
       :  maxNumberOfSamplingSteps_(maxNumberOfSamplingSteps), 
          numberOfBurnInSteps_(numberOfBurnInSteps), 
@@ -125,7 +126,8 @@ public:
          useTemp_(useTemp),
          tempMin_(tmin),
          tempMax_(tmax),
-         periods_(periods){
+         periods_(periods),
+         seed_(seed){
          p_=static_cast<ValueType>(maxNumberOfSamplingSteps_/periods_);
       }
       bool useTemp_;
@@ -137,6 +139,8 @@ public:
       size_t numberOfBurnInSteps_;
       VariableProposal variableProposal_;
       std::vector<size_t> startPoint_;
+      /// seed of the counter-based random numbers, equal seeds yield equal samples
+      size_t seed_;
       
       
    };
@@ -273,23 +277,21 @@ InferenceTermination Gibbs<GM, ACC>::infer(
 ) {
    inInference_=true;
    visitor.begin(*this);
-   opengm::RandomUniform<size_t> randomVariable(0, gm_.numberOfVariables());
-   opengm::RandomUniform<ProbabilityType> randomProb(0, 1);
+   opengm::CounterBasedRandom random(parameter_.seed_);
    
    if(parameter_.useTemp_==false){
       for(size_t iteration = 0; iteration < parameter_.maxNumberOfSamplingSteps_ + parameter_.numberOfBurnInSteps_; ++iteration) {
          // select variable
          size_t variableIndex = 0;
          if(this->parameter_.variableProposal_ == Parameter::RANDOM) {
-            variableIndex = randomVariable();
+            variableIndex = random.uniformInteger(gm_.numberOfVariables());
          }
          else if(this->parameter_.variableProposal_ == Parameter::CYCLIC) {
             variableIndex < gm_.numberOfVariables() - 1 ? ++variableIndex : variableIndex = 0;
          }
 
          // draw label
-         opengm::RandomUniform<size_t> randomLabel(0, gm_.numberOfLabels(variableIndex));
-         const size_t label = randomLabel();
+         const size_t label = random.uniformInteger(static_cast<size_t>(gm_.numberOfLabels(variableIndex)));
 
          // move
          const bool burningIn = (iteration < parameter_.numberOfBurnInSteps_);
@@ -312,7 +314,7 @@ InferenceTermination Gibbs<GM, ACC>::infer(
                   detail_gibbs::ValuePairToProbability<
                      OperatorType, AccumulationType, ProbabilityType
                   >::convert(newValue, oldValue);
-               if(randomProb() < pFlip) {
+               if(random.uniform() < pFlip) {
                   movemaker_.move(&variableIndex, &variableIndex + 1, &label); 
                   visitor(*this);
                   //visitor(*this, newValue, currentBestValue_, iteration, true, burningIn);
@@ -331,15 +333,14 @@ InferenceTermination Gibbs<GM, ACC>::infer(
          // select variable
          size_t variableIndex = 0;
          if(this->parameter_.variableProposal_ == Parameter::RANDOM) {
-            variableIndex = randomVariable();
+            variableIndex = random.uniformInteger(gm_.numberOfVariables());
          }
          else if(this->parameter_.variableProposal_ == Parameter::CYCLIC) {
             variableIndex < gm_.numberOfVariables() - 1 ? ++variableIndex : variableIndex = 0;
          }
 
          // draw label
-         opengm::RandomUniform<size_t> randomLabel(0, gm_.numberOfLabels(variableIndex));
-         const size_t label = randomLabel();
+         const size_t label = random.uniformInteger(static_cast<size_t>(gm_.numberOfLabels(variableIndex)));
 
          // move
          const bool burningIn = (iteration < parameter_.numberOfBurnInSteps_);
@@ -362,7 +363,7 @@ InferenceTermination Gibbs<GM, ACC>::infer(
                   detail_gibbs::ValuePairToProbability<
                      OperatorType, AccumulationType, ProbabilityType
                   >::convert(newValue, oldValue);
-               if(randomProb() < pFlip*this->getTemperature(iteration)){
+               if(random.uniform() < pFlip*this->getTemperature(iteration)){
                   //std::cout<<"temp="<<this->getTemperature(iteration)<<"\n";
                   movemaker_.move(&variableIndex, &variableIndex + 1, &label); 
                   visitor(*this);
@@ -3,16 +3,24 @@
 #define OPENGM_GRAPHCUT_HXX
 
 #include <typeinfo>
+#include <algorithm>
+#include <utility>
 
 #include "opengm/operations/adder.hxx"
 #include "opengm/operations/maximizer.hxx"
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/inference/auxiliary/minstcutgrid.hxx"
 
 namespace opengm {
 
 /// A framework for min st-cut algorithms.
 ///
+/// If the graphical model is a grid (FactorGraph::isGrid) with only first
+/// and regular second order factors, the native lattice solver MinSTCutGrid
+/// is used instead of MINSTCUT. Set Parameter::useGrid_ to false to always
+/// use MINSTCUT.
+///
 /// \ingroup inference
 template<class GM, class ACC, class MINSTCUT>
 class GraphCut : public Inference<GM, ACC> {
@@ -21,14 +29,19 @@ public:
    typedef GM GraphicalModelType;
    OPENGM_GM_TYPE_TYPEDEFS;
    typedef MINSTCUT MinStCutType;
+   typedef MinSTCutGrid<size_t, typename MINSTCUT::ValueType> GridMinStCutType;
    typedef visitors::VerboseVisitor<GraphCut<GM, ACC, MINSTCUT> > VerboseVisitorType;
    typedef visitors::EmptyVisitor<GraphCut<GM, ACC, MINSTCUT> >   EmptyVisitorType;
    typedef visitors::TimingVisitor<GraphCut<GM, ACC, MINSTCUT> >  TimingVisitorType;
    struct Parameter {
-      Parameter(const ValueType scale = 1)
-         : scale_(scale) 
+      Parameter(const ValueType scale = 1, const bool useGrid = true, const size_t numberOfThreads = 0)
+         : scale_(scale), useGrid_(useGrid), numberOfThreads_(numberOfThreads)
          {}
       ValueType scale_;
+      /// use MinSTCutGrid for models on a grid (the grid test is skipped if false)
+      bool useGrid_;
+      /// number of threads of MinSTCutGrid (0 = all available)
+      size_t numberOfThreads_;
    };
 
    GraphCut(const GraphicalModelType&, const Parameter& = Parameter(), ValueType = static_cast<ValueType>(0.0));
@@ -43,21 +56,41 @@ public:
    template<class VISITOR>
    InferenceTermination infer(VISITOR & visitor);
    InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
+   InferenceTermination rebind(const GraphicalModelType&);
+   InferenceTermination updateUnaries(const GraphicalModelType&);
+   template<class ARRAY>
+      bool setGrid(const ARRAY&);
+   bool usesGrid() const;
 
 private:
+   typedef typename MINSTCUT::ValueType CapacityType;
+
+   bool regular(const GraphicalModelType&) const;
+   void useMinStCut();
+   void addFactors(const GraphicalModelType&);
    void addEdgeCapacity(const size_t, const size_t, const ValueType);
+   void addInnerEdge(const size_t, const size_t, const CapacityType);
+   void resetMinStCut();
    size_t tripleId(std::vector<size_t>&);
 
    const GraphicalModelType* gm_;
    ValueType tolerance_;
    MinStCutType* minStCut_;
+   GridMinStCutType* gridMinStCut_;
+   std::vector<size_t> gridNode_;
    Parameter parameter_;
    size_t numVariables_;
    std::vector<size_t> numFacDim_;
    std::list<std::vector<size_t> > tripleList;
    std::vector<bool> state_;
-   std::vector<typename MINSTCUT::ValueType> sEdges_;
-   std::vector<typename MINSTCUT::ValueType> tEdges_;
+   std::vector<CapacityType> sEdges_;
+   std::vector<CapacityType> tEdges_;
+   // contribution of the factors of order > 1, kept for updateUnaries
+   std::vector<CapacityType> sBase_;
+   std::vector<CapacityType> tBase_;
+   std::vector<std::pair<size_t, size_t> > innerEdges_;
+   std::vector<CapacityType> innerCapacities_;
+   bool recordEdges_;
    bool inferenceDone_;
 };
 
@@ -82,7 +115,9 @@ inline GraphCut<GM, ACC, MINSTCUT>::GraphCut
    const ValueType tolerance
 )
    :  gm_((GM*) 0), 
-   tolerance_(fabs(tolerance))
+   tolerance_(fabs(tolerance)),
+   gridMinStCut_(NULL),
+   recordEdges_(false)
 {
    OPENGM_ASSERT(typeid(ACC) == typeid(opengm::Minimizer) || typeid(ACC) == typeid(opengm::Maximizer));
    OPENGM_ASSERT(typeid(typename GM::OperatorType) == typeid(opengm::Adder));
@@ -106,7 +141,10 @@ inline GraphCut<GM, ACC, MINSTCUT>::GraphCut
    const ValueType tolerance
 ) 
 :  gm_(&gm), 
-   tolerance_(fabs(tolerance))
+   tolerance_(fabs(tolerance)),
+   minStCut_(NULL),
+   gridMinStCut_(NULL),
+   recordEdges_(false)
 {
    if(typeid(ACC) != typeid(opengm::Minimizer) && typeid(ACC) != typeid(opengm::Maximizer)) {
       throw RuntimeError("This implementation of the graph cut optimizer supports as accumulator only opengm::Minimizer and opengm::Maximizer.");
@@ -129,13 +167,13 @@ inline GraphCut<GM, ACC, MINSTCUT>::GraphCut
       ++numFacDim_[gm[j].numberOfVariables()];
    }
 
-   minStCut_ = new MinStCutType(2 + numVariables_ + numFacDim_[3], 2*numVariables_ + numFacDim_[2] + 3*numFacDim_[3]);
+   marray::Matrix<size_t> grid;
+   if(!parameter_.useGrid_ || !regular(gm) || !gm.isGrid(grid) || !setGrid(grid)) {
+      useMinStCut();
+   }
    sEdges_.assign(numVariables_ + numFacDim_[3], 0);
    tEdges_.assign(numVariables_ + numFacDim_[3], 0);
-
-   for(size_t j = 0; j < gm.numberOfFactors(); ++j) {
-      addFactor(gm[j]);
-   }
+   addFactors(gm);
    inferenceDone_=false;
    //std::cout << parameter_.scale_ <<std::endl;
 }
@@ -144,6 +182,205 @@ template<class GM, class ACC, class MINSTCUT>
 inline GraphCut<GM, ACC, MINSTCUT>::~GraphCut()
 {
    delete minStCut_;
+   delete gridMinStCut_;
+}
+
+/// \brief solve the min st-cut problem with MinSTCutGrid
+///
+/// \param variables array (of dimension 1, 2 or 3) that contains each
+///        variable exactly once, at its position in the grid
+///
+/// Must be called before any factor is added. If the graphical model is
+/// known, its second order factors must connect neighbors in the grid.
+/// Returns false (and keeps MINSTCUT) if these conditions are not met, if
+/// there are third order or irregular second order factors or if
+/// Parameter::useGrid_ is false.
+template<class GM, class ACC, class MINSTCUT>
+template<class ARRAY>
+bool
+GraphCut<GM, ACC, MINSTCUT>::setGrid
+(
+   const ARRAY& variables
+) {
+   if(!parameter_.useGrid_ || numFacDim_[3] != 0 || variables.size() != numVariables_
+   || variables.dimension() == 0 || variables.dimension() > 3 || (gm_ != NULL && !regular(*gm_))) {
+      return false;
+   }
+   size_t dims[] = {1, 1, 1};
+   for(size_t a = 0; a < variables.dimension(); ++a) {
+      dims[a] = variables.shape(a);
+   }
+   std::vector<size_t> gridNode(numVariables_, numVariables_);
+   size_t node = 0;
+   for(size_t z = 0; z < dims[2]; ++z)
+   for(size_t y = 0; y < dims[1]; ++y)
+   for(size_t x = 0; x < dims[0]; ++x, ++node) {
+      const size_t var = variables.dimension() == 1 ? variables(x)
+         : variables.dimension() == 2 ? variables(x, y) : variables(x, y, z);
+      if(var >= numVariables_ || gridNode[var] != numVariables_) {
+         return false;
+      }
+      gridNode[var] = node;
+   }
+   GridMinStCutType* gridMinStCut = new GridMinStCutType(dims[0], dims[1], dims[2], parameter_.numberOfThreads_);
+   if(gm_ != NULL) {
+      for(size_t j = 0; j < gm_->numberOfFactors(); ++j) {
+         if((*gm_)[j].numberOfVariables() == 2
+         && !gridMinStCut->adjacent(gridNode[(*gm_)[j].variableIndex(0)] + 2, gridNode[(*gm_)[j].variableIndex(1)] + 2)) {
+            delete gridMinStCut;
+            return false;
+         }
+      }
+   }
+   delete minStCut_;
+   minStCut_ = NULL;
+   delete gridMinStCut_;
+   gridMinStCut_ = gridMinStCut;
+   gridNode_.swap(gridNode);
+   return true;
+}
+
+/// \brief true if MinSTCutGrid is used instead of MINSTCUT
+template<class GM, class ACC, class MINSTCUT>
+inline bool
+GraphCut<GM, ACC, MINSTCUT>::usesGrid() const
+{
+   return gridMinStCut_ != NULL;
+}
+
+/// \brief bind to a model of the same structure
+///
+/// The min st-cut graph is cleared in place (MINSTCUT::reset, which keeps
+/// the allocated nodes) and filled with the capacities of the new model.
+/// Flows of the previous solution are not reused. Returns UNKNOWN for a
+/// solver that has been constructed without a graphical model.
+template<class GM, class ACC, class MINSTCUT>
+inline InferenceTermination
+GraphCut<GM, ACC, MINSTCUT>::rebind
+(
+   const GraphicalModelType& gm
+) {
+   if(gm_ == NULL) {
+      return UNKNOWN;
+   }
+   this->checkRebind(*gm_, gm);
+   gm_ = &gm;
+   numVariables_ = gm.numberOfVariables();
+   tripleList.clear();
+   if(gridMinStCut_ != NULL && !regular(gm)) {
+      useMinStCut();
+   }
+   resetMinStCut();
+   std::fill(sEdges_.begin(), sEdges_.end(), 0);
+   std::fill(tEdges_.begin(), tEdges_.end(), 0);
+   addFactors(gm);
+   inferenceDone_ = false;
+   return NORMAL;
+}
+
+/// \brief bind to a model that differs only in the first order factors
+///
+/// The capacities of the factors of order > 1 are taken from the previous
+/// model without evaluating them again, only the unaries are read from gm.
+/// Returns UNKNOWN for a solver that has been constructed without a
+/// graphical model.
+template<class GM, class ACC, class MINSTCUT>
+inline InferenceTermination
+GraphCut<GM, ACC, MINSTCUT>::updateUnaries
+(
+   const GraphicalModelType& gm
+) {
+   if(gm_ == NULL) {
+      return UNKNOWN;
+   }
+   this->checkRebind(*gm_, gm);
+   gm_ = &gm;
+   resetMinStCut();
+   for(size_t e = 0; e < innerEdges_.size(); ++e) {
+      addInnerEdge(innerEdges_[e].first, innerEdges_[e].second, innerCapacities_[e]);
+   }
+   sEdges_ = sBase_;
+   tEdges_ = tBase_;
+   for(size_t j = 0; j < gm.numberOfFactors(); ++j) {
+      if(gm[j].numberOfVariables() == 1) {
+         addFactor(gm[j]);
+      }
+   }
+   inferenceDone_ = false;
+   return NORMAL;
+}
+
+/// true if all second order factors of gm are regular (submodular for
+/// Minimizer, supermodular for Maximizer up to the tolerance), i.e. the
+/// min st-cut graph has no negative capacities
+template<class GM, class ACC, class MINSTCUT>
+inline bool
+GraphCut<GM, ACC, MINSTCUT>::regular
+(
+   const GraphicalModelType& gm
+) const {
+   for(size_t j = 0; j < gm.numberOfFactors(); ++j) {
+      if(gm[j].numberOfVariables() == 2) {
+         size_t i[] = {0, 0}; const ValueType A = gm[j](i);
+         i[0] = 0; i[1] = 1;  const ValueType B = gm[j](i);
+         i[0] = 1; i[1] = 0;  const ValueType C = gm[j](i);
+         i[0] = 1; i[1] = 1;  const ValueType D = gm[j](i);
+         const ValueType term = B + C - A - D;
+         if(typeid(ACC) == typeid(opengm::Minimizer) ? term < -tolerance_ : term > tolerance_) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+/// replace MinSTCutGrid (if any) by MINSTCUT
+template<class GM, class ACC, class MINSTCUT>
+inline void
+GraphCut<GM, ACC, MINSTCUT>::useMinStCut() {
+   delete gridMinStCut_;
+   gridMinStCut_ = NULL;
+   gridNode_.clear();
+   if(minStCut_ == NULL) {
+      minStCut_ = new MinStCutType(2 + numVariables_ + numFacDim_[3], 2*numVariables_ + numFacDim_[2] + 3*numFacDim_[3]);
+   }
+}
+
+/// add the factors of gm, those of order > 1 first, and keep their capacities for updateUnaries
+template<class GM, class ACC, class MINSTCUT>
+inline void
+GraphCut<GM, ACC, MINSTCUT>::addFactors
+(
+   const GraphicalModelType& gm
+) {
+   innerEdges_.clear();
+   innerCapacities_.clear();
+   recordEdges_ = true;
+   for(size_t j = 0; j < gm.numberOfFactors(); ++j) {
+      if(gm[j].numberOfVariables() != 1) {
+         addFactor(gm[j]);
+      }
+   }
+   recordEdges_ = false;
+   sBase_ = sEdges_;
+   tBase_ = tEdges_;
+   for(size_t j = 0; j < gm.numberOfFactors(); ++j) {
+      if(gm[j].numberOfVariables() == 1) {
+         addFactor(gm[j]);
+      }
+   }
+}
+
+/// remove all capacities from the min st-cut graph
+template<class GM, class ACC, class MINSTCUT>
+inline void
+GraphCut<GM, ACC, MINSTCUT>::resetMinStCut() {
+   if(gridMinStCut_ != NULL) {
+      gridMinStCut_->reset();
+   }
+   else {
+      minStCut_->reset();
+   }
 }
 
 /// add a factor of the GraphicalModel to the min st-cut formulation of the solver MinStCutType
@@ -320,7 +557,28 @@ GraphCut<GM, ACC, MINSTCUT>::addEdgeCapacity
       tEdges_[n1-2] += cost;
    }
    else {
-      minStCut_->addEdge(n1, n2, cost);
+      if(recordEdges_) {
+         innerEdges_.push_back(std::make_pair(v, w));
+         innerCapacities_.push_back(cost);
+      }
+      addInnerEdge(v, w, cost);
+   }
+}
+
+template<class GM, class ACC, class MINSTCUT>
+inline void 
+GraphCut<GM, ACC, MINSTCUT>::addInnerEdge
+(
+   const size_t v, 
+   const size_t w, 
+   const CapacityType cost
+) {
+   typedef typename MINSTCUT::node_type NType;
+   if(gridMinStCut_ != NULL) {
+      gridMinStCut_->addEdge(gridNode_[v-2] + 2, gridNode_[w-2] + 2, cost);
+   }
+   else {
+      minStCut_->addEdge(static_cast<NType>(v), static_cast<NType>(w), cost);
    }
 }
 
@@ -357,11 +615,27 @@ template<class VISITOR>
 inline InferenceTermination 
 GraphCut<GM, ACC, MINSTCUT>::infer(VISITOR & visitor) { 
    visitor.begin(*this);
-   for(size_t i=0; i<sEdges_.size(); ++i) {
-      minStCut_->addEdge(0, i+2, sEdges_[i]);
-      minStCut_->addEdge(i+2, 1, tEdges_[i]);
+   if(gridMinStCut_ != NULL) {
+      for(size_t i=0; i<sEdges_.size(); ++i) {
+         gridMinStCut_->addEdge(0, gridNode_[i]+2, sEdges_[i]);
+         gridMinStCut_->addEdge(gridNode_[i]+2, 1, tEdges_[i]);
+      }
+      std::vector<bool> segmentation;
+      gridMinStCut_->calculateCut(segmentation);
+      state_.resize(2 + numVariables_);
+      state_[0] = segmentation[0];
+      state_[1] = segmentation[1];
+      for(size_t i=0; i<numVariables_; ++i) {
+         state_[i+2] = segmentation[gridNode_[i]+2];
+      }
+   }
+   else {
+      for(size_t i=0; i<sEdges_.size(); ++i) {
+         minStCut_->addEdge(0, i+2, sEdges_[i]);
+         minStCut_->addEdge(i+2, 1, tEdges_[i]);
+      }
+      minStCut_->calculateCut(state_);
    }
-   minStCut_->calculateCut(state_);
    inferenceDone_=true;
    visitor.end(*this);
    return NORMAL;
@@ -73,12 +73,13 @@ public:
    template<class VisitorType>
       InferenceTermination infer(VisitorType&);
    void setStartingPoint(typename std::vector<LabelType>::const_iterator);
+   InferenceTermination rebind(const GraphicalModelType&);
    virtual InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const ;
    virtual ValueType value()const{return movemaker_.value();}
    size_t currentMoveType() const;
 
 private:
-      const GraphicalModelType& gm_;
+      const GraphicalModelType* gm_;
       MovemakerType movemaker_;
       Parameter param_;
       MoveType currentMoveType_;
@@ -97,7 +98,7 @@ ICM<GM, ACC>::ICM
 (
       const GraphicalModelType& gm
 )
-:  gm_(gm),
+:  gm_(&gm),
    movemaker_(gm),
    param_(Parameter()),
    currentMoveType_(SINGLE_VARIABLE) {
@@ -109,7 +110,7 @@ ICM<GM, ACC>::ICM
       const GraphicalModelType& gm,
       const Parameter& parameter
 )
-:  gm_(gm),
+:  gm_(&gm),
    movemaker_(gm),
    param_(parameter),
    currentMoveType_(SINGLE_VARIABLE)
@@ -126,7 +127,7 @@ template<class GM, class ACC>
 inline void
 ICM<GM, ACC>::reset()
 {
-   if(param_.startPoint_.size() == gm_.numberOfVariables()) {
+   if(param_.startPoint_.size() == gm_->numberOfVariables()) {
       movemaker_.initialize(param_.startPoint_.begin() );
    }
    else if(param_.startPoint_.size() != 0) {
@@ -146,6 +147,20 @@ ICM<GM,ACC>::setStartingPoint
    movemaker_.initialize(begin);
 }
    
+/// \brief bind to a model of the same structure, the current labeling is the starting point of the next infer()
+template<class GM, class ACC>
+inline InferenceTermination
+ICM<GM,ACC>::rebind
+(
+   const GraphicalModelType& gm
+) {
+   this->checkRebind(*gm_, gm);
+   gm_ = &gm;
+   movemaker_.rebind(gm);
+   currentMoveType_ = SINGLE_VARIABLE;
+   return NORMAL;
+}
+
 template<class GM, class ACC>
 inline std::string
 ICM<GM, ACC>::name() const
@@ -157,7 +172,7 @@ template<class GM, class ACC>
 inline const typename ICM<GM, ACC>::GraphicalModelType&
 ICM<GM, ACC>::graphicalModel() const
 {
-   return gm_;
+   return *gm_;
 }
   
 template<class GM, class ACC>
@@ -180,15 +195,14 @@ InferenceTermination ICM<GM,ACC>::infer
    visitor.begin(*this);
    if(param_.moveType_==SINGLE_VARIABLE ||param_.moveType_==FACTOR) {
       bool updates = true;
-      std::vector<bool> isLocalOptimal(gm_.numberOfVariables());
-      std::vector<opengm::RandomAccessSet<IndexType> >variableAdjacencyList;
-      gm_.variableAdjacencyList(variableAdjacencyList);
+      std::vector<bool> isLocalOptimal(gm_->numberOfVariables());
+      const typename GraphicalModelType::AdjacencyType& variableAdjacencyList = gm_->variableAdjacency();
       size_t v=0,s=0,n=0;
       while(updates && exitInf==false) {
          updates = false;
-         for(v=0; v<gm_.numberOfVariables() && exitInf==false; ++v) {
+         for(v=0; v<gm_->numberOfVariables() && exitInf==false; ++v) {
             if(isLocalOptimal[v]==false) {
-               for(s=0; s<gm_.numberOfLabels(v); ++s) {
+               for(s=0; s<gm_->numberOfLabels(v); ++s) {
                   if(s != movemaker_.state(v)) {
                      if(AccumulationType::bop(movemaker_.valueAfterMove(&v, &v+1, &s), movemaker_.value())) {
                         movemaker_.move(&v, &v+1, &s);
@@ -211,34 +225,34 @@ InferenceTermination ICM<GM,ACC>::infer
       currentMoveType_=FACTOR;
       //visitor(*this, movemaker_.value(),movemaker_.value());
       bool updates = true;
-      std::vector<bool> isLocalOptimal(gm_.numberOfFactors(),false);
+      std::vector<bool> isLocalOptimal(gm_->numberOfFactors(),false);
       //std::vector<opengm::RandomAccessSet<size_t> >variableAdjacencyList;
       opengm::BufferVector<LabelType> stateBuffer;
       stateBuffer.reserve(10);
-      //gm_.factorAdjacencyList(variableAdjacencyList);
+      //gm_->factorAdjacencyList(variableAdjacencyList);
       size_t f=0,ff=0,v=0;
       while(updates && exitInf==false) {
          updates = false;
-         for(f=0; f<gm_.numberOfFactors() && exitInf==false; ++f) {
-            if(isLocalOptimal[f]==false && gm_[f].numberOfVariables()>1) {
+         for(f=0; f<gm_->numberOfFactors() && exitInf==false; ++f) {
+            if(isLocalOptimal[f]==false && (*gm_)[f].numberOfVariables()>1) {
                stateBuffer.clear();
-               stateBuffer.resize(gm_[f].numberOfVariables());
-               for(v=0;v<gm_[f].numberOfVariables();++v) {
-                  stateBuffer[v]=movemaker_.state(gm_[f].variableIndex(v));
+               stateBuffer.resize((*gm_)[f].numberOfVariables());
+               for(v=0;v<(*gm_)[f].numberOfVariables();++v) {
+                  stateBuffer[v]=movemaker_.state((*gm_)[f].variableIndex(v));
                }
                ValueType oldValue=movemaker_.value();
-               ValueType newValue=movemaker_. template moveOptimally<ACC>(gm_[f].variableIndicesBegin(),gm_[f].variableIndicesEnd());   
+               ValueType newValue=movemaker_. template moveOptimally<ACC>((*gm_)[f].variableIndicesBegin(),(*gm_)[f].variableIndicesEnd());   
                if(ACC::bop(newValue,oldValue)) {
                   updates = true ;
                   if( visitor(*this) != visitors::VisitorReturnFlag::ContinueInf ){
                      exitInf=true;
                      break;
                   }
-                  for(v=0;v<gm_[f].numberOfVariables();++v) {
-                     const size_t varIndex=gm_[f].variableIndex(v);
+                  for(v=0;v<(*gm_)[f].numberOfVariables();++v) {
+                     const size_t varIndex=(*gm_)[f].variableIndex(v);
                      if(stateBuffer[v]!=movemaker_.state(varIndex)) {
-                        for(ff=0;ff<gm_.numberOfFactors(varIndex);++ff) {
-                           isLocalOptimal[gm_.factorOfVariable(varIndex,ff)]=false;
+                        for(ff=0;ff<gm_->numberOfFactors(varIndex);++ff) {
+                           isLocalOptimal[gm_->factorOfVariable(varIndex,ff)]=false;
                         }
                      }
                   }
@@ -261,7 +275,7 @@ ICM<GM,ACC>::arg
 ) const
 {
    if(N==1) {
-      x.resize(gm_.numberOfVariables());
+      x.resize(gm_->numberOfVariables());
       for(size_t j=0; j<x.size(); ++j) {
          x[j] = movemaker_.state(j);
       }
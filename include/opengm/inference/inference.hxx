@@ -7,6 +7,7 @@
 #include <list>
 #include <limits>
 #include <exception>
+#include <algorithm>
 
 #include "opengm/opengm.hxx"
 
@@ -55,6 +56,8 @@ public:
 
    // member functions with default definition
    virtual void setStartingPoint(typename std::vector<LabelType>::const_iterator);
+   virtual InferenceTermination rebind(const GraphicalModelType&);
+   virtual InferenceTermination updateUnaries(const GraphicalModelType&);
    virtual InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
    virtual InferenceTermination args(std::vector<std::vector<LabelType> >&) const;
    virtual InferenceTermination marginal(const size_t, IndependentFactorType&) const;
@@ -64,6 +67,9 @@ public:
    InferenceTermination constrainedOptimum(std::vector<IndexType>&,std::vector<LabelType>&, std::vector<LabelType>&) const;
    InferenceTermination modeFromMarginal(std::vector<LabelType>&) const;
    InferenceTermination modeFromFactorMarginal(std::vector<LabelType>&) const;
+
+protected:
+   static void checkRebind(const GraphicalModelType&, const GraphicalModelType&);
 };
 
 /// \brief output a solution
@@ -88,6 +94,65 @@ Inference<GM, ACC>::setStartingPoint(
 ) 
 {}
    
+/// \brief bind the algorithm to another graphical model of the same structure
+///
+/// The new model must have the same variables, numbers of labels and factors
+/// (with the same variable indices) as the current one, only the function
+/// values may differ, e.g. the unaries of the next frame of a video.
+/// Algorithms that support this keep their allocated storage and use their
+/// current state (labeling, messages, dual variables) as a warm start for the
+/// next call of infer(). The model must outlive the algorithm.
+///
+/// \return NORMAL if the algorithm has been re-bound, UNKNOWN if it does not
+/// support re-binding (and has to be constructed anew)
+template<class GM, class ACC>
+inline InferenceTermination
+Inference<GM, ACC>::rebind(
+   const GraphicalModelType& gm
+)
+{
+   return UNKNOWN;
+}
+
+/// \brief bind the algorithm to a graphical model that differs from the
+/// current one only in the values of the first order factors
+///
+/// Like rebind, but algorithms may take the factors of higher order from the
+/// current model without reading them again. The default calls rebind.
+template<class GM, class ACC>
+inline InferenceTermination
+Inference<GM, ACC>::updateUnaries(
+   const GraphicalModelType& gm
+)
+{
+   return rebind(gm);
+}
+
+/// \brief throw a RuntimeError if two graphical models differ in structure
+template<class GM, class ACC>
+inline void
+Inference<GM, ACC>::checkRebind(
+   const GraphicalModelType& gm,
+   const GraphicalModelType& newGm
+)
+{
+   if(gm.numberOfVariables() != newGm.numberOfVariables()
+   || gm.numberOfFactors() != newGm.numberOfFactors()) {
+      throw RuntimeError("rebind: the structure of the graphical models differs.");
+   }
+   for(IndexType v = 0; v < gm.numberOfVariables(); ++v) {
+      if(gm.numberOfLabels(v) != newGm.numberOfLabels(v)) {
+         throw RuntimeError("rebind: the numbers of labels differ.");
+      }
+   }
+   for(IndexType f = 0; f < gm.numberOfFactors(); ++f) {
+      if(gm[f].numberOfVariables() != newGm[f].numberOfVariables()
+      || !std::equal(gm[f].variableIndicesBegin(), gm[f].variableIndicesEnd(), newGm[f].variableIndicesBegin())) {
+         throw RuntimeError("rebind: the variables of the factors differ.");
+      }
+   }
+}
+
 template<class GM, class ACC>
 inline InferenceTermination
 Inference<GM, ACC>::args(
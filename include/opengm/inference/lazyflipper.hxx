@@ -191,7 +191,7 @@ private:
    const bool flipMultiLabel(SubgraphForestNode); // ???
 
    const GraphicalModelType& gm_;
-   Adjacency variableAdjacency_;
+   const typename GraphicalModelType::AdjacencyType& variableAdjacency_;
    Movemaker<GraphicalModelType> movemaker_;
    Tagging<bool> activation_[2];
    SubgraphForest subgraphForest_;
@@ -593,7 +593,7 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    const Tribool useMultilabelInference
 )
 :  gm_(gm),
-   variableAdjacency_(Adjacency(gm.numberOfVariables())),
+   variableAdjacency_(gm.variableAdjacency()),
    movemaker_(Movemaker<GM>(gm)),
    subgraphForest_(SubgraphForest()),
    maxSubgraphSize_(maxSubgraphSize),
@@ -606,15 +606,6 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    // initialize activation_
    activation_[0].append(gm_.numberOfVariables());
    activation_[1].append(gm_.numberOfVariables());
-   // initialize variableAdjacency_
-   for(size_t j=0; j<gm_.numberOfFactors(); ++j) {
-      const FactorType& factor = gm_[j];
-      for(size_t m=0; m<factor.numberOfVariables(); ++m) {
-         for(size_t n=m+1; n<factor.numberOfVariables(); ++n) {
-            variableAdjacency_.connect(factor.variableIndex(m), factor.variableIndex(n));
-         }
-      }
-   }
 }
 
 template<class GM, class ACC>
@@ -624,7 +615,7 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    typename LazyFlipper::Parameter param
 )
 :  gm_(gm),
-   variableAdjacency_(Adjacency(gm.numberOfVariables())),
+   variableAdjacency_(gm.variableAdjacency()),
    movemaker_(Movemaker<GM>(gm)),
    subgraphForest_(SubgraphForest()),
    maxSubgraphSize_(param.maxSubgraphSize_),
@@ -637,15 +628,6 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    // initialize activation_
    activation_[0].append(gm_.numberOfVariables());
    activation_[1].append(gm_.numberOfVariables());
-   // initialize variableAdjacency_
-   for(size_t j=0; j<gm_.numberOfFactors(); ++j) {
-      const FactorType& factor = gm_[j];
-      for(size_t m=0; m<factor.numberOfVariables(); ++m) {
-         for(size_t n=m+1; n<factor.numberOfVariables(); ++n) {
-            variableAdjacency_.connect(factor.variableIndex(m), factor.variableIndex(n));
-         }
-      }
-   }
    if(param.startingPoint_.size() == gm_.numberOfVariables()) {
       movemaker_.initialize(param.startingPoint_.begin());
    }
@@ -667,7 +649,7 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    const Tribool useMultilabelInference
 )
 :  gm_(gm),
-   variableAdjacency_(Adjacency(gm_.numberOfVariables())),
+   variableAdjacency_(gm_.variableAdjacency()),
    movemaker_(Movemaker<GM>(gm, it)),
    subgraphForest_(SubgraphForest()),
    maxSubgraphSize_(2),
@@ -680,15 +662,6 @@ LazyFlipper<GM, ACC>::LazyFlipper(
    // initialize activation_
    activation_[0].append(gm_.numberOfVariables());
    activation_[1].append(gm_.numberOfVariables());
-   // initialize variableAdjacency_
-   for(size_t j=0; j<gm_.numberOfFactors(); ++j) {
-      const FactorType& factor = gm_[j];
-      for(size_t m=0; m<factor.numberOfVariables(); ++m) {
-         for(size_t n=m+1; n<factor.numberOfVariables(); ++n) {
-            variableAdjacency_.connect(factor.variableIndex(m), factor.variableIndex(n));
-         }
-      }
-   }
 }
 
 template<class GM, class ACC>
@@ -1014,7 +987,7 @@ LazyFlipper<GM, ACC>::appendVariableToPath(
    {
       SubgraphForestNode q = p;
       while(q != NONODE) {
-         for(Adjacency::const_iterator it = variableAdjacency_.neighborsBegin(subgraphForest_.value(q));
+         for(typename GraphicalModelType::AdjacencyType::const_iterator it = variableAdjacency_.neighborsBegin(subgraphForest_.value(q));
             it != variableAdjacency_.neighborsEnd(subgraphForest_.value(q)); ++it) {
                candidateVariableIndices.insert(*it);
          }
@@ -1134,7 +1107,7 @@ LazyFlipper<GM, ACC>::activateInfluencedVariables(
    OPENGM_ASSERT(activationListIndex < 2);
    while(p != NONODE) {
       activation_[activationListIndex].tag(subgraphForest_.value(p), true);
-      for(Adjacency::const_iterator it = variableAdjacency_.neighborsBegin(subgraphForest_.value(p));
+      for(typename GraphicalModelType::AdjacencyType::const_iterator it = variableAdjacency_.neighborsBegin(subgraphForest_.value(p));
          it != variableAdjacency_.neighborsEnd(subgraphForest_.value(p)); ++it) {
             activation_[activationListIndex].tag(*it, true);
       }
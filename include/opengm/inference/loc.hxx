@@ -11,11 +11,14 @@
 #include <cmath>
 #include <queue>
 #include <deque>
+#include <numeric>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 #include "opengm/opengm.hxx"
 #include "opengm/utilities/random.hxx"
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/movemaker.hxx"
-#include "opengm/inference/external/ad3.hxx"
 
 #include <cmath>
 #include <algorithm>
@@ -29,12 +32,14 @@
 #include "opengm/inference/dynamicprogramming.hxx"
 #include "opengm/inference/astar.hxx"
 #include "opengm/inference/lazyflipper.hxx"
+#include "opengm/inference/admm.hxx"
 #include <opengm/inference/messagepassing/messagepassing.hxx>
 #include "opengm/inference/visitors/visitors.hxx"
 
-// external (autoinc)
-#include "opengm/inference/external/ad3.hxx"
 // external (inclued by with)
+#ifdef WITH_AD3
+#include "opengm/inference/external/ad3.hxx"
+#endif
 #ifdef WITH_CPLEX
 #include "opengm/inference/lpcplex.hxx"
 #endif
@@ -48,6 +53,10 @@ namespace opengm {
 /// truncated geometric distribution by hand. Depending on the size of
 /// the subgraph, either A* or exhaustive search is used for MAP 
 /// estimation on the subgraph 
+///
+/// With more than one thread, each round selects several regions that are
+/// separated by at least one variable and optimizes them concurrently. No
+/// factor connects two such regions, so their moves are committed together.
 /// \ingroup inference 
 template<class GM, class ACC>
 class LOC : public Inference<GM, ACC> {
@@ -64,19 +73,24 @@ public:
 
    typedef SubmodelOptimizer<GM,ACC> SubOptimizer;
    typedef typename SubOptimizer::SubGmType SubGmType;
+   typedef typename SubOptimizer::MergedSubGmType MergedSubGmType;
 
    // subsolvers 
    
    typedef opengm::DynamicProgramming<SubGmType,AccumulationType> DpSubInf;
    typedef opengm::AStar<SubGmType,AccumulationType> AStarSubInf;
-   typedef opengm::LazyFlipper<SubGmType,AccumulationType> LfSubInf;
+   typedef opengm::LazyFlipper<MergedSubGmType,AccumulationType> LfSubInf;
    typedef opengm::BeliefPropagationUpdateRules<SubGmType,AccumulationType> UpdateRulesTypeBp;
    typedef opengm::TrbpUpdateRules<SubGmType,AccumulationType> UpdateRulesTypeTrbp;
    typedef opengm::MessagePassing<SubGmType, AccumulationType,UpdateRulesTypeBp  , opengm::MaxDistance> BpSubInf;
    typedef opengm::MessagePassing<SubGmType, AccumulationType,UpdateRulesTypeTrbp, opengm::MaxDistance> TrBpSubInf;
 
-   // external (autoincluded)
+   typedef opengm::ADMM<MergedSubGmType,AccumulationType> AdmmSubInf;
+
+   // external
+   #ifdef WITH_AD3
    typedef opengm::external::AD3Inf<SubGmType,AccumulationType> Ad3SubInf;
+   #endif
    #ifdef WITH_CPLEX
    typedef opengm::LPCplex<SubGmType,AccumulationType> LpCplexSubInf;
    #endif
@@ -90,6 +104,8 @@ public:
       /// \param maxIteration maximum number of iterations (in one iteration on subgraph gets) optimized
       /// \param ad3Threshold if the subgraph size is bigger than ad3Threshold opengm::external::Ad3Inf is used to optimize the subgraphes
       /// \param stopAfterNBadIterations stop after n iterations without improvement
+      /// \param numberOfThreads number of threads optimizing separated regions concurrently (1 = sequential, 0 = one per core)
+      /// \param seed seed of the random radii and of the random order in which trees are grown
       Parameter
       (
          const std::string solver="ad3",
@@ -101,7 +117,9 @@ public:
          const size_t stopAfterNBadIterations=10000,
          const size_t maxBlockSize = 0,
          const size_t maxTreeSize     =0,
-         const int treeRuns        =1
+         const int treeRuns        =1,
+         const size_t numberOfThreads = 1,
+         const size_t seed = 0
       )
       :  solver_(solver),
          phi_(phi),
@@ -111,11 +129,15 @@ public:
          maxIterations_(maxIterations),
          stopAfterNBadIterations_(stopAfterNBadIterations),
          maxBlockSize_(maxBlockSize),
-         treeRuns_(treeRuns)
+         maxTreeSize_(maxTreeSize),
+         treeRuns_(treeRuns),
+         numberOfThreads_(numberOfThreads),
+         seed_(seed)
       {
 
       }
-      // subsolver used for submodel ("ad3" or "astar" so far)
+      // subsolver used for submodel ("ad3", "admm", "cplex" or "lf<n>"),
+      // "ad3" (exact AD3_ILP) needs WITH_AD3, "admm" is an LP relaxation with rounding
       std::string solver_;
       /// phi of the truncated geometric distribution is used to select a certain subgraph radius with a certain probability
       double phi_;
@@ -134,6 +156,11 @@ public:
       size_t maxBlockSize_;
       size_t maxTreeSize_;
       int treeRuns_;
+      /// number of threads optimizing separated regions concurrently (1 = sequential, 0 = one per core)
+      size_t numberOfThreads_;
+      /// seed of the counter-based random numbers, for a fixed number of threads
+      /// equal seeds yield equal results
+      size_t seed_;
    };
 
    LOC(const GraphicalModelType&, const Parameter& param = Parameter());
@@ -192,16 +219,63 @@ public:
 
 
 private:
-   void getSubgraphVis(const size_t, const size_t, std::vector<size_t>&);
-   void getSubgraphTreeVis(const size_t, const size_t, std::vector<size_t>&);
+   /// buffers for growing regions. Only the entries touched by the last
+   /// region are reset, each worker of the concurrent mode owns one.
+   struct RegionBuffer {
+      RegionBuffer(const size_t numberOfVariables = 0, const CounterBasedRandom& random = CounterBasedRandom())
+      :  usedVi_(numberOfVariables, false),
+         checkedVi_(numberOfVariables, false),
+         inRegion_(numberOfVariables, false),
+         distance_(numberOfVariables, 0),
+         random_(random)
+      {}
+      void touch(const size_t vi) {
+         touched_.push_back(vi);
+      }
+      void reset() {
+         for(size_t j = 0; j < touched_.size(); ++j) {
+            usedVi_[touched_[j]] = false;
+            checkedVi_[touched_[j]] = false;
+            distance_[touched_[j]] = 0;
+         }
+         touched_.clear();
+         queue_.clear();
+      }
+      std::vector<bool> usedVi_;
+      std::vector<bool> checkedVi_;
+      std::vector<bool> inRegion_;
+      std::vector<UInt64Type> distance_;
+      std::vector<size_t> touched_;
+      std::deque<size_t> queue_;
+      std::vector<size_t> adjacentVis_;
+      CounterBasedRandom random_;
+   };
+   struct AnyVariable {
+      bool operator()(const size_t) const { return true; }
+   };
+   /// variables whose mark equals allowed
+   struct MaskedVariables {
+      MaskedVariables(const std::vector<bool>& mask, const bool allowed)
+      :  mask_(mask), allowed_(allowed) {}
+      bool operator()(const size_t vi) const { return mask_[vi] == allowed_; }
+      const std::vector<bool>& mask_;
+      bool allowed_;
+   };
+
+   template<class ALLOWED>
+      void getSubgraphVis(const size_t, const size_t, std::vector<size_t>&, RegionBuffer&, const ALLOWED&) const;
+   template<class ALLOWED>
+      void getSubgraphTreeVis(const size_t, const size_t, std::vector<size_t>&, RegionBuffer&, const ALLOWED&) const;
    void inline initializeProbabilities(std::vector<double>&,const size_t maxRadius);
+   template<class VisitorType>
+      void inferConcurrent(VisitorType&, CounterBasedRandom&, const std::vector<double>&, const std::vector<double>&);
+   bool optimizeRegion(SubOptimizer&, RegionBuffer&, const size_t, const std::vector<size_t>&, const std::vector<size_t>&, const size_t, std::vector<LabelType>&) const;
+   bool solveSubmodel(SubOptimizer&, const std::vector<size_t>&, const bool, std::vector<LabelType>&) const;
    const GraphicalModelType& gm_;
    MovemakerType movemaker_;
    Parameter param_;
-   std::vector< RandomAccessSet<IndexType> > viAdjacency_;
-   std::vector<bool> usedVi_;
-   std::vector<bool> checkedVi_;
-   std::vector<UInt64Type> distance_;
+   const typename GraphicalModelType::AdjacencyType& viAdjacency_;
+   RegionBuffer buffer_;
 
 
    // submodel
@@ -224,16 +298,12 @@ LOC<GM, ACC>::LOC
 :  gm_(gm),
    movemaker_(gm),
    param_(parameter),
-   viAdjacency_(gm.numberOfVariables()),
-   usedVi_(gm.numberOfVariables(), false),
-   checkedVi_(gm.numberOfVariables(), false),
-   distance_(gm.numberOfVariables()), 
+   viAdjacency_(gm.variableAdjacency()),
+   buffer_(gm.numberOfVariables()),
    subOptimizer_(gm),
    cleanRegion_(gm.numberOfVariables(),false)
 {
 
-   // compute variable adjacency
-   gm.variableAdjacencyList(viAdjacency_);
    if(this->param_.maxIterations_==0)
       param_.maxIterations_ = gm_.numberOfVariables() * 
          log(double(gm_.numberOfVariables()))*log(double(gm_.numberOfVariables()));
@@ -244,7 +314,7 @@ void
 LOC<GM, ACC>::reset()
 {
    movemaker_.reset();
-   std::fill(usedVi_.begin(),usedVi_.end(),false);
+   buffer_.reset();
    // compute variable adjacency is not nessesary
    // since reset assumes that the structure of
    // the graphical model has not changed
@@ -304,38 +374,41 @@ LOC<GM, ACC>::graphicalModel() const {
 }
 
 template<class GM, class ACC>
+template<class ALLOWED>
 void LOC<GM, ACC>::getSubgraphVis
 (
    const size_t startVi,
    const size_t radius,
-   std::vector<size_t>& vis
-) {
-   std::fill(usedVi_.begin(),usedVi_.end(),false);
+   std::vector<size_t>& vis,
+   RegionBuffer& buffer,
+   const ALLOWED& allowed
+) const {
+   buffer.reset();
    vis.clear();
    vis.push_back(startVi);
-   usedVi_[startVi]=true;
-   std::queue<size_t> viQueue;
-   viQueue.push(startVi);
-
-   std::fill(distance_.begin(),distance_.begin()+gm_.numberOfVariables(),0);
+   buffer.usedVi_[startVi]=true;
+   buffer.touch(startVi);
+   std::deque<size_t>& viQueue = buffer.queue_;
+   viQueue.push_back(startVi);
 
    const size_t maxSgSize = (param_.maxBlockSize_==0? gm_.numberOfVariables() :param_.maxBlockSize_);
    while(viQueue.size()!=0  &&  vis.size()<=maxSgSize) {
       size_t cvi=viQueue.front();
-      viQueue.pop();
+      viQueue.pop_front();
       // for each neigbour of cvi
       for(size_t vni=0;vni<viAdjacency_[cvi].size();++vni) {
          // if neighbour has not been visited
          const size_t vn=viAdjacency_[cvi][vni];
-         if(usedVi_[vn]==false) {
+         if(buffer.usedVi_[vn]==false && allowed(vn)) {
             // set as visited
-            usedVi_[vn]=true;
+            buffer.usedVi_[vn]=true;
+            buffer.touch(vn);
             // insert into the subgraph vis
-            distance_[vn]=distance_[cvi]+1;
-            if(distance_[vn]<=radius){
+            buffer.distance_[vn]=buffer.distance_[cvi]+1;
+            if(buffer.distance_[vn]<=radius){
                if(vis.size()<maxSgSize){
                   vis.push_back(vn);
-                  viQueue.push(vn);
+                  viQueue.push_back(vn);
                }
                else{
                   break;
@@ -348,39 +421,39 @@ void LOC<GM, ACC>::getSubgraphVis
 
 
 template<class GM, class ACC>
+template<class ALLOWED>
 void LOC<GM, ACC>::getSubgraphTreeVis
 (
    const size_t startVi,
    const size_t radius,
-   std::vector<size_t>& vis
-) {
+   std::vector<size_t>& vis,
+   RegionBuffer& buffer,
+   const ALLOWED& allowed
+) const {
 
    //std::cout<<"build tree\n";
-   std::fill(usedVi_.begin(),usedVi_.end(),false);
-   std::fill(checkedVi_.begin(),checkedVi_.end(),false);
+   buffer.reset();
    vis.clear();
    vis.push_back(startVi);
-   usedVi_[startVi]=true;
-   checkedVi_[startVi]=true;
-   std::deque<IndexType> viQueue;
+   buffer.usedVi_[startVi]=true;
+   buffer.checkedVi_[startVi]=true;
+   buffer.touch(startVi);
+   std::deque<size_t>& viQueue = buffer.queue_;
    viQueue.push_back(startVi);
 
    bool first=true;
    const size_t maxSgSize = (param_.maxTreeSize_==0? gm_.numberOfVariables() :param_.maxTreeSize_);
 
-   std::fill(distance_.begin(),distance_.begin()+gm_.numberOfVariables(),0);
-   //std::fill(distance_.begin(),distance_.begin()+vis.size(),0);
-
    while(viQueue.size()!=0 && /*r<radius &&*/  vis.size()<=maxSgSize) {
       IndexType cvi=viQueue.front();
 
-      OPENGM_CHECK(usedVi_[cvi]==false || vis.size()==1,"");
+      OPENGM_CHECK(buffer.usedVi_[cvi]==false || vis.size()==1,"");
       
 
       //std::cout<<"cvi "<<cvi<<" size "<<viQueue.size()<<" vis size "<<vis.size()<<"\n";
       viQueue.pop_front();
 
-      if(checkedVi_[cvi]==true && first ==false){
+      if(buffer.checkedVi_[cvi]==true && first ==false){
          continue;
       }
       first=false;
@@ -389,49 +462,48 @@ void LOC<GM, ACC>::getSubgraphTreeVis
       // for each neigbour of cvi
       for(size_t vni=0;vni<viAdjacency_[cvi].size();++vni) {
          const IndexType vn=viAdjacency_[cvi][vni];
-         if(usedVi_[vn]==true) {
+         if(buffer.usedVi_[vn]==true) {
             ++includeInTree;
          }
       }
       //std::cout<<"inlcuded in tree "<<includeInTree<<"\n";
       OPENGM_CHECK_OP(includeInTree,<=,vis.size(),"");
       //OPENGM_CHECK_OP(includeInTree,<=,2,"");
-      checkedVi_[cvi]=true;
+      buffer.checkedVi_[cvi]=true;
+      buffer.touch(cvi);
       //std::cout<<"icn in tree "<<includeInTree<<"\n";
       OPENGM_CHECK(includeInTree>0 || (vis.size()==1 && includeInTree==0),"");
       //if (usedVi_[cvi]==false && includeInTree<=1){
       if (includeInTree<=1){
          //std::cout<<"in 1....\n";
          // insert into the subgraph vis
-         if(usedVi_[cvi]==false){
+         if(buffer.usedVi_[cvi]==false){
             vis.push_back(cvi);
              // set as visited
-            usedVi_[cvi]=true;
+            buffer.usedVi_[cvi]=true;
 
             if(vis.size()>=maxSgSize){
                //std::cout<<"max size exit\n";
             }
          }
 
-         std::vector<IndexType> adjVis(viAdjacency_[cvi].size());
-         for(size_t vni=0;vni<viAdjacency_[cvi].size();++vni) {
-            const size_t vn=viAdjacency_[cvi][vni];
-            adjVis[vni]=vn;
-         }
-         std::random_shuffle(adjVis.begin(),adjVis.end());
+         std::vector<size_t>& adjVis = buffer.adjacentVis_;
+         adjVis.assign(viAdjacency_[cvi].begin(), viAdjacency_[cvi].end());
+         std::shuffle(adjVis.begin(),adjVis.end(),buffer.random_);
          
          // for each neigbour of cvi
-         for(size_t vni=0;vni<viAdjacency_[cvi].size();++vni) {
+         for(size_t vni=0;vni<adjVis.size();++vni) {
             //std::cout<<"hello\n";
             // if neighbour has not been visited
             const size_t vn=adjVis[vni];
             //std::cout<<"in 2....\n";
-            if(usedVi_[vn]==false && checkedVi_[vn]==false) {
+            if(buffer.usedVi_[vn]==false && buffer.checkedVi_[vn]==false && allowed(vn)) {
                //std::cout<<"in 3....\n";
                // insert into queue
 
-               distance_[vn]=distance_[cvi]+1;
-               if(distance_[vn]<=radius)
+               buffer.distance_[vn]=buffer.distance_[cvi]+1;
+               buffer.touch(vn);
+               if(buffer.distance_[vn]<=radius)
                   viQueue.push_back(vn);
             }
          }
@@ -464,20 +536,18 @@ LOC<GM, ACC>::infer
 
 
    visitor.begin(*this);
-   // create random generators
-   opengm::RandomUniform<size_t> randomVariable(0, gm_.numberOfVariables());
-   opengm::RandomUniform<double> random01(0.0, 1.0);
+   // create random generators, the radii are drawn from the cumulative distributions
+   CounterBasedRandom random(param_.seed_);
+   buffer_.random_ = random.split(0);
 
    std::vector<double> probBlock,probTree;
-   opengm::RandomDiscreteWeighted<size_t, double> randomRadiusBlock,randomRadiusTree;
-
    if(useBlocks){
       this->initializeProbabilities(probBlock,param_.maxBlockRadius_);
-      randomRadiusBlock =opengm::RandomDiscreteWeighted<size_t, double> (probBlock.begin(),   probBlock.end());
+      std::partial_sum(probBlock.begin(), probBlock.end(), probBlock.begin());
    }
    if(useTrees){
       this->initializeProbabilities(probTree,param_.maxTreeRadius_);
-      randomRadiusTree= opengm::RandomDiscreteWeighted<size_t, double> (probTree.begin(), probTree.end());
+      std::partial_sum(probTree.begin(), probTree.end(), probTree.begin());
    }
    
   
@@ -494,6 +564,11 @@ LOC<GM, ACC>::infer
       subOptimizer_.setLabel(vi,movemaker_.state(vi));
    }
 
+   if(param_.numberOfThreads_!=1){
+      this->inferConcurrent(visitor, random, probBlock, probTree);
+      visitor.end(*this);
+      return NORMAL;
+   }
 
    for(IndexType run=0;run<2;++run){
       std::vector<bool> coverdVar(gm_.numberOfVariables(),false);
@@ -502,8 +577,8 @@ LOC<GM, ACC>::infer
          if(coverdVar[vi]==false){
             size_t viStart = vi;
              // select random radius block and tree
-            size_t radiusBlock   = (useBlocks ? randomRadiusBlock()+1 : 0);
-            size_t radiusTree    = (useTrees  ? randomRadiusTree()+1  : 0);
+            size_t radiusBlock   = (useBlocks ? random.categorical(probBlock.begin(), probBlock.end())+1 : 0);
+            size_t radiusTree    = (useTrees  ? random.categorical(probTree.begin(), probTree.end())+1  : 0);
 
 
             //std::cout<<"viStart "<<viStart<<" rt "<<radiusTree<<" rb "<<radiusBlock<<"\n";
@@ -515,7 +590,7 @@ LOC<GM, ACC>::infer
                   //std::cout<<"get'n optimize tree model\n";
                   if(param_.treeRuns_>0){
                      for(size_t tr=0;tr<(size_t)(param_.treeRuns_);++tr){
-                        this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                        this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                         std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                         optimizeSubmodel(subgGraphViTree,true);
                      }
@@ -524,11 +599,11 @@ LOC<GM, ACC>::infer
                      size_t nTr=(param_.treeRuns_==0? 1: std::abs(param_.treeRuns_));
                      bool changes=true;
                      while(changes){
-                        this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                        this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                         std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                         changes=false;
                         for(size_t tr=0;tr<nTr;++tr){
-                           this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                           this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                            std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                            bool c=optimizeSubmodel(subgGraphViTree,true);
                            if(c){
@@ -540,7 +615,7 @@ LOC<GM, ACC>::infer
             }
             //std::cout<<"bevore block "<<movemaker_.value()<<"\n";
             if(useBlocks){
-               this->getSubgraphVis(viStart, radiusBlock, subgGraphViBLock);
+               this->getSubgraphVis(viStart, radiusBlock, subgGraphViBLock, buffer_, AnyVariable());
                std::sort(subgGraphViBLock.begin(), subgGraphViBLock.end());
                optimizeSubmodel(subgGraphViBLock,false);
 
@@ -562,10 +637,10 @@ LOC<GM, ACC>::infer
       //std::cout<<i<<" "<<param_.maxIterations_<<"\n";
 
       // select random variable
-      size_t viStart = randomVariable();
+      size_t viStart = random.uniformInteger(static_cast<size_t>(gm_.numberOfVariables()));
       // select random radius block and tree
-      size_t radiusBlock   = (useBlocks ? randomRadiusBlock()+1 : 0);
-      size_t radiusTree    = (useTrees  ? randomRadiusTree()+1  : 0);
+      size_t radiusBlock   = (useBlocks ? random.categorical(probBlock.begin(), probBlock.end())+1 : 0);
+      size_t radiusTree    = (useTrees  ? random.categorical(probTree.begin(), probTree.end())+1  : 0);
 
 
       //std::cout<<"viStart "<<viStart<<" rt "<<radiusTree<<" rb "<<radiusBlock<<"\n";
@@ -577,7 +652,7 @@ LOC<GM, ACC>::infer
             //std::cout<<"get'n optimize tree model\n";
             if(param_.treeRuns_>0){
                for(size_t tr=0;tr<(size_t)(param_.treeRuns_);++tr){
-                  this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                  this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                   std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                   optimizeSubmodel(subgGraphViTree,true);
                }
@@ -586,11 +661,11 @@ LOC<GM, ACC>::infer
                size_t nTr=(param_.treeRuns_==0? 1: std::abs(param_.treeRuns_));
                bool changes=true;
                while(changes){
-                  this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                  this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                   std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                   changes=false;
                   for(size_t tr=0;tr<nTr;++tr){
-                     this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree);
+                     this->getSubgraphTreeVis(viStart, radiusTree, subgGraphViTree, buffer_, AnyVariable());
                      std::sort(subgGraphViTree.begin(), subgGraphViTree.end());
                      bool c=optimizeSubmodel(subgGraphViTree,true);
                      if(c){
@@ -602,7 +677,7 @@ LOC<GM, ACC>::infer
       }
       //std::cout<<"bevore block "<<movemaker_.value()<<"\n";
       if(useBlocks){
-            this->getSubgraphVis(viStart, radiusBlock, subgGraphViBLock);
+            this->getSubgraphVis(viStart, radiusBlock, subgGraphViBLock, buffer_, AnyVariable());
             std::sort(subgGraphViBLock.begin(), subgGraphViBLock.end());
             optimizeSubmodel(subgGraphViBLock,false);
       }
@@ -618,36 +693,281 @@ LOC<GM, ACC>::infer
    return NORMAL;
 }
 
+template<class GM, class ACC>
+template<class VisitorType>
+void LOC<GM, ACC>::inferConcurrent
+(
+   VisitorType& visitor,
+   CounterBasedRandom& random,
+   const std::vector<double>& probBlock,
+   const std::vector<double>& probTree
+) {
+   const bool useTrees  = param_.maxTreeRadius_  > 0;
+   const bool useBlocks = param_.maxBlockRadius_ > 0;
+   #ifdef WITH_OPENMP
+   const int nThreads = param_.numberOfThreads_ > 0 ? static_cast<int>(param_.numberOfThreads_) : omp_get_max_threads();
+   #else
+   const int nThreads = 1;
+   #endif
+   const size_t regionsPerRound = 4 * static_cast<size_t>(nThreads);
+
+   // submodel optimizer and region buffers of each worker
+   std::vector<SubOptimizer> optimizers(nThreads, subOptimizer_);
+   std::vector<RegionBuffer> buffers;
+   for(int t=0;t<nThreads;++t){
+      buffers.push_back(RegionBuffer(gm_.numberOfVariables()));
+   }
+
+   std::vector<size_t> seeds(regionsPerRound);
+   std::vector<size_t> treeRadii(regionsPerRound);
+   std::vector<std::vector<size_t> > regions(regionsPerRound);
+   std::vector<std::vector<size_t> > blocks(regionsPerRound);
+   std::vector<std::vector<LabelType> > labels(regionsPerRound);
+   std::vector<unsigned char> changed(regionsPerRound);
+   // regions of a round and their neighbours
+   std::vector<bool> blocked(gm_.numberOfVariables(),false);
+   std::vector<size_t> blockedVis;
+
+   std::vector<size_t> seedQueue, deferred;
+   bool stop=false;
+   for(IndexType run=0;run<2 && !stop;++run){
+      std::vector<bool> coverdVar(gm_.numberOfVariables(),false);
+      seedQueue.resize(gm_.numberOfVariables());
+      for(IndexType vi=0;vi<gm_.numberOfVariables();++vi){
+         seedQueue[vi]=vi;
+      }
+      while(!seedQueue.empty() && !stop){
+         // select regions that are separated by at least one variable, seeds
+         // whose region touches a selected region are deferred to the next round
+         size_t numberOfRegions=0;
+         size_t s=0;
+         for(;s<seedQueue.size() && numberOfRegions<regionsPerRound;++s){
+            const size_t vi=seedQueue[s];
+            if(coverdVar[vi]){
+               continue;
+            }
+            if(blocked[vi]){
+               deferred.push_back(vi);
+               continue;
+            }
+            // the region contains the block and all trees of the seed
+            const size_t radiusBlock = (useBlocks ? random.categorical(probBlock.begin(), probBlock.end())+1 : 0);
+            const size_t radiusTree  = (useTrees  ? random.categorical(probTree.begin(), probTree.end())+1  : 0);
+            std::vector<size_t>& region = regions[numberOfRegions];
+            this->getSubgraphVis(vi, std::max(radiusBlock, radiusTree), region, buffer_, AnyVariable());
+            bool separated=true;
+            for(size_t j=0;j<region.size() && separated;++j){
+               separated=!blocked[region[j]];
+            }
+            if(!separated){
+               deferred.push_back(vi);
+               continue;
+            }
+            std::sort(region.begin(), region.end());
+            std::vector<size_t>& block = blocks[numberOfRegions];
+            if(radiusBlock<radiusTree){
+               this->getSubgraphVis(vi, radiusBlock, block, buffer_, AnyVariable());
+               std::sort(block.begin(), block.end());
+            }
+            else{
+               block=region;
+            }
+            for(size_t j=0;j<block.size();++j){
+               coverdVar[block[j]]=true;
+            }
+            for(size_t j=0;j<region.size();++j){
+               const size_t rvi=region[j];
+               if(!blocked[rvi]){
+                  blocked[rvi]=true;
+                  blockedVis.push_back(rvi);
+               }
+               for(size_t n=0;n<viAdjacency_[rvi].size();++n){
+                  const size_t vn=viAdjacency_[rvi][n];
+                  if(!blocked[vn]){
+                     blocked[vn]=true;
+                     blockedVis.push_back(vn);
+                  }
+               }
+            }
+            seeds[numberOfRegions]=vi;
+            treeRadii[numberOfRegions]=radiusTree;
+            ++numberOfRegions;
+         }
+         deferred.insert(deferred.end(), seedQueue.begin()+s, seedQueue.end());
+         seedQueue.swap(deferred);
+         deferred.clear();
+
+         // optimize the regions concurrently
+         bool error=false;
+         std::string message;
+         #ifdef WITH_OPENMP
+         #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+         #endif
+         for(std::ptrdiff_t r=0;r<static_cast<std::ptrdiff_t>(numberOfRegions);++r){
+            #ifdef WITH_OPENMP
+            const int t=omp_get_thread_num();
+            #else
+            const int t=0;
+            #endif
+            try{
+               // the trees of a region are grown in an order that does not depend on the thread
+               buffers[t].random_ = random.split(run * gm_.numberOfVariables() + seeds[r] + 1);
+               changed[r]=this->optimizeRegion(optimizers[t], buffers[t], seeds[r], regions[r], blocks[r], treeRadii[r], labels[r]);
+            }
+            catch(std::exception& e){
+               #ifdef WITH_OPENMP
+               #pragma omp critical(opengm_loc_error)
+               #endif
+               {
+                  error=true;
+                  message=e.what();
+               }
+            }
+         }
+         if(error){
+            throw RuntimeError(message);
+         }
+
+         // commit the moves, no factor connects two regions
+         for(size_t r=0;r<numberOfRegions;++r){
+            if(changed[r]){
+               movemaker_.move(regions[r].begin(), regions[r].end(), labels[r].begin());
+               for(size_t j=0;j<regions[r].size();++j){
+                  const size_t rvi=regions[r][j];
+                  subOptimizer_.setLabel(rvi,movemaker_.state(rvi));
+                  for(int t=0;t<nThreads;++t){
+                     optimizers[t].setLabel(rvi,movemaker_.state(rvi));
+                  }
+               }
+            }
+         }
+         for(size_t j=0;j<blockedVis.size();++j){
+            blocked[blockedVis[j]]=false;
+         }
+         blockedVis.clear();
+         if(visitor(*this)!=visitors::VisitorReturnFlag::ContinueInf){
+            stop=true;
+         }
+      }
+   }
+}
+
+/// optimizes trees within the region and then the block, which is a subset
+/// of the region. The labeling of the region is written to labels, the labels
+/// of the region in the optimizer are updated, the movemaker is not changed.
+template<class GM, class ACC>
+bool LOC<GM, ACC>::optimizeRegion
+(
+   SubOptimizer& optimizer,
+   RegionBuffer& buffer,
+   const size_t seed,
+   const std::vector<size_t>& region,
+   const std::vector<size_t>& block,
+   const size_t treeRadius,
+   std::vector<LabelType>& labels
+) const {
+   labels.resize(region.size());
+   for(size_t j=0;j<region.size();++j){
+      labels[j]=movemaker_.state(region[j]);
+   }
+   bool changed=false;
+   std::vector<LabelType> states;
+   if(treeRadius>0){
+      for(size_t j=0;j<region.size();++j){
+         buffer.inRegion_[region[j]]=true;
+      }
+      std::vector<size_t> tree;
+      const size_t nTr=(param_.treeRuns_==0? 1: std::abs(param_.treeRuns_));
+      bool changes=true;
+      while(changes){
+         changes=false;
+         for(size_t tr=0;tr<nTr;++tr){
+            this->getSubgraphTreeVis(seed, treeRadius, tree, buffer, MaskedVariables(buffer.inRegion_,true));
+            std::sort(tree.begin(), tree.end());
+            if(this->solveSubmodel(optimizer, tree, true, states)){
+               changes=true;
+               for(size_t j=0;j<tree.size();++j){
+                  optimizer.setLabel(tree[j],states[j]);
+                  labels[std::lower_bound(region.begin(), region.end(), tree[j])-region.begin()]=states[j];
+               }
+            }
+         }
+         changed = changed || changes;
+         if(param_.treeRuns_>0){
+            break;
+         }
+      }
+      for(size_t j=0;j<region.size();++j){
+         buffer.inRegion_[region[j]]=false;
+      }
+   }
+   if(param_.maxBlockRadius_>0 && this->solveSubmodel(optimizer, block, false, states)){
+      changed=true;
+      for(size_t j=0;j<block.size();++j){
+         optimizer.setLabel(block[j],states[j]);
+         labels[std::lower_bound(region.begin(), region.end(), block[j])-region.begin()]=states[j];
+      }
+   }
+   return changed;
+}
+
 template<class GM, class ACC>
 bool LOC<GM, ACC>::optimizeSubmodel(std::vector<size_t> & subgGraphVi,const bool useTrees){
+   std::vector<LabelType> states;
+   const bool changes = this->solveSubmodel(subOptimizer_, subgGraphVi, useTrees, states);
+   if(changes){
+      movemaker_.move(subgGraphVi.begin(), subgGraphVi.end(), states.begin());
+      for(IndexType v=0;v<subgGraphVi.size();++v){
+         subOptimizer_.setLabel(subgGraphVi[v],movemaker_.state(subgGraphVi[v]));
+      }
+   }
+   return changes;
+}
+
+/// optimizes the submodel of the variables for the labels of the optimizer
+template<class GM, class ACC>
+bool LOC<GM, ACC>::solveSubmodel
+(
+   SubOptimizer& optimizer,
+   const std::vector<size_t>& subgGraphVi,
+   const bool useTrees,
+   std::vector<LabelType>& states
+) const {
 
    bool changes=false;
-   std::vector<LabelType> states;
    if(subgGraphVi.size()>2){
-      subOptimizer_.setVariableIndices(subgGraphVi.begin(), subgGraphVi.end());
+      optimizer.setVariableIndices(subgGraphVi.begin(), subgGraphVi.end());
 
 
       if (useTrees){
          //std::cout<<"infer with tres\n";
-         changes = subOptimizer_.mergeFactorsAndInferDp(states);
-         //changes = subOptimizer_. template inferSubmodel<BpSubInf>(typename BpSubInf::Parameter() ,states);
-         //changes = subOptimizer_. template inferSubmodel<DpSubInf>(typename DpSubInf::Parameter() ,states);
+         changes = optimizer.inferConditionedTreeDp(states);
+         //changes = optimizer. template inferSubmodel<BpSubInf>(typename BpSubInf::Parameter() ,states);
+         //changes = optimizer. template inferSubmodel<DpSubInf>(typename DpSubInf::Parameter() ,states);
          //std::cout<<"infer with tress\n";
       }
       // OPTIMAL OR MONOTON MOVERS
       else if(param_.solver_==std::string("ad3")){
-         changes = subOptimizer_. template inferSubmodelInplace<Ad3SubInf>(typename Ad3SubInf::Parameter(Ad3SubInf::AD3_ILP) ,states);
+         #ifdef WITH_AD3
+         changes = optimizer. template inferSubmodelInplace<Ad3SubInf>(typename Ad3SubInf::Parameter(Ad3SubInf::AD3_ILP) ,states);
+         #else
+            throw RuntimeError("solver ad3 needs flag WITH_AD3 defined bevore the #include of LOC sovler, use solver admm otherwise");
+         #endif
+      }
+      // LP relaxation with rounding, only improving moves are accepted
+      else if(param_.solver_==std::string("admm")){
+         changes = optimizer. template inferConditionedSubmodel<AdmmSubInf>(typename AdmmSubInf::Parameter() ,states,true,true);
       }
 
       else if (param_.solver_==std::string("astar")){
-         //changes = subOptimizer_. template inferSubmodel<AStarSubInf>(typename AStarSubInf::Parameter() ,states);
+         //changes = optimizer. template inferSubmodel<AStarSubInf>(typename AStarSubInf::Parameter() ,states);
       }
       else if (param_.solver_==std::string("cplex")){
          #ifdef WITH_CPLEX
             //typedef opengm::LPCplex<SubGmType,AccumulationType> LpCplexSubInf;
             typename LpCplexSubInf::Parameter subParam;
             subParam.integerConstraint_=true;
-            changes = subOptimizer_. template inferSubmodel<LpCplexSubInf>(subParam ,states); 
+            changes = optimizer. template inferSubmodel<LpCplexSubInf>(subParam ,states); 
          #else  
             throw RuntimeError("solver cplex needs flag WITH_CPLEX defined bevore the #include of LOC sovler");
          #endif  
@@ -660,17 +980,10 @@ bool LOC<GM, ACC>::optimizeSubmodel(std::vector<size_t> & subgGraphVi,const bool
          }
          size_t maxSgSize;
          ss>>maxSgSize;
-         changes = subOptimizer_. template inferSubmodel<LfSubInf>(typename LfSubInf::Parameter(maxSgSize) ,states,true,true);  
+         changes = optimizer. template inferConditionedSubmodel<LfSubInf>(typename LfSubInf::Parameter(maxSgSize) ,states,true,true);
       }
 
-      subOptimizer_.unsetVariableIndices();
-
-      if(changes){
-         movemaker_.move(subgGraphVi.begin(), subgGraphVi.end(), states.begin());
-         for(IndexType v=0;v<subgGraphVi.size();++v){
-            subOptimizer_.setLabel(subgGraphVi[v],movemaker_.state(subgGraphVi[v]));
-         }
-      }
+      optimizer.unsetVariableIndices();
    }
    else{
       // do nothing
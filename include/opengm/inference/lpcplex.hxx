@@ -158,6 +158,7 @@ public:
    virtual InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
    virtual InferenceTermination args(std::vector<std::vector<LabelType> >&) const 
       { return UNKNOWN; };
+   virtual void setStartingPoint(typename std::vector<LabelType>::const_iterator);
    void variable(const size_t, IndependentFactorType& out) const;     
    void factorVariable(const size_t, IndependentFactorType& out) const;
    typename GM::ValueType bound() const; 
@@ -520,6 +521,48 @@ LPCplex<GM, ACC>::infer
    return NORMAL;
 }
  
+/// \brief register a labeling as MIP start
+///
+/// The node and factor indicators of the labeling are passed to CPLEX, which
+/// uses them as initial incumbent if the integer constraints are enabled.
+template<class GM, class ACC>
+void LPCplex<GM, ACC>::setStartingPoint
+(
+   typename std::vector<typename LPCplex<GM, ACC>::LabelType>::const_iterator begin
+) {
+   try {
+      IloNumVarArray startVar(env_);
+      IloNumArray startVal(env_);
+      for(size_t node = 0; node < gm_.numberOfVariables(); ++node) {
+         for(LabelType i = 0; i < gm_.numberOfLabels(node); ++i) {
+            startVar.add(x_[idNodesBegin_[node]+i]);
+            startVal.add(begin[node] == i ? 1 : 0);
+         }
+      }
+      std::vector<LabelType> labeling;
+      for(size_t f = 0; f < gm_.numberOfFactors(); ++f) {
+         if(gm_[f].numberOfVariables() < 2) {
+            continue;
+         }
+         labeling.resize(gm_[f].numberOfVariables());
+         for(size_t i = 0; i < gm_[f].numberOfVariables(); ++i) {
+            labeling[i] = begin[gm_[f].variableIndex(i)];
+         }
+         const size_t active = lpFactorVi(f, labeling.begin(), labeling.end());
+         for(size_t i = 0; i < gm_[f].size(); ++i) {
+            startVar.add(x_[idFactorsBegin_[f]+i]);
+            startVal.add(idFactorsBegin_[f]+i == active ? 1 : 0);
+         }
+      }
+      cplex_.addMIPStart(startVar, startVal);
+      startVar.end();
+      startVal.end();
+   }
+   catch(IloCplex::Exception& e) {
+      throw std::runtime_error("CPLEX exception");
+   }
+}
+
 template <class GM, class ACC>
 LPCplex<GM, ACC>::~LPCplex() {
    env_.end();
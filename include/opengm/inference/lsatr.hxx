@@ -10,6 +10,7 @@
 #include "opengm/opengm.hxx"
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/utilities/random.hxx"
 
 #include <maxflowlib.h>
 
@@ -581,10 +582,10 @@ namespace opengm {
    template<class GM, class ACC>
    void LSA_TR<GM, ACC>::init()
    {
-      srand(param_.randSeed_);
+      CounterBasedRandom random(param_.randSeed_);
       numVar_ = gm_.numberOfVariables();
       curState_.resize(numVar_,1);
-      for (size_t i=0; i<numVar_; ++i) curState_[i]= rand()%2;
+      for (size_t i=0; i<numVar_; ++i) curState_[i]= random.uniformInteger(LabelType(2));
       helper_.init(gm_, curState_);
       if(param_.distance_ == Parameter::HAMMING)
          helper_.setDistanceType(LSA_TR_HELPER<LabelType>::HAMMING); 
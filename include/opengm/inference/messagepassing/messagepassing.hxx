@@ -119,6 +119,7 @@ public:
    ValueType convergenceFX() const;
    ValueType convergence() const;
    virtual void reset();
+   InferenceTermination rebind(const GraphicalModelType&);
    InferenceTermination infer();
    template<class VisitorType>
       InferenceTermination infer(VisitorType&);
@@ -139,7 +140,7 @@ private:
    template<class VisitorType>
       void inferSequential(VisitorType&);
 private:
-   const GraphicalModelType& gm_;
+   const GraphicalModelType* gm_;
    Parameter parameter_;
    std::vector<FactorHullType> factorHulls_;
    std::vector<VariableHullType> variableHulls_;
@@ -151,7 +152,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::MessagePassing
    const GraphicalModelType& gm,
    const typename  MessagePassing<GM, ACC, UPDATE_RULES, DIST>::Parameter& parameter
 )
-:  gm_(gm),
+:  gm_(&gm),
    parameter_(parameter)
 {
    if(parameter_.sortedNodeList_.size() == 0) {
@@ -161,7 +162,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::MessagePassing
    }
    OPENGM_ASSERT(parameter_.sortedNodeList_.size() == gm.numberOfVariables());
 
-   UPDATE_RULES::initializeSpecialParameter(gm_,this->parameter_);
+   UPDATE_RULES::initializeSpecialParameter(*gm_,this->parameter_);
   
    // set hulls
    variableHulls_.resize(gm.numberOfVariables(), VariableHullType ());
@@ -179,24 +180,40 @@ void
 MessagePassing<GM, ACC, UPDATE_RULES, DIST>::reset()
 {
    if(parameter_.sortedNodeList_.size() == 0) {
-      parameter_.sortedNodeList_.resize(gm_.numberOfVariables());
-      for (size_t i = 0; i < gm_.numberOfVariables(); ++i)
+      parameter_.sortedNodeList_.resize(gm_->numberOfVariables());
+      for (size_t i = 0; i < gm_->numberOfVariables(); ++i)
          parameter_.sortedNodeList_[i] = i;
    }
-   OPENGM_ASSERT(parameter_.sortedNodeList_.size() == gm_.numberOfVariables());
-   UPDATE_RULES::initializeSpecialParameter(gm_,this->parameter_);
+   OPENGM_ASSERT(parameter_.sortedNodeList_.size() == gm_->numberOfVariables());
+   UPDATE_RULES::initializeSpecialParameter(*gm_,this->parameter_);
 
    // set hulls
-   variableHulls_.resize(gm_.numberOfVariables(), VariableHullType ());
-   for (size_t i = 0; i < gm_.numberOfVariables(); ++i) {
-      variableHulls_[i].assign(gm_, i, &parameter_.specialParameter_);
+   variableHulls_.resize(gm_->numberOfVariables(), VariableHullType ());
+   for (size_t i = 0; i < gm_->numberOfVariables(); ++i) {
+      variableHulls_[i].assign(*gm_, i, &parameter_.specialParameter_);
    }
-   factorHulls_.resize(gm_.numberOfFactors(), FactorHullType ());
-   for (size_t i = 0; i < gm_.numberOfFactors(); i++) {
-      factorHulls_[i].assign(gm_, i, variableHulls_, &parameter_.specialParameter_);
+   factorHulls_.resize(gm_->numberOfFactors(), FactorHullType ());
+   for (size_t i = 0; i < gm_->numberOfFactors(); i++) {
+      factorHulls_[i].assign(*gm_, i, variableHulls_, &parameter_.specialParameter_);
    }
 }
 
+/// \brief bind to a model of the same structure, the current messages are the starting point of the next infer()
+template<class GM, class ACC, class UPDATE_RULES, class DIST>
+InferenceTermination
+MessagePassing<GM, ACC, UPDATE_RULES, DIST>::rebind
+(
+   const GraphicalModelType& gm
+)
+{
+   this->checkRebind(*gm_, gm);
+   gm_ = &gm;
+   for (size_t i = 0; i < gm.numberOfFactors(); ++i) {
+      factorHulls_[i].rebind(gm, i);
+   }
+   return NORMAL;
+}
+
 template<class GM, class ACC, class UPDATE_RULES, class DIST>
 inline std::string
 MessagePassing<GM, ACC, UPDATE_RULES, DIST>::name() const {
@@ -206,7 +223,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::name() const {
 template<class GM, class ACC, class UPDATE_RULES, class DIST>
 inline const typename MessagePassing<GM, ACC, UPDATE_RULES, DIST>::GraphicalModelType&
 MessagePassing<GM, ACC, UPDATE_RULES, DIST>::graphicalModel() const {
-   return gm_;
+   return *gm_;
 }
 
 template<class GM, class ACC, class UPDATE_RULES, class DIST>
@@ -234,7 +251,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::infer
          inferParallel(visitor);
       }
    } else { //triibool maby
-      if (gm_.isAcyclic()) {
+      if (gm_->isAcyclic()) {
          parameter_.isAcyclic_ = opengm::Tribool::True;
          if(parameter_.useNormalization_==opengm::Tribool::Maybe)
             parameter_.useNormalization_=false;
@@ -278,10 +295,10 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferAcyclic
    VisitorType& visitor
 ) 
 {
-   OPENGM_ASSERT(gm_.isAcyclic());
+   OPENGM_ASSERT(gm_->isAcyclic());
    visitor.begin(*this);
-   size_t numberOfVariables = gm_.numberOfVariables();
-   size_t numberOfFactors = gm_.numberOfFactors();
+   size_t numberOfVariables = gm_->numberOfVariables();
+   size_t numberOfFactors = gm_->numberOfFactors();
    // number of messages which have not yet been recevied
    // but are required for sending
    std::vector<std::vector<size_t> > counterVar2FacMessage(numberOfVariables);
@@ -292,12 +309,12 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferAcyclic
    ready2SendVar2FacMessage.reserve(100);
    ready2SendFac2VarMessage.reserve(100);
    for (size_t fac = 0; fac < numberOfFactors; ++fac) {
-      counterFac2VarMessage[fac].resize(gm_[fac].numberOfVariables(), gm_[fac].numberOfVariables() - 1);
+      counterFac2VarMessage[fac].resize((*gm_)[fac].numberOfVariables(), (*gm_)[fac].numberOfVariables() - 1);
    }
    for (size_t var = 0; var < numberOfVariables; ++var) {
-      counterVar2FacMessage[var].resize(gm_.numberOfFactors(var));
-      for (size_t i = 0; i < gm_.numberOfFactors(var); ++i) {
-         counterVar2FacMessage[var][i] = gm_.numberOfFactors(var) - 1;
+      counterVar2FacMessage[var].resize(gm_->numberOfFactors(var));
+      for (size_t i = 0; i < gm_->numberOfFactors(var); ++i) {
+         counterVar2FacMessage[var][i] = gm_->numberOfFactors(var) - 1;
       }
    }
    // find all messages which are ready for sending
@@ -322,13 +339,13 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferAcyclic
       while (ready2SendVar2FacMessage.size() > 0) {
          Message m = ready2SendVar2FacMessage.back();
          size_t nodeId = m.nodeId_;
-         size_t factorId = gm_.factorOfVariable(nodeId,m.internalMessageId_);
+         size_t factorId = gm_->factorOfVariable(nodeId,m.internalMessageId_);
          // send message
-         variableHulls_[nodeId].propagate(gm_, m.internalMessageId_, 0, false);
+         variableHulls_[nodeId].propagate(*gm_, m.internalMessageId_, 0, false);
          ready2SendVar2FacMessage.pop_back();
          //check if new messages can be sent
-         for (size_t i = 0; i < gm_[factorId].numberOfVariables(); ++i) {
-            if (gm_[factorId].variableIndex(i) != nodeId) {
+         for (size_t i = 0; i < (*gm_)[factorId].numberOfVariables(); ++i) {
+            if ((*gm_)[factorId].variableIndex(i) != nodeId) {
                if (--counterFac2VarMessage[factorId][i] == 0) {
                   ready2SendFac2VarMessage.push_back(Message(factorId, i));
                }
@@ -338,13 +355,13 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferAcyclic
       while (ready2SendFac2VarMessage.size() > 0) {
          Message m = ready2SendFac2VarMessage.back();
          size_t factorId = m.nodeId_;
-         size_t nodeId = gm_[factorId].variableIndex(m.internalMessageId_);
+         size_t nodeId = (*gm_)[factorId].variableIndex(m.internalMessageId_);
          // send message
          factorHulls_[factorId].propagate(m.internalMessageId_, 0, parameter_.useNormalization_);
          ready2SendFac2VarMessage.pop_back();
          // check if new messages can be sent
-         for (size_t i = 0; i < gm_.numberOfFactors(nodeId); ++i) {
-            if (gm_.factorOfVariable(nodeId,i) != factorId) {
+         for (size_t i = 0; i < gm_->numberOfFactors(nodeId); ++i) {
+            if (gm_->factorOfVariable(nodeId,i) != factorId) {
                if (--counterVar2FacMessage[nodeId][i] == 0) {
                   ready2SendVar2FacMessage.push_back(Message(nodeId, i));
                }
@@ -401,7 +418,7 @@ inline void MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferParallel
    }
    for (unsigned long n = 0; n < parameter_.maximumNumberOfSteps_; ++n) {
       for (size_t i = 0; i < variableHulls_.size(); ++i) {
-         variableHulls_[i].propagateAll(gm_, damping, false);
+         variableHulls_[i].propagateAll(*gm_, damping, false);
       }
       for (size_t i = 0; i < factorHulls_.size(); ++i) {
          if (factorHulls_[i].numberOfBuffers() >= 2)// messages from factors of order <2 do not change
@@ -448,13 +465,13 @@ inline void MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferSequential
 (
    VisitorType& visitor
 ) {
-   OPENGM_ASSERT(parameter_.sortedNodeList_.size() == gm_.numberOfVariables()); 
+   OPENGM_ASSERT(parameter_.sortedNodeList_.size() == gm_->numberOfVariables()); 
    visitor.begin(*this);
    ValueType damping = parameter_.damping_;
 
    // set nodeOrder
-   std::vector<size_t> nodeOrder(gm_.numberOfVariables());
-   for (size_t o = 0; o < gm_.numberOfVariables(); ++o) {
+   std::vector<size_t> nodeOrder(gm_->numberOfVariables());
+   for (size_t o = 0; o < gm_->numberOfVariables(); ++o) {
       nodeOrder[parameter_.sortedNodeList_[o]] = o;
    }
 
@@ -467,12 +484,12 @@ inline void MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferSequential
    }
 
    // calculate inverse positions
-   std::vector<std::vector<size_t> > inversePositions(gm_.numberOfVariables());
-   for(size_t var=0; var<gm_.numberOfVariables();++var) {
-      for(size_t i=0; i<gm_.numberOfFactors(var); ++i) {
-         size_t factorId = gm_.factorOfVariable(var,i);
-         for(size_t j=0; j<gm_.numberOfVariables(factorId);++j) {
-            if(gm_.variableOfFactor(factorId,j)==var) {
+   std::vector<std::vector<size_t> > inversePositions(gm_->numberOfVariables());
+   for(size_t var=0; var<gm_->numberOfVariables();++var) {
+      for(size_t i=0; i<gm_->numberOfFactors(var); ++i) {
+         size_t factorId = gm_->factorOfVariable(var,i);
+         for(size_t j=0; j<gm_->numberOfVariables(factorId);++j) {
+            if(gm_->variableOfFactor(factorId,j)==var) {
                inversePositions[var].push_back(j);
                break;
             }
@@ -485,29 +502,29 @@ inline void MessagePassing<GM, ACC, UPDATE_RULES, DIST>::inferSequential
    for (unsigned long itteration = 0; itteration < parameter_.maximumNumberOfSteps_; ++itteration) {
       if(itteration%2==0) {
          // in increasing ordering
-         for (size_t o = 0; o < gm_.numberOfVariables(); ++o) {
+         for (size_t o = 0; o < gm_->numberOfVariables(); ++o) {
             size_t variableId = parameter_.sortedNodeList_[o];
             // update messages to the variable node
-            for(size_t i=0; i<gm_.numberOfFactors(variableId); ++i) {
-               size_t factorId = gm_.factorOfVariable(variableId,i);
+            for(size_t i=0; i<gm_->numberOfFactors(variableId); ++i) {
+               size_t factorId = gm_->factorOfVariable(variableId,i);
                factorHulls_[factorId].propagate(inversePositions[variableId][i], damping, parameter_.useNormalization_); 
             }
 
             // update messages from the variable node
-            variableHulls_[variableId].propagateAll(gm_, damping, false);
+            variableHulls_[variableId].propagateAll(*gm_, damping, false);
          }
       }
       else{
          // in decreasing ordering
-         for (size_t o = 0; o < gm_.numberOfVariables(); ++o) {
-            size_t variableId = parameter_.sortedNodeList_[gm_.numberOfVariables() - 1 - o];
+         for (size_t o = 0; o < gm_->numberOfVariables(); ++o) {
+            size_t variableId = parameter_.sortedNodeList_[gm_->numberOfVariables() - 1 - o];
             // update messages to the variable node
-            for(size_t i=0; i<gm_.numberOfFactors(variableId); ++i) {
-               size_t factorId = gm_.factorOfVariable(variableId,i);
+            for(size_t i=0; i<gm_->numberOfFactors(variableId); ++i) {
+               size_t factorId = gm_->factorOfVariable(variableId,i);
                factorHulls_[factorId].propagate(inversePositions[variableId][i], damping, parameter_.useNormalization_); 
             }
             // update messages from Variable
-            variableHulls_[variableId].propagateAll(gm_, damping, false);
+            variableHulls_[variableId].propagateAll(*gm_, damping, false);
          }
       }
       if(visitor(*this)!=0)
@@ -529,7 +546,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::marginal
    IndependentFactorType & out
 ) const {
    OPENGM_ASSERT(variableIndex < variableHulls_.size());
-   variableHulls_[variableIndex].marginal(gm_, variableIndex, out, parameter_.useNormalization_);
+   variableHulls_[variableIndex].marginal(*gm_, variableIndex, out, parameter_.useNormalization_);
    return NORMAL;
 }
 
@@ -542,7 +559,7 @@ MessagePassing<GM, ACC, UPDATE_RULES, DIST>::factorMarginal
 ) const {
    typedef typename GM::OperatorType OP;
    OPENGM_ASSERT(factorIndex < factorHulls_.size());
-   out.assign(gm_, gm_[factorIndex].variableIndicesBegin(), gm_[factorIndex].variableIndicesEnd(), OP::template neutral<ValueType>());
+   out.assign(*gm_, (*gm_)[factorIndex].variableIndicesBegin(), (*gm_)[factorIndex].variableIndicesEnd(), OP::template neutral<ValueType>());
    factorHulls_[factorIndex].marginal(out, parameter_.useNormalization_);
    return NORMAL;
 }
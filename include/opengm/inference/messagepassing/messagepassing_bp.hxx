@@ -57,6 +57,7 @@ namespace opengm {
   
       size_t numberOfBuffers() const        { return inBuffer_.size(); }
       void assign(const GM&, const size_t, std::vector<VariableHullBP<GM,BUFFER,OP,ACC> >&, const meta::EmptyType*);
+      void rebind(const GM&, const size_t);
       void propagateAll(const ValueType& = 0, const bool = true);
       void propagate(const size_t, const ValueType& = 0, const bool = true);
       void marginal(IndependentFactorType&, const bool = true) const;
@@ -232,6 +233,15 @@ namespace opengm {
       return outBuffer_[bufferIndex]->current();
    }
 
+   template<class GM, class BUFFER, class OP, class ACC>
+   inline void FactorHullBP<GM, BUFFER, OP, ACC>::rebind
+   (
+      const GM& gm,
+      const size_t factorIndex
+   ) {
+      myFactor_ = (FactorType *const)(&gm[factorIndex]);
+   }
+
    template<class GM, class BUFFER, class OP, class ACC>
    inline void FactorHullBP<GM, BUFFER, OP, ACC>::assign
    (
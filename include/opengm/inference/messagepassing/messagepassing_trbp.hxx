@@ -57,6 +57,7 @@ namespace opengm {
       size_t numberOfBuffers() const       { return inBuffer_.size(); }
       //size_t variableIndex(size_t i) const { return variableIndices_[i]; }
       void assign(const GM&, const size_t, std::vector<VariableHullTRBP<GM,BUFFER,OP,ACC> >&, const std::vector<ValueType>*);
+      void rebind(const GM&, const size_t);
       void propagateAll(const ValueType& = 0, const bool = true);
       void propagate(const size_t, const ValueType& = 0, const bool = true);
       void marginal(IndependentFactorType&, const bool = true) const; 
@@ -252,6 +253,15 @@ namespace opengm {
    inline FactorHullTRBP<GM, BUFFER, OP, ACC>::FactorHullTRBP()
    {}
 
+   template<class GM, class BUFFER, class OP, class ACC>
+   inline void FactorHullTRBP<GM, BUFFER, OP, ACC>::rebind
+   (
+      const GM& gm,
+      const size_t factorIndex
+   ) {
+      myFactor_ = (FactorType*) (&gm[factorIndex]);
+   }
+
    template<class GM, class BUFFER, class OP, class ACC>
    inline void FactorHullTRBP<GM, BUFFER, OP, ACC>::assign
    (
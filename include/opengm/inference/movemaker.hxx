@@ -44,6 +44,7 @@ public:
    void reset();
    template<class StateIterator>
       void initialize(StateIterator);
+   void rebind(const GraphicalModelType&);
    template<class IndexIterator, class StateIterator>
       ValueType move(IndexIterator, IndexIterator, StateIterator);
    template<class ACCUMULATOR, class IndexIterator>
@@ -69,7 +70,7 @@ private:
    template<class FactorIndexIterator>
       ValueType evaluateFactors(FactorIndexIterator, FactorIndexIterator, const std::vector<LabelType>&) const;
 
-   const GraphicalModelType& gm_;
+   const GraphicalModelType* gm_;
    std::vector<std::set<size_t> > factorsOfVariable_;
    std::vector<LabelType> state_;
    std::vector<LabelType> stateBuffer_; // always equal to state_ (invariant)
@@ -110,7 +111,7 @@ Movemaker<GM>::proposeMoveAccordingToInference
    const size_t numberOfVariables = std::distance(variablesBegin, variablesEnd);
    std::vector<LabelType> spaceVector(numberOfVariables);
    for (size_t v = 0; v < numberOfVariables; ++v)
-      spaceVector[v] = gm_.numberOfLabels(variablesBegin[v]);
+      spaceVector[v] = gm_->numberOfLabels(variablesBegin[v]);
    SubGmSpace subGmSpace(spaceVector);
    SubGmType subGm(subGmSpace);
    this->addFactorsToSubGm(variablesBegin, variablesEnd, subGm);
@@ -128,7 +129,7 @@ inline void Movemaker<GM>::addSingleSide
    std::set<typename Movemaker<GM>::IndexType> & addedFactors
 )const {
    const size_t var1Index[] = {subGmVarIndex};
-   ViewFunction<GM> function = (gm_[gmFactorIndex]);
+   ViewFunction<GM> function = ((*gm_)[gmFactorIndex]);
    typename GM::FunctionIdentifier fid = subGm.addFunction(function);
    subGm.addFactor(fid, var1Index, var1Index + 1);
    addedFactors.insert(gmFactorIndex);
@@ -142,7 +143,7 @@ inline void Movemaker<GM>::addHigherOrderInsideFactor
    typename Movemaker<GM>::SubGmType & subGm,
    std::set<typename Movemaker<GM>::IndexType> & addedFactors
 )const {
-   ViewFunction<GM> function(gm_[gmFactorIndex]);
+   ViewFunction<GM> function((*gm_)[gmFactorIndex]);
    typename GM::FunctionIdentifier fid = subGm.addFunction(function);
    subGm.addFactor(fid, subGmFactorVi.begin(), subGmFactorVi.end());
    addedFactors.insert(gmFactorIndex);
@@ -157,7 +158,7 @@ inline void Movemaker<GM>::addHigherOrderBorderFactor
    typename Movemaker<GM>::SubGmType & subGm,
    std::set<typename Movemaker<GM>::IndexType> & addedFactors
 )const {
-   ViewFixVariablesFunction<GM> function(gm_[gmFactorIndex], factorFixVi);
+   ViewFixVariablesFunction<GM> function((*gm_)[gmFactorIndex], factorFixVi);
    typename GM::FunctionIdentifier fid = subGm.addFunction(function);
    subGm.addFactor(fid, subGmFactorVi.begin(), subGmFactorVi.end());
    addedFactors.insert(gmFactorIndex);
@@ -176,23 +177,23 @@ inline void Movemaker<GM>::addFactorsToSubGm
    opengm::BufferVector<opengm::PositionAndLabel<IndexType, LabelType > >factorFixVi;
    subGm.reserveFactors(subGm.numberOfVariables()*7);
    for (IndexType subGmVi = 0; subGmVi < subGm.numberOfVariables(); ++subGmVi) {
-      for (size_t f = 0; f < gm_.numberOfFactors(variablesBegin[subGmVi]); ++f) {
-         const size_t factorIndex = gm_.factorOfVariable(variablesBegin[subGmVi], f);
+      for (size_t f = 0; f < gm_->numberOfFactors(variablesBegin[subGmVi]); ++f) {
+         const size_t factorIndex = gm_->factorOfVariable(variablesBegin[subGmVi], f);
          // if the factor has not been added
          if (addedFactors.find(factorIndex) == addedFactors.end()) {
-            if (gm_[factorIndex].numberOfVariables() == 0) {
-            } else if (gm_[factorIndex].numberOfVariables() == 1)
+            if ((*gm_)[factorIndex].numberOfVariables() == 0) {
+            } else if ((*gm_)[factorIndex].numberOfVariables() == 1)
                this->addSingleSide(factorIndex, subGmVi, subGm, addedFactors);
             else {
                // find if all variables of the factor are in the subgraph or not:
                subGmFactorVi.clear();
                factorFixVi.clear();
-               for (IndexType vv = 0; vv < gm_[factorIndex].numberOfVariables(); ++vv) {
+               for (IndexType vv = 0; vv < (*gm_)[factorIndex].numberOfVariables(); ++vv) {
                   bool foundVarIndex = false;
                   IndexType varIndexSubGm = 0;
-                  foundVarIndex = findInSortedSequence(variablesBegin, subGm.numberOfVariables(), gm_[factorIndex].variableIndex(vv), varIndexSubGm);
+                  foundVarIndex = findInSortedSequence(variablesBegin, subGm.numberOfVariables(), (*gm_)[factorIndex].variableIndex(vv), varIndexSubGm);
                   if (foundVarIndex == false) // variable is outside the subgraph
-                     factorFixVi.push_back(opengm::PositionAndLabel<IndexType, LabelType > (vv, this->state(gm_[factorIndex].variableIndex(vv))));
+                     factorFixVi.push_back(opengm::PositionAndLabel<IndexType, LabelType > (vv, this->state((*gm_)[factorIndex].variableIndex(vv))));
                   else // variable is inside the subgraph
                      subGmFactorVi.push_back(varIndexSubGm);
                }
@@ -211,7 +212,7 @@ Movemaker<GM>::Movemaker
 (
    const GraphicalModelType& gm
 )
-:  gm_(gm),
+:  gm_(&gm),
    factorsOfVariable_(gm.numberOfVariables()),
    state_(gm.numberOfVariables()),
    stateBuffer_(gm.numberOfVariables()),
@@ -231,7 +232,7 @@ Movemaker<GM>::Movemaker
    const GraphicalModelType& gm,
    StateIterator it
 )
-:  gm_(gm),
+:  gm_(&gm),
    factorsOfVariable_(gm.numberOfVariables()),
    state_(gm.numberOfVariables()),
    stateBuffer_(gm.numberOfVariables()),
@@ -254,21 +255,33 @@ void Movemaker<GM>::initialize
 (
    StateIterator it
 ) {
-   energy_ = gm_.evaluate(it); // fails if *it is out of bounds
-   for (size_t j = 0; j < gm_.numberOfVariables(); ++j, ++it) {
+   energy_ = gm_->evaluate(it); // fails if *it is out of bounds
+   for (size_t j = 0; j < gm_->numberOfVariables(); ++j, ++it) {
       state_[j] = *it;
       stateBuffer_[j] = *it;
    }
 }
 
+/// \brief bind to a graphical model of the same structure, keeping the current state
+template<class GM>
+inline void
+Movemaker<GM>::rebind
+(
+   const GraphicalModelType& gm
+) {
+   OPENGM_ASSERT(gm.numberOfVariables() == state_.size());
+   gm_ = &gm;
+   energy_ = gm_->evaluate(state_.begin());
+}
+
 template<class GM>
 void
 Movemaker<GM>::reset() {
-   for (size_t j = 0; j < gm_.numberOfVariables(); ++j) {
+   for (size_t j = 0; j < gm_->numberOfVariables(); ++j) {
       state_[j] = 0;
       stateBuffer_[j] = 0;
    }
-   energy_ = gm_.evaluate(state_.begin());
+   energy_ = gm_->evaluate(state_.begin());
 }
 
 template<class GM>
@@ -295,7 +308,7 @@ Movemaker<GM>::valueAfterMove
          stateBuffer_[*it] = *destinationState;
       }
       // evaluate destination state
-      destinationValue = gm_.evaluate(stateBuffer_); 
+      destinationValue = gm_->evaluate(stateBuffer_); 
       // restore stateBuffer_
       for (IndexIterator it = begin; it != end; ++it) {
          stateBuffer_[*it] = state_[*it];
@@ -306,9 +319,9 @@ Movemaker<GM>::valueAfterMove
       // set stateBuffer_ to destinationState, and determine factors to recompute
       std::set<size_t> factorsToRecompute;
       for (IndexIterator it = begin; it != end; ++it, ++destinationState) {
-         OPENGM_ASSERT(*destinationState < gm_.numberOfLabels(*it));
+         OPENGM_ASSERT(*destinationState < gm_->numberOfLabels(*it));
          if (state_[*it] != *destinationState) {
-            OPENGM_ASSERT(*destinationState < gm_.numberOfLabels(*it));
+            OPENGM_ASSERT(*destinationState < gm_->numberOfLabels(*it));
             stateBuffer_[*it] = *destinationState;
             std::set<size_t> tmpSet;
             std::set_union(factorsToRecompute.begin(), factorsToRecompute.end(),
@@ -320,18 +333,18 @@ Movemaker<GM>::valueAfterMove
       // \todo consider buffering the values of ALL factors at the current state!
       destinationValue = energy_;
       for (std::set<size_t>::const_iterator it = factorsToRecompute.begin(); it != factorsToRecompute.end(); ++it) {
-         OPENGM_ASSERT(*it < gm_.numberOfFactors());
+         OPENGM_ASSERT(*it < gm_->numberOfFactors());
          // determine current and destination state of the current factor
-         std::vector<size_t> currentFactorState(gm_[*it].numberOfVariables());
-         std::vector<size_t> destinationFactorState(gm_[*it].numberOfVariables());
-         for (size_t j = 0; j < gm_[*it].numberOfVariables(); ++j) {
-            currentFactorState[j] = state_[gm_[*it].variableIndex(j)];
-            OPENGM_ASSERT(currentFactorState[j] < gm_[*it].numberOfLabels(j));
-            destinationFactorState[j] = stateBuffer_[gm_[*it].variableIndex(j)];
-            OPENGM_ASSERT(destinationFactorState[j] < gm_[*it].numberOfLabels(j));
+         std::vector<size_t> currentFactorState((*gm_)[*it].numberOfVariables());
+         std::vector<size_t> destinationFactorState((*gm_)[*it].numberOfVariables());
+         for (size_t j = 0; j < (*gm_)[*it].numberOfVariables(); ++j) {
+            currentFactorState[j] = state_[(*gm_)[*it].variableIndex(j)];
+            OPENGM_ASSERT(currentFactorState[j] < (*gm_)[*it].numberOfLabels(j));
+            destinationFactorState[j] = stateBuffer_[(*gm_)[*it].variableIndex(j)];
+            OPENGM_ASSERT(destinationFactorState[j] < (*gm_)[*it].numberOfLabels(j));
          }
-         OperatorType::op(destinationValue, gm_[*it](destinationFactorState.begin()), destinationValue);
-         OperatorType::iop(destinationValue, gm_[*it](currentFactorState.begin()), destinationValue);
+         OperatorType::op(destinationValue, (*gm_)[*it](destinationFactorState.begin()), destinationValue);
+         OperatorType::iop(destinationValue, (*gm_)[*it](currentFactorState.begin()), destinationValue);
       }
       // restore stateBuffer_
       for (IndexIterator it = begin; it != end; ++it) {
@@ -411,7 +424,7 @@ Movemaker<GM>::moveOptimally
       // increment buffered state
       for (size_t j = 0; j < numberOfVariables; ++j) {
          const size_t vi = variableIndices[j];
-         if (stateBuffer_[vi] < gm_.numberOfLabels(vi) - 1) {
+         if (stateBuffer_[vi] < gm_->numberOfLabels(vi) - 1) {
             ++stateBuffer_[vi];
             break;
          } else {
@@ -438,8 +451,8 @@ overflow:
       meta::Compare<ACCUMULATOR, opengm::Maximizer>::value,
       meta::Compare<OperatorType, opengm::Multiplier>::value
       >::value && energy_ == static_cast<ValueType> (0)) {
-         OPENGM_ASSERT(state_.size() == gm_.numberOfVariables());
-         energy_ = gm_.evaluate(state_.begin());
+         OPENGM_ASSERT(state_.size() == gm_->numberOfVariables());
+         energy_ = gm_->evaluate(state_.begin());
       }
       else {
          OperatorType::iop(initialEnergy, energy_); // energy_ -= initialEnergy
@@ -486,7 +499,7 @@ Movemaker<GM>::moveOptimallyWithAllLabelsChanging
    std::vector<size_t> bestState(numberOfVariables);
    // set initial labeling
    for(size_t j=0; j<numberOfVariables; ++j) {
-      if(gm_.space().numberOfLabels(variableIndices[j]) == 1) {
+      if(gm_->space().numberOfLabels(variableIndices[j]) == 1) {
          // restore stateBuffer_
          for(size_t k=0; k<j; ++k) {
             stateBuffer_[k] = state_[k];
@@ -525,12 +538,12 @@ Movemaker<GM>::moveOptimallyWithAllLabelsChanging
       // increment buffered state
       for (size_t j=0; j<numberOfVariables; ++j) {
          const size_t vi = variableIndices[j];
-         if(stateBuffer_[vi] < gm_.numberOfLabels(vi) - 1) {
+         if(stateBuffer_[vi] < gm_->numberOfLabels(vi) - 1) {
             if(stateBuffer_[vi] + 1 != state_[vi]) {
                ++stateBuffer_[vi];
                break;
             }
-            else if(stateBuffer_[vi] + 1 < gm_.numberOfLabels(vi) - 1) {
+            else if(stateBuffer_[vi] + 1 < gm_->numberOfLabels(vi) - 1) {
                stateBuffer_[vi] += 2; // skip current label
                break;
             }
@@ -575,7 +588,7 @@ overflow2:
       meta::Compare<ACCUMULATOR, opengm::Maximizer>::value,
       meta::Compare<OperatorType, opengm::Multiplier>::value
       >::value && energy_ == static_cast<ValueType> (0)) {
-         energy_ = gm_.evaluate(state_.begin());
+         energy_ = gm_->evaluate(state_.begin());
       }
       else {
          OperatorType::iop(initialEnergy, energy_); // energy_ -= initialEnergy
@@ -625,11 +638,11 @@ Movemaker<GM>::evaluateFactors
 ) const {
    ValueType value = OperatorType::template neutral<ValueType>();
    for(; begin != end; ++begin) {
-      std::vector<size_t> currentFactorState(gm_[*begin].numberOfVariables());
-      for (size_t j=0; j<gm_[*begin].numberOfVariables(); ++j) {
-         currentFactorState[j] = state[gm_[*begin].variableIndex(j)];
+      std::vector<size_t> currentFactorState((*gm_)[*begin].numberOfVariables());
+      for (size_t j=0; j<(*gm_)[*begin].numberOfVariables(); ++j) {
+         currentFactorState[j] = state[(*gm_)[*begin].variableIndex(j)];
       }
-      OperatorType::op(value, gm_[*begin](currentFactorState.begin()), value);
+      OperatorType::op(value, (*gm_)[*begin](currentFactorState.begin()), value);
    }
    return value;
 }
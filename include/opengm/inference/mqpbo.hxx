@@ -11,6 +11,7 @@
 #include "opengm/inference/inference.hxx"
 #include <opengm/utilities/metaprogramming.hxx>
 #include "opengm/utilities/tribool.hxx"
+#include "opengm/utilities/random.hxx"
 #include <opengm/inference/messagepassing/messagepassing.hxx>
 #include <opengm/functions/view_fix_variables_function.hxx>
 
@@ -50,13 +51,15 @@ namespace opengm {
       
       class Parameter{
       public:
-         Parameter(): useKovtunsMethod_(true), probing_(false),  strongPersistency_(false), rounds_(0), permutationType_(NONE) {};
+         Parameter(): useKovtunsMethod_(true), probing_(false),  strongPersistency_(false), rounds_(0), permutationType_(NONE), seed_(0) {};
          std::vector<LabelType> label_;
          bool useKovtunsMethod_;
          const bool probing_; //do not use this!
          bool strongPersistency_;
          size_t rounds_;
          PermutationType permutationType_;
+         /// seed of the counter-based RANDOM permutations, each round draws new ones
+         size_t seed_;
       };
 
       MQPBO(const GmType&, const Parameter& = Parameter());
@@ -102,6 +105,7 @@ namespace opengm {
 
       size_t numNodes_;
       size_t numEdges_;
+      size_t permutationRound_;
 
       GraphValueType scale;
 
@@ -117,6 +121,7 @@ namespace opengm {
    )
    :  gm_(gm),    
       param_(parameter),
+      permutationRound_(0),
       scale(1)
    {
       for(size_t j = 0; j < gm_.numberOfFactors(); ++j) {
@@ -412,7 +417,7 @@ namespace opengm {
          }
       }
       else if(permutationType==RANDOM){ 
-         srand ( unsigned ( time (NULL) ) );
+         CounterBasedRandom random(param_.seed_, permutationRound_++);
          for(IndexType var=0; var<gm_.numberOfVariables(); ++var){
             LabelType numStates = gm_.numberOfLabels(var);
             //IDENTYTY PERMUTATION
@@ -420,7 +425,7 @@ namespace opengm {
                permutation_[var][i]=i;
             }
             //SHUFFEL PERMUTATION  
-            std::random_shuffle(permutation_[var].begin(),permutation_[var].end());
+            std::shuffle(permutation_[var].begin(),permutation_[var].end(),random);
          }
       }
       else if(permutationType==MINMARG){
@@ -0,0 +1,617 @@
+#pragma once
+#ifndef OPENGM_PORTFOLIO_HXX
+#define OPENGM_PORTFOLIO_HXX
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <exception>
+#include <algorithm>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/opengm.hxx"
+#include "opengm/inference/inference.hxx"
+#include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/utilities/timer.hxx"
+
+namespace opengm {
+
+/// \brief Portfolio of inference algorithms racing on the same model
+///
+/// All solvers added with addSolver() are run concurrently (one thread per
+/// solver, WITH_OPENMP) on the same graphical model. Through their visitors
+/// they report to a shared incumbent: the best labeling and the best bound
+/// found by any of them. All solvers are asked to stop as soon as the gap
+/// between incumbent value and bound is at most Parameter::gapLimit_ or
+/// Parameter::timeLimit_ (wall clock seconds) is exceeded. Every improvement
+/// of the incumbent is recorded together with the solver that produced it.
+///
+/// Solvers stop only when they call their visitor, algorithms that do not
+/// call it during inference run to completion. Without OpenMP the solvers
+/// are run one after the other and share the time limit.
+///
+/// If Parameter::warmStart_ is set, each solver that starts after the
+/// incumbent has a labeling is given that labeling via setStartingPoint().
+/// A solver that throws does not stop the others; its message is available
+/// from solverError() and infer() returns INFERENCE_ERROR.
+///
+/// \ingroup inference
+template<class GM, class ACC>
+class Portfolio : public Inference<GM, ACC> {
+public:
+   typedef ACC AccumulationType;
+   typedef GM GraphicalModelType;
+   OPENGM_GM_TYPE_TYPEDEFS;
+   typedef visitors::VerboseVisitor<Portfolio<GM, ACC> > VerboseVisitorType;
+   typedef visitors::EmptyVisitor<Portfolio<GM, ACC> > EmptyVisitorType;
+   typedef visitors::TimingVisitor<Portfolio<GM, ACC> > TimingVisitorType;
+
+   struct Parameter {
+      Parameter
+      (
+         const double timeLimit = std::numeric_limits<double>::infinity(),
+         const double gapLimit = 0.0,
+         const size_t numberOfThreads = 0,
+         const bool warmStart = true
+      )
+      :  timeLimit_(timeLimit),
+         gapLimit_(gapLimit),
+         numberOfThreads_(numberOfThreads),
+         warmStart_(warmStart)
+      {}
+
+      /// maximal wall clock time in seconds
+      double timeLimit_;
+      /// stop if |value - bound| <= gapLimit_
+      double gapLimit_;
+      /// number of threads (0 = all available), used only WITH_OPENMP
+      size_t numberOfThreads_;
+      /// start solvers from the incumbent labeling
+      bool warmStart_;
+   };
+
+   /// improvement of the incumbent value or bound
+   struct Improvement {
+      /// index of the solver that produced the improvement
+      size_t solver_;
+      /// wall clock seconds since the start of infer()
+      double time_;
+      /// incumbent value after the improvement
+      ValueType value_;
+      /// incumbent bound after the improvement
+      ValueType bound_;
+   };
+
+   /// visitor through which a solver reports to the incumbent
+   template<class INF>
+   class IncumbentVisitor {
+   public:
+      IncumbentVisitor(Portfolio&, const size_t);
+      void begin(INF&);
+      size_t operator()(INF&);
+      void end(INF&);
+      void addLog(const std::string&) {}
+      void log(const std::string&, const double) {}
+   private:
+      size_t update(INF&);
+      Portfolio& portfolio_;
+      size_t solver_;
+      std::vector<LabelType> labeling_;
+   };
+
+   Portfolio(const GraphicalModelType&, const Parameter& = Parameter());
+   ~Portfolio();
+   std::string name() const;
+   const GraphicalModelType& graphicalModel() const;
+   template<class INF>
+      void addSolver(const typename INF::Parameter& = typename INF::Parameter(), const std::string& = std::string());
+   size_t numberOfSolvers() const;
+   const std::string& solverName(const size_t) const;
+   const std::string& solverError(const size_t) const;
+   const std::vector<Improvement>& improvements() const;
+   void reset();
+   InferenceTermination infer();
+   template<class VISITOR>
+      InferenceTermination infer(VISITOR&);
+   InferenceTermination arg(std::vector<LabelType>&, const size_t = 1) const;
+   ValueType value() const;
+   ValueType bound() const;
+
+   bool offerLabeling(const size_t, const std::vector<LabelType>&, const ValueType);
+   bool offerBound(const size_t, const ValueType);
+   bool improves(const ValueType) const;
+   bool stopped();
+
+private:
+   class SolverBase {
+   public:
+      SolverBase(const std::string& name)
+         : name_(name) {}
+      virtual ~SolverBase() {}
+      virtual void run(Portfolio&, const size_t) = 0;
+      std::string name_;
+   };
+
+   template<class INF>
+   class Solver : public SolverBase {
+   public:
+      Solver(const typename INF::Parameter& parameter, const std::string& name)
+         : SolverBase(name), parameter_(parameter) {}
+      virtual void run(Portfolio&, const size_t);
+   private:
+      typename INF::Parameter parameter_;
+   };
+
+   bool incumbentLabeling(std::vector<LabelType>&);
+   double elapsedTime();
+   void record(const size_t);
+   bool gapClosed() const;
+
+   const GraphicalModelType& gm_;
+   Parameter parameter_;
+   std::vector<SolverBase*> solvers_;
+   std::vector<LabelType> state_;
+   ValueType value_;
+   ValueType bound_;
+   bool stop_;
+   std::vector<Improvement> improvements_;
+   std::vector<std::string> errors_;
+   #ifdef WITH_OPENMP
+   double start_;
+   #else
+   Timer timer_;
+   #endif
+};
+
+template<class GM, class ACC>
+inline
+Portfolio<GM, ACC>::Portfolio
+(
+   const GraphicalModelType& gm,
+   const Parameter& parameter
+)
+:  gm_(gm),
+   parameter_(parameter),
+   solvers_(),
+   state_(gm.numberOfVariables(), 0),
+   value_(ACC::template neutral<ValueType>()),
+   bound_(ACC::template ineutral<ValueType>()),
+   stop_(false),
+   improvements_(),
+   errors_()
+{}
+
+template<class GM, class ACC>
+inline
+Portfolio<GM, ACC>::~Portfolio()
+{
+   for(size_t j = 0; j < solvers_.size(); ++j) {
+      delete solvers_[j];
+   }
+}
+
+template<class GM, class ACC>
+inline std::string
+Portfolio<GM, ACC>::name() const
+{
+   return "Portfolio";
+}
+
+template<class GM, class ACC>
+inline const typename Portfolio<GM, ACC>::GraphicalModelType&
+Portfolio<GM, ACC>::graphicalModel() const
+{
+   return gm_;
+}
+
+/// \brief add an inference algorithm to the portfolio
+///
+/// The algorithm is constructed as INF(gm, parameter) in infer().
+/// \param parameter parameter of the algorithm
+/// \param name name used in the improvement history (default: INF::name())
+template<class GM, class ACC>
+template<class INF>
+inline void
+Portfolio<GM, ACC>::addSolver
+(
+   const typename INF::Parameter& parameter,
+   const std::string& name
+)
+{
+   solvers_.push_back(new Solver<INF>(parameter, name));
+}
+
+template<class GM, class ACC>
+inline size_t
+Portfolio<GM, ACC>::numberOfSolvers() const
+{
+   return solvers_.size();
+}
+
+/// \brief name of a solver (available after infer() if no name was given)
+template<class GM, class ACC>
+inline const std::string&
+Portfolio<GM, ACC>::solverName
+(
+   const size_t solver
+) const
+{
+   OPENGM_ASSERT(solver < solvers_.size());
+   return solvers_[solver]->name_;
+}
+
+/// \brief message of the exception thrown by a solver in the last infer()
+/// (empty if the solver did not fail)
+template<class GM, class ACC>
+inline const std::string&
+Portfolio<GM, ACC>::solverError
+(
+   const size_t solver
+) const
+{
+   OPENGM_ASSERT(solver < errors_.size());
+   return errors_[solver];
+}
+
+/// \brief all improvements of the incumbent in chronological order
+template<class GM, class ACC>
+inline const std::vector<typename Portfolio<GM, ACC>::Improvement>&
+Portfolio<GM, ACC>::improvements() const
+{
+   return improvements_;
+}
+
+template<class GM, class ACC>
+inline void
+Portfolio<GM, ACC>::reset()
+{
+   std::fill(state_.begin(), state_.end(), static_cast<LabelType>(0));
+   value_ = ACC::template neutral<ValueType>();
+   bound_ = ACC::template ineutral<ValueType>();
+   stop_ = false;
+   improvements_.clear();
+   errors_.assign(solvers_.size(), std::string());
+}
+
+template<class GM, class ACC>
+inline InferenceTermination
+Portfolio<GM, ACC>::infer()
+{
+   EmptyVisitorType visitor;
+   return infer(visitor);
+}
+
+/// \brief run all solvers concurrently
+///
+/// The visitor of the portfolio is called at the beginning and the end only.
+/// \return INFERENCE_ERROR if a solver threw, the incumbent of the other
+/// solvers is kept; throws if all solvers failed without an improvement
+template<class GM, class ACC>
+template<class VISITOR>
+InferenceTermination
+Portfolio<GM, ACC>::infer
+(
+   VISITOR& visitor
+)
+{
+   reset();
+   #ifdef WITH_OPENMP
+   start_ = omp_get_wtime();
+   #else
+   timer_.tic();
+   #endif
+   visitor.begin(*this);
+
+   #ifdef WITH_OPENMP
+   const int nThreads = parameter_.numberOfThreads_ > 0 ? static_cast<int>(parameter_.numberOfThreads_) : omp_get_max_threads();
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t j = 0; j < static_cast<std::ptrdiff_t>(solvers_.size()); ++j) {
+      // exceptions must not leave the parallel region
+      try {
+         solvers_[j]->run(*this, static_cast<size_t>(j));
+      }
+      catch(std::exception& e) {
+         errors_[j] = e.what();
+      }
+   }
+
+   bool failed = false;
+   for(size_t j = 0; j < errors_.size(); ++j) {
+      if(!errors_[j].empty()) {
+         if(improvements_.empty()) {
+            throw RuntimeError(solvers_[j]->name_ + " failed: " + errors_[j]);
+         }
+         failed = true;
+      }
+   }
+   visitor.end(*this);
+   if(failed) {
+      return INFERENCE_ERROR;
+   }
+   return improvements_.empty() ? UNKNOWN : NORMAL;
+}
+
+template<class GM, class ACC>
+inline InferenceTermination
+Portfolio<GM, ACC>::arg
+(
+   std::vector<LabelType>& arg,
+   const size_t n
+) const
+{
+   if(n == 1) {
+      arg.assign(state_.begin(), state_.end());
+      return NORMAL;
+   }
+   else {
+      return UNKNOWN;
+   }
+}
+
+template<class GM, class ACC>
+inline typename Portfolio<GM, ACC>::ValueType
+Portfolio<GM, ACC>::value() const
+{
+   return value_;
+}
+
+template<class GM, class ACC>
+inline typename Portfolio<GM, ACC>::ValueType
+Portfolio<GM, ACC>::bound() const
+{
+   return bound_;
+}
+
+/// \brief replace the incumbent labeling if the value is better
+/// \return true if the incumbent was replaced
+template<class GM, class ACC>
+bool
+Portfolio<GM, ACC>::offerLabeling
+(
+   const size_t solver,
+   const std::vector<LabelType>& labeling,
+   const ValueType value
+)
+{
+   OPENGM_ASSERT(labeling.size() == gm_.numberOfVariables());
+   bool improved = false;
+   #ifdef WITH_OPENMP
+   #pragma omp critical(opengm_portfolio_incumbent)
+   #endif
+   {
+      if(ACC::bop(value, value_)) {
+         value_ = value;
+         state_.assign(labeling.begin(), labeling.end());
+         record(solver);
+         improved = true;
+      }
+   }
+   return improved;
+}
+
+/// \brief replace the incumbent bound if it is tighter
+/// \return true if the incumbent bound was replaced
+template<class GM, class ACC>
+bool
+Portfolio<GM, ACC>::offerBound
+(
+   const size_t solver,
+   const ValueType bound
+)
+{
+   bool improved = false;
+   #ifdef WITH_OPENMP
+   #pragma omp critical(opengm_portfolio_incumbent)
+   #endif
+   {
+      if(ACC::ibop(bound, bound_)) {
+         bound_ = bound;
+         record(solver);
+         improved = true;
+      }
+   }
+   return improved;
+}
+
+/// \brief check if a value would improve the incumbent
+///
+/// Used to avoid copying labelings that cannot win, the final decision is
+/// made in offerLabeling().
+template<class GM, class ACC>
+inline bool
+Portfolio<GM, ACC>::improves
+(
+   const ValueType value
+) const
+{
+   bool improved;
+   #ifdef WITH_OPENMP
+   #pragma omp critical(opengm_portfolio_incumbent)
+   #endif
+   {
+      improved = ACC::bop(value, value_);
+   }
+   return improved;
+}
+
+/// \brief true if the gap is closed or the time limit is exceeded
+template<class GM, class ACC>
+bool
+Portfolio<GM, ACC>::stopped()
+{
+   bool stop;
+   #ifdef WITH_OPENMP
+   #pragma omp critical(opengm_portfolio_incumbent)
+   #endif
+   {
+      if(!stop_ && (gapClosed() || elapsedTime() > parameter_.timeLimit_)) {
+         stop_ = true;
+      }
+      stop = stop_;
+   }
+   return stop;
+}
+
+/// copy of the incumbent labeling, false if there is none yet
+template<class GM, class ACC>
+bool
+Portfolio<GM, ACC>::incumbentLabeling
+(
+   std::vector<LabelType>& labeling
+)
+{
+   bool found;
+   #ifdef WITH_OPENMP
+   #pragma omp critical(opengm_portfolio_incumbent)
+   #endif
+   {
+      found = value_ != ACC::template neutral<ValueType>();
+      if(found) {
+         labeling.assign(state_.begin(), state_.end());
+      }
+   }
+   return found;
+}
+
+template<class GM, class ACC>
+inline double
+Portfolio<GM, ACC>::elapsedTime()
+{
+   #ifdef WITH_OPENMP
+   return omp_get_wtime() - start_;
+   #else
+   timer_.toc();
+   return timer_.elapsedTime();
+   #endif
+}
+
+// requires the incumbent lock
+template<class GM, class ACC>
+inline void
+Portfolio<GM, ACC>::record
+(
+   const size_t solver
+)
+{
+   Improvement improvement;
+   improvement.solver_ = solver;
+   improvement.time_ = elapsedTime();
+   improvement.value_ = value_;
+   improvement.bound_ = bound_;
+   improvements_.push_back(improvement);
+}
+
+// requires the incumbent lock
+template<class GM, class ACC>
+inline bool
+Portfolio<GM, ACC>::gapClosed() const
+{
+   if(improvements_.empty() || value_ == ACC::template neutral<ValueType>()
+   || bound_ == ACC::template ineutral<ValueType>()) {
+      return false;
+   }
+   return std::fabs(static_cast<double>(value_) - static_cast<double>(bound_)) <= parameter_.gapLimit_;
+}
+
+template<class GM, class ACC>
+template<class INF>
+void
+Portfolio<GM, ACC>::Solver<INF>::run
+(
+   Portfolio& portfolio,
+   const size_t solver
+)
+{
+   if(portfolio.stopped()) {
+      return;
+   }
+   INF inference(portfolio.gm_, parameter_);
+   if(this->name_.empty()) {
+      this->name_ = inference.name();
+   }
+   std::vector<LabelType> labeling;
+   if(portfolio.parameter_.warmStart_ && portfolio.incumbentLabeling(labeling)) {
+      inference.setStartingPoint(labeling.begin());
+   }
+   IncumbentVisitor<INF> visitor(portfolio, solver);
+   inference.infer(visitor);
+   // the final result is offered even if the solver does not call end()
+   if(inference.arg(labeling) == NORMAL && labeling.size() == portfolio.gm_.numberOfVariables()) {
+      portfolio.offerLabeling(solver, labeling, portfolio.gm_.evaluate(labeling.begin()));
+   }
+   portfolio.offerBound(solver, inference.bound());
+}
+
+template<class GM, class ACC>
+template<class INF>
+inline
+Portfolio<GM, ACC>::IncumbentVisitor<INF>::IncumbentVisitor
+(
+   Portfolio& portfolio,
+   const size_t solver
+)
+:  portfolio_(portfolio),
+   solver_(solver),
+   labeling_()
+{}
+
+template<class GM, class ACC>
+template<class INF>
+inline void
+Portfolio<GM, ACC>::IncumbentVisitor<INF>::begin
+(
+   INF& inference
+)
+{
+   update(inference);
+}
+
+template<class GM, class ACC>
+template<class INF>
+inline size_t
+Portfolio<GM, ACC>::IncumbentVisitor<INF>::operator()
+(
+   INF& inference
+)
+{
+   return update(inference);
+}
+
+template<class GM, class ACC>
+template<class INF>
+inline void
+Portfolio<GM, ACC>::IncumbentVisitor<INF>::end
+(
+   INF& inference
+)
+{
+   update(inference);
+}
+
+// The value reported by the solver is used only as a filter, the labeling
+// is re-evaluated on the model before it is offered.
+template<class GM, class ACC>
+template<class INF>
+size_t
+Portfolio<GM, ACC>::IncumbentVisitor<INF>::update
+(
+   INF& inference
+)
+{
+   if(portfolio_.improves(inference.value())) {
+      if(inference.arg(labeling_) == NORMAL && labeling_.size() == portfolio_.gm_.numberOfVariables()) {
+         portfolio_.offerLabeling(solver_, labeling_, portfolio_.gm_.evaluate(labeling_.begin()));
+      }
+   }
+   portfolio_.offerBound(solver_, inference.bound());
+   return portfolio_.stopped() ? visitors::VisitorReturnFlag::StopInfBoundReached : visitors::VisitorReturnFlag::ContinueInf;
+}
+
+} // namespace opengm
+
+#endif // #ifndef OPENGM_PORTFOLIO_HXX
@@ -7,6 +7,10 @@
 #include <map>
 #include <string>
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
 
 #include "opengm/opengm.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
@@ -28,6 +32,10 @@
 #include "opengm/graphicalmodel/space/discretespace.hxx"
 #include "opengm/graphicalmodel/graphicalmodel.hxx"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace opengm {
   template<class GM>
   class ReducedInferenceHelper
@@ -56,6 +64,7 @@ namespace opengm {
   /// * modelreduction by partial optimality
   /// * seperate optimization of independent subparts of the objective
   /// * preoptimization of acyclic subproblems (only second order so far)
+  /// * concurrent optimization of the independent subparts (requires OpenMP)
   ///
   /// additional to the CVPR-Paper
   /// * the complete code is refactort - parts of the code are moved to graphicalmodel_manipulator.hxx
@@ -91,17 +100,25 @@ namespace opengm {
         bool Persistency_;
         bool Tentacle_;
         bool ConnectedComponents_;
+        /// number of threads used to build and solve the connected components (0 = OpenMP default)
+        size_t numberOfThreads_;
+        /// time limit in seconds for the inference of a single connected component
+        double subTimeLimit_;
         Parameter(
             const bool Persistency=false,
             const bool Tentacle=false,
             const bool ConnectedComponents=false,
-            typename INF::Parameter subParameter = typename INF::Parameter()
+            typename INF::Parameter subParameter = typename INF::Parameter(),
+            const size_t numberOfThreads=1,
+            const double subTimeLimit=std::numeric_limits<double>::infinity()
         )
         :
+            subParameter_(subParameter),
             Persistency_(Persistency),
             Tentacle_(Tentacle),
             ConnectedComponents_(ConnectedComponents),
-            subParameter_(subParameter)
+            numberOfThreads_(numberOfThreads),
+            subTimeLimit_(subTimeLimit)
         {
 
         };
@@ -426,26 +443,62 @@ namespace opengm {
 
     // CONNTECTED COMPONENTS INFERENCE
     if(param_.ConnectedComponents_ == true){
-      gmm.buildModifiedSubModels();
-      std::vector<std::vector<LabelType> > args(gmm.numberOfSubmodels(),std::vector<LabelType>() );
-      for(size_t i=0; i<gmm.numberOfSubmodels(); ++i){
-         args[i].resize(gmm.getModifiedSubModel(i).numberOfVariables());
+      gmm.buildModifiedSubModels(param_.numberOfThreads_);
+      const size_t numberOfSubmodels = gmm.numberOfSubmodels();
+      std::vector<std::vector<LabelType> > args(numberOfSubmodels,std::vector<LabelType>() );
+      std::vector<ValueType> bounds(numberOfSubmodels);
+      // largest components first, such that the big ones do not end up at the tail of the schedule
+      std::vector<std::pair<IndexType,size_t> > order(numberOfSubmodels);
+      for(size_t i=0; i<numberOfSubmodels; ++i){
+         args[i].resize(gmm.getModifiedSubModel(i).numberOfVariables(),0);
+         ACC::ineutral(bounds[i]);
+         order[i] = std::pair<IndexType,size_t>(gmm.getModifiedSubModel(i).numberOfVariables(),i);
       } 
-      for(size_t i=0; i<gmm.numberOfSubmodels(); ++i){
-         typename ReducedInferenceHelper<GM>::InfGmType agm = gmm.getModifiedSubModel(i);
-         subinf(agm, param_.Tentacle_, args[i],v,b);
-         //OperatorType::op(v,sv);
-         OperatorType::op(b,sb);
-         //gmm.modifiedSubStates2OriginalState(args, state_);
-         //visitor(*this,value(),bound(),"numberOfComp",i);
-         if( visitor(*this) != visitors::VisitorReturnFlag::ContinueInf ) {
-            visitor.end(*this);
-            return NORMAL;
+      std::sort(order.begin(),order.end(),std::greater<std::pair<IndexType,size_t> >());
+
+      visitor.addLog("solvedComponents");
+      bool stop = false;
+      size_t numberOfSolvedSubmodels = 0;
+      const std::ptrdiff_t numberOfSubmodelsS = static_cast<std::ptrdiff_t>(numberOfSubmodels);
+#ifdef WITH_OPENMP
+      const int numThreads = param_.numberOfThreads_>0 ? static_cast<int>(param_.numberOfThreads_) : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic,1) num_threads(numThreads)
+#endif
+      for(std::ptrdiff_t n=0; n<numberOfSubmodelsS; ++n){
+         bool skip;
+#ifdef WITH_OPENMP
+#pragma omp atomic read
+#endif
+         skip = stop;
+         if(skip) continue;
+         const size_t i = order[n].second;
+         ValueType subValue, subBound;
+         subinf(gmm.getModifiedSubModel(i), param_.Tentacle_, args[i], subValue, subBound);
+         bounds[i] = subBound;
+         // the visitor is not thread safe, progress is reported by one thread at a time
+#ifdef WITH_OPENMP
+#pragma omp critical(ReducedInferenceVisitor)
+#endif
+         {
+            ++numberOfSolvedSubmodels;
+            if(!stop){
+               const size_t flag = visitor(*this);
+               visitor.log("solvedComponents",static_cast<double>(numberOfSolvedSubmodels));
+               if( flag != visitors::VisitorReturnFlag::ContinueInf ) {
+#ifdef WITH_OPENMP
+#pragma omp atomic write
+#endif
+                  stop = true;
+               }
+            }
          }
       }
+      for(size_t i=0; i<numberOfSubmodels; ++i){
+         OperatorType::op(bounds[i],sb);
+      }
       bound_= sb;
       gmm.modifiedSubStates2OriginalState(args, state_);
-      if( visitor(*this) != visitors::VisitorReturnFlag::ContinueInf ) {
+      if( stop || visitor(*this) != visitors::VisitorReturnFlag::ContinueInf ) {
          visitor.end(*this);
          return NORMAL;
       }
@@ -481,7 +534,13 @@ namespace opengm {
   {
      //std::cout << "solve model with "<<agm.numberOfVariables()<<" and "<<agm.numberOfFactors()<<" factors."<<std::endl; 
      InfType inf(agm, param_.subParameter_);
-     inf.infer();
+     if(param_.subTimeLimit_ < std::numeric_limits<double>::infinity()){
+        visitors::TimingVisitor<InfType> subVisitor(1,0,false,false,param_.subTimeLimit_);
+        inf.infer(subVisitor);
+     }
+     else{
+        inf.infer();
+     }
      arg.resize(agm.numberOfVariables());
      inf.arg(arg);   
      value = inf.value();
@@ -2,8 +2,14 @@
 #define OPENGM_SELF_FUSION_HXX
 
 #include <vector>
+#include <deque>
 #include <string>
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 #include "opengm/opengm.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
@@ -30,6 +36,145 @@
 
 
 namespace opengm {
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_self_fusion {
+
+   /// labeling proposed by a base solver
+   template<class LABEL, class VALUE>
+   struct Proposal {
+      std::vector<LABEL> labels_;
+      VALUE value_;
+      VALUE bound_;
+   };
+
+   /// bounded queue of the proposals of the base solvers, consumed by the fusion worker.
+   /// push() never blocks: if the queue is full, the oldest proposal is dropped, such that
+   /// the base solvers run at their own rate and the worker fuses the most recent labelings.
+   /// pop() blocks the worker until a proposal arrives or all producers are done.
+   template<class LABEL, class VALUE>
+   class ProposalQueue {
+   public:
+      typedef Proposal<LABEL, VALUE> ProposalType;
+
+      ProposalQueue(const size_t capacity, const size_t numberOfProducers)
+      :  queue_(),
+         capacity_(capacity > 0 ? capacity : 1),
+         producers_(numberOfProducers),
+         stop_(0),
+         dropped_(0),
+         mutex_(),
+         condition_()
+      {}
+
+      template<class INF>
+      void push(INF& inf) {
+         // the labeling is copied outside of the critical section
+         ProposalType proposal;
+         inf.arg(proposal.labels_);
+         proposal.value_ = inf.value();
+         proposal.bound_ = inf.bound();
+         {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(queue_.size() >= capacity_) {
+               queue_.pop_front();
+               ++dropped_;
+            }
+            queue_.push_back(ProposalType());
+            queue_.back().labels_.swap(proposal.labels_);
+            queue_.back().value_ = proposal.value_;
+            queue_.back().bound_ = proposal.bound_;
+         }
+         condition_.notify_one();
+      }
+
+      /// waits for the next proposal
+      /// \return false if all producers are done and all proposals are consumed
+      bool pop(ProposalType& proposal) {
+         std::unique_lock<std::mutex> lock(mutex_);
+         while(queue_.empty() && producers_ > 0) {
+            condition_.wait(lock);
+         }
+         if(queue_.empty()) {
+            return false;
+         }
+         proposal.labels_.swap(queue_.front().labels_);
+         proposal.value_ = queue_.front().value_;
+         proposal.bound_ = queue_.front().bound_;
+         queue_.pop_front();
+         return true;
+      }
+
+      void producerDone() {
+         {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --producers_;
+         }
+         condition_.notify_one();
+      }
+
+      void stop() {
+         #ifdef WITH_OPENMP
+         #pragma omp atomic write
+         #endif
+         stop_ = 1;
+      }
+
+      bool stopped() const {
+         int stop;
+         #ifdef WITH_OPENMP
+         #pragma omp atomic read
+         #endif
+         stop = stop_;
+         return stop != 0;
+      }
+
+      size_t numberOfDroppedProposals() const {
+         std::lock_guard<std::mutex> lock(mutex_);
+         return dropped_;
+      }
+
+   private:
+      std::deque<ProposalType> queue_;
+      size_t capacity_;
+      size_t producers_;
+      int stop_;
+      size_t dropped_;
+      mutable std::mutex mutex_;
+      std::condition_variable condition_;
+   };
+
+   /// visitor of a base solver run concurrently to the fusion, proposes every
+   /// fuseNth-th labeling and the final labeling
+   template<class INF, class QUEUE>
+   class ProposalVisitor {
+   public:
+      ProposalVisitor(QUEUE& queue, const UInt64Type fuseNth)
+      :  queue_(queue),
+         fuseNth_(fuseNth > 0 ? fuseNth : 1),
+         iteration_(0)
+      {}
+      void begin(INF&) {}
+      size_t operator()(INF& inf) {
+         if(iteration_ % fuseNth_ == 0) {
+            queue_.push(inf);
+         }
+         ++iteration_;
+         return queue_.stopped() ? visitors::VisitorReturnFlag::StopInfTimeout : visitors::VisitorReturnFlag::ContinueInf;
+      }
+      void end(INF& inf) {
+         queue_.push(inf);
+      }
+      void addLog(const std::string&) {}
+      void log(const std::string&, const double) {}
+   private:
+      QUEUE& queue_;
+      UInt64Type fuseNth_;
+      UInt64Type iteration_;
+   };
+
+} // namespace detail_self_fusion
+/// \endcond
   
 template<class INF,class SELF_FUSION,class SELF_FUSION_VISITOR>
 struct FusionVisitor{
@@ -63,7 +208,8 @@ struct FusionVisitor{
             std::vector<LabelType> &    argBest,
             ValueType &                 value,
             ValueType &                 bound,
-            UInt64Type                  fuseNth=1
+            UInt64Type                  fuseNth=1,
+            const bool                  initialize=true
         )
     :   gm_(selfFusion.graphicalModel()),
         selfFusion_(selfFusion),
@@ -77,7 +223,8 @@ struct FusionVisitor{
         argBest_(argBest),
         argOut_(selfFusion.graphicalModel().numberOfVariables()),
         returnFlag_(visitors::VisitorReturnFlag::ContinueInf),
-        numNoProgress_(0)
+        numNoProgress_(0),
+        initialize_(initialize)
     {
 
     }
@@ -110,117 +257,26 @@ struct FusionVisitor{
 
         ValueType oldValue = value_;
 
-        if(iteration_==0 ){         
+        if(iteration_==0 && initialize_){         
             inference.arg(argBest_);
-            ValueType value = inference.value();
-            if(AccumulationType::bop(value,value_)){
-               std::copy(argOut_.begin(),argOut_.end(),argBest_.begin());
-               value_ = value;
-            }
+            value_ = inference.value();
             returnFlag_ =   selfFusionVisitor_(selfFusion_);
-            selfFusionVisitor_.log("infValue",value);
+            selfFusionVisitor_.log("infValue",value_);
         }
         else if(iteration_%fuseNth_==0){
           
             inference.arg(argFromInf_);
 
             const ValueType infValue = inference.value();
-            bound_   = inference.bound();
-            lastInfValue_=infValue;
-            IndexType nLocalVar=0;
-            for(IndexType vi=0;vi<gm_.numberOfVariables();++vi){
-                if(argBest_[vi]!=argFromInf_[vi]){
-                    ++nLocalVar;
-                }
+            if(AccumulationType::ibop(inference.bound(),bound_)){
+               bound_ = inference.bound();
             }
+            lastInfValue_=infValue;
 
+            value_ = fuse(fusionMover_, selfFusion_, argBest_, value_, argFromInf_, infValue, argOut_);
 
-            // setup which to labels should be fused and declare 
-            // output label vector
-            fusionMover_.setup(argBest_,argFromInf_,argOut_,value_,infValue);
-            // get the number of fusion-move variables
-            const IndexType nFuseMoveVar=fusionMover_.numberOfFusionMoveVariable();
-
-            if(nFuseMoveVar>0){
-
-
-                if(param.fusionSolver_==SelfFusionType::LazyFlipperFusion){
-                    //std::cout<<"fuse with lazy flipper "<<param.maxSubgraphSize_<<"\n";
-                    value_ = fusionMover_. template fuse<LazyFlipperSubInf> (
-                        typename LazyFlipperSubInf::Parameter(param.maxSubgraphSize_),true
-                    );
-
-                }
-                #ifdef WITH_CPLEX
-                else if(param.fusionSolver_==SelfFusionType::CplexFusion ){
-#ifdef WITH_QPBO
-                   // NON reduced inference
-                   if(param.reducedInf_==false){
-#endif  
-                      //std::cout <<"ILP"<<std::endl;
-                      typename CplexSubInf::Parameter p;
-                      p.integerConstraint_ = true;
-                      p.numberOfThreads_   = 1;
-                      p.timeLimit_         = param.fusionTimeLimit_;
-                      value_ = fusionMover_. template fuse<CplexSubInf> (p,true);
- #ifdef WITH_QPBO
-                   } 
-                   // reduced inference
-                   else{
-                      //std::cout <<"RILP"<<std::endl;
-                      typedef typename ReducedInferenceHelper<SubGmType>::InfGmType ReducedGmType;
-                      typedef opengm::LPCplex<ReducedGmType, AccumulationType>      _CplexSubInf;
-                      typedef ReducedInference<SubGmType,AccumulationType,_CplexSubInf>          CplexReducedSubInf; 
-                      typename _CplexSubInf::Parameter _subInfParam;
-                      _subInfParam.integerConstraint_ = true; 
-                      _subInfParam.numberOfThreads_   = 1;
-                      _subInfParam.timeLimit_         = param.fusionTimeLimit_; 
-                      typename CplexReducedSubInf::Parameter subInfParam(true,param.tentacles_,param.connectedComponents_,_subInfParam);
-                      value_ = fusionMover_. template fuse<CplexReducedSubInf> (subInfParam,true); 
-                   }
-                  
- #endif
-                   
-                }
-                #endif
-
-                #ifdef WITH_QPBO
-                else if(param.fusionSolver_==SelfFusionType::QpboFusion ){
-                    
-                    if(selfFusion_.maxOrder()<=2){
-                        //std::cout<<"fuse with qpbo\n";
-                        value_ = fusionMover_. template fuseQpbo<QpboSubInf> ();
-                        //typename QPBOSubInf::Parameter subInfParam;
-                        //subInfParam.strongPersistency_ = false;
-                        //subInfParam.label_ = argBest_;
-                        //value_ = fusionMover_. template fuse<QPBOSubInf> (subInfParam,false); 
-                    }
-                    else{
-                        //std::cout<<"fuse with fix-qpbo\n";
-                        //value_ = fusionMover_. template fuseFixQpbo<QpboSubInf> ();
-                        typename HQPBOSubInf::Parameter subInfParam;
-                        value_ = fusionMover_. template fuse<HQPBOSubInf> (subInfParam,true);
-                    }
-                }
-                #endif
-                else{
-                   throw std::runtime_error("Unknown Fusion Type! Maybe caused by missing linking!");
-                }
-
-
-                // write fusion result into best arg
-                std::copy(argOut_.begin(),argOut_.end(),argBest_.begin());
-
-                //std::cout<<"fusionValue "<<value_<<" infValue "<<infValue<<"\n";
-
-                returnFlag_ =  selfFusionVisitor_(selfFusion_);
-                                selfFusionVisitor_.log("infValue",infValue);
-            } 
-
-            else{
-               returnFlag_ =   selfFusionVisitor_(selfFusion_);
-               selfFusionVisitor_.log("infValue",value_);
-            }
+            returnFlag_ =  selfFusionVisitor_(selfFusion_);
+            selfFusionVisitor_.log("infValue",infValue);
         }
         ++iteration_;
 
@@ -239,6 +295,84 @@ struct FusionVisitor{
 
 
 
+    /// fuses argBest with a proposal using the fusion solver selected in the parameter
+    /// of selfFusion, the fused labeling is written to argBest and its value returned
+    static ValueType fuse(
+        FusionMoverType &               fusionMover,
+        const SelfFusionType &          selfFusion,
+        std::vector<LabelType> &        argBest,
+        const ValueType                 value,
+        const std::vector<LabelType> &  proposal,
+        const ValueType                 proposalValue,
+        std::vector<LabelType> &        argOut
+    ){
+        const typename SelfFusionType::Parameter & param = selfFusion.parameter();
+
+        // setup which to labels should be fused and declare 
+        // output label vector
+        fusionMover.setup(argBest,proposal,argOut,value,proposalValue);
+        // get the number of fusion-move variables
+        const IndexType nFuseMoveVar=fusionMover.numberOfFusionMoveVariable();
+        if(nFuseMoveVar==0){
+            return value;
+        }
+
+        ValueType fusedValue = value;
+        if(param.fusionSolver_==SelfFusionType::LazyFlipperFusion){
+            fusedValue = fusionMover. template fuse<LazyFlipperSubInf> (
+                typename LazyFlipperSubInf::Parameter(param.maxSubgraphSize_),true
+            );
+        }
+        #ifdef WITH_CPLEX
+        else if(param.fusionSolver_==SelfFusionType::CplexFusion ){
+#ifdef WITH_QPBO
+           // NON reduced inference
+           if(param.reducedInf_==false){
+#endif  
+              typename CplexSubInf::Parameter p;
+              p.integerConstraint_ = true;
+              p.numberOfThreads_   = 1;
+              p.timeLimit_         = param.fusionTimeLimit_;
+              fusedValue = fusionMover. template fuse<CplexSubInf> (p,true);
+ #ifdef WITH_QPBO
+           } 
+           // reduced inference
+           else{
+              typedef typename ReducedInferenceHelper<SubGmType>::InfGmType ReducedGmType;
+              typedef opengm::LPCplex<ReducedGmType, AccumulationType>      _CplexSubInf;
+              typedef ReducedInference<SubGmType,AccumulationType,_CplexSubInf>          CplexReducedSubInf; 
+              typename _CplexSubInf::Parameter _subInfParam;
+              _subInfParam.integerConstraint_ = true; 
+              _subInfParam.numberOfThreads_   = 1;
+              _subInfParam.timeLimit_         = param.fusionTimeLimit_; 
+              typename CplexReducedSubInf::Parameter subInfParam(true,param.tentacles_,param.connectedComponents_,_subInfParam);
+              fusedValue = fusionMover. template fuse<CplexReducedSubInf> (subInfParam,true); 
+           }
+ #endif
+        }
+        #endif
+
+        #ifdef WITH_QPBO
+        else if(param.fusionSolver_==SelfFusionType::QpboFusion ){
+            if(selfFusion.maxOrder()<=2){
+                fusedValue = fusionMover. template fuseQpbo<QpboSubInf> ();
+            }
+            else{
+                typename HQPBOSubInf::Parameter subInfParam;
+                fusedValue = fusionMover. template fuse<HQPBOSubInf> (subInfParam,true);
+            }
+        }
+        #endif
+        else{
+           throw std::runtime_error("Unknown Fusion Type! Maybe caused by missing linking!");
+        }
+
+        // write fusion result into best arg
+        std::copy(argOut.begin(),argOut.end(),argBest.begin());
+        return fusedValue;
+    }
+
+
     const GraphicalModelType & gm_;
     SelfFusionType & selfFusion_;
     SelfFusionVisitorType & selfFusionVisitor_;
@@ -258,6 +392,7 @@ struct FusionVisitor{
     ValueType lastInfValue_;
     size_t returnFlag_;
     size_t numNoProgress_;
+    bool initialize_;
 
 };
 
@@ -278,6 +413,7 @@ public:
     typedef SelfFusion<INFERENCE> SelfType;
 
     typedef INFERENCE ToFuseInferenceType;
+    typedef detail_self_fusion::ProposalQueue<LabelType, ValueType> ProposalQueueType;
 
     enum FusionSolver{
         QpboFusion,
@@ -297,7 +433,9 @@ public:
         const bool tentacles = false,
         const bool connectedComponents = false,
         const double fusionTimeLimit = 100.0,
-        const size_t numStopIt = 10
+        const size_t numStopIt = 10,
+        const size_t numberOfThreads = 1,
+        const size_t queueSize = 4
       )
       : fuseNth_(fuseNth),
         fusionSolver_(fusionSolver),
@@ -307,7 +445,10 @@ public:
         connectedComponents_(connectedComponents),
         tentacles_(tentacles),
         fusionTimeLimit_(fusionTimeLimit),
-        numStopIt_(numStopIt)
+        numStopIt_(numStopIt),
+        infParams_(),
+        numberOfThreads_(numberOfThreads),
+        queueSize_(queueSize)
       {
 
       }
@@ -320,6 +461,15 @@ public:
       bool tentacles_;
       double fusionTimeLimit_;
       size_t numStopIt_;
+      /// parameters of further base solvers, their labelings are fused as well
+      std::vector<typename INFERENCE::Parameter> infParams_;
+      /// 1: the labelings are fused on the thread of the base solver, which are run one after the other,
+      /// otherwise all base solvers and a fusion worker run concurrently (0 = all available threads,
+      /// at least the number of base solvers plus one is needed to run all at the same time), used only WITH_OPENMP
+      size_t numberOfThreads_;
+      /// maximal number of labelings waiting for the fusion worker, the oldest is dropped
+      /// if a base solver proposes a labeling to a full queue
+      size_t queueSize_;
    };
 
    SelfFusion(const GraphicalModelType&, const Parameter& = Parameter());
@@ -347,6 +497,10 @@ public:
     }
 
 private:
+    template<class VisitorType>
+    void inferConcurrent(VisitorType&);
+    template<class VisitorType>
+    void fuseProposals(VisitorType&, ProposalQueueType&);
 
     Parameter param_;
     size_t maxOrder_;
@@ -424,15 +578,112 @@ InferenceTermination SelfFusion<INFERENCE>::infer
 
    visitor.begin(*this);
    visitor.addLog("infValue");
+   #ifdef WITH_OPENMP
+   if(param_.numberOfThreads_!=1){
+      this->inferConcurrent(visitor);
+      visitor.end(*this);
+      return NORMAL;
+   }
+   #endif
    // the fusion visitor will do the job...
-   FusionVisitor<INFERENCE,SelfType,VisitorType> fusionVisitor(*this,visitor,argBest_,value_,bound_,param_.fuseNth_);
-
-   INFERENCE inf(gm_,param_.infParam_);
-   inf.infer(fusionVisitor);
+   for(size_t s=0;s<=param_.infParams_.size();++s){
+      FusionVisitor<INFERENCE,SelfType,VisitorType> fusionVisitor(*this,visitor,argBest_,value_,bound_,param_.fuseNth_,s==0);
+      INFERENCE inf(gm_,s==0 ? param_.infParam_ : param_.infParams_[s-1]);
+      inf.infer(fusionVisitor);
+   }
    visitor.end(*this);
    return NORMAL;
 }
 
+/// runs the base solvers and a fusion worker concurrently. The base solvers
+/// propose their labelings through a bounded queue and never wait for the fusion.
+/// The fusion worker is the last task, such that with fewer threads than tasks
+/// it starts when a base solver is done, rather than occupying a thread that
+/// a base solver needs.
+template<class INFERENCE>
+template<class VisitorType>
+void SelfFusion<INFERENCE>::inferConcurrent
+(
+   VisitorType& visitor
+)
+{
+   #ifdef WITH_OPENMP
+   const int nThreads = param_.numberOfThreads_ > 0 ? static_cast<int>(param_.numberOfThreads_) : omp_get_max_threads();
+   #endif
+   const std::ptrdiff_t numberOfSolvers = static_cast<std::ptrdiff_t>(param_.infParams_.size()) + 1;
+   ProposalQueueType queue(param_.queueSize_, static_cast<size_t>(numberOfSolvers));
+   std::vector<std::string> errors(numberOfSolvers + 1);
+   #ifdef WITH_OPENMP
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t j=0;j<=numberOfSolvers;++j){
+      // exceptions must not leave the parallel region
+      if(j<numberOfSolvers){
+         try{
+            INFERENCE inf(gm_,j==0 ? param_.infParam_ : param_.infParams_[j-1]);
+            detail_self_fusion::ProposalVisitor<INFERENCE,ProposalQueueType> proposalVisitor(queue,param_.fuseNth_);
+            inf.infer(proposalVisitor);
+         }
+         catch(std::exception& e){
+            errors[j]=e.what();
+         }
+         queue.producerDone();
+      }
+      else{
+         try{
+            this->fuseProposals(visitor,queue);
+         }
+         catch(std::exception& e){
+            errors[j]=e.what();
+            queue.stop();
+         }
+      }
+   }
+   for(size_t j=0;j<errors.size();++j){
+      if(!errors[j].empty()){
+         throw RuntimeError(errors[j]);
+      }
+   }
+}
+
+/// fuses the proposals until all base solvers are done, stops the base solvers
+/// if the visitor requests it or after numStopIt_ fusions without improvement
+template<class INFERENCE>
+template<class VisitorType>
+void SelfFusion<INFERENCE>::fuseProposals
+(
+   VisitorType& visitor,
+   ProposalQueueType& queue
+)
+{
+   typedef FusionVisitor<INFERENCE,SelfType,VisitorType> FusionVisitorType;
+   typename FusionVisitorType::FusionMoverType fusionMover(gm_);
+   typename ProposalQueueType::ProposalType proposal;
+   std::vector<LabelType> argOut(gm_.numberOfVariables());
+   bool initialized=false;
+   size_t numNoProgress=0;
+   while(queue.pop(proposal)){
+      if(AccumulationType::ibop(proposal.bound_,bound_)){
+         bound_=proposal.bound_;
+      }
+      const ValueType oldValue=value_;
+      if(!initialized){
+         std::copy(proposal.labels_.begin(),proposal.labels_.end(),argBest_.begin());
+         value_=proposal.value_;
+         initialized=true;
+      }
+      else{
+         value_=FusionVisitorType::fuse(fusionMover,*this,argBest_,value_,proposal.labels_,proposal.value_,argOut);
+      }
+      const size_t returnFlag=visitor(*this);
+      visitor.log("infValue",proposal.value_);
+      numNoProgress = (oldValue==value_ ? numNoProgress+1 : 0);
+      if(returnFlag!=visitors::VisitorReturnFlag::ContinueInf || numNoProgress>=param_.numStopIt_){
+         queue.stop();
+      }
+   }
+}
+
 template<class INFERENCE>
 inline InferenceTermination
 SelfFusion<INFERENCE>::arg
@@ -4,6 +4,7 @@
 
 #include "opengm/inference/inference.hxx"
 #include "opengm/inference/visitors/visitors.hxx"
+#include "opengm/utilities/random.hxx"
 #include "submodular-ibfs.hpp"
 
 namespace opengm {
@@ -307,10 +308,10 @@ SoS_UBWrapper<GM, ACC>::setInitialLabelRandom
 (
    unsigned int seed
 ) {
-   srand(seed);
+   CounterBasedRandom random(seed);
    label_.resize(gm_.numberOfVariables());
    for(size_t i=0; i<gm_.numberOfVariables();++i) {
-      label_[i] = rand() % gm_.numberOfLabels(i);
+      label_[i] = random.uniformInteger(static_cast<LabelType>(gm_.numberOfLabels(i)));
    }
 }
 }
@@ -4,8 +4,8 @@
 
 #include <vector>
 #include <set>
-#include <stack>
 #include <cmath>
+#include <cstddef>
 #include <algorithm>
 #include <iostream>
 
@@ -16,12 +16,16 @@
 #include "opengm/operations/maximizer.hxx"
 #include "opengm/utilities/random.hxx"
 #include "opengm/utilities/indexing.hxx"
+#include "opengm/utilities/disjoint-set.hxx"
 #include "opengm/datastructures/randomaccessset.hxx"
-#include "opengm/datastructures/partition.hxx"
 #include "opengm/inference/movemaker.hxx"
-#include "opengm/inference/visitors/visitor.hxx"
+#include "opengm/inference/visitors/visitors.hxx"
 #include "opengm/functions/view_convert_function.hxx"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace opengm {
 
 /// \cond suppress doxygen
@@ -46,6 +50,7 @@ namespace detail_swendsenwang {
          static ProbabilityType convert(const T x)
             { return static_cast<ProbabilityType>(std::exp(-x)); }
    };
+
 }
 /// \endcond no longer suppress doxygen
 
@@ -121,7 +126,7 @@ public:
    typedef double ProbabilityType;
    typedef SwendsenWangEmptyVisitor<SwendsenWang<GM, ACC> > EmptyVisitorType;
    typedef SwendsenWangVerboseVisitor<SwendsenWang<GM, ACC> > VerboseVisitorType;
-   typedef TimingVisitor<SwendsenWang<GM, ACC> > TimingVisitorType;
+   typedef visitors::TimingVisitor<SwendsenWang<GM, ACC> > TimingVisitorType;
 
    struct Parameter
    {
@@ -130,18 +135,27 @@ public:
          const size_t maxNumberOfSamplingSteps = 1e5,
          const size_t numberOfBurnInSteps = 1e5,
          ProbabilityType lowestAllowedProbability = 1e-6,
-         const std::vector<LabelType>& initialState = std::vector<LabelType>()
+         const std::vector<LabelType>& initialState = std::vector<LabelType>(),
+         const size_t numberOfThreads = 1,
+         const size_t seed = 0
       )
       :  maxNumberOfSamplingSteps_(maxNumberOfSamplingSteps),
          numberOfBurnInSteps_(numberOfBurnInSteps),
          lowestAllowedProbability_(lowestAllowedProbability),
-         initialState_(initialState)
+         initialState_(initialState),
+         numberOfThreads_(numberOfThreads),
+         seed_(seed)
       {}
 
       size_t maxNumberOfSamplingSteps_;
       size_t numberOfBurnInSteps_;
       ProbabilityType lowestAllowedProbability_;
       std::vector<LabelType> initialState_;
+      /// threads used for bond sampling and clustering (0 = OpenMP default),
+      /// the samples do not depend on the number of threads
+      size_t numberOfThreads_;
+      /// seed of the counter-based random numbers, equal seeds yield equal samples
+      size_t seed_;
    };
 
    SwendsenWang(const GraphicalModelType&, const Parameter& param = Parameter());
@@ -160,15 +174,28 @@ public:
 
 private:
    void computeEdgeProbabilities();
-   void cluster(Partition<size_t>&) const;
+   size_t cluster();
+   size_t drawCluster(const size_t);
+   void collectCluster(const size_t, std::vector<size_t>&, std::vector<size_t>&);
+   size_t numberOfThreads() const;
    template<bool BURNED_IN, class VARIABLE_ITERATOR, class STATE_ITERATOR>
       bool move(VARIABLE_ITERATOR, VARIABLE_ITERATOR, STATE_ITERATOR);
 
    Parameter parameter_;
    const GraphicalModelType& gm_;
    Movemaker<GraphicalModelType> movemaker_;
-   std::vector<RandomAccessSet<size_t> > variableAdjacency_;
-   std::vector<std::vector<ProbabilityType> > edgeProbabilities_;
+   // edges (pairs of adjacent variables j < k) and adjacency in CSR format
+   std::vector<size_t> edges_;
+   std::vector<ProbabilityType> edgeProbabilities_;
+   std::vector<size_t> adjacencyBegin_;
+   std::vector<size_t> adjacentVariables_;
+   std::vector<size_t> adjacentEdges_;
+   // clustering of the current sampling step
+   concurrent_disjoint_set<size_t> bonds_;
+   std::vector<size_t> clusterOf_;
+   std::vector<size_t> blockOffsets_;
+   std::vector<unsigned char> visited_;
+   size_t step_;
    std::vector<LabelType> currentBestState_;
    ValueType currentBestValue_;
 };
@@ -183,18 +210,46 @@ SwendsenWang<GM, ACC>::SwendsenWang
 :  parameter_(param),
    gm_(gm),
    movemaker_(param.initialState_.size() == gm.numberOfVariables() ? Movemaker<GM>(gm, param.initialState_.begin()) : Movemaker<GM>(gm)),
-   variableAdjacency_(gm.numberOfVariables()),
-   edgeProbabilities_(gm.numberOfVariables()),
+   edges_(),
+   edgeProbabilities_(),
+   adjacencyBegin_(gm.numberOfVariables() + 1, 0),
+   adjacentVariables_(),
+   adjacentEdges_(),
+   bonds_(gm.numberOfVariables()),
+   clusterOf_(gm.numberOfVariables()),
+   blockOffsets_(),
+   visited_(gm.numberOfVariables(), 0),
+   step_(0),
    currentBestState_(gm.numberOfVariables()),
    currentBestValue_(movemaker_.value())
 {
    if(parameter_.initialState_.size() != 0 && parameter_.initialState_.size() != gm.numberOfVariables()) {
       throw RuntimeError("The size of the initial state does not match the number of variables.");
    }
-   gm.variableAdjacencyList(variableAdjacency_);
+   const typename GraphicalModelType::AdjacencyType& variableAdjacency = gm.variableAdjacency();
    for(size_t j=0; j<gm_.numberOfVariables(); ++j) {
-      edgeProbabilities_[j].resize(variableAdjacency_[j].size());
+      adjacencyBegin_[j + 1] = adjacencyBegin_[j] + variableAdjacency[j].size();
+      for(size_t k=0; k<variableAdjacency[j].size(); ++k) {
+         if(j < variableAdjacency[j][k]) {
+            edges_.push_back(j);
+            edges_.push_back(variableAdjacency[j][k]);
+         }
+      }
+   }
+   adjacentVariables_.resize(adjacencyBegin_.back());
+   adjacentEdges_.resize(adjacencyBegin_.back());
+   {
+      std::vector<size_t> fill(adjacencyBegin_.begin(), adjacencyBegin_.end() - 1);
+      for(size_t e=0; e<edges_.size() / 2; ++e) {
+         const size_t j = edges_[2 * e];
+         const size_t k = edges_[2 * e + 1];
+         adjacentVariables_[fill[j]] = k;
+         adjacentEdges_[fill[j]++] = e;
+         adjacentVariables_[fill[k]] = j;
+         adjacentEdges_[fill[k]++] = e;
+      }
    }
+   edgeProbabilities_.resize(edges_.size() / 2, 0);
    computeEdgeProbabilities();
 }
 
@@ -214,6 +269,7 @@ SwendsenWang<GM, ACC>::reset()
       std::fill(currentBestState_.begin(),currentBestState_.end(),0);
    }
    currentBestValue_ = movemaker_.value();
+   step_ = 0;
    computeEdgeProbabilities();
 }
 
@@ -239,64 +295,29 @@ SwendsenWang<GM, ACC>::infer
    VISITOR& visitor
 )
 {
-   Partition<size_t> partition(gm_.numberOfVariables());
-   std::vector<size_t> representatives(gm_.numberOfVariables());
-   std::vector<bool> visited(gm_.numberOfVariables());
-   std::stack<size_t> stack;
    std::vector<size_t> variablesInCluster;
    std::vector<size_t> variablesAroundCluster;
-   for(size_t j=0; j<parameter_.numberOfBurnInSteps_ + parameter_.maxNumberOfSamplingSteps_; ++j) {
+   for(size_t j=0; j<parameter_.numberOfBurnInSteps_ + parameter_.maxNumberOfSamplingSteps_; ++j, ++step_) {
       // cluster the variable adjacency graph by randomly removing edges
-      cluster(partition);
+      const size_t numberOfClusters = cluster();
+
+      // the remaining random numbers of the step are drawn from a stream split off the bond stream
+      CounterBasedRandom random = CounterBasedRandom(parameter_.seed_, step_).split(0);
 
       // draw one cluster at random
-      partition.representatives(representatives.begin());
-      RandomUniform<size_t> randomNumberGeneratorCluster(0, partition.numberOfSets());
-      const size_t representative = representatives[randomNumberGeneratorCluster()];
+      const size_t representative = drawCluster(random.uniformInteger(numberOfClusters));
       // collect all variables in and around the drawn cluster
-      variablesInCluster.clear();
-      variablesAroundCluster.clear();
-      visited[representative] = true;
-      stack.push(representative);
-      while(!stack.empty()) {
-         const size_t variable = stack.top();
-         stack.pop();
-         variablesInCluster.push_back(variable);
-         for(size_t k=0; k<variableAdjacency_[variable].size(); ++k) {
-            const size_t adjacentVariable = variableAdjacency_[variable][k];
-            if(!visited[adjacentVariable]) {
-               visited[adjacentVariable] = true;
-               if(partition.find(adjacentVariable) == representative) { // if in cluster
-                  stack.push(adjacentVariable);
-               }
-               else {
-                  variablesAroundCluster.push_back(adjacentVariable);
-               }
-            }
-         }
-      }
-
-      // clean vector visited
-      for(size_t k=0; k<variablesInCluster.size(); ++k) {
-         visited[variablesInCluster[k]] = false;
-      }
-      for(size_t k=0; k<variablesAroundCluster.size(); ++k) {
-         visited[variablesAroundCluster[k]] = false;
-      }
+      collectCluster(representative, variablesInCluster, variablesAroundCluster);
 
       // assertion testing
       if(!NO_DEBUG) {
-         for(size_t k=0; k<visited.size(); ++k) {
-            OPENGM_ASSERT(!visited[k]);
-         }
          for(size_t k=0; k<variablesInCluster.size(); ++k) {
             OPENGM_ASSERT(gm_.numberOfLabels(variablesInCluster[k]) == gm_.numberOfLabels(representative));
          }
       }
 
       // draw a new label at random
-      RandomUniform<size_t> randomNumberGeneratorState(0, gm_.numberOfLabels(representative));
-      size_t targetLabel = randomNumberGeneratorState();
+      size_t targetLabel = random.uniformInteger(static_cast<size_t>(gm_.numberOfLabels(representative)));
       std::vector<size_t> targetLabels(variablesInCluster.size(), targetLabel); // TODO add simpler function to movemaker
 
       if(j < parameter_.numberOfBurnInSteps_) {
@@ -318,18 +339,16 @@ SwendsenWang<GM, ACC>::infer
       ProbabilityType targetValueProposal = 1;
       for(std::vector<size_t>::const_iterator vi = variablesAroundCluster.begin(); vi != variablesAroundCluster.end(); ++vi) {
          if(movemaker_.state(*vi) == movemaker_.state(representative)) { // *vi has old label
-            for(size_t k=0; k<variableAdjacency_[*vi].size(); ++k) {
-               const size_t nvi = variableAdjacency_[*vi][k];
-               if(partition.find(nvi) == representative) { // if *nvi is in cluster
-                  currentValueProposal *= (1.0 - edgeProbabilities_[*vi][k]);
+            for(size_t k=adjacencyBegin_[*vi]; k<adjacencyBegin_[*vi + 1]; ++k) {
+               if(clusterOf_[adjacentVariables_[k]] == representative) { // if neighbor is in cluster
+                  currentValueProposal *= (1.0 - edgeProbabilities_[adjacentEdges_[k]]);
                }
             }
          }
          else if(movemaker_.state(*vi) == targetLabel) { // *vi has new label
-            for(size_t k=0; k<variableAdjacency_[*vi].size(); ++k) {
-               const size_t nvi = variableAdjacency_[*vi][k];
-               if(partition.find(nvi) == representative) { // if *nvi is in cluster
-                  targetValueProposal *= (1.0 - edgeProbabilities_[*vi][k]);
+            for(size_t k=adjacencyBegin_[*vi]; k<adjacencyBegin_[*vi + 1]; ++k) {
+               if(clusterOf_[adjacentVariables_[k]] == representative) { // if neighbor is in cluster
+                  targetValueProposal *= (1.0 - edgeProbabilities_[adjacentEdges_[k]]);
                }
             }
          }
@@ -343,8 +362,7 @@ SwendsenWang<GM, ACC>::infer
          visitor(*this, j, variablesInCluster.size(), true, false);
       }
       else {
-         RandomUniform<ProbabilityType> randomNumberGeneratorAcceptance(0, 1);
-         if(metropolisHastingsProbability >= randomNumberGeneratorAcceptance()) { // accept
+         if(metropolisHastingsProbability >= random.uniform()) { // accept
             move<true>(variablesInCluster.begin(), variablesInCluster.end(), targetLabels.begin());
             visitor(*this, j, variablesInCluster.size(), true, false);
          }
@@ -443,10 +461,9 @@ SwendsenWang<GM, ACC>::computeEdgeProbabilities()
 {
    std::set<size_t> factors;
    std::set<size_t> connectedVariables;
-   size_t variables[] = {0, 0};
-   for(variables[0] = 0; variables[0] < gm_.numberOfVariables(); ++variables[0]) {
-      for(size_t j = 0; j < variableAdjacency_[variables[0]].size(); ++j) {
-         variables[1] = variableAdjacency_[variables[0]][j];
+   for(size_t e = 0; e < edgeProbabilities_.size(); ++e) {
+      {
+         const size_t variables[] = {edges_[2 * e], edges_[2 * e + 1]};
          if(gm_.numberOfLabels(variables[0]) == gm_.numberOfLabels(variables[1])) {
             // for all pairs of connected variables, variables[0] and variables[1],
             // that have the same number of states, identify
@@ -527,36 +544,131 @@ SwendsenWang<GM, ACC>::computeEdgeProbabilities()
                throw RuntimeError("Marginal probabilities are smaller than the allowed minimum.");
             }
 
-            edgeProbabilities_[variables[0]][j] = probUnequal;
+            edgeProbabilities_[e] = probUnequal;
+         }
+      }
+   }
+}
+
+template<class GM, class ACC>
+inline size_t
+SwendsenWang<GM, ACC>::numberOfThreads() const
+{
+#ifdef WITH_OPENMP
+   return parameter_.numberOfThreads_ > 0 ? parameter_.numberOfThreads_ : static_cast<size_t>(omp_get_max_threads());
+#else
+   return 1;
+#endif
+}
+
+/// sample the bonds of the current step and label each variable with the
+/// representative (smallest variable index) of its cluster
+/// \return number of clusters
+template<class GM, class ACC>
+size_t
+SwendsenWang<GM, ACC>::cluster()
+{
+   const std::ptrdiff_t numberOfVariables = static_cast<std::ptrdiff_t>(gm_.numberOfVariables());
+   const std::ptrdiff_t numberOfEdges = static_cast<std::ptrdiff_t>(edgeProbabilities_.size());
+   const std::ptrdiff_t numberOfBlocks = static_cast<std::ptrdiff_t>(numberOfThreads());
+   const std::ptrdiff_t blockSize = (numberOfVariables + numberOfBlocks - 1) / numberOfBlocks;
+   blockOffsets_.assign(numberOfBlocks + 1, 0);
+   bonds_.reset();
+#ifdef WITH_OPENMP
+#pragma omp parallel num_threads(static_cast<int>(numberOfBlocks))
+#endif
+   {
+      // turn each edge between equally labeled variables on with probability edgeProbabilities_[e]
+#ifdef WITH_OPENMP
+#pragma omp for schedule(static)
+#endif
+      for(std::ptrdiff_t e = 0; e < numberOfEdges; ++e) {
+         const size_t j = edges_[2 * e];
+         const size_t k = edges_[2 * e + 1];
+         if(movemaker_.state(j) == movemaker_.state(k)
+         && edgeProbabilities_[e] > CounterBasedRandom::uniformAt(parameter_.seed_, step_, e)) {
+            bonds_.join(j, k);
          }
       }
+      // relabel, count the clusters per block of variables
+#ifdef WITH_OPENMP
+#pragma omp for schedule(static, 1)
+#endif
+      for(std::ptrdiff_t b = 0; b < numberOfBlocks; ++b) {
+         const std::ptrdiff_t end = std::min(numberOfVariables, (b + 1) * blockSize);
+         size_t count = 0;
+         for(std::ptrdiff_t j = b * blockSize; j < end; ++j) {
+            clusterOf_[j] = bonds_.find(j);
+            count += (clusterOf_[j] == static_cast<size_t>(j));
+         }
+         blockOffsets_[b + 1] = count;
+      }
+   }
+   for(std::ptrdiff_t b = 0; b < numberOfBlocks; ++b) {
+      blockOffsets_[b + 1] += blockOffsets_[b];
+   }
+   return blockOffsets_.back();
+}
+
+/// \return representative of the n-th cluster (clusters ordered by representative)
+template<class GM, class ACC>
+size_t
+SwendsenWang<GM, ACC>::drawCluster
+(
+   const size_t n
+)
+{
+   OPENGM_ASSERT(n < blockOffsets_.back());
+   const size_t b = static_cast<size_t>(std::upper_bound(blockOffsets_.begin(), blockOffsets_.end(), n) - blockOffsets_.begin()) - 1;
+   const size_t blockSize = (gm_.numberOfVariables() + blockOffsets_.size() - 2) / (blockOffsets_.size() - 1);
+   size_t count = blockOffsets_[b];
+   for(size_t j = b * blockSize; ; ++j) {
+      if(clusterOf_[j] == j) {
+         if(count == n) {
+            return j;
+         }
+         ++count;
+      }
    }
 }
 
 template<class GM, class ACC>
 void
-SwendsenWang<GM, ACC>::cluster
+SwendsenWang<GM, ACC>::collectCluster
 (
-   Partition<size_t>& out
-) const
+   const size_t representative,
+   std::vector<size_t>& variablesInCluster,
+   std::vector<size_t>& variablesAroundCluster
+)
 {
-   // randomly merge variables
-   out.reset(gm_.numberOfVariables());
-   opengm::RandomUniform<ProbabilityType> randomNumberGenerator(0.0, 1.0);
-   size_t variables[] = {0, 0};
-   for(variables[0] = 0; variables[0] < gm_.numberOfVariables(); ++variables[0]) {
-      for(size_t j = 0; j < variableAdjacency_[variables[0]].size(); ++j) {
-         variables[1] = variableAdjacency_[variables[0]][j];
-         if(variables[0] < variables[1]) { // only once for each pair
-            if(movemaker_.state(variables[0]) == movemaker_.state(variables[1])) {
-               if(edgeProbabilities_[variables[0]][j] > randomNumberGenerator()) {
-                  // turn edge on with probability edgeProbabilities_[variables[0]][variables[1]]
-                  out.merge(variables[0], variables[1]);
-               }
+   // breadth first search from the representative, variablesInCluster is used as queue
+   variablesInCluster.clear();
+   variablesAroundCluster.clear();
+   visited_[representative] = 1;
+   variablesInCluster.push_back(representative);
+   for(size_t k = 0; k < variablesInCluster.size(); ++k) {
+      const size_t variable = variablesInCluster[k];
+      for(size_t m = adjacencyBegin_[variable]; m < adjacencyBegin_[variable + 1]; ++m) {
+         const size_t adjacentVariable = adjacentVariables_[m];
+         if(!visited_[adjacentVariable]) {
+            visited_[adjacentVariable] = 1;
+            if(clusterOf_[adjacentVariable] == representative) { // if in cluster
+               variablesInCluster.push_back(adjacentVariable);
+            }
+            else {
+               variablesAroundCluster.push_back(adjacentVariable);
             }
          }
       }
    }
+
+   // clean vector visited
+   for(size_t k = 0; k < variablesInCluster.size(); ++k) {
+      visited_[variablesInCluster[k]] = 0;
+   }
+   for(size_t k = 0; k < variablesAroundCluster.size(); ++k) {
+      visited_[variablesAroundCluster[k]] = 0;
+   }
 }
 
 template<class SW>
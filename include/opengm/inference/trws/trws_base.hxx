@@ -53,8 +53,8 @@ public:
 	DecompositionStorage(const GM& gm,StructureType structureType=GENERALSTRUCTURE, const DDVectorType* pddvector=0);
 	~DecompositionStorage();
 
-	const GM& masterModel()const{return _gm;}
-	LabelType numberOfLabels(IndexType varId)const{return _gm.numberOfLabels(varId);}
+	const GM& masterModel()const{return *_gm;}
+	LabelType numberOfLabels(IndexType varId)const{return _gm->numberOfLabels(varId);}
 	IndexType numberOfModels()const{return (IndexType)_subModels.size();}
 	IndexType numberOfSharedVariables()const{return (IndexType)_variableDecomposition.size();}
 	SubModel& subModel(IndexType modelId){return *_subModels[modelId];}
@@ -71,10 +71,11 @@ public:
 	void getDDVector(DDVectorType* ddvector)const;
 	size_t  getDDVectorSize()const;
 	void addDDvector(const DDVectorType& ddvector);
+	void rebind(const GM& gm);
 private:
 	void _InitSubModels(const DDVectorType* pddvector=0);
 	//void _addDDvector(const DDVectorType& ddvector);
-	const GM& _gm;
+	const GM* _gm;
 	StructureType  _structureType;
 	std::vector<SubModel*> _subModels;
 	std::vector<SubVariableListType> _variableDecomposition;
@@ -263,6 +264,11 @@ public:
 	template<class VISITOR> InferenceTermination infer_visitor_updates(VISITOR& visitor, size_t* pinterCounter=0);
 	InferenceTermination core_infer(size_t* piterCounter=0){EmptyVisitorParent vis; EmptyVisitorType visitor(&vis,this);  return _core_infer(visitor,piterCounter);};
 	const FactorProperties& getFactorProperties()const{return _factorProperties;}
+	/*
+	 * to be called after the storage has been bound to a new model of the same structure:
+	 * keeps the subsolvers and the dual variables, resets the bounds
+	 */
+	virtual void rebind();
 
 	/*
 	 * typedef TRWS_Reparametrizer<Storage,ACC> ReparametrizerType;
@@ -504,6 +510,15 @@ public:
 	{}
 	~MaxSumTRWS(){};
 
+	void rebind()
+	{
+		parent::rebind();
+		_pseudoBoundValue=0.0;
+		_localConsistencyCounter=0;
+		_agree_count=0;
+		_treeAgree_iterationCounter=0;
+	}
+
 	void getTreeAgreement(std::vector<bool>& out,std::vector<LabelType>* plabeling=0,std::vector<std::vector<LabelType> >* ptreeLabelings=0);
 	bool CheckTreeAgreement(InferenceTermination* pterminationCode);
 protected:
@@ -565,6 +580,17 @@ _sumMarginal()
 #endif
 }
 
+template <class SubSolver>
+void TRWSPrototype<SubSolver>::rebind()
+{
+	_factorProperties.rebind(_storage.masterModel());
+	_dualBound=ACC::template ineutral<ValueType>();
+	_oldDualBound=ACC::template ineutral<ValueType>();
+	_lastDualUpdate=0;
+	_integerBound=ACC::template neutral<ValueType>();
+	_bestIntegerBound=ACC::template neutral<ValueType>();
+}
+
 template <class SubSolver>
 TRWSPrototype<SubSolver>::~TRWSPrototype()
 {
@@ -582,7 +608,11 @@ void TRWSPrototype<SubSolver>::_InitSubSolvers()
 template <class SubSolver>
 bool TRWSPrototype<SubSolver>::CheckDualityGap(ValueType primalBound,ValueType dualBound)
 {
-	OPENGM_ASSERT((ACC::bop(-1,1) ? 1 : -1 )*(primalBound-dualBound) >  -dualBound*std::numeric_limits<ValueType>::epsilon());
+	// both bounds are accumulated in ValueType over all factors of the model, so each carries a rounding
+	// error of up to numberOfFactors*epsilon relative to its magnitude; the primal bound may therefore fall
+	// short of the dual one by that much (e.g. float models), and the tolerance must not change sign with the bound
+	OPENGM_ASSERT((ACC::bop(-1,1) ? 1 : -1 )*(primalBound-dualBound) >=
+			-fabs(dualBound)*_storage.masterModel().numberOfFactors()*std::numeric_limits<ValueType>::epsilon());
 
 //	_fout << "(ACC::bop(-1,1) ? 1 : -1 )*(primalBound-dualBound)=" << (ACC::bop(-1,1) ? 1 : -1 )*(primalBound-dualBound)
 //			<< ", -dualBound*std::numeric_limits<ValueType>::epsilon()=" << -dualBound*std::numeric_limits<ValueType>::epsilon()<<std::endl;
@@ -926,7 +956,7 @@ void TRWSPrototype<SubSolver>::_EvaluateIntegerBounds()
 //================================= DecompositionStorage IMPLEMENTATION =================================================
 template<class GM>
 DecompositionStorage<GM>::DecompositionStorage(const GM& gm,StructureType structureType, const DDVectorType* pddvector):
-_gm(gm),
+_gm(&gm),
 _structureType(structureType),
 _subModels(),
 _variableDecomposition(),
@@ -950,28 +980,28 @@ void DecompositionStorage<GM>::_InitSubModels(const DDVectorType* pddvector)
 	{
 	case GRIDSTRUCTURE:
 	{
-		pdecomposition=std::auto_ptr<Decomposition<GM> >(new GridDecomposition<GM>(_gm));
+		pdecomposition=std::auto_ptr<Decomposition<GM> >(new GridDecomposition<GM>(*_gm));
 		break;
 	}
 	case EDGESTRUCTURE:
 	{
-		pdecomposition=std::auto_ptr<Decomposition<GM> >(new EdgeDecomposition<GM>(_gm));
+		pdecomposition=std::auto_ptr<Decomposition<GM> >(new EdgeDecomposition<GM>(*_gm));
 		break;
 	}
 	case GENERALSTRUCTURE:
 	{
-		pdecomposition=std::auto_ptr<Decomposition<GM> >(new MonotoneChainsDecomposition<GM>(_gm));
+		pdecomposition=std::auto_ptr<Decomposition<GM> >(new MonotoneChainsDecomposition<GM>(*_gm));
 		break;
 	}
 	default:
 		throw std::runtime_error("DecompositionStorage::_InitSubModels: Unknown decomposition type!");
 	}
 //	if (_structureType==GRIDSTRUCTURE)
-//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new GridDecomposition<GM>(_gm));
+//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new GridDecomposition<GM>(*_gm));
 //	else (_structureType==EDGESTRUCTURE)
-//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new EdgeDecomposition<GM>(_gm));
+//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new EdgeDecomposition<GM>(*_gm));
 //	else
-//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new MonotoneChainsDecomposition<GM>(_gm));
+//		pdecomposition=std::auto_ptr<Decomposition<GM> >(new MonotoneChainsDecomposition<GM>(*_gm));
 
 	try{
 		pdecomposition->ComputeVariableDecomposition(&_variableDecomposition);
@@ -985,7 +1015,7 @@ void DecompositionStorage<GM>::_InitSubModels(const DDVectorType* pddvector)
 			for (size_t varIndx=0;varIndx<varList.size();++varIndx)
 				numOfSubModelsPerVar[varIndx]=_variableDecomposition[varList[varIndx]].size();
 
-			_subModels[modelId]= new SubModel(_gm,_var2FactorMap,varList,pdecomposition->getFactorList(modelId),numOfSubModelsPerVar);
+			_subModels[modelId]= new SubModel(*_gm,_var2FactorMap,varList,pdecomposition->getFactorList(modelId),numOfSubModelsPerVar);
 		};
 
 		if (pddvector!=0)
@@ -1035,14 +1065,14 @@ void DecompositionStorage<GM>::getDDVector(DDVectorType* pddvector)const
 	pddvector->resize(getDDVectorSize());
 	typename DDVectorType::iterator gradientIt=pddvector->begin();
 	UnaryFactor uf;
-	for (IndexType varId=0;varId<_gm.numberOfVariables();++varId)// all variables
+	for (IndexType varId=0;varId<_gm->numberOfVariables();++varId)// all variables
 	{
 		const SubVariableListType& varList=getSubVariableList(varId);
 
 		if (varList.size()==1) continue;
 		typename SubVariableListType::const_iterator modelIt=varList.begin();
-		uf.resize(_gm.numberOfLabels(varId));
-		_gm[_var2FactorMap(varId)].copyValues(uf.begin());
+		uf.resize(_gm->numberOfLabels(varId));
+		(*_gm)[_var2FactorMap(varId)].copyValues(uf.begin());
 		transform_inplace(uf.begin(),uf.end(),std::bind2nd(std::multiplies<ValueType>(),1.0/varList.size()));
 		++modelIt;
 		for(;modelIt!=varList.end();++modelIt) //all related models
@@ -1054,12 +1084,34 @@ void DecompositionStorage<GM>::getDDVector(DDVectorType* pddvector)const
 }
 
 
+/*
+ * binds to a model of the same structure: the unary factors of the subproblems are
+ * recomputed from the new model and the current dual (DD) vector is re-applied to them
+ */
+template<class GM>
+void DecompositionStorage<GM>::rebind(const GM& gm)
+{
+	DDVectorType ddvector;
+	getDDVector(&ddvector);
+	_gm=&gm;
+	typename SubModel::IndexList numOfSubModelsPerVar;
+	for (size_t modelId=0;modelId<_subModels.size();++modelId)
+	{
+		SubModel& subModel=*_subModels[modelId];
+		numOfSubModelsPerVar.resize(subModel.size());
+		for (IndexType varIndx=0;varIndx<subModel.size();++varIndx)
+			numOfSubModelsPerVar[varIndx]=_variableDecomposition[subModel.varIndex(varIndx)].size();
+		subModel.rebind(gm,numOfSubModelsPerVar);
+	}
+	addDDvector(ddvector);
+}
+
 template<class GM>
 size_t  DecompositionStorage<GM>::getDDVectorSize()const
 {
 	size_t varsize=0;
-	for (IndexType varId=0;varId<_gm.numberOfVariables();++varId)// all variables
-		varsize+=(getSubVariableList(varId).size()-1)*_gm.numberOfLabels(varId);
+	for (IndexType varId=0;varId<_gm->numberOfVariables();++varId)// all variables
+		varsize+=(getSubVariableList(varId).size()-1)*_gm->numberOfLabels(varId);
 	return varsize;
 }
 
@@ -1079,12 +1131,12 @@ template<class GM>
 void DecompositionStorage<GM>::PrintVariableDecompositionConsistency(std::ostream& fout)const
 {
 	fout << "Variable decomposition consistency:" <<std::endl;
-	for (size_t varId=0;varId<_gm.numberOfVariables();++varId)
+	for (size_t varId=0;varId<_gm->numberOfVariables();++varId)
 	{
 		fout << varId<<": ";
 		const SubVariableListType& varList=_variableDecomposition[varId];
 		typename SubVariableListType::const_iterator modelIt=varList.begin();
-		std::vector<ValueType> sum(_gm.numberOfLabels(varId),0.0);
+		std::vector<ValueType> sum(_gm->numberOfLabels(varId),0.0);
 		while (modelIt!=varList.end())
 		{
 			const SubModel& subModel=*_subModels[modelIt->subModelId_];
@@ -1092,8 +1144,8 @@ void DecompositionStorage<GM>::PrintVariableDecompositionConsistency(std::ostrea
 			  			sum.begin(),sum.begin(),std::plus<ValueType>());
 			++modelIt;
 		}
-		std::vector<ValueType> originalFactor(_gm.numberOfLabels(varId),0.0);
-		_gm[varId].copyValues(originalFactor.begin());
+		std::vector<ValueType> originalFactor(_gm->numberOfLabels(varId),0.0);
+		(*_gm)[varId].copyValues(originalFactor.begin());
 
 		std::transform(sum.begin(),sum.end(),originalFactor.begin(),sum.begin(),std::minus<ValueType>());
 		fout << std::accumulate(sum.begin(),sum.end(),(ValueType)0.0)<<std::endl;
@@ -445,7 +445,7 @@ void LPtoDecompositionStorage(const LPReparametrisationStorage<GM>& lpRepa, trws
 {
 	OPENGM_ASSERT(&lpRepa.graphicalModel() == &ptrwsRepa->masterModel());
 
-	typedef typename LPReparametrisationStorage<GM>::uIterator uIterator;
+	typedef typename LPReparametrisationStorage<GM>::const_uIterator const_uIterator;
 	typedef typename GM::ValueType ValueType;
 	typedef typename GM::IndexType IndexType;
 	typedef typename GM::LabelType LabelType;
@@ -477,25 +477,24 @@ void LPtoDecompositionStorage(const LPReparametrisationStorage<GM>& lpRepa, trws
 		  //unary=repaUnary/numberTrees
 		  std::copy(repaUnary.begin(),repaUnary.end(),uit_begin);
 		  //add only potentials belonging to the submodel
-//		  std::pair<uIterator,uIterator> repaIt;
-		  const typename LPReparametrisationStorage<GM>::UnaryFactor* prepaUF;
+		  std::pair<const_uIterator,const_uIterator> repaIt;
 		  if (modelIt->subVariableId_ < subModel.size()-1)
 			  {
 			    IndexType pwId=subModel.pwForwardFactor(modelIt->subVariableId_);
 			    if (lpRepa.graphicalModel()[pwId].variableIndex(0)==varId)
-			    	prepaUF=&lpRepa.get(pwId,0);
-			    else prepaUF=&lpRepa.get(pwId,1);
+			    	repaIt=lpRepa.getIterators(pwId,0);
+			    else repaIt=lpRepa.getIterators(pwId,1);
 
-	            std::transform(uit_begin,uit_end,prepaUF->begin(),uit_begin,std::plus<ValueType>());
+	            std::transform(uit_begin,uit_end,repaIt.first,uit_begin,std::plus<ValueType>());
 			  }
 		if (modelIt->subVariableId_ >0)
 			  {
 				  IndexType pwId=subModel.pwForwardFactor(modelIt->subVariableId_-1);
 				  if (lpRepa.graphicalModel()[pwId].variableIndex(0)==varId)
-					  prepaUF=&lpRepa.get(pwId,0);
-				  else prepaUF=&lpRepa.get(pwId,1);
+					  repaIt=lpRepa.getIterators(pwId,0);
+				  else repaIt=lpRepa.getIterators(pwId,1);
 
-				  std::transform(uit_begin,uit_end,prepaUF->begin(),uit_begin,std::plus<ValueType>());
+				  std::transform(uit_begin,uit_end,repaIt.first,uit_begin,std::plus<ValueType>());
 			  }
 
 	  }
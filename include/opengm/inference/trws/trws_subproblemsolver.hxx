@@ -52,9 +52,13 @@ public:
 	 * allocates the container (*pfactors) with sizes, corresponding to all unary factors of the associated graphoical model
 	 */
 	void AllocateUnaryFactors(std::vector<UnaryFactor>* pfactors);
+	/*
+	 * binds to a master model of the same structure and resets the unary factors
+	 */
+	void rebind(const GM& masterModel,const IndexList& numOfSequencesPerFactor);
 	MoveDirection pwDirection(IndexType pwInd)const{assert(pwInd<_pwDirection.size()); return _pwDirection[pwInd];};
 	IndexType pwForwardFactor(IndexType var)const{assert(var<_pwForwardIndex.size()); return _pwForwardIndex[var];}
-	const GM& masterModel()const{return _masterModel;}
+	const GM& masterModel()const{return *_masterModel;}
 	/*
 	 * unary factors access
 	 */
@@ -70,7 +74,7 @@ private:
 	void _Reset(const IndexList& numOfSequencesPerFactor);//TODO: set weights from a vector
 	void _Reset(IndexType var,IndexType numOfSequences);//TODO: set weights from a vector
 
-	const GM& _masterModel;
+	const GM* _masterModel;
 	/** var - in local coordinates (of the subProblem), var can be transformed from varIndex by _variable() function */
 	IndexList _directIndex;
 	IndexList _pwForwardIndex;
@@ -93,6 +97,7 @@ public:
 	typedef typename GM::LabelType LabelType;
 
 	FunctionParameters(const GM& gm);
+	void rebind(const GM& gm);
 	FunctionType getFunctionType(IndexType factorId)const
 	{
 		OPENGM_ASSERT(factorId<_factorTypes.size());
@@ -110,18 +115,36 @@ public:
 private:
 	void _checkConsistency() const;
 	void _getPottsParameters(const typename GM::FactorType& factor,ParameterStorageType* pstorage)const;
-	const GM& _gm;
+	void _Init();
+	const GM* _gm;
 	std::vector<ParameterStorageType> _parameters;
 	std::vector<FunctionType> _factorTypes;
 };
 
 template<class GM>
 FunctionParameters<GM>::FunctionParameters(const GM& gm)
-: _gm(gm),_parameters(_gm.numberOfFactors()),_factorTypes(_gm.numberOfFactors())
+: _gm(&gm),_parameters(gm.numberOfFactors()),_factorTypes(gm.numberOfFactors())
+{
+	_Init();
+}
+
+/*
+ * binds to a model of the same structure and updates the stored function parameters
+ */
+template<class GM>
+void FunctionParameters<GM>::rebind(const GM& gm)
 {
-	for (IndexType i=0;i<_gm.numberOfFactors();++i)
+	OPENGM_ASSERT(gm.numberOfFactors()==_parameters.size());
+	_gm=&gm;
+	_Init();
+}
+
+template<class GM>
+void FunctionParameters<GM>::_Init()
+{
+	for (IndexType i=0;i<_gm->numberOfFactors();++i)
 	{
-		const typename GM::FactorType& f=_gm[i];
+		const typename GM::FactorType& f=(*_gm)[i];
 
 		if ((f.numberOfVariables()==2) && f.isPotts())
 		{
@@ -136,8 +159,8 @@ FunctionParameters<GM>::FunctionParameters(const GM& gm)
 template<class GM>
 void  FunctionParameters<GM>::_checkConsistency()const
 {
-	OPENGM_ASSERT(_parameters.size()==_gm.numberOfFactors());
-	OPENGM_ASSERT(_factorTypes.size()==_gm.numberOfFactors());
+	OPENGM_ASSERT(_parameters.size()==_gm->numberOfFactors());
+	OPENGM_ASSERT(_factorTypes.size()==_gm->numberOfFactors());
 	for (size_t i=0;i<_parameters.size();++i)
 		if (_factorTypes[i]==POTTS)
 		{
@@ -527,7 +550,7 @@ SequenceStorage<GM>::SequenceStorage(const GM& masterModel,const VariableToFacto
 		const IndexList& variableList,
 		const IndexList& pwFactorList,
 		const IndexList& numOfSequencesPerFactor)//TODO: exchange to the vector of initial values
-:_masterModel(masterModel),
+:_masterModel(&masterModel),
  _directIndex(variableList),
  _pwForwardIndex(pwFactorList),
  _pwDirection(pwFactorList.size())
@@ -546,8 +569,8 @@ void SequenceStorage<GM>::_ConsistencyCheck()
 	 LabelType v[2];
 	 for (IndexType i=0;i<size()-1;++i)
 	 {
-	  exception_check(_masterModel[pwForwardFactor(i)].numberOfVariables()==2,"DynamicProgramming::_ConsistencyCheck():factor.numberOfVariables()!=2");
-	  _masterModel[pwForwardFactor(i)].variableIndices(&v[0]);
+	  exception_check((*_masterModel)[pwForwardFactor(i)].numberOfVariables()==2,"DynamicProgramming::_ConsistencyCheck():factor.numberOfVariables()!=2");
+	  (*_masterModel)[pwForwardFactor(i)].variableIndices(&v[0]);
 
 	  if (v[0]==varIndex(i))
 	  {
@@ -564,6 +587,13 @@ void SequenceStorage<GM>::_ConsistencyCheck()
 	 }
 }
 
+template<class GM>
+void SequenceStorage<GM>::rebind(const GM& masterModel,const IndexList& numOfSequencesPerFactor)
+{
+	_masterModel=&masterModel;
+	_Reset(numOfSequencesPerFactor);
+}
+
 template<class GM>
 void SequenceStorage<GM>::_Reset(const IndexList& numOfSequencesPerFactor)
 {
@@ -576,7 +606,7 @@ void SequenceStorage<GM>::_Reset(IndexType var,IndexType numOfSequences)
 {
 	assert(var<size());
 	UnaryFactor& uf=_unaryFactors[var];
-	_masterModel[_var2FactorMap(varIndex(var))].copyValues(uf.begin());
+	(*_masterModel)[_var2FactorMap(varIndex(var))].copyValues(uf.begin());
 	transform_inplace(uf.begin(),uf.end(),std::bind2nd(std::multiplies<ValueType>(),1.0/numOfSequences));
 
 };
@@ -586,7 +616,7 @@ void SequenceStorage<GM>::AllocateUnaryFactors(std::vector<UnaryFactor>* pfactor
 {
  pfactors->resize(size());
  for (size_t i=0;i<pfactors->size();++i)
-		 (*pfactors)[i].assign(_masterModel[_var2FactorMap(varIndex(i))].size(),0.0);
+		 (*pfactors)[i].assign((*_masterModel)[_var2FactorMap(varIndex(i))].size(),0.0);
 };
 
 template<class GM>
@@ -610,12 +640,12 @@ SequenceStorage<GM>::evaluate(ITERATOR labeling)
 		if (i<size()-1)
 		{
 		 if (pwDirection(i)==Direct)
-		  value+=_masterModel[_pwForwardIndex[i]](labeling);
+		  value+=(*_masterModel)[_pwForwardIndex[i]](labeling);
 		 else
 		 {
 		  std::valarray<LabelType> ind(2);
 		  ind[0]=*(labeling+1); ind[1]=*labeling;
-		  value+= _masterModel[_pwForwardIndex[i]](labeling);
+		  value+= (*_masterModel)[_pwForwardIndex[i]](labeling);
 		 }
 		}
 		++labeling;
@@ -144,6 +144,14 @@ public:
 	  {
 	  out = _solver.arg();
 	  return opengm::NORMAL;}
+  /// binds to a model of the same structure, the current dual variables are the starting point of the next infer()
+  InferenceTermination rebind(const GraphicalModelType& gm)
+  {
+	  this->checkRebind(_storage.masterModel(),gm);
+	  _storage.rebind(gm);
+	  _solver.rebind();
+	  return NORMAL;
+  }
   virtual ValueType bound() const{return _solver.bound();}
   virtual ValueType value() const{return _solver.value();}
   void getTreeAgreement(std::vector<bool>& out,std::vector<LabelType>* plabeling=0,std::vector<std::vector<LabelType> >* ptreeLabelings=0){_solver.getTreeAgreement(out,plabeling,ptreeLabelings);}
@@ -0,0 +1,293 @@
+#pragma once
+#ifndef OPENGM_LEARNING_GRADIENT_ACCUMULATOR_HXX
+#define OPENGM_LEARNING_GRADIENT_ACCUMULATOR_HXX
+
+#include <vector>
+#include <cstddef>
+
+#include "opengm/opengm.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+#include "opengm/graphicalmodel/parameters.hxx"
+#include "opengm/graphicalmodel/space/discretespace.hxx"
+#include "opengm/functions/view.hxx"
+#include "opengm/functions/explicit_function.hxx"
+#include "opengm/functions/function_properties_base.hxx"
+#include "opengm/operations/minimizer.hxx"
+#include "opengm/utilities/metaprogramming.hxx"
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace opengm {
+namespace learning {
+
+/// \brief accumulates the joint feature vector of a labeling
+///
+/// For each factor with a learnable function (see IsLearnableFunction) the
+/// derivatives of the function value w.r.t. its parameters, evaluated at the
+/// labeling, are multiplied by a scale and added to a gradient buffer.
+/// Factors with other function types are ignored.
+///
+/// Usage:
+/// \code
+/// GradientAccumulator<GM> acc(&gradient[0], labeling, 1.0);
+/// for(size_t f=0; f<gm.numberOfFactors(); ++f)
+///    gm[f].callViFunctor(acc);
+/// \endcode
+template<class GM>
+class GradientAccumulator {
+public:
+   typedef typename GM::ValueType ValueType;
+   typedef typename GM::IndexType IndexType;
+   typedef typename GM::LabelType LabelType;
+
+   GradientAccumulator(ValueType* gradient, const std::vector<LabelType>& labeling, const ValueType scale)
+   :  gradient_(gradient),
+      labeling_(labeling),
+      scale_(scale),
+      factorLabels_()
+   {}
+
+   template<class VI_ITERATOR, class FUNCTION>
+   void operator()(VI_ITERATOR viBegin, VI_ITERATOR viEnd, const FUNCTION& function) {
+      accumulate(viBegin, viEnd, function, meta::Bool<IsLearnableFunction<FUNCTION>::value>());
+   }
+
+   /// accumulate the features of all factors of a model
+   static void accumulate(const GM& gm, const std::vector<LabelType>& labeling, const ValueType scale, ValueType* gradient) {
+      GradientAccumulator<GM> acc(gradient, labeling, scale);
+      for(IndexType f = 0; f < gm.numberOfFactors(); ++f) {
+         gm[f].callViFunctor(acc);
+      }
+   }
+
+private:
+   template<class VI_ITERATOR, class FUNCTION>
+   void accumulate(VI_ITERATOR, VI_ITERATOR, const FUNCTION&, meta::FalseCase) {
+   }
+
+   template<class VI_ITERATOR, class FUNCTION>
+   void accumulate(VI_ITERATOR viBegin, VI_ITERATOR viEnd, const FUNCTION& function, meta::TrueCase) {
+      factorLabels_.resize(0);
+      for(; viBegin != viEnd; ++viBegin) {
+         factorLabels_.push_back(labeling_[*viBegin]);
+      }
+      for(size_t p = 0; p < function.numberOfParameters(); ++p) {
+         gradient_[function.parameterIndex(p)] += scale_ * function.parameterGradient(p, factorLabels_.begin());
+      }
+   }
+
+   ValueType* gradient_;
+   const std::vector<LabelType>& labeling_;
+   const ValueType scale_;
+   std::vector<LabelType> factorLabels_;
+};
+
+/// \brief helper to build the loss-augmented version of a model
+///
+/// The loss-augmented model views all factors of the original model and adds
+/// one unary factor per variable holding the (weighted) Hamming loss w.r.t. a
+/// ground truth labeling. The inference algorithm passed to
+/// LossAugmentedGradient has to be instantiated with LossAugmentedModel<GM>::GmType.
+template<class GM>
+class LossAugmentedModel {
+public:
+   typedef typename GM::ValueType ValueType;
+   typedef typename GM::IndexType IndexType;
+   typedef typename GM::LabelType LabelType;
+   typedef typename GM::OperatorType OperatorType;
+   typedef DiscreteSpace<IndexType, LabelType> SpaceType;
+   typedef typename meta::TypeListGenerator<
+      ViewFunction<GM>,
+      ExplicitFunction<ValueType, IndexType, LabelType>
+   >::type FunctionTypeList;
+   typedef GraphicalModel<ValueType, OperatorType, FunctionTypeList, SpaceType> GmType;
+
+   /// \param gm model (must use the Adder operation)
+   /// \param groundTruth ground truth labeling of the model
+   /// \param lossValue value added for each variable that is labeled differently from the ground truth
+   /// \param out loss-augmented model (views the factors of gm, which has to outlive it)
+   static void build(const GM& gm, const std::vector<LabelType>& groundTruth, const ValueType lossValue, GmType& out) {
+      OPENGM_ASSERT(groundTruth.size() == gm.numberOfVariables());
+      std::vector<LabelType> numbersOfLabels(gm.numberOfVariables());
+      for(IndexType v = 0; v < gm.numberOfVariables(); ++v) {
+         numbersOfLabels[v] = gm.numberOfLabels(v);
+      }
+      out = GmType(SpaceType(numbersOfLabels.begin(), numbersOfLabels.end()));
+      out.reserveFactors(gm.numberOfFactors() + (lossValue != 0 ? gm.numberOfVariables() : 0));
+      for(IndexType f = 0; f < gm.numberOfFactors(); ++f) {
+         out.addFactor(out.addFunction(ViewFunction<GM>(gm[f])), gm[f].variableIndicesBegin(), gm[f].variableIndicesEnd());
+      }
+      if(lossValue != 0) {
+         for(IndexType v = 0; v < gm.numberOfVariables(); ++v) {
+            ExplicitFunction<ValueType, IndexType, LabelType> loss(&numbersOfLabels[v], &numbersOfLabels[v] + 1, lossValue);
+            loss(groundTruth[v]) = 0;
+            out.addFactor(out.addFunction(loss), &v, &v + 1);
+         }
+      }
+   }
+};
+
+/// \brief dataset-level (sub)gradient of the structured hinge loss
+///
+/// For a dataset of models E(x;w) with ground truth labelings y_n the
+/// structured hinge loss
+/// \f[ \sum_n E(y_n;w) - \min_x ( E(x;w) - \lambda \Delta(x,y_n) ) \f]
+/// (for minimization, the signs flip for maximization) and its subgradient
+/// \f[ \sum_n \Phi(y_n) - \Phi(\hat{x}_n) \f] are computed, where \f$\hat{x}_n\f$
+/// is the loss-augmented MAP labeling and \f$\Phi\f$ the joint feature vector
+/// (derivatives of the learnable functions). With \f$\lambda=1\f$ this is the
+/// structured SVM subgradient, with \f$\lambda=0\f$ the structured perceptron update.
+///
+/// Loss-augmented inference runs concurrently for several models (OpenMP).
+/// Every thread accumulates into its own gradient buffer, the buffers are
+/// reduced in a fixed order at the end, so results do not depend on the
+/// thread schedule.
+///
+/// \tparam GM model type (Adder), its learnable functions refer to one opengm::Parameters object
+/// \tparam INF inference algorithm on LossAugmentedModel<GM>::GmType
+///
+/// \ingroup learning
+template<class GM, class INF>
+class LossAugmentedGradient {
+public:
+   typedef typename GM::ValueType ValueType;
+   typedef typename GM::IndexType IndexType;
+   typedef typename GM::LabelType LabelType;
+   typedef typename INF::AccumulationType AccumulationType;
+   typedef LossAugmentedModel<GM> LossAugmentedModelType;
+   typedef typename LossAugmentedModelType::GmType LossAugmentedGmType;
+
+   class Parameter {
+   public:
+      Parameter(
+         const typename INF::Parameter& infParameter = typename INF::Parameter(),
+         const ValueType lossWeight = 1,
+         const size_t numberOfThreads = 1
+      )
+      :  infParameter_(infParameter),
+         lossWeight_(lossWeight),
+         numberOfThreads_(numberOfThreads)
+      {}
+      /// parameter of the loss-augmented inference
+      typename INF::Parameter infParameter_;
+      /// weight of the Hamming loss (1 = structured SVM, 0 = perceptron)
+      ValueType lossWeight_;
+      /// number of threads (0 = OpenMP default)
+      size_t numberOfThreads_;
+   };
+
+   LossAugmentedGradient(const Parameters<ValueType, IndexType>&, const Parameter& = Parameter());
+
+   ValueType operator()(const std::vector<GM>&, const std::vector<std::vector<LabelType> >&, std::vector<ValueType>&) const;
+   ValueType operator()(const std::vector<GM>&, const std::vector<std::vector<LabelType> >&, std::vector<ValueType>&, std::vector<std::vector<LabelType> >&) const;
+
+private:
+   const Parameters<ValueType, IndexType>& parameters_;
+   Parameter parameter_;
+};
+
+template<class GM, class INF>
+inline
+LossAugmentedGradient<GM, INF>::LossAugmentedGradient
+(
+   const Parameters<ValueType, IndexType>& parameters,
+   const Parameter& parameter
+)
+:  parameters_(parameters),
+   parameter_(parameter)
+{}
+
+/// \brief compute the hinge loss and its subgradient over a dataset
+/// \param models models of the dataset
+/// \param groundTruth ground truth labeling for each model
+/// \param gradient subgradient (resized to the number of parameters)
+/// \return structured hinge loss summed over the dataset
+template<class GM, class INF>
+inline typename LossAugmentedGradient<GM, INF>::ValueType
+LossAugmentedGradient<GM, INF>::operator()
+(
+   const std::vector<GM>& models,
+   const std::vector<std::vector<LabelType> >& groundTruth,
+   std::vector<ValueType>& gradient
+) const {
+   std::vector<std::vector<LabelType> > labelings;
+   return (*this)(models, groundTruth, gradient, labelings);
+}
+
+/// \brief compute the hinge loss and its subgradient over a dataset
+/// \param models models of the dataset
+/// \param groundTruth ground truth labeling for each model
+/// \param gradient subgradient (resized to the number of parameters)
+/// \param labelings loss-augmented MAP labeling of each model
+/// \return structured hinge loss summed over the dataset
+template<class GM, class INF>
+typename LossAugmentedGradient<GM, INF>::ValueType
+LossAugmentedGradient<GM, INF>::operator()
+(
+   const std::vector<GM>& models,
+   const std::vector<std::vector<LabelType> >& groundTruth,
+   std::vector<ValueType>& gradient,
+   std::vector<std::vector<LabelType> >& labelings
+) const {
+   OPENGM_ASSERT(models.size() == groundTruth.size());
+   const size_t numberOfParameters = parameters_.numberOfParameters();
+   // energies are minimized: phi(y) - phi(x); scores are maximized: phi(x) - phi(y)
+   const ValueType sign = meta::Compare<AccumulationType, Minimizer>::value ? 1 : -1;
+   const ValueType lossValue = -sign * parameter_.lossWeight_;
+
+   size_t numberOfThreads = 1;
+#ifdef WITH_OPENMP
+   numberOfThreads = parameter_.numberOfThreads_ > 0 ? parameter_.numberOfThreads_ : static_cast<size_t>(omp_get_max_threads());
+#endif
+   std::vector<std::vector<ValueType> > threadGradients(numberOfThreads, std::vector<ValueType>(numberOfParameters, 0));
+   std::vector<ValueType> losses(models.size(), 0);
+   labelings.resize(models.size());
+
+   const std::ptrdiff_t numberOfModels = static_cast<std::ptrdiff_t>(models.size());
+#ifdef WITH_OPENMP
+#pragma omp parallel num_threads(static_cast<int>(numberOfThreads))
+#endif
+   {
+      size_t thread = 0;
+#ifdef WITH_OPENMP
+      thread = static_cast<size_t>(omp_get_thread_num());
+#endif
+      std::vector<ValueType>& threadGradient = threadGradients[thread];
+      LossAugmentedGmType lgm;
+#ifdef WITH_OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+      for(std::ptrdiff_t n = 0; n < numberOfModels; ++n) {
+         const GM& gm = models[n];
+         LossAugmentedModelType::build(gm, groundTruth[n], lossValue, lgm);
+         INF inf(lgm, parameter_.infParameter_);
+         inf.infer();
+         inf.arg(labelings[n]);
+         losses[n] = sign * (gm.evaluate(groundTruth[n].begin()) - lgm.evaluate(labelings[n].begin()));
+         if(numberOfParameters > 0) {
+            GradientAccumulator<GM>::accumulate(gm, groundTruth[n], sign, &threadGradient[0]);
+            GradientAccumulator<GM>::accumulate(gm, labelings[n], -sign, &threadGradient[0]);
+         }
+      }
+   }
+
+   // reduction in a fixed order
+   gradient.assign(numberOfParameters, 0);
+   for(size_t t = 0; t < numberOfThreads; ++t) {
+      for(size_t p = 0; p < numberOfParameters; ++p) {
+         gradient[p] += threadGradients[t][p];
+      }
+   }
+   ValueType loss = 0;
+   for(size_t n = 0; n < losses.size(); ++n) {
+      loss += losses[n];
+   }
+   return loss;
+}
+
+} // namespace learning
+} // namespace opengm
+
+#endif // #ifndef OPENGM_LEARNING_GRADIENT_ACCUMULATOR_HXX
@@ -0,0 +1,190 @@
+#pragma once
+#ifndef OPENGM_PYTHON_NUMPY_FUNCTION_HXX
+#define OPENGM_PYTHON_NUMPY_FUNCTION_HXX
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include <boost/python.hpp>
+
+#include "opengm/opengm.hxx"
+#include "opengm/functions/function_registration.hxx"
+#include "opengm/functions/function_properties_base.hxx"
+
+namespace opengm{
+namespace python{
+
+/// \cond HIDDEN_SYMBOLS
+namespace detail_numpyfunction{
+   // releases the reference to the python object with the GIL held,
+   // such that copies of the functions can be destroyed by threads which do not hold the GIL
+   struct GilDecref{
+      void operator()(PyObject * obj)const{
+         PyGILState_STATE gstate = PyGILState_Ensure();
+         Py_XDECREF(obj);
+         PyGILState_Release(gstate);
+      }
+   };
+}
+/// \endcond
+
+/// \brief Function which views the values of a (numpy) buffer without copying them
+///
+/// The function keeps a reference to the python object owning the buffer, the
+/// buffer must not be resized while the function is alive. Copies of the function
+/// share the buffer. The value of a labeling (l_0,...,l_{n-1}) is
+/// data[sum_d l_d * strides[d]] with strides in elements, i.e. numpy arrays of any
+/// memory layout and sub-arrays (e.g. single rows of a unary table) can be viewed.
+/// Deserialized functions own their values.
+///
+/// \ingroup functions
+template<class T, class I , class L>
+class NumpyViewFunction
+: public opengm::FunctionBase<NumpyViewFunction<T, I, L>, T, I, L>
+{
+public:
+   typedef T ValueType;
+   typedef L LabelType;
+   typedef I IndexType;
+
+   NumpyViewFunction()
+   :  owner_(), values_(), data_(NULL), shape_(), strides_(), size_(1){
+   }
+
+   /// \param owner python object owning the buffer, a reference is kept (the GIL must be held)
+   /// \param data pointer to the value of the labeling (0,...,0)
+   /// \param shapeBegin begin of the shape sequence
+   /// \param shapeEnd end of the shape sequence
+   /// \param stridesBegin begin of the strides sequence (in elements, not in bytes)
+   template<class SHAPE_ITERATOR, class STRIDES_ITERATOR>
+   NumpyViewFunction(boost::python::object owner, const ValueType * data, SHAPE_ITERATOR shapeBegin, SHAPE_ITERATOR shapeEnd, STRIDES_ITERATOR stridesBegin)
+   :  owner_(),
+      values_(),
+      data_(data),
+      shape_(shapeBegin, shapeEnd),
+      strides_(shape_.size()),
+      size_(1){
+      Py_XINCREF(owner.ptr());
+      owner_ = std::shared_ptr<PyObject>(owner.ptr(), detail_numpyfunction::GilDecref());
+      for(size_t d=0; d<shape_.size(); ++d, ++stridesBegin){
+         strides_[d] = static_cast<std::ptrdiff_t>(*stridesBegin);
+         size_ *= shape_[d];
+      }
+   }
+
+   /// \brief view a sub-array of the buffer viewed by another function
+   template<class SHAPE_ITERATOR, class STRIDES_ITERATOR>
+   NumpyViewFunction(const NumpyViewFunction & other, const ValueType * data, SHAPE_ITERATOR shapeBegin, SHAPE_ITERATOR shapeEnd, STRIDES_ITERATOR stridesBegin)
+   :  owner_(other.owner_),
+      values_(other.values_),
+      data_(data),
+      shape_(shapeBegin, shapeEnd),
+      strides_(shape_.size()),
+      size_(1){
+      for(size_t d=0; d<shape_.size(); ++d, ++stridesBegin){
+         strides_[d] = static_cast<std::ptrdiff_t>(*stridesBegin);
+         size_ *= shape_[d];
+      }
+   }
+
+   LabelType shape(const size_t i) const{
+      OPENGM_ASSERT(i < shape_.size());
+      return shape_[i];
+   }
+   size_t size() const{
+      return size_;
+   }
+   size_t dimension() const{
+      return shape_.size();
+   }
+
+   template<class ITERATOR>
+   ValueType operator()(ITERATOR labeling) const{
+      std::ptrdiff_t offset = 0;
+      for(size_t d=0; d<shape_.size(); ++d, ++labeling){
+         OPENGM_ASSERT(static_cast<size_t>(*labeling) < static_cast<size_t>(shape_[d]));
+         offset += static_cast<std::ptrdiff_t>(*labeling) * strides_[d];
+      }
+      return data_[offset];
+   }
+
+private:
+   std::shared_ptr<PyObject> owner_;
+   std::shared_ptr<const std::vector<ValueType> > values_;
+   const ValueType * data_;
+   std::vector<LabelType> shape_;
+   std::vector<std::ptrdiff_t> strides_;
+   size_t size_;
+
+template<class > friend class opengm::FunctionSerialization;
+};
+
+}
+}
+
+namespace opengm{
+   /// \cond HIDDEN_SYMBOLS
+   /// FunctionRegistration
+   template<class T, class I, class L>
+   struct FunctionRegistration<python::NumpyViewFunction<T, I, L> > {
+      enum ID {
+         Id = opengm::FUNCTION_TYPE_ID_OFFSET + 101
+      };
+   };
+
+   /// FunctionSerialization, the values are stored like the values of an explicit function
+   template<class T, class I, class L>
+   class FunctionSerialization<python::NumpyViewFunction<T, I, L> >{
+   public:
+      typedef typename python::NumpyViewFunction<T, I, L>::ValueType ValueType;
+
+      static size_t indexSequenceSize(const python::NumpyViewFunction<T, I, L> & src){
+         return src.dimension()+1;
+      }
+      static size_t valueSequenceSize(const python::NumpyViewFunction<T, I, L> & src){
+         return src.size();
+      }
+      template<class INDEX_OUTPUT_ITERATOR, class VALUE_OUTPUT_ITERATOR>
+      static void serialize(const python::NumpyViewFunction<T, I, L> & src, INDEX_OUTPUT_ITERATOR indexOutIterator, VALUE_OUTPUT_ITERATOR valueOutIterator){
+         *indexOutIterator = src.dimension();
+         ++indexOutIterator;
+         for(size_t d=0; d<src.dimension(); ++d, ++indexOutIterator){
+            *indexOutIterator = src.shape(d);
+         }
+         // first coordinate varies fastest
+         std::vector<L> labeling(src.dimension(), 0);
+         for(size_t i=0; i<src.size(); ++i, ++valueOutIterator){
+            *valueOutIterator = src(labeling.begin());
+            for(size_t d=0; d<src.dimension(); ++d){
+               if(++labeling[d] < src.shape(d)) break;
+               labeling[d] = 0;
+            }
+         }
+      }
+      template<class INDEX_INPUT_ITERATOR, class VALUE_INPUT_ITERATOR>
+      static void deserialize(INDEX_INPUT_ITERATOR indexInIterator, VALUE_INPUT_ITERATOR valueInIterator, python::NumpyViewFunction<T, I, L> & dst){
+         const size_t dim = *indexInIterator;
+         ++indexInIterator;
+         dst.owner_.reset();
+         dst.shape_.resize(dim);
+         dst.strides_.resize(dim);
+         dst.size_ = 1;
+         for(size_t d=0; d<dim; ++d, ++indexInIterator){
+            dst.shape_[d] = *indexInIterator;
+            dst.strides_[d] = static_cast<std::ptrdiff_t>(dst.size_);
+            dst.size_ *= dst.shape_[d];
+         }
+         std::shared_ptr<std::vector<ValueType> > values(new std::vector<ValueType>(dst.size_));
+         for(size_t i=0; i<dst.size_; ++i, ++valueInIterator){
+            (*values)[i] = *valueInIterator;
+         }
+         dst.data_ = values->empty() ? NULL : &(*values)[0];
+         dst.values_ = values;
+      }
+   };
+   /// \endcond
+}
+
+#endif
@@ -22,6 +22,7 @@
 #include <opengm/python/converter.hxx>
 #include <opengm/python/numpyview.hxx>
 #include <opengm/python/pythonfunction.hxx>
+#include <opengm/python/numpyfunction.hxx>
 
 
 #include <algorithm>
@@ -59,6 +60,7 @@ namespace python{
       typedef opengm::TruncatedSquaredDifferenceFunction    <ValueType,IndexType,LabelType> PyTruncatedSquaredDifferenceFunction;
       typedef opengm::SparseFunction                        <ValueType,IndexType,LabelType> PySparseFunction; 
       typedef PythonFunction                                <ValueType,IndexType,LabelType> PyPythonFunction; 
+      typedef NumpyViewFunction                             <ValueType,IndexType,LabelType> PyNumpyViewFunction; 
 
       typedef typename opengm::meta::TypeListGenerator<
          PyExplicitFunction,
@@ -68,7 +70,8 @@ namespace python{
          PyTruncatedAbsoluteDifferenceFunction,
          PyTruncatedSquaredDifferenceFunction,
          PySparseFunction,
-         PyPythonFunction
+         PyPythonFunction,
+         PyNumpyViewFunction
       >::type type;
    };
 
@@ -91,6 +94,7 @@ namespace python{
    typedef opengm::TruncatedSquaredDifferenceFunction    <GmValueType,GmIndexType,GmLabelType> GmTruncatedSquaredDifferenceFunction;
    typedef opengm::SparseFunction                        <GmValueType,GmIndexType,GmLabelType> GmSparseFunction; 
    typedef opengm::python::PythonFunction                <GmValueType,GmIndexType,GmLabelType> GmPythonFunction; 
+   typedef opengm::python::NumpyViewFunction             <GmValueType,GmIndexType,GmLabelType> GmNumpyViewFunction; 
 
    typedef std::vector<GmIndexType> IndexVectorType;
    typedef std::vector<IndexVectorType> IndexVectorVectorType;
@@ -5,6 +5,11 @@
 #include <algorithm>
 #include <vector>
 #include <cmath>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
 
 #include "opengm/opengm.hxx"
 #include "opengm/functions/function_registration.hxx"
@@ -21,6 +26,52 @@ namespace python{
 
 using namespace boost::python;
 
+/// \cond HIDDEN_SYMBOLS
+namespace detail_pythonfunction{
+   // numpy dtype string of a c++ type, e.g. "f8" for double
+   template<class T>
+   inline std::string dtypeString(){
+      std::stringstream ss;
+      ss << (std::numeric_limits<T>::is_integer ? (std::numeric_limits<T>::is_signed ? "i" : "u") : "f") << sizeof(T);
+      return ss.str();
+   }
+
+   // 1d numpy array viewing a c++ buffer (no copy)
+   template<class T>
+   inline boost::python::object bufferArray(T * data, const size_t size, const bool writable){
+      const Py_ssize_t bytes = static_cast<Py_ssize_t>(size*sizeof(T));
+      #if PY_MAJOR_VERSION >= 3
+      PyObject * buffer = PyMemoryView_FromMemory(reinterpret_cast<char *>(data), bytes, writable ? PyBUF_WRITE : PyBUF_READ);
+      #else
+      PyObject * buffer = writable ? PyBuffer_FromReadWriteMemory(data, bytes) : PyBuffer_FromMemory(data, bytes);
+      #endif
+      boost::python::object bufferObj((boost::python::handle<>(buffer)));
+      return boost::python::import("numpy").attr("frombuffer")(bufferObj, dtypeString<T>());
+   }
+
+   // values of a tabulated function, shared by all copies of a function.
+   // values are written once (with the GIL held) before tabulated is set
+   template<class T>
+   struct Table{
+      Table() : tabulated(false), values(){}
+      std::atomic<bool> tabulated;
+      std::vector<T> values;
+   };
+}
+/// \endcond
+
+/// \brief Function which calls a python callable to compute its values
+///
+/// The callable is called either with a single labeling (a list of labels) or,
+/// if the function is vectorized, with a batch of labelings given as a numpy
+/// array of shape (numberOfLabelings, dimension) and must then return the
+/// numberOfLabelings values as a sequence / numpy array.
+///
+/// A function with \p tabulate set evaluates all its values at once (a single
+/// call for vectorized functions) the first time it is evaluated or when
+/// tabulate() is called, e.g. by GraphicalModel.finalize() of the python
+/// bindings. All further evaluations are table look ups which neither call back
+/// into python nor acquire the GIL. The table is shared by all copies of the function.
 template<class T, class I , class L>
 class PythonFunction
 : public opengm::FunctionBase<PythonFunction<T, I, L>, T, I, L>
@@ -31,7 +82,15 @@ public:
    typedef I IndexType;
 
    //empty
-   PythonFunction(){
+   PythonFunction()
+   :gilEnsure_(true),
+   vectorized_(false),
+   tabulate_(false),
+   table_(new detail_pythonfunction::Table<ValueType>()),
+   functionObj_(),
+   labelVector_(),
+   shape_(),
+   size_(0){
 
    }
 
@@ -39,20 +98,24 @@ public:
    PythonFunction(const PythonFunction & other)
    :
    gilEnsure_(other.gilEnsure_),
+   vectorized_(other.vectorized_),
+   tabulate_(other.tabulate_),
+   table_(other.table_),
    functionObj_(other.functionObj_),
    labelVector_(other.labelVector_),
-   coordinateBuffer_(other.coordinateBuffer_),
    shape_(other.shape_),
    size_(other.size_){
 
    }
 
    // regular constructor
-   PythonFunction(boost::python::object functionObj,boost::python::object shapeObj,const bool gilEnsure=true)
+   PythonFunction(boost::python::object functionObj,boost::python::object shapeObj,const bool gilEnsure=true,const bool vectorized=false,const bool tabulate=false)
    :gilEnsure_(gilEnsure),
+   vectorized_(vectorized),
+   tabulate_(tabulate),
+   table_(new detail_pythonfunction::Table<ValueType>()),
    functionObj_(functionObj),
    labelVector_(),
-   coordinateBuffer_(),
    shape_(),
    size_(){
       stl_input_iterator<int> shapeBegin(shapeObj), shapeEnd;
@@ -62,14 +125,15 @@ public:
       for(size_t d=0;d<shape_.size();++d){
          size_*=shape_[d];
       }
-      //std::cout<<"construct donen\n";
    }
 
    // assigment operator
    PythonFunction & operator=(const PythonFunction & other){
       if(&other!=this){
          gilEnsure_=other.gilEnsure_;
-         coordinateBuffer_=other.coordinateBuffer_;
+         vectorized_=other.vectorized_;
+         tabulate_=other.tabulate_;
+         table_=other.table_;
          shape_=other.shape_;
          functionObj_=other.functionObj_;
          size_=other.size_;
@@ -78,14 +142,6 @@ public:
       return *this;
    }
 
-   // destructor
-   ~PythonFunction(){
-      if(shape_.size()!=0){
-         //delete numpyCoordinates_;
-        // delete[] coordinateBuffer_;
-      }
-   }
-
    LabelType shape(const size_t i) const{
       return shape_[i];
    }
@@ -95,29 +151,143 @@ public:
    size_t dimension() const{
       return shape_.size();
    }
+   bool vectorized() const{
+      return vectorized_;
+   }
+   bool tabulateEnabled() const{
+      return tabulate_;
+   }
+   bool isTabulated() const{
+      return table_->tabulated.load(std::memory_order_acquire);
+   }
+
+   /// \brief evaluate all values of the function and store them in a table
+   ///
+   /// the GIL must be held if the function was constructed with gilEnsure=false
+   void tabulate() const{
+      if(table_->tabulated.load(std::memory_order_acquire)){
+         return;
+      }
+      if(gilEnsure_){
+         PyGILState_STATE gstate;
+         gstate = PyGILState_Ensure ();
+         try{
+            tabulateImpl();
+         }
+         catch(...){
+            PyGILState_Release (gstate);
+            throw;
+         }
+         PyGILState_Release (gstate);
+      }
+      else{
+         tabulateImpl();
+      }
+   }
 
    template<class ITERATOR> 
    ValueType operator()(ITERATOR labeling) const{
+      if(tabulate_){
+         tabulate();
+         return table_->values[tableIndex(labeling)];
+      }
       std::copy(labeling,labeling+shape_.size(),labelVector_.begin());
       ValueType returnValue;
       if(gilEnsure_){
          PyGILState_STATE gstate;
          gstate = PyGILState_Ensure ();
-         returnValue = boost::python::extract<ValueType> ( functionObj_( labelVector_) );
+         try{
+            returnValue = callFunction();
+         }
+         catch(...){
+            PyGILState_Release (gstate);
+            throw;
+         }
          PyGILState_Release (gstate);
       }
       else{
-         returnValue = boost::python::extract<ValueType> ( functionObj_( labelVector_) );
+         returnValue = callFunction();
       }
       return returnValue;
    }
 
 private:
+   // index of a labeling in the table, first coordinate varies fastest
+   template<class ITERATOR>
+   size_t tableIndex(ITERATOR labeling) const{
+      size_t index=0;
+      size_t stride=1;
+      for(size_t d=0;d<shape_.size();++d,++labeling){
+         OPENGM_ASSERT(static_cast<size_t>(*labeling) < static_cast<size_t>(shape_[d]));
+         index+=static_cast<size_t>(*labeling)*stride;
+         stride*=shape_[d];
+      }
+      return index;
+   }
+
+   // call the function for labelVector_ (GIL must be held)
+   ValueType callFunction() const{
+      if(vectorized_){
+         ValueType value;
+         callVectorized(&labelVector_[0],1,&value);
+         return value;
+      }
+      return boost::python::extract<ValueType> ( functionObj_( labelVector_) );
+   }
+
+   // call the vectorized function for a batch of labelings (GIL must be held)
+   void callVectorized(const LabelType * labelings,const size_t numberOfLabelings,ValueType * values) const{
+      const size_t dim=shape_.size();
+      boost::python::object labelArray = detail_pythonfunction::bufferArray(const_cast<LabelType *>(labelings),numberOfLabelings*dim,false)
+         .attr("reshape")(boost::python::make_tuple(numberOfLabelings,dim));
+      boost::python::object result = functionObj_(labelArray);
+      if(boost::python::len(result)!=static_cast<boost::python::ssize_t>(numberOfLabelings)){
+         throw RuntimeError("a vectorized python function must return one value per labeling");
+      }
+      boost::python::object valueArray = detail_pythonfunction::bufferArray(values,numberOfLabelings,true);
+      valueArray[boost::python::slice()] = result;
+   }
+
+   // evaluate all labelings (GIL must be held)
+   void tabulateImpl() const{
+      if(table_->tabulated.load(std::memory_order_relaxed)){
+         return;
+      }
+      const size_t dim=shape_.size();
+      std::vector<ValueType> values(size_);
+      // labelings are processed in batches to bound the memory of the coordinates
+      const size_t batchSize=std::min<size_t>(size_,vectorized_ ? 65536 : 1);
+      std::vector<LabelType> labelings(batchSize*dim);
+      std::vector<LabelType> labeling(dim,0);
+      size_t index=0;
+      while(index<size_){
+         const size_t n=std::min(batchSize,size_-index);
+         for(size_t i=0;i<n;++i){
+            std::copy(labeling.begin(),labeling.end(),labelings.begin()+i*dim);
+            for(size_t d=0;d<dim;++d){
+               if(++labeling[d]<shape_[d]) break;
+               labeling[d]=0;
+            }
+         }
+         if(vectorized_){
+            callVectorized(&labelings[0],n,&values[index]);
+         }
+         else{
+            std::copy(labelings.begin(),labelings.begin()+dim,labelVector_.begin());
+            values[index]=boost::python::extract<ValueType> ( functionObj_( labelVector_) );
+         }
+         index+=n;
+      }
+      table_->values.swap(values);
+      table_->tabulated.store(true,std::memory_order_release);
+   }
+
    bool gilEnsure_;
+   bool vectorized_;
+   bool tabulate_;
+   std::shared_ptr<detail_pythonfunction::Table<ValueType> > table_;
    boost::python::object functionObj_;
    mutable std::vector<LabelType> labelVector_;
-   //mutable boost::python::numeric::array  numpyCoordinates_;
-   mutable  LabelType * coordinateBuffer_;
    std::vector<LabelType> shape_;
    size_t size_;
    
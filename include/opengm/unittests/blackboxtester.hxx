@@ -9,36 +9,112 @@
 #endif
 
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
 #include <typeinfo>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 #include <opengm/opengm.hxx>
 #include <opengm/unittests/test.hxx>
 #include <opengm/inference/bruteforce.hxx>
+#include <opengm/inference/visitors/visitors.hxx>
 #include <opengm/unittests/blackboxtests/blackboxtestbase.hxx>
 #include <opengm/operations/minimizer.hxx>
 #include <opengm/operations/maximizer.hxx>
 #include <opengm/operations/integrator.hxx>
+#include <opengm/utilities/timer.hxx>
+#include <opengm/utilities/meminfo.hxx>
 
 /// \cond HIDDEN_SYMBOLS
 
 namespace opengm {
+
+   /// run time, iterations and memory of one test instance
+   struct BlackBoxReport
+   {
+      BlackBoxReport()
+         : testId(0), instance(0), seconds(0), iterations(0), peakMemory(0), exception(false)
+         {}
+      size_t testId;
+      size_t instance;
+      /// wall time of the construction of the solver and of infer()
+      double seconds;
+      /// number of visitor calls during infer(), counted only if requested by setCountIterations()
+      size_t iterations;
+      /// peak resident memory of the process in MB when the instance was done
+      /// (with several threads shared by all instances run at the same time)
+      double peakMemory;
+      bool exception;
+   };
+
+   namespace detail_blackboxtester {
+      // counts the visitor calls, accepts the visitor protocols of all solvers
+      class IterationCountingVisitor
+      {
+      public:
+         IterationCountingVisitor()
+            : iterations_(0)
+            {}
+         template<class INF, class... ARGS>
+            void begin(INF&, ARGS...) {}
+         template<class INF, class... ARGS>
+            size_t operator()(INF&, ARGS...) { ++iterations_; return visitors::VisitorReturnFlag::ContinueInf; }
+         template<class INF, class... ARGS>
+            void end(INF&, ARGS...) {}
+         void addLog(const std::string&) {}
+         void log(const std::string&, const double) {}
+         size_t iterations() const { return iterations_; }
+      private:
+         size_t iterations_;
+      };
+   }
+
    template<class GM>
    class InferenceBlackBoxTester
    {
    public:
       typedef GM GraphicalModelType;
+      InferenceBlackBoxTester();
       template<class INF> void test(const typename INF::Parameter&, bool tValue=true, bool tArg=false, bool tMarg=false, bool tFacMarg=false);
       void addTest(BlackBoxTestBase<GraphicalModelType>*);
+      /// number of test instances run concurrently (0 = one per core), used only WITH_OPENMP
+      void setNumberOfThreads(const size_t numberOfThreads) { numberOfThreads_ = numberOfThreads; }
+      /// fail if an instance takes longer (in seconds, 0 = no budget)
+      void setTimeBudget(const double seconds) { timeBudget_ = seconds; }
+      /// fail if the peak resident memory of the process exceeds the budget (in MB, 0 = no budget)
+      void setMemoryBudget(const double megabytes) { memoryBudget_ = megabytes; }
+      /// run infer(visitor) with a counting visitor instead of infer() (default: false)
+      void setCountIterations(const bool count) { countIterations_ = count; }
+      /// reports of all instances of the last call of test()
+      const std::vector<BlackBoxReport>& reports() const { return reports_; }
       ~InferenceBlackBoxTester();
 
    private:
+      template<class INF>
+         void testInstance(const GraphicalModelType&, const BlackBoxBehaviour, const typename INF::Parameter&, BlackBoxReport&, std::ostream&) const;
+
       std::vector<BlackBoxTestBase<GraphicalModelType>*> testList;
+      size_t numberOfThreads_;
+      double timeBudget_;
+      double memoryBudget_;
+      bool countIterations_;
+      std::vector<BlackBoxReport> reports_;
    };
 
    //***************
    //IMPLEMENTATION
    //***************
 
+   template<class GM>
+   InferenceBlackBoxTester<GM>::InferenceBlackBoxTester()
+      : testList(), numberOfThreads_(1), timeBudget_(0), memoryBudget_(0), countIterations_(false), reports_()
+   {}
+
    template<class GM>
    InferenceBlackBoxTester<GM>::~InferenceBlackBoxTester()
    {
@@ -51,85 +127,179 @@ namespace opengm {
    template<class INF>
    void InferenceBlackBoxTester<GM>::test(const typename INF::Parameter& infPara, bool tValue, bool tArg, bool tMarg, bool tFacMarg)
    {
-      typedef typename GraphicalModelType::ValueType ValueType;
-      typedef typename GraphicalModelType::OperatorType OperatorType;
-      typedef typename INF::AccumulationType AccType;
-
+      // the models are generated sequentially, the instances are run concurrently
+      std::vector<GraphicalModelType> models;
+      std::vector<BlackBoxBehaviour> behaviours;
+      std::vector<size_t> firstInstance(testList.size() + 1, 0);
+      reports_.clear();
       for(size_t testId = 0; testId < testList.size(); ++testId) {
-         size_t numTests = testList[testId]->numberOfTests();
-         BlackBoxBehaviour behaviour = testList[testId]->behaviour();
-         std::cout << testList[testId]->infoText();
-         std::cout << " " << std::flush;
+         const size_t numTests = testList[testId]->numberOfTests();
+         firstInstance[testId + 1] = firstInstance[testId] + numTests;
          for(size_t n = 0; n < numTests; ++n) {
-            std::cout << "*" << std::flush;
-            GraphicalModelType gm = testList[testId]->getModel(n);
+            models.push_back(testList[testId]->getModel(n));
 #ifdef OPENGM_TESTFILE
             std::cout<< "save test-file" << std::endl; 
-            opengm::hdf5::save(gm,OPENGM_TESTFILE_FILENAME,"gm");
+            opengm::hdf5::save(models.back(),OPENGM_TESTFILE_FILENAME,"gm");
 #endif
-            //Run Algorithm
-            bool exceptionFlag = false;
-            std::vector<typename GM::LabelType> state;
-            try{      
-               INF inf(gm, infPara);
-               InferenceTermination returnValue=inf.infer();
-               OPENGM_TEST((returnValue==opengm::NORMAL) || (returnValue==opengm::CONVERGENCE)); 
-               if(typeid(AccType) == typeid(opengm::Minimizer) || typeid(AccType) == typeid(opengm::Maximizer)) {
-                  OPENGM_TEST(inf.arg(state)==opengm::NORMAL);
-                  OPENGM_TEST(state.size()==gm.numberOfVariables());
-                  for(size_t varId = 0; varId < gm.numberOfVariables(); ++varId) {
-                     OPENGM_TEST(state[varId]<gm.numberOfLabels(varId));
-                  }
-                  { 
-                     ValueType bound = inf.bound();
-                     ValueType value = inf.value();
-                     ValueType value2 = 0;
-                     if(typeid(AccType) == typeid(opengm::Minimizer))
-                        value2 = value + std::min<ValueType>(1e20,std::max<ValueType>(1e-4,fabs(value)))*1e-6;
-                     if(typeid(AccType) == typeid(opengm::Maximizer))
-                        value2 = value - std::min<ValueType>(1e20,std::max<ValueType>(1e-4,fabs(value)))*1e-6;
-                   
-                     std::cout << "value = " << value << "  ,  bound = " << bound << std::endl;
-                     OPENGM_TEST(AccType::bop(bound,value2)|| bound==value2);
-                  }
-                  if(behaviour == opengm::OPTIMAL) {
-                     std::vector<typename GM::LabelType> optimalState;
-                     opengm::Bruteforce<GraphicalModelType, AccType> bf(gm);
-                     OPENGM_TEST(bf.infer()==opengm::NORMAL);
-                     OPENGM_TEST(bf.arg(optimalState)==opengm::NORMAL);
-                     OPENGM_TEST(optimalState.size()==gm.numberOfVariables());
-                     for(size_t i = 0; i < gm.numberOfVariables(); ++i) {
-                        OPENGM_TEST(optimalState[i]<gm.numberOfLabels(i));
-                     }
-                     OPENGM_TEST_EQUAL_TOLERANCE(gm.evaluate(state), gm.evaluate(optimalState), 0.00001); 
-                     //testEqualSequence(states1.begin(), states1.end(), states2.begin());
-                  }
-               }
-               //if(typeid(AccType) == typeid(opengm::Integrator)) {
-                  //for(size_t varId = 0; varId < gm.numberOfVariables(); ++varId) {
-                  //   OPENGM_TEST(inf.marginal(varId)==opengm::NORMAL);
-                  //}
-                  //for(size_t factorId = 0; factorId < gm.numberOfFactors(); ++factorId) {
-                  //   OPENGM_TEST(inf.factorMarginal(factorId)==opengm::NORMAL);
-                  //}
-               //}
-               } catch(std::exception& e) {
-                 exceptionFlag = true;
-                 std::cout << e.what() <<std::endl;
-               }
-            if(behaviour == opengm::FAIL) {
-               OPENGM_TEST(exceptionFlag);
-            }else{
-               OPENGM_TEST(!exceptionFlag);
+            behaviours.push_back(testList[testId]->behaviour());
+            BlackBoxReport report;
+            report.testId = testId;
+            report.instance = n;
+            reports_.push_back(report);
+         }
+      }
+
+      const std::ptrdiff_t numInstances = static_cast<std::ptrdiff_t>(models.size());
+      std::vector<std::string> output(models.size());
+      std::vector<std::string> failure(models.size());
+      #ifdef WITH_OPENMP
+      const int nThreads = numberOfThreads_ > 0 ? static_cast<int>(numberOfThreads_) : omp_get_max_threads();
+      #pragma omp parallel for schedule(dynamic,1) num_threads(nThreads)
+      #endif
+      for(std::ptrdiff_t i = 0; i < numInstances; ++i) {
+         std::stringstream out;
+         try {
+            testInstance<INF>(models[i], behaviours[i], infPara, reports_[i], out);
+         }
+         catch(std::exception& e) {
+            failure[i] = e.what();
+         }
+         output[i] = out.str();
+      }
+
+      for(size_t testId = 0; testId < testList.size(); ++testId) {
+         BlackBoxBehaviour behaviour = testList[testId]->behaviour();
+         std::cout << testList[testId]->infoText();
+         std::cout << " " << std::flush;
+         double maxSeconds = 0;
+         size_t maxIterations = 0;
+         for(size_t i = firstInstance[testId]; i < firstInstance[testId + 1]; ++i) {
+            std::cout << "*" << output[i] << std::flush;
+            if(!failure[i].empty()) {
+               throw std::logic_error(failure[i]);
+            }
+            const BlackBoxReport& report = reports_[i];
+            maxSeconds = std::max(maxSeconds, report.seconds);
+            maxIterations = std::max(maxIterations, report.iterations);
+            if(timeBudget_ > 0 && report.seconds > timeBudget_) {
+               std::stringstream s;
+               s << "OpenGM black box test: instance " << report.instance << " took " << report.seconds
+                 << " s, the time budget is " << timeBudget_ << " s";
+               throw std::logic_error(s.str());
+            }
+            if(memoryBudget_ > 0 && report.peakMemory > memoryBudget_) {
+               std::stringstream s;
+               s << "OpenGM black box test: peak memory " << report.peakMemory
+                 << " MB after instance " << report.instance << ", the memory budget is " << memoryBudget_ << " MB";
+               throw std::logic_error(s.str());
             }
          }
          if(behaviour == opengm::OPTIMAL) {
-            std::cout << " OPTIMAL!" << std::endl;
+            std::cout << " OPTIMAL!";
          }else if(behaviour == opengm::PASS) {
-            std::cout << " PASS!" << std::endl;
+            std::cout << " PASS!";
          }else{
-            std::cout << " OK!" << std::endl;
+            std::cout << " OK!";
          }
+         std::cout << " (max. " << maxSeconds << " s";
+         if(countIterations_) {
+            std::cout << ", " << maxIterations << " iterations";
+         }
+         std::cout << ")" << std::endl;
+      }
+   }
+
+   template<class GM>
+   template<class INF>
+   void InferenceBlackBoxTester<GM>::testInstance
+   (
+      const GraphicalModelType& gm,
+      const BlackBoxBehaviour behaviour,
+      const typename INF::Parameter& infPara,
+      BlackBoxReport& report,
+      std::ostream& out
+   ) const
+   {
+      typedef typename GraphicalModelType::ValueType ValueType;
+      typedef typename INF::AccumulationType AccType;
+
+      //Run Algorithm
+      bool exceptionFlag = false;
+      std::vector<typename GM::LabelType> state;
+      try{      
+         #ifdef WITH_OPENMP
+         const double start = omp_get_wtime();
+         #else
+         Timer timer;
+         timer.tic();
+         #endif
+         INF inf(gm, infPara);
+         InferenceTermination returnValue;
+         // infer() stays the tested entry point unless iterations are requested
+         if(countIterations_) {
+            detail_blackboxtester::IterationCountingVisitor visitor;
+            returnValue=inf.infer(visitor);
+            report.iterations = visitor.iterations();
+         }
+         else {
+            returnValue=inf.infer();
+         }
+         #ifdef WITH_OPENMP
+         report.seconds = omp_get_wtime() - start;
+         #else
+         timer.toc();
+         report.seconds = timer.elapsedTime();
+         #endif
+         OPENGM_TEST((returnValue==opengm::NORMAL) || (returnValue==opengm::CONVERGENCE)); 
+         if(typeid(AccType) == typeid(opengm::Minimizer) || typeid(AccType) == typeid(opengm::Maximizer)) {
+            OPENGM_TEST(inf.arg(state)==opengm::NORMAL);
+            OPENGM_TEST(state.size()==gm.numberOfVariables());
+            for(size_t varId = 0; varId < gm.numberOfVariables(); ++varId) {
+               OPENGM_TEST(state[varId]<gm.numberOfLabels(varId));
+            }
+            { 
+               ValueType bound = inf.bound();
+               ValueType value = inf.value();
+               ValueType value2 = 0;
+               if(typeid(AccType) == typeid(opengm::Minimizer))
+                  value2 = value + std::min<ValueType>(1e20,std::max<ValueType>(1e-4,fabs(value)))*1e-6;
+               if(typeid(AccType) == typeid(opengm::Maximizer))
+                  value2 = value - std::min<ValueType>(1e20,std::max<ValueType>(1e-4,fabs(value)))*1e-6;
+             
+               out << "value = " << value << "  ,  bound = " << bound << std::endl;
+               OPENGM_TEST(AccType::bop(bound,value2)|| bound==value2);
+            }
+            if(behaviour == opengm::OPTIMAL) {
+               std::vector<typename GM::LabelType> optimalState;
+               opengm::Bruteforce<GraphicalModelType, AccType> bf(gm);
+               OPENGM_TEST(bf.infer()==opengm::NORMAL);
+               OPENGM_TEST(bf.arg(optimalState)==opengm::NORMAL);
+               OPENGM_TEST(optimalState.size()==gm.numberOfVariables());
+               for(size_t i = 0; i < gm.numberOfVariables(); ++i) {
+                  OPENGM_TEST(optimalState[i]<gm.numberOfLabels(i));
+               }
+               OPENGM_TEST_EQUAL_TOLERANCE(gm.evaluate(state), gm.evaluate(optimalState), 0.00001); 
+               //testEqualSequence(states1.begin(), states1.end(), states2.begin());
+            }
+         }
+         //if(typeid(AccType) == typeid(opengm::Integrator)) {
+            //for(size_t varId = 0; varId < gm.numberOfVariables(); ++varId) {
+            //   OPENGM_TEST(inf.marginal(varId)==opengm::NORMAL);
+            //}
+            //for(size_t factorId = 0; factorId < gm.numberOfFactors(); ++factorId) {
+            //   OPENGM_TEST(inf.factorMarginal(factorId)==opengm::NORMAL);
+            //}
+         //}
+      } catch(std::exception& e) {
+        exceptionFlag = true;
+        out << e.what() <<std::endl;
+      }
+      report.exception = exceptionFlag;
+      report.peakMemory = sys::MemoryInfo::usedPhysicalMemMax() / 1024.0;
+      if(behaviour == opengm::FAIL) {
+         OPENGM_TEST(exceptionFlag);
+      }else{
+         OPENGM_TEST(!exceptionFlag);
       }
    }
 
@@ -6,6 +6,8 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <algorithm>
 
 namespace opengm{
   
@@ -110,6 +112,96 @@ void disjoint_set<T>::join(T x,T y){
     }
   }
   
+  /// \brief union-find that allows concurrent find and join calls
+  ///
+  /// Roots are linked by compare-and-swap, always the root with the larger
+  /// index below the one with the smaller index. The representative of a set
+  /// is therefore its smallest element, independent of the order in which
+  /// concurrent joins are executed. find() uses path halving.
+  template<class T = size_t>
+  class concurrent_disjoint_set{
+
+  public:
+
+    concurrent_disjoint_set(T = 0);
+
+    void reset();
+    void reset(T);
+    T find(T);
+    bool join(T,T);
+    T numberOfElements() const;
+
+  private:
+
+    std::vector<std::atomic<T> > parents_;
+
+  };
+  // end Class
+
+  template<class T>
+  concurrent_disjoint_set<T>::concurrent_disjoint_set(T numberOfElements)
+  : parents_(numberOfElements){
+    reset();
+  }
+
+  /// make every element a singleton set (not thread safe)
+  template<class T>
+  void concurrent_disjoint_set<T>::reset(){
+    for(T i=0;i<static_cast<T>(parents_.size());++i){
+      parents_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  template<class T>
+  void concurrent_disjoint_set<T>::reset(T numberOfElements){
+    if(static_cast<T>(parents_.size()) != numberOfElements){
+      std::vector<std::atomic<T> > parents(numberOfElements);
+      parents_.swap(parents);
+    }
+    reset();
+  }
+
+  template<class T>
+  T concurrent_disjoint_set<T>::find(T x){
+    for(;;){
+      T p = parents_[x].load(std::memory_order_relaxed);
+      if(p == x){
+        return x;
+      }
+      const T gp = parents_[p].load(std::memory_order_relaxed);
+      if(p != gp){
+        // path halving, losing the race only skips the shortcut
+        parents_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+      }
+      x = gp;
+    }
+  }
+
+  /// \return true if x and y were in different sets
+  template<class T>
+  bool concurrent_disjoint_set<T>::join(T x,T y){
+    for(;;){
+      x = find(x);
+      y = find(y);
+      if(x == y){
+        return false;
+      }
+      if(x < y){
+        std::swap(x, y);
+      }
+      T expected = x;
+      if(parents_[x].compare_exchange_strong(expected, y)){
+        return true;
+      }
+      // x has been linked concurrently, retry from its new root
+    }
+  }
+
+  template<class T>
+  T concurrent_disjoint_set<T>::numberOfElements() const{
+    return static_cast<T>(parents_.size());
+  }
+
 }
 
 
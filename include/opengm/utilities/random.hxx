@@ -7,6 +7,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <cmath>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 
 #include "opengm/opengm.hxx"
 
@@ -154,6 +158,161 @@ public:
 	{}
 };
 
+/// \endcond
+
+/// \brief Splittable counter-based pseudo random number generator
+///
+/// The n-th number of the stream (seed, stream) is a pure function of
+/// (seed, stream, n), namely the splitmix64 finalizer applied to a Weyl sequence.
+/// Independent generators for threads, factors, sampling steps, etc. are obtained
+/// by split() or by choosing the stream, such that parallel computations are
+/// bitwise reproducible, regardless of the number of threads and of the order in
+/// which the streams are consumed. In contrast to RandomUniform, no global
+/// state is involved. The class models the UniformRandomBitGenerator concept
+/// and can be used with std::shuffle and with the distributions of <random>.
+class CounterBasedRandom
+{
+public:
+   typedef UInt64Type result_type;
+
+   CounterBasedRandom(const UInt64Type seed = 0, const UInt64Type stream = 0)
+   :  seed_(seed), 
+      stream_(stream), 
+      counter_(0)
+   {}
+
+   /// 64 random bits of the index-th number of the stream (seed, stream)
+   static UInt64Type hash(const UInt64Type seed, const UInt64Type stream, const UInt64Type index)
+   {
+      UInt64Type z = seed * 0x9E3779B97F4A7C15ULL + stream * 0xD1B54A32D192ED03ULL + index;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+   }
+
+   /// uniform random number in [0, 1) of the index-th number of the stream (seed, stream)
+   static double uniformAt(const UInt64Type seed, const UInt64Type stream, const UInt64Type index)
+   {
+      return toUnit(hash(seed, stream, index));
+   }
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return ~UInt64Type(0); }
+
+   /// next 64 random bits
+   result_type operator()() { return hash(seed_, stream_, counter_++); }
+
+   /// generator of an independent stream, the state of this generator is not changed
+   CounterBasedRandom split(const UInt64Type stream) const
+   {
+      return CounterBasedRandom(hash(seed_, stream_, ~UInt64Type(0)), stream);
+   }
+
+   /// uniform random number in [0, 1)
+   double uniform() { return toUnit((*this)()); }
+
+   /// uniform random number in [low, high)
+   double uniform(const double low, const double high) { return low + (high - low) * uniform(); }
+
+   /// uniform random integer in [0, n)
+   template<class T>
+   T uniformInteger(const T n)
+   {
+      OPENGM_ASSERT(n > 0);
+      const T r = static_cast<T>(uniform() * static_cast<double>(n));
+      return r < n ? r : n - 1;
+   }
+
+   /// normally distributed random number (Box-Muller)
+   double normal(const double mean = 0, const double sigma = 1)
+   {
+      const double u1 = 1.0 - uniform();
+      const double u2 = uniform();
+      return mean + sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+   }
+
+   /// random index i with probability proportional to w_i, given the cumulative weights
+   /// w_0, w_0+w_1, ...
+   template<class ITERATOR>
+   size_t categorical(ITERATOR cumulativeBegin, ITERATOR cumulativeEnd)
+   {
+      OPENGM_ASSERT(cumulativeBegin != cumulativeEnd);
+      const size_t n = static_cast<size_t>(std::distance(cumulativeBegin, cumulativeEnd));
+      ITERATOR last = cumulativeBegin;
+      std::advance(last, n - 1);
+      const double r = uniform() * static_cast<double>(*last);
+      const size_t i = static_cast<size_t>(std::distance(cumulativeBegin, std::upper_bound(cumulativeBegin, last, r)));
+      return i;
+   }
+
+   /// fill a sequence with uniform random numbers in [low, high)
+   ///
+   /// The numbers do not depend on each other, the counter is advanced once.
+   template<class ITERATOR>
+   void fillUniform(ITERATOR begin, ITERATOR end, const double low = 0, const double high = 1)
+   {
+      typedef typename std::iterator_traits<ITERATOR>::value_type T;
+      const UInt64Type first = counter_;
+      UInt64Type i = 0;
+      for(; begin != end; ++begin, ++i) {
+         *begin = static_cast<T>(low + (high - low) * toUnit(hash(seed_, stream_, first + i)));
+      }
+      counter_ += i;
+   }
+
+   /// fill a sequence with normally distributed random numbers
+   template<class ITERATOR>
+   void fillNormal(ITERATOR begin, ITERATOR end, const double mean = 0, const double sigma = 1)
+   {
+      typedef typename std::iterator_traits<ITERATOR>::value_type T;
+      while(begin != end) {
+         // both numbers of a Box-Muller pair are used
+         const double u1 = 1.0 - uniform();
+         const double u2 = uniform();
+         const double radius = sigma * std::sqrt(-2.0 * std::log(u1));
+         *begin = static_cast<T>(mean + radius * std::cos(6.283185307179586 * u2));
+         ++begin;
+         if(begin != end) {
+            *begin = static_cast<T>(mean + radius * std::sin(6.283185307179586 * u2));
+            ++begin;
+         }
+      }
+   }
+
+   /// fill a sequence with random indices drawn from the cumulative weights
+   template<class CUMULATIVE_ITERATOR, class ITERATOR>
+   void fillCategorical(CUMULATIVE_ITERATOR cumulativeBegin, CUMULATIVE_ITERATOR cumulativeEnd, ITERATOR begin, ITERATOR end)
+   {
+      typedef typename std::iterator_traits<ITERATOR>::value_type T;
+      std::vector<double> cumulative(cumulativeBegin, cumulativeEnd);
+      OPENGM_ASSERT(!cumulative.empty());
+      const double total = cumulative.back();
+      for(; begin != end; ++begin) {
+         const double r = uniform() * total;
+         *begin = static_cast<T>(std::upper_bound(cumulative.begin(), cumulative.end() - 1, r) - cumulative.begin());
+      }
+   }
+
+   /// skip n numbers
+   void discard(const UInt64Type n) { counter_ += n; }
+
+   UInt64Type seed() const { return seed_; }
+   UInt64Type stream() const { return stream_; }
+   UInt64Type counter() const { return counter_; }
+
+private:
+   static double toUnit(const UInt64Type bits)
+   {
+      return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+   }
+
+   UInt64Type seed_;
+   UInt64Type stream_;
+   UInt64Type counter_;
+};
+
+/// \cond HIDDEN_SYMBOLS
+
 template<class T, class U>
 class RandomDiscreteWeighted
 {
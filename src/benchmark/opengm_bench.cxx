@@ -0,0 +1,472 @@
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include <opengm/opengm.hxx>
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/graphicalmodel/modelgenerators/syntheticmodelgenerator.hxx>
+#include <opengm/functions/explicit_function.hxx>
+#include <opengm/functions/potts.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/inference/movemaker.hxx>
+#include <opengm/inference/messagepassing/messagepassing.hxx>
+#include <opengm/inference/trws/trws_trws.hxx>
+#include <opengm/utilities/timer.hxx>
+#include <opengm/utilities/random.hxx>
+
+#if defined(WITH_BOOST) || defined(WITH_MAXFLOW)
+#  define OPENGM_BENCH_GRAPHCUT
+#  include <opengm/inference/graphcut.hxx>
+#  include <opengm/inference/alphaexpansion.hxx>
+#  ifdef WITH_BOOST
+#     include <opengm/inference/auxiliary/minstcutboost.hxx>
+#  else
+#     include <opengm/inference/auxiliary/minstcutkolmogorov.hxx>
+#  endif
+#endif
+
+#ifdef WITH_HDF5
+#  include <opengm/graphicalmodel/graphicalmodel_hdf5.hxx>
+#endif
+
+// Benchmarks of the hot paths of OpenGM on models of SyntheticModelGenerator2.
+//
+// All models are generated with fixed seeds such that runs are comparable
+// across releases. Each benchmark is repeated and the minimum, median and
+// mean run time are written as JSON, together with a checksum of the result
+// (e.g. the energy of the labeling found) to detect changes in behaviour.
+//
+// usage: opengm-bench [--filter SUBSTRING] [--repetitions N] [--scale S] [--output FILE] [--list]
+
+typedef double ValueType;
+typedef size_t IndexType;
+typedef size_t LabelType;
+typedef opengm::GraphicalModel<
+   ValueType,
+   opengm::Adder,
+   opengm::meta::TypeListGenerator<
+      opengm::ExplicitFunction<ValueType, IndexType, LabelType>,
+      opengm::PottsFunction<ValueType, IndexType, LabelType>
+   >::type,
+   opengm::DiscreteSpace<IndexType, LabelType>
+> Model;
+typedef opengm::SyntheticModelGenerator2<Model> ModelGenerator;
+
+struct Benchmark {
+   std::string name;
+   std::string model;
+   /// number of operations of one run (e.g. evaluations, iterations)
+   size_t operations;
+   /// performs one run and returns a checksum of its result
+   std::function<double()> run;
+   /// optional, called before / after each run (not timed)
+   std::function<void()> setup;
+   std::function<void()> teardown;
+};
+
+struct Result {
+   std::vector<double> seconds;
+   double checksum;
+};
+
+struct Options {
+   Options() : filter(), repetitions(5), scale(1), output(), list(false) {}
+   std::string filter;
+   size_t repetitions;
+   size_t scale;
+   std::string output;
+   bool list;
+};
+
+// random grid with unary and second order factors
+Model gridModel(const size_t id, const size_t side, const size_t numberOfLabels, const ModelGenerator::FunctionTypes pairwiseType) {
+   ModelGenerator::Parameter parameter;
+   parameter.functionTypes_[1] = pairwiseType;
+   if(pairwiseType == ModelGenerator::GPOTTS) {
+      parameter.functionParameters_[1].assign(1, 0.5);
+   }
+   ModelGenerator generator;
+   return generator.buildGrid(id, side, side, numberOfLabels, parameter);
+}
+
+std::string gridName(const size_t side, const size_t numberOfLabels, const std::string& pairwise) {
+   std::stringstream ss;
+   ss << "grid " << side << "x" << side << ", " << numberOfLabels << " labels, " << pairwise;
+   return ss.str();
+}
+
+// random labelings, generated once such that all runs evaluate the same labelings
+std::vector<std::vector<LabelType> > randomLabelings(const Model& gm, const size_t numberOfLabelings) {
+   opengm::RandomUniform<size_t> random(0, 1 << 30, 42);
+   std::vector<std::vector<LabelType> > labelings(numberOfLabelings, std::vector<LabelType>(gm.numberOfVariables()));
+   for(size_t i = 0; i < numberOfLabelings; ++i) {
+      for(size_t v = 0; v < gm.numberOfVariables(); ++v) {
+         labelings[i][v] = random() % gm.numberOfLabels(v);
+      }
+   }
+   return labelings;
+}
+
+template<class INF>
+double inferValue(const Model& gm, const typename INF::Parameter& parameter) {
+   INF inf(gm, parameter);
+   inf.infer();
+   std::vector<LabelType> labeling;
+   inf.arg(labeling);
+   return gm.evaluate(labeling.begin());
+}
+
+std::vector<Benchmark> benchmarks(const size_t scale) {
+   typedef opengm::BeliefPropagationUpdateRules<Model, opengm::Minimizer> BpUpdateRules;
+   typedef opengm::MessagePassing<Model, opengm::Minimizer, BpUpdateRules, opengm::MaxDistance> Bp;
+   typedef opengm::TrbpUpdateRules<Model, opengm::Minimizer> TrbpUpdateRules;
+   typedef opengm::MessagePassing<Model, opengm::Minimizer, TrbpUpdateRules, opengm::MaxDistance> Trbp;
+   typedef opengm::TRWSi<Model, opengm::Minimizer> TrwsI;
+
+   const size_t side = 64 * scale;
+   const size_t numberOfLabels = 5;
+   const size_t numberOfIterations = 10;
+   // models are shared by the benchmarks and built once
+   std::shared_ptr<Model> grid(new Model(gridModel(0, side, numberOfLabels, ModelGenerator::URANDOM)));
+   std::shared_ptr<Model> potts(new Model(gridModel(1, side, numberOfLabels, ModelGenerator::GPOTTS)));
+   const std::string gridDescription = gridName(side, numberOfLabels, "random pairwise");
+   const std::string pottsDescription = gridName(side, numberOfLabels, "potts");
+
+   std::vector<Benchmark> list;
+   {
+      Benchmark b;
+      b.name = "gm-construction";
+      b.model = gridDescription;
+      b.operations = grid->numberOfFactors();
+      b.run = [side, numberOfLabels]() {
+         const Model gm = gridModel(0, side, numberOfLabels, ModelGenerator::URANDOM);
+         return static_cast<double>(gm.numberOfFactors());
+      };
+      list.push_back(b);
+   }
+   {
+      const size_t numberOfLabelings = 100;
+      std::shared_ptr<std::vector<std::vector<LabelType> > > labelings(
+         new std::vector<std::vector<LabelType> >(randomLabelings(*grid, numberOfLabelings))
+      );
+      Benchmark b;
+      b.name = "evaluate";
+      b.model = gridDescription;
+      b.operations = numberOfLabelings;
+      b.run = [grid, labelings]() {
+         double sum = 0;
+         for(size_t i = 0; i < labelings->size(); ++i) {
+            sum += grid->evaluate((*labelings)[i].begin());
+         }
+         return sum;
+      };
+      list.push_back(b);
+
+      // factor values through the function type dispatch of the factors
+      Benchmark d;
+      d.name = "factor-dispatch";
+      d.model = pottsDescription;
+      d.operations = numberOfLabelings * potts->numberOfFactors();
+      d.run = [potts, labelings]() {
+         std::vector<LabelType> factorLabels;
+         double sum = 0;
+         for(size_t i = 0; i < labelings->size(); ++i) {
+            const std::vector<LabelType>& labeling = (*labelings)[i];
+            for(size_t f = 0; f < potts->numberOfFactors(); ++f) {
+               const Model::FactorType& factor = (*potts)[f];
+               factorLabels.resize(factor.numberOfVariables());
+               for(size_t j = 0; j < factor.numberOfVariables(); ++j) {
+                  factorLabels[j] = labeling[factor.variableIndex(j)];
+               }
+               sum += factor(factorLabels.begin());
+            }
+         }
+         return sum;
+      };
+      list.push_back(d);
+   }
+   {
+      // one sweep of optimal single variable moves (ICM)
+      Benchmark b;
+      b.name = "movemaker-sweep";
+      b.model = gridDescription;
+      b.operations = grid->numberOfVariables();
+      b.run = [grid]() {
+         opengm::Movemaker<Model> movemaker(*grid);
+         for(IndexType v = 0; v < grid->numberOfVariables(); ++v) {
+            movemaker.moveOptimally<opengm::Minimizer>(&v, &v + 1);
+         }
+         return movemaker.value();
+      };
+      list.push_back(b);
+   }
+   {
+      Benchmark b;
+      b.name = "bp-iterations";
+      b.model = gridDescription;
+      b.operations = numberOfIterations;
+      b.run = [grid, numberOfIterations]() {
+         return inferValue<Bp>(*grid, Bp::Parameter(numberOfIterations));
+      };
+      list.push_back(b);
+
+      Benchmark t;
+      t.name = "trbp-iterations";
+      t.model = gridDescription;
+      t.operations = numberOfIterations;
+      t.run = [grid, numberOfIterations]() {
+         return inferValue<Trbp>(*grid, Trbp::Parameter(numberOfIterations));
+      };
+      list.push_back(t);
+
+      Benchmark w;
+      w.name = "trwsi-iterations";
+      w.model = gridDescription;
+      w.operations = numberOfIterations;
+      w.run = [grid, numberOfIterations]() {
+         TrwsI::Parameter parameter(numberOfIterations);
+         parameter.precision() = 0;
+         return inferValue<TrwsI>(*grid, parameter);
+      };
+      list.push_back(w);
+   }
+   #ifdef OPENGM_BENCH_GRAPHCUT
+   {
+      #ifdef WITH_BOOST
+      typedef opengm::MinSTCutBoost<size_t, ValueType, opengm::KOLMOGOROV> MinStCutType;
+      #else
+      typedef opengm::external::MinSTCutKolmogorov<size_t, ValueType> MinStCutType;
+      #endif
+      typedef opengm::GraphCut<Model, opengm::Minimizer, MinStCutType> GraphCut;
+      typedef opengm::AlphaExpansion<Model, GraphCut> AlphaExpansion;
+
+      std::shared_ptr<Model> binary(new Model(gridModel(2, side, 2, ModelGenerator::GPOTTS)));
+      Benchmark b;
+      b.name = "graphcut";
+      b.model = gridName(side, 2, "potts");
+      b.operations = 1;
+      b.run = [binary]() {
+         // the general min st-cut solver, not the grid solver
+         return inferValue<GraphCut>(*binary, GraphCut::Parameter(1, false));
+      };
+      list.push_back(b);
+
+      Benchmark g;
+      g.name = "graphcut-grid";
+      g.model = b.model;
+      g.operations = 1;
+      g.run = [binary]() {
+         return inferValue<GraphCut>(*binary, GraphCut::Parameter(1, true));
+      };
+      list.push_back(g);
+
+      Benchmark a;
+      a.name = "alpha-expansion";
+      a.model = pottsDescription;
+      a.operations = 1;
+      a.run = [potts]() {
+         return inferValue<AlphaExpansion>(*potts, AlphaExpansion::Parameter(1000, GraphCut::Parameter(1, false)));
+      };
+      list.push_back(a);
+   }
+   #endif
+   #ifdef WITH_HDF5
+   {
+      const std::string file = "opengm-bench.h5";
+      Benchmark s;
+      s.name = "hdf5-save";
+      s.model = gridDescription;
+      s.operations = 1;
+      s.run = [grid, file]() {
+         opengm::hdf5::save(*grid, file, "gm");
+         return static_cast<double>(grid->numberOfFactors());
+      };
+      s.teardown = [file]() {
+         std::remove(file.c_str());
+      };
+      list.push_back(s);
+
+      Benchmark l;
+      l.name = "hdf5-load";
+      l.model = gridDescription;
+      l.operations = 1;
+      l.setup = [grid, file]() {
+         opengm::hdf5::save(*grid, file, "gm");
+      };
+      l.run = [file]() {
+         Model gm;
+         opengm::hdf5::load(gm, file, "gm");
+         return static_cast<double>(gm.numberOfFactors());
+      };
+      l.teardown = s.teardown;
+      list.push_back(l);
+   }
+   #endif
+   return list;
+}
+
+Result measure(const Benchmark& benchmark, const size_t repetitions) {
+   Result result;
+   result.checksum = 0;
+   for(size_t r = 0; r < repetitions; ++r) {
+      if(benchmark.setup) {
+         benchmark.setup();
+      }
+      opengm::Timer timer;
+      timer.tic();
+      result.checksum = benchmark.run();
+      timer.toc();
+      result.seconds.push_back(timer.elapsedTime());
+      if(benchmark.teardown) {
+         benchmark.teardown();
+      }
+   }
+   return result;
+}
+
+std::string jsonString(const std::string& s) {
+   std::stringstream ss;
+   ss << '"';
+   for(size_t i = 0; i < s.size(); ++i) {
+      if(s[i] == '"' || s[i] == '\\') {
+         ss << '\\';
+      }
+      ss << s[i];
+   }
+   ss << '"';
+   return ss.str();
+}
+
+void writeJson(std::ostream& out, const Options& options, const std::vector<Benchmark>& list, const std::vector<Result>& results) {
+   #ifdef WITH_OPENMP
+   const bool openmp = true;
+   const int numberOfThreads = omp_get_max_threads();
+   #else
+   const bool openmp = false;
+   const int numberOfThreads = 1;
+   #endif
+   out.precision(10);
+   out << "{\n";
+   out << "  \"version\": \"" << opengm::VERSION_MAJOR << "." << opengm::VERSION_MINOR << "." << opengm::VERSION_PATCH << "\",\n";
+   #ifdef __VERSION__
+   out << "  \"compiler\": " << jsonString(__VERSION__) << ",\n";
+   #endif
+   out << "  \"openmp\": " << (openmp ? "true" : "false") << ",\n";
+   out << "  \"threads\": " << numberOfThreads << ",\n";
+   out << "  \"repetitions\": " << options.repetitions << ",\n";
+   out << "  \"scale\": " << options.scale << ",\n";
+   out << "  \"benchmarks\": [";
+   for(size_t i = 0; i < list.size(); ++i) {
+      std::vector<double> seconds = results[i].seconds;
+      std::sort(seconds.begin(), seconds.end());
+      double mean = 0;
+      for(size_t r = 0; r < seconds.size(); ++r) {
+         mean += seconds[r];
+      }
+      mean /= seconds.size();
+      const double median = seconds.size() % 2 == 1 ? seconds[seconds.size() / 2]
+         : 0.5 * (seconds[seconds.size() / 2 - 1] + seconds[seconds.size() / 2]);
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    {\n";
+      out << "      \"name\": " << jsonString(list[i].name) << ",\n";
+      out << "      \"model\": " << jsonString(list[i].model) << ",\n";
+      out << "      \"operations\": " << list[i].operations << ",\n";
+      out << "      \"min_seconds\": " << seconds.front() << ",\n";
+      out << "      \"median_seconds\": " << median << ",\n";
+      out << "      \"mean_seconds\": " << mean << ",\n";
+      out << "      \"seconds_per_operation\": " << seconds.front() / list[i].operations << ",\n";
+      out << "      \"checksum\": " << results[i].checksum << "\n";
+      out << "    }";
+   }
+   out << "\n  ]\n}\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+   Options options;
+   for(int i = 1; i < argc; ++i) {
+      const std::string arg(argv[i]);
+      if(arg == "--list") {
+         options.list = true;
+         continue;
+      }
+      if(i + 1 >= argc) {
+         throw std::runtime_error("missing value of " + arg);
+      }
+      const std::string value(argv[++i]);
+      if(arg == "--filter") {
+         options.filter = value;
+      }
+      else if(arg == "--repetitions") {
+         options.repetitions = static_cast<size_t>(std::max(1, atoi(value.c_str())));
+      }
+      else if(arg == "--scale") {
+         options.scale = static_cast<size_t>(std::max(1, atoi(value.c_str())));
+      }
+      else if(arg == "--output") {
+         options.output = value;
+      }
+      else {
+         throw std::runtime_error("unknown option " + arg);
+      }
+   }
+   return options;
+}
+
+int main(int argc, char** argv) {
+   Options options;
+   try {
+      options = parseOptions(argc, argv);
+   }
+   catch(const std::exception& e) {
+      std::cerr << e.what() << "\n"
+         << "usage: opengm-bench [--filter SUBSTRING] [--repetitions N] [--scale S] [--output FILE] [--list]" << std::endl;
+      return 1;
+   }
+
+   const std::vector<Benchmark> all = benchmarks(options.scale);
+   std::vector<Benchmark> list;
+   for(size_t i = 0; i < all.size(); ++i) {
+      if(all[i].name.find(options.filter) != std::string::npos) {
+         list.push_back(all[i]);
+      }
+   }
+   if(options.list) {
+      for(size_t i = 0; i < list.size(); ++i) {
+         std::cout << list[i].name << " (" << list[i].model << ")" << std::endl;
+      }
+      return 0;
+   }
+
+   std::vector<Result> results;
+   for(size_t i = 0; i < list.size(); ++i) {
+      std::cerr << list[i].name << " ..." << std::flush;
+      results.push_back(measure(list[i], options.repetitions));
+      std::cerr << " " << *std::min_element(results.back().seconds.begin(), results.back().seconds.end()) << " s" << std::endl;
+   }
+
+   if(options.output.empty()) {
+      writeJson(std::cout, options, list, results);
+   }
+   else {
+      std::ofstream out(options.output.c_str());
+      if(!out) {
+         std::cerr << "cannot write " << options.output << std::endl;
+         return 1;
+      }
+      writeJson(out, options, list, results);
+   }
+   return 0;
+}
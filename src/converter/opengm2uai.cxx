@@ -1,11 +1,11 @@
 #include <string>
 #include <vector>
 #include <iostream>
-#include <fstream>
 
 
 #include <opengm/graphicalmodel/graphicalmodel.hxx>
 #include <opengm/graphicalmodel/graphicalmodel_hdf5.hxx>
+#include <opengm/graphicalmodel/graphicalmodel_uai.hxx>
 #include <opengm/operations/minimizer.hxx>
 #include <opengm/operations/adder.hxx>
 #include <opengm/functions/explicit_function.hxx>
@@ -18,6 +18,10 @@
 
 int
 main(int argc, const char* argv[] ) {
+   if(argc != 3) {
+      std::cerr << "Two input arguments required" << std::endl;
+      return 1;
+   }
 
    typedef double ValueType;
    typedef size_t IndexType;
@@ -50,52 +54,14 @@ main(int argc, const char* argv[] ) {
    std::string uaifile    = argv[2];
  
    opengm::hdf5::load(gm, opengmfile,"gm");
-   std::ofstream myuaifile;
-   myuaifile.open(uaifile.c_str());
-   myuaifile << "MARKOV" << std::endl;
-   myuaifile << gm.numberOfVariables() << std::endl;
-   for(IndexType var=0; var<gm.numberOfVariables(); ++var){
-      myuaifile << gm.numberOfLabels(var) << " ";
-   }
-   myuaifile << std::endl;
-   myuaifile << gm.numberOfFactors() << std::endl;
-   for(IndexType f=0; f<gm.numberOfFactors(); ++f){
-      myuaifile << gm[f].numberOfVariables() << " " ;
-      for(IndexType i=0; i<gm[f].numberOfVariables(); ++i){
-         myuaifile << gm[f].variableIndex(i) << " "; 
-      } 
-      myuaifile << std::endl;
-   }
-   LabelType l[3] = {0,0,0};
-   for(IndexType f=0; f<gm.numberOfFactors(); ++f){
-      myuaifile << std::endl;
-      myuaifile << gm[f].size() << std::endl;
-      if(gm[f].numberOfVariables()==0){
-         l[0]=0;
-         myuaifile << std::exp(-gm[f](l)) << std::endl;
-      }
-      else if(gm[f].numberOfVariables()==1){
-         for(l[0]=0; l[0]<gm[f].numberOfLabels(0); ++l[0]){
-            myuaifile << std::exp(-gm[f](l)) << " "; 
-         } 
-         myuaifile << std::endl;
-
-      } 
-      else if(gm[f].numberOfVariables()==2){
-         for(l[0]=0; l[0]<gm[f].numberOfLabels(0); ++l[0]){
-            for(l[1]=0; l[1]<gm[f].numberOfLabels(1); ++l[1]){
-               myuaifile << std::exp(-gm[f](l)) << " "; 
-            }
-            myuaifile << std::endl;
-         }
-      }
-      else{
-         std::cout << "Factors of order higher than 2 are so far not supported !" <<std::endl;
-         myuaifile.close();
-         return 1;
-      }
 
+   // energies v are stored as probabilities exp(-v)
+   try {
+      opengm::uai::save(gm, uaifile);
+   }
+   catch(std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
    }
-   myuaifile.close();
    return 0;
 }
@@ -0,0 +1,95 @@
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include <opengm/graphicalmodel/grid_graphicalmodel.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/inference/graphcut.hxx>
+#include <opengm/inference/auxiliary/minstcutgrid.hxx>
+#include <opengm/inference/auxiliary/minstcutboost.hxx>
+#include <opengm/utilities/timer.hxx>
+
+using namespace std; // 'using' is used only in example code
+
+// binary segmentation of a noisy synthetic image (a disc on a gradient
+// background) with GraphCut on 1 to 16 megapixel grids: MinSTCutGrid with
+// one and with all threads and the Boykov-Kolmogorov solver of Boost (up to
+// 4 megapixels, its adjacency list graph needs much more memory)
+
+typedef float ValueType;
+typedef opengm::GridGraphicalModel<ValueType, opengm::Adder> Model;
+typedef opengm::MinSTCutBoost<size_t, ValueType, opengm::KOLMOGOROV> MinStCutType;
+typedef opengm::GraphCut<Model, opengm::Minimizer, MinStCutType> GraphCut;
+
+void segmentationModel(const size_t width, const size_t height, Model& gm) {
+   gm.assign(width, height, 2);
+   const double r = 0.35 * min(width, height);
+   for(size_t y = 0; y < height; ++y) {
+      for(size_t x = 0; x < width; ++x) {
+         const double dx = x - 0.5 * width;
+         const double dy = y - 0.5 * height;
+         const double foreground = dx * dx + dy * dy < r * r ? 0.7 : 0.3 * x / width;
+         const double intensity = foreground + 0.4 * (static_cast<double>(rand()) / RAND_MAX - 0.5);
+         const size_t v = gm.variableIndex(x, y);
+         gm.unary(v, 0) = static_cast<ValueType>(intensity * intensity);
+         gm.unary(v, 1) = static_cast<ValueType>((1.0 - intensity) * (1.0 - intensity));
+      }
+   }
+   const size_t shape[] = {2, 2};
+   opengm::ExplicitFunction<ValueType> potts(shape, shape + 2, 0.1f);
+   potts(0, 0) = potts(1, 1) = 0;
+   gm.setPairwiseFunction(Model::Horizontal, potts);
+   gm.setPairwiseFunction(Model::Vertical, potts);
+}
+
+double run(const Model& gm, const GraphCut::Parameter& parameter, ValueType& value) {
+   opengm::Timer timer;
+   timer.tic();
+   GraphCut gc(gm, parameter);
+   gc.infer();
+   timer.toc();
+   vector<size_t> labeling;
+   gc.arg(labeling);
+   value = gm.evaluate(labeling.begin());
+   return timer.elapsedTime();
+}
+
+int main() {
+   #ifdef WITH_OPENMP
+   const size_t numberOfThreads = static_cast<size_t>(omp_get_max_threads());
+   #else
+   const size_t numberOfThreads = 1;
+   #endif
+   cout << "megapixels  grid (1 thread)  grid (" << numberOfThreads << " threads)  kolmogorov  [seconds]" << endl;
+
+   srand(42);
+   for(size_t megapixels = 1; megapixels <= 16; megapixels *= 2) {
+      const size_t side = static_cast<size_t>(sqrt(megapixels * 1e6));
+      Model gm;
+      segmentationModel(side, side, gm);
+
+      ValueType single, multi;
+      const double tSingle = run(gm, GraphCut::Parameter(1, true, 1), single);
+      const double tMulti = run(gm, GraphCut::Parameter(1, true, numberOfThreads), multi);
+      cout << megapixels << "  " << tSingle << "  " << tMulti;
+      if(megapixels <= 4) {
+         ValueType reference;
+         const double tReference = run(gm, GraphCut::Parameter(1, false), reference);
+         cout << "  " << tReference;
+         if(fabs(reference - multi) > 1e-3 * fabs(reference)) {
+            cout << "  (energy differs: " << multi << " vs. " << reference << ")";
+         }
+      }
+      if(single != multi) {
+         cout << "  (energy depends on the number of threads: " << single << " vs. " << multi << ")";
+      }
+      cout << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,90 @@
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+
+#include <opengm/functions/sparsemarray.hxx>
+#include <opengm/utilities/timer.hxx>
+
+using namespace std; // 'using' is used only in example code
+
+// compares the lookup performance of the containers of the SparseFunction
+// on a table of 10^6 non-default entries (out of 10^8 entries in total)
+
+template<class FUNCTION>
+double lookup(const FUNCTION& f, const vector<size_t>& queries, const size_t repetitions, double& checksum) {
+   opengm::Timer timer;
+   timer.tic();
+   size_t c[2];
+   for(size_t r = 0; r < repetitions; ++r) {
+      for(size_t q = 0; q < queries.size(); ++q) {
+         f.keyToCoordinate(queries[q], c);
+         checksum += f(c);
+      }
+   }
+   timer.toc();
+   return timer.elapsedTime() / static_cast<double>(repetitions * queries.size()) * 1e9;
+}
+
+int main() {
+   typedef double ValueType;
+   typedef opengm::SparseFunction<ValueType, size_t, size_t> MapFunction;
+   typedef opengm::SparseFunction<ValueType, size_t, size_t, opengm::OpenAddressingMap<size_t, ValueType> > HashFunction;
+   typedef opengm::SparseFunction<ValueType, size_t, size_t, opengm::SortedArrayMap<size_t, ValueType> > SortedFunction;
+
+   const size_t shape[] = {10000, 10000};
+   const size_t numberOfEntries = 1000000;
+   const size_t numberOfQueries = 1000000;
+   const size_t repetitions = 5;
+
+   // build the function with the default (map based) container
+   srand(42);
+   MapFunction mapFunction(shape, shape + 2, 0.0);
+   size_t c[2];
+   while(mapFunction.container().size() < numberOfEntries) {
+      c[0] = rand() % shape[0];
+      c[1] = rand() % shape[1];
+      mapFunction.insert(c, static_cast<ValueType>(rand()) / RAND_MAX);
+   }
+
+   // freeze into the flat containers
+   opengm::Timer timer;
+   timer.tic();
+   HashFunction hashFunction(mapFunction);
+   timer.toc();
+   const double hashBuild = timer.elapsedTime();
+   timer.reset();
+   timer.tic();
+   SortedFunction sortedFunction(mapFunction);
+   timer.toc();
+   const double sortedBuild = timer.elapsedTime();
+
+   // half of the queries hit a stored entry, the other half the default value
+   vector<size_t> queries(numberOfQueries);
+   MapFunction::ConstContainerIteratorType it = mapFunction.container().begin();
+   for(size_t q = 0; q < numberOfQueries; ++q) {
+      if(q % 2 == 0) {
+         queries[q] = it->first;
+         ++it;
+      }
+      else {
+         queries[q] = static_cast<size_t>(rand()) % (shape[0] * shape[1]);
+      }
+   }
+   random_shuffle(queries.begin(), queries.end());
+
+   double cMap = 0, cHash = 0, cSorted = 0;
+   const double tMap = lookup(mapFunction, queries, repetitions, cMap);
+   const double tHash = lookup(hashFunction, queries, repetitions, cHash);
+   const double tSorted = lookup(sortedFunction, queries, repetitions, cSorted);
+
+   cout << "entries            : " << numberOfEntries << endl;
+   cout << "std::map           : " << tMap << " ns/lookup" << endl;
+   cout << "OpenAddressingMap  : " << tHash << " ns/lookup (freeze " << hashBuild << " s)" << endl;
+   cout << "SortedArrayMap     : " << tSorted << " ns/lookup (freeze " << sortedBuild << " s)" << endl;
+   if(cMap != cHash || cMap != cSorted) {
+      cout << "checksum mismatch" << endl;
+      return 1;
+   }
+   return 0;
+}
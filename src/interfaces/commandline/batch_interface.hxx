@@ -0,0 +1,380 @@
+#ifndef BATCH_INTERFACE_HXX_
+#define BATCH_INTERFACE_HXX_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <chrono>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include <opengm/opengm.hxx>
+#include <opengm/graphicalmodel/graphicalmodel_hdf5.hxx>
+
+#include "io_cmd.hxx"
+#include "../common/argument/argument_executer.hxx"
+
+namespace opengm {
+
+namespace interface {
+
+/********************
+ * class definition *
+ ********************/
+
+template<class TYPELIST, class GM, size_t IX, size_t DX, bool END>
+struct runCallerWithTypeFromString;
+
+template<class TYPELIST, class GM, size_t IX, size_t DX>
+struct runCallerWithTypeFromString<TYPELIST, GM, IX, DX, false> {
+   static void execute(const std::string& typeName, IOCMD& io, GM& gm, StringArgument<>& outputfile, const bool verbose);
+};
+
+template<class TYPELIST, class GM, size_t IX, size_t DX>
+struct runCallerWithTypeFromString<TYPELIST, GM, IX, DX, true> {
+   static void execute(const std::string& typeName, IOCMD& io, GM& gm, StringArgument<>& outputfile, const bool verbose);
+};
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+class BatchInterface {
+public:
+   BatchInterface(int argc, char** argv);
+   virtual ~BatchInterface();
+
+   static bool requested(int argc, char** argv);
+   int run();
+
+protected:
+   typedef typename GM::ValueType ValueType;
+
+   struct Job {
+      size_t line_;
+      std::string model_;
+      std::string outputfile_;
+      std::string algorithm_;
+      std::vector<std::string> arguments_;
+      bool succeeded_;
+      std::string error_;
+      double modelTime_;
+      double runTime_;
+      ValueType value_;
+   };
+
+   IOCMD commandlineIO_;
+   ArgumentExecuter<IOCMD> argumentContainer_;
+
+   // Storage for input variables
+   bool helpRequested_;
+   bool verboseRequested_;
+   std::string manifest_;
+   std::string summary_;
+   size_t numberOfThreads_;
+
+   std::vector<Job> jobs_;
+   std::map<std::string, GM*> models_;
+   std::map<std::string, double> modelTimes_;
+   std::map<std::string, std::string> modelErrors_;
+
+   void readManifest();
+   void loadModels();
+   void runJob(Job& job);
+   void writeSummary() const;
+   double wallTime() const;
+};
+
+/***********************
+ * class documentation *
+ ***********************/
+
+/**
+ * @class BatchInterface
+ * @brief Runs a list of inference jobs inside one process.
+ * @details The jobs are read from a manifest file, one job per line:
+ *          \code
+ *          model.h5:gm result.h5 ALGORITHM [algorithm arguments]
+ *          \endcode
+ *          The algorithm arguments use the same syntax as single runs of the
+ *          command line interface. Empty lines and lines starting with '#'
+ *          are skipped. Every model is loaded once, even if several jobs
+ *          use it. WITH_OPENMP the jobs are distributed over a number of
+ *          worker threads, file access is serialized. A job whose model
+ *          cannot be loaded or whose inference or output fails is reported
+ *          as failed, the other jobs are run nevertheless. One line per job
+ *          with status, energy of the result and wall clock times is written
+ *          to a CSV summary.
+ */
+
+/******************
+ * implementation *
+ ******************/
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline BatchInterface<GM, INFERENCETYPES>::BatchInterface(int argc, char** argv)
+: commandlineIO_(argc, argv), argumentContainer_(commandlineIO_, 10) {
+   argumentContainer_.addArgument(BoolArgument(helpRequested_, "h", "help", "used to activate help output"));
+   argumentContainer_.addArgument(BoolArgument(verboseRequested_, "v", "verbose", "used to activate verbose output"));
+   argumentContainer_.addArgument(StringArgument<>(manifest_, "", "batch", "manifest file with one job per line. Usage: \"model.h5:dataset result.h5 ALGORITHM [algorithm arguments]\"", true));
+   std::string defaultSummary = "opengm_batch.csv";
+   argumentContainer_.addArgument(StringArgument<>(summary_, "", "summary", "CSV file to which status, energy and timing of all jobs are written", defaultSummary));
+   argumentContainer_.addArgument(Size_TArgument<>(numberOfThreads_, "", "threads", "number of worker threads (0 = one per core), used only WITH_OPENMP", size_t(0)));
+}
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline BatchInterface<GM, INFERENCETYPES>::~BatchInterface() {
+   for(typename std::map<std::string, GM*>::iterator iter = models_.begin(); iter != models_.end(); ++iter) {
+      delete iter->second;
+   }
+}
+
+/**
+ * @brief Checks if batch mode is requested on the command line.
+ */
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline bool BatchInterface<GM, INFERENCETYPES>::requested(int argc, char** argv) {
+   const std::string batch = ArgumentBaseDelimiter::delimiter_ + ArgumentBaseDelimiter::delimiter_ + "batch";
+   for(int i = 1; i < argc; ++i) {
+      if(batch == argv[i]) {
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * @brief Runs all jobs of the manifest.
+ * @return 0 if all jobs succeeded, 1 otherwise.
+ */
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline int BatchInterface<GM, INFERENCETYPES>::run() {
+   argumentContainer_.read();
+   if(helpRequested_) {
+      std::cout << "Batch mode of the command line interface of the opengm library" << std::endl;
+      std::cout << "Usage: opengm --batch manifest.txt [arguments]" << std::endl;
+      std::cout << "arguments:" << std::endl;
+      std::cout << std::setw(12) << std::left << "  short name" << std::setw(29) << std::left << "  long name" << std::setw(8) << std::left << "needed" << "description" << std::endl;
+      argumentContainer_.printHelp(std::cout, true);
+      return 0;
+   }
+
+   readManifest();
+   loadModels();
+
+   #ifdef WITH_OPENMP
+   const int nThreads = numberOfThreads_ > 0 ? static_cast<int>(numberOfThreads_) : omp_get_max_threads();
+   #pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+   #endif
+   for(std::ptrdiff_t j = 0; j < static_cast<std::ptrdiff_t>(jobs_.size()); ++j) {
+      runJob(jobs_[j]);
+   }
+
+   writeSummary();
+   size_t failed = 0;
+   for(size_t j = 0; j < jobs_.size(); ++j) {
+      if(!jobs_[j].succeeded_) {
+         commandlineIO_.errorStream() << "job in line " << jobs_[j].line_ << " failed: " << jobs_[j].error_ << std::endl;
+         ++failed;
+      }
+   }
+   commandlineIO_.standardStream() << jobs_.size() - failed << " of " << jobs_.size() << " jobs succeeded, summary written to " << summary_ << std::endl;
+   return failed == 0 ? 0 : 1;
+}
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline void BatchInterface<GM, INFERENCETYPES>::readManifest() {
+   std::ifstream manifest(manifest_.c_str());
+   if(!manifest) {
+      throw RuntimeError("Unable to open manifest file " + manifest_);
+   }
+   std::string line;
+   size_t lineNumber = 0;
+   while(std::getline(manifest, line)) {
+      ++lineNumber;
+      std::istringstream tokens(line);
+      std::vector<std::string> fields;
+      std::string token;
+      while(tokens >> token) {
+         fields.push_back(token);
+      }
+      if(fields.empty() || fields[0][0] == '#') {
+         continue;
+      }
+      if(fields.size() < 3) {
+         std::stringstream error;
+         error << "line " << lineNumber << " of " << manifest_ << " does not specify model, output file and algorithm";
+         throw RuntimeError(error.str());
+      }
+      Job job;
+      job.line_ = lineNumber;
+      job.model_ = fields[0];
+      job.outputfile_ = fields[1];
+      job.algorithm_ = fields[2];
+      job.arguments_.assign(fields.begin() + 3, fields.end());
+      job.succeeded_ = false;
+      job.modelTime_ = 0.0;
+      job.runTime_ = 0.0;
+      job.value_ = std::numeric_limits<ValueType>::quiet_NaN();
+      jobs_.push_back(job);
+   }
+}
+
+// Models are loaded sequentially before the workers start (HDF5 is not
+// thread safe), each distinct model:dataset only once.
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline void BatchInterface<GM, INFERENCETYPES>::loadModels() {
+   for(size_t j = 0; j < jobs_.size(); ++j) {
+      Job& job = jobs_[j];
+      std::string modelFilename;
+      std::string dataset;
+      commandlineIO_.separateFilename(job.model_, modelFilename, dataset);
+      if(dataset.empty()) {
+         dataset = "gm";
+      }
+      job.model_ = modelFilename + ":" + dataset;
+      if(modelErrors_.find(job.model_) == modelErrors_.end() && models_.find(job.model_) == models_.end()) {
+         commandlineIO_.standardStream() << "loading model: " << modelFilename << ":" << dataset << std::endl;
+         const double start = wallTime();
+         GM* gm = new GM();
+         try {
+            opengm::hdf5::load(*gm, modelFilename, dataset);
+            models_[job.model_] = gm;
+         }
+         catch(std::exception& e) {
+            // only the jobs using this model fail
+            delete gm;
+            modelErrors_[job.model_] = std::string("unable to load model: ") + e.what();
+         }
+         modelTimes_[job.model_] = wallTime() - start;
+      }
+      job.modelTime_ = modelTimes_[job.model_];
+      if(modelErrors_.find(job.model_) != modelErrors_.end()) {
+         job.error_ = modelErrors_[job.model_];
+      }
+   }
+}
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline void BatchInterface<GM, INFERENCETYPES>::runJob(Job& job) {
+   if(models_.find(job.model_) == models_.end()) {
+      // the model could not be loaded, the error is already set
+      return;
+   }
+
+   // job local command line: program name, output file and the algorithm arguments
+   std::vector<std::string> tokens;
+   tokens.push_back("opengm");
+   tokens.push_back(ArgumentBaseDelimiter::delimiter_ + "o");
+   tokens.push_back(job.outputfile_);
+   tokens.insert(tokens.end(), job.arguments_.begin(), job.arguments_.end());
+   std::vector<std::vector<char> > storage(tokens.size());
+   std::vector<char*> argv(tokens.size());
+   for(size_t j = 0; j < tokens.size(); ++j) {
+      storage[j].assign(tokens[j].begin(), tokens[j].end());
+      storage[j].push_back('\0');
+      argv[j] = &storage[j][0];
+   }
+
+   const double start = wallTime();
+   try {
+      IOCMD io(static_cast<int>(argv.size()), &argv[0]);
+      std::string outputfile;
+      StringArgument<> output(outputfile, "o", "outputfile", "used to specify the desired outputfile for the computed results", true);
+      GM& gm = *models_.find(job.model_)->second;
+      const size_t length = opengm::meta::LengthOfTypeList<INFERENCETYPES>::value;
+      runCallerWithTypeFromString<INFERENCETYPES, GM, 0, length, opengm::meta::EqualNumber<length, 0>::value>::execute(job.algorithm_, io, gm, output, verboseRequested_);
+      job.runTime_ = wallTime() - start;
+
+      std::vector<typename GM::LabelType> states;
+      io.loadVector(outputfile + ":states", states);
+      if(states.size() == gm.numberOfVariables()) {
+         job.value_ = gm.evaluate(states.begin());
+      }
+      job.succeeded_ = true;
+   }
+   catch(std::exception& e) {
+      job.runTime_ = wallTime() - start;
+      job.error_ = e.what();
+   }
+}
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline void BatchInterface<GM, INFERENCETYPES>::writeSummary() const {
+   std::ofstream summary(summary_.c_str());
+   if(!summary) {
+      throw RuntimeError("Unable to open summary file " + summary_);
+   }
+   summary << "line,model,algorithm,outputfile,status,value,model_seconds,run_seconds" << std::endl;
+   summary << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+   for(size_t j = 0; j < jobs_.size(); ++j) {
+      const Job& job = jobs_[j];
+      summary << job.line_ << "," << job.model_ << "," << job.algorithm_ << "," << job.outputfile_ << ","
+         << (job.succeeded_ ? "ok" : "failed") << "," << job.value_ << ","
+         << job.modelTime_ << "," << job.runTime_ << std::endl;
+   }
+}
+
+template <
+   class GM,
+   class INFERENCETYPES
+>
+inline double BatchInterface<GM, INFERENCETYPES>::wallTime() const {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<class TYPELIST, class GM, size_t IX, size_t DX>
+inline void runCallerWithTypeFromString<TYPELIST, GM, IX, DX, true>::execute(const std::string& typeName, IOCMD& io, GM& gm, StringArgument<>& outputfile, const bool verbose) {
+   std::string error("Unknown type: ");
+   error += typeName;
+   throw opengm::RuntimeError(error);
+}
+
+template<class TYPELIST, class GM, size_t IX, size_t DX>
+inline void runCallerWithTypeFromString<TYPELIST, GM, IX, DX, false>::execute(const std::string& typeName, IOCMD& io, GM& gm, StringArgument<>& outputfile, const bool verbose) {
+   typedef typename opengm::meta::TypeAtTypeList<TYPELIST, IX>::type currentType;
+   if(typeName == (std::string)currentType::name_) {
+      currentType caller(io);
+      caller.run(gm, outputfile, verbose);
+   } else {
+      // proceed with next type
+      typedef typename opengm::meta::Increment<IX>::type NewIX;
+      runCallerWithTypeFromString<TYPELIST, GM, NewIX::value, DX, opengm::meta::EqualNumber<NewIX::value, DX>::value >::execute(typeName, io, gm, outputfile, verbose);
+   }
+}
+
+} // namespace interface
+
+} // namespace opengm
+
+#endif /* BATCH_INTERFACE_HXX_ */
@@ -12,6 +12,7 @@
 #include "opengm/functions/truncated_squared_difference.hxx"
 #include "opengm/functions/fieldofexperts.hxx"
 #include "../cmd_interface.hxx"
+#include "../batch_interface.hxx"
 
 //inference caller
 #include "../../common/caller/bruteforce_caller.hxx"
@@ -30,6 +31,8 @@
 #include "../../common/caller/greedygremlin_caller.hxx"
 #include "../../common/caller/selffusion_caller.hxx"
 #include "../../common/caller/fusion_caller.hxx"
+#include "../../common/caller/portfolio_caller.hxx"
+#include "../../common/caller/admm_caller.hxx"
 
 #ifdef WITH_TRWS
 #include "../../common/caller/trws_caller.hxx"
@@ -176,6 +179,16 @@ int main(int argc, char** argv) {
       opengm::meta::ListEnd
    >::type NativeInferenceTypeList;
 
+   typedef meta::TypeListGenerator <
+      interface::ADMMCaller<InterfaceType, GmType, AccumulatorType>,
+      opengm::meta::ListEnd
+   >::type NativeLPInferenceTypeList;
+
+   typedef meta::TypeListGenerator <
+      interface::PortfolioCaller<InterfaceType, GmType, AccumulatorType>,
+      opengm::meta::ListEnd
+   >::type MetaInferenceTypeList;
+
    typedef meta::TypeListGenerator <
 #if defined(WITH_MAXFLOW) || defined(WITH_BOOST)
       interface::GraphCutCaller<InterfaceType, GmType, AccumulatorType>,
@@ -249,8 +262,14 @@ int main(int argc, char** argv) {
       opengm::meta::ListEnd
    >::type ExternalILPInferenceTypeList;
 
-   typedef meta::MergeTypeLists<NativeInferenceTypeList, ExternalInferenceTypeList>::type InferenceTypeList_T1;
-   typedef meta::MergeTypeLists<ExternalILPInferenceTypeList, InferenceTypeList_T1>::type InferenceTypeList;
+   typedef meta::MergeTypeLists<NativeInferenceTypeList, NativeLPInferenceTypeList>::type InferenceTypeList_T0;
+   typedef meta::MergeTypeLists<InferenceTypeList_T0, ExternalInferenceTypeList>::type InferenceTypeList_T1;
+   typedef meta::MergeTypeLists<MetaInferenceTypeList, InferenceTypeList_T1>::type InferenceTypeList_T2;
+   typedef meta::MergeTypeLists<ExternalILPInferenceTypeList, InferenceTypeList_T2>::type InferenceTypeList;
+   if(interface::BatchInterface<GmType, InferenceTypeList>::requested(argc, argv)) {
+      interface::BatchInterface<GmType, InferenceTypeList> batch(argc, argv);
+      return batch.run();
+   }
    interface::CMDInterface<GmType, InferenceTypeList> interface(argc, argv);
    interface.parse();
 
@@ -11,6 +11,7 @@
 #include "opengm/functions/truncated_absolute_difference.hxx"
 #include "opengm/functions/truncated_squared_difference.hxx"
 #include "../cmd_interface.hxx"
+#include "../batch_interface.hxx"
 
 //inference caller
 #include "../../common/caller/bruteforce_caller.hxx"
@@ -132,6 +133,10 @@ int main(int argc, char** argv) {
    >::type ExternalInferenceTypeList;
 
    typedef meta::MergeTypeLists<NativeInferenceTypeList, ExternalInferenceTypeList>::type InferenceTypeList;
+   if(interface::BatchInterface<GmType, InferenceTypeList>::requested(argc, argv)) {
+      interface::BatchInterface<GmType, InferenceTypeList> batch(argc, argv);
+      return batch.run();
+   }
    interface::CMDInterface<GmType, InferenceTypeList> interface(argc, argv);
    interface.parse();
 
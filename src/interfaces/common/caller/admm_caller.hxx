@@ -0,0 +1,66 @@
+#ifndef ADMM_CALLER_HXX_
+#define ADMM_CALLER_HXX_
+
+#include <opengm/opengm.hxx>
+#include <opengm/inference/admm.hxx>
+
+#include "inference_caller_base.hxx"
+#include "../argument/argument.hxx"
+
+namespace opengm {
+
+namespace interface {
+
+template <class IO, class GM, class ACC>
+class ADMMCaller : public InferenceCallerBase<IO, GM, ACC, ADMMCaller<IO, GM, ACC> > {
+public:
+   typedef ADMM<GM, ACC> Solver;
+   typedef InferenceCallerBase<IO, GM, ACC, ADMMCaller<IO, GM, ACC> > BaseClass;
+   typedef typename Solver::VerboseVisitorType VerboseVisitorType;
+   typedef typename Solver::EmptyVisitorType   EmptyVisitorType;
+   typedef typename Solver::TimingVisitorType  TimingVisitorType;
+
+   const static std::string name_;
+   ADMMCaller(IO& ioIn);
+   virtual ~ADMMCaller();
+protected:
+   using BaseClass::addArgument;
+   using BaseClass::io_;
+   using BaseClass::infer;
+
+   typedef typename BaseClass::OutputBase OutputBase;
+
+   typename Solver::Parameter param_;
+
+   virtual void runImpl(GM& model, OutputBase& output, const bool verbose);
+};
+
+template <class IO, class GM, class ACC>
+inline ADMMCaller<IO, GM, ACC>::ADMMCaller(IO& ioIn)
+   : BaseClass(name_, "in-tree alternating directions dual decomposition (AD3) of the local polytope relaxation", ioIn) {
+   addArgument(Size_TArgument<>(param_.steps_, "", "steps", "maximum number of iterations", param_.steps_));
+   addArgument(DoubleArgument<>(param_.eta_, "", "eta", "initial penalty of the augmented Lagrangian", param_.eta_));
+   addArgument(BoolArgument(param_.adaptEta_, "", "adaptEta", "adapt eta to balance primal and dual residual"));
+   addArgument(DoubleArgument<>(param_.residualThreshold_, "", "residualThreshold", "stop if primal and dual residual fall below this threshold", param_.residualThreshold_));
+   addArgument(Size_TArgument<>(param_.numberOfThreads_, "", "threads", "number of threads solving factor subproblems (0 = one per core)", param_.numberOfThreads_));
+}
+
+template <class IO, class GM, class ACC>
+inline ADMMCaller<IO, GM, ACC>::~ADMMCaller() {
+
+}
+
+template <class IO, class GM, class ACC>
+inline void ADMMCaller<IO, GM, ACC>::runImpl(GM& model, OutputBase& output, const bool verbose) {
+   std::cout << "running ADMM caller" << std::endl;
+   this-> template infer<Solver, TimingVisitorType, typename Solver::Parameter>(model, output, verbose, param_);
+}
+
+template <class IO, class GM, class ACC>
+const std::string ADMMCaller<IO, GM, ACC>::name_ = "ADMM";
+
+} // namespace interface
+
+} // namespace opengm
+
+#endif /* ADMM_CALLER_HXX_ */
@@ -41,6 +41,7 @@ inline LOCCaller<IO, GM, ACC>::LOCCaller(IO& ioIn)
    std::vector<std::string> possibleSolvers;
    possibleSolvers.push_back(std::string("dp"));
    possibleSolvers.push_back(std::string("ad3"));
+   possibleSolvers.push_back(std::string("admm"));
    possibleSolvers.push_back(std::string("astar"));
    possibleSolvers.push_back(std::string("bp"));
    possibleSolvers.push_back(std::string("trbp"));
@@ -71,6 +72,8 @@ inline LOCCaller<IO, GM, ACC>::LOCCaller(IO& ioIn)
       "maxBlockSize","max size of a block which will be optimized",locParameter_.maxBlockSize_)); 
    addArgument(Size_TArgument<>(locParameter_.maxTreeSize_,"",
       "maxTreeSize","max size of a block which will be optimized",locParameter_.maxTreeSize_));
+   addArgument(Size_TArgument<>(locParameter_.numberOfThreads_,"",
+      "threads","number of threads optimizing separated regions concurrently (1 = sequential, 0 = one per core)",locParameter_.numberOfThreads_));
 
    //addArgument(VectorArgument<std::vector<typename L_O_C::LabelType> >(locParameter_.startPoint_, "x0", "startingpoint", "location of the file containing the values for the starting point", false));
 }
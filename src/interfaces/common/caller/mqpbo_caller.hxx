@@ -43,6 +43,7 @@ inline MQPBOCaller<IO, GM, ACC>::MQPBOCaller(IO& ioIn)
    addArgument(BoolArgument(mqpboParameter_.strongPersistency_, "", "strongPersistency", "enforce strong persistency"));
 
    addArgument(Size_TArgument<>(mqpboParameter_.rounds_, "", "rounds", "rounds of MQPBO"));
+   addArgument(Size_TArgument<>(mqpboParameter_.seed_, "", "seed", "seed of the RANDOM permutations", (size_t)0));
   
    std::vector<std::string> permittedPermutationTypes;
    permittedPermutationTypes.push_back("NONE");
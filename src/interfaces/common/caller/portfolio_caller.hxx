@@ -0,0 +1,169 @@
+#ifndef PORTFOLIO_CALLER_HXX_
+#define PORTFOLIO_CALLER_HXX_
+
+#include <sstream>
+
+#include <opengm/opengm.hxx>
+#include <opengm/inference/portfolio.hxx>
+#include <opengm/inference/icm.hxx>
+#include <opengm/inference/lazyflipper.hxx>
+#include <opengm/inference/trws/trws_trws.hxx>
+#include <opengm/inference/messagepassing/messagepassing.hxx>
+#include <opengm/inference/fusion_based_inf.hxx>
+
+#if (defined(WITH_MAXFLOW) || defined(WITH_BOOST))
+#  include <opengm/inference/graphcut.hxx>
+#  include <opengm/inference/alphaexpansion.hxx>
+#  ifdef WITH_MAXFLOW
+#     include <opengm/inference/auxiliary/minstcutkolmogorov.hxx>
+#  else
+#     include <opengm/inference/auxiliary/minstcutboost.hxx>
+#  endif
+#endif
+
+#include "inference_caller_base.hxx"
+#include "../argument/argument.hxx"
+
+namespace opengm {
+
+namespace interface {
+
+template <class IO, class GM, class ACC>
+class PortfolioCaller : public InferenceCallerBase<IO, GM, ACC, PortfolioCaller<IO, GM, ACC> > {
+public:
+   typedef InferenceCallerBase<IO, GM, ACC, PortfolioCaller<IO, GM, ACC> > BaseClass;
+   typedef Portfolio<GM, ACC> PortfolioType;
+   typedef typename PortfolioType::VerboseVisitorType VerboseVisitorType;
+   typedef typename PortfolioType::EmptyVisitorType EmptyVisitorType;
+   typedef typename PortfolioType::TimingVisitorType TimingVisitorType;
+   const static std::string name_;
+   PortfolioCaller(IO& ioIn);
+   virtual ~PortfolioCaller();
+protected:
+   using BaseClass::addArgument;
+   using BaseClass::io_;
+   typedef typename BaseClass::OutputBase OutputBase;
+   virtual void runImpl(GM& model, OutputBase& output, const bool verbose);
+   void addSolver(PortfolioType& portfolio, const std::string& solver) const;
+
+   std::string solvers_;
+   size_t numberOfThreads_;
+   size_t maxNumberOfIterations_;
+   bool coldStart_;
+};
+
+template <class IO, class GM, class ACC>
+inline PortfolioCaller<IO, GM, ACC>::PortfolioCaller(IO& ioIn)
+   : BaseClass(name_, "runs several inference algorithms concurrently on the same model. They share the best labeling and the best bound found so far and are stopped together by --timeout or --gaplimit. The improvement history (times, values, bounds and the index of the improving solver) is stored with the states.", ioIn) {
+   addArgument(StringArgument<>(solvers_, "", "solvers", "comma separated list of solvers run with their default parameters. Available: ICM, LAZYFLIPPER, TRWSI, BP, FUSION"
+#if (defined(WITH_MAXFLOW) || defined(WITH_BOOST))
+      ", ALPHAEXPANSION"
+#endif
+      , std::string("TRWSI,LAZYFLIPPER,FUSION")));
+   addArgument(Size_TArgument<>(numberOfThreads_, "", "threads", "number of threads (0 = one per core)", size_t(0)));
+   addArgument(Size_TArgument<>(maxNumberOfIterations_, "", "maxIt", "maximum number of iterations of TRWSI, BP and FUSION", size_t(1000)));
+   addArgument(BoolArgument(coldStart_, "", "coldStart", "do not start the solvers from the best labeling found so far"));
+}
+
+template <class IO, class GM, class ACC>
+inline PortfolioCaller<IO, GM, ACC>::~PortfolioCaller() {
+
+}
+
+template <class IO, class GM, class ACC>
+inline void PortfolioCaller<IO, GM, ACC>::addSolver(PortfolioType& portfolio, const std::string& solver) const {
+   if(solver == "ICM") {
+      portfolio.template addSolver<ICM<GM, ACC> >(typename ICM<GM, ACC>::Parameter(), solver);
+   } else if(solver == "LAZYFLIPPER") {
+      portfolio.template addSolver<LazyFlipper<GM, ACC> >(typename LazyFlipper<GM, ACC>::Parameter(), solver);
+   } else if(solver == "TRWSI") {
+      typedef TRWSi<GM, ACC> TRWSiType;
+      portfolio.template addSolver<TRWSiType>(typename TRWSiType::Parameter(maxNumberOfIterations_), solver);
+   } else if(solver == "BP") {
+      typedef MessagePassing<GM, ACC, BeliefPropagationUpdateRules<GM, ACC>, MaxDistance> BP;
+      portfolio.template addSolver<BP>(typename BP::Parameter(maxNumberOfIterations_), solver);
+   } else if(solver == "FUSION") {
+      typedef FusionBasedInf<GM, proposal_gen::AlphaExpansionGen<GM, ACC> > Fusion;
+      typename Fusion::Parameter parameter;
+      parameter.numIt_ = maxNumberOfIterations_;
+      parameter.fusionParam_.fusionSolver_ = Fusion::FusionMover::LazyFlipperFusion;
+      portfolio.template addSolver<Fusion>(parameter, solver);
+   }
+#if (defined(WITH_MAXFLOW) || defined(WITH_BOOST))
+   else if(solver == "ALPHAEXPANSION") {
+#  ifdef WITH_MAXFLOW
+      typedef external::MinSTCutKolmogorov<size_t, typename GM::ValueType> MinStCutType;
+#  else
+      typedef MinSTCutBoost<size_t, typename GM::ValueType, KOLMOGOROV> MinStCutType;
+#  endif
+      typedef AlphaExpansion<GM, GraphCut<GM, ACC, MinStCutType> > AlphaExpansionType;
+      portfolio.template addSolver<AlphaExpansionType>(typename AlphaExpansionType::Parameter(), solver);
+   }
+#endif
+   else {
+      throw RuntimeError("Unknown solver in portfolio: " + solver);
+   }
+}
+
+template <class IO, class GM, class ACC>
+inline void PortfolioCaller<IO, GM, ACC>::runImpl(GM& model, OutputBase& output, const bool verbose) {
+   std::cout << "running Portfolio caller" << std::endl;
+
+   PortfolioType portfolio(model, typename PortfolioType::Parameter(this->timeLimit_, this->gapLimit_, numberOfThreads_, !coldStart_));
+   std::stringstream list(solvers_);
+   std::string solver;
+   while(std::getline(list, solver, ',')) {
+      if(!solver.empty()) {
+         addSolver(portfolio, solver);
+      }
+   }
+   if(portfolio.numberOfSolvers() == 0) {
+      throw RuntimeError("Portfolio contains no solvers.");
+   }
+
+   const InferenceTermination termination = portfolio.infer();
+   if(termination == UNKNOWN) {
+      std::string error("None of the solvers of the portfolio returned a labeling.");
+      io_.errorStream() << error << std::endl;
+      throw RuntimeError(error);
+   }
+   if(termination == INFERENCE_ERROR) {
+      for(size_t j = 0; j < portfolio.numberOfSolvers(); ++j) {
+         if(!portfolio.solverError(j).empty()) {
+            io_.errorStream() << portfolio.solverName(j) << " failed: " << portfolio.solverError(j) << std::endl;
+         }
+      }
+   }
+
+   // improvement history
+   typename OutputBase::ProtocolMapType protocol;
+   std::vector<double>& times = protocol["times"];
+   std::vector<double>& values = protocol["values"];
+   std::vector<double>& bounds = protocol["bounds"];
+   std::vector<double>& solvers = protocol["solvers"];
+   for(size_t j = 0; j < portfolio.improvements().size(); ++j) {
+      const typename PortfolioType::Improvement& improvement = portfolio.improvements()[j];
+      times.push_back(improvement.time_);
+      values.push_back(static_cast<double>(improvement.value_));
+      bounds.push_back(static_cast<double>(improvement.bound_));
+      solvers.push_back(static_cast<double>(improvement.solver_));
+      if(verbose) {
+         std::cout << improvement.time_ << " sec: value " << improvement.value_ << " bound " << improvement.bound_
+            << " by " << portfolio.solverName(improvement.solver_) << std::endl;
+      }
+   }
+   output.storeProtocolMap(protocol);
+
+   std::vector<typename GM::LabelType> states;
+   portfolio.arg(states);
+   output.storeStates(states);
+}
+
+template <class IO, class GM, class ACC>
+const std::string PortfolioCaller<IO, GM, ACC>::name_ = "PORTFOLIO";
+
+} // namespace interface
+
+} // namespace opengm
+
+#endif /* PORTFOLIO_CALLER_HXX_ */
@@ -42,6 +42,8 @@ inline SwendsenWangCaller<IO, GM, ACC>::SwendsenWangCaller(IO& ioIn)
    addArgument(Size_TArgument<>(swParameter_.numberOfBurnInSteps_, "", "burninSteps", "number of burnin steps (should always be 0 for optimization)", (size_t)0));
    addArgument(VectorArgument<std::vector<typename GM::LabelType> >(swParameter_.initialState_, "", "startPoint", "location of the file containing a vector which specifies the initial labeling", false));
    addArgument(DoubleArgument<>(swParameter_.lowestAllowedProbability_,"","lowestProb","used to throw an exception if undercut", 1e-6)); 
+   addArgument(Size_TArgument<>(swParameter_.numberOfThreads_, "", "numThreads", "number of threads used for bond sampling (0 = all)", size_t(1)));
+   addArgument(Size_TArgument<>(swParameter_.seed_, "", "seed", "seed for bond sampling", size_t(0)));
 }
 
 template <class IO, class GM, class ACC>
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <fstream>
 #include <typeinfo>
+#include <mutex>
 
 #include <opengm/datastructures/marray/marray.hxx>
 #ifdef WITH_HDF5
@@ -32,6 +33,9 @@ protected:
    template <class CONTAINER, class VECTYPE>
    bool sanityCheck(CONTAINER& storage, VECTYPE object);
 
+   // serializes file access of concurrent jobs, the HDF5 library is not thread safe
+   static std::mutex& fileMutex();
+
    std::string getFileExtension(const std::string& filename);
    template <class VEC_TYPE>
    void loadVectorText(const std::string& filename, const std::string& dataset, VEC_TYPE& vec);
@@ -208,6 +212,7 @@ void IOBase::loadVector(const std::string& completeFilename, VEC_TYPE& vec) {
 
   separateFilename(completeFilename, separatedFilename, dataset);
   fileExtension = getFileExtension(separatedFilename);
+  std::lock_guard<std::mutex> lock(fileMutex());
   if(fileExtension == "txt") {
     loadVectorText(separatedFilename, dataset, vec);
   } else if(fileExtension == "h5") {
@@ -225,6 +230,7 @@ void IOBase::loadVector(const std::string& completeFilename, VEC_TYPE& vec) {
 
 template <class VEC_TYPE>
 void IOBase::storeVector(const std::string& completeFilename, VEC_TYPE& vec) {
+  std::lock_guard<std::mutex> lock(fileMutex());
   if(completeFilename == "PRINT ON SCREEN") {
     printVector(vec);
   } else {
@@ -258,6 +264,7 @@ void IOBase::loadMArray(const std::string& completeFilename, MARRAY& array) {
 
   separateFilename(completeFilename, separatedFilename, dataset);
   fileExtension = getFileExtension(separatedFilename);
+  std::lock_guard<std::mutex> lock(fileMutex());
   if(fileExtension == "txt") {
     loadMArrayText(separatedFilename, dataset, array);
   } else if(fileExtension == "h5") {
@@ -275,6 +282,7 @@ void IOBase::loadMArray(const std::string& completeFilename, MARRAY& array) {
 
 template <class MARRAY>
 void IOBase::storeMArray(const std::string& completeFilename, MARRAY& array) {
+  std::lock_guard<std::mutex> lock(fileMutex());
   if(completeFilename == "PRINT ON SCREEN") {
     printVector(array);
   } else {
@@ -362,6 +370,11 @@ void IOBase::separateFilename(const std::string& completeFilename, std::string&
   }
 }
 
+inline std::mutex& IOBase::fileMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
 std::string IOBase::getFileExtension(const std::string& filename) {
   size_t dotPosition = filename.rfind('.');
   if(dotPosition == std::string::npos) {
@@ -19,6 +19,18 @@ for c in opengm.shapeWalker(pf.shape):
     print c," ",pf[c]
 
 
+# vectorized: the function gets all labelings at once as an array of
+# shape (numberOfLabelings,dimension), tabulate: the values are computed
+# once and looked up afterwards (no calls back into python during inference)
+def myFuncVectorized(labelings):
+    return numpy.prod(labelings,axis=1)+numpy.sum(labelings,axis=1)
+
+pfv=opengm.PythonFunction(myFuncVectorized,[2,2],vectorized=True,tabulate=True)
+pfv.tabulate()
+for c in opengm.shapeWalker(pfv.shape):
+    print c," ",pfv[c]
+
+
 
 unaries=numpy.random.rand(5 , 5,2)
 potts=opengm.PottsFunction([2,2],0.0,0.1)
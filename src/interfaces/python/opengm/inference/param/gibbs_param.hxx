@@ -51,6 +51,9 @@ public:
          .def_readwrite("periodeLength", &Parameter::p_,
          "periode length"
          )
+         .def_readwrite("seed", &Parameter::seed_,
+         "Seed of the random numbers, equal seeds yield equal samples"
+         )
          .def("set", &SelfType::set, 
          (
             boost::python::arg("steps")=size_t(1e6),
@@ -52,7 +52,7 @@ public:
 
       .def_readwrite("solver", &Parameter::solver_,
       "solver used for the subproblems.\n"
-      "must be \"ad3\" , \"astar\""
+      "must be \"ad3\" , \"admm\" , \"astar\""
       )
 
       .def_readwrite("phi", &Parameter::phi_,
@@ -93,6 +93,9 @@ public:
       .def_readwrite("treeRuns", &Parameter::treeRuns_,
       "number of iterative tree runs ,\n"
       )
+      .def_readwrite("seed", &Parameter::seed_,
+      "seed of the random radii and tree growing order"
+      )
 
 
       
@@ -49,6 +49,7 @@ public:
          .def_readwrite("strongPersistency", &Parameter::strongPersistency_,  "use strong persitency")
          .def_readwrite("rounds",            &Parameter::rounds_,             "rounds of MQPBO")
          .def_readwrite("permutationType",   &Parameter::permutationType_,    "permutation used for label-ordering")
+         .def_readwrite("seed",              &Parameter::seed_,               "seed of the random permutations")
       ;
    }
 };
@@ -24,12 +24,16 @@ public:
         const SubInfParam & subInfParam,
         bool persistency,
         bool tentacle,
-        bool connectedComponents
+        bool connectedComponents,
+        const size_t numberOfThreads,
+        const double subTimeLimit
     ){
         p.subParameter_=subInfParam;
         p.Persistency_=persistency;
         p.Tentacle_=tentacle;
         p.ConnectedComponents_=connectedComponents;
+        p.numberOfThreads_=numberOfThreads;
+        p.subTimeLimit_=subTimeLimit;
     }
 
     void static exportInfParam(const std::string & className){
@@ -40,13 +44,17 @@ public:
                 boost::python::arg("subInfParam")=SubInfParam(),
                 boost::python::arg("persistency")=false,
                 boost::python::arg("tentacle")=false,
-                boost::python::arg("connectedComponents")=false
+                boost::python::arg("connectedComponents")=false,
+                boost::python::arg("numberOfThreads")=1,
+                boost::python::arg("subTimeLimit")=std::numeric_limits<double>::infinity()
             )
         ) 
         .def_readwrite( "subInfParam",&Parameter::subParameter_,"use reduction by removing tentacles")
         .def_readwrite( "persistency",&Parameter::Persistency_,"use reduction persistency")
         .def_readwrite( "tentacle", &Parameter::Tentacle_,"use reduction by removing tentacles")
         .def_readwrite( "connectedComponents",&Parameter::ConnectedComponents_,"use reduction by finding connect components")
+        .def_readwrite( "numberOfThreads",&Parameter::numberOfThreads_,"number of threads used to solve the connected components")
+        .def_readwrite( "subTimeLimit",&Parameter::subTimeLimit_,"time limit in seconds for a single connected component")
         ; 
     }
 };
@@ -67,6 +67,8 @@ public:
         .def_readwrite("tentacles",&Parameter::tentacles_,"if reduced inference is used,  eliminate tentacles (default=false)")
         .def_readwrite("fusionTimeLimit",&Parameter::fusionTimeLimit_, "time limit for each fusion move step")
         .def_readwrite("numStopIt",&Parameter::numStopIt_,"stop after n not successful iterations")
+        .def_readwrite("numberOfThreads",&Parameter::numberOfThreads_,"1 fuses on the thread of the base solver, otherwise fusion runs in a concurrent worker (0 = all threads)")
+        .def_readwrite("queueSize",&Parameter::queueSize_,"maximal number of labelings waiting for the concurrent fusion worker")
     .def ("set", &SelfType::set,
       (
         boost::python::arg("fuseNth")=1,
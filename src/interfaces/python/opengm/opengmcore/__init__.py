@@ -350,6 +350,7 @@ _PottsFunction                       = PottsFunction
 _PottsNFunction                      = PottsNFunction
 _PottsGFunction                      = PottsGFunction
 _PythonFunction                      = PythonFunction
+_NumpyViewFunction                   = NumpyViewFunction
 _FactorSubset                        = FactorSubset
 
 
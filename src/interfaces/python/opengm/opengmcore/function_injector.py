@@ -1,11 +1,11 @@
 from _opengmcore import ExplicitFunction,SparseFunction, \
                         TruncatedAbsoluteDifferenceFunction, \
                         TruncatedSquaredDifferenceFunction,PottsFunction,PottsNFunction, \
-                        PottsGFunction,PythonFunction,\
+                        PottsGFunction,PythonFunction,NumpyViewFunction,\
                         ExplicitFunctionVector,SparseFunctionVector, \
                         TruncatedAbsoluteDifferenceFunctionVector, \
                         TruncatedSquaredDifferenceFunctionVector,PottsFunctionVector,PottsNFunctionVector, \
-                        PottsGFunctionVector,PythonFunctionVector
+                        PottsGFunctionVector,PythonFunctionVector,NumpyViewFunctionVector
 import numpy
 
 
@@ -26,7 +26,7 @@ def _extend_function_vector_classes():
                                 TruncatedAbsoluteDifferenceFunctionVector,
                                 TruncatedSquaredDifferenceFunctionVector,PottsFunctionVector,
                                 PottsNFunctionVector,PottsGFunctionVector,
-                                PythonFunctionVector ]  
+                                PythonFunctionVector,NumpyViewFunctionVector ]  
 
     for function_vector in function_vector_classes:
         class InjectorGenericFunctionVector(object):
@@ -51,7 +51,7 @@ def _extend_function_type_classes():
                     TruncatedAbsoluteDifferenceFunction,
                     TruncatedSquaredDifferenceFunction,PottsFunction,
                     PottsNFunction,PottsGFunction,
-                    PythonFunction]
+                    PythonFunction,NumpyViewFunction]
 
 
 
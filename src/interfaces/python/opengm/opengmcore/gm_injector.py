@@ -345,6 +345,24 @@ def _extend_gm_classes():
           except:
             raise RuntimeError( "%s is not an supperted type for arument ``variableIndices`` in ``addFactors``" %(str(type(variableIndices)) ,)  ) 
      
+      def addUnaryFactors(self,unaries,variableIndices=None,finalize=True):
+        """ add a unary factor for each row of a 2d array without copying the values
+
+        Args:
+          unaries : numpy.ndarray with shape (numberOfVariables,numberOfLabels),
+            ``unaries[i,:]`` are the values of the unary factor of variable ``variableIndices[i]``.
+            The array is kept alive by the graphical model and must not be modified afterwards.
+          variableIndices : variable indices of the unary factors (default: 0,...,len(unaries)-1)
+          finalize : finalize the factors
+
+        Returns:
+          index of the last added factor
+        """
+        if variableIndices is None:
+          variableIndices=numpy.zeros(0,dtype=index_type)
+        unaries=numpy.require(unaries,dtype=value_type)
+        return self._addUnaryFactors_numpy_view(unaries,numpy.require(variableIndices,dtype=index_type),finalize)
+
       def fixVariables(self,variableIndices,labels):
         """ return a new graphical model where some variables are fixed to a given label.
 
@@ -462,8 +480,21 @@ def _extend_gm_classes():
           return self._addFunction(function)
 
 
-      def addFunctions(self,functions):
+      def addFunctions(self,functions,copy=True):
+        """ add multiple functions to the graphical model
+
+        Args:
+          functions : functions to add, for a numpy.ndarray each ``functions[i,...]`` becomes one function
+          copy : if ``functions`` is a numpy.ndarray and ``copy`` is False the functions view the
+            array instead of copying its values. The array is kept alive by the graphical model
+            and must not be modified afterwards.
+
+        Returns:
+          a vector of function identifiers
+        """
         if isinstance(functions,numpy.ndarray):
+          if not copy:
+            return self._addFunctions_numpy_view(numpy.require(functions,dtype=value_type))
           if functions.ndim==2:
             return self._addUnaryFunctions_numpy(numpy.require(functions,dtype=value_type))
           else:
@@ -12,6 +12,7 @@
 #include <opengm/python/converter.hxx>
 #include <opengm/python/numpyview.hxx>
 #include <opengm/python/pythonfunction.hxx>
+#include <opengm/python/numpyfunction.hxx>
 
 #include "copyhelper.hxx"
 
@@ -246,6 +247,27 @@ namespace pyfunction{
       return f.coordinateToKey(begin);
    }
 
+   template<class FUNCTION>
+   FUNCTION * numpyViewFunctionConstructor(boost::python::object array){
+      typedef typename FUNCTION::ValueType ValueType;
+      PyObject * arrayPtr=array.ptr();
+      if(!PyArray_Check(arrayPtr))
+         throw opengm::RuntimeError("array must be a numpy.ndarray");
+      if(PyArray_TYPE(arrayPtr)!=opengm::python::typeEnumFromType<ValueType>())
+         throw opengm::RuntimeError("array must have the value type of the graphical model as dtype");
+      const size_t dim=static_cast<size_t>(PyArray_NDIM(arrayPtr));
+      const npy_intp * shapePtr = PyArray_DIMS(arrayPtr);
+      const npy_intp * stridePtr = PyArray_STRIDES(arrayPtr);
+      std::vector<std::ptrdiff_t> strides(dim);
+      for(size_t d=0;d<dim;++d){
+         if(stridePtr[d]%static_cast<npy_intp>(sizeof(ValueType))!=0)
+            throw opengm::RuntimeError("array strides must be a multiple of the item size");
+         strides[d]=static_cast<std::ptrdiff_t>(stridePtr[d]/static_cast<npy_intp>(sizeof(ValueType)));
+      }
+      const ValueType * data=static_cast<const ValueType *>(PyArray_DATA(arrayPtr));
+      return new FUNCTION(array,data,shapePtr,shapePtr+dim,strides.begin());
+   }
+
 
 
 
@@ -335,6 +357,7 @@ void export_functiontypes(){
    typedef opengm::TruncatedSquaredDifferenceFunction    <ValueType,IndexType,LabelType> PyTruncatedSquaredDifferenceFunction;
    typedef opengm::SparseFunction                        <ValueType,IndexType,LabelType> PySparseFunction; 
    typedef opengm::python::PythonFunction                <ValueType,IndexType,LabelType> PyPythonFunction; 
+   typedef opengm::python::NumpyViewFunction             <ValueType,IndexType,LabelType> PyNumpyViewFunction; 
     
    // vector exporters
    export_function_type_vector<PyExplicitFunction>("ExplicitFunctionVector");
@@ -360,6 +383,7 @@ void export_functiontypes(){
    export_function_type_vector<PyTruncatedSquaredDifferenceFunction>("TruncatedSquaredDifferenceFunctionVector");
    export_function_type_vector<PySparseFunction>("SparseFunctionVector");
    export_function_type_vector<PyPythonFunction>("PythonFunctionVector");
+   export_function_type_vector<PyNumpyViewFunction>("NumpyViewFunctionVector");
 
    typedef typename PySparseFunction::ContainerType PySparseFunctionMapType;
    //export std::map for sparsefunction
@@ -583,8 +607,16 @@ void export_functiontypes(){
    ;
    
    FUNCTION_TYPE_EXPORTER_HELPER(PyPythonFunction,                       "PythonFunction")
-   .def(init<boost::python::object,boost::python::object,const bool>(
-         (arg("function"),arg("shape"),arg("ensureGilState")=true),
+   .def(init<boost::python::object,boost::python::object,const bool,const bool,const bool>(
+         (arg("function"),arg("shape"),arg("ensureGilState")=true,arg("vectorized")=false,arg("tabulate")=false),
+         "Args:\n\n"
+         "  function: python callable which computes the value of a labeling\n\n"
+         "  shape: shape of the function\n\n"
+         "  ensureGilState: acquire the GIL before calling ``function`` (default: True)\n\n"
+         "  vectorized: ``function`` is called with a numpy.ndarray of shape (numberOfLabelings,dimension)\n"
+         "     and returns the values of all these labelings (default: False)\n\n"
+         "  tabulate: evaluate all values at once and store them in a table, at the latest\n"
+         "     in ``gm.finalize()`` or when the function is first evaluated (default: False)\n\n"
          "Examples: ::\n\n"
          "   >>> import opengm\n"
          "   >>> import numpy\n" 
@@ -594,9 +626,32 @@ void export_functiontypes(){
          "   ...       s+=l\n"
          "   ...    return s\n"
          "   >>> f=opengm.PythonFunction(function=labelSumFunction,shape=[2,2])\n"
+         "   >>> def labelSumFunctionVectorized(labelings):\n"
+         "   ...    return labelings.sum(axis=1)\n"
+         "   >>> f=opengm.PythonFunction(function=labelSumFunctionVectorized,shape=[2,2],vectorized=True,tabulate=True)\n"
          "\n\n"
       )
    )
+   .add_property("vectorized",&PyPythonFunction::vectorized,"the python callable is called with batches of labelings")
+   .add_property("tabulated",&PyPythonFunction::isTabulated,"the values of the function have been tabulated")
+   .def("tabulate",&PyPythonFunction::tabulate,"evaluate all values of the function at once and store them in a table")
+   ;
+
+   FUNCTION_TYPE_EXPORTER_HELPER(PyNumpyViewFunction,                    "NumpyViewFunction")
+   .def("__init__", make_constructor(&pyfunction::numpyViewFunctionConstructor<PyNumpyViewFunction> ,default_call_policies(),
+         (
+            boost::python::arg("array")
+         )
+      ),
+   "Construct a NumpyViewFunction which views the values of a numpy.ndarray without copying them.\n\n"
+   "The function keeps a reference to the array, the array must not be modified afterwards.\n\n"
+   "Args:\n\n"
+   "  array: numpy.ndarray with the value type of the graphical model as dtype\n\n"
+   "Example: ::\n\n"
+   "   >>> values=numpy.random.rand(3,3)\n"
+   "   >>> f=opengm.NumpyViewFunction(values)\n"
+   "\n\n"
+   )
    ;
 
 }
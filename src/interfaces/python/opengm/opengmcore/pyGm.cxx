@@ -545,6 +545,120 @@ namespace pygm {
       }
       
 
+      // a view function for each sub-array array[f,...], the functions keep a reference
+      // to the array (instead of copying the values into explicit functions)
+      template<class GM>
+      void numpyViewFunctions(boost::python::object array,std::vector<opengm::python::NumpyViewFunction<typename GM::ValueType,typename GM::IndexType,typename GM::LabelType> > & functions) {
+         typedef typename GM::ValueType ValueType;
+         typedef typename GM::LabelType LabelType;
+         typedef opengm::python::NumpyViewFunction<ValueType,typename GM::IndexType,LabelType> ViewFunction;
+         PyObject * arrayPtr=array.ptr();
+         if(!PyArray_Check(arrayPtr))
+            throw opengm::RuntimeError("array must be a numpy.ndarray");
+         if(PyArray_TYPE(arrayPtr)!=opengm::python::typeEnumFromType<ValueType>())
+            throw opengm::RuntimeError("array must have the value type of the graphical model as dtype");
+         const size_t dim=static_cast<size_t>(PyArray_NDIM(arrayPtr));
+         if(dim<2)
+            throw opengm::RuntimeError("functions dimension must be at least 2");
+         const npy_intp * shapePtr = PyArray_DIMS(arrayPtr);
+         const npy_intp * stridePtr = PyArray_STRIDES(arrayPtr);
+         std::vector<LabelType> shape(shapePtr+1,shapePtr+dim);
+         std::vector<std::ptrdiff_t> strides(dim);
+         for(size_t d=0;d<dim;++d){
+            if(stridePtr[d]%static_cast<npy_intp>(sizeof(ValueType))!=0)
+               throw opengm::RuntimeError("array strides must be a multiple of the item size");
+            strides[d]=static_cast<std::ptrdiff_t>(stridePtr[d]/static_cast<npy_intp>(sizeof(ValueType)));
+         }
+         const ValueType * data=static_cast<const ValueType *>(PyArray_DATA(arrayPtr));
+         const size_t numF=static_cast<size_t>(shapePtr[0]);
+         functions.clear();
+         functions.reserve(numF);
+         if(numF==0)
+            return;
+         // only the first function takes a reference to the array, the others share it
+         functions.push_back(ViewFunction(array,data,shape.begin(),shape.end(),strides.begin()+1));
+         for(size_t f=1;f<numF;++f){
+            functions.push_back(ViewFunction(functions.front(),data+static_cast<std::ptrdiff_t>(f)*strides[0],shape.begin(),shape.end(),strides.begin()+1));
+         }
+      }
+
+      template<class GM>
+      std::vector<typename GM::FunctionIdentifier> * addFunctionsNpViewPy( GM & gm,boost::python::object array) {
+         typedef opengm::python::NumpyViewFunction<typename GM::ValueType,typename GM::IndexType,typename GM::LabelType> ViewFunction;
+         std::vector<ViewFunction> functions;
+         numpyViewFunctions<GM>(array,functions);
+         std::vector<typename GM::FunctionIdentifier> * fidVec=new std::vector<typename GM::FunctionIdentifier>(functions.size());
+         {
+            releaseGIL rgil;
+            gm. template reserveFunctions<ViewFunction>(gm.numberOfFunctions(opengm::meta::GetIndexInTypeList<typename GM::FunctionTypeList,ViewFunction>::value)+functions.size());
+            for(size_t f=0;f<functions.size();++f){
+               (*fidVec)[f]=gm.addFunction(functions[f]);
+            }
+         }
+         return fidVec;
+      }
+
+      // bulk assignment of unary factors from a (numVar,numLabels) array,
+      // the f-th row becomes the unary function of the variable vis[f] (or f if vis is empty)
+      template<class GM>
+      typename GM::IndexType addUnaryFactorsNpViewPy(GM & gm,boost::python::object array,opengm::python::NumpyView<typename GM::IndexType,1> vis,const bool finalize) {
+         typedef typename GM::IndexType IndexType;
+         typedef opengm::python::NumpyViewFunction<typename GM::ValueType,IndexType,typename GM::LabelType> ViewFunction;
+         if(PyArray_Check(array.ptr()) && PyArray_NDIM(array.ptr())!=2)
+            throw opengm::RuntimeError("unaries must be a 2d array with shape (numberOfVariables,numberOfLabels)");
+         std::vector<ViewFunction> functions;
+         numpyViewFunctions<GM>(array,functions);
+         const size_t numVis=vis.size();
+         if(numVis!=0 && numVis!=functions.size())
+            throw opengm::RuntimeError("len(vis) must be 0 or unaries.shape[0]");
+         // validate everything before the first function is added, such that
+         // an error does not leave the gm half-modified
+         for(size_t f=0;f<functions.size();++f){
+            const IndexType vi = numVis==0 ? static_cast<IndexType>(f) : vis(f);
+            if(vi>=gm.numberOfVariables())
+               throw opengm::RuntimeError("variable index out of range");
+            if(gm.numberOfLabels(vi)!=functions[f].shape(0))
+               throw opengm::RuntimeError("number of labels of the unaries do not match the number of labels of the variable");
+         }
+         IndexType retFactorIndex=0;
+         {
+            releaseGIL rgil;
+            for(size_t f=0;f<functions.size();++f){
+               const IndexType vi = numVis==0 ? static_cast<IndexType>(f) : vis(f);
+               const typename GM::FunctionIdentifier fid=gm.addFunction(functions[f]);
+               if(finalize)
+                  retFactorIndex=gm.addFactor(fid,&vi,&vi+1);
+               else
+                  retFactorIndex=gm.addFactorNonFinalized(fid,&vi,&vi+1);
+            }
+         }
+         return retFactorIndex;
+      }
+
+      // finalize the gm and tabulate all python functions which requested it,
+      // such that inference never calls back into python for these functions
+      template<class GM>
+      void finalizePy(GM & gm) {
+         typedef opengm::python::PythonFunction<typename GM::ValueType,typename GM::IndexType,typename GM::LabelType> PyPythonFunction;
+         typedef typename GM::FunctionIdentifier FidType;
+         typedef typename FidType::FunctionIndexType FunctionIndexType;
+         typedef typename FidType::FunctionTypeIndexType FunctionTypeIndexType;
+         const FunctionTypeIndexType typeIndex=static_cast<FunctionTypeIndexType>(
+            opengm::meta::GetIndexInTypeList<typename GM::FunctionTypeList,PyPythonFunction>::value
+         );
+         {
+            releaseGIL rgil;
+            gm.finalize();
+         }
+         const size_t numF=gm.numberOfFunctions(typeIndex);
+         for(size_t f=0;f<numF;++f){
+            const PyPythonFunction & function=gm. template getFunction<PyPythonFunction>(FidType(static_cast<FunctionIndexType>(f),typeIndex));
+            if(function.tabulateEnabled()){
+               function.tabulate();
+            }
+         }
+      }
+
       template<class GM>
       const typename GM::FactorType  & getFactorStaticPy(const GM & gm, const int factorIndex) {
          return gm.operator[](factorIndex);
@@ -683,6 +797,7 @@ namespace pygm {
          typedef opengm::TruncatedSquaredDifferenceFunction    <ValueType,IndexType,LabelType> PyTruncatedSquaredDifferenceFunction;
          typedef opengm::SparseFunction                        <ValueType,IndexType,LabelType> PySparseFunction; 
          typedef opengm::python::PythonFunction                <ValueType,IndexType,LabelType> PyPythonFunction; 
+         typedef opengm::python::NumpyViewFunction             <ValueType,IndexType,LabelType> PyNumpyViewFunction; 
 
          if(fname==std::string("explicit")){
             return gm. template  reserveFunctions<PyExplicitFunction>(size);
@@ -708,6 +823,9 @@ namespace pygm {
          else if(fname==std::string("python")){
             return gm. template  reserveFunctions<PyPythonFunction>(size);
          }
+         else if(fname==std::string("numpy-view")){
+            return gm. template  reserveFunctions<PyNumpyViewFunction>(size);
+         }
          else{
             throw opengm::RuntimeError(fname + std::string(" is an unknown function type name"));
          }
@@ -1458,6 +1576,7 @@ void export_gm() {
    typedef opengm::TruncatedSquaredDifferenceFunction    <ValueType,IndexType,LabelType> PyTruncatedSquaredDifferenceFunction;
    typedef opengm::SparseFunction                        <ValueType,IndexType,LabelType> PySparseFunction; 
    typedef opengm::python::PythonFunction                <ValueType,IndexType,LabelType> PyPythonFunction; 
+   typedef opengm::python::NumpyViewFunction             <ValueType,IndexType,LabelType> PyNumpyViewFunction; 
 
 
 
@@ -1827,6 +1946,7 @@ void export_gm() {
    .def("_addFunctions_list", &pygm::addFunctionsListNpPy<PyGm>,return_value_policy<manage_new_object>(),args("functions"))
    .def("_addFunctions_numpy", &pygm::addFunctionsNpPy<PyGm>,return_value_policy<manage_new_object>(),args("functions"))
    .def("_addUnaryFunctions_numpy", &pygm::addUnaryFunctionsNpPy<PyGm>,return_value_policy<manage_new_object>(),args("functions"))
+   .def("_addFunctions_numpy_view", &pygm::addFunctionsNpViewPy<PyGm>,return_value_policy<manage_new_object>(),args("functions"))
    .def("_addFunctions_generator", &pygm::addFunctionsFromGenerator<PyGm>,return_value_policy<manage_new_object>(),args("functions"))
     // WARNING,THIS IS UNTESTED....TEST ME!!!!!!
    .def("_addFunctions_vector",&pygm::addFunctionsGenericVectorPy<PyGm,PyPottsFunction>,return_value_policy<manage_new_object>(),args("functions"))
@@ -1850,16 +1970,19 @@ void export_gm() {
    .def("_addFunction",&pygm::addFunctionGenericPy<PyGm,PyTruncatedSquaredDifferenceFunction>,args("function"))
    .def("_addFunction",&pygm::addFunctionGenericPy<PyGm,PySparseFunction>,args("function"))
    .def("_addFunction",&pygm::addFunctionGenericPy<PyGm,PyPythonFunction>,args("function"))
+   .def("_addFunction",&pygm::addFunctionGenericPy<PyGm,PyNumpyViewFunction>,args("function"))
 	.def("_addFunction", &pygm::addFunctionNpPy<PyGm>,args("function"))
    .def("_addFactor", &pygm::addFactor_Any<PyGm,int>, (arg("fid"),arg("variableIndices"),arg("finalize")))
 	.def("_addFactor", &pygm::addFactor_Numpy<PyGm>, (arg("fid"),arg("variableIndices"),arg("finalize")))
    .def("_addFactor", &pygm::addFactor_Vector<PyGm>, (arg("fid"),arg("variableIndices"),arg("finalize")))
    .def("_addUnaryFactors_vector_numpy", &pygm::addUnaryFactors_Vector_Numpy<PyGm>, (arg("fid"),arg("variableIndices"),arg("finalize")))
+   .def("_addUnaryFactors_numpy_view", &pygm::addUnaryFactorsNpViewPy<PyGm>, (arg("unaries"),arg("variableIndices"),arg("finalize")))
    .def("_addFactors_vector_numpy", &pygm::addFactors_Vector_Numpy<PyGm>, (arg("fid"),arg("variableIndices"),arg("finalize")))
    .def("_addFactors_vector_vectorvector", &pygm::addFactors_Vector_VectorVector<PyGm>, (arg("fid"),arg("variableIndices"),arg("finalize")))
-   .def("finalize",&PyGm::finalize,
+   .def("finalize",&pygm::finalizePy<PyGm>,
       "finalize the graphical model after adding all factors \n\n"
-      "this method must be called if any non finalized factor has been added (addFactor / addFactors with finalize=False)"
+      "this method must be called if any non finalized factor has been added (addFactor / addFactors with finalize=False)\n\n"
+      "python functions constructed with ``tabulate=True`` are tabulated here"
    )
 	.def("__getitem__", &pygm::getFactorStaticPy<PyGm>, return_internal_reference<>(),(arg("factorIndex")),
 	"Get a factor of the graphical model\n\n"
@@ -221,6 +221,97 @@ class TestFunctions:
             assert f[[1, 1]] == 0
             assert f[[0, 1]] == vnew[i]
 
+    def test_python_function_vectorized(self):
+        shape = [2, 3, 4]
+
+        def labelingFunction(labels):
+            return float(labels[0] + 10 * labels[1] + 100 * labels[2])
+
+        def vectorizedFunction(labelings):
+            assert labelings.ndim == 2
+            assert labelings.shape[1] == len(shape)
+            return labelings[:, 0] + 10 * labelings[:, 1] + 100 * labelings[:, 2]
+
+        f = opengm.PythonFunction(labelingFunction, shape)
+        fv = opengm.PythonFunction(vectorizedFunction, shape, vectorized=True)
+        assert not f.vectorized
+        assert fv.vectorized
+        assert not fv.tabulated
+        for c in opengm.shapeWalker(shape):
+            assert fv[c] == f[c]
+            assert fv[c] == labelingFunction(c)
+
+    def test_python_function_vectorized_wrong_length(self):
+        shape = [2, 3]
+
+        def wrongLength(labelings):
+            return numpy.zeros(len(labelings) + 1)
+
+        for tabulate in [False, True]:
+            f = opengm.PythonFunction(wrongLength, shape, vectorized=True,
+                                      tabulate=tabulate)
+            try:
+                f[0, 0]
+            except RuntimeError:
+                pass
+            else:
+                raise AssertionError("wrong number of values was accepted")
+            assert not f.tabulated
+
+        f = opengm.PythonFunction(lambda labelings: [1.0], shape,
+                                  vectorized=True)
+        try:
+            f.tabulate()
+        except RuntimeError:
+            pass
+        else:
+            raise AssertionError("wrong number of values was accepted")
+
+    def test_python_function_tabulate(self):
+        shape = [2, 3, 4]
+        calls = [0]
+
+        def vectorizedFunction(labelings):
+            calls[0] += 1
+            return labelings[:, 0] + 10 * labelings[:, 1] + 100 * labelings[:, 2]
+
+        def expected(c):
+            return float(c[0] + 10 * c[1] + 100 * c[2])
+
+        # explicit tabulate(), a single call for all labelings
+        f = opengm.PythonFunction(vectorizedFunction, shape, vectorized=True,
+                                  tabulate=True)
+        f.tabulate()
+        assert f.tabulated
+        assert calls[0] == 1
+        for c in opengm.shapeWalker(shape):
+            assert f[c] == expected(c)
+        assert calls[0] == 1
+
+        # tabulated by gm.finalize(), the copy in the gm shares the table
+        calls[0] = 0
+        gm = opengm.gm(shape)
+        f = opengm.PythonFunction(vectorizedFunction, shape, vectorized=True,
+                                  tabulate=True)
+        fid = gm.addFunction(f)
+        gm.addFactor(fid, [0, 1, 2])
+        gm.addFactor(gm.addFunction(f), [0, 1, 2])
+        assert not f.tabulated
+        assert calls[0] == 0
+        gm.finalize()
+        assert f.tabulated
+        assert calls[0] == 1
+        for c in opengm.shapeWalker(shape):
+            assert gm[0][c] == expected(c)
+            assert gm[1][c] == expected(c)
+            assert f[c] == expected(c)
+        assert calls[0] == 1
+
+        solver = opengm.inference.Bruteforce(gm=gm)
+        solver.infer()
+        assert solver.value() == 0.0
+        assert calls[0] == 1
+
 
 class TestGm:
 
@@ -344,6 +435,120 @@ class TestGm:
                 # assertions
             assert len(fids) == nFunctions
 
+    def test_numpy_view_function_strided(self):
+        values = numpy.random.rand(6, 8)
+        for view in [values, values[::2, 1::3], values[1:5, 2:7], values.T,
+                     values[::-1, ::2]]:
+            f = opengm.NumpyViewFunction(view)
+            assert tuple(f.shape) == view.shape
+            for c in opengm.shapeWalker(f.shape):
+                assert f[c] == view[tuple(c)]
+
+    def test_add_multiple_functions_no_copy(self):
+        nLabels = 3
+        gm = opengm.gm([nLabels] * 4)
+        f = numpy.random.rand(8, nLabels, 2 * nLabels)[::2, :, ::2]
+        fids = gm.addFunctions(f, copy=False)
+        assert len(fids) == 4
+        gm.addFactors(fids, numpy.array([[0, 1], [1, 2], [2, 3], [0, 3]]))
+        for x in xrange(4):
+            for c in opengm.shapeWalker(gm[x].shape):
+                assert gm[x][c] == f[x][tuple(c)]
+
+    def test_add_multiple_functions_no_copy_keeps_array_alive(self):
+        import gc
+        import weakref
+        gm = opengm.gm([2] * 3)
+        f = numpy.random.rand(3, 2)
+        expected = f.copy()
+        arrayRef = weakref.ref(f)
+        fids = gm.addFunctions(f, copy=False)
+        gm.addFactors(fids, numpy.arange(3))
+        del f
+        gc.collect()
+        assert arrayRef() is not None
+        for x in xrange(3):
+            assert gm[x][(0,)] == expected[x, 0]
+            assert gm[x][(1,)] == expected[x, 1]
+        del fids
+        del gm
+        gc.collect()
+        assert arrayRef() is None
+
+    def test_add_unary_factors(self):
+        nVar = 5
+        nLabels = 3
+        gm = opengm.gm([nLabels] * nVar)
+        unaries = numpy.random.rand(nVar, nLabels)
+        gm.addUnaryFactors(unaries)
+        assert gm.numberOfFactors == nVar
+        for x in xrange(nVar):
+            assert gm[x].variableIndices[0] == x
+            for l in xrange(nLabels):
+                assert gm[x][(l,)] == unaries[x, l]
+
+        gm = opengm.gm([nLabels] * nVar)
+        gm.addUnaryFactors(unaries[:2], variableIndices=[4, 1])
+        assert gm[0].variableIndices[0] == 4
+        assert gm[1].variableIndices[0] == 1
+        assert gm[0][(2,)] == unaries[0, 2]
+        assert gm[1][(2,)] == unaries[1, 2]
+
+    def test_add_unary_factors_invalid(self):
+        gm = opengm.gm([2, 2, 3])
+        # an invalid row must not leave factors from the valid rows behind
+        for unaries, vis in [(numpy.random.rand(3, 2), None),
+                             (numpy.random.rand(2, 2), [1, 3]),
+                             (numpy.random.rand(2, 2), [0, 1, 2])]:
+            try:
+                gm.addUnaryFactors(unaries, variableIndices=vis)
+            except RuntimeError:
+                pass
+            else:
+                raise AssertionError("invalid unaries were accepted")
+            assert gm.numberOfFactors == 0
+        # no view function has been added by the failed calls
+        fids = gm.addFunctions(numpy.random.rand(1, 2), copy=False)
+        assert fids[0].functionIndex == 0
+
+    def test_add_unary_factors_inference(self):
+        nVar = 6
+        nLabels = 3
+        gm = opengm.gm([nLabels] * nVar)
+        unaries = numpy.random.rand(nVar, nLabels)
+        gm.addUnaryFactors(unaries)
+        fid = gm.addFunction(opengm.PottsFunction([nLabels, nLabels], 0.0, 0.1))
+        gm.addFactors(fid, [[x, x + 1] for x in xrange(nVar - 1)])
+
+        solver = opengm.inference.Bruteforce(gm=gm)
+        solver.infer()
+        arg = solver.arg()
+        assert abs(gm.evaluate(arg) - solver.value()) < 1e-9
+        for c in opengm.shapeWalker([nLabels] * nVar):
+            assert solver.value() <= gm.evaluate(c) + 1e-9
+
+    def test_numpy_view_function_hdf5(self):
+        if opengm.configuration.withHdf5:
+            import tempfile
+            gm = opengm.gm([3] * 4)
+            gm.addUnaryFactors(numpy.random.rand(4, 3))
+            pairwise = numpy.random.rand(6, 3, 3)[::2]
+            fids = gm.addFunctions(pairwise, copy=False)
+            gm.addFactors(fids, numpy.array([[0, 1], [1, 2], [2, 3]]))
+            handle, path = tempfile.mkstemp(suffix='.h5')
+            os.close(handle)
+            try:
+                opengm.saveGm(gm, path)
+                loaded = opengm.loadGm(path)
+            finally:
+                os.remove(path)
+            assert loaded.numberOfVariables == gm.numberOfVariables
+            assert loaded.numberOfFactors == gm.numberOfFactors
+            for fi in xrange(gm.numberOfFactors):
+                assert tuple(loaded[fi].variableIndices) == tuple(gm[fi].variableIndices)
+                for c in opengm.shapeWalker(gm[fi].shape):
+                    assert loaded[fi][c] == gm[fi][c]
+
     def test_add_multiple_functions_order1(self):
         nVar = 4
         nLabels = 2
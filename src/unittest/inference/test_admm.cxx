@@ -0,0 +1,100 @@
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/unittests/test.hxx>
+#include <opengm/inference/admm.hxx>
+#include <opengm/inference/bruteforce.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/operations/maximizer.hxx>
+#include <opengm/functions/explicit_function.hxx>
+
+#include <opengm/unittests/blackboxtester.hxx>
+#include <opengm/unittests/blackboxtests/blackboxtestgrid.hxx>
+#include <opengm/unittests/blackboxtests/blackboxtestfull.hxx>
+#include <opengm/unittests/blackboxtests/blackboxteststar.hxx>
+
+typedef opengm::GraphicalModel<double, opengm::Adder> SumGmType;
+
+template<class ADMM>
+void testOpt(const typename ADMM::Parameter& para) {
+   typedef opengm::BlackBoxTestGrid<SumGmType> SumGridTest;
+   typedef opengm::BlackBoxTestStar<SumGmType> SumStarTest;
+
+   // the local polytope relaxation is tight on trees
+   opengm::InferenceBlackBoxTester<SumGmType> sumTesterOpt;
+   sumTesterOpt.addTest(new SumStarTest(6, 4, false, true, SumStarTest::RANDOM, opengm::OPTIMAL, 10));
+   sumTesterOpt.addTest(new SumStarTest(8, 2, false, true, SumStarTest::RANDOM, opengm::OPTIMAL, 10));
+   sumTesterOpt.addTest(new SumGridTest(1, 8, 3, false, true, SumGridTest::POTTS, opengm::OPTIMAL, 10));
+   sumTesterOpt.template test<ADMM>(para);
+}
+
+template<class ADMM>
+void test(const typename ADMM::Parameter& para) {
+   typedef opengm::BlackBoxTestGrid<SumGmType> SumGridTest;
+   typedef opengm::BlackBoxTestFull<SumGmType> SumFullTest;
+
+   opengm::InferenceBlackBoxTester<SumGmType> sumTester;
+   sumTester.addTest(new SumGridTest(4, 4, 2, false, true, SumGridTest::RANDOM, opengm::PASS, 10));
+   sumTester.addTest(new SumGridTest(5, 5, 3, false, true, SumGridTest::POTTS, opengm::PASS, 10));
+   sumTester.addTest(new SumFullTest(5, 3, false, 3, SumFullTest::RANDOM, opengm::PASS, 5));
+   sumTester.template test<ADMM>(para);
+}
+
+// chain of third order factors, the relaxation is tight on this hypertree
+void testHigherOrder() {
+   typedef opengm::ExplicitFunction<double> ExplicitFunction;
+   typedef opengm::ADMM<SumGmType, opengm::Minimizer> ADMM;
+   for(size_t n = 0; n < 5; ++n) {
+      const size_t numbersOfLabels[] = {2, 3, 2, 3, 2, 3, 2};
+      SumGmType gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels, numbersOfLabels + 7));
+      for(size_t v = 0; v < 7; ++v) {
+         ExplicitFunction f(numbersOfLabels + v, numbersOfLabels + v + 1);
+         for(size_t i = 0; i < f.size(); ++i) {
+            f(i) = static_cast<double>(rand() % 100) / 10.0;
+         }
+         gm.addFactor(gm.addFunction(f), &v, &v + 1);
+      }
+      for(size_t v = 0; v + 2 < 7; v += 2) {
+         const size_t vis[] = {v, v + 1, v + 2};
+         const size_t shape[] = {numbersOfLabels[v], numbersOfLabels[v + 1], numbersOfLabels[v + 2]};
+         ExplicitFunction f(shape, shape + 3);
+         for(size_t i = 0; i < f.size(); ++i) {
+            f(i) = static_cast<double>(rand() % 100) / 10.0;
+         }
+         gm.addFactor(gm.addFunction(f), vis, vis + 3);
+      }
+      ADMM admm(gm, ADMM::Parameter(2000));
+      admm.infer();
+      opengm::Bruteforce<SumGmType, opengm::Minimizer> bf(gm);
+      bf.infer();
+      OPENGM_TEST_EQUAL_TOLERANCE(admm.value(), bf.value(), 1e-6);
+      OPENGM_TEST(admm.bound() <= bf.value() + 1e-6);
+      OPENGM_TEST_EQUAL_TOLERANCE(admm.bound(), bf.value(), 1e-3);
+   }
+}
+
+int main() {
+   std::cout << "ADMM Tests ..." << std::endl;
+   {
+      typedef opengm::ADMM<SumGmType, opengm::Minimizer> ADMM;
+      ADMM::Parameter para;
+      std::cout << "    - Minimization/Adder ...\n" << std::flush;
+      testOpt<ADMM>(para);
+      test<ADMM>(para);
+      para.numberOfThreads_ = 4;
+      std::cout << "    - Minimization/Adder with 4 threads ...\n" << std::flush;
+      test<ADMM>(para);
+   }
+   {
+      typedef opengm::ADMM<SumGmType, opengm::Maximizer> ADMM;
+      ADMM::Parameter para;
+      std::cout << "    - Maximization/Adder ...\n" << std::flush;
+      testOpt<ADMM>(para);
+      test<ADMM>(para);
+   }
+   testHigherOrder();
+   return 0;
+}
@@ -105,6 +105,15 @@ int main() {
       MinAlphaBetaSwap::Parameter para;
       minTester.test<MinAlphaBetaSwap>(para);
    }
+   std::cout << "  * Test Min-Sum with BOOST-Kolmogorov on grids (MinSTCutGrid disabled)" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      typedef opengm::AlphaBetaSwap<GraphicalModelType, MinGraphCut> MinAlphaBetaSwap;
+      MinAlphaBetaSwap::Parameter para;
+      para.parameter_.useGrid_ = false;
+      minTester.test<MinAlphaBetaSwap>(para);
+   }
 #endif
 #ifdef WITH_MAXFLOW
 //   std::cout << "  * Test Max-Sum with Kolmogorov" << std::endl;
@@ -132,6 +132,62 @@ int main() {
          minTester.test<MinAlphaExpansion>(para);
       }
    }
+   std::cout << "  * Test Min-Sum with BOOST-Kolmogorov on grids (MinSTCutGrid disabled)" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      typedef opengm::AlphaExpansion<GraphicalModelType, MinGraphCut> MinAlphaExpansion;
+      MinAlphaExpansion::Parameter para;
+      para.parameter_.useGrid_ = false;
+      minTester.test<MinAlphaExpansion>(para);
+   }
+   std::cout << "  * Test Min-Sum with MinSTCutGrid on a non-metric grid" << std::endl;
+   {
+      // squared differences are not a metric, moves with irregular terms
+      // must fall back to auxiliary nodes instead of negative capacities
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      typedef opengm::AlphaExpansion<GraphicalModelType, MinGraphCut> MinAlphaExpansion;
+      const size_t width = 5, height = 4, numberOfLabels = 4;
+      const std::vector<size_t> numbersOfLabels(width * height, numberOfLabels);
+      GraphicalModelType gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels.begin(), numbersOfLabels.end()));
+      const size_t shape[] = {numberOfLabels, numberOfLabels};
+      // checkerboard of labels 0 and 3, later expansions on 1 and 2 have irregular terms
+      for(size_t v = 0; v < width * height; ++v) {
+         opengm::ExplicitFunction<float> f(shape, shape + 1, 30.0f);
+         f(((v % width) + (v / width)) % 2 == 0 ? 0 : numberOfLabels - 1) = 0.0f;
+         gm.addFactor(gm.addFunction(f), &v, &v + 1);
+      }
+      opengm::ExplicitFunction<float> squared(shape, shape + 2);
+      for(size_t l0 = 0; l0 < numberOfLabels; ++l0) {
+         for(size_t l1 = 0; l1 < numberOfLabels; ++l1) {
+            const float difference = static_cast<float>(l0) - static_cast<float>(l1);
+            squared(l0, l1) = 0.5f * difference * difference;
+         }
+      }
+      const GraphicalModelType::FunctionIdentifier squaredId = gm.addFunction(squared);
+      for(size_t y = 0; y < height; ++y) {
+         for(size_t x = 0; x < width; ++x) {
+            const size_t v = x + width * y;
+            if(x + 1 < width) {
+               const size_t vars[] = {v, v + 1};
+               gm.addFactor(squaredId, vars, vars + 2);
+            }
+            if(y + 1 < height) {
+               const size_t vars[] = {v, v + width};
+               gm.addFactor(squaredId, vars, vars + 2);
+            }
+         }
+      }
+      MinAlphaExpansion::Parameter para;
+      MinAlphaExpansion grid(gm, para);
+      OPENGM_TEST(grid.infer() == opengm::NORMAL);
+      std::vector<size_t> arg;
+      grid.arg(arg);
+      const std::vector<size_t> start(gm.numberOfVariables(), 0);
+      OPENGM_TEST_EQUAL_TOLERANCE(grid.value(), gm.evaluate(arg.begin()), 0.0001);
+      OPENGM_TEST(grid.value() <= gm.evaluate(start.begin()));
+   }
 #endif
 
 #ifdef WITH_MAXFLOW
@@ -152,6 +152,83 @@ void test_ab_swap_generator()
 }   
 
 
+// proposals of the random generators depend only on the seed
+template<class GEN, class GM>
+void test_seeded_generator(const GM& gm, const typename GEN::Parameter& param, const typename GEN::Parameter& otherParam)
+{
+    // start away from label 0, where moving up and down give the same proposal
+    std::vector<size_t> current(gm.numberOfVariables(),2);
+    std::vector<std::vector<size_t> > proposals(3, std::vector<size_t>(gm.numberOfVariables(),0));
+    bool different = false;
+    GEN gen(gm, param);
+    GEN sameGen(gm, param);
+    GEN otherGen(gm, otherParam);
+    for(size_t step=0; step<4; ++step){
+        gen.getProposal(current,proposals[0]);
+        sameGen.getProposal(current,proposals[1]);
+        otherGen.getProposal(current,proposals[2]);
+        OPENGM_TEST(proposals[0]==proposals[1]);
+        different = different || proposals[0]!=proposals[2];
+        for(size_t vi=0; vi<gm.numberOfVariables(); ++vi){
+            OPENGM_TEST(proposals[0][vi] < gm.numberOfLabels(vi));
+        }
+        current = proposals[0];
+    }
+    OPENGM_TEST(different);
+}
+
+void test_random_generators()
+{
+    // 5x4 grid, variable r + c*5, with random unaries and potts terms
+    typedef opengm::SimpleDiscreteSpace<size_t, size_t> Space;
+    typedef opengm::GraphicalModel < double, opengm::Adder,
+            OPENGM_TYPELIST_2(opengm::ExplicitFunction<double> , opengm::PottsFunction<double> ) , Space > GmType;
+    const size_t height = 5;
+    const size_t width = 4;
+    const size_t numberOfLabels = 6;
+    GmType gm(Space(height*width, numberOfLabels));
+    opengm::CounterBasedRandom random(1);
+    for(size_t vi=0; vi<gm.numberOfVariables(); ++vi){
+        const size_t shape[] = {numberOfLabels};
+        opengm::ExplicitFunction<double> f(shape, shape+1);
+        for(size_t l=0; l<numberOfLabels; ++l){
+            f(l) = random.uniform();
+        }
+        gm.addFactor(gm.addFunction(f), &vi, &vi+1);
+    }
+    const GmType::FunctionIdentifier fid = gm.addFunction(opengm::PottsFunction<double>(numberOfLabels, numberOfLabels, 0.0, 0.2));
+    for(size_t c=0; c<width; ++c){
+        for(size_t r=0; r<height; ++r){
+            const size_t vi = r + c*height;
+            if(r+1<height){
+                const size_t vis[] = {vi, vi+1};
+                gm.addFactor(fid, vis, vis+2);
+            }
+            if(c+1<width){
+                const size_t vis[] = {vi, vi+height};
+                gm.addFactor(fid, vis, vis+2);
+            }
+        }
+    }
+
+    typedef opengm::proposal_gen::RandomGen<GmType, opengm::Minimizer> RGen;
+    test_seeded_generator<RGen>(gm, RGen::Parameter(3), RGen::Parameter(4));
+    typedef opengm::proposal_gen::NonUniformRandomGen<GmType, opengm::Minimizer> NURGen;
+    test_seeded_generator<NURGen>(gm, NURGen::Parameter(1.0, 3), NURGen::Parameter(1.0, 4));
+    typedef opengm::proposal_gen::BlurGen<GmType, opengm::Minimizer> BlurGen;
+    test_seeded_generator<BlurGen>(gm, BlurGen::Parameter(1.0, 3), BlurGen::Parameter(1.0, 4));
+    typedef opengm::proposal_gen::EnergyBlurGen<GmType, opengm::Minimizer> EBlurGen;
+    test_seeded_generator<EBlurGen>(gm, EBlurGen::Parameter(1.0, false, 1.0, 3), EBlurGen::Parameter(1.0, false, 1.0, 4));
+    test_seeded_generator<EBlurGen>(gm, EBlurGen::Parameter(1.0, true, 1.0, 3), EBlurGen::Parameter(1.0, true, 1.0, 4));
+    typedef opengm::proposal_gen::UpDownGen<GmType, opengm::Minimizer> UDGen;
+    test_seeded_generator<UDGen>(gm, UDGen::Parameter("random", 3), UDGen::Parameter("random", 4));
+    typedef opengm::proposal_gen::JumpUpDownGen<GmType, opengm::Minimizer> JUDGen;
+    test_seeded_generator<JUDGen>(gm, JUDGen::Parameter("random", 3), JUDGen::Parameter("random", 4));
+    typedef opengm::proposal_gen::MJumpUpDownGen<GmType, opengm::Minimizer> MJUDGen;
+    test_seeded_generator<MJUDGen>(gm, MJUDGen::Parameter("random", 3), MJUDGen::Parameter("random", 4));
+}
+
+
 int main()
 {
     typedef opengm::GraphicalModel<double, opengm::Adder> SumGmType;
@@ -169,6 +246,7 @@ int main()
 
     test_ae_generator();
     test_ab_swap_generator();
+    test_random_generators();
 
 
     typedef opengm::proposal_gen::AlphaBetaSwapGen<SumGmType, opengm::Minimizer> ABGen;
@@ -8,6 +8,7 @@
 #include <opengm/operations/multiplier.hxx>
 #include <opengm/operations/minimizer.hxx>
 #include <opengm/operations/maximizer.hxx>
+#include <opengm/functions/explicit_function.hxx>
 #include <opengm/inference/graphcut.hxx>
 
 #include <opengm/unittests/blackboxtester.hxx>
@@ -112,6 +113,40 @@ int main() {
       MinGraphCut::Parameter para;
       minTester.test<MinGraphCut>(para);
    }
+   std::cout << "  * Test Min-Sum with single-threaded MinSTCutGrid" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      MinGraphCut::Parameter para;
+      para.numberOfThreads_ = 1;
+      minTester.test<MinGraphCut>(para);
+   }
+   std::cout << "  * Test Min-Sum with BOOST-Kolmogorov on grids (MinSTCutGrid disabled)" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      MinGraphCut::Parameter para;
+      para.useGrid_ = false;
+      minTester.test<MinGraphCut>(para);
+   }
+   std::cout << "  * Test selection of MinSTCutGrid" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> MinGraphCut;
+      const GraphicalModelType potts = GridTest(4, 3, 2, false, true, GridTest::POTTS, opengm::OPTIMAL, 1).getModel(0);
+      OPENGM_TEST(MinGraphCut(potts).usesGrid());
+      OPENGM_TEST(!MinGraphCut(potts, MinGraphCut::Parameter(1, false)).usesGrid());
+      const GraphicalModelType star = StarTest(5, 2, false, true, StarTest::POTTS, opengm::OPTIMAL, 1).getModel(0);
+      OPENGM_TEST(!MinGraphCut(star).usesGrid());
+      // a second order factor between variables that are not neighbors in the grid
+      GraphicalModelType diagonal(potts);
+      const size_t shape[] = {2, 2};
+      opengm::ExplicitFunction<float> f(shape, shape + 2, 1.0f);
+      f(0, 0) = f(1, 1) = 0.0f;
+      const size_t vars[] = {0, 5};
+      diagonal.addFactor(diagonal.addFunction(f), vars, vars + 2);
+      OPENGM_TEST(!MinGraphCut(diagonal).usesGrid());
+   }
 #endif
   
 #ifdef WITH_MAXFLOW_IBFS
@@ -168,6 +203,14 @@ int main() {
       MaxGraphCut::Parameter para;
       maxTester.test<MaxGraphCut>(para);
    }
+   std::cout << "  * Test Max-Sum with BOOST-Kolmogorov on grids (MinSTCutGrid disabled)" << std::endl;
+   {
+      typedef opengm::MinSTCutBoost<size_t, float, opengm::KOLMOGOROV> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Maximizer, MinStCutType> MaxGraphCut;
+      MaxGraphCut::Parameter para;
+      para.useGrid_ = false;
+      maxTester.test<MaxGraphCut>(para);
+   }
 #endif
 
    return 0;
@@ -63,6 +63,23 @@ int main() {
       prodTester.test<ICM>(para);
       std::cout << " OK!"<<std::endl;
    }
+   {
+      std::cout << "  * Minimization/Adder  (parallel, with budgets) ..." << std::endl;
+      typedef opengm::ICM<SumGmType, opengm::Minimizer> ICM;
+      ICM::Parameter para;
+      sumTester.setNumberOfThreads(4);
+      sumTester.setTimeBudget(60.0);
+      sumTester.setMemoryBudget(4096.0);
+      sumTester.setCountIterations(true);
+      sumTester.test<ICM>(para);
+      OPENGM_TEST_EQUAL(sumTester.reports().size(), 2);
+      for(size_t i = 0; i < sumTester.reports().size(); ++i) {
+         OPENGM_TEST_EQUAL(sumTester.reports()[i].testId, i);
+         OPENGM_TEST(sumTester.reports()[i].seconds >= 0);
+         OPENGM_TEST(sumTester.reports()[i].peakMemory > 0);
+      }
+      std::cout << " OK!"<<std::endl;
+   }
 }
 
 
@@ -36,6 +36,7 @@ int main() {
    //prodTester.addTest(new ProdFullTest(4,    3, false,    3, ProdFullTest::RANDOM, opengm::PASS, 5));
    
    //const size_t ad3Threshold=4;
+#ifdef WITH_AD3
    std::cout << "LOC -AD3 Tests ..." << std::endl;
    {
       std::cout << "  * Maximization/Adder  ..." << std::endl;
@@ -51,6 +52,35 @@ int main() {
       sumTester.test<LOC>(para);
       std::cout << " OK!"<<std::endl;
    }
+#endif
+   std::cout << "LOC -ADMM Tests ..." << std::endl;
+   {
+      std::cout << "  * Minimization/Adder  ..." << std::endl;
+      typedef opengm::LOC<SumGmType, opengm::Minimizer> LOC;
+      LOC::Parameter para("admm",0.5,10,200);
+      sumTester.test<LOC>(para);
+      std::cout << " OK!"<<std::endl;
+   }
+   std::cout << "LOC -ADMM concurrent Tests ..." << std::endl;
+   {
+      std::cout << "  * Minimization/Adder  ..." << std::endl;
+      typedef opengm::LOC<SumGmType, opengm::Minimizer> LOC;
+      LOC::Parameter para("admm",0.5,10,200);
+      para.numberOfThreads_=2;
+      sumTester.test<LOC>(para);
+      std::cout << " OK!"<<std::endl;
+   }
+#ifndef WITH_AD3
+   std::cout << "LOC -AD3 without WITH_AD3 ..." << std::endl;
+   {
+      typedef opengm::LOC<SumGmType, opengm::Minimizer> LOC;
+      opengm::InferenceBlackBoxTester<SumGmType> failTester;
+      failTester.addTest(new SumGridTest(5, 5, 2, false, true, SumGridTest::POTTS, opengm::FAIL, 1));
+      LOC::Parameter para("ad3",0.5,10,200);
+      failTester.test<LOC>(para);
+      std::cout << " OK!"<<std::endl;
+   }
+#endif
    std::cout << "LOC -ASTAR Tests ..." << std::endl;
    {
       std::cout << "  * Maximization/Adder  ..." << std::endl;
@@ -0,0 +1,226 @@
+#include <vector>
+#include <stdexcept>
+
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/unittests/test.hxx>
+#include <opengm/inference/auxiliary/lp_reparametrization.hxx>
+#ifdef WITH_HDF5
+#  include <opengm/inference/auxiliary/lp_reparametrization_hdf5.hxx>
+#endif
+
+typedef opengm::GraphicalModel<double, opengm::Adder> GraphicalModelType;
+typedef opengm::ExplicitFunction<double> ExplicitFunctionType;
+typedef opengm::LPReparametrisationStorage<GraphicalModelType> RepaType;
+
+// 3 variables with 2, 3 and 2 labels: unaries, two pairwise factors and one third order factor
+GraphicalModelType model() {
+   const size_t numbersOfLabels[] = {2, 3, 2};
+   GraphicalModelType gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels, numbersOfLabels + 3));
+   for(size_t v = 0; v < 3; ++v) {
+      ExplicitFunctionType f(numbersOfLabels + v, numbersOfLabels + v + 1);
+      for(size_t l = 0; l < numbersOfLabels[v]; ++l) {
+         f(l) = 0.5 * v + 0.25 * l;
+      }
+      gm.addFactor(gm.addFunction(f), &v, &v + 1);
+   }
+   for(size_t v = 0; v < 2; ++v) {
+      ExplicitFunctionType f(numbersOfLabels + v, numbersOfLabels + v + 2);
+      for(size_t l0 = 0; l0 < numbersOfLabels[v]; ++l0)
+      for(size_t l1 = 0; l1 < numbersOfLabels[v + 1]; ++l1) {
+         f(l0, l1) = l0 == l1 ? 0.0 : 1.0 + v;
+      }
+      const size_t vi[] = {v, v + 1};
+      gm.addFactor(gm.addFunction(f), vi, vi + 2);
+   }
+   {
+      ExplicitFunctionType f(numbersOfLabels, numbersOfLabels + 3);
+      for(size_t l0 = 0; l0 < 2; ++l0)
+      for(size_t l1 = 0; l1 < 3; ++l1)
+      for(size_t l2 = 0; l2 < 2; ++l2) {
+         f(l0, l1, l2) = 0.1 * (l0 + 2 * l1 + 3 * l2);
+      }
+      const size_t vi[] = {0, 1, 2};
+      gm.addFactor(gm.addFunction(f), vi, vi + 3);
+   }
+   return gm;
+}
+
+// distinct dual values, written through the mutable iterators
+void fill(RepaType& repa) {
+   const GraphicalModelType& gm = repa.graphicalModel();
+   for(size_t f = 0; f < gm.numberOfFactors(); ++f) {
+      if(gm[f].numberOfVariables() < 2) {
+         continue;
+      }
+      for(size_t n = 0; n < gm[f].numberOfVariables(); ++n) {
+         std::pair<RepaType::uIterator, RepaType::uIterator> it = repa.getIterators(f, n);
+         for(size_t l = 0; it.first != it.second; ++it.first, ++l) {
+            *it.first = f + 0.1 * n + 0.01 * l;
+         }
+      }
+   }
+}
+
+void testAccess() {
+   const GraphicalModelType gm = model();
+   RepaType repa(gm);
+   // 2+3 + 3+2 + 2+3+2 dual variables, all zero
+   OPENGM_TEST_EQUAL(repa.size(), 17);
+   for(size_t k = 0; k < repa.size(); ++k) {
+      OPENGM_TEST_EQUAL(repa.data()[k], 0.0);
+   }
+   fill(repa);
+
+   const RepaType& constRepa = repa;
+   for(size_t f = 0; f < gm.numberOfFactors(); ++f) {
+      if(gm[f].numberOfVariables() < 2) {
+         continue;
+      }
+      for(size_t n = 0; n < gm[f].numberOfVariables(); ++n) {
+         const size_t var = gm[f].variableIndex(n);
+         OPENGM_TEST_EQUAL(repa.localId(f, var), n);
+         std::pair<RepaType::const_uIterator, RepaType::const_uIterator> it = constRepa.getIterators(f, n);
+         OPENGM_TEST_EQUAL(static_cast<size_t>(it.second - it.first), gm.numberOfLabels(var));
+         const RepaType::UnaryFactor copy = constRepa.get(f, n);
+         OPENGM_TEST_EQUAL(copy.size(), gm.numberOfLabels(var));
+         for(size_t l = 0; l < copy.size(); ++l) {
+            OPENGM_TEST_EQUAL_TOLERANCE(it.first[l], f + 0.1 * n + 0.01 * l, 1e-12);
+            OPENGM_TEST_EQUAL(copy[l], it.first[l]);
+         }
+      }
+   }
+
+   // factor 3 connects the variables 0 and 1 only
+   bool thrown = false;
+   try {
+      repa.localId(3, 2);
+   }
+   catch(std::runtime_error&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+void testFactorValues() {
+   const GraphicalModelType gm = model();
+   RepaType repa(gm);
+   fill(repa);
+
+   std::vector<size_t> labeling(3, 0);
+   for(labeling[0] = 0; labeling[0] < 2; ++labeling[0])
+   for(labeling[1] = 0; labeling[1] < 3; ++labeling[1])
+   for(labeling[2] = 0; labeling[2] < 2; ++labeling[2]) {
+      double sum = 0.0;
+      for(size_t f = 0; f < gm.numberOfFactors(); ++f) {
+         std::vector<size_t> factorLabeling(gm[f].numberOfVariables());
+         for(size_t n = 0; n < factorLabeling.size(); ++n) {
+            factorLabeling[n] = labeling[gm[f].variableIndex(n)];
+         }
+         double expected = gm[f](factorLabeling.begin());
+         if(gm[f].numberOfVariables() > 1) {
+            for(size_t n = 0; n < factorLabeling.size(); ++n) {
+               expected += repa.get(f, n)[factorLabeling[n]];
+            }
+         }
+         else {
+            const size_t var = gm[f].variableIndex(0);
+            for(size_t j = 0; j < gm.numberOfFactors(var); ++j) {
+               const size_t g = gm.factorOfVariable(var, j);
+               if(gm[g].numberOfVariables() > 1) {
+                  expected -= repa.get(g, repa.localId(g, var))[labeling[var]];
+               }
+            }
+            OPENGM_TEST_EQUAL_TOLERANCE(repa.getVariableValue(var, labeling[var]), expected, 1e-12);
+         }
+         const double value = repa.getFactorValue(f, factorLabeling.begin());
+         OPENGM_TEST_EQUAL_TOLERANCE(value, expected, 1e-12);
+         sum += value;
+      }
+      // a reparametrization does not change the energy
+      OPENGM_TEST_EQUAL_TOLERANCE(sum, gm.evaluate(labeling.begin()), 1e-12);
+   }
+}
+
+void testSerialization() {
+   const GraphicalModelType gm = model();
+   RepaType repa(gm);
+   fill(repa);
+   std::vector<double> serialization;
+   repa.serialize(&serialization);
+   OPENGM_TEST_EQUAL(serialization.size(), repa.size());
+
+   RepaType copy(gm);
+   copy.deserialize(serialization);
+   for(size_t k = 0; k < repa.size(); ++k) {
+      OPENGM_TEST_EQUAL(copy.data()[k], repa.data()[k]);
+   }
+
+   serialization.pop_back();
+   bool thrown = false;
+   try {
+      copy.deserialize(serialization);
+   }
+   catch(std::runtime_error&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+#ifdef WITH_HDF5
+void testHDF5() {
+   const GraphicalModelType gm = model();
+   RepaType repa(gm);
+   fill(repa);
+   opengm::hdf5::save(repa, "test_lp_reparametrization.h5", "repa");
+
+   RepaType loaded(gm);
+   opengm::hdf5::load(&loaded, "test_lp_reparametrization.h5", "repa");
+   for(size_t k = 0; k < repa.size(); ++k) {
+      OPENGM_TEST_EQUAL(loaded.data()[k], repa.data()[k]);
+   }
+
+   // the file holds the serialization as a one-dimensional dataset
+   {
+      std::vector<double> serialization;
+      repa.serialize(&serialization);
+      marray::Marray<double> stored;
+      hid_t file = marray::hdf5::openFile("test_lp_reparametrization.h5");
+      marray::hdf5::load(file, "repa", stored);
+      marray::hdf5::closeFile(file);
+      OPENGM_TEST_EQUAL(stored.dimension(), 1);
+      OPENGM_TEST_EQUAL(stored.size(), serialization.size());
+      for(size_t k = 0; k < serialization.size(); ++k) {
+         OPENGM_TEST_EQUAL(stored(k), serialization[k]);
+      }
+   }
+
+   // a reparametrization of another model does not fit
+   const size_t numbersOfLabels[] = {2, 2};
+   GraphicalModelType other(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels, numbersOfLabels + 2));
+   ExplicitFunctionType f(numbersOfLabels, numbersOfLabels + 2, 0.0);
+   const size_t vi[] = {0, 1};
+   other.addFactor(other.addFunction(f), vi, vi + 2);
+   RepaType otherRepa(other);
+   bool thrown = false;
+   try {
+      opengm::hdf5::load(&otherRepa, "test_lp_reparametrization.h5", "repa");
+   }
+   catch(std::runtime_error&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+#endif
+
+int main() {
+   std::cout << "LP Reparametrization Tests ..." << std::endl;
+   testAccess();
+   testFactorValues();
+   testSerialization();
+#ifdef WITH_HDF5
+   testHDF5();
+#endif
+   std::cout << "done!" << std::endl;
+   return 0;
+}
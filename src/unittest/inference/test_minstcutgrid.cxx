@@ -0,0 +1,135 @@
+#include <vector>
+#include <iostream>
+#include <stdlib.h>
+
+#include <opengm/unittests/test.hxx>
+#include <opengm/inference/auxiliary/minstcutgrid.hxx>
+
+typedef opengm::MinSTCutGrid<size_t, double> ALG;
+
+struct Edge {
+   size_t n1, n2;
+   double capacity;
+};
+
+// value of the cut; segmentation[n] == true means node n is on the sink side
+double cutValue(const std::vector<Edge>& edges, const std::vector<bool>& segmentation) {
+   double value = 0.0;
+   for(size_t e = 0; e < edges.size(); ++e) {
+      if(!segmentation[edges[e].n1] && segmentation[edges[e].n2]) {
+         value += edges[e].capacity;
+      }
+   }
+   return value;
+}
+
+// compares the cut on a random lattice to the minimum over all cuts
+void testLattice(const size_t dimX, const size_t dimY, const size_t dimZ, const size_t numberOfThreads) {
+   const size_t numberOfVariables = dimX * dimY * dimZ;
+   ALG alg(dimX, dimY, dimZ, numberOfThreads);
+   OPENGM_TEST_EQUAL(alg.numberOfNodes(), numberOfVariables + 2);
+
+   std::vector<Edge> edges;
+   for(size_t v = 0; v < numberOfVariables; ++v) {
+      const Edge source = {0, v + 2, static_cast<double>(rand() % 100)};
+      const Edge sink = {v + 2, 1, static_cast<double>(rand() % 100)};
+      edges.push_back(source);
+      edges.push_back(sink);
+      const size_t x = v % dimX;
+      const size_t y = (v / dimX) % dimY;
+      const size_t z = v / (dimX * dimY);
+      const size_t stride[] = {1, dimX, dimX * dimY};
+      const bool inside[] = {x + 1 < dimX, y + 1 < dimY, z + 1 < dimZ};
+      for(size_t axis = 0; axis < 3; ++axis) {
+         if(inside[axis]) {
+            const Edge forward = {v + 2, v + stride[axis] + 2, static_cast<double>(rand() % 60)};
+            const Edge backward = {v + stride[axis] + 2, v + 2, static_cast<double>(rand() % 60)};
+            edges.push_back(forward);
+            edges.push_back(backward);
+         }
+      }
+   }
+   for(size_t e = 0; e < edges.size(); ++e) {
+      alg.addEdge(edges[e].n1, edges[e].n2, edges[e].capacity);
+   }
+   std::vector<bool> segmentation;
+   alg.calculateCut(segmentation);
+   OPENGM_TEST_EQUAL(segmentation.size(), numberOfVariables + 2);
+   OPENGM_TEST(!segmentation[0]);
+   OPENGM_TEST(segmentation[1]);
+
+   std::vector<bool> s(numberOfVariables + 2, false);
+   s[1] = true;
+   double optimum = cutValue(edges, s);
+   for(size_t code = 1; code < (size_t(1) << numberOfVariables); ++code) {
+      for(size_t v = 0; v < numberOfVariables; ++v) {
+         s[v + 2] = ((code >> v) & 1) == 1;
+      }
+      optimum = std::min(optimum, cutValue(edges, s));
+   }
+   OPENGM_TEST_EQUAL_TOLERANCE(cutValue(edges, segmentation), optimum, 1e-9);
+}
+
+// a larger lattice spanning several blocks, cut value must not depend on the number of threads
+void testBlocks() {
+   const size_t dimX = 150;
+   const size_t dimY = 90;
+   double values[2];
+   for(size_t run = 0; run < 2; ++run) {
+      srand(7);
+      ALG alg(dimX, dimY, 1, run == 0 ? 1 : 0);
+      std::vector<Edge> edges;
+      for(size_t v = 0; v < dimX * dimY; ++v) {
+         const Edge source = {0, v + 2, static_cast<double>(rand() % 100)};
+         const Edge sink = {v + 2, 1, static_cast<double>(rand() % 100)};
+         edges.push_back(source);
+         edges.push_back(sink);
+         if(v % dimX + 1 < dimX) {
+            const Edge e = {v + 2, v + 3, static_cast<double>(rand() % 60)};
+            edges.push_back(e);
+         }
+         if(v + dimX < dimX * dimY) {
+            const Edge e = {v + dimX + 2, v + 2, static_cast<double>(rand() % 60)};
+            edges.push_back(e);
+         }
+      }
+      for(size_t e = 0; e < edges.size(); ++e) {
+         alg.addEdge(edges[e].n1, edges[e].n2, edges[e].capacity);
+      }
+      std::vector<bool> segmentation;
+      alg.calculateCut(segmentation);
+      values[run] = cutValue(edges, segmentation);
+   }
+   OPENGM_TEST_EQUAL_TOLERANCE(values[0], values[1], 1e-9);
+}
+
+void testAdjacency() {
+   ALG alg(4, 3);
+   OPENGM_TEST(alg.adjacent(2, 3));
+   OPENGM_TEST(alg.adjacent(2, 6));
+   OPENGM_TEST(!alg.adjacent(5, 6));
+   OPENGM_TEST(!alg.adjacent(2, 7));
+   bool thrown = false;
+   try {
+      alg.addEdge(2, 7, 1.0);
+   }
+   catch(opengm::RuntimeError&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+int main() {
+   std::cout << "MinStCutGrid Test ... " << std::endl;
+   srand(0);
+   for(size_t n = 0; n < 20; ++n) {
+      testLattice(12, 1, 1, 1);
+      testLattice(4, 3, 1, 1);
+      testLattice(3, 2, 2, 2);
+      testLattice(2, 3, 2, 0);
+   }
+   testBlocks();
+   testAdjacency();
+   std::cout << "done!" << std::endl;
+   return 0;
+}
@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <vector>
+
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/inference/portfolio.hxx>
+#include <opengm/inference/icm.hxx>
+#include <opengm/inference/lazyflipper.hxx>
+#include <opengm/inference/bruteforce.hxx>
+#include <opengm/inference/trws/trws_trws.hxx>
+
+#include <opengm/unittests/test.hxx>
+#include <opengm/unittests/blackboxtests/blackboxtestgrid.hxx>
+
+typedef opengm::GraphicalModel<double, opengm::Adder> GmType;
+typedef opengm::Portfolio<GmType, opengm::Minimizer> PortfolioType;
+typedef opengm::ICM<GmType, opengm::Minimizer> ICMType;
+typedef opengm::LazyFlipper<GmType, opengm::Minimizer> LazyFlipperType;
+typedef opengm::Bruteforce<GmType, opengm::Minimizer> BruteforceType;
+typedef opengm::TRWSi<GmType, opengm::Minimizer> TRWSiType;
+
+// returns its starting point as result, remembers the last one it was given
+class StartRecorder : public opengm::Inference<GmType, opengm::Minimizer> {
+public:
+   struct Parameter {};
+   StartRecorder(const GmType& gm, const Parameter& = Parameter())
+      : gm_(gm), state_(gm.numberOfVariables(), 0) {}
+   std::string name() const { return "StartRecorder"; }
+   const GmType& graphicalModel() const { return gm_; }
+   void setStartingPoint(std::vector<LabelType>::const_iterator begin) {
+      state_.assign(begin, begin + gm_.numberOfVariables());
+      lastStart_ = state_;
+   }
+   opengm::InferenceTermination infer() { return opengm::NORMAL; }
+   template<class VISITOR>
+   opengm::InferenceTermination infer(VISITOR& visitor) {
+      visitor.begin(*this);
+      visitor.end(*this);
+      return opengm::NORMAL;
+   }
+   opengm::InferenceTermination arg(std::vector<LabelType>& arg, const size_t = 1) const {
+      arg = state_;
+      return opengm::NORMAL;
+   }
+   ValueType value() const { return gm_.evaluate(state_.begin()); }
+   static std::vector<LabelType> lastStart_;
+private:
+   const GmType& gm_;
+   std::vector<LabelType> state_;
+};
+std::vector<size_t> StartRecorder::lastStart_;
+
+class FailingSolver : public opengm::Inference<GmType, opengm::Minimizer> {
+public:
+   struct Parameter {};
+   FailingSolver(const GmType& gm, const Parameter& = Parameter())
+      : gm_(gm) {}
+   std::string name() const { return "FailingSolver"; }
+   const GmType& graphicalModel() const { return gm_; }
+   opengm::InferenceTermination infer() { throw opengm::RuntimeError("out of luck"); }
+   template<class VISITOR>
+   opengm::InferenceTermination infer(VISITOR&) { return infer(); }
+private:
+   const GmType& gm_;
+};
+
+void testIncumbent() {
+   opengm::BlackBoxTestGrid<GmType> models(3, 4, 3, false, true, opengm::BlackBoxTestGrid<GmType>::RANDOM, opengm::PASS, 1);
+   const GmType gm = models.getModel(0);
+
+   PortfolioType portfolio(gm, PortfolioType::Parameter(std::numeric_limits<double>::infinity(), 0.0, 2));
+   portfolio.addSolver<ICMType>();
+   portfolio.addSolver<LazyFlipperType>(LazyFlipperType::Parameter(2), "LF2");
+   portfolio.addSolver<TRWSiType>(TRWSiType::Parameter(50));
+   OPENGM_TEST_EQUAL(portfolio.numberOfSolvers(), 3);
+   OPENGM_TEST(portfolio.infer() == opengm::NORMAL);
+   OPENGM_TEST_EQUAL(portfolio.solverName(1), "LF2");
+   OPENGM_TEST(!portfolio.solverName(0).empty());
+
+   // the incumbent is the best labeling of all solvers
+   std::vector<size_t> labeling;
+   portfolio.arg(labeling);
+   OPENGM_TEST_EQUAL_TOLERANCE(portfolio.value(), gm.evaluate(labeling.begin()), 1e-9);
+   ICMType icm(gm);
+   icm.infer();
+   OPENGM_TEST(portfolio.value() <= icm.value() + 1e-9);
+   OPENGM_TEST(portfolio.bound() <= portfolio.value() + 1e-9);
+
+   // improvements are chronological and monotone
+   const std::vector<PortfolioType::Improvement>& improvements = portfolio.improvements();
+   OPENGM_TEST(!improvements.empty());
+   for(size_t j = 0; j < improvements.size(); ++j) {
+      OPENGM_TEST(improvements[j].solver_ < portfolio.numberOfSolvers());
+      if(j > 0) {
+         OPENGM_TEST(improvements[j].time_ >= improvements[j - 1].time_);
+         OPENGM_TEST(improvements[j].value_ <= improvements[j - 1].value_);
+         OPENGM_TEST(improvements[j].bound_ >= improvements[j - 1].bound_);
+      }
+   }
+   OPENGM_TEST_EQUAL(improvements.back().value_, portfolio.value());
+}
+
+void testGapLimit() {
+   opengm::BlackBoxTestGrid<GmType> models(1, 6, 3, false, true, opengm::BlackBoxTestGrid<GmType>::POTTS, opengm::PASS, 1);
+   const GmType gm = models.getModel(0);
+
+   // TRWSi closes the gap on this chain
+   PortfolioType portfolio(gm, PortfolioType::Parameter(std::numeric_limits<double>::infinity(), 1e-6));
+   portfolio.addSolver<TRWSiType>(TRWSiType::Parameter(100));
+   portfolio.addSolver<ICMType>();
+   portfolio.infer();
+   BruteforceType bruteforce(gm);
+   bruteforce.infer();
+   OPENGM_TEST_EQUAL_TOLERANCE(portfolio.value(), bruteforce.value(), 1e-9);
+   OPENGM_TEST(portfolio.value() - portfolio.bound() <= 1e-6);
+}
+
+void testWarmStart() {
+   opengm::BlackBoxTestGrid<GmType> models(3, 3, 3, false, true, opengm::BlackBoxTestGrid<GmType>::RANDOM, opengm::PASS, 1);
+   const GmType gm = models.getModel(0);
+
+   // with one thread the solvers run in order, the recorder starts from the ICM result
+   PortfolioType portfolio(gm, PortfolioType::Parameter(std::numeric_limits<double>::infinity(), 0.0, 1));
+   portfolio.addSolver<ICMType>();
+   portfolio.addSolver<StartRecorder>();
+   StartRecorder::lastStart_.clear();
+   OPENGM_TEST(portfolio.infer() == opengm::NORMAL);
+   std::vector<size_t> labeling;
+   portfolio.arg(labeling);
+   OPENGM_TEST(StartRecorder::lastStart_ == labeling);
+
+   PortfolioType cold(gm, PortfolioType::Parameter(std::numeric_limits<double>::infinity(), 0.0, 1, false));
+   cold.addSolver<ICMType>();
+   cold.addSolver<StartRecorder>();
+   StartRecorder::lastStart_.clear();
+   cold.infer();
+   OPENGM_TEST(StartRecorder::lastStart_.empty());
+}
+
+void testErrors() {
+   opengm::BlackBoxTestGrid<GmType> models(3, 3, 3, false, true, opengm::BlackBoxTestGrid<GmType>::RANDOM, opengm::PASS, 1);
+   const GmType gm = models.getModel(0);
+
+   // the failure is reported, the result of the other solver is kept
+   PortfolioType portfolio(gm, PortfolioType::Parameter(std::numeric_limits<double>::infinity(), 0.0, 2));
+   portfolio.addSolver<ICMType>();
+   portfolio.addSolver<FailingSolver>();
+   OPENGM_TEST(portfolio.infer() == opengm::INFERENCE_ERROR);
+   OPENGM_TEST(portfolio.solverError(0).empty());
+   OPENGM_TEST(portfolio.solverError(1).find("out of luck") != std::string::npos);
+   ICMType icm(gm);
+   icm.infer();
+   OPENGM_TEST(portfolio.value() <= icm.value() + 1e-9);
+
+   // without any result the failure is thrown
+   PortfolioType failing(gm);
+   failing.addSolver<FailingSolver>();
+   bool thrown = false;
+   try {
+      failing.infer();
+   }
+   catch(opengm::RuntimeError&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+int main() {
+   std::cout << "Portfolio Tests ..." << std::endl;
+   testIncumbent();
+   testGapLimit();
+   testWarmStart();
+   testErrors();
+   std::cout << "done!" << std::endl;
+   return 0;
+}
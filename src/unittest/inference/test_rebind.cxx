@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <vector>
+#include <cmath>
+
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/unittests/test.hxx>
+
+#include <opengm/inference/bruteforce.hxx>
+#include <opengm/inference/icm.hxx>
+#include <opengm/inference/messagepassing/messagepassing.hxx>
+#include <opengm/inference/trws/trws_trws.hxx>
+
+#ifdef WITH_BOOST
+#  include <opengm/inference/graphcut.hxx>
+#  include <opengm/inference/alphaexpansion.hxx>
+#  include <opengm/inference/auxiliary/minstcutboost.hxx>
+#endif
+
+typedef opengm::GraphicalModel<double, opengm::Adder> GraphicalModelType;
+typedef opengm::ExplicitFunction<double> ExplicitFunctionType;
+
+// chain with random unaries (depending on the seed) and fixed potts terms
+GraphicalModelType chain(const size_t numberOfVariables, const size_t numberOfLabels, const unsigned int seed) {
+   std::vector<size_t> numbersOfLabels(numberOfVariables, numberOfLabels);
+   GraphicalModelType gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels.begin(), numbersOfLabels.end()));
+   srand(seed);
+   for(size_t v = 0; v < numberOfVariables; ++v) {
+      ExplicitFunctionType f(&numbersOfLabels[v], &numbersOfLabels[v] + 1);
+      for(size_t l = 0; l < numberOfLabels; ++l) {
+         f(l) = static_cast<double>(rand() % 100) / 100.0;
+      }
+      gm.addFactor(gm.addFunction(f), &v, &v + 1);
+   }
+   const size_t shape[] = {numberOfLabels, numberOfLabels};
+   ExplicitFunctionType potts(shape, shape + 2, 0.3);
+   for(size_t l = 0; l < numberOfLabels; ++l) {
+      potts(l, l) = 0;
+   }
+   const GraphicalModelType::FunctionIdentifier fid = gm.addFunction(potts);
+   for(size_t v = 0; v + 1 < numberOfVariables; ++v) {
+      const size_t vi[] = {v, v + 1};
+      gm.addFactor(fid, vi, vi + 2);
+   }
+   return gm;
+}
+
+double optimum(const GraphicalModelType& gm) {
+   opengm::Bruteforce<GraphicalModelType, opengm::Minimizer> bf(gm);
+   bf.infer();
+   return bf.value();
+}
+
+template<class INF>
+void testRebind(const typename INF::Parameter& parameter, const size_t numberOfLabels, const bool optimal) {
+   const GraphicalModelType gmA = chain(8, numberOfLabels, 0);
+   const GraphicalModelType gmB = chain(8, numberOfLabels, 1);
+   const GraphicalModelType gmC = chain(7, numberOfLabels, 2);
+   INF inf(gmA, parameter);
+   inf.infer();
+   std::vector<size_t> argA;
+   inf.arg(argA);
+
+   OPENGM_TEST(inf.rebind(gmB) == opengm::NORMAL);
+   OPENGM_TEST(&inf.graphicalModel() == &gmB);
+   inf.infer();
+   std::vector<size_t> argB;
+   inf.arg(argB);
+   OPENGM_TEST_EQUAL(argB.size(), gmB.numberOfVariables());
+   if(optimal) {
+      OPENGM_TEST_EQUAL_TOLERANCE(gmB.evaluate(argB.begin()), optimum(gmB), 1e-6);
+   }
+   else {
+      // warm start: not worse than the previous labeling on the new model
+      OPENGM_TEST(gmB.evaluate(argB.begin()) <= gmB.evaluate(argA.begin()) + 1e-6);
+   }
+
+   // models that differ only in the unaries
+   OPENGM_TEST(inf.updateUnaries(gmA) == opengm::NORMAL);
+   OPENGM_TEST(&inf.graphicalModel() == &gmA);
+   inf.infer();
+   std::vector<size_t> argA2;
+   inf.arg(argA2);
+   OPENGM_TEST_EQUAL(argA2.size(), gmA.numberOfVariables());
+   if(optimal) {
+      OPENGM_TEST_EQUAL_TOLERANCE(gmA.evaluate(argA2.begin()), optimum(gmA), 1e-6);
+   }
+   else {
+      OPENGM_TEST(gmA.evaluate(argA2.begin()) <= gmA.evaluate(argB.begin()) + 1e-6);
+   }
+
+   // models of a different structure are rejected
+   bool thrown = false;
+   try {
+      inf.rebind(gmC);
+   }
+   catch(opengm::RuntimeError&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+int main() {
+   std::cout << "Rebind Tests ..." << std::endl;
+   {
+      typedef opengm::ICM<GraphicalModelType, opengm::Minimizer> ICM;
+      testRebind<ICM>(ICM::Parameter(), 3, false);
+   }
+   {
+      typedef opengm::BeliefPropagationUpdateRules<GraphicalModelType, opengm::Minimizer> UpdateRules;
+      typedef opengm::MessagePassing<GraphicalModelType, opengm::Minimizer, UpdateRules, opengm::MaxDistance> BP;
+      testRebind<BP>(BP::Parameter(100), 3, true);
+   }
+   {
+      typedef opengm::TrbpUpdateRules<GraphicalModelType, opengm::Minimizer> UpdateRules;
+      typedef opengm::MessagePassing<GraphicalModelType, opengm::Minimizer, UpdateRules, opengm::MaxDistance> TRBP;
+      testRebind<TRBP>(TRBP::Parameter(100), 3, false);
+   }
+   {
+      typedef opengm::TRWSi<GraphicalModelType, opengm::Minimizer> TRWSi;
+      TRWSi::Parameter parameter(100);
+      parameter.precision_ = 1e-12;
+      testRebind<TRWSi>(parameter, 3, true);
+   }
+#ifdef WITH_BOOST
+   {
+      typedef opengm::MinSTCutBoost<size_t, double, opengm::PUSH_RELABEL> MinStCutType;
+      typedef opengm::GraphCut<GraphicalModelType, opengm::Minimizer, MinStCutType> GraphCut;
+      testRebind<GraphCut>(GraphCut::Parameter(), 2, true);
+      testRebind<GraphCut>(GraphCut::Parameter(1, false), 2, true);
+      typedef opengm::AlphaExpansion<GraphicalModelType, GraphCut> AlphaExpansion;
+      testRebind<AlphaExpansion>(AlphaExpansion::Parameter(), 3, false);
+   }
+#endif
+   std::cout << "done!" << std::endl;
+   return 0;
+}
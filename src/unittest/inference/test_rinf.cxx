@@ -65,6 +65,9 @@ struct RINFTest
     para.ConnectedComponents_ = true;
     std::cout << "    - Minimization/Adder (with persistency and CC) ..."<<std::endl;
     this->test<InfType>(para);
+    para.numberOfThreads_ = 2;
+    std::cout << "    - Minimization/Adder (with persistency and parallel CC) ..."<<std::endl;
+    this->test<InfType>(para);
   };
 };
 #endif
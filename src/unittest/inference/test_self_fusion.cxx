@@ -63,6 +63,22 @@ int main() {
          std::cout << " OK!"<<std::endl;
 
       }
+      {
+         std::cout << "  * Self Fusion  Belief Propagation  Minimization/Adder with concurrent fusion of two solvers..."<<std::endl;
+         typedef opengm::GraphicalModel<double, opengm::Adder> GraphicalModelType;
+         typedef opengm::BeliefPropagationUpdateRules<GraphicalModelType,opengm::Minimizer> UpdateRulesType;
+         typedef opengm::MessagePassing<GraphicalModelType, opengm::Minimizer,UpdateRulesType, opengm::MaxDistance> InfType;
+         typedef opengm::SelfFusion<InfType> SelfFusionInf;
+
+         InfType::Parameter infParam;
+         InfType::Parameter dampedInfParam(100, 0.0, 0.5);
+         SelfFusionInf::Parameter selfFuseInfParam(1,SelfFusionInf::LazyFlipperFusion,infParam);
+         selfFuseInfParam.infParams_.push_back(dampedInfParam);
+         selfFuseInfParam.numberOfThreads_ = 3;
+         selfFuseInfParam.queueSize_ = 2;
+         sumTester.test<SelfFusionInf>(selfFuseInfParam);
+         std::cout << " OK!"<<std::endl;
+      }
 
 
 
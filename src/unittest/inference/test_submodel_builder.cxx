@@ -0,0 +1,159 @@
+#include <vector>
+#include <cstdlib>
+
+#include <opengm/unittests/test.hxx>
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/operations/maximizer.hxx>
+#include <opengm/functions/explicit_function.hxx>
+#include <opengm/inference/bruteforce.hxx>
+#include <opengm/inference/auxiliary/submodel/submodel_builder.hxx>
+
+typedef opengm::GraphicalModel<double, opengm::Adder> Model;
+typedef opengm::ExplicitFunction<double> ExplicitFunction;
+typedef opengm::SubmodelOptimizer<Model, opengm::Minimizer> SubOptimizer;
+typedef opengm::Bruteforce<SubOptimizer::SubGmType, opengm::Minimizer> ViewBruteforce;
+typedef opengm::Bruteforce<SubOptimizer::MergedSubGmType, opengm::Minimizer> MergedBruteforce;
+typedef opengm::Bruteforce<SubOptimizer::MergedSubGmType, opengm::Maximizer> WorstBruteforce;
+
+size_t addRandomFactor(Model& gm, const size_t* vis, const size_t order) {
+   std::vector<size_t> shape(order);
+   for(size_t v = 0; v < order; ++v) {
+      shape[v] = gm.numberOfLabels(vis[v]);
+   }
+   ExplicitFunction f(shape.begin(), shape.end());
+   for(size_t i = 0; i < f.size(); ++i) {
+      f(i) = static_cast<double>(rand() % 1000) / 100.0;
+   }
+   return gm.addFactor(gm.addFunction(f), vis, vis + order);
+}
+
+// 6x6 grid with two pairwise factors per edge, higher order factors are optional
+Model buildModel(const bool highOrder) {
+   const size_t numbersOfLabels[] = {2, 3, 4};
+   std::vector<size_t> labels(36);
+   for(size_t v = 0; v < labels.size(); ++v) {
+      labels[v] = numbersOfLabels[rand() % 3];
+   }
+   Model gm(opengm::DiscreteSpace<size_t, size_t>(labels.begin(), labels.end()));
+   for(size_t v = 0; v < 36; ++v) {
+      addRandomFactor(gm, &v, 1);
+   }
+   for(size_t y = 0; y < 6; ++y) {
+      for(size_t x = 0; x < 6; ++x) {
+         if(x + 1 < 6) {
+            const size_t vis[] = {y * 6 + x, y * 6 + x + 1};
+            addRandomFactor(gm, vis, 2);
+         }
+         if(y + 1 < 6) {
+            const size_t vis[] = {y * 6 + x, y * 6 + x + 6};
+            addRandomFactor(gm, vis, 2);
+            addRandomFactor(gm, vis, 2);
+         }
+         if(highOrder && x + 1 < 6 && y + 1 < 6) {
+            const size_t vis[] = {y * 6 + x, y * 6 + x + 1, y * 6 + x + 7};
+            addRandomFactor(gm, vis, 3);
+         }
+      }
+   }
+   return gm;
+}
+
+std::vector<size_t> setRandomLabels(const Model& gm, SubOptimizer& optimizer) {
+   std::vector<size_t> labels(gm.numberOfVariables());
+   for(size_t v = 0; v < gm.numberOfVariables(); ++v) {
+      labels[v] = rand() % gm.numberOfLabels(v);
+      optimizer.setLabel(v, labels[v]);
+   }
+   return labels;
+}
+
+void testTreeDp() {
+   // a comb and a forest of paths
+   const size_t comb[] = {0, 1, 2, 3, 4, 5, 6, 8, 10, 12, 14, 16};
+   const size_t paths[] = {7, 8, 9, 20, 21, 22, 23, 29, 35};
+   std::vector<std::vector<size_t> > regions;
+   regions.push_back(std::vector<size_t>(comb, comb + 12));
+   regions.push_back(std::vector<size_t>(paths, paths + 9));
+
+   for(size_t n = 0; n < 5; ++n) {
+      const Model gm = buildModel(false);
+      SubOptimizer optimizer(gm);
+      for(size_t r = 0; r < regions.size(); ++r) {
+         const std::vector<size_t> labels = setRandomLabels(gm, optimizer);
+         std::vector<size_t> reference, conditioned, bruteforce;
+         optimizer.setVariableIndices(regions[r].begin(), regions[r].end());
+         optimizer.inferSubmodel<ViewBruteforce>(ViewBruteforce::Parameter(), bruteforce);
+         const bool changed = optimizer.inferConditionedTreeDp(conditioned);
+         optimizer.mergeFactorsAndInferDp(reference);
+         OPENGM_TEST(reference == conditioned);
+         OPENGM_TEST(bruteforce == conditioned);
+         optimizer.unsetVariableIndices();
+         bool differs = false;
+         for(size_t j = 0; j < regions[r].size(); ++j) {
+            differs = differs || conditioned[j] != labels[regions[r][j]];
+         }
+         OPENGM_TEST_EQUAL(changed, differs);
+      }
+   }
+}
+
+void testConditionedSubmodel() {
+   const size_t block[] = {7, 8, 9, 13, 14, 15, 20};
+   for(size_t n = 0; n < 5; ++n) {
+      const Model gm = buildModel(true);
+      SubOptimizer optimizer(gm);
+      setRandomLabels(gm, optimizer);
+      // reuse the buffers of the optimizer for several regions
+      for(size_t shift = 0; shift < 3; ++shift) {
+         std::vector<size_t> region(block, block + 7);
+         for(size_t v = 0; v < region.size(); ++v) {
+            region[v] += shift;
+         }
+         std::vector<size_t> reference, conditioned;
+         optimizer.setVariableIndices(region.begin(), region.end());
+         optimizer.inferSubmodel<ViewBruteforce>(ViewBruteforce::Parameter(), reference);
+         optimizer.inferConditionedSubmodel<MergedBruteforce>(MergedBruteforce::Parameter(), conditioned);
+         optimizer.unsetVariableIndices();
+         OPENGM_TEST(reference == conditioned);
+      }
+   }
+}
+
+// a solver that finds the worst labeling is rejected if only improving results are accepted
+void testImproving() {
+   const size_t block[] = {7, 8, 9, 13, 14, 15, 20};
+   const std::vector<size_t> region(block, block + 7);
+   for(size_t n = 0; n < 5; ++n) {
+      const Model gm = buildModel(true);
+      SubOptimizer optimizer(gm);
+      const std::vector<size_t> labels = setRandomLabels(gm, optimizer);
+      std::vector<size_t> current(region.size()), worst, rejected;
+      for(size_t j = 0; j < region.size(); ++j) {
+         current[j] = labels[region[j]];
+      }
+      optimizer.setVariableIndices(region.begin(), region.end());
+      optimizer.inferConditionedSubmodel<WorstBruteforce>(WorstBruteforce::Parameter(), worst, false);
+      const bool changed = optimizer.inferConditionedSubmodel<WorstBruteforce>(WorstBruteforce::Parameter(), rejected, true);
+      optimizer.unsetVariableIndices();
+
+      std::vector<size_t> worstLabels(labels);
+      for(size_t j = 0; j < region.size(); ++j) {
+         worstLabels[region[j]] = worst[j];
+      }
+      if(gm.evaluate(worstLabels.begin()) > gm.evaluate(labels.begin())) {
+         OPENGM_TEST(!changed);
+         OPENGM_TEST(rejected == current);
+      }
+   }
+}
+
+int main() {
+   std::cout << "Submodel Builder Test... " << std::endl;
+   testTreeDp();
+   testConditionedSubmodel();
+   testImproving();
+   std::cout << "done!" << std::endl;
+   return 0;
+}
@@ -6,7 +6,6 @@
 #include <opengm/operations/maximizer.hxx>
 #include <opengm/operations/normalize.hxx>
 #include <opengm/inference/swendsenwang.hxx>
-#include <opengm/inference/gibbs.hxx>
 #include <opengm/inference/messagepassing/messagepassing.hxx>
 #include <opengm/unittests/blackboxtester.hxx>
 #include <opengm/unittests/blackboxtests/blackboxtestgrid.hxx>
@@ -138,11 +137,10 @@ void SwendsenWangTest<OP, ACC>::run()
 // - 1st order marginals sampled using Swendsen-Wang
 //   with true 1st order marginals computed by BP
 // - 2nd order marginals sampled using Swendsen-Wang
-//   with 2nd order marginals sampled using Gibbs
+//   with true 2nd order marginals computed by enumeration
 void biasedModelTest() {
    typedef opengm::GraphicalModel<double, opengm::Multiplier> GraphicalModel;
    typedef opengm::SwendsenWang<GraphicalModel, opengm::Maximizer> SwendsenWang;
-   typedef opengm::Gibbs<GraphicalModel, opengm::Maximizer> Gibbs;
    typedef opengm::BeliefPropagationUpdateRules<GraphicalModel, opengm::Integrator> BpUpdateRules;
    typedef opengm::MessagePassing<GraphicalModel, opengm::Integrator, BpUpdateRules> BeliefPropagation;
 
@@ -189,14 +187,25 @@ void biasedModelTest() {
    BeliefPropagation::EmptyVisitorType bpVisitor;
    bp.infer(bpVisitor);
 
-   // sample 2nd order marginals using a Gibbs sampler
-   Gibbs gibbs(gm);
-   opengm::GibbsMarginalVisitor<Gibbs> gibbsVisitor(gm);
-   for(size_t j = 0; j < gm.numberOfVariables() - 1; ++j) {
-      size_t variableIndices[] = {j, j + 1};
-      gibbsVisitor.addMarginal(variableIndices, variableIndices + 2);
+   // compute exact 2nd order marginals by enumerating all states
+   std::vector<double> trueMarginals2(4 * (numberOfVariables - 1), 0.0);
+   {
+      std::vector<size_t> state(numberOfVariables);
+      double sum = 0.0;
+      for(size_t s = 0; s < (size_t(1) << numberOfVariables); ++s) {
+         for(size_t j = 0; j < numberOfVariables; ++j) {
+            state[j] = (s >> j) & 1;
+         }
+         const double p = gm.evaluate(state.begin());
+         sum += p;
+         for(size_t j = 0; j < numberOfVariables - 1; ++j) {
+            trueMarginals2[4 * j + 2 * state[j] + state[j + 1]] += p;
+         }
+      }
+      for(size_t k = 0; k < trueMarginals2.size(); ++k) {
+         trueMarginals2[k] /= sum;
+      }
    }
-   gibbs.infer(gibbsVisitor);
 
    // sample 1st and 2nd order marginals using Swendsen Wang
    SwendsenWang::Parameter swParameter(numberOfSamplingSteps,
@@ -260,15 +269,86 @@ void biasedModelTest() {
       for(size_t x = 0; x < 2; ++x)
       for(size_t y = 0; y < 2; ++y) {
          const double p = static_cast<double>(visitor.marginal(j)(x, y)) / visitor.numberOfSamples();
-         const double pGibbs = static_cast<double>(gibbsVisitor.marginal(j - gm.numberOfVariables())(x, y)) / gibbsVisitor.numberOfSamples();
-         OPENGM_TEST(2.0 * opengm::abs(p - pGibbs) / (p + pGibbs) < relativeTolerance);
+         const double pTrue = trueMarginals2[4 * (j - gm.numberOfVariables()) + 2 * x + y];
+         const double tolerance = pTrue * relativeTolerance;
+         OPENGM_TEST(p > pTrue - tolerance && p < pTrue + tolerance);
+      }
+   }
+}
+
+// Sampling is a function of the seed only: the same seed reproduces
+// the chain and its marginals, independently of the number of threads.
+void seedTest() {
+   typedef opengm::GraphicalModel<double, opengm::Multiplier> GraphicalModel;
+   typedef opengm::SwendsenWang<GraphicalModel, opengm::Maximizer> SwendsenWang;
+   typedef opengm::SwendsenWangMarginalVisitor<SwendsenWang> MarginalVisitor;
+
+   // 4x4 grid, binary
+   const size_t numberOfRows = 4;
+   const size_t numberOfVariables = numberOfRows * numberOfRows;
+   std::vector<size_t> numbersOfStates(numberOfVariables, 2);
+   GraphicalModel gm(opengm::DiscreteSpace<size_t,size_t>(numbersOfStates.begin(), numbersOfStates.end()));
+   size_t shape2[] = {2, 2};
+   opengm::ExplicitFunction<double> f2(shape2, shape2 + 2);
+   f2(0, 0) = 0.4;
+   f2(0, 1) = 0.1;
+   f2(1, 0) = 0.1;
+   f2(1, 1) = 0.4;
+   GraphicalModel::FunctionIdentifier fid2 = gm.addFunction(f2);
+   for(size_t r = 0; r < numberOfRows; ++r)
+   for(size_t c = 0; c < numberOfRows; ++c) {
+      const size_t v = r * numberOfRows + c;
+      if(c + 1 < numberOfRows) {
+         size_t variableIndices[] = {v, v + 1};
+         gm.addFactor(fid2, variableIndices, variableIndices + 2);
+      }
+      if(r + 1 < numberOfRows) {
+         size_t variableIndices[] = {v, v + numberOfRows};
+         gm.addFactor(fid2, variableIndices, variableIndices + 2);
+      }
+   }
+   size_t shape1[] = {2};
+   opengm::ExplicitFunction<double> f1(shape1, shape1 + 1);
+   f1(0) = 0.3;
+   f1(1) = 0.7;
+   {
+      size_t variableIndices[] = {0};
+      gm.addFactor(gm.addFunction(f1), variableIndices, variableIndices + 1);
+   }
+
+   const size_t seeds[] = {7, 7, 7, 8};
+   const size_t threads[] = {1, 1, 4, 1};
+   std::vector<std::vector<size_t> > counts(4);
+   std::vector<std::vector<size_t> > states(4);
+   for(size_t run = 0; run < 4; ++run) {
+      SwendsenWang::Parameter parameter(2000, 100);
+      parameter.seed_ = seeds[run];
+      parameter.numberOfThreads_ = threads[run];
+      SwendsenWang sw(gm, parameter);
+      MarginalVisitor visitor(gm);
+      for(size_t j = 0; j < gm.numberOfVariables(); ++j) {
+         visitor.addMarginal(j);
+      }
+      sw.infer(visitor);
+      for(size_t j = 0; j < gm.numberOfVariables(); ++j) {
+         counts[run].push_back(static_cast<size_t>(visitor.marginal(j)(0)));
+         states[run].push_back(sw.markovState(j));
       }
    }
+   // same seed, same chain
+   OPENGM_TEST(counts[0] == counts[1]);
+   OPENGM_TEST(states[0] == states[1]);
+   // same seed, different number of threads
+   OPENGM_TEST(counts[0] == counts[2]);
+   OPENGM_TEST(states[0] == states[2]);
+   // different seed, different chain
+   OPENGM_TEST(counts[0] != counts[3]);
 }
 
 int main() {
    { SwendsenWangTest<opengm::Multiplier, opengm::Maximizer> test; test.run(); }
    { SwendsenWangTest<opengm::Adder, opengm::Minimizer> test; test.run(); }
    biasedModelTest();
+   seedTest();
    return 0;
 }
@@ -0,0 +1,129 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include <opengm/unittests/test.hxx>
+#include <opengm/graphicalmodel/graphicalmodel.hxx>
+#include <opengm/graphicalmodel/graphicalmodel_hdf5.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/operations/minimizer.hxx>
+#include <opengm/functions/explicit_function.hxx>
+#include <opengm/utilities/metaprogramming.hxx>
+
+#include "../interfaces/commandline/batch_interface.hxx"
+#include "../interfaces/common/caller/icm_caller.hxx"
+#include "../interfaces/common/caller/bruteforce_caller.hxx"
+
+typedef opengm::GraphicalModel<
+   double,
+   opengm::Adder,
+   opengm::meta::TypeListGenerator<opengm::ExplicitFunction<double> >::type,
+   opengm::DiscreteSpace<size_t, size_t>
+> GmType;
+
+typedef opengm::meta::TypeListGenerator<
+   opengm::interface::ICMCaller<opengm::interface::IOCMD, GmType, opengm::Minimizer>,
+   opengm::interface::BruteforceCaller<opengm::interface::IOCMD, GmType, opengm::Minimizer>
+>::type InferenceTypeList;
+
+// runs the batch interface with the given command line
+int runBatch(const std::vector<std::string>& arguments) {
+   std::vector<std::vector<char> > storage(arguments.size());
+   std::vector<char*> argv(arguments.size());
+   for(size_t j = 0; j < arguments.size(); ++j) {
+      storage[j].assign(arguments[j].begin(), arguments[j].end());
+      storage[j].push_back('\0');
+      argv[j] = &storage[j][0];
+   }
+   typedef opengm::interface::BatchInterface<GmType, InferenceTypeList> BatchType;
+   OPENGM_TEST((BatchType::requested(static_cast<int>(argv.size()), &argv[0])));
+   BatchType batch(static_cast<int>(argv.size()), &argv[0]);
+   return batch.run();
+}
+
+// status column of the summary, one entry per job
+std::vector<std::string> readStatus(const std::string& summary) {
+   std::ifstream file(summary.c_str());
+   OPENGM_TEST(file.good());
+   std::vector<std::string> status;
+   std::string line;
+   std::getline(file, line); // header
+   while(std::getline(file, line)) {
+      std::vector<std::string> fields;
+      std::stringstream stream(line);
+      std::string field;
+      while(std::getline(stream, field, ',')) {
+         fields.push_back(field);
+      }
+      OPENGM_TEST(fields.size() == 8);
+      status.push_back(fields[4]);
+   }
+   return status;
+}
+
+int main() {
+   std::cout << "Batch Interface Test..." << std::endl;
+
+   // chain with 4 variables and 3 labels
+   const size_t numbersOfLabels[] = {3, 3, 3, 3};
+   GmType gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels, numbersOfLabels + 4));
+   for(size_t v = 0; v < 4; ++v) {
+      opengm::ExplicitFunction<double> f(numbersOfLabels, numbersOfLabels + 1);
+      for(size_t l = 0; l < 3; ++l) {
+         f(l) = static_cast<double>((v + l) % 3);
+      }
+      const size_t variableIndices[] = {v};
+      gm.addFactor(gm.addFunction(f), variableIndices, variableIndices + 1);
+   }
+   for(size_t v = 0; v + 1 < 4; ++v) {
+      opengm::ExplicitFunction<double> f(numbersOfLabels, numbersOfLabels + 2);
+      for(size_t l0 = 0; l0 < 3; ++l0) {
+         for(size_t l1 = 0; l1 < 3; ++l1) {
+            f(l0, l1) = l0 == l1 ? 0.0 : 0.5;
+         }
+      }
+      const size_t variableIndices[] = {v, v + 1};
+      gm.addFactor(gm.addFunction(f), variableIndices, variableIndices + 2);
+   }
+   opengm::hdf5::save(gm, "test_batch_interface_model.h5", "gm");
+
+   {
+      std::cout << "  * failing jobs do not stop the batch" << std::endl;
+      std::ofstream manifest("test_batch_interface_manifest.txt");
+      manifest << "# model output algorithm" << std::endl;
+      manifest << "test_batch_interface_model.h5:gm test_batch_interface_icm.h5 ICM" << std::endl;
+      manifest << "test_batch_interface_missing.h5:gm test_batch_interface_missing_model.h5 ICM" << std::endl;
+      manifest << "test_batch_interface_model.h5:gm test_batch_interface_missing_directory/result.h5 ICM" << std::endl;
+      manifest << "test_batch_interface_model.h5:gm test_batch_interface_unknown.h5 UNKNOWN" << std::endl;
+      manifest << "test_batch_interface_model.h5:gm test_batch_interface_bruteforce.h5 BRUTEFORCE" << std::endl;
+      manifest.close();
+
+      std::vector<std::string> arguments;
+      arguments.push_back("opengm");
+      arguments.push_back("--batch");
+      arguments.push_back("test_batch_interface_manifest.txt");
+      arguments.push_back("--summary");
+      arguments.push_back("test_batch_interface_summary.csv");
+      arguments.push_back("--threads");
+      arguments.push_back("2");
+      OPENGM_TEST_EQUAL(runBatch(arguments), 1);
+
+      const std::vector<std::string> status = readStatus("test_batch_interface_summary.csv");
+      OPENGM_TEST_EQUAL(status.size(), 5);
+      OPENGM_TEST(status[0] == "ok");
+      OPENGM_TEST(status[1] == "failed");
+      OPENGM_TEST(status[2] == "failed");
+      OPENGM_TEST(status[3] == "failed");
+      OPENGM_TEST(status[4] == "ok");
+
+      // the results of the successful jobs are stored
+      std::vector<size_t> states;
+      opengm::interface::IOCMD io(0, NULL);
+      io.loadVector("test_batch_interface_bruteforce.h5:states", states);
+      OPENGM_TEST_EQUAL(states.size(), gm.numberOfVariables());
+   }
+   std::cout << "done!" << std::endl;
+   return 0;
+}
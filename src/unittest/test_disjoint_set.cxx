@@ -0,0 +1,114 @@
+#include <vector>
+#include <cstddef>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
+#include "opengm/unittests/test.hxx"
+#include "opengm/utilities/disjoint-set.hxx"
+#include "opengm/utilities/random.hxx"
+
+struct TestDisjointSet{
+
+   // random edges between the elements, drawn reproducibly
+   void randomEdges(const size_t numberOfElements, const size_t numberOfEdges, const size_t seed, std::vector<size_t>& edges) {
+      opengm::CounterBasedRandom random(seed);
+      edges.resize(2 * numberOfEdges);
+      for(size_t e = 0; e < edges.size(); ++e) {
+         edges[e] = random.uniformInteger(numberOfElements);
+      }
+   }
+
+   void testSequential() {
+      opengm::concurrent_disjoint_set<size_t> sets(5);
+      OPENGM_TEST_EQUAL(sets.numberOfElements(), 5);
+      for(size_t i = 0; i < 5; ++i) {
+         OPENGM_TEST_EQUAL(sets.find(i), i);
+      }
+      OPENGM_TEST(sets.join(3, 4));
+      OPENGM_TEST(sets.join(4, 1));
+      OPENGM_TEST(!sets.join(1, 3));
+      OPENGM_TEST(!sets.join(2, 2));
+      // the representative of a set is its smallest element
+      OPENGM_TEST_EQUAL(sets.find(4), 1);
+      OPENGM_TEST_EQUAL(sets.find(3), 1);
+      OPENGM_TEST_EQUAL(sets.find(1), 1);
+      OPENGM_TEST_EQUAL(sets.find(0), 0);
+      OPENGM_TEST_EQUAL(sets.find(2), 2);
+
+      sets.reset();
+      for(size_t i = 0; i < 5; ++i) {
+         OPENGM_TEST_EQUAL(sets.find(i), i);
+      }
+      sets.reset(7);
+      OPENGM_TEST_EQUAL(sets.numberOfElements(), 7);
+      OPENGM_TEST_EQUAL(sets.find(6), 6);
+   }
+
+   // concurrent joins must yield the partition of sequential joins
+   void testConcurrent(const size_t numberOfElements, const size_t numberOfEdges, const int numberOfThreads) {
+      std::vector<size_t> edges;
+      randomEdges(numberOfElements, numberOfEdges, numberOfEdges, edges);
+
+      opengm::disjoint_set<size_t> reference(numberOfElements);
+      for(size_t e = 0; e < numberOfEdges; ++e) {
+         reference.join(edges[2 * e], edges[2 * e + 1]);
+      }
+      // smallest element of each reference set
+      std::vector<size_t> smallest(numberOfElements, numberOfElements);
+      for(size_t i = 0; i < numberOfElements; ++i) {
+         const size_t root = reference.find(i);
+         if(i < smallest[root]) {
+            smallest[root] = i;
+         }
+      }
+
+      opengm::concurrent_disjoint_set<size_t> sets(numberOfElements);
+      for(size_t run = 0; run < 3; ++run) {
+         sets.reset();
+         std::vector<unsigned char> merged(numberOfEdges, 0);
+         #ifdef WITH_OPENMP
+         #pragma omp parallel for schedule(dynamic, 64) num_threads(numberOfThreads)
+         #endif
+         for(std::ptrdiff_t e = 0; e < static_cast<std::ptrdiff_t>(numberOfEdges); ++e) {
+            merged[e] = sets.join(edges[2 * e], edges[2 * e + 1]) ? 1 : 0;
+         }
+         // every successful join merges two sets
+         size_t numberOfJoins = 0;
+         for(size_t e = 0; e < numberOfEdges; ++e) {
+            numberOfJoins += merged[e];
+         }
+         OPENGM_TEST_EQUAL(numberOfElements - numberOfJoins, reference.numberOfSets());
+         // concurrent finds while the structure is only read
+         std::vector<size_t> representatives(numberOfElements);
+         #ifdef WITH_OPENMP
+         #pragma omp parallel for num_threads(numberOfThreads)
+         #endif
+         for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(numberOfElements); ++i) {
+            representatives[i] = sets.find(i);
+         }
+         for(size_t i = 0; i < numberOfElements; ++i) {
+            OPENGM_TEST_EQUAL(representatives[i], smallest[reference.find(i)]);
+         }
+      }
+   }
+
+   void run() {
+      testSequential();
+      testConcurrent(1000, 500, 4);
+      testConcurrent(100000, 90000, 4);
+      // few large sets, many joins race on the same roots
+      testConcurrent(1000, 20000, 8);
+   }
+};
+
+int main() {
+   std::cout << "Disjoint Set test...  " << std::endl;
+   {
+      TestDisjointSet t;
+      t.run();
+   }
+   std::cout << "done.." << std::endl;
+   return 0;
+}
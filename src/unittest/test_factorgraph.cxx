@@ -703,6 +703,76 @@ void testIsGrid()
    }
 }
 
+void testCachedAdjacency()
+{
+   // chain 0-1-2 plus a third order factor on 1,2,3
+   size_t numbersOfStates[] = {2, 2, 2, 2, 2};
+   GraphicalModel gm(opengm::DiscreteSpace<size_t,size_t>(numbersOfStates, numbersOfStates + 4));
+   Function f2(numbersOfStates, numbersOfStates + 2);
+   Function f3(numbersOfStates, numbersOfStates + 3);
+   FID fid2 = gm.addFunction(f2);
+   FID fid3 = gm.addFunction(f3);
+   size_t vi[] = {0, 1, 2, 3};
+   gm.addFactor(fid2, vi, vi + 2);
+   gm.addFactor(fid2, vi + 1, vi + 3);
+   gm.addFactor(fid3, vi + 1, vi + 4);
+
+   const FactorGraph::AdjacencyType& variableAdjacency = gm.variableAdjacency();
+   OPENGM_TEST(variableAdjacency.numberOfNodes() == 4);
+   for(size_t j=0; j<gm.numberOfVariables(); ++j) {
+      std::set<size_t> expected;
+      for(size_t k=0; k<gm.numberOfVariables(); ++k) {
+         if(gm.variableVariableConnection(j, k)) {
+            expected.insert(k);
+         }
+         OPENGM_TEST(variableAdjacency.connected(j, k) == gm.variableVariableConnection(j, k));
+      }
+      OPENGM_TEST(variableAdjacency[j].size() == expected.size());
+      OPENGM_TEST(std::equal(expected.begin(), expected.end(), variableAdjacency[j].begin()));
+   }
+   // the cache is reused
+   OPENGM_TEST(&gm.variableAdjacency() == &variableAdjacency);
+   OPENGM_TEST(gm.variableAdjacency()[1].begin() == variableAdjacency[1].begin());
+
+   // factor adjacency: factors sharing a variable
+   const FactorGraph::AdjacencyType& factorAdjacency = gm.factorAdjacency();
+   OPENGM_TEST(factorAdjacency.numberOfNodes() == 3);
+   OPENGM_TEST(factorAdjacency[0].size() == 2);
+   OPENGM_TEST(factorAdjacency[1].size() == 2);
+   OPENGM_TEST(factorAdjacency[2].size() == 2);
+   OPENGM_TEST(factorAdjacency.connected(0, 2));
+   {
+      std::vector<std::set<size_t> > list;
+      gm.factorAdjacencyList(list);
+      OPENGM_TEST(list.size() == 3);
+      OPENGM_TEST(list[0].size() == 2 && list[0].count(1) == 1 && list[0].count(2) == 1);
+   }
+
+   // second order adjacency with the connecting factors
+   const FactorGraph::AdjacencyType& secondOrderAdjacency = gm.secondOrderAdjacency();
+   OPENGM_TEST(secondOrderAdjacency[0].size() == 1);
+   OPENGM_TEST(secondOrderAdjacency[0][0] == 1);
+   OPENGM_TEST(secondOrderAdjacency.edges(0)[0] == 0);
+   OPENGM_TEST(secondOrderAdjacency[1].size() == 2);
+   OPENGM_TEST(secondOrderAdjacency[1][1] == 2);
+   OPENGM_TEST(secondOrderAdjacency.edges(1)[1] == 1);
+   OPENGM_TEST(secondOrderAdjacency[3].size() == 0);
+
+   // adding a factor invalidates the cache
+   OPENGM_TEST(!gm.variableAdjacency().connected(0, 3));
+   gm.addFactor(fid2, vi + 2, vi + 4);
+   size_t vi03[] = {0, 3};
+   gm.addFactor(fid2, vi03, vi03 + 2);
+   OPENGM_TEST(gm.variableAdjacency().connected(0, 3));
+   OPENGM_TEST(gm.secondOrderAdjacency()[3].size() == 2);
+   OPENGM_TEST(gm.factorAdjacency().numberOfNodes() == 5);
+
+   // a copy has its own cache
+   GraphicalModel copy(gm);
+   OPENGM_TEST(&copy.variableAdjacency() != &gm.variableAdjacency());
+   OPENGM_TEST(copy.variableAdjacency().numberOfEntries() == gm.variableAdjacency().numberOfEntries());
+}
+
 int main() {
    // build graphical model for testing
    std::vector<size_t> numbersOfStates(4, 2);
@@ -1029,6 +1099,7 @@ int main() {
    testIsChain();
    testIsConnected();
    testIsGrid();
+   testCachedAdjacency();
 
    return 0;
 }
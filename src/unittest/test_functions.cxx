@@ -15,6 +15,7 @@
 #include "opengm/functions/singlesitefunction.hxx"
 #include "opengm/functions/view_fix_variables_function.hxx"
 #include "opengm/functions/fieldofexperts.hxx"
+#include "opengm/functions/sparsemarray.hxx"
 
 #include <opengm/unittests/test.hxx>
 #include <opengm/graphicalmodel/graphicalmodel.hxx>
@@ -476,6 +477,41 @@ struct FunctionsTest {
       i[1]=1;
       OPENGM_TEST(fv(i)==6);
    }
+   template<class CONTAINER>
+   void testSparseFunction(const std::string& containerName) {
+      std::cout << "  * SparseFunction (" << containerName << ")" << std::endl;
+      typedef opengm::SparseFunction<T,size_t,size_t> MapFunctionType;
+      typedef opengm::SparseFunction<T,size_t,size_t,CONTAINER> FunctionType;
+      size_t shape[] = {4, 5, 3};
+      FunctionType f(shape, shape+3, 7);
+      MapFunctionType fm(shape, shape+3, 7);
+      OPENGM_TEST(f.dimension()==3);
+      OPENGM_TEST(f.size()==60);
+      // insert out of order to exercise all insertion paths
+      for(size_t n=0; n<60; n+=7) {
+         const size_t key = (n*13)%60;
+         size_t c[3];
+         f.keyToCoordinate(key, c);
+         f.insert(c, static_cast<T>(key));
+         fm.insert(c, static_cast<T>(key));
+      }
+      OPENGM_TEST(f.container().size()==fm.container().size());
+      opengm::ShapeWalker<size_t*> walker(shape, 3);
+      for(size_t i=0; i<f.size(); ++i, ++walker) {
+         OPENGM_TEST(f(walker.coordinateTuple().begin())==fm(walker.coordinateTuple().begin()));
+      }
+      // freeze the map based function into the flat container
+      FunctionType frozen(fm);
+      OPENGM_TEST(frozen.container().size()==fm.container().size());
+      OPENGM_TEST(frozen.defaultValue()==fm.defaultValue());
+      walker.reset();
+      for(size_t i=0; i<f.size(); ++i, ++walker) {
+         OPENGM_TEST(frozen(walker.coordinateTuple().begin())==fm(walker.coordinateTuple().begin()));
+      }
+      testSerialization(f);
+      testProperties(f);
+   }
+
    void testSquaredDifference() {
       std::cout << "  * SquaredDiffrence" << std::endl;
       opengm::SquaredDifferenceFunction<T> f(4,4);
@@ -755,6 +791,9 @@ struct FunctionsTest {
       testView();
       testViewAndFixVariables();
       testSingleSiteFunction();
+      testSparseFunction<std::map<size_t,T> >("std::map");
+      testSparseFunction<opengm::OpenAddressingMap<size_t,T> >("OpenAddressingMap");
+      testSparseFunction<opengm::SortedArrayMap<size_t,T> >("SortedArrayMap");
    }
    void run2() {
       testFoE();
@@ -1,4 +1,6 @@
 #include <vector>
+#include <limits>
+#include <cstdlib>
 
 #include <opengm/functions/explicit_function.hxx>
 #include <opengm/functions/l_potts.hxx>
@@ -9,6 +11,8 @@
 #include <opengm/operations/multiplier.hxx>
 #include <opengm/inference/bruteforce.hxx>
 #include <opengm/utilities/metaprogramming.hxx>
+#include <opengm/operations/adder.hxx>
+#include <opengm/learning/gradient_accumulator.hxx>
 
 
 struct TestFunctor{
@@ -95,8 +99,96 @@ struct GraphicalModelTest {
       OPENGM_ASSERT_OP(lPotts(labels10),<,3.01);
    }
 
+   void testLossAugmentedGradient() {
+      typedef typename opengm::meta::TypeListGenerator
+         <
+         opengm::ExplicitFunction<T,I,L>,
+         opengm::LPottsFunction<T,I,L>
+         >::type FunctionTypeList;
+      typedef opengm::GraphicalModel<T, opengm::Adder, FunctionTypeList, opengm::DiscreteSpace<I, L> > GmType;
+      typedef opengm::learning::LossAugmentedModel<GmType> LossAugmentedModelType;
+      typedef typename LossAugmentedModelType::GmType LossAugmentedGmType;
+      typedef opengm::Bruteforce<LossAugmentedGmType, opengm::Minimizer> InfType;
+      typedef opengm::learning::LossAugmentedGradient<GmType, InfType> GradientType;
+      typedef opengm::ExplicitFunction<T,I,L> EF;
+      typedef opengm::LPottsFunction<T,I,L> LPF;
+
+      // two parameters: weight of the horizontal and of the vertical potts terms
+      opengm::Parameters<T,I> param(2);
+      param.setParameter(0, 0.5);
+      param.setParameter(1, 0.25);
+
+      // dataset of 2x2 grids with random unaries
+      const size_t numberOfModels = 5;
+      const L numberOfLabels = 3;
+      std::vector<GmType> models;
+      std::vector<std::vector<L> > groundTruth(numberOfModels, std::vector<L>(4));
+      srand(0);
+      for(size_t n = 0; n < numberOfModels; ++n) {
+         L nos[] = {numberOfLabels, numberOfLabels, numberOfLabels, numberOfLabels};
+         GmType gm(opengm::DiscreteSpace<I, L>(nos, nos + 4));
+         for(I v = 0; v < 4; ++v) {
+            EF unary(nos, nos + 1);
+            for(L l = 0; l < numberOfLabels; ++l) {
+               unary(l) = static_cast<T>(rand() % 100) / 100;
+            }
+            gm.addFactor(gm.addFunction(unary), &v, &v + 1);
+            groundTruth[n][v] = static_cast<L>(rand()) % numberOfLabels;
+         }
+         const I pairs[4][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}};
+         for(size_t p = 0; p < 4; ++p) {
+            LPF potts(numberOfLabels, numberOfLabels, param, p < 2 ? 0 : 1);
+            gm.addFactor(gm.addFunction(potts), pairs[p], pairs[p] + 2);
+         }
+         models.push_back(gm);
+      }
+
+      for(size_t lw = 0; lw < 2; ++lw) {
+         // reference by enumeration
+         std::vector<T> refGradient(2, 0);
+         T refLoss = 0;
+         for(size_t n = 0; n < numberOfModels; ++n) {
+            const GmType& gm = models[n];
+            std::vector<L> best(4), x(4, 0);
+            T bestValue = std::numeric_limits<T>::infinity();
+            for(size_t i = 0; i < 81; ++i) {
+               size_t c = i;
+               T value = 0;
+               for(I v = 0; v < 4; ++v) {
+                  x[v] = c % numberOfLabels;
+                  c /= numberOfLabels;
+                  value -= (x[v] != groundTruth[n][v] ? static_cast<T>(lw) : 0);
+               }
+               value += gm.evaluate(x.begin());
+               if(value < bestValue) {
+                  bestValue = value;
+                  best = x;
+               }
+            }
+            refLoss += gm.evaluate(groundTruth[n].begin()) - bestValue;
+            const I pairs[4][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}};
+            for(size_t p = 0; p < 4; ++p) {
+               refGradient[p < 2 ? 0 : 1] += (groundTruth[n][pairs[p][0]] != groundTruth[n][pairs[p][1]] ? 1 : 0);
+               refGradient[p < 2 ? 0 : 1] -= (best[pairs[p][0]] != best[pairs[p][1]] ? 1 : 0);
+            }
+         }
+
+         for(size_t threads = 1; threads < 4; ++threads) {
+            typename GradientType::Parameter gradientParam(typename InfType::Parameter(), static_cast<T>(lw), threads);
+            GradientType gradient(param, gradientParam);
+            std::vector<T> g;
+            const T loss = gradient(models, groundTruth, g);
+            OPENGM_TEST_EQUAL(g.size(), 2);
+            OPENGM_TEST_EQUAL_TOLERANCE(loss, refLoss, 0.0001);
+            OPENGM_TEST_EQUAL_TOLERANCE(g[0], refGradient[0], 0.0001);
+            OPENGM_TEST_EQUAL_TOLERANCE(g[1], refGradient[1], 0.0001);
+         }
+      }
+   }
+
    void run() {
       this->test1();
+      this->testLossAugmentedGradient();
    }
 };
 
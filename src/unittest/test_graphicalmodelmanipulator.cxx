@@ -79,10 +79,108 @@ struct ManipulatorTest {
       OPENGM_TEST_EQUAL(l2x.size(),l1.size());
       for(IndexType i=0; i<l1.size();++i)
          OPENGM_ASSERT(l1[i]==l2x[i]);
+
+      std::cout << "build sub-models with several threads ..."<<std::endl;
+      gmm.buildModifiedSubModels(2);
+      OPENGM_TEST_EQUAL(gmm.numberOfSubmodels(), 2);
+      OPENGM_TEST_EQUAL(gmm.getModifiedSubModel(0).numberOfFactors(), gm2a.numberOfFactors());
+      OPENGM_TEST_EQUAL(gmm.getModifiedSubModel(1).numberOfFactors(), gm2b.numberOfFactors());
+      v = gmm.getModifiedSubModel(0).evaluate(l2a) + gmm.getModifiedSubModel(1).evaluate(l2b);
+      OPENGM_TEST_EQUAL_TOLERANCE(gm.evaluate(l1), v, 0.000001);
       
 
       return;
    }
+
+   void testIncremental() {
+      // 8x8 grid
+      const IndexType width = 8;
+      std::vector<LabelType> nos(width*width,2);
+      GraphicalModelType gm(opengm::DiscreteSpace<IndexType,LabelType>(nos.begin(), nos.end()));
+      for (IndexType var=0; var<gm.numberOfVariables(); ++var){
+         ExplicitFunctionType f(&nos[var], &nos[var]+1);
+         f(0) = var%7; f(1) = var%5;
+         gm.addFactor(gm.addFunction(f), &var, (&var)+1);
+         for(IndexType d=1; d<=width; d+=width-1){
+            if((d==1 && var%width+1<width) || (d==width && var+width<gm.numberOfVariables())){
+               ExplicitFunctionType g(&nos[var], &nos[var]+2);
+               g(0,0) = 0; g(0,1) = 1+var%3; g(1,0) = 2; g(1,1) = var%2;
+               IndexType vars[2]; vars[0]=var; vars[1]=var+d;
+               gm.addFactor(gm.addFunction(g), vars, vars+2);
+            }
+         }
+      }
+
+      for(size_t m=0; m<2; ++m){
+         const opengm::GraphicalModelManipulator<GraphicalModelType>::ManipulationMode mode = 
+            m==0 ? opengm::GraphicalModelManipulator<GraphicalModelType>::FIX : opengm::GraphicalModelManipulator<GraphicalModelType>::DROP;
+         opengm::GraphicalModelManipulator<GraphicalModelType> incremental(gm, mode);
+         incremental.setIncrementalUpdates(true);
+         std::vector<bool> fixed(gm.numberOfVariables(),false);
+         std::vector<LabelType> fixedLabel(gm.numberOfVariables(),0);
+         size_t rebuilt = 0, built = 0;
+         // separating column and row, then free and refix single variables
+         for(IndexType i=0; i<width; ++i){
+            fixed[3*width+i]=true;
+            fixed[i*width+3]=true;
+         }
+         for(size_t step=0; step<12; ++step){
+            if(step>0){
+               const IndexType var = (step*37)%gm.numberOfVariables();
+               fixed[var] = !fixed[var];
+               fixedLabel[var] = step%2;
+            }
+            opengm::GraphicalModelManipulator<GraphicalModelType> reference(gm, mode);
+            incremental.unlock();
+            for(IndexType var=0; var<gm.numberOfVariables(); ++var){
+               if(fixed[var]){
+                  incremental.fixVariable(var, fixedLabel[var]);
+                  reference.fixVariable(var, fixedLabel[var]);
+               }
+            }
+            incremental.lock();
+            reference.lock();
+            incremental.buildModifiedSubModels();
+            reference.buildModifiedSubModels();
+            OPENGM_TEST_EQUAL(incremental.numberOfSubmodels(), reference.numberOfSubmodels());
+            if(step==0){
+               OPENGM_TEST_EQUAL(incremental.numberOfSubmodels(), 4);
+            }
+            OPENGM_TEST(incremental.numberOfRebuiltSubmodels() <= incremental.numberOfSubmodels());
+            rebuilt += incremental.numberOfRebuiltSubmodels();
+            built   += reference.numberOfRebuiltSubmodels();
+
+            std::vector<std::vector<LabelType> > subLabels(reference.numberOfSubmodels());
+            for(size_t i=0; i<reference.numberOfSubmodels(); ++i){
+               const opengm::GraphicalModelManipulator<GraphicalModelType>::MGM& a = incremental.getModifiedSubModel(i);
+               const opengm::GraphicalModelManipulator<GraphicalModelType>::MGM& b = reference.getModifiedSubModel(i);
+               OPENGM_TEST_EQUAL(a.numberOfVariables(), b.numberOfVariables());
+               OPENGM_TEST_EQUAL(a.numberOfFactors(), b.numberOfFactors());
+               subLabels[i].resize(a.numberOfVariables());
+               for(size_t n=0; n<4; ++n){
+                  for(IndexType v=0; v<a.numberOfVariables(); ++v){
+                     subLabels[i][v] = (v*3+n+i)%2;
+                  }
+                  OPENGM_TEST_EQUAL_TOLERANCE(a.evaluate(subLabels[i]), b.evaluate(subLabels[i]), 0.000001);
+               }
+            }
+            std::vector<LabelType> la, lb;
+            incremental.modifiedSubStates2OriginalState(subLabels, la);
+            reference.modifiedSubStates2OriginalState(subLabels, lb);
+            OPENGM_TEST(la == lb);
+            std::vector<std::vector<LabelType> > restricted;
+            incremental.originalState2ModifiedSubStates(la, restricted);
+            OPENGM_TEST(restricted == subLabels);
+            size_t rebuiltFlags = 0;
+            for(size_t i=0; i<incremental.numberOfSubmodels(); ++i){
+               if(incremental.isRebuiltSubmodel(i)) ++rebuiltFlags;
+            }
+            OPENGM_TEST_EQUAL(rebuiltFlags, incremental.numberOfRebuiltSubmodels());
+            OPENGM_TEST(incremental.isRebuiltSubmodel(0));
+         }
+         OPENGM_TEST(rebuilt < built);
+      }
+   }
   
 
 };
@@ -94,6 +192,7 @@ int main() {
    { 
       ManipulatorTest t;
       t.test();
+      t.testIncremental();
    }
    
    std::cout << "done.." << std::endl;
@@ -0,0 +1,177 @@
+#include <vector>
+#include <cstdlib>
+
+#include "opengm/unittests/test.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+#include "opengm/graphicalmodel/grid_graphicalmodel.hxx"
+#include "opengm/operations/adder.hxx"
+#include "opengm/operations/minimizer.hxx"
+#include "opengm/inference/bruteforce.hxx"
+#include "opengm/inference/icm.hxx"
+#include "opengm/inference/messagepassing/messagepassing.hxx"
+
+typedef opengm::GridGraphicalModel<double, opengm::Adder> GridModel;
+typedef opengm::GraphicalModel<double, opengm::Adder> Model;
+typedef opengm::ExplicitFunction<double> Function;
+
+// builds a random grid model and the equivalent explicit model
+void build(const size_t dimX, const size_t dimY, const size_t numberOfLabels, GridModel& grid, Model& gm) {
+   grid.assign(dimX, dimY, numberOfLabels);
+   for(size_t v = 0; v < grid.numberOfVariables(); ++v) {
+      for(size_t l = 0; l < numberOfLabels; ++l) {
+         grid.unary(v, l) = static_cast<double>(rand() % 100) / 10.0;
+      }
+   }
+   const size_t shape[] = {numberOfLabels, numberOfLabels};
+   Function horizontal(shape, shape + 2, 1.5);
+   Function vertical(shape, shape + 2);
+   for(size_t j = 0; j < numberOfLabels; ++j) {
+      horizontal(j, j) = 0.0;
+      for(size_t k = 0; k < numberOfLabels; ++k) {
+         vertical(j, k) = static_cast<double>(rand() % 100) / 20.0;
+      }
+   }
+   grid.setPairwiseFunction(GridModel::Horizontal, horizontal);
+   grid.setPairwiseFunction(GridModel::Vertical, vertical);
+
+   std::vector<size_t> numbersOfLabels(grid.numberOfVariables(), numberOfLabels);
+   gm = Model(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels.begin(), numbersOfLabels.end()));
+   for(size_t v = 0; v < grid.numberOfVariables(); ++v) {
+      Function f(shape, shape + 1);
+      for(size_t l = 0; l < numberOfLabels; ++l) {
+         f(l) = grid.unary(v, l);
+      }
+      gm.addFactor(gm.addFunction(f), &v, &v + 1);
+   }
+   const Model::FunctionIdentifier fh = gm.addFunction(horizontal);
+   const Model::FunctionIdentifier fv = gm.addFunction(vertical);
+   for(size_t y = 0; y < dimY; ++y) {
+      for(size_t x = 0; x + 1 < dimX; ++x) {
+         const size_t vi[] = {grid.variableIndex(x, y), grid.variableIndex(x + 1, y)};
+         gm.addFactor(fh, vi, vi + 2);
+      }
+   }
+   for(size_t y = 0; y + 1 < dimY; ++y) {
+      for(size_t x = 0; x < dimX; ++x) {
+         const size_t vi[] = {grid.variableIndex(x, y), grid.variableIndex(x, y + 1)};
+         gm.addFactor(fv, vi, vi + 2);
+      }
+   }
+}
+
+void testStructure() {
+   GridModel grid;
+   Model gm;
+   build(5, 4, 3, grid, gm);
+
+   OPENGM_TEST_EQUAL(grid.numberOfVariables(), gm.numberOfVariables());
+   OPENGM_TEST_EQUAL(grid.numberOfFactors(), gm.numberOfFactors());
+   OPENGM_TEST_EQUAL(grid.factorOrder(), 2);
+   for(size_t f = 0; f < gm.numberOfFactors(); ++f) {
+      OPENGM_TEST_EQUAL(grid.numberOfVariables(f), gm.numberOfVariables(f));
+      OPENGM_TEST_EQUAL(grid[f].numberOfVariables(), gm[f].numberOfVariables());
+      for(size_t j = 0; j < gm.numberOfVariables(f); ++j) {
+         OPENGM_TEST_EQUAL(grid.variableOfFactor(f, j), gm.variableOfFactor(f, j));
+         OPENGM_TEST_EQUAL(grid[f].variableIndex(j), gm[f].variableIndex(j));
+         OPENGM_TEST_EQUAL(grid[f].shape(j), gm[f].shape(j));
+      }
+      // iterators of different temporaries can be compared
+      OPENGM_TEST(std::equal(grid[f].variableIndicesBegin(), grid[f].variableIndicesEnd(), gm[f].variableIndicesBegin()));
+      OPENGM_TEST_EQUAL(grid[f].isPotts(), gm[f].isPotts());
+      OPENGM_TEST_EQUAL_TOLERANCE(grid[f].min(), gm[f].min(), 1e-12);
+      OPENGM_TEST_EQUAL_TOLERANCE(grid[f].sum(), gm[f].sum(), 1e-12);
+      std::vector<double> a(gm[f].size()), b(gm[f].size());
+      grid[f].copyValues(a.begin());
+      gm[f].copyValues(b.begin());
+      for(size_t j = 0; j < a.size(); ++j) {
+         OPENGM_TEST_EQUAL_TOLERANCE(a[j], b[j], 1e-12);
+      }
+   }
+   for(size_t v = 0; v < gm.numberOfVariables(); ++v) {
+      OPENGM_TEST_EQUAL(grid.numberOfFactors(v), gm.numberOfFactors(v));
+      for(size_t j = 0; j < gm.numberOfFactors(v); ++j) {
+         OPENGM_TEST_EQUAL(grid.factorOfVariable(v, j), gm.factorOfVariable(v, j));
+      }
+   }
+   OPENGM_TEST_EQUAL(grid.factorIndex(GridModel::Horizontal, 1, 2), 20 + 2 * 4 + 1);
+   OPENGM_TEST_EQUAL(grid.factorIndex(GridModel::Vertical, 1, 2), 20 + 16 + 11);
+   OPENGM_TEST(grid.direction(grid.factorIndex(GridModel::Vertical, 0, 0)) == GridModel::Vertical);
+
+   // factor graph interface
+   OPENGM_TEST(!grid.isAcyclic());
+   OPENGM_TEST_EQUAL(grid.variableAdjacency()[grid.variableIndex(2, 2)].size(), 4);
+   OPENGM_TEST_EQUAL(grid.variableAdjacency()[0].size(), 2);
+
+   // lattice layout, as detected for the explicit model
+   marray::Matrix<size_t> layout;
+   OPENGM_TEST(grid.isGrid(layout));
+   OPENGM_TEST_EQUAL(layout.shape(0), 5);
+   OPENGM_TEST_EQUAL(layout(3, 2), grid.variableIndex(3, 2));
+   OPENGM_TEST(gm.isGrid(layout));
+
+   // label-major unaries
+   OPENGM_TEST_EQUAL(grid.unaries()[2 * grid.numberOfVariables() + 7], grid.unary(7, 2));
+
+   std::vector<size_t> labeling(gm.numberOfVariables());
+   for(size_t n = 0; n < 10; ++n) {
+      for(size_t v = 0; v < labeling.size(); ++v) {
+         labeling[v] = rand() % 3;
+      }
+      OPENGM_TEST_EQUAL_TOLERANCE(grid.evaluate(labeling.begin()), gm.evaluate(labeling.begin()), 1e-9);
+   }
+
+   bool thrown = false;
+   try {
+      const size_t shape[] = {2, 2};
+      grid.setPairwiseFunction(GridModel::Horizontal, Function(shape, shape + 2));
+   }
+   catch(opengm::RuntimeError&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+void testInference() {
+   GridModel grid;
+   Model gm;
+   build(3, 3, 2, grid, gm);
+   {
+      opengm::Bruteforce<GridModel, opengm::Minimizer> a(grid);
+      opengm::Bruteforce<Model, opengm::Minimizer> b(gm);
+      a.infer();
+      b.infer();
+      OPENGM_TEST_EQUAL_TOLERANCE(a.value(), b.value(), 1e-9);
+   }
+   {
+      opengm::ICM<GridModel, opengm::Minimizer> a(grid);
+      opengm::ICM<Model, opengm::Minimizer> b(gm);
+      a.infer();
+      b.infer();
+      std::vector<size_t> argA, argB;
+      a.arg(argA);
+      b.arg(argB);
+      OPENGM_TEST(argA == argB);
+   }
+   {
+      typedef opengm::BeliefPropagationUpdateRules<GridModel, opengm::Minimizer> UpdateRulesA;
+      typedef opengm::BeliefPropagationUpdateRules<Model, opengm::Minimizer> UpdateRulesB;
+      typedef opengm::MessagePassing<GridModel, opengm::Minimizer, UpdateRulesA, opengm::MaxDistance> BPA;
+      typedef opengm::MessagePassing<Model, opengm::Minimizer, UpdateRulesB, opengm::MaxDistance> BPB;
+      BPA a(grid, BPA::Parameter(20));
+      BPB b(gm, BPB::Parameter(20));
+      a.infer();
+      b.infer();
+      std::vector<size_t> argA, argB;
+      a.arg(argA);
+      b.arg(argB);
+      OPENGM_TEST(argA == argB);
+   }
+}
+
+int main() {
+   std::cout << "Grid Graphical Model Test... " << std::endl;
+   testStructure();
+   testInference();
+   std::cout << "done!" << std::endl;
+   return 0;
+}
@@ -7,6 +7,8 @@
 
 #include <fstream>
 #include <vector>
+#include <numeric>
+#include <cstdlib>
 #include <opengm/inference/auxiliary/primal_lpbound.hxx>
 namespace TST{
 using std::string;
@@ -181,8 +183,60 @@ double RandomDouble(double max)
 		OPENGM_ASSERT(fabs(totalval-21.9)<1e-8);
 	};
 
+	// a random 10x10 grid evaluated by one and by several threads
+	void test_PrimalLPBoundThreads()
+	{
+		const size_t width=10, numberOfLabels=3;
+		GraphicalModel gm(opengm::DiscreteSpace<>(width*width,numberOfLabels));
+		const size_t shape[]={numberOfLabels,numberOfLabels};
+		for (size_t v=0;v<width*width;++v)
+		{
+			opengm::ExplicitFunction<double> f(shape,shape+1);
+			for (size_t i=0;i<numberOfLabels;++i)
+				f(i)=(rand()%100)/10.0;
+			gm.addFactor(gm.addFunction(f),&v,&v+1);
+		}
+		for (size_t v=0;v<width*width;++v)
+			for (size_t d=1;d<=width;d+=width-1)
+			{
+				if ((v+d>=width*width) || ((d==1) && ((v+1)%width==0)))
+					continue;
+				const size_t vi[]={v,v+d};
+				opengm::ExplicitFunction<double> f(shape,shape+2);
+				for (size_t i=0;i<numberOfLabels*numberOfLabels;++i)
+					f(i)=(rand()%100)/10.0;
+				gm.addFactor(gm.addFunction(f),vi,vi+2);
+			}
+
+		LPBounder sequential(gm,LPBounder::Parameter(LPBounder::Solver::floatTypeEps,100,1));
+		LPBounder parallel(gm,LPBounder::Parameter(LPBounder::Solver::floatTypeEps,100,4));
+		std::vector<double> val(numberOfLabels);
+		for (size_t v=0;v<width*width;++v)
+		{
+			for (size_t i=0;i<numberOfLabels;++i)
+				val[i]=1.0+rand()%10;
+			const double sum=std::accumulate(val.begin(),val.end(),0.0);
+			for (size_t i=0;i<numberOfLabels;++i)
+				val[i]/=sum;
+			sequential.setVariable(v,val.begin());
+			parallel.setVariable(v,val.begin());
+		}
+
+		OPENGM_ASSERT(sequential.getTotalValue()==parallel.getTotalValue());
+		const size_t lastFactor=gm.numberOfFactors()-1;
+		OPENGM_ASSERT(parallel.IsFactorVariableBuffered(lastFactor));
+		for (size_t i=0;i<gm.numberOfFactors();++i)
+			OPENGM_ASSERT(parallel.IsValueBuffered(i));
+
+		TransportSolver::MatrixWrapper<double> matrix0(numberOfLabels,numberOfLabels), matrix1(numberOfLabels,numberOfLabels);
+		sequential.getFactorVariable(lastFactor-1,matrix0);
+		parallel.getFactorVariable(lastFactor-1,matrix1);
+		OPENGM_ASSERT(std::equal(matrix0.begin(),matrix0.end(),matrix1.begin()));
+	};
+
 int main()
 {
 	test_PrimalLPBound();
+	test_PrimalLPBoundThreads();
 	return 0;
 }
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 
 #include <opengm/opengm.hxx>
 #include <opengm/utilities/random.hxx>
@@ -22,6 +25,108 @@ int main(int argc, char** argv) {
       OPENGM_TEST(ri1() < 10);
       OPENGM_TEST(ri2() < 10);
    }
+
+   std::cout << "starting test counter-based random..." << std::endl;
+   {
+      // ranges and reproducibility
+      opengm::CounterBasedRandom r1(42, 3);
+      opengm::CounterBasedRandom r2(42, 3);
+      opengm::CounterBasedRandom r3(43, 3);
+      size_t equal = 0;
+      for(size_t i = 0; i < 100000; ++i) {
+         const double u = r1.uniform();
+         OPENGM_TEST(u >= 0 && u < 1);
+         OPENGM_TEST_EQUAL(u, r2.uniform());
+         equal += (u == r3.uniform());
+         const size_t k = r1.uniformInteger(size_t(7));
+         OPENGM_TEST(k < 7);
+         r2.discard(1);
+         r3.discard(1);
+      }
+      OPENGM_TEST(equal < 10);
+      OPENGM_TEST_EQUAL(r1.counter(), 200000);
+      // the n-th number of a stream is a pure function of (seed, stream, n)
+      opengm::CounterBasedRandom r4(42, 3);
+      r4.discard(10);
+      OPENGM_TEST_EQUAL(r4.uniform(), opengm::CounterBasedRandom::uniformAt(42, 3, 10));
+   }
+   {
+      // bulk generation draws the same numbers as single draws
+      opengm::CounterBasedRandom r1(7);
+      opengm::CounterBasedRandom r2(7);
+      std::vector<double> values(1000);
+      r1.fillUniform(values.begin(), values.end(), -1.0, 1.0);
+      for(size_t i = 0; i < values.size(); ++i) {
+         OPENGM_TEST_EQUAL(values[i], r2.uniform(-1.0, 1.0));
+      }
+      OPENGM_TEST_EQUAL(r1.uniform(), r2.uniform());
+   }
+   {
+      // split streams are reproducible and independent of the parent and of each other
+      const opengm::CounterBasedRandom root(5);
+      opengm::CounterBasedRandom a = root.split(0);
+      opengm::CounterBasedRandom b = root.split(1);
+      opengm::CounterBasedRandom c = root.split(1);
+      opengm::CounterBasedRandom d(5);
+      OPENGM_TEST_EQUAL(root.counter(), 0);
+      size_t equal = 0;
+      for(size_t i = 0; i < 10000; ++i) {
+         const opengm::UInt64Type x = b();
+         OPENGM_TEST_EQUAL(x, c());
+         const opengm::UInt64Type y = a();
+         equal += (x == y) + (y == d());
+      }
+      OPENGM_TEST_EQUAL(equal, 0);
+   }
+   {
+      // moments of the normal distribution
+      opengm::CounterBasedRandom r(11);
+      std::vector<double> values(100001);
+      r.fillNormal(values.begin(), values.end(), 2.0, 3.0);
+      double mean = 0, variance = 0;
+      for(size_t i = 0; i < values.size(); ++i) {
+         mean += values[i];
+      }
+      mean /= values.size();
+      for(size_t i = 0; i < values.size(); ++i) {
+         variance += (values[i] - mean) * (values[i] - mean);
+      }
+      variance /= values.size();
+      OPENGM_TEST_EQUAL_TOLERANCE(mean, 2.0, 0.05);
+      OPENGM_TEST_EQUAL_TOLERANCE(variance, 9.0, 0.2);
+   }
+   {
+      // frequencies of categorical draws
+      const double cumulative[] = {1.0, 1.0, 3.0, 6.0};
+      opengm::CounterBasedRandom r(13);
+      std::vector<size_t> draws(60000);
+      r.fillCategorical(cumulative, cumulative + 4, draws.begin(), draws.end());
+      std::vector<size_t> histogram(4, 0);
+      for(size_t i = 0; i < draws.size(); ++i) {
+         OPENGM_TEST(draws[i] < 4);
+         ++histogram[draws[i]];
+         ++histogram[r.categorical(cumulative, cumulative + 4)];
+      }
+      OPENGM_TEST_EQUAL(histogram[1], 0);
+      OPENGM_TEST_EQUAL_TOLERANCE(histogram[0] / 120000.0, 1.0 / 6.0, 0.01);
+      OPENGM_TEST_EQUAL_TOLERANCE(histogram[2] / 120000.0, 2.0 / 6.0, 0.01);
+      OPENGM_TEST_EQUAL_TOLERANCE(histogram[3] / 120000.0, 3.0 / 6.0, 0.01);
+   }
+   {
+      // usable as a uniform random bit generator
+      std::vector<size_t> a(100), b(100);
+      for(size_t i = 0; i < a.size(); ++i) {
+         a[i] = b[i] = i;
+      }
+      opengm::CounterBasedRandom r1(17), r2(17);
+      std::shuffle(a.begin(), a.end(), r1);
+      std::shuffle(b.begin(), b.end(), r2);
+      OPENGM_TEST(std::equal(a.begin(), a.end(), b.begin()));
+      std::sort(a.begin(), a.end());
+      for(size_t i = 0; i < a.size(); ++i) {
+         OPENGM_TEST_EQUAL(a[i], i);
+      }
+   }
    std::cout << "test random finished successfully" << std::endl;
    return 0;
 }
@@ -0,0 +1,117 @@
+#include <vector>
+#include <set>
+
+#include "opengm/unittests/test.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+#include "opengm/graphicalmodel/modelgenerators/syntheticmodelgenerator.hxx"
+#include "opengm/operations/adder.hxx"
+
+typedef opengm::GraphicalModel<double, opengm::Adder> Model;
+typedef opengm::SyntheticModelGenerator2<Model> Generator;
+
+// compares structure and all function values
+bool equal(const Model& a, const Model& b) {
+   if(a.numberOfVariables() != b.numberOfVariables() || a.numberOfFactors() != b.numberOfFactors()) {
+      return false;
+   }
+   for(size_t v = 0; v < a.numberOfVariables(); ++v) {
+      if(a.numberOfLabels(v) != b.numberOfLabels(v)) {
+         return false;
+      }
+   }
+   for(size_t f = 0; f < a.numberOfFactors(); ++f) {
+      if(a[f].numberOfVariables() != b[f].numberOfVariables() || a[f].size() != b[f].size()
+         || !std::equal(a[f].variableIndicesBegin(), a[f].variableIndicesEnd(), b[f].variableIndicesBegin())) {
+         return false;
+      }
+      std::vector<double> va(a[f].size()), vb(b[f].size());
+      a[f].copyValues(va.begin());
+      b[f].copyValues(vb.begin());
+      if(va != vb) {
+         return false;
+      }
+   }
+   return true;
+}
+
+void testDeterminism() {
+   Generator generator;
+   Generator::Parameter parameter;
+   parameter.sharedFunctions_[1] = false;
+   parameter.randomNumberOfStates_ = true;
+   parameter.numberOfThreads_ = 1;
+   const Model a = generator.buildGrid(3, 20, 30, 4, parameter);
+   parameter.numberOfThreads_ = 4;
+   const Model b = generator.buildGrid(3, 20, 30, 4, parameter);
+   OPENGM_TEST(equal(a, b));
+   const Model c = generator.buildGrid(4, 20, 30, 4, parameter);
+   OPENGM_TEST(!equal(a, c));
+   OPENGM_TEST_EQUAL(a.numberOfFactors(), 20 * 30 + 19 * 30 + 20 * 29);
+   for(size_t v = 0; v < a.numberOfVariables(); ++v) {
+      OPENGM_TEST(a.numberOfLabels(v) >= 1 && a.numberOfLabels(v) <= 4);
+   }
+   for(size_t f = 0; f < a.numberOfFactors(); ++f) {
+      OPENGM_TEST(a[f].min() >= 0.1 && a[f].max() <= 1.0);
+   }
+
+   parameter.randomNumberOfStates_ = false;
+   parameter.functionTypes_[0] = Generator::EMPTY;
+   parameter.functionTypes_[1] = Generator::RGPOTTS;
+   const Model d = generator.buildCliques(5, 50, 40, 3, 3, parameter);
+   parameter.numberOfThreads_ = 1;
+   OPENGM_TEST(equal(d, generator.buildCliques(5, 50, 40, 3, 3, parameter)));
+}
+
+void testFamilies() {
+   Generator generator;
+   Generator::Parameter parameter;
+   parameter.functionTypes_[1] = Generator::GPOTTS;
+   parameter.functionParameters_[1].assign(1, 2.0);
+   parameter.sharedFunctions_[1] = false;
+
+   // deterministic functions are shared
+   const Model grid = generator.buildGrid3D(0, 4, 3, 2, 3, parameter);
+   OPENGM_TEST_EQUAL(grid.numberOfVariables(), 24);
+   OPENGM_TEST_EQUAL(grid.numberOfFactors(), 24 + 3 * 3 * 2 + 4 * 2 * 2 + 4 * 3 * 1);
+   OPENGM_TEST_EQUAL(grid.numberOfFunctions(0), 2);
+   OPENGM_TEST_EQUAL(grid.variableOfFactor(grid.numberOfFactors() - 1, 1), 23);
+   const size_t equalLabels[] = {1, 1};
+   const size_t differentLabels[] = {0, 2};
+   OPENGM_TEST_EQUAL(grid[24](equalLabels), 0.0);
+   OPENGM_TEST_EQUAL(grid[24](differentLabels), 2.0);
+
+   parameter.functionTypes_[1] = Generator::URANDOM;
+   parameter.functionParameters_[1].assign(2, 1.0);
+   parameter.functionParameters_[1][1] = 2.0;
+   const Model regular = generator.buildRandomRegular(1, 100, 5, 2, parameter);
+   OPENGM_TEST_EQUAL(regular.numberOfFactors(), 100 + 250);
+   std::set<std::pair<size_t, size_t> > edges;
+   for(size_t f = 100; f < regular.numberOfFactors(); ++f) {
+      OPENGM_TEST(regular.variableOfFactor(f, 0) < regular.variableOfFactor(f, 1));
+      edges.insert(std::make_pair(regular.variableOfFactor(f, 0), regular.variableOfFactor(f, 1)));
+   }
+   OPENGM_TEST_EQUAL(edges.size(), 250);
+   for(size_t v = 0; v < regular.numberOfVariables(); ++v) {
+      OPENGM_TEST_EQUAL(regular.numberOfFactors(v), 6);
+   }
+
+   const Model cliques = generator.buildCliques(2, 10, 30, 4, 2, parameter);
+   OPENGM_TEST_EQUAL(cliques.numberOfFactors(), 40);
+   OPENGM_TEST_EQUAL(cliques.factorOrder(), 4);
+   for(size_t f = 10; f < cliques.numberOfFactors(); ++f) {
+      OPENGM_TEST_EQUAL(cliques[f].size(), 16);
+   }
+
+   const Model full = generator.buildFull(0, 6, 2, parameter);
+   OPENGM_TEST_EQUAL(full.numberOfFactors(), 6 + 15);
+   const Model star = generator.buildStar(0, 6, 2, parameter);
+   OPENGM_TEST_EQUAL(star.numberOfFactors(), 6 + 5);
+}
+
+int main() {
+   std::cout << "Synthetic Model Generator Test... " << std::endl;
+   testDeterminism();
+   testFamilies();
+   std::cout << "done!" << std::endl;
+   return 0;
+}
@@ -0,0 +1,165 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+#include "opengm/unittests/test.hxx"
+#include "opengm/graphicalmodel/graphicalmodel.hxx"
+#include "opengm/graphicalmodel/graphicalmodel_uai.hxx"
+#include "opengm/functions/explicit_function.hxx"
+#include "opengm/functions/potts.hxx"
+#include "opengm/operations/adder.hxx"
+#include "opengm/operations/multiplier.hxx"
+
+typedef opengm::ExplicitFunction<double> ExplicitFunction;
+typedef opengm::PottsFunction<double> PottsFunction;
+typedef opengm::GraphicalModel<double, opengm::Adder,
+   opengm::meta::TypeListGenerator<ExplicitFunction, PottsFunction>::type> Model;
+typedef opengm::GraphicalModel<double, opengm::Multiplier> ProbabilityModel;
+
+void write(const std::string& filename, const std::string& content) {
+   std::ofstream file(filename.c_str());
+   file << content;
+}
+
+void testParseNumber() {
+   const char* numbers[] = {
+      "0", "1", "-2", "+3.5", "0.000123", "1e-5", "2.5E+10", "123456789012345",
+      "0.1234567890123456789", "1e300", "4.9e-324", "inf", ".5", "7."
+   };
+   for(size_t j = 0; j < sizeof(numbers) / sizeof(numbers[0]); ++j) {
+      const std::string token(numbers[j]);
+      const double value = opengm::uai::detail_uai::parseNumber(token.data(), token.data() + token.size());
+      OPENGM_TEST(value == std::strtod(numbers[j], NULL));
+   }
+   bool thrown = false;
+   try {
+      const std::string token("1.2.3");
+      opengm::uai::detail_uai::parseNumber(token.data(), token.data() + token.size());
+   }
+   catch(opengm::RuntimeError&) {
+      thrown = true;
+   }
+   OPENGM_TEST(thrown);
+}
+
+void testLoad() {
+   // unsorted scope, the table of factor 2 equals the table of factor 1
+   write("test_uai_model.uai",
+      "MARKOV\n3\n2 3 2\n4\n1 0\n2 1 0\n2 1 0\n0\n"
+      "2\n 0.5 0.25\n"
+      "6\n 0.1 0.2\n 0.3 0.4\n 0.5 1\n"
+      "6 0.1 0.2 0.3 0.4 0.5 1\n"
+      "1\n 0\n");
+   Model gm;
+   opengm::uai::load(gm, "test_uai_model.uai");
+   OPENGM_TEST_EQUAL(gm.numberOfVariables(), 3);
+   OPENGM_TEST_EQUAL(gm.numberOfLabels(1), 3);
+   OPENGM_TEST_EQUAL(gm.numberOfFactors(), 4);
+   OPENGM_TEST_EQUAL(gm.numberOfFunctions(0), 3);
+   OPENGM_TEST_EQUAL(gm[1].numberOfVariables(), 2);
+   OPENGM_TEST_EQUAL(gm[1].variableIndex(0), 0);
+   OPENGM_TEST_EQUAL(gm[1].variableIndex(1), 1);
+   OPENGM_TEST_EQUAL(gm.numberOfFactors(1), 2);
+   OPENGM_TEST_EQUAL_TOLERANCE(gm[0](std::vector<size_t>(1, 1).begin()), -std::log(0.25), 1e-12);
+   // file entry (x1, x0) = (2, 0) is the sixth-but-one value
+   const size_t labels[] = {0, 2};
+   OPENGM_TEST_EQUAL_TOLERANCE(gm[1](labels), -std::log(0.5), 1e-12);
+   OPENGM_TEST_EQUAL_TOLERANCE(gm[2](labels), -std::log(0.5), 1e-12);
+   const size_t labels2[] = {1, 0};
+   OPENGM_TEST_EQUAL_TOLERANCE(gm[1](labels2), -std::log(0.2), 1e-12);
+   OPENGM_TEST_EQUAL(gm[3](labels), opengm::uai::zeroProbabilityEnergy);
+
+   ProbabilityModel pm;
+   opengm::uai::load(pm, "test_uai_model.uai", false, 2);
+   OPENGM_TEST_EQUAL(pm[1](labels2), 0.2);
+
+   // malformed files
+   const char* invalid[] = {
+      "MARKOV\n1\n2\n1\n1 0\n3 0.1 0.2 0.3\n",
+      "MARKOV\n1\n2\n1\n1 0\n2 0.1\n",
+      "MARKOV\n1\n2\n1\n1 1\n2 0.1 0.2\n",
+      "MARKOV\n2\n2 2\n1\n2 0 0\n4 0.1 0.2 0.3 0.4\n",
+      "MARKOV\n1\n2\n1\n1 0\n2 0.1 -0.2\n",
+      "MARKOV\n1\n2\n1\n1 0\n2 0.1 x\n",
+      "CLIQUE\n1\n2\n1\n1 0\n2 0.1 0.2\n"
+   };
+   for(size_t j = 0; j < sizeof(invalid) / sizeof(invalid[0]); ++j) {
+      write("test_uai_invalid.uai", invalid[j]);
+      bool thrown = false;
+      try {
+         opengm::uai::load(gm, "test_uai_invalid.uai");
+      }
+      catch(opengm::RuntimeError&) {
+         thrown = true;
+      }
+      OPENGM_TEST(thrown);
+   }
+   std::remove("test_uai_model.uai");
+   std::remove("test_uai_invalid.uai");
+}
+
+void testSaveLoad() {
+   const size_t numbersOfLabels[] = {2, 3, 4, 2, 3};
+   Model gm(opengm::DiscreteSpace<size_t, size_t>(numbersOfLabels, numbersOfLabels + 5));
+   for(size_t v = 0; v < 5; ++v) {
+      ExplicitFunction f(numbersOfLabels + v, numbersOfLabels + v + 1);
+      for(size_t l = 0; l < f.size(); ++l) {
+         f(l) = static_cast<double>(rand() % 100) / 10.0;
+      }
+      gm.addFactor(gm.addFunction(f), &v, &v + 1);
+   }
+   const size_t vi[] = {0, 2, 4};
+   const size_t shape[] = {2, 4, 3};
+   ExplicitFunction f(shape, shape + 3);
+   for(size_t l = 0; l < f.size(); ++l) {
+      f(l) = static_cast<double>(rand() % 100) / 10.0;
+   }
+   gm.addFactor(gm.addFunction(f), vi, vi + 3);
+   gm.addFactor(gm.addFunction(PottsFunction(3, 2, 0.0, 1.5)), vi + 1, vi + 3);
+
+   opengm::uai::save(gm, "test_uai_save.uai", true, 2);
+   Model loaded;
+   opengm::uai::load(loaded, "test_uai_save.uai");
+   OPENGM_TEST_EQUAL(loaded.numberOfFactors(), gm.numberOfFactors());
+   std::vector<size_t> labeling(gm.numberOfVariables());
+   for(size_t n = 0; n < 20; ++n) {
+      for(size_t v = 0; v < labeling.size(); ++v) {
+         labeling[v] = rand() % numbersOfLabels[v];
+      }
+      OPENGM_TEST_EQUAL_TOLERANCE(loaded.evaluate(labeling.begin()), gm.evaluate(labeling.begin()), 1e-9);
+   }
+   std::remove("test_uai_save.uai");
+}
+
+void testEvidence() {
+   std::vector<std::pair<size_t, size_t> > evidence;
+   write("test_uai.evid", "2 0 1 4 2\n");
+   opengm::uai::loadEvidence("test_uai.evid", evidence);
+   OPENGM_TEST_EQUAL(evidence.size(), 2);
+   OPENGM_TEST_EQUAL(evidence[1].first, 4);
+   OPENGM_TEST_EQUAL(evidence[1].second, 2);
+
+   // format with a number of samples
+   write("test_uai.evid", "1\n3 0 1 4 2 5 0\n");
+   opengm::uai::loadEvidence("test_uai.evid", evidence);
+   OPENGM_TEST_EQUAL(evidence.size(), 3);
+   OPENGM_TEST_EQUAL(evidence[2].first, 5);
+
+   write("test_uai.evid", "0\n");
+   opengm::uai::loadEvidence("test_uai.evid", evidence);
+   OPENGM_TEST(evidence.empty());
+   std::remove("test_uai.evid");
+}
+
+int main() {
+   std::cout << "UAI File Format Test... " << std::endl;
+   testParseNumber();
+   testLoad();
+   testSaveLoad();
+   testEvidence();
+   std::cout << "done!" << std::endl;
+   return 0;
+}